@@ -0,0 +1,118 @@
+// =============================================================================
+// bench_allocator.cpp — Allocator Throughput and Purge Benchmarks
+// =============================================================================
+//
+// The request-path pattern: allocate a burst of small, mixed-size blocks
+// (headers, keys, values, response text), then free them all. Timed with
+// plain malloc/free and with Allocator, on 1 thread and on several (where
+// glibc's shared arenas start to be contended), then the resident set size
+// before and after Allocator::purge().
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "util/allocator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using mini_redis::Allocator;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t BURST = 64;
+constexpr std::size_t BURSTS_PER_THREAD = 200'000;
+
+// Sizes 16..1000, varied so several size classes are in play
+std::size_t size_for(std::size_t i) { return 16 + (i * 2654435761u) % 985; }
+
+struct Malloc {
+  static void *allocate(std::size_t size) { return std::malloc(size); }
+  static void deallocate(void *ptr, std::size_t) { std::free(ptr); }
+};
+
+struct Cached {
+  static void *allocate(std::size_t size) { return Allocator::allocate(size); }
+  static void deallocate(void *ptr, std::size_t size) {
+    Allocator::deallocate(ptr, size);
+  }
+};
+
+template <typename Backend> void bursts(std::size_t seed) {
+  void *blocks[BURST];
+  for (std::size_t burst = 0; burst < BURSTS_PER_THREAD; ++burst) {
+    for (std::size_t i = 0; i < BURST; ++i) {
+      blocks[i] = Backend::allocate(size_for(seed + burst + i));
+      static_cast<char *>(blocks[i])[0] = 1; // touch it
+    }
+    for (std::size_t i = 0; i < BURST; ++i) {
+      Backend::deallocate(blocks[i], size_for(seed + burst + i));
+    }
+  }
+}
+
+template <typename Backend> void run_threads(const char *label, int threads) {
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; ++t) {
+    workers.emplace_back([t] { bursts<Backend>(static_cast<std::size_t>(t)); });
+  }
+  for (auto &worker : workers) {
+    worker.join();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  const double ops =
+      static_cast<double>(threads) * BURSTS_PER_THREAD * BURST * 2;
+  std::printf("%-40s %2d threads %9.3f s %8.1f ns/op (alloc or free)\n",
+              label, threads, seconds, seconds * 1e9 / ops);
+}
+
+} // anonymous namespace
+
+int main() {
+  std::printf("backend: %s\n\n", Allocator::backend_name());
+
+  for (const int threads : {1, 4}) {
+    run_threads<Malloc>("malloc/free", threads);
+    run_threads<Cached>("Allocator", threads);
+  }
+
+  // A single-size loop isolates the thread-cache fast path
+  std::printf("\n");
+  bench::run("malloc+free 48 B", 20'000'000, [](std::size_t) {
+    void *block = std::malloc(48);
+    bench::do_not_optimize(block);
+    std::free(block);
+  });
+  bench::run("Allocator 48 B", 20'000'000, [](std::size_t) {
+    void *block = Allocator::allocate(48);
+    bench::do_not_optimize(block);
+    Allocator::deallocate(block, 48);
+  });
+
+  // Grow the heap, free it all, then see what purge() gives back
+  std::vector<void *> blocks;
+  for (std::size_t i = 0; i < 1'000'000; ++i) {
+    blocks.push_back(Allocator::allocate(size_for(i)));
+  }
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    Allocator::deallocate(blocks[i], size_for(i));
+  }
+  auto stats = Allocator::stats();
+  std::printf("\nafter 1M blocks freed:  resident %6.1f MB, "
+              "cached in threads %6.1f KB\n",
+              static_cast<double>(stats.resident_bytes) / 1e6,
+              static_cast<double>(stats.cached_bytes) / 1e3);
+  Allocator::purge();
+  stats = Allocator::stats();
+  std::printf("after purge():          resident %6.1f MB, "
+              "cached in threads %6.1f KB\n",
+              static_cast<double>(stats.resident_bytes) / 1e6,
+              static_cast<double>(stats.cached_bytes) / 1e3);
+  return 0;
+}
@@ -0,0 +1,107 @@
+// =============================================================================
+// bench_backing_store.cpp — Write-Through vs. Write-Behind, and Stampedes
+// =============================================================================
+//
+// The price of a SET when the system of record is written on the request
+// path (one file per write) against queueing it for the writer thread,
+// over a working set of 1k keys that are each written many times. Then
+// 16 threads miss the same slow key at once: one load, or sixteen.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/backing_store.hpp"
+#include "core/key_value_store.hpp"
+#include "util/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::BackingStats;
+using mini_redis::FileBackingStore;
+using mini_redis::KeyValueStore;
+using mini_redis::WriteBehindOptions;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t KEYS = 1'000;
+constexpr std::size_t OPS = 20'000;
+constexpr int THREADS = 16;
+
+// ---- A backing store with a database-like round trip on every load ----
+class SlowBackingStore : public FileBackingStore {
+public:
+  using FileBackingStore::FileBackingStore;
+  std::optional<std::string> load(const std::string &key) override {
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    return FileBackingStore::load(key);
+  }
+};
+
+void print_stats(const BackingStats &stats) {
+  std::printf("  loads %llu  coalesced %llu  written %llu  batches %llu\n",
+              static_cast<unsigned long long>(stats.loads),
+              static_cast<unsigned long long>(stats.coalesced),
+              static_cast<unsigned long long>(stats.written),
+              static_cast<unsigned long long>(stats.batches));
+}
+
+} // anonymous namespace
+
+int main() {
+  mini_redis::Logger::set_min_level(mini_redis::LogLevel::WARNING);
+  const std::string directory =
+      (std::filesystem::temp_directory_path() / "mini_redis_bench_backing")
+          .string();
+  std::filesystem::remove_all(directory);
+  auto backing = std::make_shared<SlowBackingStore>(directory);
+
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    keys.push_back("user:" + std::to_string(i));
+  }
+
+  std::printf("--- SET, %zu keys ---\n", KEYS);
+  KeyValueStore through;
+  bench::run("write-through (file write per SET)", OPS, [&](std::size_t i) {
+    const std::string &key = keys[(i * 7919) % KEYS];
+    through.set(key, "value");
+    bench::do_not_optimize(backing->write_batch({{key, std::string("value")}}));
+  });
+
+  {
+    KeyValueStore behind;
+    behind.set_backing_store(backing, WriteBehindOptions{});
+    bench::run("write-behind (queued)", OPS, [&](std::size_t i) {
+      behind.set(keys[(i * 7919) % KEYS], "value");
+    });
+    behind.flush_backing_store();
+    print_stats(*behind.backing_stats());
+  }
+
+  std::printf("\n--- %d threads miss one key (5 ms load) ---\n", THREADS);
+  KeyValueStore cache;
+  cache.set_backing_store(backing, WriteBehindOptions{});
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int t = 0; t < THREADS; ++t) {
+    threads.emplace_back(
+        [&] { bench::do_not_optimize(cache.get("user:7").has_value()); });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  std::printf("  all answered in %.1f ms\n",
+              std::chrono::duration<double, std::milli>(
+                  std::chrono::steady_clock::now() - start)
+                  .count());
+  print_stats(*cache.backing_stats());
+
+  std::filesystem::remove_all(directory);
+  return 0;
+}
@@ -0,0 +1,145 @@
+// =============================================================================
+// bench_batch_lookups.cpp — Probing a Batch: One by One vs. Prefetched
+// =============================================================================
+//
+// Batches of 32 random keys looked up in tables far larger than the
+// cache, first one key at a time (each probe waits out its own miss),
+// then with the bucket of the key PREFETCH_DISTANCE ahead requested
+// before each probe (several misses in flight). Both table kinds the map
+// offers, then the store paths that batch: MGET and snapshot loading.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "core/thread_safe_hash_map.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+using mini_redis::KeyValueStore;
+using mini_redis::StoreEntry;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t KEYS = 1'000'000;
+constexpr std::size_t BATCH = 32;
+constexpr std::size_t BATCHES = 100'000;
+constexpr std::size_t DISTANCE = 8; // as in ThreadSafeHashMap
+
+std::vector<std::uint64_t> random_keys(std::size_t count) {
+  std::mt19937_64 rng(7);
+  std::vector<std::uint64_t> keys(count);
+  for (auto &key : keys) {
+    key = rng() % KEYS;
+  }
+  return keys;
+}
+
+// One table, probed straight (no map, no locks): only the probes differ
+template <typename Storage> void table_batches(const char *name) {
+  using Table = typename Storage::template Table<std::uint64_t, std::uint64_t>;
+  const mini_redis::KeyHasher<std::uint64_t> hasher;
+  Table table;
+  for (std::uint64_t key = 0; key < KEYS; ++key) {
+    table.insert_or_assign(key, hasher(key), key);
+  }
+  const auto keys = random_keys(BATCH * BATCHES);
+  std::vector<std::uint64_t> hashes(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    hashes[i] = hasher(keys[i]);
+  }
+
+  std::printf("--- %s ---\n", name);
+  std::string label = std::string(name) + ": one by one";
+  bench::run(label.c_str(), BATCHES, [&](std::size_t batch) {
+    std::uint64_t sum = 0;
+    for (std::size_t i = batch * BATCH; i < (batch + 1) * BATCH; ++i) {
+      sum += *table.find(keys[i], hashes[i]);
+    }
+    bench::do_not_optimize(sum);
+  });
+
+  label = std::string(name) + ": prefetched";
+  bench::run(label.c_str(), BATCHES, [&](std::size_t batch) {
+    const std::size_t begin = batch * BATCH;
+    const std::size_t end = begin + BATCH;
+    for (std::size_t i = begin; i < begin + DISTANCE; ++i) {
+      table.prefetch(keys[i], hashes[i]);
+    }
+    std::uint64_t sum = 0;
+    for (std::size_t i = begin; i < end; ++i) {
+      if (i + DISTANCE < end) {
+        table.prefetch(keys[i + DISTANCE], hashes[i + DISTANCE]);
+      }
+      sum += *table.find(keys[i], hashes[i]);
+    }
+    bench::do_not_optimize(sum);
+  });
+}
+
+std::string name_of(std::uint64_t i) { return "user:" + std::to_string(i); }
+
+void store_batches() {
+  std::printf("--- store (%zu string keys) ---\n", KEYS);
+  KeyValueStore store;
+  for (std::uint64_t i = 0; i < KEYS; ++i) {
+    store.restore(name_of(i), StoreEntry{std::string("value"), std::nullopt});
+  }
+  const auto numbers = random_keys(BATCH * BATCHES);
+  std::vector<std::vector<std::string>> batches(BATCHES);
+  for (std::size_t b = 0; b < BATCHES; ++b) {
+    for (std::size_t i = b * BATCH; i < (b + 1) * BATCH; ++i) {
+      batches[b].push_back(name_of(numbers[i]));
+    }
+  }
+
+  bench::run("MGET x32 as 32 GETs", BATCHES, [&](std::size_t b) {
+    for (const std::string &key : batches[b]) {
+      bench::do_not_optimize(store.get(key));
+    }
+  });
+  bench::run("MGET x32 (get_many)", BATCHES, [&](std::size_t b) {
+    bench::do_not_optimize(store.get_many(batches[b]));
+  });
+}
+
+// Snapshot loading: the same entries restored key by key, then batched
+void load_entries(const char *label, bool batched) {
+  std::vector<std::pair<std::string, StoreEntry>> entries;
+  entries.reserve(KEYS);
+  std::mt19937_64 rng(11);
+  for (std::uint64_t i = 0; i < KEYS; ++i) {
+    entries.emplace_back(name_of(rng()), StoreEntry{std::string("value"), {}});
+  }
+  KeyValueStore store;
+  std::size_t done = 0;
+  bench::run(label, 1, [&](std::size_t) {
+    if (batched) {
+      store.restore_many(std::move(entries));
+    } else {
+      for (auto &[key, entry] : entries) {
+        store.restore(key, std::move(entry));
+      }
+    }
+    done = store.keys().size();
+  });
+  std::printf("  (%zu keys loaded)\n", done);
+}
+
+} // anonymous namespace
+
+int main() {
+  table_batches<mini_redis::NodeStorage>("node table");
+  table_batches<mini_redis::FlatStorage>("flat table");
+  store_batches();
+
+  std::printf("--- snapshot load (%zu keys) ---\n", KEYS);
+  load_entries("restore() per key", false);
+  load_entries("restore_many()", true);
+  return 0;
+}
@@ -0,0 +1,109 @@
+// =============================================================================
+// bench_bitmap.cpp — Bitmap Benchmarks on 100M-bit Bitmaps
+// =============================================================================
+//
+// 100 million bits = 12.5 MB: one "daily active users" bitmap for a large
+// service. Measures the whole-bitmap operations (BITCOUNT, BITOP, BITPOS)
+// with the SIMD kernels against the portable ones, random SETBIT, and a
+// sparse roaring bitmap over the same offset range.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/bitmap.hpp"
+#include "core/bitmap_ops.hpp"
+#include "core/roaring_bitmap.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+
+using mini_redis::BitOp;
+using mini_redis::RoaringBitmap;
+namespace bench = mini_redis::bench;
+
+int main() {
+  constexpr std::uint64_t BITS = 100'000'000;
+  constexpr std::size_t BYTES = BITS / 8;
+  constexpr std::size_t PASSES = 50;
+
+  std::mt19937_64 rng(1);
+  std::string monday(BYTES, '\0');
+  std::string tuesday(BYTES, '\0');
+  for (std::size_t i = 0; i < BYTES; i += 8) {
+    const std::uint64_t a = rng();
+    const std::uint64_t b = rng();
+    monday.replace(i, 8, reinterpret_cast<const char *>(&a), 8);
+    tuesday.replace(i, 8, reinterpret_cast<const char *>(&b), 8);
+  }
+  std::string result = monday;
+  const auto *mon = reinterpret_cast<const std::uint8_t *>(monday.data());
+  const auto *tue = reinterpret_cast<const std::uint8_t *>(tuesday.data());
+  auto *scratch = reinterpret_cast<std::uint8_t *>(result.data());
+
+  // bench::run() returns ops/s; each op streams through BYTES bytes
+  const auto report = [&](const char *label, double ops_per_sec) {
+    std::printf("  %-38s %.1f GB/s\n", label,
+                static_cast<double>(BYTES) * ops_per_sec / 1e9);
+  };
+
+  report("BITCOUNT scalar",
+         bench::run("BITCOUNT 100M bits (scalar)", PASSES, [&](std::size_t) {
+           bench::do_not_optimize(mini_redis::bit_count_scalar(mon, BYTES));
+         }));
+  report("BITCOUNT dispatched",
+         bench::run("BITCOUNT 100M bits (AVX2)", PASSES, [&](std::size_t) {
+           bench::do_not_optimize(mini_redis::bit_count(mon, BYTES));
+         }));
+
+  report("BITOP AND scalar",
+         bench::run("BITOP AND 100M bits (scalar)", PASSES, [&](std::size_t) {
+           mini_redis::bitwise_scalar(BitOp::AND, scratch, tue, BYTES);
+         }));
+  report("BITOP AND dispatched",
+         bench::run("BITOP AND 100M bits (AVX2)", PASSES, [&](std::size_t) {
+           mini_redis::bitwise(BitOp::AND, scratch, tue, BYTES);
+         }));
+  bench::run("BITOP OR full command (copy + OR)", PASSES, [&](std::size_t) {
+    bench::do_not_optimize(
+        mini_redis::combine_bits(BitOp::OR, {monday, tuesday}));
+  });
+
+  std::string sparse(BYTES, '\0');
+  mini_redis::set_bit(sparse, BITS - 1, true);
+  bench::run("BITPOS 1 (one bit at the end)", PASSES, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::find_bit(
+        sparse, true, mini_redis::ByteRange{0, BYTES - 1}));
+  });
+
+  constexpr std::size_t SETS = 5'000'000;
+  bench::run("SETBIT random offsets", SETS, [&](std::size_t i) {
+    bench::do_not_optimize(
+        mini_redis::set_bit(sparse, (i * 2654435761u) % BITS, true));
+  });
+
+  // ---- Roaring: 100k users flagged out of 100M ----
+  RoaringBitmap roaring_a;
+  RoaringBitmap roaring_b;
+  bench::run("roaring SETBIT (100k random)", 100'000, [&](std::size_t) {
+    roaring_a.set(static_cast<std::uint32_t>(rng() % BITS), true);
+  });
+  for (int i = 0; i < 100'000; ++i) {
+    roaring_b.set(static_cast<std::uint32_t>(rng() % BITS), true);
+  }
+  std::printf("roaring: %zu bytes for %llu bits (plain: %zu bytes)\n",
+              roaring_a.memory_bytes(),
+              static_cast<unsigned long long>(roaring_a.count()), BYTES);
+  bench::run("roaring BITCOUNT", 100'000, [&](std::size_t) {
+    bench::do_not_optimize(roaring_a.count());
+  });
+  bench::run("roaring BITOP AND", 200, [&](std::size_t) {
+    bench::do_not_optimize(
+        RoaringBitmap::combine(BitOp::AND, {&roaring_a, &roaring_b}));
+  });
+  bench::run("roaring BITOP OR", 200, [&](std::size_t) {
+    bench::do_not_optimize(
+        RoaringBitmap::combine(BitOp::OR, {&roaring_a, &roaring_b}));
+  });
+
+  return 0;
+}
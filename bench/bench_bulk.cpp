@@ -0,0 +1,96 @@
+// =============================================================================
+// bench_bulk.cpp — Loading a Dataset: Key by Key vs. One Bulk Stream
+// =============================================================================
+//
+// One million keys with 100-byte values, exported as one bulk stream and
+// loaded back: first key by key through set() (what a million PUTs do
+// once HTTP is out of the picture), then through BulkImporter fed in
+// network-sized pieces, with one worker and with four. Throughput is
+// given in MB of stream per second, to compare with disk and network.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/bulk_stream.hpp"
+#include "core/key_value_store.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using mini_redis::BulkImporter;
+using mini_redis::KeyValueStore;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t KEYS = 1'000'000;
+constexpr std::size_t VALUE_BYTES = 100;
+constexpr std::size_t CHUNK_BYTES = 1 << 20;
+constexpr std::size_t PIECE_BYTES = 256 * 1024; // one socket read
+
+std::string name_of(std::size_t i) { return "user:" + std::to_string(i); }
+
+void report(const char *label, double runs_per_sec, std::size_t bytes) {
+  std::printf("  %-38s %8.0f MB/s\n", label,
+              runs_per_sec * static_cast<double>(bytes) / 1e6);
+}
+
+void import_with(std::size_t workers, const std::string &stream) {
+  KeyValueStore store;
+  std::size_t loaded = 0;
+  const std::string label =
+      "BulkImporter, " + std::to_string(workers) + " worker(s)";
+  const double rate = bench::run(label.c_str(), 1, [&](std::size_t) {
+    BulkImporter importer(store, workers);
+    for (std::size_t pos = 0; pos < stream.size(); pos += PIECE_BYTES) {
+      importer.feed(std::string_view(stream).substr(pos, PIECE_BYTES));
+    }
+    importer.finish();
+    loaded = importer.records();
+  });
+  report(label.c_str(), rate, stream.size());
+  std::printf("  (%zu keys loaded)\n", loaded);
+}
+
+} // anonymous namespace
+
+int main() {
+  // set() logs every write; at a million of them that is all we'd measure
+  mini_redis::Logger::set_min_level(mini_redis::LogLevel::WARNING);
+  std::printf("--- %zu keys, %zu-byte values ---\n", KEYS, VALUE_BYTES);
+  KeyValueStore source;
+  const std::string value(VALUE_BYTES, 'v');
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    source.set(name_of(i), value);
+  }
+
+  // What the export route does: spool to a temporary file
+  std::FILE *spool = std::tmpfile();
+  const double export_rate =
+      bench::run("export (encode + spool)", 1, [&](std::size_t) {
+        mini_redis::encode_bulk_export(source, CHUNK_BYTES, spool);
+      });
+  std::string stream(static_cast<std::size_t>(std::ftell(spool)), '\0');
+  std::rewind(spool);
+  if (std::fread(stream.data(), 1, stream.size(), spool) != stream.size()) {
+    std::printf("  (could not read the spool back)\n");
+  }
+  std::fclose(spool);
+  report("export (encode + spool)", export_rate, stream.size());
+
+  KeyValueStore by_key;
+  const double set_rate = bench::run("key by key (set())", 1, [&](std::size_t) {
+    for (std::size_t i = 0; i < KEYS; ++i) {
+      by_key.set(name_of(i), value);
+    }
+  });
+  report("key by key (set())", set_rate, stream.size());
+
+  import_with(1, stream);
+  import_with(4, stream);
+  return 0;
+}
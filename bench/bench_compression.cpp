@@ -0,0 +1,109 @@
+// =============================================================================
+// bench_compression.cpp — Transparent Compression: Memory vs. CPU
+// =============================================================================
+//
+// 20k keys holding 16 KB JSON-like documents, loaded with compression off
+// and on. Reports heap growth, the achieved ratio, and SET / GET /
+// pass-through GET (get_encoded: the "Accept-Encoding: lz4" path, which
+// skips decompression) throughput. Also times the raw codec in MB/s.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
+#include "util/lz4.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::Allocator;
+using mini_redis::KeyValueStore;
+using mini_redis::StoreEntry;
+namespace bench = mini_redis::bench;
+namespace lz4 = mini_redis::lz4;
+
+namespace {
+
+constexpr std::size_t KEYS = 20'000;
+constexpr std::size_t VALUE_BYTES = 16 * 1024;
+constexpr std::size_t DOCUMENTS = 64; // distinct bodies, cycled
+
+std::string document(std::mt19937 &rng) {
+  std::string out = "[";
+  while (out.size() < VALUE_BYTES) {
+    out += "{\"id\":" + std::to_string(rng() % 1'000'000) +
+           ",\"score\":" + std::to_string(rng() % 1000) +
+           ",\"tags\":[\"alpha\",\"beta\"],\"active\":" +
+           (rng() % 2 == 0 ? "true" : "false") + "},";
+  }
+  out.resize(VALUE_BYTES);
+  return out;
+}
+
+void load(const char *label, std::size_t min_bytes,
+          const std::vector<std::string> &names,
+          const std::vector<std::string> &docs) {
+  std::printf("\n--- %s ---\n", label);
+  const std::uint64_t heap_before = Allocator::stats().heap_used_bytes;
+  {
+    KeyValueStore store;
+    store.set_compression_min_bytes(min_bytes);
+    bench::run("SET (restore)", KEYS, [&](std::size_t i) {
+      store.restore(names[i], StoreEntry{docs[i % DOCUMENTS], std::nullopt});
+    });
+    bench::run("GET", KEYS, [&](std::size_t i) {
+      bench::do_not_optimize(store.get(names[(i * 7919) % KEYS]));
+    });
+    bench::run("GET pass-through", KEYS, [&](std::size_t i) {
+      bench::do_not_optimize(store.get_encoded(names[(i * 7919) % KEYS]));
+    });
+
+    const std::uint64_t heap_after = Allocator::stats().heap_used_bytes;
+    const auto stats = store.compression_stats();
+    std::printf("  heap growth %.1f MB; %llu values compressed, ratio %.2f\n",
+                static_cast<double>(heap_after - heap_before) / 1e6,
+                static_cast<unsigned long long>(stats.compressed),
+                stats.compressed_bytes == 0
+                    ? 1.0
+                    : static_cast<double>(stats.raw_bytes) /
+                          static_cast<double>(stats.compressed_bytes));
+  }
+}
+
+} // anonymous namespace
+
+int main() {
+  std::mt19937 rng(42);
+  std::vector<std::string> docs;
+  for (std::size_t i = 0; i < DOCUMENTS; ++i) {
+    docs.push_back(document(rng));
+  }
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    names.push_back("doc:" + std::to_string(i));
+  }
+
+  std::printf("--- codec alone (16 KB documents) ---\n");
+  std::vector<std::string> frames;
+  const double compress_ops =
+      bench::run("lz4::compress", KEYS, [&](std::size_t i) {
+        if (i < DOCUMENTS) {
+          frames.push_back(lz4::compress(docs[i]));
+        } else {
+          bench::do_not_optimize(lz4::compress(docs[i % DOCUMENTS]));
+        }
+      });
+  const double decompress_ops =
+      bench::run("lz4::decompress", KEYS, [&](std::size_t i) {
+        bench::do_not_optimize(lz4::decompress(frames[i % DOCUMENTS]));
+      });
+  std::printf("  compress %.0f MB/s, decompress %.0f MB/s\n",
+              compress_ops * VALUE_BYTES / 1e6,
+              decompress_ops * VALUE_BYTES / 1e6);
+
+  load("compression off", 0, names, docs);
+  load("compression on (min 4 KB)", 4096, names, docs);
+  return 0;
+}
@@ -0,0 +1,74 @@
+// =============================================================================
+// bench_dedup.cpp — Value Deduplication: Memory Saved vs. Write Cost
+// =============================================================================
+//
+// 200k keys whose 1 KB values come from a pool of 100 distinct blobs (the
+// "same default config for every user" case). Loaded with dedup off and
+// on; reports heap growth, the intern table's own numbers, and SET / GET
+// throughput. The extra SET cost is one content hash plus the table lock.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using mini_redis::Allocator;
+using mini_redis::KeyValueStore;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t KEYS = 200'000;
+constexpr std::size_t BLOBS = 100;
+constexpr std::size_t VALUE_BYTES = 1024;
+
+void load(const char *label, std::size_t min_bytes,
+          const std::vector<std::string> &names,
+          const std::vector<std::string> &blobs) {
+  std::printf("\n--- %s ---\n", label);
+  const std::uint64_t heap_before = Allocator::stats().heap_used_bytes;
+  {
+    KeyValueStore store;
+    store.set_dedup_min_bytes(min_bytes);
+    bench::run("SET (restore)", KEYS, [&](std::size_t i) {
+      store.restore(names[i], {blobs[i % BLOBS], std::nullopt});
+    });
+    bench::run("GET", KEYS, [&](std::size_t i) {
+      bench::do_not_optimize(store.get(names[(i * 7919) % KEYS]));
+    });
+
+    const std::uint64_t heap_after = Allocator::stats().heap_used_bytes;
+    const auto dedup = store.dedup_stats();
+    std::printf("  heap growth %.1f MB; %llu distinct values, %.1f MB "
+                "saved, hit rate %.1f%%\n",
+                static_cast<double>(heap_after - heap_before) / 1e6,
+                static_cast<unsigned long long>(dedup.values),
+                static_cast<double>(dedup.saved_bytes()) / 1e6,
+                dedup.hits + dedup.misses == 0
+                    ? 0.0
+                    : 100.0 * static_cast<double>(dedup.hits) /
+                          static_cast<double>(dedup.hits + dedup.misses));
+  }
+}
+
+} // anonymous namespace
+
+int main() {
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    names.push_back("user:" + std::to_string(i) + ":config");
+  }
+  std::vector<std::string> blobs;
+  for (std::size_t i = 0; i < BLOBS; ++i) {
+    blobs.push_back(std::string(VALUE_BYTES - 8, 'c') +
+                    std::to_string(10'000'000 + i));
+  }
+
+  load("dedup off", 0, names, blobs);
+  load("dedup on (min 256 B)", 256, names, blobs);
+  return 0;
+}
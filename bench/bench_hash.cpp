@@ -0,0 +1,87 @@
+// =============================================================================
+// bench_hash.cpp — Key Hashing and Table Lookup Benchmarks
+// =============================================================================
+//
+// Times the three hashes the server could use for keys — MurmurHash64A
+// (hash64, kept for sketches and checksums), the table hash fast_hash64,
+// and the standard library's std::hash — across key lengths, then a
+// store-sized table: 1M keys, random GETs and overwrites through
+// KeyValueStore (one hash per request picks the shard and the bucket).
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "util/hash.hpp"
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace bench = mini_redis::bench;
+
+namespace {
+
+void bench_lengths() {
+  constexpr std::size_t HASHES = 20'000'000;
+  const std::uint64_t seed = mini_redis::process_hash_seed();
+
+  for (const std::size_t length : {8u, 16u, 24u, 64u, 256u, 4096u}) {
+    // A few distinct inputs so the loop can't be folded to a constant
+    std::vector<std::string> inputs;
+    for (char c = 'a'; c < 'a' + 8; ++c) {
+      inputs.emplace_back(length, c);
+    }
+    const std::size_t ops = length >= 256 ? HASHES / (length / 16) : HASHES;
+    std::printf("\n--- %zu-byte keys ---\n", length);
+
+    bench::run("hash64 (MurmurHash64A)", ops, [&](std::size_t i) {
+      bench::do_not_optimize(mini_redis::hash64(inputs[i & 7]));
+    });
+    bench::run("fast_hash64", ops, [&](std::size_t i) {
+      bench::do_not_optimize(mini_redis::fast_hash64(inputs[i & 7], seed));
+    });
+    bench::run("std::hash<std::string_view>", ops, [&](std::size_t i) {
+      bench::do_not_optimize(
+          std::hash<std::string_view>{}(std::string_view(inputs[i & 7])));
+    });
+  }
+}
+
+void bench_store() {
+  constexpr std::size_t KEYS = 1'000'000;
+  constexpr std::size_t LOOKUPS = 4'000'000;
+
+  std::vector<std::string> keys;
+  keys.reserve(KEYS);
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    keys.push_back("user:" + std::to_string(i));
+  }
+
+  std::printf("\n--- KeyValueStore, %zu keys ---\n", KEYS);
+  // restore() is SET without the per-command log line, which would
+  // otherwise be most of what gets timed
+  mini_redis::KeyValueStore store;
+  bench::run("SET (insert)", KEYS, [&](std::size_t i) {
+    store.restore(keys[i], {std::string("value"), std::nullopt});
+  });
+  bench::run("GET (random hit)", LOOKUPS, [&](std::size_t i) {
+    bench::do_not_optimize(store.get(keys[(i * 7919) % KEYS]));
+  });
+  bench::run("GET (miss)", LOOKUPS, [&](std::size_t i) {
+    bench::do_not_optimize(store.get("missing:" + std::to_string(i & 1023)));
+  });
+  bench::run("SET (overwrite)", LOOKUPS, [&](std::size_t i) {
+    store.restore(keys[(i * 7919) % KEYS],
+                  {std::string("other"), std::nullopt});
+  });
+}
+
+} // anonymous namespace
+
+int main() {
+  bench_lengths();
+  bench_store();
+  return 0;
+}
@@ -0,0 +1,97 @@
+// =============================================================================
+// bench_huge_pages.cpp — Random GETs With and Without Huge Pages
+// =============================================================================
+//
+// Fills a store with KEYS short string values, then times random GETs —
+// the access pattern where every lookup misses the TLB. Three runs:
+//   heap              Allocator on top of malloc (the default)
+//   arena, 4 KB pages the same arena as below, but ordinary pages
+//   arena, 2 MB pages explicit huge pages, else transparent ones
+// The two arena runs differ ONLY in page size, so their gap is the TLB.
+//
+// The arena is process-wide and set up once, so each run is a fork()ed
+// child starting from the same empty state. This target also links
+// new_delete.cpp, like the server: key and value strings go through
+// Allocator too.
+//
+// Usage: bench_huge_pages [keys]   (default 2M)
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <vector>
+
+using mini_redis::Allocator;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+enum class Mode { HEAP, ARENA_REGULAR, ARENA_HUGE };
+
+void run(Mode mode, std::size_t keys) {
+  // Room for the nodes (~400 B each), keys, values and bucket arrays
+  const std::size_t arena_bytes = keys * 640 + (64u << 20);
+  const auto start = std::chrono::steady_clock::now();
+  if (mode != Mode::HEAP &&
+      !Allocator::use_page_arena(arena_bytes, mode == Mode::ARENA_HUGE)) {
+    std::printf("\narena: could not be mapped\n");
+    return;
+  }
+  const double setup = std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+
+  std::vector<std::string> names;
+  names.reserve(keys);
+  for (std::size_t i = 0; i < keys; ++i) {
+    names.push_back("user:" + std::to_string(i));
+  }
+
+  const char *label = mode == Mode::HEAP            ? "heap"
+                      : mode == Mode::ARENA_REGULAR ? "arena, 4 KB pages"
+                                                    : "arena, 2 MB pages";
+  std::printf("\n--- %s (setup + prefault %.2f s) ---\n", label, setup);
+
+  mini_redis::KeyValueStore store;
+  bench::run("SET (insert)", keys, [&](std::size_t i) {
+    store.restore(names[i], {std::string("value"), std::nullopt});
+  });
+  bench::run("GET (random hit)", 4 * keys, [&](std::size_t i) {
+    bench::do_not_optimize(store.get(names[(i * 7919) % keys]));
+  });
+
+  const auto stats = Allocator::stats();
+  std::printf("  resident %.0f MB, arena used %.0f MB, %llu x 2 MB pages\n",
+              static_cast<double>(stats.resident_bytes) / 1e6,
+              static_cast<double>(stats.arena_used_bytes) / 1e6,
+              static_cast<unsigned long long>(stats.huge_pages));
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+  const std::size_t keys =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+  std::printf("%zu keys, backend %s\n", keys, Allocator::backend_name());
+
+  for (const Mode mode : {Mode::HEAP, Mode::ARENA_REGULAR, Mode::ARENA_HUGE}) {
+    std::fflush(stdout); // or the child inherits and re-prints the buffer
+    const pid_t child = fork();
+    if (child == 0) {
+      run(mode, keys);
+      std::fflush(stdout);
+      _exit(0);
+    }
+    int status = 0;
+    waitpid(child, &status, 0);
+  }
+  return 0;
+}
@@ -0,0 +1,58 @@
+// =============================================================================
+// bench_hyperloglog.cpp — HyperLogLog Benchmarks
+// =============================================================================
+//
+// PFADD throughput into one dense HLL, then PFCOUNT and PFMERGE, which are
+// dominated by the register kernels (unpack + AVX2 max / harmonic sum).
+// Also prints the accuracy and memory footprint after 10M uniques.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/hyperloglog.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using mini_redis::HyperLogLog;
+namespace bench = mini_redis::bench;
+
+int main() {
+  constexpr std::size_t UNIQUES = 10'000'000;
+  constexpr std::size_t QUERIES = 20'000;
+
+  HyperLogLog visitors;
+  std::string id = "visitor:";
+  const std::size_t prefix = id.size();
+  bench::run("PFADD (unique ids)", UNIQUES, [&](std::size_t i) {
+    id.resize(prefix);
+    id += std::to_string(i);
+    bench::do_not_optimize(visitors.add(id));
+  });
+
+  const auto estimate = visitors.count();
+  std::printf("estimate %llu for %zu uniques (error %.3f%%), %zu bytes\n",
+              static_cast<unsigned long long>(estimate), UNIQUES,
+              100.0 * std::abs(static_cast<double>(estimate) - UNIQUES) /
+                  UNIQUES,
+              visitors.memory_bytes());
+
+  bench::run("PFCOUNT (dense)", QUERIES,
+             [&](std::size_t) { bench::do_not_optimize(visitors.count()); });
+
+  HyperLogLog other;
+  for (std::size_t i = 0; i < 100'000; ++i) {
+    other.add("other:" + std::to_string(i));
+  }
+  const std::vector<const HyperLogLog *> both{&visitors, &other};
+  bench::run("PFCOUNT (union of 2 dense)", QUERIES, [&](std::size_t) {
+    bench::do_not_optimize(HyperLogLog::count_union(both));
+  });
+
+  HyperLogLog merged;
+  bench::run("PFMERGE (dense into dense)", QUERIES,
+             [&](std::size_t) { merged.merge(visitors); });
+
+  return 0;
+}
@@ -0,0 +1,106 @@
+// =============================================================================
+// bench_integer_keys.cpp — Integer Keys: Own Table vs. Decimal Strings
+// =============================================================================
+//
+// 1M keys, loaded twice into a fresh store: once as plain numbers ("4711",
+// which parse_integer_key() routes to the integer table) and once with a
+// one-character prefix ("#4711", the same digits, stored as a string the
+// way every key was before). Two shapes of ID:
+//   - sequential 7-digit IDs: fit the std::string's inline buffer
+//   - 19-digit snowflake IDs: each string key needs a heap buffer too
+// Reports heap growth (every allocation goes through Allocator here) and
+// SET / GET / miss throughput. On a table this size a lookup is mostly
+// cache misses, which both layouts pay alike, so GETs are also timed over
+// a small hot set. "user:<n>" keys show what the parse costs the keys it
+// rejects.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::Allocator;
+using mini_redis::KeyValueStore;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t KEYS = 1'000'000;
+constexpr std::size_t HOT_KEYS = 4096;
+
+void load(const char *label, const std::vector<std::string> &names,
+          const std::vector<std::string> &misses) {
+  std::printf("\n--- %s ---\n", label);
+  const std::uint64_t heap_before = Allocator::stats().heap_used_bytes;
+  {
+    KeyValueStore store;
+    bench::run("SET (restore)", KEYS, [&](std::size_t i) {
+      store.restore(names[i], {std::string("v"), std::nullopt});
+    });
+    const std::uint64_t heap_after = Allocator::stats().heap_used_bytes;
+
+    bench::run("GET (hit, random order)", KEYS, [&](std::size_t i) {
+      bench::do_not_optimize(store.get(names[(i * 7919) % KEYS]));
+    });
+    bench::run("GET (miss)", KEYS, [&](std::size_t i) {
+      bench::do_not_optimize(store.get(misses[i]));
+    });
+    // A working set that stays in cache: the key handling itself shows
+    bench::run("GET (hit, 4k hot keys)", KEYS, [&](std::size_t i) {
+      bench::do_not_optimize(store.get(names[(i * 7919) % HOT_KEYS]));
+    });
+
+    const auto counts = store.key_counts();
+    std::printf("  heap growth %.1f MB (%.1f B/key); %zu integer, %zu "
+                "string keys\n",
+                static_cast<double>(heap_after - heap_before) / 1e6,
+                static_cast<double>(heap_after - heap_before) /
+                    static_cast<double>(KEYS),
+                counts.integer, counts.string);
+  }
+}
+
+std::vector<std::string> with_prefix(const std::vector<std::string> &names,
+                                     const std::string &prefix) {
+  std::vector<std::string> out;
+  out.reserve(names.size());
+  for (const auto &name : names) {
+    out.push_back(prefix + name);
+  }
+  return out;
+}
+
+} // anonymous namespace
+
+int main() {
+  std::vector<std::string> sequential;
+  std::vector<std::string> sequential_misses;
+  std::vector<std::string> snowflakes;
+  std::vector<std::string> snowflake_misses;
+  std::mt19937_64 rng(5);
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    sequential.push_back(std::to_string(1'000'000 + i));
+    sequential_misses.push_back(std::to_string(3'000'000 + i));
+    // 41 bits of milliseconds, then 22 bits of worker and sequence
+    const std::uint64_t millis = 1'700'000'000'000ULL + i;
+    snowflakes.push_back(std::to_string((millis << 22) | (rng() & 0x3FFFFF)));
+    snowflake_misses.push_back(
+        std::to_string(((millis + KEYS) << 22) | (rng() & 0x3FFFFF)));
+  }
+
+  // First, as it also pays for faulting in the heap the others reuse
+  load("named keys (\"user:<n>\")", with_prefix(sequential, "user:"),
+       with_prefix(sequential_misses, "user:"));
+  load("7-digit IDs, integer table", sequential, sequential_misses);
+  load("7-digit IDs as strings (\"#<n>\")", with_prefix(sequential, "#"),
+       with_prefix(sequential_misses, "#"));
+  load("19-digit IDs, integer table", snowflakes, snowflake_misses);
+  load("19-digit IDs as strings (\"#<n>\")", with_prefix(snowflakes, "#"),
+       with_prefix(snowflake_misses, "#"));
+  return 0;
+}
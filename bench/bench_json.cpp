@@ -0,0 +1,114 @@
+// =============================================================================
+// bench_json.cpp — JSON Parsing and Path Access Benchmarks
+// =============================================================================
+//
+// A ~50 KB document (an array of user records, with nested objects, arrays,
+// numbers and escaped strings) — the "big blob a client stores once and
+// reads a field of" case. Measures:
+//   - stage 1 (structural indexing), SIMD against the portable scanner;
+//   - a full parse into the tape;
+//   - reading one field by path against printing the whole document
+//     (what a client would have to download without paths);
+//   - replacing one field and incrementing one number in place.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/json.hpp"
+#include "core/json_scan.hpp"
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using mini_redis::JsonDocument;
+using mini_redis::JsonPath;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr int USERS = 160;
+
+std::string make_document() {
+  std::string text = "{\"version\": 3, \"users\": [\n";
+  for (int i = 0; i < USERS; ++i) {
+    const std::string n = std::to_string(i);
+    text += "  {\"id\": " + n + ", \"name\": \"User \\\"" + n +
+            "\\\" Example\", \"email\": \"user" + n +
+            "@example.com\", \"active\": " + (i % 3 ? "true" : "false") +
+            ", \"score\": " + std::to_string(i * 1.25) +
+            ",\n   \"tags\": [\"alpha\", \"beta\", \"gamma\", \"delta\"],"
+            " \"address\": {\"street\": \"" +
+            n + " Main St\", \"city\": \"Springfield\", \"zip\": \"0" + n +
+            "\", \"geo\": [51.5, -0.12]},\n   \"bio\": \"Line one\\nline "
+            "two\\ttabbed \\u00e9t\\u00e9 and some filler text to pad\"}" +
+            (i + 1 < USERS ? ",\n" : "\n");
+  }
+  text += "]}";
+  return text;
+}
+
+void report_throughput(double ops_per_sec, std::size_t bytes) {
+  std::printf("  throughput: %.2f GB/s\n",
+              ops_per_sec * static_cast<double>(bytes) / 1e9);
+}
+
+} // anonymous namespace
+
+int main() {
+  const std::string text = make_document();
+  std::printf("document: %zu bytes\n\n", text.size());
+
+  constexpr std::size_t SCANS = 20'000;
+  std::vector<std::uint32_t> positions;
+  positions.reserve(text.size() / 2);
+  bool ascii = false;
+
+  double rate =
+      bench::run("stage 1 scan (scalar)", SCANS, [&](std::size_t) {
+    positions.clear();
+    bench::do_not_optimize(
+        mini_redis::find_structurals_scalar(text, positions, ascii));
+  });
+  report_throughput(rate, text.size());
+  rate = bench::run("stage 1 scan (SIMD)", SCANS, [&](std::size_t) {
+    positions.clear();
+    bench::do_not_optimize(
+        mini_redis::find_structurals(text, positions, ascii));
+  });
+  report_throughput(rate, text.size());
+  std::printf("  %zu structurals (%.1f%% of bytes reach stage 2)\n",
+              positions.size(),
+              100.0 * static_cast<double>(positions.size()) /
+                  static_cast<double>(text.size()));
+
+  constexpr std::size_t PARSES = 5'000;
+  rate = bench::run("parse (stage 1 + tape)", PARSES, [&](std::size_t) {
+    bench::do_not_optimize(JsonDocument::parse(text));
+  });
+  report_throughput(rate, text.size());
+
+  JsonDocument document = *JsonDocument::parse(text);
+  std::printf("  tape: %zu bytes in memory\n", document.memory_bytes());
+
+  constexpr std::size_t READS = 200'000;
+  const JsonPath city = *JsonPath::parse("$.users[150].address.city");
+  bench::run("GET $.users[150].address.city", READS, [&](std::size_t) {
+    bench::do_not_optimize(document.get(city));
+  });
+  bench::run("GET $ (whole document)", READS / 100, [&](std::size_t) {
+    bench::do_not_optimize(document.to_json());
+  });
+
+  const JsonPath name = *JsonPath::parse("$.users[150].name");
+  const JsonDocument new_name = *JsonDocument::parse("\"Renamed User\"");
+  const JsonDocument old_name = *JsonDocument::parse("\"User 150\"");
+  bench::run("SET $.users[150].name (splice)", READS, [&](std::size_t i) {
+    document.set(name, i % 2 ? old_name : new_name);
+  });
+
+  const JsonPath score = *JsonPath::parse("$.users[150].score");
+  bench::run("NUMINCRBY $.users[150].score", READS, [&](std::size_t) {
+    bench::do_not_optimize(document.increment(score, 1.0));
+  });
+  return 0;
+}
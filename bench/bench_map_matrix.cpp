@@ -0,0 +1,151 @@
+// =============================================================================
+// bench_map_matrix.cpp — ThreadSafeHashMap: Every Storage × Lock Policy
+// =============================================================================
+//
+// The same workloads against each policy combination (map_policies.hpp):
+//   - integer keys (uint64 → uint64): random GETs, then overwrites,
+//     single-threaded — the pure table + lock cost
+//   - the same GETs from 4 threads while a 5th keeps writing (90/10),
+//     reported as total GETs per second
+//   - string keys (the store's shape): random GETs
+// Each row is a separate template instantiation, fully inlined: what a
+// combination costs here is what it would cost in the server.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/thread_safe_hash_map.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace mini_redis;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t KEYS = 1'000'000;
+constexpr std::size_t OPS = 4'000'000;
+constexpr std::size_t READERS = 4;
+
+std::vector<std::uint64_t> random_indices(std::size_t count) {
+  std::mt19937_64 rng(17);
+  std::vector<std::uint64_t> out(count);
+  for (auto &index : out) {
+    index = rng() % KEYS;
+  }
+  return out;
+}
+
+template <typename Map>
+void integer_keys(const char *label, const std::vector<std::uint64_t> &order) {
+  std::printf("\n--- %s ---\n", label);
+  Map map;
+  for (std::uint64_t i = 0; i < KEYS; ++i) {
+    map.set(i, i);
+  }
+  bench::run("GET (1 thread)", OPS, [&](std::size_t i) {
+    bench::do_not_optimize(map.get(order[i]));
+  });
+  bench::run("SET overwrite (1 thread)", OPS,
+             [&](std::size_t i) { map.set(order[i], i); });
+
+  // Readers and one writer at once: where the lock policy shows
+  std::atomic<bool> stop{false};
+  std::atomic<std::size_t> reads{0};
+  std::thread writer([&] {
+    for (std::size_t i = 0; !stop.load(std::memory_order_relaxed); ++i) {
+      map.set(order[i % OPS], i);
+    }
+  });
+  const auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> readers;
+  for (std::size_t t = 0; t < READERS; ++t) {
+    readers.emplace_back([&, t] {
+      const std::size_t share = OPS / READERS;
+      for (std::size_t i = t * share; i < (t + 1) * share; ++i) {
+        bench::do_not_optimize(map.get(order[i]));
+      }
+      reads.fetch_add(share);
+    });
+  }
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  const double seconds = std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - start)
+                             .count();
+  stop = true;
+  writer.join();
+  std::printf("%-40s %10zu ops %9.3f s %12.0f ops/s\n",
+              "GET (4 threads + 1 writer)", reads.load(), seconds,
+              static_cast<double>(reads.load()) / seconds);
+}
+
+template <typename Map>
+void string_keys(const char *label, const std::vector<std::string> &names,
+                 const std::vector<std::uint64_t> &order) {
+  Map map;
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    map.set(names[i], i);
+  }
+  bench::run(label, OPS, [&](std::size_t i) {
+    bench::do_not_optimize(map.get(names[order[i]]));
+  });
+}
+
+} // anonymous namespace
+
+int main() {
+  using U64 = std::uint64_t;
+  const auto order = random_indices(OPS);
+
+  integer_keys<ThreadSafeHashMap<U64, U64>>(
+      "node + shared_mutex (default)", order);
+  integer_keys<ThreadSafeHashMap<U64, U64, NodeStorage, SpinLock>>(
+      "node + spinlock", order);
+  integer_keys<ThreadSafeHashMap<U64, U64, FlatStorage>>(
+      "flat + shared_mutex", order);
+  integer_keys<ThreadSafeHashMap<U64, U64, FlatStorage, SpinLock>>(
+      "flat + spinlock", order);
+  integer_keys<ThreadSafeHashMap<U64, U64, FlatStorage, SeqLock>>(
+      "flat + seqlock (optimistic GET)", order);
+  integer_keys<ThreadSafeHashMap<U64, U64, FlatStorage, SharedMutexLock, 64>>(
+      "flat + shared_mutex, 64 shards", order);
+  integer_keys<ThreadSafeHashMap<U64, U64, OrderedStorage>>(
+      "ordered + shared_mutex", order);
+
+  // No lock is only correct with one thread per map: time it alone
+  std::printf("\n--- flat + no lock, 1 shard (single-threaded only) ---\n");
+  {
+    ThreadSafeHashMap<U64, U64, FlatStorage, NoLock, 1> map;
+    for (U64 i = 0; i < KEYS; ++i) {
+      map.set(i, i);
+    }
+    bench::run("GET (1 thread)", OPS, [&](std::size_t i) {
+      bench::do_not_optimize(map.get(order[i]));
+    });
+    bench::run("SET overwrite (1 thread)", OPS,
+               [&](std::size_t i) { map.set(order[i], i); });
+  }
+
+  std::printf("\n--- string keys (\"user:<n>\"), GET ---\n");
+  std::vector<std::string> names;
+  names.reserve(KEYS);
+  for (std::size_t i = 0; i < KEYS; ++i) {
+    names.push_back("user:" + std::to_string(i));
+  }
+  string_keys<ThreadSafeHashMap<std::string, U64>>("node + shared_mutex",
+                                                   names, order);
+  string_keys<ThreadSafeHashMap<std::string, U64, FlatStorage>>(
+      "flat + shared_mutex", names, order);
+  string_keys<ThreadSafeHashMap<std::string, U64, FlatStorage, SpinLock>>(
+      "flat + spinlock", names, order);
+  string_keys<ThreadSafeHashMap<std::string, U64, OrderedStorage>>(
+      "ordered + shared_mutex", names, order);
+  return 0;
+}
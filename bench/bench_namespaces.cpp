@@ -0,0 +1,104 @@
+// =============================================================================
+// bench_namespaces.cpp — Tenants by Key Prefix vs. by Namespace
+// =============================================================================
+//
+// Eight tenants of 100k keys each, stored two ways: in one shared store
+// under "tenant<n>:" prefixes, and in one namespace per tenant. For one
+// tenant we time:
+//   - listing its keys  (prefix: walk all 800k and filter; namespace:
+//                        walk its own 100k)
+//   - flushing it       (prefix: find and remove its keys one by one;
+//                        namespace: flush(), the freeing left to the
+//                        reclaimer thread)
+// The bench holds on to the flushed namespace, so that flush() is timed
+// on its own, and the freeing separately: on a machine with few cores the
+// reclaimer would otherwise run in the middle of the timed call. For the
+// same reason the namespaces' maintenance cycles are set never to run.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/key_value_store.hpp"
+#include "core/namespaces.hpp"
+#include "util/logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::KeyValueStore;
+using mini_redis::NamespaceLimits;
+using mini_redis::NamespaceRegistry;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr int TENANTS = 8;
+constexpr int KEYS_PER_TENANT = 100'000;
+const std::string VALUE(64, 'v');
+const NamespaceLimits QUIET{0, mini_redis::EvictionPolicy::NO_EVICTION,
+                            std::chrono::hours(1)};
+
+std::string tenant_name(int tenant) {
+  return "tenant" + std::to_string(tenant);
+}
+
+std::vector<std::string> prefixed_keys(const KeyValueStore &shared,
+                                       const std::string &prefix) {
+  std::vector<std::string> result;
+  for (const std::string &key : shared.keys()) {
+    if (key.compare(0, prefix.size(), prefix) == 0) {
+      result.push_back(key);
+    }
+  }
+  return result;
+}
+
+} // anonymous namespace
+
+int main() {
+  mini_redis::Logger::set_min_level(mini_redis::LogLevel::WARNING);
+  std::printf("--- %d tenants x %d keys ---\n", TENANTS, KEYS_PER_TENANT);
+
+  KeyValueStore shared;
+  NamespaceRegistry registry;
+  for (int tenant = 0; tenant < TENANTS; ++tenant) {
+    const std::string name = tenant_name(tenant);
+    registry.create(name, QUIET);
+    KeyValueStore &own = registry.find(name)->store();
+    for (int i = 0; i < KEYS_PER_TENANT; ++i) {
+      const std::string key = "user:" + std::to_string(i);
+      shared.set(name + ":" + key, VALUE);
+      own.set(key, VALUE);
+    }
+  }
+
+  const std::string prefix = tenant_name(0) + ":";
+  bench::run("keys(), prefix in a shared store", 5, [&](std::size_t) {
+    bench::do_not_optimize(prefixed_keys(shared, prefix).size());
+  });
+  bench::run("keys(), own namespace", 5, [&](std::size_t) {
+    bench::do_not_optimize(registry.find(tenant_name(0))->store().keys());
+  });
+
+  auto flushed = registry.find(tenant_name(0));
+  bench::run("flush, namespace: flush()", 1,
+             [&](std::size_t) { registry.flush(tenant_name(0)); });
+  while (registry.pending_reclaims() > 0) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  // What flush() left to the background
+  bench::run("  ...then freeing it (off the request)", 1,
+             [&](std::size_t) { flushed.reset(); });
+
+  // Last: glibc defers part of the work of 100k frees to the next large
+  // allocation, which would otherwise land in the flush() above
+  bench::run("flush, prefix: remove() each key", 1, [&](std::size_t) {
+    for (const std::string &key : prefixed_keys(shared, prefix)) {
+      shared.remove(key);
+    }
+  });
+  return 0;
+}
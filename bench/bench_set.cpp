@@ -0,0 +1,100 @@
+// =============================================================================
+// bench_set.cpp — Set Intersection Benchmarks
+// =============================================================================
+//
+// Compares the intersection kernels on 64K-member integer sets (the largest
+// intset) at two overlaps, then a skewed 100-vs-64K case where galloping
+// should win, and finally a 3-key SINTER through Set::intersect().
+// Kernel ops = one full intersection; the ns/op column is per intersection.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/set.hpp"
+#include "core/set_ops.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::Set;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+// 'count' sorted unique IDs drawn from [0, universe)
+std::vector<std::int64_t> random_ids(std::size_t count, std::int64_t universe,
+                                     std::mt19937_64 &rng) {
+  std::vector<std::int64_t> ids;
+  ids.reserve(count * 2);
+  while (ids.size() < count) {
+    ids.push_back(static_cast<std::int64_t>(rng() % universe));
+    if (ids.size() == count) {
+      std::sort(ids.begin(), ids.end());
+      ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    }
+  }
+  return ids;
+}
+
+Set make_set(const std::vector<std::int64_t> &ids) {
+  std::vector<std::string> members;
+  members.reserve(ids.size());
+  for (const auto id : ids) {
+    members.push_back(std::to_string(id));
+  }
+  Set set;
+  set.add_all(members);
+  return set;
+}
+
+void compare_kernels(const char *title, const std::vector<std::int64_t> &a,
+                     const std::vector<std::int64_t> &b, std::size_t rounds) {
+  std::printf("-- %s (|a|=%zu, |b|=%zu)\n", title, a.size(), b.size());
+  std::vector<std::int64_t> out(std::min(a.size(), b.size()));
+
+  bench::run("  merge (scalar)", rounds, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::intersect_merge_scalar(
+        a.data(), a.size(), b.data(), b.size(), out.data()));
+  });
+  bench::run("  merge (SIMD)", rounds, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::intersect_merge_simd(
+        a.data(), a.size(), b.data(), b.size(), out.data()));
+  });
+  bench::run("  gallop", rounds, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::intersect_gallop(
+        a.data(), a.size(), b.data(), b.size(), out.data()));
+  });
+}
+
+} // anonymous namespace
+
+int main() {
+  constexpr std::size_t SET_SIZE = 64 * 1024;
+  constexpr std::size_t ROUNDS = 2'000;
+  std::mt19937_64 rng(7);
+
+  // Dense universe → ~50% of IDs shared; sparse universe → ~3% shared
+  const auto dense_a = random_ids(SET_SIZE, 2 * SET_SIZE, rng);
+  const auto dense_b = random_ids(SET_SIZE, 2 * SET_SIZE, rng);
+  compare_kernels("high overlap", dense_a, dense_b, ROUNDS);
+
+  const auto sparse_a = random_ids(SET_SIZE, 32 * SET_SIZE, rng);
+  const auto sparse_b = random_ids(SET_SIZE, 32 * SET_SIZE, rng);
+  compare_kernels("low overlap", sparse_a, sparse_b, ROUNDS);
+
+  const auto tiny = random_ids(100, 2 * SET_SIZE, rng);
+  compare_kernels("skewed", tiny, dense_b, ROUNDS * 10);
+
+  // End-to-end SINTER over three keys (includes formatting the result)
+  const Set x = make_set(dense_a);
+  const Set y = make_set(dense_b);
+  const Set z = make_set(random_ids(SET_SIZE, 2 * SET_SIZE, rng));
+  const std::vector<const Set *> keys{&x, &y, &z};
+  bench::run("SINTER 3 x 64K intsets", ROUNDS / 10, [&](std::size_t) {
+    bench::do_not_optimize(Set::intersect(keys).size());
+  });
+
+  return 0;
+}
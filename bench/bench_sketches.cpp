@@ -0,0 +1,108 @@
+// =============================================================================
+// bench_sketches.cpp — Bloom Filter & Count-Min Sketch Benchmarks
+// =============================================================================
+//
+// Compares one-at-a-time calls against the batched APIs (hash everything
+// first, then probe with prefetching) on structures far bigger than the
+// CPU caches, where every probe is otherwise a cache miss.
+// Also times a full snapshot encode/decode of a store holding both.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/bloom_filter.hpp"
+#include "core/count_min_sketch.hpp"
+#include "core/key_value_store.hpp"
+#include "core/snapshot.hpp"
+
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+using mini_redis::BloomFilter;
+using mini_redis::CountMinSketch;
+namespace bench = mini_redis::bench;
+
+int main() {
+  constexpr std::size_t ITEMS = 2'000'000;
+  constexpr std::size_t BATCH = 1000;
+
+  std::vector<std::string> items;
+  items.reserve(ITEMS);
+  for (std::size_t i = 0; i < ITEMS; ++i) {
+    items.push_back("user:" + std::to_string(i));
+  }
+
+  // ---- Bloom filter: ~2.4 MB per million items at 1% ----
+  BloomFilter filter(0.01, ITEMS);
+  bench::run("BF.ADD (single)", ITEMS, [&](std::size_t i) {
+    bench::do_not_optimize(filter.add(items[i]));
+  });
+  bench::run("BF.EXISTS (single)", ITEMS, [&](std::size_t i) {
+    bench::do_not_optimize(filter.contains(items[(i * 7919) % ITEMS]));
+  });
+
+  std::vector<std::vector<std::string>> batches;
+  for (std::size_t i = 0; i < ITEMS; i += BATCH) {
+    std::vector<std::string> batch;
+    for (std::size_t j = 0; j < BATCH; ++j) {
+      batch.push_back(items[((i + j) * 7919) % ITEMS]);
+    }
+    batches.push_back(std::move(batch));
+  }
+  bench::run("BF.MEXISTS (batch of 1000)", batches.size(), [&](std::size_t b) {
+    bench::do_not_optimize(filter.contains_all(batches[b]));
+  });
+  std::printf("  (per item: divide by %zu)\n", BATCH);
+
+  BloomFilter batched(0.01, ITEMS);
+  bench::run("BF.MADD (batch of 1000)", batches.size(), [&](std::size_t b) {
+    bench::do_not_optimize(batched.add_all(batches[b]));
+  });
+  std::printf("filter: %zu items, %zu bytes, %zu layer(s)\n", filter.size(),
+              filter.memory_bytes(), filter.layer_count());
+
+  // ---- Count-min sketch: wide enough to spill out of L2 ----
+  CountMinSketch sketch(1 << 18, 5); // 10 MB of counters
+  bench::run("CMS.INCRBY (single)", ITEMS, [&](std::size_t i) {
+    bench::do_not_optimize(sketch.increment(items[i]));
+  });
+
+  std::vector<std::vector<std::pair<std::string, std::uint64_t>>> increments;
+  for (const auto &batch : batches) {
+    std::vector<std::pair<std::string, std::uint64_t>> pairs;
+    for (const auto &item : batch) {
+      pairs.emplace_back(item, 1);
+    }
+    increments.push_back(std::move(pairs));
+  }
+  bench::run("CMS.INCRBY (batch of 1000)", increments.size(),
+             [&](std::size_t b) {
+               bench::do_not_optimize(sketch.increment_all(increments[b]));
+             });
+  bench::run("CMS.QUERY (batch of 1000)", batches.size(), [&](std::size_t b) {
+    bench::do_not_optimize(sketch.query_all(batches[b]));
+  });
+
+  // ---- Snapshot of a store holding both ----
+  mini_redis::KeyValueStore store;
+  store.modify_as<BloomFilter>("seen", true, [&](BloomFilter &f) {
+    f = filter;
+    return true;
+  });
+  store.modify_as<CountMinSketch>("hits", true, [&](CountMinSketch &s) {
+    s = sketch;
+    return true;
+  });
+  std::string bytes;
+  bench::run("snapshot encode", 20, [&](std::size_t) {
+    bytes = mini_redis::encode_snapshot(store);
+  });
+  bench::run("snapshot decode", 20, [&](std::size_t) {
+    mini_redis::KeyValueStore restored;
+    bench::do_not_optimize(mini_redis::decode_snapshot(restored, bytes));
+  });
+  std::printf("snapshot: %zu bytes\n", bytes.size());
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+// =============================================================================
+// bench_sorted_set.cpp — Sorted Set Benchmarks (1M members)
+// =============================================================================
+//
+// Measures the leaderboard operations on a 1,000,000-member SortedSet:
+// inserts, score updates, rank lookups, rank windows and score ranges.
+// Every lookup should stay O(log n), so ns/op should be roughly flat as the
+// set grows.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/sorted_set.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::SortedSet;
+namespace bench = mini_redis::bench;
+
+int main() {
+  constexpr std::size_t MEMBERS = 1'000'000;
+  constexpr std::size_t QUERIES = 200'000;
+
+  // Pre-generate members and scores so string formatting and random number
+  // generation aren't part of what we time
+  std::mt19937_64 rng(42);
+  std::uniform_real_distribution<double> score_dist(0.0, 1e6);
+  std::vector<std::string> members(MEMBERS);
+  std::vector<double> scores(MEMBERS);
+  for (std::size_t i = 0; i < MEMBERS; ++i) {
+    members[i] = "player:" + std::to_string(i);
+    scores[i] = score_dist(rng);
+  }
+  std::vector<std::size_t> picks(QUERIES);
+  for (auto &pick : picks) {
+    pick = rng() % MEMBERS;
+  }
+
+  SortedSet zset;
+  bench::run("ZADD (new members)", MEMBERS,
+             [&](std::size_t i) { zset.add(members[i], scores[i]); });
+
+  bench::run("ZINCRBY (random member)", QUERIES, [&](std::size_t i) {
+    bench::do_not_optimize(zset.increment(members[picks[i]], 1.0));
+  });
+
+  bench::run("ZSCORE (random member)", QUERIES, [&](std::size_t i) {
+    bench::do_not_optimize(zset.score(members[picks[i]]));
+  });
+
+  bench::run("ZRANK (random member)", QUERIES, [&](std::size_t i) {
+    bench::do_not_optimize(zset.rank(members[picks[i]]));
+  });
+
+  bench::run("ZRANGE (10 by rank, random offset)", QUERIES, [&](std::size_t i) {
+    const auto start = static_cast<long long>(picks[i]);
+    bench::do_not_optimize(zset.range_by_rank(start, start + 9).size());
+  });
+
+  bench::run("ZRANGE (top 100)", QUERIES / 10, [&](std::size_t) {
+    bench::do_not_optimize(zset.range_by_rank(-100, -1).size());
+  });
+
+  bench::run("ZRANGEBYSCORE (width 10)", QUERIES, [&](std::size_t i) {
+    const double min = scores[picks[i]];
+    bench::do_not_optimize(zset.range_by_score(min, min + 10.0).size());
+  });
+
+  bench::run("ZREM (random member)", QUERIES, [&](std::size_t i) {
+    bench::do_not_optimize(zset.remove(members[picks[i]]));
+  });
+
+  return 0;
+}
@@ -0,0 +1,72 @@
+// =============================================================================
+// bench_stream.cpp — Stream Benchmarks
+// =============================================================================
+//
+// An event log of 1M entries shaped like typical telemetry: the same three
+// fields every time, one ID per millisecond with occasional bursts in the
+// same millisecond. Reports bytes per entry (packed blocks vs ~150 bytes
+// for a hash per event), append speed, and the two read patterns that
+// matter: a tailing reader ("after my last ID") and a historical XRANGE.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/stream.hpp"
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::Stream;
+using mini_redis::StreamFields;
+using mini_redis::StreamId;
+namespace bench = mini_redis::bench;
+
+int main() {
+  constexpr std::size_t ENTRIES = 1'000'000;
+  constexpr std::uint64_t START = 1'700'000'000'000;
+
+  std::mt19937_64 rng(42);
+  std::vector<StreamFields> events;
+  events.reserve(ENTRIES);
+  for (std::size_t i = 0; i < ENTRIES; ++i) {
+    events.push_back({{"device", "d" + std::to_string(rng() % 1000)},
+                      {"kind", (rng() % 4 == 0) ? "alert" : "reading"},
+                      {"value", std::to_string(rng() % 10'000)}});
+  }
+
+  Stream stream;
+  std::uint64_t clock = START;
+  bench::run("XADD *", ENTRIES, [&](std::size_t i) {
+    clock += (rng() % 8 == 0) ? 0 : 1; // bursts share a millisecond
+    stream.add(*stream.next_id(clock), events[i]);
+  });
+  std::printf("  %.2f bytes/entry (%zu entries in %zu blocks, %zu KB)\n",
+              static_cast<double>(stream.memory_bytes()) /
+                  static_cast<double>(stream.size()),
+              stream.size(), stream.block_count(),
+              stream.memory_bytes() / 1024);
+
+  const StreamId last = stream.last_id();
+  bench::run("XREAD tail (last 10 entries)", 500'000, [&](std::size_t) {
+    bench::do_not_optimize(
+        stream.read_after(StreamId{last.ms > 10 ? last.ms - 10 : 0, 0}));
+  });
+
+  bench::run("XRANGE 100 entries, random start", 200'000, [&](std::size_t) {
+    const StreamId start{START + rng() % (last.ms - START), 0};
+    bench::do_not_optimize(stream.range(start, StreamId::max(), 100));
+  });
+
+  const double scans = bench::run("XRANGE - + (full scan)", 5, [&](std::size_t) {
+    bench::do_not_optimize(stream.range(StreamId::min(), StreamId::max()));
+  });
+  std::printf("  %.1f M entries/s decoded\n",
+              scans * static_cast<double>(ENTRIES) / 1e6);
+
+  bench::run("XTRIM MAXLEN (keep 900k, 1 entry at a time)", 100'000,
+             [&](std::size_t i) {
+               stream.trim_max_len(ENTRIES - 1 - i);
+             });
+  return 0;
+}
@@ -0,0 +1,82 @@
+// =============================================================================
+// bench_time_series.cpp — Time-Series Benchmarks
+// =============================================================================
+//
+// A day of per-second samples (86,400) for 20 series, shaped like real
+// metrics: a steady interval with occasional jitter, values that drift
+// slowly at one decimal of precision. Reports bytes per sample — the
+// number that matters against ~100 bytes for one key per sample — plus
+// append speed and full-range decode with and without downsampling.
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/time_series.hpp"
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using mini_redis::TimeSeries;
+namespace bench = mini_redis::bench;
+
+int main() {
+  constexpr std::size_t SERIES = 20;
+  constexpr std::size_t SAMPLES = 86'400;
+  constexpr std::int64_t START = 1'700'000'000'000;
+
+  std::mt19937_64 rng(42);
+  std::vector<std::vector<TimeSeries::Sample>> input(SERIES);
+  for (auto &samples : input) {
+    std::int64_t ts = START;
+    double value = 50.0;
+    samples.reserve(SAMPLES);
+    for (std::size_t i = 0; i < SAMPLES; ++i) {
+      ts += (rng() % 50 == 0) ? 1000 + static_cast<std::int64_t>(rng() % 7)
+                              : 1000;
+      value += (static_cast<double>(rng() % 21) - 10.0) / 100.0;
+      samples.push_back({ts, std::round(value * 10) / 10});
+    }
+  }
+
+  std::vector<TimeSeries> series(SERIES);
+  bench::run("TS.ADD (in order)", SERIES * SAMPLES, [&](std::size_t i) {
+    const auto &sample = input[i / SAMPLES][i % SAMPLES];
+    series[i / SAMPLES].add(sample.timestamp, sample.value);
+  });
+
+  std::size_t bytes = 0;
+  std::size_t count = 0;
+  for (const auto &one : series) {
+    bytes += one.memory_bytes();
+    count += one.size();
+  }
+  std::printf("  %.2f bytes/sample (%zu samples in %zu KB)\n",
+              static_cast<double>(bytes) / static_cast<double>(count), count,
+              bytes / 1024);
+
+  const double ranges =
+      bench::run("TS.RANGE full day (raw)", SERIES * 5, [&](std::size_t i) {
+        bench::do_not_optimize(series[i % SERIES].range(START, START * 2));
+      });
+  std::printf("  %.0f M samples/s decoded\n",
+              ranges * static_cast<double>(SAMPLES) / 1e6);
+
+  bench::run("TS.RANGE full day (avg per 1 min)", SERIES * 5,
+             [&](std::size_t i) {
+               bench::do_not_optimize(series[i % SERIES].range(
+                   START, START * 2, TimeSeries::Aggregation::AVG, 60'000));
+             });
+  bench::run("TS.RANGE last 5 minutes", 200'000, [&](std::size_t i) {
+    const std::int64_t end = START + SAMPLES * 1000;
+    bench::do_not_optimize(
+        series[i % SERIES].range(end - 300'000, end + 1000));
+  });
+
+  TimeSeries jittered;
+  bench::run("TS.ADD (1% out of order)", SAMPLES, [&](std::size_t i) {
+    const auto &sample = input[0][(i % 100 == 99 && i > 200) ? i - 150 : i];
+    jittered.add(sample.timestamp, sample.value);
+  });
+  return 0;
+}
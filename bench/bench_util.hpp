@@ -0,0 +1,44 @@
+// =============================================================================
+// bench_util.hpp — Tiny Timing Helpers for the Micro-Benchmarks
+// =============================================================================
+//
+// Each benchmark is: "run this lambda N times, report ops/second".
+// We use steady_clock (monotonic — see key_value_store.hpp) for timing.
+//
+// THE OPTIMIZER TRAP:
+// If a benchmark computes a result and never uses it, the compiler may
+// delete the whole computation ("dead code elimination") and you'd measure
+// nothing. do_not_optimize() hides a value from the optimizer so the work
+// that produced it must really happen.
+// =============================================================================
+
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+
+namespace mini_redis::bench {
+
+// Force the compiler to assume 'value' is read (GCC/Clang inline asm)
+template <typename T> inline void do_not_optimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Time 'ops' calls of body(i) and print one aligned result line
+template <typename Body>
+double run(const char *label, std::size_t ops, Body &&body) {
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t i = 0; i < ops; ++i) {
+    body(i);
+  }
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+
+  const double seconds = std::chrono::duration<double>(elapsed).count();
+  const double ops_per_sec = static_cast<double>(ops) / seconds;
+  std::printf("%-40s %10zu ops %9.3f s %12.0f ops/s %8.1f ns/op\n", label, ops,
+              seconds, ops_per_sec, seconds * 1e9 / static_cast<double>(ops));
+  return ops_per_sec;
+}
+
+} // namespace mini_redis::bench
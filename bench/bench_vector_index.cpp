@@ -0,0 +1,149 @@
+// =============================================================================
+// bench_vector_index.cpp — Vector Search Benchmarks on 1M x 128-d Vectors
+// =============================================================================
+//
+// One million 128-dimensional embeddings (the size of a SIFT descriptor or
+// a small sentence-embedding model), drawn around 100 cluster centres the
+// way real embeddings cluster by topic. Measures:
+//   - the distance kernels, SIMD against the portable loops;
+//   - HNSW build cost per insert;
+//   - brute-force KNN (exact, the ground truth);
+//   - HNSW recall@10 and queries/second as 'ef' grows.
+// for float32 and int8 storage. Pass a vector count to run a smaller set:
+//   ./bench_vector_index 100000
+// =============================================================================
+
+#include "bench_util.hpp"
+#include "core/vector_index.hpp"
+#include "core/vector_ops.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using mini_redis::VectorIndex;
+namespace bench = mini_redis::bench;
+
+namespace {
+
+constexpr std::size_t DIM = 128;
+constexpr std::size_t CENTRES = 100;
+constexpr std::size_t QUERIES = 200;
+constexpr std::size_t K = 10;
+
+class ClusteredVectors {
+public:
+  ClusteredVectors() : rng_(1), centres_(CENTRES, std::vector<float>(DIM)) {
+    for (auto &centre : centres_) {
+      for (auto &value : centre) {
+        value = normal_(rng_);
+      }
+    }
+  }
+
+  std::vector<float> next() {
+    const auto &centre = centres_[rng_() % CENTRES];
+    std::vector<float> vector(DIM);
+    for (std::size_t i = 0; i < DIM; ++i) {
+      vector[i] = centre[i] + 0.5f * normal_(rng_);
+    }
+    return vector;
+  }
+
+private:
+  std::mt19937_64 rng_;
+  std::normal_distribution<float> normal_{0.0f, 1.0f};
+  std::vector<std::vector<float>> centres_;
+};
+
+void bench_kernels() {
+  constexpr std::size_t PAIRS = 20'000'000;
+  ClusteredVectors source;
+  const auto a = source.next();
+  const auto b = source.next();
+  std::vector<std::int8_t> x(DIM);
+  std::vector<std::int8_t> y(DIM);
+  for (std::size_t i = 0; i < DIM; ++i) {
+    x[i] = static_cast<std::int8_t>(static_cast<int>(a[i] * 40.0f) % 127);
+    y[i] = static_cast<std::int8_t>(static_cast<int>(b[i] * 40.0f) % 127);
+  }
+
+  bench::run("dot 128-d float32 (scalar)", PAIRS, [&](std::size_t) {
+    bench::do_not_optimize(
+        mini_redis::dot_f32_scalar(a.data(), b.data(), DIM));
+  });
+  bench::run("dot 128-d float32 (SIMD)", PAIRS, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::dot_f32(a.data(), b.data(), DIM));
+  });
+  bench::run("L2 128-d float32 (SIMD)", PAIRS, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::l2_sq_f32(a.data(), b.data(), DIM));
+  });
+  bench::run("dot 128-d int8 (scalar)", PAIRS, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::dot_i8_scalar(x.data(), y.data(), DIM));
+  });
+  bench::run("dot 128-d int8 (SIMD)", PAIRS, [&](std::size_t) {
+    bench::do_not_optimize(mini_redis::dot_i8(x.data(), y.data(), DIM));
+  });
+}
+
+void bench_index(VectorIndex::Quantization quantization, std::size_t count) {
+  const bool int8 = quantization == VectorIndex::Quantization::INT8;
+  std::printf("\n--- %zu x %zu-d, cosine, %s ---\n", count, DIM,
+              int8 ? "int8" : "float32");
+
+  ClusteredVectors source;
+  VectorIndex::Options options;
+  options.dim = DIM;
+  options.quantization = quantization;
+  options.algorithm = VectorIndex::Algorithm::HNSW;
+  VectorIndex index(options);
+
+  bench::run(int8 ? "VADD (HNSW insert, int8)" : "VADD (HNSW insert)", count,
+             [&](std::size_t i) {
+               index.add("v" + std::to_string(i), source.next());
+             });
+  std::printf("  memory: %.1f MB (%.0f bytes/vector)\n",
+              static_cast<double>(index.memory_bytes()) / 1e6,
+              static_cast<double>(index.memory_bytes()) /
+                  static_cast<double>(count));
+
+  std::vector<std::vector<float>> queries;
+  for (std::size_t i = 0; i < QUERIES; ++i) {
+    queries.push_back(source.next());
+  }
+
+  std::vector<std::set<std::string>> truth(QUERIES);
+  bench::run("KNN k=10 brute force (exact)", QUERIES, [&](std::size_t i) {
+    for (const auto &match : index.knn_exact(queries[i], K)) {
+      truth[i].insert(match.name);
+    }
+  });
+
+  for (const std::size_t ef : {10u, 50u, 100u, 200u, 400u}) {
+    std::size_t found = 0;
+    const std::string label = "KNN k=10 HNSW ef=" + std::to_string(ef);
+    bench::run(label.c_str(), QUERIES, [&](std::size_t i) {
+      for (const auto &match : index.knn(queries[i], K, ef)) {
+        found += truth[i].count(match.name);
+      }
+    });
+    std::printf("  recall@10: %.3f\n",
+                static_cast<double>(found) /
+                    static_cast<double>(QUERIES * K));
+  }
+}
+
+} // anonymous namespace
+
+int main(int argc, char **argv) {
+  const std::size_t count =
+      argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  bench_kernels();
+  bench_index(VectorIndex::Quantization::FLOAT32, count);
+  bench_index(VectorIndex::Quantization::INT8, count);
+  return 0;
+}
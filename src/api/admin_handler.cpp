@@ -0,0 +1,326 @@
+// =============================================================================
+// admin_handler.cpp — Server Administration Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/admin_handler.hpp"
+#include "api/handler_util.hpp"
+#include "core/snapshot.hpp"
+#include "util/allocator.hpp"
+#include "util/logger.hpp"
+
+#include <cstdio>
+#include <utility> // std::move
+
+namespace mini_redis {
+
+AdminHandler::AdminHandler(KeyValueStore &store, Defragmenter &defragmenter,
+                           const RateLimiter &rate_limiter,
+                           RuntimeConfig &config, std::string snapshot_path)
+    : store_(store), defragmenter_(defragmenter), rate_limiter_(rate_limiter),
+      config_(config), snapshot_path_(std::move(snapshot_path)) {}
+
+void AdminHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::POST, "/admin/save",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return save(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/admin/memory",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return memory(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/admin/memory/purge",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return memory_purge(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/admin/memory/decay",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return memory_decay(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/admin/memory/defrag",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return memory_defrag(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/admin/memory/dedup",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return memory_dedup(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/admin/memory/compress",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return memory_compress(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/admin/ratelimit",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return rate_limit(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/admin/backing",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return backing(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/admin/config",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return config(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/admin/config/reload",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return config_reload(req, params);
+                   });
+
+  Logger::info("Admin handler routes registered");
+}
+
+// =============================================================================
+// POST /admin/save
+// =============================================================================
+HttpResponse AdminHandler::save(const HttpRequest & /*request*/,
+                                const RouteParams & /*params*/) {
+  const auto saved = save_snapshot(store_, snapshot_path_);
+  if (!saved.has_value()) {
+    return HttpResponse::internal_error().body("ERR snapshot failed");
+  }
+  return HttpResponse::ok().body("OK " + std::to_string(*saved) + " keys");
+}
+
+// =============================================================================
+// GET /admin/memory
+// =============================================================================
+// One "name value" line per statistic, in the spirit of INFO memory:
+//   allocator system
+//   allocations 1048576
+//   ...
+// =============================================================================
+HttpResponse AdminHandler::memory(const HttpRequest & /*request*/,
+                                  const RouteParams & /*params*/) {
+  const AllocatorStats stats = Allocator::stats();
+  std::string body = "allocator " + std::string(stats.backend) + "\n";
+  const auto line = [&body](const char *name, std::uint64_t value) {
+    body += name;
+    body += ' ';
+    body += std::to_string(value);
+    body += '\n';
+  };
+  line("allocations", stats.allocations);
+  line("frees", stats.frees);
+  line("thread_cache_hits", stats.cache_hits);
+  line("thread_cache_bytes", stats.cached_bytes);
+  line("thread_caches", stats.threads);
+  line("heap_used_bytes", stats.heap_used_bytes);
+  line("heap_free_bytes", stats.heap_free_bytes);
+  line("resident_bytes", stats.resident_bytes);
+  line("decay_ms", stats.decay_ms);
+  line("purges", stats.purges);
+  body += "page_backing " + std::string(stats.page_backing) + "\n";
+  line("arena_capacity_bytes", stats.arena_capacity_bytes);
+  line("arena_used_bytes", stats.arena_used_bytes);
+  line("huge_pages", stats.huge_pages);
+  line("arena_slab_bytes", stats.arena_slab_bytes);
+  line("arena_live_bytes", stats.arena_live_bytes);
+
+  const DefragStats defrag = defragmenter_.stats();
+  char ratio[32];
+  std::snprintf(ratio, sizeof(ratio), "%.2f", defrag.fragmentation_ratio);
+  body += "fragmentation_ratio " + std::string(ratio) + "\n";
+  line("defrag_active", defrag.active ? 1 : 0);
+  line("defrag_runs", defrag.runs);
+  line("defrag_passes", defrag.passes);
+  line("defrag_moved", defrag.moved);
+
+  // Hit rate = hits / (hits + misses); saved = what the copies would take
+  const InternStats dedup = store_.dedup_stats();
+  line("dedup_min_bytes", dedup.min_bytes);
+  line("dedup_values", dedup.values);
+  line("dedup_references", dedup.references);
+  line("dedup_hits", dedup.hits);
+  line("dedup_misses", dedup.misses);
+  line("dedup_unique_bytes", dedup.unique_bytes);
+  line("dedup_saved_bytes", dedup.saved_bytes());
+
+  // Totals over the writes since startup, not what is stored right now
+  const CompressionStats compression = store_.compression_stats();
+  line("compress_min_bytes", compression.min_bytes);
+  line("compress_values", compression.compressed);
+  line("compress_rejected", compression.rejected);
+  line("compress_raw_bytes", compression.raw_bytes);
+  line("compress_stored_bytes", compression.compressed_bytes);
+
+  // Which table the keys live in (see parse_integer_key())
+  const KeyCounts counts = store_.key_counts();
+  line("keys_integer", counts.integer);
+  line("keys_string", counts.string);
+
+  // Small values GET can read without locking (see inline_values.hpp)
+  const InlineValueStats inline_values = store_.inline_value_stats();
+  line("inline_max_bytes", inline_values.max_bytes);
+  line("inline_values", inline_values.values);
+  return HttpResponse::ok().body(body);
+}
+
+// =============================================================================
+// POST /admin/memory/purge
+// =============================================================================
+HttpResponse AdminHandler::memory_purge(const HttpRequest & /*request*/,
+                                        const RouteParams & /*params*/) {
+  const std::uint64_t before = Allocator::stats().resident_bytes;
+  Allocator::purge();
+  const std::uint64_t after = Allocator::stats().resident_bytes;
+  return HttpResponse::ok().body(
+      "OK resident " + std::to_string(before) + " -> " + std::to_string(after));
+}
+
+// =============================================================================
+// POST /admin/memory/decay?ms=N
+// =============================================================================
+HttpResponse AdminHandler::memory_decay(const HttpRequest &request,
+                                        const RouteParams & /*params*/) {
+  const auto text = request.get_query_param("ms");
+  const auto ms = text ? parse_integer(*text) : std::nullopt;
+  if (!ms.has_value() || *ms < 0) {
+    return HttpResponse::bad_request().body(
+        "ERR ms must be a non-negative integer");
+  }
+  Allocator::set_decay_ms(static_cast<std::uint64_t>(*ms));
+  Logger::info("Allocator decay set to " + std::to_string(*ms) + " ms");
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /admin/memory/defrag
+// =============================================================================
+// Runs on the request's worker thread, outside the CPU budget: for an
+// operator who wants the memory back now rather than at 10% of a core.
+// =============================================================================
+HttpResponse AdminHandler::memory_defrag(const HttpRequest & /*request*/,
+                                         const RouteParams & /*params*/) {
+  const std::uint64_t moved = defragmenter_.run_pass();
+  return HttpResponse::ok().body("OK moved " + std::to_string(moved));
+}
+
+// =============================================================================
+// POST /admin/memory/dedup?min_bytes=N
+// =============================================================================
+HttpResponse AdminHandler::memory_dedup(const HttpRequest &request,
+                                        const RouteParams & /*params*/) {
+  const auto text = request.get_query_param("min_bytes");
+  const auto min_bytes = text ? parse_integer(*text) : std::nullopt;
+  if (!min_bytes.has_value() || *min_bytes < 0) {
+    return HttpResponse::bad_request().body(
+        "ERR min_bytes must be a non-negative integer");
+  }
+  store_.set_dedup_min_bytes(static_cast<std::size_t>(*min_bytes));
+  Logger::info("Value dedup threshold set to " + std::to_string(*min_bytes) +
+               " bytes");
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /admin/memory/compress?min_bytes=N
+// =============================================================================
+HttpResponse AdminHandler::memory_compress(const HttpRequest &request,
+                                           const RouteParams & /*params*/) {
+  const auto text = request.get_query_param("min_bytes");
+  const auto min_bytes = text ? parse_integer(*text) : std::nullopt;
+  if (!min_bytes.has_value() || *min_bytes < 0) {
+    return HttpResponse::bad_request().body(
+        "ERR min_bytes must be a non-negative integer");
+  }
+  store_.set_compression_min_bytes(static_cast<std::size_t>(*min_bytes));
+  Logger::info("Value compression threshold set to " +
+               std::to_string(*min_bytes) + " bytes");
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// GET /admin/ratelimit
+// =============================================================================
+//   rate 100             tokens per second per client (0 = off)
+//   burst 200
+//   by ip                what a client is (rate_limit_by)
+//   allowed 123456       requests let through since startup
+//   rejected 789         answered 429
+//   untracked 0          let through with no bucket free for the client
+//   active_clients 42    clients with a bucket not yet back to full
+// =============================================================================
+HttpResponse AdminHandler::rate_limit(const HttpRequest & /*request*/,
+                                      const RouteParams & /*params*/) {
+  const RateLimiterStats stats = rate_limiter_.stats();
+  std::string body;
+  body += "rate " + std::to_string(stats.rate) + "\n";
+  body += "burst " + std::to_string(stats.burst) + "\n";
+  body += std::string("by ") +
+          rate_limit_key_name(config_.current().rate_limit_by) + "\n";
+  body += "allowed " + std::to_string(stats.allowed) + "\n";
+  body += "rejected " + std::to_string(stats.rejected) + "\n";
+  body += "untracked " + std::to_string(stats.untracked) + "\n";
+  body += "active_clients " + std::to_string(stats.active_clients);
+  return HttpResponse::ok().body(body);
+}
+
+// =============================================================================
+// GET /admin/backing
+// =============================================================================
+//   loads 120            misses sent to the backing store
+//   load_hits 97         ... that found the key
+//   coalesced 4031       misses that waited on another's load instead
+//   queue_hits 3         misses answered by a write not yet sent
+//   queued 51200         writes queued (SET and DEL)
+//   superseded 48000     ... replaced by a newer write to the same key
+//   written 3200         writes sent
+//   batches 13           write batches sent
+//   failed_batches 0     write batches that failed (and were retried)
+//   pending 0            writes queued or being sent right now
+//
+// 404 when the server runs without a backing store (backing_dir unset).
+// =============================================================================
+HttpResponse AdminHandler::backing(const HttpRequest & /*request*/,
+                                   const RouteParams & /*params*/) {
+  const auto stats = store_.backing_stats();
+  if (!stats.has_value()) {
+    return HttpResponse::not_found().body("ERR no backing store");
+  }
+  std::string body;
+  body += "loads " + std::to_string(stats->loads) + "\n";
+  body += "load_hits " + std::to_string(stats->load_hits) + "\n";
+  body += "coalesced " + std::to_string(stats->coalesced) + "\n";
+  body += "queue_hits " + std::to_string(stats->queue_hits) + "\n";
+  body += "queued " + std::to_string(stats->queued) + "\n";
+  body += "superseded " + std::to_string(stats->superseded) + "\n";
+  body += "written " + std::to_string(stats->written) + "\n";
+  body += "batches " + std::to_string(stats->batches) + "\n";
+  body += "failed_batches " + std::to_string(stats->failed_batches) + "\n";
+  body += "pending " + std::to_string(stats->pending);
+  return HttpResponse::ok().body(body);
+}
+
+// =============================================================================
+// GET /admin/config
+// =============================================================================
+HttpResponse AdminHandler::config(const HttpRequest & /*request*/,
+                                  const RouteParams & /*params*/) {
+  return HttpResponse::ok().body(format_config(config_.current()));
+}
+
+// =============================================================================
+// POST /admin/config/reload
+// =============================================================================
+// "OK", then one line per setting that changed:
+//   applied log_level error
+//   restart port 9090
+// A source that no longer parses changes nothing and answers 400 with
+// the reason (file and line, or the variable).
+// =============================================================================
+HttpResponse AdminHandler::config_reload(const HttpRequest & /*request*/,
+                                         const RouteParams & /*params*/) {
+  const auto result = config_.reload();
+  if (!result.ok) {
+    return HttpResponse::bad_request().body("ERR " + result.error);
+  }
+  std::string body = "OK";
+  for (const std::string &change : result.applied) {
+    body += "\napplied " + change;
+  }
+  for (const std::string &change : result.needs_restart) {
+    body += "\nrestart " + change;
+  }
+  return HttpResponse::ok().body(body);
+}
+
+} // namespace mini_redis
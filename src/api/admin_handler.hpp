@@ -0,0 +1,78 @@
+// =============================================================================
+// admin_handler.hpp — Server Administration Endpoints (HEADER)
+// =============================================================================
+//
+// Operations on the server as a whole rather than on one key:
+//
+//   POST /admin/save          → write a snapshot of every key to disk (SAVE)
+//   GET  /admin/memory        → allocator statistics, "name value" lines
+//   POST /admin/memory/purge  → give cached / free memory back now
+//   POST /admin/memory/decay?ms=N → purge automatically every N ms (0 = off)
+//   POST /admin/memory/defrag → one full defragmentation pass right now
+//   POST /admin/memory/dedup?min_bytes=N → share identical values of at
+//                               least N bytes between keys (0 = off)
+//   POST /admin/memory/compress?min_bytes=N → store string values of at
+//                               least N bytes LZ4-compressed (0 = off)
+//   GET  /admin/ratelimit     → rate limiter settings and counters
+//   GET  /admin/backing       → read-through / write-behind counters
+//   GET  /admin/config        → every setting, "name value" lines
+//   POST /admin/config/reload → re-read the config file, environment and
+//                               flags; apply the live settings (like SIGHUP)
+//
+// The snapshot file is also loaded at startup and written at shutdown by
+// the Application; this endpoint lets you checkpoint in between.
+// =============================================================================
+
+#pragma once
+
+#include "app/config.hpp"
+#include "core/defragmenter.hpp"
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+#include "util/rate_limiter.hpp"
+
+#include <string>
+
+namespace mini_redis {
+
+class AdminHandler {
+public:
+  AdminHandler(KeyValueStore &store, Defragmenter &defragmenter,
+               const RateLimiter &rate_limiter, RuntimeConfig &config,
+               std::string snapshot_path);
+
+  // Register all /admin/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse save(const HttpRequest &request, const RouteParams &params);
+  HttpResponse memory(const HttpRequest &request, const RouteParams &params);
+  HttpResponse memory_purge(const HttpRequest &request,
+                            const RouteParams &params);
+  HttpResponse memory_decay(const HttpRequest &request,
+                            const RouteParams &params);
+  HttpResponse memory_defrag(const HttpRequest &request,
+                             const RouteParams &params);
+  HttpResponse memory_dedup(const HttpRequest &request,
+                            const RouteParams &params);
+  HttpResponse memory_compress(const HttpRequest &request,
+                               const RouteParams &params);
+  HttpResponse rate_limit(const HttpRequest &request,
+                          const RouteParams &params);
+  HttpResponse backing(const HttpRequest &request, const RouteParams &params);
+  HttpResponse config(const HttpRequest &request, const RouteParams &params);
+  HttpResponse config_reload(const HttpRequest &request,
+                             const RouteParams &params);
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+  Defragmenter &defragmenter_;
+  const RateLimiter &rate_limiter_;
+  RuntimeConfig &config_;
+  std::string snapshot_path_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,399 @@
+// =============================================================================
+// bitmap_handler.cpp — Bitmap REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/bitmap_handler.hpp"
+#include "api/handler_util.hpp"
+#include "core/bitmap.hpp"
+#include "util/logger.hpp"
+
+#include <string_view>
+
+namespace mini_redis {
+
+namespace {
+
+// ---- Run the reader matching whichever representation 'key' holds ----
+// Two lookups (string first) instead of one: the common case is a plain
+// string, and it keeps read_as() the only way into the store.
+template <typename OnString, typename OnRoaring>
+AccessStatus read_bitmap(KeyValueStore &store, const std::string &key,
+                         OnString on_string, OnRoaring on_roaring) {
+  const auto status = store.read_as<std::string>(key, on_string);
+  if (status != AccessStatus::WRONG_TYPE) {
+    return status;
+  }
+  return store.read_as<RoaringBitmap>(key, on_roaring);
+}
+
+// ?name=<integer>, std::nullopt if absent, 'invalid' set if unparsable
+std::optional<long long> integer_param(const HttpRequest &request,
+                                       const std::string &name, bool &invalid) {
+  const auto text = request.get_query_param(name);
+  if (!text.has_value()) {
+    return std::nullopt;
+  }
+  const auto value = parse_integer(*text);
+  invalid = invalid || !value.has_value();
+  return value;
+}
+
+// ---- BITPOS' rules, shared by both representations ----
+// 'find' searches a resolved byte range and returns a bit offset.
+template <typename Finder>
+long long bit_position(std::uint64_t length, bool bit, long long start,
+                       long long end, bool end_given, Finder find) {
+  if (length == 0) {
+    return bit ? -1 : 0; // an empty bitmap is all zeros
+  }
+  const auto range = resolve_byte_range(start, end, length);
+  if (!range.has_value()) {
+    return -1;
+  }
+  if (const auto found = find(*range)) {
+    return static_cast<long long>(*found);
+  }
+  // No 0 found and no explicit end: the bitmap is conceptually padded with
+  // zeros, so the first clear bit is the one just past the last byte
+  return (!bit && !end_given) ? static_cast<long long>(length * 8) : -1;
+}
+
+std::optional<BitOp> parse_bit_op(std::string_view name) {
+  if (name == "and") {
+    return BitOp::AND;
+  }
+  if (name == "or") {
+    return BitOp::OR;
+  }
+  if (name == "xor") {
+    return BitOp::XOR;
+  }
+  return std::nullopt;
+}
+
+HttpResponse wrong_type_multi() {
+  return HttpResponse::conflict().body(
+      "WRONGTYPE Operation against a key holding the wrong kind of value");
+}
+
+} // anonymous namespace
+
+BitmapHandler::BitmapHandler(KeyValueStore &store) : store_(store) {}
+
+void BitmapHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/bit/set/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return set_bit(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/bit/get/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return get_bit(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/bit/count/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return count(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/bit/pos/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return position(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/bit/op/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return bit_op(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/bit/info/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return info(req, params);
+                   });
+
+  Logger::info("Bitmap handler routes registered");
+}
+
+// =============================================================================
+// PUT /bit/set/{key}?offset=N&value=0|1[&encoding=roaring]
+// =============================================================================
+HttpResponse BitmapHandler::set_bit(const HttpRequest &request,
+                                    const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto offset =
+      parse_integer(request.get_query_param("offset").value_or(""));
+  const auto value = request.get_query_param("value").value_or("");
+  const bool roaring =
+      request.get_query_param("encoding").value_or("") == "roaring";
+  if (key.empty() || !offset || *offset < 0 ||
+      static_cast<std::uint64_t>(*offset) > MAX_BIT_OFFSET ||
+      (value != "0" && value != "1")) {
+    return HttpResponse::bad_request().body(
+        "Usage: ?offset=<0..4294967295>&value=<0|1>[&encoding=roaring]");
+  }
+
+  const auto bit_offset = static_cast<std::uint64_t>(*offset);
+  const bool bit = value == "1";
+  bool old = false;
+
+  // The encoding only matters when the key is CREATED; an existing
+  // bitmap keeps whichever representation it already has
+  auto status = store_.modify_as<std::string>(
+      key, !roaring, [&](std::string &bytes) {
+        old = mini_redis::set_bit(bytes, bit_offset, bit);
+        return true;
+      });
+  if (status == AccessStatus::WRONG_TYPE ||
+      (status == AccessStatus::NOT_FOUND && roaring)) {
+    status = store_.modify_as<RoaringBitmap>(
+        key, roaring, [&](RoaringBitmap &bitmap) {
+          old = bitmap.set(static_cast<std::uint32_t>(bit_offset), bit);
+          return true;
+        });
+  }
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(old ? "1" : "0");
+}
+
+// =============================================================================
+// GET /bit/get/{key}?offset=N
+// =============================================================================
+HttpResponse BitmapHandler::get_bit(const HttpRequest &request,
+                                    const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto offset =
+      parse_integer(request.get_query_param("offset").value_or(""));
+  if (!offset || *offset < 0) {
+    return HttpResponse::bad_request().body("Usage: ?offset=<non-negative>");
+  }
+
+  const auto bit_offset = static_cast<std::uint64_t>(*offset);
+  bool bit = false;
+  const auto status = read_bitmap(
+      store_, key,
+      [&](const std::string &bytes) {
+        bit = mini_redis::get_bit(bytes, bit_offset);
+      },
+      [&](const RoaringBitmap &bitmap) { bit = bitmap.get(bit_offset); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(bit ? "1" : "0");
+}
+
+// =============================================================================
+// GET /bit/count/{key}[?start=&end=]
+// =============================================================================
+HttpResponse BitmapHandler::count(const HttpRequest &request,
+                                  const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  bool invalid = false;
+  const auto start = integer_param(request, "start", invalid);
+  const auto end = integer_param(request, "end", invalid);
+  if (invalid || start.has_value() != end.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: [?start=<byte>&end=<byte>] (both or neither)");
+  }
+
+  std::uint64_t total = 0;
+  const auto status = read_bitmap(
+      store_, key,
+      [&](const std::string &bytes) {
+        const auto range =
+            resolve_byte_range(start.value_or(0), end.value_or(-1), bytes.size());
+        total = range ? count_bits(bytes, *range) : 0;
+      },
+      [&](const RoaringBitmap &bitmap) {
+        if (!start.has_value()) {
+          total = bitmap.count();
+          return;
+        }
+        const auto range =
+            resolve_byte_range(*start, *end, bitmap.byte_length());
+        total = range
+                    ? bitmap.count_range(range->first * 8, range->last * 8 + 7)
+                    : 0;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(total));
+}
+
+// =============================================================================
+// GET /bit/pos/{key}?bit=0|1[&start=&end=]
+// =============================================================================
+HttpResponse BitmapHandler::position(const HttpRequest &request,
+                                     const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto bit_text = request.get_query_param("bit").value_or("");
+  bool invalid = false;
+  const auto start = integer_param(request, "start", invalid);
+  const auto end = integer_param(request, "end", invalid);
+  if (invalid || (bit_text != "0" && bit_text != "1") ||
+      (end.has_value() && !start.has_value())) {
+    return HttpResponse::bad_request().body(
+        "Usage: ?bit=<0|1>[&start=<byte>[&end=<byte>]]");
+  }
+
+  const bool bit = bit_text == "1";
+  const long long first = start.value_or(0);
+  const long long last = end.value_or(-1);
+  long long result = bit ? -1 : 0; // missing key = empty bitmap
+
+  const auto status = read_bitmap(
+      store_, key,
+      [&](const std::string &bytes) {
+        result = bit_position(bytes.size(), bit, first, last, end.has_value(),
+                              [&](ByteRange range) {
+                                return find_bit(bytes, bit, range);
+                              });
+      },
+      [&](const RoaringBitmap &bitmap) {
+        result = bit_position(bitmap.byte_length(), bit, first, last,
+                              end.has_value(), [&](ByteRange range) {
+                                return bitmap.find(bit, range.first * 8,
+                                                   range.last * 8 + 7);
+                              });
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(result));
+}
+
+// =============================================================================
+// POST /bit/op/{op}/{dest} — body: one source key per line
+// =============================================================================
+// Sources are combined under the read lock (into a local result), and the
+// result is written to 'dest' afterwards, like PFMERGE (hll_handler.cpp).
+// =============================================================================
+HttpResponse BitmapHandler::bit_op(const HttpRequest &request,
+                                   const RouteParams &params) {
+  const std::string &suffix = params.path_suffix;
+  const auto slash = suffix.find('/');
+  const auto sources = split_lines(request.body());
+  const std::string op_name =
+      slash == std::string::npos ? "" : suffix.substr(0, slash);
+  const std::string dest =
+      slash == std::string::npos ? "" : suffix.substr(slash + 1);
+  const auto op = parse_bit_op(op_name);
+  const bool is_not = op_name == "not";
+  if (dest.empty() || sources.empty() || (!op && !is_not) ||
+      (is_not && sources.size() != 1)) {
+    return HttpResponse::bad_request().body(
+        "Usage: POST /bit/op/{and|or|xor|not}/{dest}, body = one source key "
+        "per line (exactly one for not)");
+  }
+
+  bool wrong_type = false;
+  std::optional<RoaringBitmap> roaring_result;
+  std::string string_result;
+
+  store_.read_values(sources, [&](const std::vector<const StoreValue *> &values) {
+    bool any_roaring = false;
+    for (const StoreValue *value : values) {
+      if (value == nullptr || string_value(*value) != nullptr) {
+        continue;
+      }
+      if (!std::holds_alternative<RoaringBitmap>(*value)) {
+        wrong_type = true;
+        return;
+      }
+      any_roaring = true;
+    }
+
+    // Any roaring source (except for NOT): work in roaring form, so a
+    // sparse bitmap with a huge offset is never expanded to megabytes
+    if (any_roaring && !is_not) {
+      std::vector<RoaringBitmap> converted;
+      converted.reserve(values.size());
+      std::vector<const RoaringBitmap *> roarings;
+      for (const StoreValue *value : values) {
+        if (value == nullptr) {
+          roarings.push_back(nullptr);
+        } else if (const auto *bitmap = std::get_if<RoaringBitmap>(value)) {
+          roarings.push_back(bitmap);
+        } else {
+          converted.push_back(RoaringBitmap::from_bytes(*string_value(*value)));
+          roarings.push_back(&converted.back());
+        }
+      }
+      roaring_result = RoaringBitmap::combine(*op, roarings);
+      return;
+    }
+
+    // Plain strings (or NOT, whose result is dense anyway)
+    std::string expanded;
+    std::vector<std::string_view> views;
+    for (const StoreValue *value : values) {
+      if (value == nullptr) {
+        views.emplace_back();
+      } else if (const auto *text = string_value(*value)) {
+        views.emplace_back(*text);
+      } else {
+        expanded = std::get<RoaringBitmap>(*value).to_bytes(); // NOT only
+        views.emplace_back(expanded);
+      }
+    }
+    string_result = is_not ? invert_bits(views.front())
+                           : combine_bits(*op, views);
+  });
+
+  if (wrong_type) {
+    return wrong_type_multi();
+  }
+
+  // An empty result deletes the destination, as in Redis
+  std::uint64_t length = 0;
+  if (roaring_result.has_value()) {
+    length = roaring_result->byte_length();
+    if (roaring_result->empty()) {
+      store_.remove(dest);
+    } else {
+      store_.restore(dest,
+                     StoreEntry{std::move(*roaring_result), std::nullopt});
+    }
+  } else {
+    length = string_result.size();
+    if (string_result.empty()) {
+      store_.remove(dest);
+    } else {
+      store_.restore(dest, StoreEntry{std::move(string_result), std::nullopt});
+    }
+  }
+  return HttpResponse::ok().body(std::to_string(length));
+}
+
+// =============================================================================
+// GET /bit/info/{key}
+// =============================================================================
+HttpResponse BitmapHandler::info(const HttpRequest & /*request*/,
+                                 const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::string text;
+  const auto status = read_bitmap(
+      store_, key,
+      [&](const std::string &bytes) {
+        text = "encoding:raw\nlength:" + std::to_string(bytes.size()) +
+               "\nmemory:" + std::to_string(bytes.size());
+      },
+      [&](const RoaringBitmap &bitmap) {
+        text = "encoding:roaring\nlength:" +
+               std::to_string(bitmap.byte_length()) +
+               "\nmemory:" + std::to_string(bitmap.memory_bytes()) +
+               "\ncontainers:" + std::to_string(bitmap.container_count());
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body(text);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,58 @@
+// =============================================================================
+// bitmap_handler.hpp — Bitmap REST Endpoints (HEADER)
+// =============================================================================
+//
+// Bit-level commands on string values (like Redis), plus an opt-in
+// compressed encoding for very sparse bitmaps:
+//
+//   PUT  /bit/set/{key}?offset=N&value=1      → old bit                (SETBIT)
+//        &encoding=roaring                    create as a roaring bitmap
+//   GET  /bit/get/{key}?offset=N              → 0 / 1                  (GETBIT)
+//   GET  /bit/count/{key}[?start=&end=]       → number of set bits     (BITCOUNT)
+//   GET  /bit/pos/{key}?bit=1[&start=&end=]   → first offset, or -1    (BITPOS)
+//   POST /bit/op/{and|or|xor|not}/{dest}      body: source keys        (BITOP)
+//                                             → length of dest in bytes
+//   GET  /bit/info/{key}                      → encoding, length, memory
+//
+// start/end are byte indexes, inclusive, negative = from the end.
+//
+// A key holds either a plain string (GET /kv/{key} returns its raw bytes)
+// or a RoaringBitmap; every command accepts both. BITOP over roaring
+// sources only stays roaring; anything involving a string (or NOT, which
+// turns sparse into dense) produces a string.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class BitmapHandler {
+public:
+  explicit BitmapHandler(KeyValueStore &store);
+
+  // Register all /bit/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse set_bit(const HttpRequest &request, const RouteParams &params);
+  HttpResponse get_bit(const HttpRequest &request,
+                       const RouteParams &params) const;
+  HttpResponse count(const HttpRequest &request,
+                     const RouteParams &params) const;
+  HttpResponse position(const HttpRequest &request,
+                        const RouteParams &params) const;
+  HttpResponse bit_op(const HttpRequest &request, const RouteParams &params);
+  HttpResponse info(const HttpRequest &request,
+                    const RouteParams &params) const;
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
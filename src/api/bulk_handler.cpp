@@ -0,0 +1,115 @@
+// =============================================================================
+// bulk_handler.cpp — Bulk Import / Export Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/bulk_handler.hpp"
+#include "core/bulk_stream.hpp"
+#include "util/logger.hpp"
+
+#include <cstdio> // std::tmpfile, std::fread
+#include <memory> // std::shared_ptr
+#include <string>
+#include <string_view>
+
+namespace mini_redis {
+
+BulkHandler::BulkHandler(KeyValueStore &store) : store_(store) {}
+
+void BulkHandler::register_routes(Router &router) {
+  // A streaming route: the body is NOT read up front, the handler pulls
+  // it from the socket as it goes (see Router::add_streaming_route)
+  router.add_streaming_route(
+      HttpMethod::POST, "/bulk/import",
+      [this](const HttpRequest &req, const RouteParams &params) {
+        return import(req, params);
+      });
+  router.add_route(HttpMethod::GET, "/bulk/export",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return export_all(req, params);
+                   });
+
+  Logger::info("Bulk handler routes registered");
+}
+
+// =============================================================================
+// POST /bulk/import
+// =============================================================================
+// While the importer's workers store one batch, this thread is already
+// reading the next piece from the network. On a malformed stream we stop
+// reading at once: the rest of a multi-GB upload is not worth waiting for.
+// =============================================================================
+HttpResponse BulkHandler::import(const HttpRequest &request,
+                                 const RouteParams & /*params*/) {
+  if (!request.content_length().has_value()) {
+    return HttpResponse::bad_request().body("ERR Content-Length required");
+  }
+
+  BulkImporter importer(store_);
+  bool ok = importer.feed(request.body());
+  while (ok) {
+    const std::string piece = request.next_body_chunk();
+    if (piece.empty()) {
+      break;
+    }
+    ok = importer.feed(piece);
+  }
+  ok = importer.finish() && ok;
+
+  if (!ok) {
+    Logger::warning("Bulk import failed after " +
+                    std::to_string(importer.records()) +
+                    " records: " + importer.error());
+    return HttpResponse::bad_request().body("ERR " + importer.error());
+  }
+  Logger::info("Bulk import: " + std::to_string(importer.records()) + " keys");
+  return HttpResponse::ok().body("OK " + std::to_string(importer.records()) +
+                                 " keys");
+}
+
+// =============================================================================
+// GET /bulk/export
+// =============================================================================
+// Two steps, so that neither the store's locks nor its size in memory
+// depend on how fast the client reads:
+//   1. SPOOL: one point-in-time view of the store is encoded into an
+//      anonymous temporary file (std::tmpfile(), deleted when closed),
+//      one chunk at a time. Writers wait for this step — a walk of the
+//      store at disk-cache speed, like a snapshot — and no longer.
+//   2. SEND: the file is streamed back one chunk at a time with no lock
+//      held; a slow client only keeps a file open.
+// The process holds one EXPORT_CHUNK_BYTES buffer in either step.
+// =============================================================================
+HttpResponse BulkHandler::export_all(const HttpRequest & /*request*/,
+                                     const RouteParams & /*params*/) {
+  std::shared_ptr<std::FILE> spool(std::tmpfile(), [](std::FILE *file) {
+    if (file != nullptr) {
+      std::fclose(file);
+    }
+  });
+  const auto records =
+      spool ? encode_bulk_export(store_, EXPORT_CHUNK_BYTES, spool.get())
+            : std::nullopt;
+  if (!records.has_value() || std::fseek(spool.get(), 0, SEEK_SET) != 0) {
+    Logger::error("Bulk export: cannot write the temporary file");
+    return HttpResponse::internal_error().body("ERR export failed");
+  }
+  Logger::info("Bulk export: " + std::to_string(*records) + " keys");
+
+  return HttpResponse::ok()
+      .header("Content-Type", "application/octet-stream")
+      .stream_body([spool](const HttpResponse::ChunkSink &send) {
+        std::string chunk(EXPORT_CHUNK_BYTES, '\0');
+        while (true) {
+          const std::size_t got =
+              std::fread(chunk.data(), 1, chunk.size(), spool.get());
+          if (got == 0) {
+            return std::ferror(spool.get()) == 0;
+          }
+          if (!send(std::string_view(chunk.data(), got))) {
+            return false; // the client went away
+          }
+        }
+      });
+}
+
+} // namespace mini_redis
@@ -0,0 +1,47 @@
+// =============================================================================
+// bulk_handler.hpp — Bulk Import / Export Endpoints (HEADER)
+// =============================================================================
+// A whole dataset in or out in ONE request, in the bulk stream format
+// (core/bulk_stream.hpp):
+//   POST /bulk/import → store every record of the request body, read from
+//                       the socket as it arrives; "OK <n> keys"
+//   GET  /bulk/export → every key, TTL included, as one chunked response:
+//                       one instant's view, spooled to a temporary file
+// An export is a valid import, so copying one server into another is:
+//   curl -o data.bulk http://a:8080/bulk/export
+//   curl --data-binary @data.bulk http://b:8080/bulk/import
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+#include <cstddef>
+
+namespace mini_redis {
+
+class BulkHandler {
+public:
+  // Export chunk size: large enough that per-chunk costs vanish, small
+  // enough that buffering one (to spool, or to send) costs nothing
+  static constexpr std::size_t EXPORT_CHUNK_BYTES = 1 << 20;
+
+  explicit BulkHandler(KeyValueStore &store);
+
+  // Register the /bulk/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse import(const HttpRequest &request, const RouteParams &params);
+  HttpResponse export_all(const HttpRequest &request,
+                          const RouteParams &params);
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
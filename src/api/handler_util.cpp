@@ -0,0 +1,82 @@
+// =============================================================================
+// handler_util.cpp — Small Helpers Shared by the REST Handlers (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/handler_util.hpp"
+
+#include <cmath>   // std::isnan
+#include <iomanip> // std::setprecision
+#include <sstream>
+
+namespace mini_redis {
+
+std::optional<double> parse_double(const std::string &text) {
+  try {
+    // std::stod reports how many characters it consumed in 'used' —
+    // if that's not ALL of them, the input had trailing garbage
+    std::size_t used = 0;
+    const double value = std::stod(text, &used);
+    if (used != text.size() || std::isnan(value)) {
+      return std::nullopt;
+    }
+    return value;
+  } catch (const std::exception & /*e*/) {
+    // std::invalid_argument (not a number) or std::out_of_range
+    return std::nullopt;
+  }
+}
+
+std::optional<long long> parse_integer(const std::string &text) {
+  try {
+    std::size_t used = 0;
+    const long long value = std::stoll(text, &used);
+    if (used != text.size()) {
+      return std::nullopt;
+    }
+    return value;
+  } catch (const std::exception & /*e*/) {
+    return std::nullopt;
+  }
+}
+
+std::string format_double(double value) {
+  std::ostringstream out;
+  out << std::setprecision(17) << value;
+  return out.str();
+}
+
+std::vector<std::string> split_lines(const std::string &body) {
+  std::vector<std::string> lines;
+  std::istringstream stream(body);
+  std::string line;
+
+  while (std::getline(stream, line)) {
+    if (!line.empty() && line.back() == '\r') {
+      line.pop_back();
+    }
+    if (!line.empty()) {
+      lines.push_back(line);
+    }
+  }
+
+  return lines;
+}
+
+std::string join_lines(const std::vector<std::string> &items) {
+  std::ostringstream out;
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    out << items[i];
+    if (i + 1 < items.size()) {
+      out << "\n";
+    }
+  }
+  return out.str();
+}
+
+HttpResponse wrong_type_response(const std::string &key) {
+  return HttpResponse::conflict().body(
+      "WRONGTYPE Operation against a key holding the wrong kind of value: " +
+      key);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,44 @@
+// =============================================================================
+// handler_util.hpp — Small Helpers Shared by the REST Handlers (HEADER)
+// =============================================================================
+//
+// Every handler needs the same chores: turn query-string text into numbers,
+// turn numbers back into text, split a request body into lines, and answer
+// "that key holds the wrong type". Writing these once keeps each handler
+// focused on its own endpoints (DRY — "Don't Repeat Yourself").
+//
+// They're FREE FUNCTIONS (not a class) because they have no state to share.
+// =============================================================================
+
+#pragma once
+
+#include "http/http_response.hpp"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mini_redis {
+
+// Parse a whole string as a double ("1.5", "-inf", "+inf").
+// Returns std::nullopt on garbage, trailing junk ("1.5abc") or NaN.
+std::optional<double> parse_double(const std::string &text);
+
+// Parse a whole string as a signed 64-bit integer.
+// Returns std::nullopt on garbage, trailing junk or overflow.
+std::optional<long long> parse_integer(const std::string &text);
+
+// Format a double with up to 17 significant digits: 1.5 → "1.5", 3 → "3".
+// Enough digits that parsing the text back yields the SAME double.
+std::string format_double(double value);
+
+// Split a body into non-empty lines (tolerates both "\n" and "\r\n").
+std::vector<std::string> split_lines(const std::string &body);
+
+// The inverse: one item per line, no trailing newline.
+std::string join_lines(const std::vector<std::string> &items);
+
+// 409 Conflict with a Redis-style WRONGTYPE message
+HttpResponse wrong_type_response(const std::string &key);
+
+} // namespace mini_redis
@@ -0,0 +1,142 @@
+// =============================================================================
+// hll_handler.cpp — HyperLogLog REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/hll_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+namespace mini_redis {
+
+HllHandler::HllHandler(KeyValueStore &store) : store_(store) {}
+
+void HllHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/hll/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return add(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/hll/count/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return count(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/hll/count",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return count_union(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/hll/merge/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return merge(req, params);
+                   });
+
+  Logger::info("HyperLogLog handler routes registered");
+}
+
+// =============================================================================
+// PUT /hll/add/{key} — body: one element per line
+// =============================================================================
+HttpResponse HllHandler::add(const HttpRequest &request,
+                             const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto elements = split_lines(request.body());
+  if (key.empty() || elements.empty()) {
+    return HttpResponse::bad_request().body(
+        "Usage: body = one element per line");
+  }
+
+  bool changed = false;
+  const auto status =
+      store_.modify_as<HyperLogLog>(key, true, [&](HyperLogLog &hll) {
+        for (const auto &element : elements) {
+          // Non-short-circuit: every element must be added
+          changed = hll.add(element) || changed;
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(changed ? "1" : "0");
+}
+
+// =============================================================================
+// GET /hll/count/{key}
+// =============================================================================
+HttpResponse HllHandler::count(const HttpRequest & /*request*/,
+                               const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::uint64_t estimate = 0;
+  const auto status = store_.read_as<HyperLogLog>(
+      key, [&](const HyperLogLog &hll) { estimate = hll.count(); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(estimate));
+}
+
+// =============================================================================
+// POST /hll/count — body: one key per line; counts the UNION
+// =============================================================================
+HttpResponse HllHandler::count_union(const HttpRequest &request,
+                                     const RouteParams & /*params*/) const {
+  const auto keys = split_lines(request.body());
+  if (keys.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one key per line");
+  }
+
+  std::uint64_t estimate = 0;
+  const auto status = store_.read_many_as<HyperLogLog>(
+      keys, [&](const std::vector<const HyperLogLog *> &hlls) {
+        estimate = HyperLogLog::count_union(hlls);
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return HttpResponse::conflict().body(
+        "WRONGTYPE Operation against a key holding the wrong kind of value");
+  }
+  return HttpResponse::ok().body(std::to_string(estimate));
+}
+
+// =============================================================================
+// POST /hll/merge/{dest} — body: one source key per line
+// =============================================================================
+// The sources are folded into a temporary HLL under the READ lock first,
+// then merged into 'dest' under its write lock. Taking the write lock while
+// still holding the read lock would deadlock on the store's single mutex.
+// =============================================================================
+HttpResponse HllHandler::merge(const HttpRequest &request,
+                               const RouteParams &params) {
+  const std::string &dest = params.path_suffix;
+  const auto sources = split_lines(request.body());
+  if (dest.empty()) {
+    return HttpResponse::bad_request().body("Destination key cannot be empty");
+  }
+
+  HyperLogLog combined;
+  const auto read_status = store_.read_many_as<HyperLogLog>(
+      sources, [&](const std::vector<const HyperLogLog *> &hlls) {
+        for (const HyperLogLog *hll : hlls) {
+          if (hll != nullptr) {
+            combined.merge(*hll);
+          }
+        }
+      });
+  if (read_status == AccessStatus::WRONG_TYPE) {
+    return HttpResponse::conflict().body(
+        "WRONGTYPE Operation against a key holding the wrong kind of value");
+  }
+
+  const auto status =
+      store_.modify_as<HyperLogLog>(dest, true, [&](HyperLogLog &hll) {
+        hll.merge(combined);
+        return true;
+      });
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(dest);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+} // namespace mini_redis
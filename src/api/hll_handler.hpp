@@ -0,0 +1,42 @@
+// =============================================================================
+// hll_handler.hpp — HyperLogLog REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the HyperLogLog value type over HTTP:
+//
+//   PUT  /hll/add/{key}     body: one element per line → "1" if changed (PFADD)
+//   GET  /hll/count/{key}   → estimated unique count                 (PFCOUNT)
+//   POST /hll/count         body: one key per line → count of union  (PFCOUNT)
+//   POST /hll/merge/{dest}  body: one source key per line            (PFMERGE)
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class HllHandler {
+public:
+  explicit HllHandler(KeyValueStore &store);
+
+  // Register all /hll/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse count(const HttpRequest &request,
+                     const RouteParams &params) const;
+  HttpResponse count_union(const HttpRequest &request,
+                           const RouteParams &params) const;
+  HttpResponse merge(const HttpRequest &request, const RouteParams &params);
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,283 @@
+// =============================================================================
+// json_handler.cpp — JSON Document REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/json_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+namespace mini_redis {
+
+namespace {
+
+// ?path= (default: the root); std::nullopt if the syntax is invalid
+std::optional<JsonPath> path_param(const HttpRequest &request) {
+  return JsonPath::parse(request.get_query_param("path").value_or("$"));
+}
+
+HttpResponse bad_path_response() {
+  return HttpResponse::bad_request().body(
+      "ERR invalid path (use $, $.member, $['member'] or $.array[index])");
+}
+
+HttpResponse bad_json_response() {
+  return HttpResponse::bad_request().body("ERR body is not valid JSON");
+}
+
+HttpResponse no_path_response(const std::string &key) {
+  return HttpResponse::not_found().body("Path not found in " + key);
+}
+
+HttpResponse status_response(JsonDocument::Status status,
+                             const std::string &key) {
+  switch (status) {
+  case JsonDocument::Status::OK:
+    break;
+  case JsonDocument::Status::NO_PATH:
+    return no_path_response(key);
+  case JsonDocument::Status::WRONG_TYPE:
+    return HttpResponse::bad_request().body(
+        "ERR the path's parent is not an object or array of that kind");
+  case JsonDocument::Status::TOO_DEEP:
+    return HttpResponse::bad_request().body(
+        "ERR document would nest deeper than " +
+        std::to_string(JsonDocument::MAX_DEPTH) + " levels");
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+} // anonymous namespace
+
+JsonHandler::JsonHandler(KeyValueStore &store) : store_(store) {}
+
+void JsonHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/json/set/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return set(req, params);
+                   });
+  router.add_route(HttpMethod::PATCH, "/json/set/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return set(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/json/get/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return get(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/json/del/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return del(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/json/incrby/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return incrby(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/json/append/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return append(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/json/type/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return type(req, params);
+                   });
+
+  Logger::info("JSON handler routes registered");
+}
+
+// =============================================================================
+// PUT|PATCH /json/set/{key}[?path=] — body: a JSON value
+// =============================================================================
+// Only a root write may create the key: "set $.a on a missing document"
+// has no document to put 'a' into.
+// =============================================================================
+HttpResponse JsonHandler::set(const HttpRequest &request,
+                              const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto path = path_param(request);
+  if (key.empty()) {
+    return HttpResponse::bad_request().body(
+        "Usage: PUT /json/set/{key}[?path=$...], body = JSON");
+  }
+  if (!path.has_value()) {
+    return bad_path_response();
+  }
+  const auto value = JsonDocument::parse(request.body());
+  if (!value.has_value()) {
+    return bad_json_response();
+  }
+
+  auto result = JsonDocument::Status::OK;
+  const auto status = store_.modify_as<JsonDocument>(
+      key, path->is_root(), [&](JsonDocument &document) {
+        result = document.set(*path, *value);
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return status_response(result, key);
+}
+
+// =============================================================================
+// GET /json/get/{key}[?path=]
+// =============================================================================
+HttpResponse JsonHandler::get(const HttpRequest &request,
+                              const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto path = path_param(request);
+  if (!path.has_value()) {
+    return bad_path_response();
+  }
+
+  std::optional<std::string> fragment;
+  const auto status = store_.read_as<JsonDocument>(
+      key, [&](const JsonDocument &document) {
+        fragment = document.get(*path);
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  if (!fragment.has_value()) {
+    return no_path_response(key);
+  }
+  return HttpResponse::ok().body(*fragment);
+}
+
+// =============================================================================
+// POST /json/del/{key}[?path=] — the root path deletes the whole key
+// =============================================================================
+HttpResponse JsonHandler::del(const HttpRequest &request,
+                              const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto path = path_param(request);
+  if (!path.has_value()) {
+    return bad_path_response();
+  }
+
+  bool removed = false;
+  const auto status = store_.modify_as<JsonDocument>(
+      key, false, [&](JsonDocument &document) {
+        if (path->is_root()) {
+          removed = true;
+          return false; // drop the key
+        }
+        removed = document.remove(*path) == JsonDocument::Status::OK;
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(removed ? "1" : "0");
+}
+
+// =============================================================================
+// POST /json/incrby/{key}?path=&by=n
+// =============================================================================
+HttpResponse JsonHandler::incrby(const HttpRequest &request,
+                                 const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto path = path_param(request);
+  const auto delta =
+      parse_double(request.get_query_param("by").value_or(""));
+  if (!path.has_value() || !delta.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: POST /json/incrby/{key}?path=$...&by=<number>");
+  }
+
+  std::optional<std::string> result;
+  const auto status = store_.modify_as<JsonDocument>(
+      key, false, [&](JsonDocument &document) {
+        result = document.increment(*path, *delta);
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  if (!result.has_value()) {
+    return HttpResponse::bad_request().body(
+        "ERR no number at that path, or the result overflows");
+  }
+  return HttpResponse::ok().body(*result);
+}
+
+// =============================================================================
+// POST /json/append/{key}?path= — body: one JSON value
+// =============================================================================
+HttpResponse JsonHandler::append(const HttpRequest &request,
+                                 const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto path = path_param(request);
+  if (!path.has_value()) {
+    return bad_path_response();
+  }
+  auto value = JsonDocument::parse(request.body());
+  if (!value.has_value()) {
+    return bad_json_response();
+  }
+  const std::vector<JsonDocument> values{std::move(*value)};
+
+  std::size_t length = 0;
+  auto result = JsonDocument::Status::OK;
+  const auto status = store_.modify_as<JsonDocument>(
+      key, false, [&](JsonDocument &document) {
+        result = document.array_append(*path, values, length);
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  if (result == JsonDocument::Status::WRONG_TYPE) {
+    return HttpResponse::bad_request().body("ERR the path is not an array");
+  }
+  if (result != JsonDocument::Status::OK) {
+    return status_response(result, key);
+  }
+  return HttpResponse::ok().body(std::to_string(length));
+}
+
+// =============================================================================
+// GET /json/type/{key}[?path=]
+// =============================================================================
+HttpResponse JsonHandler::type(const HttpRequest &request,
+                               const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto path = path_param(request);
+  if (!path.has_value()) {
+    return bad_path_response();
+  }
+
+  std::optional<JsonDocument::Type> found;
+  const auto status = store_.read_as<JsonDocument>(
+      key, [&](const JsonDocument &document) {
+        found = document.type_at(*path);
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  if (!found.has_value()) {
+    return no_path_response(key);
+  }
+  return HttpResponse::ok().body(JsonDocument::type_name(*found));
+}
+
+} // namespace mini_redis
@@ -0,0 +1,55 @@
+// =============================================================================
+// json_handler.hpp — JSON Document REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the JSON value type (RedisJSON-style). Every endpoint takes an
+// optional ?path= (default "$", the whole document) — see json.hpp for the
+// syntax. In a URL, '$' and '.' are fine as-is; encode '[' ']' as %5B %5D
+// (or let curl do it with -G --data-urlencode).
+//
+//   PUT   /json/set/{key}[?path=$]  body: JSON      → OK       (JSON.SET)
+//   PATCH /json/set/{key}?path=...  body: JSON      → OK
+//         (the same operation; the key must already exist unless the path
+//          is "$", and a missing object member is added)
+//   GET   /json/get/{key}[?path=$]        → that fragment as JSON (JSON.GET)
+//   POST  /json/del/{key}[?path=$]        → 1 / 0            (JSON.DEL)
+//   POST  /json/incrby/{key}?path=&by=n   → the new number (JSON.NUMINCRBY)
+//   POST  /json/append/{key}?path=  body: one JSON value
+//                                         → new array length (JSON.ARRAPPEND)
+//   GET   /json/type/{key}[?path=$]       → object, array, string, ...
+//
+// Bodies are parsed BEFORE the key is locked, so a big document never
+// holds up other clients of the same shard while it's being parsed.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class JsonHandler {
+public:
+  explicit JsonHandler(KeyValueStore &store);
+
+  // Register all /json/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse set(const HttpRequest &request, const RouteParams &params);
+  HttpResponse get(const HttpRequest &request, const RouteParams &params) const;
+  HttpResponse del(const HttpRequest &request, const RouteParams &params);
+  HttpResponse incrby(const HttpRequest &request, const RouteParams &params);
+  HttpResponse append(const HttpRequest &request, const RouteParams &params);
+  HttpResponse type(const HttpRequest &request,
+                    const RouteParams &params) const;
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
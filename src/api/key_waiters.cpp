@@ -0,0 +1,273 @@
+// =============================================================================
+// key_waiters.cpp — Clients Blocked Until a Key Gets Data (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/key_waiters.hpp"
+
+#include <algorithm> // std::min
+#include <utility>
+#include <vector>
+
+namespace mini_redis {
+
+KeyWaiters::KeyWaiters() : timer_thread_(&KeyWaiters::timer_loop, this) {}
+
+KeyWaiters::~KeyWaiters() { stop(); }
+
+void KeyWaiters::stop() {
+  {
+    // Set the flag under the mutex so the timer can't miss the wakeup
+    // between checking the flag and going to sleep
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_requested_.store(true);
+  }
+  timer_cv_.notify_all();
+
+  if (timer_thread_.joinable()) {
+    timer_thread_.join();
+  }
+}
+
+// =============================================================================
+// block() — Serve immediately if possible, otherwise park
+// =============================================================================
+HttpResponse KeyWaiters::block(const std::string &key,
+                               std::chrono::milliseconds timeout,
+                               ServeFunc serve,
+                               const HttpResponse &timeout_response) {
+  return block(std::vector<std::string>{key}, timeout, std::move(serve),
+               timeout_response);
+}
+
+HttpResponse KeyWaiters::block(const std::vector<std::string> &keys,
+                               std::chrono::milliseconds timeout,
+                               ServeFunc serve,
+                               const HttpResponse &timeout_response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  // Fast path: data is already there
+  if (auto reply = serve()) {
+    return std::move(reply.value());
+  }
+
+  auto waiter = std::make_shared<Waiter>();
+  waiter->serve = std::move(serve);
+  waiter->timeout_reply = timeout_response.build();
+  waiter->connection = std::make_shared<ParkedConnection>();
+
+  waiter->queue_positions.reserve(keys.size());
+  for (const auto &key : keys) {
+    auto &queue = by_key_[key];
+    waiter->queue_positions.emplace_back(key,
+                                         queue.insert(queue.end(), waiter));
+  }
+
+  if (timeout.count() > 0) {
+    waiter->deadline_position = deadlines_.emplace(
+        Clock::now() + std::min(timeout, MAX_TIMEOUT), waiter);
+  }
+  // The new deadline may be sooner than the one the timer sleeps toward;
+  // and with no waiters before, the timer wasn't sweeping at all
+  timer_cv_.notify_one();
+
+  return HttpResponse::parked(waiter->connection);
+}
+
+// =============================================================================
+// notify() — Serve waiters on 'key' in FIFO order
+// =============================================================================
+// Replies are COLLECTED under the mutex but WRITTEN after releasing it, so a
+// slow client socket never stalls other threads waiting for mutex_.
+// A waiter whose client hung up is unlinked WITHOUT calling serve(): what
+// it would have popped stays in the list for the next one. Those checks
+// are syscalls, so like drop_disconnected() they run on a snapshot of the
+// queue with mutex_ released.
+// =============================================================================
+void KeyWaiters::notify(const std::string &key, Wake wake) {
+  std::vector<WaiterPtr> queued;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = by_key_.find(key);
+    if (it == by_key_.end()) {
+      return;
+    }
+    queued.assign(it->second.begin(), it->second.end());
+  }
+
+  std::vector<WaiterPtr> closed;
+  for (const auto &waiter : queued) {
+    if (waiter->connection->peer_closed()) {
+      closed.push_back(waiter);
+    }
+  }
+
+  std::vector<std::pair<std::shared_ptr<ParkedConnection>, std::string>>
+      replies;
+  std::vector<std::shared_ptr<ParkedConnection>> hung_up;
+
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto &waiter : closed) {
+      if (!waiter->queue_positions.empty()) { // not served or timed out since
+        hung_up.push_back(waiter->connection);
+        unlink(waiter);
+      }
+    }
+
+    const auto it = by_key_.find(key);
+    if (wake == Wake::ALL && it != by_key_.end()) {
+      // Serving unlinks waiters from this very queue: walk a copy
+      const std::vector<WaiterPtr> queue(it->second.begin(),
+                                         it->second.end());
+      for (const auto &waiter : queue) {
+        if (waiter->queue_positions.empty()) {
+          continue; // listed twice (a repeated key) and already served
+        }
+        if (auto reply = waiter->serve()) {
+          replies.emplace_back(waiter->connection, reply->build());
+          unlink(waiter);
+        }
+      }
+    }
+
+    while (wake == Wake::UNTIL_EMPTY && it != by_key_.end() &&
+           !it->second.empty()) {
+      const WaiterPtr waiter = it->second.front();
+      auto reply = waiter->serve();
+      if (!reply.has_value()) {
+        break; // the data ran out — the rest keep waiting
+      }
+      replies.emplace_back(waiter->connection, reply->build());
+      unlink(waiter); // may erase 'it' when the queue empties
+      if (by_key_.find(key) == by_key_.end()) {
+        break;
+      }
+    }
+  }
+
+  for (const auto &[connection, raw] : replies) {
+    connection->complete(raw);
+  }
+  // Nothing to say to them: completing just closes our end
+  for (const auto &connection : hung_up) {
+    connection->complete("");
+  }
+}
+
+std::size_t KeyWaiters::waiting_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  std::size_t count = 0;
+  for (const auto &[key, queue] : by_key_) {
+    count += queue.size();
+  }
+  return count;
+}
+
+void KeyWaiters::unlink(const WaiterPtr &waiter) {
+  for (const auto &[key, position] : waiter->queue_positions) {
+    const auto it = by_key_.find(key);
+    if (it != by_key_.end()) {
+      it->second.erase(position);
+      if (it->second.empty()) {
+        by_key_.erase(it);
+      }
+    }
+  }
+  waiter->queue_positions.clear();
+  if (waiter->deadline_position.has_value()) {
+    deadlines_.erase(waiter->deadline_position.value());
+    waiter->deadline_position.reset();
+  }
+}
+
+// =============================================================================
+// drop_disconnected() — Unlink waiters whose client hung up
+// =============================================================================
+// Each check is a syscall, so they run with mutex_ RELEASED: a snapshot
+// of the waiters is taken, checked, and the dead ones unlinked after
+// re-locking — unless notify() or the deadline already unlinked them.
+// =============================================================================
+void KeyWaiters::drop_disconnected(std::unique_lock<std::mutex> &lock) {
+  std::vector<WaiterPtr> waiters;
+  for (const auto &[key, queue] : by_key_) {
+    waiters.insert(waiters.end(), queue.begin(), queue.end());
+  }
+
+  lock.unlock();
+  std::vector<WaiterPtr> dead;
+  for (const auto &waiter : waiters) {
+    if (waiter->connection->peer_closed()) {
+      dead.push_back(waiter);
+    }
+  }
+  lock.lock();
+
+  for (const auto &waiter : dead) {
+    if (!waiter->queue_positions.empty()) {
+      unlink(waiter);
+    }
+  }
+  lock.unlock();
+  for (const auto &waiter : dead) {
+    waiter->connection->complete("");
+  }
+  lock.lock();
+}
+
+// =============================================================================
+// timer_loop() — Sleep until the soonest deadline, answer expired waiters
+// =============================================================================
+// While anyone is parked, it also wakes every DISCONNECT_SWEEP to drop the
+// clients that hung up.
+// =============================================================================
+void KeyWaiters::timer_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto next_sweep = Clock::now() + DISCONNECT_SWEEP;
+
+  while (!stop_requested_.load()) {
+    if (by_key_.empty()) {
+      // Every waiter with a deadline is also in by_key_
+      timer_cv_.wait(lock, [this] {
+        return stop_requested_.load() || !by_key_.empty();
+      });
+      next_sweep = Clock::now() + DISCONNECT_SWEEP;
+      continue;
+    }
+
+    if (Clock::now() >= next_sweep) {
+      drop_disconnected(lock);
+      next_sweep = Clock::now() + DISCONNECT_SWEEP;
+      continue;
+    }
+
+    auto wake_at = next_sweep;
+    if (!deadlines_.empty()) {
+      wake_at = std::min(wake_at, deadlines_.begin()->first);
+    }
+    if (Clock::now() < wake_at) {
+      // Wakes at the deadline or sweep, on stop(), or when block() adds a
+      // sooner deadline
+      timer_cv_.wait_until(lock, wake_at);
+      continue;
+    }
+
+    // Collect every expired waiter, then reply outside the lock
+    std::vector<WaiterPtr> expired;
+    const auto now = Clock::now();
+    while (!deadlines_.empty() && deadlines_.begin()->first <= now) {
+      const WaiterPtr waiter = deadlines_.begin()->second;
+      unlink(waiter);
+      expired.push_back(waiter);
+    }
+
+    lock.unlock();
+    for (const auto &waiter : expired) {
+      waiter->connection->complete(waiter->timeout_reply);
+    }
+    lock.lock();
+  }
+}
+
+} // namespace mini_redis
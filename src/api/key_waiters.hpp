@@ -0,0 +1,158 @@
+// =============================================================================
+// key_waiters.hpp — Clients Blocked Until a Key Gets Data (HEADER)
+// =============================================================================
+//
+// Coordinates blocking commands (BLPOP, BRPOP, ...) WITHOUT blocking threads:
+//
+//   1. block(): try to serve the client right away. If there's nothing to
+//      serve, remember the client as a WAITER on that key, park its
+//      connection (see network/parked_connection.hpp) and return at once.
+//   2. notify(): after a write to the key (LPUSH...), waiters get another
+//      try, oldest first (FIFO fairness), until the data runs out.
+//   3. A single timer thread answers waiters whose timeout has passed.
+//
+// CLIENTS THAT HANG UP:
+// A parked client may close its connection while it waits. Serving it
+// anyway would POP an element and write it to a dead socket — the element
+// would be lost. So notify() checks each waiter's connection before
+// serving it and drops the ones whose peer has gone; the timer thread also
+// sweeps every DISCONNECT_SWEEP, so a client that blocked forever
+// (timeout 0) on a key nobody writes doesn't stay queued forever either.
+//
+// A waiter may watch SEVERAL keys (XREAD on many streams): it sits in the
+// queue of each one, and whichever key serves it first unlinks it from all.
+//
+// THE LOST-WAKEUP RACE:
+// If we checked the list, THEN registered as a waiter, a push landing in
+// between would call notify() before we're registered — and we'd sleep
+// until the timeout with data sitting in the list. block() avoids this by
+// trying and registering under ONE mutex that notify() also takes.
+//
+// LOCK ORDER: our mutex_ is always taken BEFORE any store lock (serve
+// callbacks touch the store while we hold mutex_), and the store never
+// calls back into us while holding its own locks — so no deadlock.
+// =============================================================================
+
+#pragma once
+
+#include "http/http_response.hpp"
+#include "network/parked_connection.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace mini_redis {
+
+class KeyWaiters {
+public:
+  // Tries to answer a waiting client. Returns the reply if it could (e.g. it
+  // popped an element), or std::nullopt if there's still nothing to serve.
+  using ServeFunc = std::function<std::optional<HttpResponse>()>;
+
+  // Starts the timeout thread
+  KeyWaiters();
+
+  // Stops the timeout thread. Clients still parked are disconnected when
+  // their ParkedConnection is destroyed.
+  ~KeyWaiters();
+
+  // Non-copyable, non-movable (owns a running thread)
+  KeyWaiters(const KeyWaiters &) = delete;
+  KeyWaiters &operator=(const KeyWaiters &) = delete;
+  KeyWaiters(KeyWaiters &&) = delete;
+  KeyWaiters &operator=(KeyWaiters &&) = delete;
+
+  // How far notify() goes down a key's queue
+  enum class Wake {
+    // Stop at the first waiter that can't be served: data is CONSUMED
+    // (BLPOP), so once one waiter finds nothing, later ones would too
+    UNTIL_EMPTY,
+    // Try every waiter: data is only READ (XREAD), so one waiter finding
+    // nothing says nothing about the next one
+    ALL,
+  };
+
+  // How often the timer thread looks for clients that hung up
+  static constexpr std::chrono::milliseconds DISCONNECT_SWEEP =
+      std::chrono::seconds(1);
+
+  // Longest finite wait; longer timeouts are cut to it (a deadline past
+  // steady_clock's range would overflow)
+  static constexpr std::chrono::milliseconds MAX_TIMEOUT =
+      std::chrono::hours(24 * 365);
+
+  // ---- block() — Serve now, or park the client on 'key' ----
+  // timeout == 0 means "wait forever" (same as Redis).
+  // Returns either the immediate reply, or an HttpResponse::parked(...)
+  // placeholder whose connection will be completed later.
+  HttpResponse block(const std::string &key, std::chrono::milliseconds timeout,
+                     ServeFunc serve, const HttpResponse &timeout_response);
+
+  // ---- block() on several keys: notify() on ANY of them retries 'serve' ----
+  HttpResponse block(const std::vector<std::string> &keys,
+                     std::chrono::milliseconds timeout, ServeFunc serve,
+                     const HttpResponse &timeout_response);
+
+  // ---- notify() — 'key' received data; let its waiters retry ----
+  void notify(const std::string &key, Wake wake = Wake::UNTIL_EMPTY);
+
+  // ---- Stop the timeout thread (idempotent) ----
+  void stop();
+
+  // Number of clients currently parked (for diagnostics and tests)
+  std::size_t waiting_count() const;
+
+private:
+  using Clock = std::chrono::steady_clock;
+  struct Waiter;
+  using WaiterPtr = std::shared_ptr<Waiter>;
+
+  struct Waiter {
+    ServeFunc serve;
+    std::string timeout_reply; // pre-serialized, sent if the deadline passes
+    std::shared_ptr<ParkedConnection> connection;
+
+    // Back-references so a waiter can be unlinked in O(1) / O(log n):
+    // one queue position per watched key
+    std::vector<std::pair<std::string, std::list<WaiterPtr>::iterator>>
+        queue_positions;
+    std::optional<std::multimap<Clock::time_point, WaiterPtr>::iterator>
+        deadline_position;
+  };
+
+  // Remove a waiter from both indexes (caller holds mutex_)
+  void unlink(const WaiterPtr &waiter);
+
+  // Unlink every waiter whose client hung up. Called by the timer thread
+  // with 'lock' held; the checks themselves run without it.
+  void drop_disconnected(std::unique_lock<std::mutex> &lock);
+
+  // The timeout thread's main loop
+  void timer_loop();
+
+  mutable std::mutex mutex_;
+
+  // key → waiters in arrival order
+  std::unordered_map<std::string, std::list<WaiterPtr>> by_key_;
+
+  // deadline → waiter, ordered so the soonest deadline is begin()
+  std::multimap<Clock::time_point, WaiterPtr> deadlines_;
+
+  std::condition_variable timer_cv_;
+  std::atomic<bool> stop_requested_{false};
+  std::thread timer_thread_;
+};
+
+} // namespace mini_redis
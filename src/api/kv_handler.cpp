@@ -3,12 +3,70 @@
 // =============================================================================
 
 #include "api/kv_handler.hpp"
+#include "api/handler_util.hpp"
 #include "util/logger.hpp"
 
+#include <cctype>
 #include <sstream> // for building the key list response
+#include <string_view>
+#include <vector>
 
 namespace mini_redis {
 
+namespace {
+
+// ---- Does an Accept-Encoding header list 'coding'? ----
+// "gzip, lz4;q=0.5" → yes for lz4. Names are case-insensitive, and a
+// coding with q=0 is explicitly refused.
+bool accepts_encoding(std::string_view header, std::string_view coding) {
+  const auto trim = [](std::string_view text) {
+    while (!text.empty() && std::isspace(static_cast<unsigned char>(text[0]))) {
+      text.remove_prefix(1);
+    }
+    while (!text.empty() &&
+           std::isspace(static_cast<unsigned char>(text.back()))) {
+      text.remove_suffix(1);
+    }
+    return text;
+  };
+  const auto same = [](std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (std::size_t i = 0; i < a.size(); ++i) {
+      if (std::tolower(static_cast<unsigned char>(a[i])) !=
+          std::tolower(static_cast<unsigned char>(b[i]))) {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  while (!header.empty()) {
+    const std::size_t comma = header.find(',');
+    std::string_view item = header.substr(0, comma);
+    header = comma == std::string_view::npos ? std::string_view()
+                                             : header.substr(comma + 1);
+    const std::size_t semicolon = item.find(';');
+    if (!same(trim(item.substr(0, semicolon)), coding)) {
+      continue;
+    }
+    if (semicolon == std::string_view::npos) {
+      return true;
+    }
+    std::string_view weight = trim(item.substr(semicolon + 1));
+    if (weight.size() < 2 || !same(weight.substr(0, 2), "q=")) {
+      return true;
+    }
+    weight.remove_prefix(2);
+    // q=0, q=0.0, q=0.000 all mean "not acceptable"
+    return weight.find_first_not_of("0.") != std::string_view::npos;
+  }
+  return false;
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Constructor
 // =============================================================================
@@ -61,13 +119,18 @@ void KvHandler::register_routes(Router &router) {
                      return list_keys(req, params);
                    });
 
+  router.add_route(HttpMethod::POST, "/mget",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return mget(req, params);
+                   });
+
   Logger::info("KV handler routes registered");
 }
 
 // =============================================================================
 // GET /kv/{key} — Retrieve a value by key
 // =============================================================================
-HttpResponse KvHandler::get_key(const HttpRequest & /*request*/,
+HttpResponse KvHandler::get_key(const HttpRequest &request,
                                 const RouteParams &params) const {
   // The key is the path suffix extracted by the router.
   // Example: URL "/kv/hello" with prefix "/kv/" → suffix = "hello"
@@ -78,6 +141,21 @@ HttpResponse KvHandler::get_key(const HttpRequest & /*request*/,
     return HttpResponse::bad_request().body("Key cannot be empty");
   }
 
+  // A client that decodes LZ4 itself gets a compressed value as stored:
+  // no decompression here, and fewer bytes on the wire
+  const auto accept = request.get_header("Accept-Encoding");
+  if (accept.has_value() && accepts_encoding(*accept, "lz4")) {
+    auto encoded = store_.get_encoded(key);
+    if (!encoded.has_value()) {
+      return HttpResponse::not_found().body("Key not found: " + key);
+    }
+    HttpResponse response = HttpResponse::ok();
+    if (encoded->codec != ValueCodec::NONE) {
+      response.header("Content-Encoding", content_encoding(encoded->codec));
+    }
+    return response.body(encoded->bytes);
+  }
+
   // Look up the value in the store
   const auto value = store_.get(key);
 
@@ -169,4 +247,25 @@ HttpResponse KvHandler::list_keys(const HttpRequest & /*request*/,
   return HttpResponse::ok().body(response_body.str());
 }
 
+// =============================================================================
+// POST /mget — Retrieve several values in one request
+// =============================================================================
+// Not one get() per key: get_many() probes them as a batch, so the cache
+// misses of a large MGET overlap instead of being paid one after another.
+// =============================================================================
+HttpResponse KvHandler::mget(const HttpRequest &request,
+                             const RouteParams & /*params*/) const {
+  const auto keys = split_lines(request.body());
+  if (keys.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one key per line");
+  }
+
+  std::vector<std::string> lines;
+  lines.reserve(keys.size());
+  for (auto &value : store_.get_many(keys)) {
+    lines.push_back(value.has_value() ? std::move(*value) : std::string());
+  }
+  return HttpResponse::ok().body(join_lines(lines));
+}
+
 } // namespace mini_redis
@@ -9,6 +9,10 @@
 //   PUT    /kv/{key}  → put_key()   — store a value
 //   DELETE /kv/{key}  → delete_key() — remove a value
 //   GET    /kv        → list_keys() — list all keys
+//   POST   /mget      → mget()      — several values at once
+//
+// GET /kv/{key} honours "Accept-Encoding: lz4": a value the store keeps
+// compressed is then sent as stored, with "Content-Encoding: lz4".
 //
 // DESIGN: These functions are "stateless" — they receive the request and
 // a reference to the store, do their work, and return a response. They
@@ -76,6 +80,11 @@ public:
   HttpResponse list_keys(const HttpRequest &request,
                          const RouteParams &params) const;
 
+  // POST /mget — body = one key per line; one value per line back, in the
+  // same order, with an empty line for a missing key (or a non-string)
+  HttpResponse mget(const HttpRequest &request,
+                    const RouteParams &params) const;
+
 private:
   // Reference to the key-value store (NOT owned by this class)
   KeyValueStore &store_;
@@ -0,0 +1,221 @@
+// =============================================================================
+// list_handler.cpp — List REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/list_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm> // std::min
+#include <chrono>
+#include <cmath> // std::ceil, std::isfinite
+
+namespace mini_redis {
+
+ListHandler::ListHandler(KeyValueStore &store, KeyWaiters &waiters)
+    : store_(store), waiters_(waiters) {}
+
+void ListHandler::register_routes(Router &router) {
+  // The bool argument picks the end of the list: true = front (left)
+  router.add_route(HttpMethod::POST, "/list/lpush/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return push(req, params, true);
+                   });
+  router.add_route(HttpMethod::POST, "/list/rpush/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return push(req, params, false);
+                   });
+  router.add_route(HttpMethod::POST, "/list/lpop/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return pop(req, params, true);
+                   });
+  router.add_route(HttpMethod::POST, "/list/rpop/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return pop(req, params, false);
+                   });
+  router.add_route(HttpMethod::GET, "/list/range/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return range(req, params);
+                   });
+  router.add_route(HttpMethod::PUT, "/list/trim/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return trim(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/list/blpop/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return blocking_pop(req, params, true);
+                   });
+  router.add_route(HttpMethod::POST, "/list/brpop/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return blocking_pop(req, params, false);
+                   });
+
+  Logger::info("List handler routes registered");
+}
+
+// =============================================================================
+// POST /list/lpush|rpush/{key}
+// =============================================================================
+HttpResponse ListHandler::push(const HttpRequest &request,
+                               const RouteParams &params, bool to_front) {
+  const std::string &key = params.path_suffix;
+  const auto values = split_lines(request.body());
+  if (key.empty() || values.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one element per line");
+  }
+
+  std::size_t length = 0;
+  const auto status =
+      store_.modify_as<QuickList>(key, true, [&](QuickList &list) {
+        for (const auto &value : values) {
+          if (to_front) {
+            list.push_front(value);
+          } else {
+            list.push_back(value);
+          }
+        }
+        length = list.size();
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+
+  // Clients parked in BLPOP/BRPOP on this key get their turn now
+  waiters_.notify(key);
+  return HttpResponse::ok().body(std::to_string(length));
+}
+
+// =============================================================================
+// POST /list/lpop|rpop/{key}[?count=n]
+// =============================================================================
+HttpResponse ListHandler::pop(const HttpRequest &request,
+                              const RouteParams &params, bool from_front) {
+  const std::string &key = params.path_suffix;
+  const auto count = parse_integer(request.get_query_param("count").value_or("1"));
+  if (key.empty() || !count.has_value() || count.value() < 1) {
+    return HttpResponse::bad_request().body("Usage: /list/lpop/{key}?count=n");
+  }
+
+  std::vector<std::string> popped;
+  const auto status =
+      store_.modify_as<QuickList>(key, false, [&](QuickList &list) {
+        for (long long i = 0; i < count.value(); ++i) {
+          auto value = from_front ? list.pop_front() : list.pop_back();
+          if (!value.has_value()) {
+            break;
+          }
+          popped.push_back(std::move(value.value()));
+        }
+        return !list.empty(); // popping the last element deletes the key
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (popped.empty()) {
+    return HttpResponse::not_found().body("List is empty: " + key);
+  }
+  return HttpResponse::ok().body(join_lines(popped));
+}
+
+// =============================================================================
+// GET /list/range/{key}?start=0&stop=-1
+// =============================================================================
+HttpResponse ListHandler::range(const HttpRequest &request,
+                                const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto start = parse_integer(request.get_query_param("start").value_or("0"));
+  const auto stop = parse_integer(request.get_query_param("stop").value_or("-1"));
+  if (key.empty() || !start.has_value() || !stop.has_value()) {
+    return HttpResponse::bad_request().body("Usage: /list/range/{key}"
+                                            "?start=0&stop=-1");
+  }
+
+  std::vector<std::string> items;
+  const auto status = store_.read_as<QuickList>(key, [&](const QuickList &list) {
+    items = list.range(start.value(), stop.value());
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(join_lines(items));
+}
+
+// =============================================================================
+// PUT /list/trim/{key}?start=0&stop=99
+// =============================================================================
+HttpResponse ListHandler::trim(const HttpRequest &request,
+                               const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto start = parse_integer(request.get_query_param("start").value_or(""));
+  const auto stop = parse_integer(request.get_query_param("stop").value_or(""));
+  if (key.empty() || !start.has_value() || !stop.has_value()) {
+    return HttpResponse::bad_request().body("Usage: /list/trim/{key}"
+                                            "?start=0&stop=99");
+  }
+
+  const auto status =
+      store_.modify_as<QuickList>(key, false, [&](QuickList &list) {
+        list.trim(start.value(), stop.value());
+        return !list.empty();
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /list/blpop|brpop/{key}?timeout=seconds
+// =============================================================================
+// The serve lambda is called now, and again (from ANOTHER thread) on every
+// push to this key — so it captures copies of what it needs, never
+// references to this function's locals.
+// =============================================================================
+HttpResponse ListHandler::blocking_pop(const HttpRequest &request,
+                                       const RouteParams &params,
+                                       bool from_front) {
+  const std::string key = params.path_suffix;
+  const auto timeout_seconds =
+      parse_double(request.get_query_param("timeout").value_or("0"));
+  if (key.empty() || !timeout_seconds.has_value() ||
+      !std::isfinite(timeout_seconds.value()) ||
+      timeout_seconds.value() < 0) {
+    return HttpResponse::bad_request().body("Usage: /list/blpop/{key}"
+                                            "?timeout=seconds");
+  }
+
+  KeyValueStore &store = store_;
+  auto serve = [&store, key, from_front]() -> std::optional<HttpResponse> {
+    std::optional<std::string> value;
+    const auto status =
+        store.modify_as<QuickList>(key, false, [&](QuickList &list) {
+          value = from_front ? list.pop_front() : list.pop_back();
+          return !list.empty();
+        });
+
+    if (status == AccessStatus::WRONG_TYPE) {
+      return wrong_type_response(key);
+    }
+    if (!value.has_value()) {
+      return std::nullopt; // keep waiting
+    }
+    return HttpResponse::ok().body(value.value());
+  };
+
+  // Round UP so a tiny positive timeout never becomes 0 ("wait forever").
+  // Clamped BEFORE the cast: a double past long long's range (1e300) is
+  // undefined behaviour to convert.
+  const double max_ms =
+      static_cast<double>(KeyWaiters::MAX_TIMEOUT.count());
+  const auto timeout = std::chrono::milliseconds(static_cast<long long>(
+      std::min(std::ceil(timeout_seconds.value() * 1000.0), max_ms)));
+  return waiters_.block(key, timeout, std::move(serve),
+                        HttpResponse::not_found().body("Timed out: " + key));
+}
+
+} // namespace mini_redis
@@ -0,0 +1,53 @@
+// =============================================================================
+// list_handler.hpp — List REST Endpoints (HEADER)
+// =============================================================================
+//
+//   POST   /list/lpush/{key}     body: one element per line → new length
+//   POST   /list/rpush/{key}     body: one element per line → new length
+//   POST   /list/lpop/{key}[?count=n]                       (LPOP)
+//   POST   /list/rpop/{key}[?count=n]                       (RPOP)
+//   GET    /list/range/{key}?start=0&stop=-1                (LRANGE)
+//   PUT    /list/trim/{key}?start=0&stop=99                 (LTRIM)
+//   POST   /list/blpop/{key}?timeout=seconds                (BLPOP)
+//   POST   /list/brpop/{key}?timeout=seconds                (BRPOP)
+//
+// Pops are POST (not GET) because they CHANGE the list.
+// BLPOP/BRPOP never hold a worker thread while waiting: an empty list parks
+// the client's connection in KeyWaiters, and the next push answers it.
+// timeout=0 waits forever; a timeout answers 404.
+// =============================================================================
+
+#pragma once
+
+#include "api/key_waiters.hpp"
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class ListHandler {
+public:
+  ListHandler(KeyValueStore &store, KeyWaiters &waiters);
+
+  // Register all /list/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse push(const HttpRequest &request, const RouteParams &params,
+                    bool to_front);
+  HttpResponse pop(const HttpRequest &request, const RouteParams &params,
+                   bool from_front);
+  HttpResponse range(const HttpRequest &request,
+                     const RouteParams &params) const;
+  HttpResponse trim(const HttpRequest &request, const RouteParams &params);
+  HttpResponse blocking_pop(const HttpRequest &request,
+                            const RouteParams &params, bool from_front);
+
+private:
+  KeyValueStore &store_;  // NOT owned
+  KeyWaiters &waiters_;   // NOT owned — shared with other blocking commands
+};
+
+} // namespace mini_redis
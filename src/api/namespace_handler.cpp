@@ -0,0 +1,259 @@
+// =============================================================================
+// namespace_handler.cpp — Namespace Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/namespace_handler.hpp"
+#include "api/handler_util.hpp"
+#include "api/kv_handler.hpp"
+#include "util/logger.hpp"
+
+#include <memory> // std::shared_ptr
+#include <string>
+
+namespace mini_redis {
+
+namespace {
+
+// ---- NamespacePath — "/ns/" suffixes taken apart ----
+//   "acme"          → name "acme"
+//   "acme/flush"    → name "acme", action "flush"
+//   "acme/kv"       → name "acme", action "kv"
+//   "acme/kv/a/b"   → name "acme", action "kv", key "a/b"
+struct NamespacePath {
+  std::string name;
+  std::string action;
+  std::string key;
+  bool has_key = false; // "acme/kv/" has one, empty; "acme/kv" doesn't
+};
+
+NamespacePath split_path(const std::string &suffix) {
+  NamespacePath path;
+  const std::size_t slash = suffix.find('/');
+  path.name = suffix.substr(0, slash);
+  if (slash == std::string::npos) {
+    return path;
+  }
+  const std::size_t key_slash = suffix.find('/', slash + 1);
+  path.action = suffix.substr(slash + 1, key_slash - slash - 1);
+  if (key_slash != std::string::npos) {
+    path.key = suffix.substr(key_slash + 1);
+    path.has_key = true;
+  }
+  return path;
+}
+
+HttpResponse no_such_namespace(const std::string &name) {
+  return HttpResponse::not_found().body("No such namespace: " + name);
+}
+
+} // anonymous namespace
+
+NamespaceHandler::NamespaceHandler(NamespaceRegistry &namespaces)
+    : namespaces_(namespaces) {}
+
+void NamespaceHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::GET, "/ns/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return get(req, params);
+                   });
+  router.add_route(HttpMethod::PUT, "/ns/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return put(req, params);
+                   });
+  router.add_route(HttpMethod::DELETE, "/ns/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return remove(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/ns/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return post(req, params);
+                   });
+  // After "/ns/", like GET /kv after GET /kv/
+  router.add_route(HttpMethod::GET, "/ns",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return list(req, params);
+                   });
+
+  Logger::info("Namespace handler routes registered");
+}
+
+// =============================================================================
+// GET /ns/{name}, GET /ns/{name}/kv[/{key}]
+// =============================================================================
+// Inside a namespace the work is KvHandler's, on the namespace's store.
+// The handler is only a reference to the store: building one per request
+// costs nothing, and the shared_ptr keeps the store alive until the
+// response is built, even if the namespace is flushed meanwhile.
+// =============================================================================
+HttpResponse NamespaceHandler::get(const HttpRequest &request,
+                                   const RouteParams &params) {
+  const NamespacePath path = split_path(params.path_suffix);
+  const auto ns = namespaces_.find(path.name);
+  if (ns == nullptr) {
+    return no_such_namespace(path.name);
+  }
+  if (path.action.empty()) {
+    return info(*ns);
+  }
+  if (path.action != "kv") {
+    return HttpResponse::not_found().body("Not Found: " + request.path());
+  }
+
+  const KvHandler kv(ns->store());
+  if (!path.has_key) {
+    return kv.list_keys(request, RouteParams{});
+  }
+  return kv.get_key(request, RouteParams{path.key});
+}
+
+// =============================================================================
+// PUT /ns/{name}, PUT /ns/{name}/kv/{key}
+// =============================================================================
+HttpResponse NamespaceHandler::put(const HttpRequest &request,
+                                   const RouteParams &params) {
+  const NamespacePath path = split_path(params.path_suffix);
+  if (path.action.empty()) {
+    return configure(request, path.name);
+  }
+  const auto ns = namespaces_.find(path.name);
+  if (ns == nullptr) {
+    return no_such_namespace(path.name);
+  }
+  if (path.action != "kv") {
+    return HttpResponse::not_found().body("Not Found: " + request.path());
+  }
+
+  if (!ns->admits_writes()) {
+    return HttpResponse::insufficient_storage().body(
+        "OOM namespace '" + path.name + "' is over its max_memory of " +
+        std::to_string(ns->limits().max_memory) + " bytes");
+  }
+  // Charged what the write actually changed, measured either side of it:
+  // an overwrite costs only the difference, a refused write nothing
+  KvHandler kv(ns->store());
+  const std::size_t before = ns->entry_bytes(path.key);
+  HttpResponse response = kv.put_key(request, RouteParams{path.key});
+  ns->charge(before, ns->entry_bytes(path.key));
+  return response;
+}
+
+// =============================================================================
+// DELETE /ns/{name}, DELETE /ns/{name}/kv/{key}
+// =============================================================================
+HttpResponse NamespaceHandler::remove(const HttpRequest &request,
+                                      const RouteParams &params) {
+  const NamespacePath path = split_path(params.path_suffix);
+  if (path.action.empty()) {
+    if (!namespaces_.drop(path.name)) {
+      return no_such_namespace(path.name);
+    }
+    return HttpResponse::ok().body("OK");
+  }
+  const auto ns = namespaces_.find(path.name);
+  if (ns == nullptr) {
+    return no_such_namespace(path.name);
+  }
+  if (path.action != "kv") {
+    return HttpResponse::not_found().body("Not Found: " + request.path());
+  }
+
+  KvHandler kv(ns->store());
+  const std::size_t before = ns->entry_bytes(path.key);
+  HttpResponse response = kv.delete_key(request, RouteParams{path.key});
+  ns->charge(before, ns->entry_bytes(path.key));
+  return response;
+}
+
+// =============================================================================
+// POST /ns/{name}/flush
+// =============================================================================
+HttpResponse NamespaceHandler::post(const HttpRequest &request,
+                                    const RouteParams &params) {
+  const NamespacePath path = split_path(params.path_suffix);
+  if (path.action != "flush" || path.has_key) {
+    return HttpResponse::not_found().body("Not Found: " + request.path());
+  }
+  if (!namespaces_.flush(path.name)) {
+    return no_such_namespace(path.name);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// GET /ns
+// =============================================================================
+HttpResponse NamespaceHandler::list(const HttpRequest & /*request*/,
+                                    const RouteParams & /*params*/) const {
+  return HttpResponse::ok().body(join_lines(namespaces_.names()));
+}
+
+// =============================================================================
+// PUT /ns/{name} — Create, or change some settings
+// =============================================================================
+// Settings left out of the query string keep their current value (their
+// default, for a new namespace).
+// =============================================================================
+HttpResponse NamespaceHandler::configure(const HttpRequest &request,
+                                         const std::string &name) {
+  if (!NamespaceRegistry::valid_name(name)) {
+    return HttpResponse::bad_request().body(
+        "ERR namespace names are 1-64 characters of [A-Za-z0-9_-]");
+  }
+  const auto existing = namespaces_.find(name);
+  NamespaceLimits limits =
+      existing != nullptr ? existing->limits() : NamespaceLimits{};
+
+  if (const auto text = request.get_query_param("max_memory")) {
+    const auto bytes = parse_integer(*text);
+    if (!bytes.has_value() || *bytes < 0) {
+      return HttpResponse::bad_request().body(
+          "ERR max_memory must be a non-negative integer");
+    }
+    limits.max_memory = static_cast<std::size_t>(*bytes);
+  }
+  if (const auto text = request.get_query_param("eviction")) {
+    const auto policy = parse_eviction_policy(*text);
+    if (!policy.has_value()) {
+      return HttpResponse::bad_request().body(
+          "ERR eviction must be noeviction, allkeys-random or volatile-ttl");
+    }
+    limits.eviction = *policy;
+  }
+  if (const auto text = request.get_query_param("expiry_ms")) {
+    const auto ms = parse_integer(*text);
+    if (!ms.has_value() || *ms <= 0) {
+      return HttpResponse::bad_request().body(
+          "ERR expiry_ms must be a positive integer");
+    }
+    limits.expiry_interval = std::chrono::milliseconds(*ms);
+  }
+
+  if (existing != nullptr) {
+    existing->set_limits(limits);
+    return HttpResponse::ok().body("OK");
+  }
+  if (!namespaces_.create(name, limits)) {
+    return HttpResponse::conflict().body("ERR namespace '" + name +
+                                         "' was just created");
+  }
+  return HttpResponse::created().body("OK");
+}
+
+// =============================================================================
+// GET /ns/{name} — Settings and usage
+// =============================================================================
+HttpResponse NamespaceHandler::info(const Namespace &ns) const {
+  const NamespaceLimits limits = ns.limits();
+  const KeyCounts counts = ns.store().key_counts();
+  std::string body;
+  body += "keys " + std::to_string(counts.integer + counts.string) + "\n";
+  body += "used_bytes " + std::to_string(ns.used_bytes()) + "\n";
+  body += "max_memory " + std::to_string(limits.max_memory) + "\n";
+  body += std::string("eviction ") + eviction_policy_name(limits.eviction) +
+          "\n";
+  body += "expiry_ms " + std::to_string(limits.expiry_interval.count()) + "\n";
+  body += "evicted " + std::to_string(ns.evicted());
+  return HttpResponse::ok().body(body);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,51 @@
+// =============================================================================
+// namespace_handler.hpp — Namespace Endpoints (HEADER)
+// =============================================================================
+// Managing namespaces (see core/namespaces.hpp):
+//   GET    /ns                 → every namespace name, one per line
+//   PUT    /ns/{name}?max_memory=N&eviction=P&expiry_ms=N
+//                               → create it (201), or change the given
+//                                 settings of an existing one (200)
+//   GET    /ns/{name}          → its settings and usage, "name value" lines
+//   DELETE /ns/{name}          → drop it, keys and all
+//   POST   /ns/{name}/flush    → empty it (O(1): freed in the background)
+//
+// And the key-value API inside one, exactly as /kv/... behaves outside:
+//   GET / PUT / DELETE /ns/{name}/kv/{key},  GET /ns/{name}/kv
+// A PUT to a namespace over its quota under "noeviction" gets
+// 507 Insufficient Storage ("OOM ...", as Redis words it).
+// =============================================================================
+
+#pragma once
+
+#include "core/namespaces.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class NamespaceHandler {
+public:
+  explicit NamespaceHandler(NamespaceRegistry &namespaces);
+
+  // Register the /ns/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers (one per method: the path picks the action) ----
+  HttpResponse get(const HttpRequest &request, const RouteParams &params);
+  HttpResponse put(const HttpRequest &request, const RouteParams &params);
+  HttpResponse remove(const HttpRequest &request, const RouteParams &params);
+  HttpResponse post(const HttpRequest &request, const RouteParams &params);
+  HttpResponse list(const HttpRequest &request,
+                    const RouteParams &params) const;
+
+private:
+  HttpResponse info(const Namespace &ns) const;
+  HttpResponse configure(const HttpRequest &request, const std::string &name);
+
+  // Reference to the namespaces (NOT owned by this class)
+  NamespaceRegistry &namespaces_;
+};
+
+} // namespace mini_redis
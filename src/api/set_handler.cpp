@@ -0,0 +1,205 @@
+// =============================================================================
+// set_handler.cpp — Set REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/set_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+namespace mini_redis {
+
+SetHandler::SetHandler(KeyValueStore &store) : store_(store) {}
+
+void SetHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/set/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return add(req, params);
+                   });
+  router.add_route(HttpMethod::DELETE, "/set/rem/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return remove(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/set/ismember/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return is_member(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/set/card/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return cardinality(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/set/members/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return members(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/set/inter",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return intersect(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/set/union",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return unite(req, params);
+                   });
+
+  Logger::info("Set handler routes registered");
+}
+
+// =============================================================================
+// PUT /set/add/{key} — body: one member per line
+// =============================================================================
+HttpResponse SetHandler::add(const HttpRequest &request,
+                             const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto members = split_lines(request.body());
+  if (key.empty() || members.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one member per line");
+  }
+
+  std::size_t added = 0;
+  const auto status = store_.modify_as<Set>(key, true, [&](Set &set) {
+    added = set.add_all(members);
+    return true;
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(added));
+}
+
+// =============================================================================
+// DELETE /set/rem/{key}?member=m — removing the last member deletes the key
+// =============================================================================
+HttpResponse SetHandler::remove(const HttpRequest &request,
+                                const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+
+  std::vector<std::string> members = split_lines(request.body());
+  if (const auto member = request.get_query_param("member")) {
+    members.push_back(member.value());
+  }
+  if (key.empty() || members.empty()) {
+    return HttpResponse::bad_request().body("Usage: /set/rem/{key}?member=m");
+  }
+
+  std::size_t removed = 0;
+  const auto status = store_.modify_as<Set>(key, false, [&](Set &set) {
+    for (const auto &member : members) {
+      if (set.remove(member)) {
+        ++removed;
+      }
+    }
+    return !set.empty();
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(removed));
+}
+
+// =============================================================================
+// GET /set/ismember/{key}?member=m
+// =============================================================================
+HttpResponse SetHandler::is_member(const HttpRequest &request,
+                                   const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto member = request.get_query_param("member");
+  if (key.empty() || !member.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: /set/ismember/{key}?member=m");
+  }
+
+  bool found = false;
+  const auto status = store_.read_as<Set>(
+      key, [&](const Set &set) { found = set.contains(member.value()); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  // A missing key is an empty set: nothing is a member
+  return HttpResponse::ok().body(found ? "1" : "0");
+}
+
+// =============================================================================
+// GET /set/card/{key}
+// =============================================================================
+HttpResponse SetHandler::cardinality(const HttpRequest & /*request*/,
+                                     const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::size_t count = 0;
+  const auto status =
+      store_.read_as<Set>(key, [&](const Set &set) { count = set.size(); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(count));
+}
+
+// =============================================================================
+// GET /set/members/{key}
+// =============================================================================
+HttpResponse SetHandler::members(const HttpRequest & /*request*/,
+                                 const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::vector<std::string> items;
+  const auto status =
+      store_.read_as<Set>(key, [&](const Set &set) { items = set.members(); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(join_lines(items));
+}
+
+// =============================================================================
+// POST /set/inter — body: one key per line
+// =============================================================================
+// All keys are read under one lock and intersected in place — no key's
+// members are copied out of the store except the final result.
+// =============================================================================
+HttpResponse SetHandler::intersect(const HttpRequest &request,
+                                   const RouteParams & /*params*/) const {
+  const auto keys = split_lines(request.body());
+  if (keys.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one key per line");
+  }
+
+  std::vector<std::string> items;
+  const auto status = store_.read_many_as<Set>(
+      keys, [&](const std::vector<const Set *> &sets) {
+        items = Set::intersect(sets);
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return HttpResponse::conflict().body(
+        "WRONGTYPE Operation against a key holding the wrong kind of value");
+  }
+  return HttpResponse::ok().body(join_lines(items));
+}
+
+// =============================================================================
+// POST /set/union — body: one key per line
+// =============================================================================
+HttpResponse SetHandler::unite(const HttpRequest &request,
+                               const RouteParams & /*params*/) const {
+  const auto keys = split_lines(request.body());
+  if (keys.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one key per line");
+  }
+
+  std::vector<std::string> items;
+  const auto status = store_.read_many_as<Set>(
+      keys,
+      [&](const std::vector<const Set *> &sets) { items = Set::unite(sets); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return HttpResponse::conflict().body(
+        "WRONGTYPE Operation against a key holding the wrong kind of value");
+  }
+  return HttpResponse::ok().body(join_lines(items));
+}
+
+} // namespace mini_redis
@@ -0,0 +1,55 @@
+// =============================================================================
+// set_handler.hpp — Set REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the Set value type over HTTP. Single-key commands take the key as
+// the path suffix; multi-key commands list their keys in the body:
+//
+//   PUT    /set/add/{key}                 body: one member per line  (SADD)
+//   DELETE /set/rem/{key}?member=m        (or one member per line)   (SREM)
+//   GET    /set/ismember/{key}?member=m   → "1" or "0"               (SISMEMBER)
+//   GET    /set/card/{key}                → member count             (SCARD)
+//   GET    /set/members/{key}                                        (SMEMBERS)
+//   POST   /set/inter                     body: one key per line     (SINTER)
+//   POST   /set/union                     body: one key per line     (SUNION)
+//
+// SINTER/SUNION are POST only because the key list travels in the body;
+// they don't modify anything. Results are one member per line.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class SetHandler {
+public:
+  explicit SetHandler(KeyValueStore &store);
+
+  // Register all /set/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse remove(const HttpRequest &request, const RouteParams &params);
+  HttpResponse is_member(const HttpRequest &request,
+                         const RouteParams &params) const;
+  HttpResponse cardinality(const HttpRequest &request,
+                           const RouteParams &params) const;
+  HttpResponse members(const HttpRequest &request,
+                       const RouteParams &params) const;
+  HttpResponse intersect(const HttpRequest &request,
+                         const RouteParams &params) const;
+  HttpResponse unite(const HttpRequest &request,
+                     const RouteParams &params) const;
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,351 @@
+// =============================================================================
+// sketch_handler.cpp — Bloom Filter & Count-Min Sketch Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/sketch_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+#include <cstdint>
+
+namespace mini_redis {
+
+namespace {
+
+// Safety limits for client-chosen sizes (a typo shouldn't allocate 80 GB)
+constexpr double MAX_BLOOM_BITS = 4.0 * 1024 * 1024 * 1024; // 512 MB
+constexpr std::uint64_t MAX_CMS_CELLS = 64 * 1024 * 1024; // 512 MB, as uint64
+
+// The items of a request: the body's lines, or the single ?item= parameter
+std::vector<std::string> items_of(const HttpRequest &request) {
+  if (const auto item = request.get_query_param("item")) {
+    return {*item};
+  }
+  return split_lines(request.body());
+}
+
+std::string bools_to_lines(const std::vector<bool> &flags) {
+  std::string out;
+  out.reserve(flags.size() * 2);
+  for (std::size_t i = 0; i < flags.size(); ++i) {
+    if (i > 0) {
+      out += '\n';
+    }
+    out += flags[i] ? '1' : '0';
+  }
+  return out;
+}
+
+std::string counts_to_lines(const std::vector<std::uint64_t> &counts) {
+  std::vector<std::string> lines;
+  lines.reserve(counts.size());
+  for (const std::uint64_t count : counts) {
+    lines.push_back(std::to_string(count));
+  }
+  return join_lines(lines);
+}
+
+// "item count" → (item, count); a line without a numeric last word is an
+// item with count 1
+std::pair<std::string, std::uint64_t> parse_increment(const std::string &line) {
+  const auto space = line.rfind(' ');
+  if (space != std::string::npos) {
+    const auto count = parse_integer(line.substr(space + 1));
+    if (count.has_value() && *count >= 0) {
+      return {line.substr(0, space), static_cast<std::uint64_t>(*count)};
+    }
+  }
+  return {line, 1};
+}
+
+HttpResponse key_exists_response(const std::string &key) {
+  return HttpResponse::conflict().body("ERR key '" + key +
+                                       "' already holds data");
+}
+
+} // anonymous namespace
+
+SketchHandler::SketchHandler(KeyValueStore &store) : store_(store) {}
+
+void SketchHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/bf/reserve/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return bf_reserve(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/bf/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return bf_add(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/bf/exists/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return bf_exists(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/bf/exists/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return bf_exists(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/bf/info/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return bf_info(req, params);
+                   });
+  router.add_route(HttpMethod::PUT, "/cms/init/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return cms_init(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/cms/incrby/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return cms_incrby(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/cms/query/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return cms_query(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/cms/query/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return cms_query(req, params);
+                   });
+
+  Logger::info("Sketch handler routes registered");
+}
+
+// =============================================================================
+// PUT /bf/reserve/{key}?error=&capacity=
+// =============================================================================
+HttpResponse SketchHandler::bf_reserve(const HttpRequest &request,
+                                       const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto error = parse_double(request.get_query_param("error").value_or(
+      std::to_string(BloomFilter::DEFAULT_ERROR_RATE)));
+  const auto capacity =
+      parse_integer(request.get_query_param("capacity").value_or(
+          std::to_string(BloomFilter::DEFAULT_CAPACITY)));
+  if (key.empty() || !error || !(*error > 0.0 && *error < 1.0) || !capacity ||
+      *capacity < 1 ||
+      static_cast<std::uint64_t>(*capacity) > BloomFilter::MAX_CAPACITY) {
+    return HttpResponse::bad_request().body(
+        "Usage: ?error=<0..1 exclusive>&capacity=<positive integer>");
+  }
+  // The capacity alone doesn't bound the size: error=1e-300 needs ~1440
+  // bits per item
+  if (BloomFilter::first_layer_bits(*error,
+                                    static_cast<std::size_t>(*capacity)) >
+      MAX_BLOOM_BITS) {
+    return HttpResponse::bad_request().body("Filter too large");
+  }
+
+  bool reserved = false;
+  const auto status =
+      store_.modify_as<BloomFilter>(key, true, [&](BloomFilter &filter) {
+        if (filter.empty()) {
+          filter = BloomFilter(*error, static_cast<std::size_t>(*capacity));
+          reserved = true;
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!reserved) {
+    return key_exists_response(key);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /bf/add/{key} — body: one item per line
+// =============================================================================
+HttpResponse SketchHandler::bf_add(const HttpRequest &request,
+                                   const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto items = items_of(request);
+  if (key.empty() || items.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one item per line");
+  }
+
+  std::vector<bool> added;
+  const auto status =
+      store_.modify_as<BloomFilter>(key, true, [&](BloomFilter &filter) {
+        added = filter.add_all(items);
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(bools_to_lines(added));
+}
+
+// =============================================================================
+// POST /bf/exists/{key} (body) — GET /bf/exists/{key}?item=
+// =============================================================================
+HttpResponse SketchHandler::bf_exists(const HttpRequest &request,
+                                      const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto items = items_of(request);
+  if (items.empty()) {
+    return HttpResponse::bad_request().body(
+        "Usage: ?item=<item> or body = one item per line");
+  }
+
+  // A missing key is an empty filter: nothing "exists"
+  std::vector<bool> found(items.size(), false);
+  const auto status = store_.read_as<BloomFilter>(
+      key, [&](const BloomFilter &filter) {
+        found = filter.contains_all(items);
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(bools_to_lines(found));
+}
+
+// =============================================================================
+// GET /bf/info/{key}
+// =============================================================================
+HttpResponse SketchHandler::bf_info(const HttpRequest & /*request*/,
+                                    const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::string info;
+  const auto status = store_.read_as<BloomFilter>(
+      key, [&](const BloomFilter &filter) {
+        info = "items:" + std::to_string(filter.size()) +
+               "\nlayers:" + std::to_string(filter.layer_count()) +
+               "\nbytes:" + std::to_string(filter.memory_bytes()) +
+               "\nerror_rate:" + format_double(filter.error_rate());
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body(info);
+}
+
+// =============================================================================
+// PUT /cms/init/{key}?width=&depth=  or  ?error=&probability=
+// =============================================================================
+HttpResponse SketchHandler::cms_init(const HttpRequest &request,
+                                     const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto usage = [] {
+    return HttpResponse::bad_request().body(
+        "Usage: ?width=<n>&depth=<n> or ?error=<0..1>&probability=<0..1>");
+  };
+  const auto too_large = [] {
+    return HttpResponse::bad_request().body("Sketch too large");
+  };
+  if (key.empty()) {
+    return usage();
+  }
+
+  std::optional<CountMinSketch> fresh;
+  if (request.get_query_param("error").has_value()) {
+    const auto error = parse_double(*request.get_query_param("error"));
+    const auto probability =
+        parse_double(request.get_query_param("probability").value_or(""));
+    if (!error || !probability || !(*error > 0.0 && *error < 1.0) ||
+        !(*probability > 0.0 && *probability < 1.0)) {
+      return usage();
+    }
+    fresh = CountMinSketch::from_error(*error, *probability, MAX_CMS_CELLS);
+    if (!fresh) {
+      return too_large();
+    }
+  } else {
+    const auto width = parse_integer(request.get_query_param("width").value_or(
+        std::to_string(CountMinSketch::DEFAULT_WIDTH)));
+    const auto depth = parse_integer(request.get_query_param("depth").value_or(
+        std::to_string(CountMinSketch::DEFAULT_DEPTH)));
+    if (!width || !depth || *width < 1 || *depth < 1) {
+      return usage();
+    }
+    // Checked before the sketch exists: width * depth can overflow
+    if (!CountMinSketch::fits(static_cast<std::uint64_t>(*width),
+                              static_cast<std::uint64_t>(*depth),
+                              MAX_CMS_CELLS)) {
+      return too_large();
+    }
+    fresh = CountMinSketch(static_cast<std::size_t>(*width),
+                           static_cast<std::size_t>(*depth));
+  }
+
+  bool initialized = false;
+  const auto status = store_.modify_as<CountMinSketch>(
+      key, true, [&](CountMinSketch &sketch) {
+        if (sketch.total() == 0) {
+          sketch = std::move(*fresh);
+          initialized = true;
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!initialized) {
+    return key_exists_response(key);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /cms/incrby/{key} — body: "item [count]" per line
+// =============================================================================
+HttpResponse SketchHandler::cms_incrby(const HttpRequest &request,
+                                       const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto lines = split_lines(request.body());
+  if (key.empty() || lines.empty()) {
+    return HttpResponse::bad_request().body(
+        "Usage: body = one \"item [count]\" per line");
+  }
+
+  std::vector<std::pair<std::string, std::uint64_t>> increments;
+  increments.reserve(lines.size());
+  for (const auto &line : lines) {
+    increments.push_back(parse_increment(line));
+  }
+
+  std::vector<std::uint64_t> estimates;
+  const auto status = store_.modify_as<CountMinSketch>(
+      key, true, [&](CountMinSketch &sketch) {
+        estimates = sketch.increment_all(increments);
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(counts_to_lines(estimates));
+}
+
+// =============================================================================
+// POST /cms/query/{key} (body) — GET /cms/query/{key}?item=
+// =============================================================================
+HttpResponse SketchHandler::cms_query(const HttpRequest &request,
+                                      const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto items = items_of(request);
+  if (items.empty()) {
+    return HttpResponse::bad_request().body(
+        "Usage: ?item=<item> or body = one item per line");
+  }
+
+  std::vector<std::uint64_t> estimates(items.size(), 0);
+  const auto status = store_.read_as<CountMinSketch>(
+      key, [&](const CountMinSketch &sketch) {
+        estimates = sketch.query_all(items);
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(counts_to_lines(estimates));
+}
+
+} // namespace mini_redis
@@ -0,0 +1,63 @@
+// =============================================================================
+// sketch_handler.hpp — Bloom Filter & Count-Min Sketch Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the two probabilistic value types over HTTP (RedisBloom-style).
+// Every add/query endpoint takes a BATCH — one item per line — and
+// answers one line per item, in order: one round trip and one lock for
+// the whole batch instead of one per item.
+//
+//   PUT  /bf/reserve/{key}?error=0.01&capacity=1000              (BF.RESERVE)
+//   POST /bf/add/{key}     body: items → "1" new / "0" seen      (BF.MADD)
+//   POST /bf/exists/{key}  body: items → "1" maybe / "0" no      (BF.MEXISTS)
+//   GET  /bf/exists/{key}?item=x → "1" / "0"                     (BF.EXISTS)
+//   GET  /bf/info/{key}    → items, layers, bytes, error rate    (BF.INFO)
+//
+//   PUT  /cms/init/{key}?width=2000&depth=5                      (CMS.INITBYDIM)
+//   PUT  /cms/init/{key}?error=0.001&probability=0.01            (CMS.INITBYPROB)
+//   POST /cms/incrby/{key} body: "item [count]" lines → estimates (CMS.INCRBY)
+//   POST /cms/query/{key}  body: items → estimates               (CMS.QUERY)
+//   GET  /cms/query/{key}?item=x → estimate
+//
+// Adding to a missing key creates it with the default parameters.
+// Reserving / initializing a key that already holds data is refused.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class SketchHandler {
+public:
+  explicit SketchHandler(KeyValueStore &store);
+
+  // Register all /bf/... and /cms/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Bloom filter ----
+  HttpResponse bf_reserve(const HttpRequest &request,
+                          const RouteParams &params);
+  HttpResponse bf_add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse bf_exists(const HttpRequest &request,
+                         const RouteParams &params) const;
+  HttpResponse bf_info(const HttpRequest &request,
+                       const RouteParams &params) const;
+
+  // ---- Count-min sketch ----
+  HttpResponse cms_init(const HttpRequest &request, const RouteParams &params);
+  HttpResponse cms_incrby(const HttpRequest &request,
+                          const RouteParams &params);
+  HttpResponse cms_query(const HttpRequest &request,
+                         const RouteParams &params) const;
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
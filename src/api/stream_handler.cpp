@@ -0,0 +1,426 @@
+// =============================================================================
+// stream_handler.cpp — Stream REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/stream_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm> // std::min
+#include <chrono>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace mini_redis {
+
+namespace {
+
+std::uint64_t now_ms() {
+  return static_cast<std::uint64_t>(
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count());
+}
+
+// ?name=<non-negative integer>: std::nullopt if absent, 'invalid' if bad
+std::optional<std::uint64_t> count_param(const HttpRequest &request,
+                                         const std::string &name,
+                                         bool &invalid) {
+  const auto text = request.get_query_param(name);
+  if (!text.has_value()) {
+    return std::nullopt;
+  }
+  const auto value = parse_integer(*text);
+  if (!value.has_value() || *value < 0) {
+    invalid = true;
+    return std::nullopt;
+  }
+  return static_cast<std::uint64_t>(*value);
+}
+
+// ---- Trimming options shared by XADD and XTRIM ----
+// maxage=ms is turned into the equivalent minid: entries whose ID (= time
+// added) is older than now - maxage go.
+struct TrimSpec {
+  std::optional<std::uint64_t> max_len;
+  std::optional<StreamId> min_id;
+
+  bool any() const { return max_len.has_value() || min_id.has_value(); }
+
+  std::size_t apply(Stream &stream) const {
+    std::size_t removed = 0;
+    if (max_len.has_value()) {
+      removed += stream.trim_max_len(*max_len);
+    }
+    if (min_id.has_value()) {
+      removed += stream.trim_min_id(*min_id);
+    }
+    return removed;
+  }
+};
+
+std::optional<TrimSpec> parse_trim(const HttpRequest &request) {
+  TrimSpec spec;
+  bool invalid = false;
+  spec.max_len = count_param(request, "maxlen", invalid);
+  const auto max_age = count_param(request, "maxage", invalid);
+  if (max_age.has_value()) {
+    const std::uint64_t now = now_ms();
+    spec.min_id = StreamId{now > *max_age ? now - *max_age : 0, 0};
+  }
+  if (const auto text = request.get_query_param("minid")) {
+    const auto id = StreamId::parse(*text);
+    invalid = invalid || !id.has_value() || max_age.has_value();
+    spec.min_id = id;
+  }
+  if (invalid) {
+    return std::nullopt;
+  }
+  return spec;
+}
+
+// "-" / "+" for the open ends; a bare "<ms>" covers the whole millisecond
+std::optional<StreamId> range_bound(const HttpRequest &request,
+                                    const std::string &name, bool is_end) {
+  const auto text = request.get_query_param(name);
+  if (!text.has_value() || *text == (is_end ? "+" : "-")) {
+    return is_end ? StreamId::max() : StreamId::min();
+  }
+  return StreamId::parse(*text, is_end ? ~std::uint64_t{0} : 0);
+}
+
+std::string format_entry(const StreamEntry &entry) {
+  std::string line = entry.id.to_string();
+  for (const auto &[field, value] : entry.fields) {
+    line += '\t';
+    line += field;
+    line += '\t';
+    line += value;
+  }
+  return line;
+}
+
+// One XREAD request line: read 'key' after 'after' — or, when 'after' is
+// empty, after the consumer's stored offset (looked up at serve time, so
+// readers sharing a consumer name never get the same entry twice)
+struct ReadPosition {
+  std::string key;
+  std::optional<StreamId> after;
+};
+
+} // anonymous namespace
+
+StreamHandler::StreamHandler(KeyValueStore &store, KeyWaiters &waiters)
+    : store_(store), waiters_(waiters) {}
+
+void StreamHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::POST, "/stream/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return add(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/stream/range/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return range(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/stream/read",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return read(req, params);
+                   });
+  router.add_route(HttpMethod::PUT, "/stream/offset/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return set_offset(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/stream/trim/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return trim(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/stream/info/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return info(req, params);
+                   });
+
+  Logger::info("Stream handler routes registered");
+}
+
+// =============================================================================
+// POST /stream/add/{key}?id=*|<ms>-*|<ms>-<seq>[&maxlen=|minid=|maxage=]
+// =============================================================================
+// The ID is resolved INSIDE the store lock: "*" must see the stream's
+// current last ID, or two concurrent adds could pick the same one.
+// =============================================================================
+HttpResponse StreamHandler::add(const HttpRequest &request,
+                                const RouteParams &params) {
+  const std::string key = params.path_suffix;
+  const std::string id_text = request.get_query_param("id").value_or("*");
+  const auto trim_spec = parse_trim(request);
+
+  StreamFields fields;
+  for (const auto &line : split_lines(request.body())) {
+    const auto space = line.find(' ');
+    if (space == std::string::npos) {
+      fields.clear();
+      break;
+    }
+    fields.emplace_back(line.substr(0, space), line.substr(space + 1));
+  }
+
+  // "<ms>-*" → auto sequence within that millisecond
+  std::optional<std::uint64_t> auto_seq_ms;
+  std::optional<StreamId> explicit_id;
+  if (id_text.size() > 2 && id_text.compare(id_text.size() - 2, 2, "-*") == 0) {
+    const auto ms = StreamId::parse(id_text.substr(0, id_text.size() - 2));
+    auto_seq_ms = ms ? std::optional(ms->ms) : std::nullopt;
+  } else if (id_text != "*") {
+    explicit_id = StreamId::parse(id_text);
+  }
+  const bool id_valid = id_text == "*" || auto_seq_ms || explicit_id;
+
+  if (key.empty() || fields.empty() || !trim_spec.has_value() || !id_valid) {
+    return HttpResponse::bad_request().body(
+        "Usage: POST /stream/add/{key}?id=*|<ms>-*|<ms>-<seq>"
+        "[&maxlen=n|minid=id|maxage=ms], body = one \"field value\" per line");
+  }
+
+  std::optional<StreamId> added;
+  StreamId last;
+  const std::uint64_t now = now_ms();
+  const auto status = store_.modify_as<Stream>(key, true, [&](Stream &stream) {
+    const auto id = explicit_id ? explicit_id
+                    : auto_seq_ms ? stream.next_id_in(*auto_seq_ms)
+                                  : stream.next_id(now);
+    if (id.has_value() && stream.add(*id, fields)) {
+      added = id;
+      trim_spec->apply(stream);
+    }
+    last = stream.last_id();
+    // Don't leave behind a stream we just created for a rejected add
+    return !stream.empty() || stream.last_id() != StreamId::min();
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!added.has_value()) {
+    return HttpResponse::bad_request().body(
+        "ERR The ID specified is equal or smaller than the stream's last ID " +
+        last.to_string());
+  }
+
+  // Readers don't consume entries: every blocked XREAD gets to look
+  waiters_.notify(key, KeyWaiters::Wake::ALL);
+  return HttpResponse::ok().body(added->to_string());
+}
+
+// =============================================================================
+// GET /stream/range/{key}?start=-&end=+[&count=n]
+// =============================================================================
+HttpResponse StreamHandler::range(const HttpRequest &request,
+                                  const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto start = range_bound(request, "start", false);
+  const auto end = range_bound(request, "end", true);
+  bool invalid = false;
+  const auto count = count_param(request, "count", invalid);
+  if (!start.has_value() || !end.has_value() || invalid) {
+    return HttpResponse::bad_request().body(
+        "Usage: /stream/range/{key}?start=-&end=+[&count=n]");
+  }
+
+  std::vector<std::string> lines;
+  const auto status = store_.read_as<Stream>(key, [&](const Stream &stream) {
+    for (const auto &entry : stream.range(*start, *end, count.value_or(0))) {
+      lines.push_back(format_entry(entry));
+    }
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(join_lines(lines));
+}
+
+// =============================================================================
+// POST /stream/read[?count=n][&block=ms][&consumer=name]
+// =============================================================================
+// "$" is resolved to the stream's last ID NOW, before blocking — "new
+// entries" means new relative to this request, not to the eventual wakeup.
+// Like BLPOP, the serve lambda runs again from other threads on every XADD,
+// so it captures copies only.
+// =============================================================================
+HttpResponse StreamHandler::read(const HttpRequest &request,
+                                 const RouteParams & /*params*/) {
+  bool invalid = false;
+  const auto count = count_param(request, "count", invalid);
+  const auto block_ms = count_param(request, "block", invalid);
+  const std::string consumer = request.get_query_param("consumer").value_or("");
+
+  std::vector<ReadPosition> positions;
+  std::vector<std::string> keys;
+  for (const auto &line : split_lines(request.body())) {
+    const auto space = line.find(' ');
+    ReadPosition position{line.substr(0, space), std::nullopt};
+    const std::string id_text =
+        space == std::string::npos ? "" : line.substr(space + 1);
+
+    if (id_text == "$") {
+      StreamId last;
+      const auto status = store_.read_as<Stream>(
+          position.key, [&](const Stream &stream) { last = stream.last_id(); });
+      if (status == AccessStatus::WRONG_TYPE) {
+        return wrong_type_response(position.key);
+      }
+      position.after = last;
+    } else if (!id_text.empty()) {
+      position.after = StreamId::parse(id_text);
+      invalid = invalid || !position.after.has_value();
+    } else {
+      invalid = invalid || consumer.empty(); // no id needs a stored offset
+    }
+    keys.push_back(position.key);
+    positions.push_back(std::move(position));
+  }
+
+  if (positions.empty() || invalid) {
+    return HttpResponse::bad_request().body(
+        "Usage: POST /stream/read[?count=n][&block=ms][&consumer=name], "
+        "body = one \"key id\" per line (id: an ID, $, or omitted with "
+        "consumer=)");
+  }
+
+  KeyValueStore &store = store_;
+  const std::size_t limit = count.value_or(0);
+  auto serve = [&store, positions, limit,
+                consumer]() -> std::optional<HttpResponse> {
+    std::vector<std::string> lines;
+    for (const auto &position : positions) {
+      const auto collect = [&](const Stream &stream, StreamId after) {
+        auto entries = stream.read_after(after, limit);
+        for (const auto &entry : entries) {
+          lines.push_back(position.key + "\t" + format_entry(entry));
+        }
+        return entries;
+      };
+
+      AccessStatus status;
+      if (consumer.empty()) {
+        status = store.read_as<Stream>(position.key, [&](const Stream &stream) {
+          collect(stream, *position.after);
+        });
+      } else {
+        // Delivery commits the consumer's offset, in the same lock
+        status =
+            store.modify_as<Stream>(position.key, false, [&](Stream &stream) {
+              const auto after = position.after.value_or(
+                  stream.offset(consumer).value_or(StreamId::min()));
+              const auto entries = collect(stream, after);
+              if (!entries.empty()) {
+                stream.set_offset(consumer, entries.back().id);
+              }
+              return true;
+            });
+      }
+      if (status == AccessStatus::WRONG_TYPE) {
+        return wrong_type_response(position.key);
+      }
+    }
+    if (lines.empty()) {
+      return std::nullopt; // keep waiting
+    }
+    return HttpResponse::ok().body(join_lines(lines));
+  };
+
+  if (!block_ms.has_value()) {
+    auto reply = serve();
+    return reply ? std::move(*reply) : HttpResponse::ok().body("");
+  }
+  // Clamped while still unsigned: 2^64-1 must not wrap to a negative count
+  const auto block = std::chrono::milliseconds(static_cast<long long>(
+      std::min<std::uint64_t>(*block_ms, KeyWaiters::MAX_TIMEOUT.count())));
+  return waiters_.block(keys, block,
+                        std::move(serve),
+                        HttpResponse::not_found().body("Timed out"));
+}
+
+// =============================================================================
+// PUT /stream/offset/{key}?consumer=name&id=id
+// =============================================================================
+HttpResponse StreamHandler::set_offset(const HttpRequest &request,
+                                       const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto consumer = request.get_query_param("consumer");
+  const auto id = StreamId::parse(request.get_query_param("id").value_or(""));
+  if (key.empty() || !consumer.has_value() || consumer->empty() ||
+      !id.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: PUT /stream/offset/{key}?consumer=name&id=<ms>-<seq>");
+  }
+
+  const auto status = store_.modify_as<Stream>(key, false, [&](Stream &stream) {
+    stream.set_offset(*consumer, *id);
+    return true;
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /stream/trim/{key}?maxlen=n|minid=id|maxage=ms
+// =============================================================================
+HttpResponse StreamHandler::trim(const HttpRequest &request,
+                                 const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto trim_spec = parse_trim(request);
+  if (key.empty() || !trim_spec.has_value() || !trim_spec->any()) {
+    return HttpResponse::bad_request().body(
+        "Usage: POST /stream/trim/{key}?maxlen=n|minid=id|maxage=ms");
+  }
+
+  std::size_t removed = 0;
+  const auto status = store_.modify_as<Stream>(key, false, [&](Stream &stream) {
+    removed = trim_spec->apply(stream);
+    return true; // an emptied stream keeps its last ID and offsets
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(removed));
+}
+
+// =============================================================================
+// GET /stream/info/{key}
+// =============================================================================
+HttpResponse StreamHandler::info(const HttpRequest & /*request*/,
+                                 const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::string text;
+  const auto status = store_.read_as<Stream>(key, [&](const Stream &stream) {
+    const auto first = stream.first_id();
+    text = "length:" + std::to_string(stream.size()) +
+           "\nblocks:" + std::to_string(stream.block_count()) +
+           "\nmemory:" + std::to_string(stream.memory_bytes()) +
+           "\nfirst-id:" + (first ? first->to_string() : "") +
+           "\nlast-id:" + stream.last_id().to_string();
+    for (const auto &[consumer, offset] : stream.offsets()) {
+      text += "\nconsumer:" + consumer + " " + offset.to_string();
+    }
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body(text);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,68 @@
+// =============================================================================
+// stream_handler.hpp — Stream REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the append-only stream value type (Redis streams). IDs are
+// "<ms>-<seq>"; in ranges "-" / "+" mean "oldest" / "newest", and a bare
+// "<ms>" covers that whole millisecond. (In a URL '+' decodes to a space:
+// send it as %2B, or just leave the parameter out.)
+//
+//   POST /stream/add/{key}[?id=*][&maxlen=n|minid=id|maxage=ms]
+//        body: one "field value" per line          → the new ID  (XADD)
+//   GET  /stream/range/{key}?start=-&end=+[&count=n]             (XRANGE)
+//   POST /stream/read[?count=n][&block=ms][&consumer=name]
+//        body: one "key [id]" per line                           (XREAD)
+//   PUT  /stream/offset/{key}?consumer=name&id=id  move an offset
+//   POST /stream/trim/{key}?maxlen=n|minid=id|maxage=ms
+//                                                  → removed     (XTRIM)
+//   GET  /stream/info/{key}      → length, blocks, IDs, consumers (XINFO)
+//
+// Entries are returned one per line, tab-separated:
+//   "<id>\t<field>\t<value>\t<field>\t<value>..."
+// and XREAD prefixes each line with "<key>\t".
+//
+// XREAD — READING AFTER A POSITION:
+// Each "key id" line asks for entries AFTER that ID; "$" means "only
+// entries added from now on". With ?consumer=name the id may be left out:
+// the stream then starts after that consumer's stored offset, and every
+// delivered entry advances it — independent readers, tracked server-side.
+//
+// BLOCKING: with ?block=ms (0 = forever) an XREAD that finds nothing parks
+// the client's connection in KeyWaiters — no worker thread waits — and
+// the next XADD to ANY of its keys answers it. A timeout answers 404.
+// =============================================================================
+
+#pragma once
+
+#include "api/key_waiters.hpp"
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class StreamHandler {
+public:
+  StreamHandler(KeyValueStore &store, KeyWaiters &waiters);
+
+  // Register all /stream/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse range(const HttpRequest &request,
+                     const RouteParams &params) const;
+  HttpResponse read(const HttpRequest &request, const RouteParams &params);
+  HttpResponse set_offset(const HttpRequest &request,
+                          const RouteParams &params);
+  HttpResponse trim(const HttpRequest &request, const RouteParams &params);
+  HttpResponse info(const HttpRequest &request,
+                    const RouteParams &params) const;
+
+private:
+  KeyValueStore &store_;  // NOT owned
+  KeyWaiters &waiters_;   // NOT owned — shared with other blocking commands
+};
+
+} // namespace mini_redis
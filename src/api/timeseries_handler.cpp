@@ -0,0 +1,294 @@
+// =============================================================================
+// timeseries_handler.cpp — Time-Series REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/timeseries_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+#include <chrono>
+#include <limits>
+
+namespace mini_redis {
+
+namespace {
+
+std::int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::system_clock::now().time_since_epoch())
+      .count();
+}
+
+// "*" = now, otherwise an integer
+std::optional<std::int64_t> parse_timestamp(const std::string &text) {
+  if (text == "*") {
+    return now_ms();
+  }
+  return parse_integer(text);
+}
+
+// ?name=<bound>: "-" / "+" for the open ends, 'fallback' when absent
+std::optional<std::int64_t> range_bound(const HttpRequest &request,
+                                        const std::string &name,
+                                        std::int64_t fallback) {
+  const auto text = request.get_query_param(name);
+  if (!text.has_value()) {
+    return fallback;
+  }
+  if (*text == "-") {
+    return std::numeric_limits<std::int64_t>::min();
+  }
+  if (*text == "+") {
+    return std::numeric_limits<std::int64_t>::max();
+  }
+  return parse_integer(*text);
+}
+
+std::optional<TimeSeries::Aggregation>
+parse_aggregation(const std::string &name) {
+  using Aggregation = TimeSeries::Aggregation;
+  if (name == "avg") {
+    return Aggregation::AVG;
+  }
+  if (name == "sum") {
+    return Aggregation::SUM;
+  }
+  if (name == "min") {
+    return Aggregation::MIN;
+  }
+  if (name == "max") {
+    return Aggregation::MAX;
+  }
+  if (name == "count") {
+    return Aggregation::COUNT;
+  }
+  if (name == "first") {
+    return Aggregation::FIRST;
+  }
+  if (name == "last") {
+    return Aggregation::LAST;
+  }
+  return std::nullopt;
+}
+
+// ?retention=<ms>: std::nullopt if absent, 'invalid' set if unparsable
+std::optional<long long> retention_param(const HttpRequest &request,
+                                         bool &invalid) {
+  const auto text = request.get_query_param("retention");
+  if (!text.has_value()) {
+    return std::nullopt;
+  }
+  const auto value = parse_integer(*text);
+  invalid = !value.has_value() || *value < 0;
+  return value;
+}
+
+std::string format_sample(const TimeSeries::Sample &sample) {
+  return std::to_string(sample.timestamp) + " " + format_double(sample.value);
+}
+
+} // anonymous namespace
+
+TimeSeriesHandler::TimeSeriesHandler(KeyValueStore &store) : store_(store) {}
+
+void TimeSeriesHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/ts/create/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return create(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/ts/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return add(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/ts/range/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return range(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/ts/get/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return get(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/ts/info/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return info(req, params);
+                   });
+
+  Logger::info("Time-series handler routes registered");
+}
+
+// =============================================================================
+// PUT /ts/create/{key}?retention=ms
+// =============================================================================
+HttpResponse TimeSeriesHandler::create(const HttpRequest &request,
+                                       const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  bool invalid = false;
+  const auto retention = retention_param(request, invalid);
+  if (key.empty() || invalid) {
+    return HttpResponse::bad_request().body(
+        "Usage: PUT /ts/create/{key}?retention=<ms, 0 = forever>");
+  }
+
+  const auto status =
+      store_.modify_as<TimeSeries>(key, true, [&](TimeSeries &series) {
+        series.set_retention_ms(retention.value_or(series.retention_ms()));
+        return true;
+      });
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /ts/add/{key} — body: "timestamp value" per line
+// =============================================================================
+// The whole body is parsed before anything is written, so a typo on line
+// 900 doesn't leave the first 899 samples half-applied. Samples already
+// outside the retention window are refused per line, like TS.MADD.
+// =============================================================================
+HttpResponse TimeSeriesHandler::add(const HttpRequest &request,
+                                    const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  bool invalid = false;
+  const auto retention = retention_param(request, invalid);
+  const auto lines = split_lines(request.body());
+  if (key.empty() || lines.empty() || invalid) {
+    return HttpResponse::bad_request().body(
+        "Usage: body = one \"timestamp value\" per line (timestamp * = now)");
+  }
+
+  std::vector<TimeSeries::Sample> samples;
+  samples.reserve(lines.size());
+  for (const auto &line : lines) {
+    const auto space = line.find(' ');
+    const auto timestamp =
+        space == std::string::npos ? std::nullopt
+                                   : parse_timestamp(line.substr(0, space));
+    const auto value = space == std::string::npos
+                           ? std::nullopt
+                           : parse_double(line.substr(space + 1));
+    if (!timestamp.has_value() || !value.has_value()) {
+      return HttpResponse::bad_request().body("Invalid sample: " + line);
+    }
+    samples.push_back(TimeSeries::Sample{*timestamp, *value});
+  }
+
+  std::vector<std::string> replies;
+  replies.reserve(samples.size());
+  const std::int64_t now = now_ms();
+  const auto status =
+      store_.modify_as<TimeSeries>(key, true, [&](TimeSeries &series) {
+        if (retention.has_value() && series.empty()) {
+          series.set_retention_ms(*retention);
+        }
+        const std::int64_t cutoff = series.retention_cutoff(now);
+        for (const auto &sample : samples) {
+          if (sample.timestamp < cutoff) {
+            replies.push_back("ERR timestamp is older than retention");
+            continue;
+          }
+          series.add(sample.timestamp, sample.value);
+          replies.push_back(std::to_string(sample.timestamp));
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(join_lines(replies));
+}
+
+// =============================================================================
+// GET /ts/range/{key}?from=&to=[&aggregation=&bucket=]
+// =============================================================================
+HttpResponse TimeSeriesHandler::range(const HttpRequest &request,
+                                      const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto from =
+      range_bound(request, "from", std::numeric_limits<std::int64_t>::min());
+  const auto to =
+      range_bound(request, "to", std::numeric_limits<std::int64_t>::max());
+
+  auto aggregation = TimeSeries::Aggregation::NONE;
+  std::int64_t bucket_ms = 0;
+  const auto aggregation_name = request.get_query_param("aggregation");
+  if (aggregation_name.has_value()) {
+    const auto parsed = parse_aggregation(*aggregation_name);
+    const auto bucket =
+        parse_integer(request.get_query_param("bucket").value_or(""));
+    if (!parsed.has_value() || !bucket.has_value() || *bucket <= 0) {
+      return HttpResponse::bad_request().body(
+          "Usage: aggregation=avg|sum|min|max|count|first|last&bucket=<ms>");
+    }
+    aggregation = *parsed;
+    bucket_ms = *bucket;
+  }
+  if (!from.has_value() || !to.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: from/to = <ms>, '-' (oldest) or '+' (newest)");
+  }
+
+  std::vector<std::string> lines;
+  const auto status =
+      store_.read_as<TimeSeries>(key, [&](const TimeSeries &series) {
+        const auto samples = series.range(*from, *to, aggregation, bucket_ms);
+        lines.reserve(samples.size());
+        for (const auto &sample : samples) {
+          lines.push_back(format_sample(sample));
+        }
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(join_lines(lines));
+}
+
+// =============================================================================
+// GET /ts/get/{key}
+// =============================================================================
+HttpResponse TimeSeriesHandler::get(const HttpRequest & /*request*/,
+                                    const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::optional<TimeSeries::Sample> newest;
+  const auto status = store_.read_as<TimeSeries>(
+      key, [&](const TimeSeries &series) { newest = series.last(); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body(newest ? format_sample(*newest) : "");
+}
+
+// =============================================================================
+// GET /ts/info/{key}
+// =============================================================================
+HttpResponse TimeSeriesHandler::info(const HttpRequest & /*request*/,
+                                     const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::string text;
+  const auto status =
+      store_.read_as<TimeSeries>(key, [&](const TimeSeries &series) {
+        text = "samples:" + std::to_string(series.size()) +
+               "\nchunks:" + std::to_string(series.chunk_count()) +
+               "\nmemory:" + std::to_string(series.memory_bytes()) +
+               "\nretention:" + std::to_string(series.retention_ms());
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body(text);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,51 @@
+// =============================================================================
+// timeseries_handler.hpp — Time-Series REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the compressed time-series value type (RedisTimeSeries-style).
+// Timestamps are Unix milliseconds; "*" means "now" when adding, and
+// "-" / "+" mean "oldest" / "newest" in a range.
+//
+//   PUT  /ts/create/{key}?retention=ms   create, or change retention
+//                                                      (TS.CREATE / TS.ALTER)
+//   POST /ts/add/{key}[?retention=ms]    body: "timestamp value" lines
+//                                        → one timestamp per line  (TS.MADD)
+//   GET  /ts/range/{key}?from=-&to=+[&aggregation=avg&bucket=60000]
+//                                        → "timestamp value" lines (TS.RANGE)
+//   GET  /ts/get/{key}                   → newest "timestamp value" (TS.GET)
+//   GET  /ts/info/{key}                  → samples, chunks, bytes   (TS.INFO)
+//
+// Aggregations: avg, sum, min, max, count, first, last.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class TimeSeriesHandler {
+public:
+  explicit TimeSeriesHandler(KeyValueStore &store);
+
+  // Register all /ts/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse create(const HttpRequest &request, const RouteParams &params);
+  HttpResponse add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse range(const HttpRequest &request,
+                     const RouteParams &params) const;
+  HttpResponse get(const HttpRequest &request, const RouteParams &params) const;
+  HttpResponse info(const HttpRequest &request,
+                    const RouteParams &params) const;
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
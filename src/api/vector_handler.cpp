@@ -0,0 +1,409 @@
+// =============================================================================
+// vector_handler.cpp — Vector Search REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/vector_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+#include <charconv> // std::from_chars — fast, locale-free number parsing
+#include <string_view>
+
+namespace mini_redis {
+
+namespace {
+
+// Upper bound for ?ef= / ?ef_construction= and ?k= (one request must not
+// be able to ask for a scan-sized candidate list)
+constexpr long long MAX_EF = 10'000;
+
+// "0.1,-2,3e-4" → {0.1, -2, 0.0003}; std::nullopt on any malformed number.
+// Called once per line of a bulk insert: a 1536-d vector is 1536 numbers,
+// so this avoids std::stod's string copies and exceptions.
+std::optional<std::vector<float>> parse_vector(std::string_view text) {
+  std::vector<float> vector;
+  while (true) {
+    while (!text.empty() && text.front() == ' ') {
+      text.remove_prefix(1);
+    }
+    float value = 0.0f;
+    const auto [end, error] =
+        std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc()) {
+      return std::nullopt;
+    }
+    vector.push_back(value);
+    text.remove_prefix(static_cast<std::size_t>(end - text.data()));
+    while (!text.empty() && text.front() == ' ') {
+      text.remove_prefix(1);
+    }
+    if (text.empty()) {
+      return vector;
+    }
+    if (text.front() != ',') {
+      return std::nullopt;
+    }
+    text.remove_prefix(1);
+  }
+}
+
+std::string format_vector(const std::vector<float> &vector) {
+  std::string out;
+  for (std::size_t i = 0; i < vector.size(); ++i) {
+    if (i > 0) {
+      out += ',';
+    }
+    out += format_double(vector[i]);
+  }
+  return out;
+}
+
+// ?name=<integer in [low, high]>, 'fallback' when absent; std::nullopt if
+// present but unparsable or out of range
+std::optional<long long> bounded_param(const HttpRequest &request,
+                                       const std::string &name,
+                                       long long fallback, long long low,
+                                       long long high) {
+  const auto text = request.get_query_param(name);
+  if (!text.has_value()) {
+    return fallback;
+  }
+  const auto value = parse_integer(*text);
+  if (!value.has_value() || *value < low || *value > high) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// The ?metric=, ?type= and ?index= choices; std::nullopt if any is unknown
+std::optional<VectorIndex::Options> parse_options(const HttpRequest &request) {
+  VectorIndex::Options options;
+
+  const std::string metric = request.get_query_param("metric").value_or("");
+  if (metric == "l2") {
+    options.metric = VectorIndex::Metric::L2;
+  } else if (!metric.empty() && metric != "cosine") {
+    return std::nullopt;
+  }
+
+  const std::string type = request.get_query_param("type").value_or("");
+  if (type == "int8") {
+    options.quantization = VectorIndex::Quantization::INT8;
+  } else if (!type.empty() && type != "float32") {
+    return std::nullopt;
+  }
+
+  const std::string index = request.get_query_param("index").value_or("");
+  if (index == "flat") {
+    options.algorithm = VectorIndex::Algorithm::FLAT;
+  } else if (index == "hnsw") {
+    options.algorithm = VectorIndex::Algorithm::HNSW;
+  } else if (!index.empty() && index != "auto") {
+    return std::nullopt;
+  }
+
+  const auto dim =
+      bounded_param(request, "dim", 0, 1, VectorIndex::MAX_DIM);
+  const auto m =
+      bounded_param(request, "m", options.m, 2, VectorIndex::MAX_M);
+  const auto ef_construction = bounded_param(
+      request, "ef_construction", options.ef_construction, 1, MAX_EF);
+  if (!dim.has_value() || !m.has_value() || !ef_construction.has_value()) {
+    return std::nullopt;
+  }
+  options.dim = static_cast<std::uint32_t>(*dim);
+  options.m = static_cast<std::uint32_t>(*m);
+  options.ef_construction = static_cast<std::uint32_t>(*ef_construction);
+  return options;
+}
+
+const char *metric_name(VectorIndex::Metric metric) {
+  return metric == VectorIndex::Metric::L2 ? "l2" : "cosine";
+}
+
+const char *quantization_name(VectorIndex::Quantization quantization) {
+  return quantization == VectorIndex::Quantization::INT8 ? "int8"
+                                                         : "float32";
+}
+
+const char *algorithm_name(VectorIndex::Algorithm algorithm) {
+  switch (algorithm) {
+  case VectorIndex::Algorithm::FLAT:
+    return "flat";
+  case VectorIndex::Algorithm::HNSW:
+    return "hnsw";
+  case VectorIndex::Algorithm::AUTO:
+    break;
+  }
+  return "auto";
+}
+
+HttpResponse key_exists_response(const std::string &key) {
+  return HttpResponse::conflict().body("ERR key '" + key +
+                                       "' already holds data");
+}
+
+} // anonymous namespace
+
+VectorHandler::VectorHandler(KeyValueStore &store) : store_(store) {}
+
+void VectorHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/vec/create/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return create(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/vec/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return add(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/vec/rem/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return remove(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/vec/knn/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return knn(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/vec/get/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return get(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/vec/info/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return info(req, params);
+                   });
+
+  Logger::info("Vector handler routes registered");
+}
+
+// =============================================================================
+// PUT /vec/create/{key}?dim=&metric=&type=&index=&m=&ef_construction=
+// =============================================================================
+// Like /bf/reserve: the options only apply to a NEW index, so creating over
+// an existing key is a 409 rather than a silent no-op. The dimension is
+// required here, which is also what tells a fresh index (dim 0) apart from
+// one that was created but has no vectors yet.
+// =============================================================================
+HttpResponse VectorHandler::create(const HttpRequest &request,
+                                   const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto options = parse_options(request);
+  if (key.empty() || !options.has_value() || options->dim == 0) {
+    return HttpResponse::bad_request().body(
+        "Usage: PUT /vec/create/{key}?dim=<n>[&metric=cosine|l2]"
+        "[&type=float32|int8][&index=auto|flat|hnsw]"
+        "[&m=<2..128>][&ef_construction=<n>]");
+  }
+
+  bool created = false;
+  const auto status =
+      store_.modify_as<VectorIndex>(key, true, [&](VectorIndex &index) {
+        if (index.empty() && index.dim() == 0) {
+          index = VectorIndex(*options);
+          created = true;
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!created) {
+    return key_exists_response(key);
+  }
+  return HttpResponse::ok().body("OK");
+}
+
+// =============================================================================
+// POST /vec/add/{key} — body: one "name v1,v2,..." per line
+// =============================================================================
+// All-or-nothing: every line is parsed and checked against the index
+// (dimension, finite values) before the first vector is inserted.
+// =============================================================================
+HttpResponse VectorHandler::add(const HttpRequest &request,
+                                const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto lines = split_lines(request.body());
+  if (key.empty() || lines.empty()) {
+    return HttpResponse::bad_request().body(
+        "Usage: body = one \"name v1,v2,...\" per line");
+  }
+
+  std::vector<std::pair<std::string, std::vector<float>>> items;
+  items.reserve(lines.size());
+  for (const auto &line : lines) {
+    const auto space = line.find(' ');
+    auto vector = space == std::string::npos || space == 0
+                      ? std::nullopt
+                      : parse_vector(std::string_view(line).substr(space + 1));
+    if (!vector.has_value() ||
+        (!items.empty() && vector->size() != items.front().second.size())) {
+      return HttpResponse::bad_request().body("Invalid vector: " + line);
+    }
+    items.emplace_back(line.substr(0, space), std::move(*vector));
+  }
+
+  std::size_t added = 0;
+  bool rejected = false;
+  const auto status =
+      store_.modify_as<VectorIndex>(key, true, [&](VectorIndex &index) {
+        for (const auto &item : items) {
+          if (!index.valid(item.second)) {
+            rejected = true;
+            return !index.empty(); // don't leave an empty auto-created key
+          }
+        }
+        for (const auto &item : items) {
+          added += index.add(item.first, item.second) ? 1 : 0;
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (rejected) {
+    return HttpResponse::bad_request().body(
+        "ERR vectors must match the index dimension and be finite "
+        "(and non-zero for cosine)");
+  }
+  return HttpResponse::ok().body(std::to_string(added));
+}
+
+// =============================================================================
+// POST /vec/rem/{key} — body: one name per line
+// =============================================================================
+HttpResponse VectorHandler::remove(const HttpRequest &request,
+                                   const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto names = split_lines(request.body());
+  if (key.empty() || names.empty()) {
+    return HttpResponse::bad_request().body("Usage: body = one name per line");
+  }
+
+  std::size_t removed = 0;
+  const auto status =
+      store_.modify_as<VectorIndex>(key, false, [&](VectorIndex &index) {
+        for (const auto &name : names) {
+          removed += index.remove(name) ? 1 : 0;
+        }
+        return !index.empty();
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(removed));
+}
+
+// =============================================================================
+// POST /vec/knn/{key}?k=10[&ef=][&exact=1] — body: the query vector
+// =============================================================================
+// Searches run under the shard's SHARED lock: any number of queries (even
+// on the same key) proceed in parallel; only writers wait.
+// =============================================================================
+HttpResponse VectorHandler::knn(const HttpRequest &request,
+                                const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto k = bounded_param(request, "k", 10, 1, MAX_EF);
+  const auto ef = bounded_param(request, "ef", 0, 1, MAX_EF);
+  const bool exact = request.get_query_param("exact").value_or("0") == "1";
+  std::string body = request.body();
+  while (!body.empty() && (body.back() == '\n' || body.back() == '\r')) {
+    body.pop_back();
+  }
+  const auto query = parse_vector(body);
+  if (key.empty() || !k.has_value() || !ef.has_value() ||
+      !query.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: POST /vec/knn/{key}?k=<n>[&ef=<n>][&exact=1], "
+        "body = v1,v2,...");
+  }
+
+  std::vector<std::string> lines;
+  bool rejected = false;
+  const auto status =
+      store_.read_as<VectorIndex>(key, [&](const VectorIndex &index) {
+        if (!index.valid(*query)) {
+          rejected = true;
+          return;
+        }
+        const auto matches =
+            exact ? index.knn_exact(*query, static_cast<std::size_t>(*k))
+                  : index.knn(*query, static_cast<std::size_t>(*k),
+                              static_cast<std::size_t>(*ef));
+        lines.reserve(matches.size());
+        for (const auto &match : matches) {
+          lines.push_back(match.name + " " + format_double(match.distance));
+        }
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (rejected) {
+    return HttpResponse::bad_request().body(
+        "ERR query must match the index dimension");
+  }
+  return HttpResponse::ok().body(join_lines(lines));
+}
+
+// =============================================================================
+// GET /vec/get/{key}?id=name
+// =============================================================================
+HttpResponse VectorHandler::get(const HttpRequest &request,
+                                const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto name = request.get_query_param("id");
+  if (key.empty() || !name.has_value()) {
+    return HttpResponse::bad_request().body(
+        "Usage: GET /vec/get/{key}?id=<name>");
+  }
+
+  std::optional<std::vector<float>> vector;
+  const auto status = store_.read_as<VectorIndex>(
+      key, [&](const VectorIndex &index) { vector = index.get(*name); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!vector.has_value()) {
+    return HttpResponse::not_found().body("Vector not found: " + *name);
+  }
+  return HttpResponse::ok().body(format_vector(*vector));
+}
+
+// =============================================================================
+// GET /vec/info/{key}
+// =============================================================================
+HttpResponse VectorHandler::info(const HttpRequest & /*request*/,
+                                 const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+
+  std::string text;
+  const auto status =
+      store_.read_as<VectorIndex>(key, [&](const VectorIndex &index) {
+        const auto &options = index.options();
+        text = "size:" + std::to_string(index.size()) +
+               "\ndim:" + std::to_string(index.dim()) +
+               "\nmetric:" + metric_name(options.metric) +
+               "\ntype:" + quantization_name(options.quantization) +
+               "\nindex:" + algorithm_name(options.algorithm) +
+               "\ngraph:" + (index.has_graph() ? "hnsw" : "none") +
+               "\nm:" + std::to_string(options.m) +
+               "\nef_construction:" +
+               std::to_string(options.ef_construction) +
+               "\ntombstones:" + std::to_string(index.tombstones()) +
+               "\nmemory:" + std::to_string(index.memory_bytes());
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (status == AccessStatus::NOT_FOUND) {
+    return HttpResponse::not_found().body("Key not found: " + key);
+  }
+  return HttpResponse::ok().body(text);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,53 @@
+// =============================================================================
+// vector_handler.hpp — Vector Search REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the nearest-neighbour vector index (in the spirit of RediSearch's
+// vector fields). A key holds one index of named, equal-length vectors;
+// vectors are written as comma-separated numbers: "0.12,-0.5,0.33,...".
+//
+//   PUT  /vec/create/{key}?dim=n[&metric=cosine|l2][&type=float32|int8]
+//        [&index=auto|flat|hnsw][&m=16][&ef_construction=200]
+//   POST /vec/add/{key}    body: one "name v1,v2,..." per line → added
+//                          (creates a default index, dim from the first line)
+//   POST /vec/rem/{key}    body: one name per line             → removed
+//   POST /vec/knn/{key}?k=10[&ef=n][&exact=1]
+//        body: the query vector   → "name distance" lines, closest first
+//   GET  /vec/get/{key}?id=name   → the stored vector
+//   GET  /vec/info/{key}          → size, dim, metric, graph, memory
+//
+// 'ef' trades speed for recall on the HNSW graph (bigger = more accurate);
+// exact=1 forces a brute-force scan, e.g. to measure that recall.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class VectorHandler {
+public:
+  explicit VectorHandler(KeyValueStore &store);
+
+  // Register all /vec/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse create(const HttpRequest &request, const RouteParams &params);
+  HttpResponse add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse remove(const HttpRequest &request, const RouteParams &params);
+  HttpResponse knn(const HttpRequest &request, const RouteParams &params) const;
+  HttpResponse get(const HttpRequest &request, const RouteParams &params) const;
+  HttpResponse info(const HttpRequest &request,
+                    const RouteParams &params) const;
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,252 @@
+// =============================================================================
+// zset_handler.cpp — Sorted Set REST Endpoints (IMPLEMENTATION)
+// =============================================================================
+
+#include "api/zset_handler.hpp"
+#include "api/handler_util.hpp"
+#include "util/logger.hpp"
+
+#include <sstream>
+
+namespace mini_redis {
+
+namespace {
+
+// Render a range result: "member" or "member score" per line
+std::string format_range(const std::vector<ScoredMember> &items,
+                         bool with_scores) {
+  std::ostringstream out;
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    out << items[i].member;
+    if (with_scores) {
+      out << ' ' << format_double(items[i].score);
+    }
+    if (i + 1 < items.size()) {
+      out << "\n";
+    }
+  }
+  return out.str();
+}
+
+} // anonymous namespace
+
+ZSetHandler::ZSetHandler(KeyValueStore &store) : store_(store) {}
+
+void ZSetHandler::register_routes(Router &router) {
+  router.add_route(HttpMethod::PUT, "/zset/add/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return add(req, params);
+                   });
+  router.add_route(HttpMethod::POST, "/zset/incrby/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return increment(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/zset/rank/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return rank(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/zset/range/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return range_by_rank(req, params);
+                   });
+  router.add_route(HttpMethod::GET, "/zset/rangebyscore/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return range_by_score(req, params);
+                   });
+  router.add_route(HttpMethod::DELETE, "/zset/rem/",
+                   [this](const HttpRequest &req, const RouteParams &params) {
+                     return remove(req, params);
+                   });
+
+  Logger::info("Sorted set handler routes registered");
+}
+
+// =============================================================================
+// PUT /zset/add/{key} — body: "score member" per line
+// =============================================================================
+// We parse and validate EVERY line before touching the store, so a bad line
+// rejects the whole request instead of leaving it half-applied.
+// =============================================================================
+HttpResponse ZSetHandler::add(const HttpRequest &request,
+                              const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  if (key.empty()) {
+    return HttpResponse::bad_request().body("Key cannot be empty");
+  }
+
+  std::vector<ScoredMember> items;
+  for (const auto &line : split_lines(request.body())) {
+    const auto space = line.find(' ');
+    if (space == std::string::npos || space + 1 == line.size()) {
+      return HttpResponse::bad_request().body("Expected 'score member': " +
+                                              line);
+    }
+    const auto score = parse_double(line.substr(0, space));
+    if (!score.has_value()) {
+      return HttpResponse::bad_request().body("Invalid score: " + line);
+    }
+    items.push_back(ScoredMember{line.substr(space + 1), score.value()});
+  }
+  if (items.empty()) {
+    return HttpResponse::bad_request().body("Body must list 'score member'");
+  }
+
+  std::size_t added = 0;
+  const auto status = store_.modify_as<SortedSet>(
+      key, true, [&items, &added](SortedSet &zset) {
+        for (const auto &item : items) {
+          if (zset.add(item.member, item.score)) {
+            ++added;
+          }
+        }
+        return true;
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(added));
+}
+
+// =============================================================================
+// POST /zset/incrby/{key}?member=m&by=delta
+// =============================================================================
+HttpResponse ZSetHandler::increment(const HttpRequest &request,
+                                    const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+  const auto member = request.get_query_param("member");
+  const auto by = request.get_query_param("by");
+  if (key.empty() || !member.has_value() || !by.has_value()) {
+    return HttpResponse::bad_request().body("Usage: /zset/incrby/{key}"
+                                            "?member=m&by=delta");
+  }
+
+  const auto delta = parse_double(by.value());
+  if (!delta.has_value()) {
+    return HttpResponse::bad_request().body("Invalid increment: " + by.value());
+  }
+
+  std::optional<double> new_score;
+  const auto status = store_.modify_as<SortedSet>(
+      key, true, [&](SortedSet &zset) {
+        new_score = zset.increment(member.value(), delta.value());
+        return !zset.empty(); // a NaN result may leave a fresh set empty
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!new_score.has_value()) {
+    return HttpResponse::bad_request().body("Resulting score is not a number");
+  }
+  return HttpResponse::ok().body(format_double(new_score.value()));
+}
+
+// =============================================================================
+// GET /zset/rank/{key}?member=m
+// =============================================================================
+HttpResponse ZSetHandler::rank(const HttpRequest &request,
+                               const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto member = request.get_query_param("member");
+  if (key.empty() || !member.has_value()) {
+    return HttpResponse::bad_request().body("Usage: /zset/rank/{key}?member=m");
+  }
+
+  std::optional<std::size_t> position;
+  const auto status = store_.read_as<SortedSet>(
+      key, [&](const SortedSet &zset) { position = zset.rank(member.value()); });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  if (!position.has_value()) {
+    return HttpResponse::not_found().body("Member not found: " +
+                                          member.value());
+  }
+  return HttpResponse::ok().body(std::to_string(position.value()));
+}
+
+// =============================================================================
+// GET /zset/range/{key}?start=0&stop=-1[&withscores]
+// =============================================================================
+HttpResponse ZSetHandler::range_by_rank(const HttpRequest &request,
+                                        const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto start = parse_integer(request.get_query_param("start").value_or("0"));
+  const auto stop = parse_integer(request.get_query_param("stop").value_or("-1"));
+  if (key.empty() || !start.has_value() || !stop.has_value()) {
+    return HttpResponse::bad_request().body("Usage: /zset/range/{key}"
+                                            "?start=0&stop=-1");
+  }
+
+  std::vector<ScoredMember> items;
+  const auto status = store_.read_as<SortedSet>(key, [&](const SortedSet &zset) {
+    items = zset.range_by_rank(start.value(), stop.value());
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  const bool with_scores = request.get_query_param("withscores").has_value();
+  return HttpResponse::ok().body(format_range(items, with_scores));
+}
+
+// =============================================================================
+// GET /zset/rangebyscore/{key}?min=...&max=...[&withscores]
+// =============================================================================
+HttpResponse ZSetHandler::range_by_score(const HttpRequest &request,
+                                         const RouteParams &params) const {
+  const std::string &key = params.path_suffix;
+  const auto min = parse_double(request.get_query_param("min").value_or("-inf"));
+  const auto max = parse_double(request.get_query_param("max").value_or("+inf"));
+  if (key.empty() || !min.has_value() || !max.has_value()) {
+    return HttpResponse::bad_request().body("Usage: /zset/rangebyscore/{key}"
+                                            "?min=a&max=b");
+  }
+
+  std::vector<ScoredMember> items;
+  const auto status = store_.read_as<SortedSet>(key, [&](const SortedSet &zset) {
+    items = zset.range_by_score(min.value(), max.value());
+  });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  const bool with_scores = request.get_query_param("withscores").has_value();
+  return HttpResponse::ok().body(format_range(items, with_scores));
+}
+
+// =============================================================================
+// DELETE /zset/rem/{key}?member=m  (or one member per body line)
+// =============================================================================
+HttpResponse ZSetHandler::remove(const HttpRequest &request,
+                                 const RouteParams &params) {
+  const std::string &key = params.path_suffix;
+
+  std::vector<std::string> members = split_lines(request.body());
+  if (const auto member = request.get_query_param("member")) {
+    members.push_back(member.value());
+  }
+  if (key.empty() || members.empty()) {
+    return HttpResponse::bad_request().body("Usage: /zset/rem/{key}?member=m");
+  }
+
+  std::size_t removed = 0;
+  const auto status = store_.modify_as<SortedSet>(
+      key, false, [&members, &removed](SortedSet &zset) {
+        for (const auto &member : members) {
+          if (zset.remove(member)) {
+            ++removed;
+          }
+        }
+        return !zset.empty(); // removing the last member deletes the key
+      });
+
+  if (status == AccessStatus::WRONG_TYPE) {
+    return wrong_type_response(key);
+  }
+  return HttpResponse::ok().body(std::to_string(removed));
+}
+
+} // namespace mini_redis
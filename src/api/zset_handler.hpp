@@ -0,0 +1,51 @@
+// =============================================================================
+// zset_handler.hpp — Sorted Set REST Endpoints (HEADER)
+// =============================================================================
+//
+// Exposes the SortedSet value type over HTTP. The command is part of the
+// path and the key is the path suffix, so each command is its own route:
+//
+//   PUT    /zset/add/{key}          body: "score member" per line  (ZADD)
+//   POST   /zset/incrby/{key}?member=m&by=1.5                      (ZINCRBY)
+//   GET    /zset/rank/{key}?member=m                               (ZRANK)
+//   GET    /zset/range/{key}?start=0&stop=-1[&withscores]          (ZRANGE)
+//   GET    /zset/rangebyscore/{key}?min=-inf&max=+inf[&withscores]
+//   DELETE /zset/rem/{key}?member=m   (or one member per body line) (ZREM)
+//
+// Range responses are one member per line ("member score" with withscores).
+// A key holding some other type answers 409 Conflict (WRONGTYPE).
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "http/http_request.hpp"
+#include "http/http_response.hpp"
+#include "http/router.hpp"
+
+namespace mini_redis {
+
+class ZSetHandler {
+public:
+  explicit ZSetHandler(KeyValueStore &store);
+
+  // Register all /zset/... routes with the given router
+  void register_routes(Router &router);
+
+  // ---- Endpoint handlers ----
+  HttpResponse add(const HttpRequest &request, const RouteParams &params);
+  HttpResponse increment(const HttpRequest &request, const RouteParams &params);
+  HttpResponse rank(const HttpRequest &request,
+                    const RouteParams &params) const;
+  HttpResponse range_by_rank(const HttpRequest &request,
+                             const RouteParams &params) const;
+  HttpResponse range_by_score(const HttpRequest &request,
+                              const RouteParams &params) const;
+  HttpResponse remove(const HttpRequest &request, const RouteParams &params);
+
+private:
+  // Reference to the key-value store (NOT owned by this class)
+  KeyValueStore &store_;
+};
+
+} // namespace mini_redis
@@ -3,11 +3,77 @@
 // =============================================================================
 
 #include "app/application.hpp"
+#include "core/snapshot.hpp"
 #include "network/tcp_server.hpp"
+#include "util/allocator.hpp"
 #include "util/logger.hpp"
 
+#include <algorithm> // std::min
+#include <chrono>
+#include <cstdint>
+#include <memory> // std::make_shared
+#include <string>
+#include <string_view>
+#include <utility> // std::move
+
 namespace mini_redis {
 
+namespace {
+
+// Where the head ends: just past the blank line after the headers —
+// "\r\n\r\n", or the bare "\n\n" HttpRequest::parse() accepts too.
+// std::string::npos while it hasn't all arrived.
+std::size_t head_end(const std::string &raw) {
+  const std::size_t crlf = raw.find("\r\n\r\n");
+  const std::size_t lf = raw.find("\n\n");
+  std::size_t end = std::string::npos;
+  if (crlf != std::string::npos) {
+    end = crlf + 4;
+  }
+  if (lf != std::string::npos) {
+    end = std::min(end, lf + 2);
+  }
+  return end;
+}
+
+void send_bad_request(Socket &client_socket, const std::string &why) {
+  client_socket.write_all(HttpResponse::bad_request().body(why).build());
+}
+
+// ---- rate_limit_client() — Whose bucket a request draws from ----
+// Prefixed by kind, so an API key can't share a bucket with an address
+// that happens to spell the same. Requests without an API key, or
+// outside any namespace, are limited by address.
+std::string rate_limit_client(const HttpRequest &request,
+                              const Socket &client_socket, RateLimitKey by) {
+  if (by == RateLimitKey::API_KEY) {
+    if (const auto key = request.get_header("x-api-key")) {
+      return "key:" + *key;
+    }
+  } else if (by == RateLimitKey::NAMESPACE) {
+    const std::string &path = request.path();
+    if (path.compare(0, 4, "/ns/") == 0) {
+      const std::size_t end = std::min(path.find('/', 4), path.size());
+      return "ns:" + path.substr(4, end - 4);
+    }
+  }
+  return "ip:" + client_socket.peer_address();
+}
+
+// Retry-After is in whole seconds: round up, so the client doesn't come
+// back a moment too early
+void send_too_many_requests(Socket &client_socket,
+                            std::uint64_t retry_after_ms) {
+  const std::uint64_t seconds = (retry_after_ms + 999) / 1000;
+  client_socket.write_all(
+      HttpResponse::too_many_requests()
+          .header("Retry-After", std::to_string(seconds == 0 ? 1 : seconds))
+          .body("ERR rate limit exceeded")
+          .build());
+}
+
+} // anonymous namespace
+
 // =============================================================================
 // Constructor — Initialize all components
 // =============================================================================
@@ -20,11 +86,26 @@ namespace mini_redis {
 // the reference would be to an uninitialized store_ → crash!
 // Modern compilers warn about this with -Wall.
 // =============================================================================
-Application::Application(int port, std::size_t thread_count)
-    : port_(port), thread_count_(thread_count), store_(),
+Application::Application(Config config, ConfigSources sources)
+    : config_(config, std::move(sources),
+              [this](const Config &live) { apply_live_settings(live); }),
+      port_(config.port), thread_count_(config.threads),
+      snapshot_path_(config.snapshot_path), store_(),
       expiry_manager_(store_) // Pass store_ by reference
       ,
-      router_(), kv_handler_(store_) { // Pass store_ by reference
+      defragmenter_(store_), router_(), namespaces_(), rate_limiter_(),
+      waiters_(),
+      kv_handler_(store_), // Pass store_ by reference
+      zset_handler_(store_), set_handler_(store_),
+      hll_handler_(store_), sketch_handler_(store_), bitmap_handler_(store_),
+      timeseries_handler_(store_), stream_handler_(store_, waiters_),
+      vector_handler_(store_), json_handler_(store_),
+      list_handler_(store_, waiters_),
+      admin_handler_(store_, defragmenter_, rate_limiter_, config_,
+                     snapshot_path_),
+      bulk_handler_(store_), namespace_handler_(namespaces_) {
+  apply_live_settings(config);
+
   // Setup routes in constructor body (after all members are initialized)
   setup_routes();
 }
@@ -36,14 +117,70 @@ Application::Application(int port, std::size_t thread_count)
 // So kv_handler_ is destroyed first, then router_, then expiry_manager_,
 // then store_. This is correct: the expiry manager is stopped before
 // the store it references is destroyed.
+//
+// The final snapshot is written HERE, once every thread that could still
+// be writing to the store has stopped.
 // =============================================================================
-Application::~Application() { stop(); }
+Application::~Application() {
+  stop();
+  if (config_.current().save_on_shutdown) {
+    save_snapshot(store_, snapshot_path_);
+  }
+}
+
+// =============================================================================
+// Configuration
+// =============================================================================
+// Every live setting is a value its component reads on each use (an
+// atomic, or a setter that takes effect on the next cycle), so applying
+// them needs no pause in serving. save_on_shutdown is read from config_
+// by the destructor itself. A reload applies every live setting, so knobs
+// changed since through /admin/memory/... go back to their configured
+// values.
+// =============================================================================
+void Application::apply_live_settings(const Config &config) {
+  Logger::set_min_level(config.log_level);
+  Socket::set_read_buffer_bytes(config.read_buffer_bytes);
+  expiry_manager_.set_interval(
+      std::chrono::milliseconds(config.expiry_interval_ms));
+  // Only on a change: with jemalloc, "0" is an instruction (purge at
+  // once), not the absence of one
+  if (config.memory_decay_ms != Allocator::stats().decay_ms) {
+    Allocator::set_decay_ms(config.memory_decay_ms);
+  }
+  // The same store settings for the default store and every namespace
+  const auto configure_store = [dedup = config.dedup_min_bytes,
+                                 compress = config.compress_min_bytes,
+                                 inline_read = config.inline_read_bytes](
+                                    KeyValueStore &store) {
+    store.set_dedup_min_bytes(dedup);
+    store.set_compression_min_bytes(compress);
+    store.set_inline_read_max_bytes(inline_read);
+  };
+  configure_store(store_);
+  namespaces_.configure(configure_store);
+  rate_limiter_.configure(config.rate_limit_rps, config.rate_limit_burst);
+  rate_limit_by_.store(config.rate_limit_by, std::memory_order_relaxed);
+}
 
 // =============================================================================
 // setup_routes() — Register all API endpoints
 // =============================================================================
 void Application::setup_routes() {
   kv_handler_.register_routes(router_);
+  zset_handler_.register_routes(router_);
+  set_handler_.register_routes(router_);
+  hll_handler_.register_routes(router_);
+  sketch_handler_.register_routes(router_);
+  bitmap_handler_.register_routes(router_);
+  timeseries_handler_.register_routes(router_);
+  stream_handler_.register_routes(router_);
+  vector_handler_.register_routes(router_);
+  json_handler_.register_routes(router_);
+  list_handler_.register_routes(router_);
+  admin_handler_.register_routes(router_);
+  bulk_handler_.register_routes(router_);
+  namespace_handler_.register_routes(router_);
   Logger::info("All routes configured");
 }
 
@@ -53,12 +190,37 @@ void Application::setup_routes() {
 void Application::run() {
   Logger::info("=== Mini Redis v1.0 ===");
 
+  // Restore the previous run's data (a missing file just means "empty")
+  load_snapshot(store_, snapshot_path_);
+
+  // A cache in front of a system of record: misses read through to it,
+  // writes are sent to it in the background (see backing_store.hpp).
+  // Attached after the snapshot, whose entries are the cache's own copy:
+  // restoring them isn't a write to send.
+  const Config config = config_.current();
+  if (!config.backing_dir.empty()) {
+    store_.set_backing_store(
+        std::make_shared<FileBackingStore>(config.backing_dir),
+        WriteBehindOptions{config.write_behind_batch,
+                           std::chrono::milliseconds(config.write_behind_ms)});
+    Logger::info("Backing store: " + config.backing_dir);
+  }
+
   // Start the background expiry manager
   expiry_manager_.start();
+  defragmenter_.start();
 
   // Create and start the TCP server
   // This will BLOCK in the accept loop until stop() is called
   TcpServer server(port_, thread_count_);
+  {
+    // A stop() that came first finds no server: stop it here instead
+    std::lock_guard<std::mutex> lock(server_mutex_);
+    server_ = &server;
+    if (stop_requested_.load()) {
+      server.stop();
+    }
+  }
 
   // Pass our connection handler as a lambda.
   // [this] captures the Application pointer so the lambda can call
@@ -66,6 +228,9 @@ void Application::run() {
   server.start([this](Socket client_socket) {
     handle_connection(std::move(client_socket));
   });
+
+  std::lock_guard<std::mutex> lock(server_mutex_);
+  server_ = nullptr;
 }
 
 // =============================================================================
@@ -80,7 +245,15 @@ void Application::stop() {
   }
 
   Logger::info("Shutting down gracefully...");
+  {
+    std::lock_guard<std::mutex> lock(server_mutex_);
+    if (server_ != nullptr) {
+      server_->stop();
+    }
+  }
   expiry_manager_.stop();
+  defragmenter_.stop();
+  waiters_.stop();
 }
 
 // =============================================================================
@@ -94,33 +267,137 @@ void Application::stop() {
 //   4. Send the HttpResponse back
 // =============================================================================
 void Application::handle_connection(Socket client_socket) {
-  // Step 1: Read raw data from the client
-  const std::string raw_request = client_socket.read_all();
-
-  if (raw_request.empty()) {
-    // Client disconnected or error — nothing to do
-    return;
-  }
-
-  // Step 2: Parse the raw HTTP text into a structured request
-  const auto request = HttpRequest::parse(raw_request);
-
+  // Steps 1 and 2: Read and parse the request (read_request() has
+  // already answered a bad one, and there's no one to answer if the
+  // client disconnected)
+  const auto request = read_request(client_socket);
   if (!request.has_value()) {
-    // Couldn't parse the request — send 400 Bad Request
-    const std::string response =
-        HttpResponse::bad_request().body("Invalid HTTP request").build();
-    client_socket.write_all(response);
     return;
   }
 
   // Step 3: Route the request to the correct handler
   const HttpResponse response = router_.route(request.value());
 
-  // Step 4: Send the response back to the client
+  // A blocking command (BLPOP...) had nothing to return yet: hand the
+  // socket over to the parked connection and free this worker thread.
+  // Whoever completes the wait (a push or the timeout) sends the reply.
+  if (response.parked_connection()) {
+    response.parked_connection()->attach(std::move(client_socket));
+    return;
+  }
+
+  // Step 4: Send the response back to the client — for a streamed body
+  // (bulk export), the headers first and then the body piece by piece
   client_socket.write_all(response.build());
+  if (response.body_writer()) {
+    response.write_streamed_body([&client_socket](std::string_view bytes) {
+      return client_socket.write_all(bytes);
+    });
+  }
 
   // When this function returns, 'client_socket' goes out of scope
   // and its destructor closes the connection. RAII at work!
 }
 
+// =============================================================================
+// read_request() — Head first, then the body
+// =============================================================================
+// One recv() usually holds a whole small request, but nothing guarantees
+// it: a long header block or any sizeable body arrives over several, so
+// we keep reading until the head is complete and Content-Length bytes of
+// body have followed it. A client that leaves before then is dropped,
+// not routed: a short body is never mistaken for the whole one.
+// =============================================================================
+std::optional<HttpRequest> Application::read_request(Socket &client_socket) {
+  std::string raw_request = client_socket.read_all();
+  std::size_t head_size = head_end(raw_request);
+  while (head_size == std::string::npos && !raw_request.empty() &&
+         raw_request.size() < MAX_HEAD_BYTES) {
+    const std::string more = client_socket.read_all();
+    if (more.empty()) {
+      break; // the client stopped sending: parse what we have
+    }
+    raw_request += more;
+    head_size = head_end(raw_request);
+  }
+
+  if (raw_request.empty()) {
+    return std::nullopt; // Client disconnected or error — nothing to do
+  }
+  if (head_size == std::string::npos) {
+    if (raw_request.size() >= MAX_HEAD_BYTES) {
+      send_bad_request(client_socket, "Request head too large");
+      return std::nullopt;
+    }
+    head_size = raw_request.size();
+  }
+
+  auto request = HttpRequest::parse(raw_request);
+  if (!request.has_value()) {
+    // Couldn't parse the request — send 400 Bad Request
+    send_bad_request(client_socket, "Invalid HTTP request");
+    return std::nullopt;
+  }
+
+  // Over its limit: answered before routing, and before any body is read
+  // (or a 100 Continue invites one), so a flood costs one parse each
+  if (rate_limiter_.enabled()) {
+    const auto decision = rate_limiter_.acquire(rate_limit_client(
+        *request, client_socket,
+        rate_limit_by_.load(std::memory_order_relaxed)));
+    if (!decision.allowed) {
+      send_too_many_requests(client_socket, decision.retry_after_ms);
+      return std::nullopt;
+    }
+  }
+
+  const std::size_t length = request->content_length().value_or(0);
+  const std::size_t received = raw_request.size() - head_size;
+  if (received >= length) {
+    return request; // the whole body came with the head
+  }
+
+  // A client that asked first ("Expect: 100-continue", as curl does for
+  // large uploads) waits for this before sending the body
+  if (request->get_header("expect") == "100-continue") {
+    client_socket.write_all("HTTP/1.1 100 Continue\r\n\r\n");
+  }
+
+  // A streaming route reads the rest itself, as it goes. The socket
+  // outlives the request: both live until handle_connection() returns.
+  if (router_.streams_body(*request)) {
+    request->set_body_source(
+        [&client_socket, left = length - received]() mutable {
+          if (left == 0) {
+            return std::string();
+          }
+          std::string piece =
+              client_socket.read_some(std::min(left, STREAM_READ_BYTES));
+          left -= piece.size();
+          return piece;
+        });
+    return request;
+  }
+
+  if (length > MAX_BODY_BYTES) {
+    send_bad_request(client_socket, "Request body too large");
+    return std::nullopt;
+  }
+  raw_request.reserve(head_size + length);
+  while (raw_request.size() < head_size + length) {
+    const std::string more = client_socket.read_some(
+        std::min(head_size + length - raw_request.size(), STREAM_READ_BYTES));
+    if (more.empty()) {
+      // The client gave up mid-body. What arrived is not the request it
+      // meant: routed, a truncated PUT would be stored as the value.
+      Logger::warning("Client disconnected after " +
+                      std::to_string(raw_request.size() - head_size) +
+                      " of " + std::to_string(length) + " body bytes");
+      return std::nullopt;
+    }
+    raw_request += more;
+  }
+  return HttpRequest::parse(raw_request);
+}
+
 } // namespace mini_redis
@@ -4,7 +4,7 @@
 //
 // This is the TOP-LEVEL class that ties everything together:
 //   1. Creates the KeyValueStore
-//   2. Creates the ExpiryManager (background cleanup)
+//   2. Creates the ExpiryManager (background cleanup) and Defragmenter
 //   3. Creates the Router and registers endpoints
 //   4. Creates the TcpServer and starts listening
 //
@@ -31,25 +31,50 @@
 
 #pragma once
 
+#include "api/admin_handler.hpp"
+#include "api/bitmap_handler.hpp"
+#include "api/bulk_handler.hpp"
+#include "api/timeseries_handler.hpp"
+#include "api/stream_handler.hpp"
+#include "api/vector_handler.hpp"
+#include "api/json_handler.hpp"
+#include "api/key_waiters.hpp"
 #include "api/kv_handler.hpp"
+#include "api/list_handler.hpp"
+#include "api/namespace_handler.hpp"
+#include "api/hll_handler.hpp"
+#include "api/set_handler.hpp"
+#include "api/sketch_handler.hpp"
+#include "api/zset_handler.hpp"
+#include "app/config.hpp"
+#include "core/defragmenter.hpp"
 #include "core/expiry_manager.hpp"
 #include "core/key_value_store.hpp"
+#include "core/namespaces.hpp"
 #include "http/router.hpp"
 #include "network/socket.hpp"
+#include "util/rate_limiter.hpp"
 
 #include <atomic>
+#include <cstddef>
 #include <memory> // std::unique_ptr — exclusive-ownership smart pointer
+#include <mutex>
+#include <optional>
+#include <string>
 
 namespace mini_redis {
 
+class TcpServer;
+
 class Application {
 public:
   // Constructor — configures the application
-  // port: TCP port to listen on (default 8080)
-  // thread_count: number of worker threads (default 4)
-  Application(int port = 8080, std::size_t thread_count = 4);
+  // config: every setting (see config.hpp); the startup ones — port,
+  //         threads, snapshot path — are fixed from here on
+  // sources: where 'config' was read from, re-read on every reload
+  explicit Application(Config config = {}, ConfigSources sources = {});
 
-  // Destructor — stops everything
+  // Destructor — stops everything and saves a final snapshot
   ~Application();
 
   // Non-copyable, non-movable
@@ -61,25 +86,70 @@ public:
   // Start the application (blocks until stopped)
   void run();
 
-  // Stop the application (can be called from a signal handler)
+  // Stop the application: run() returns once its server has stopped.
+  // Locks and joins threads, so NOT from a signal handler (main.cpp
+  // calls it from its signal thread).
   void stop();
 
+  // The store, for startup settings made before run() (see main.cpp)
+  KeyValueStore &store() { return store_; }
+
+  // The settings, and reloading them (SIGHUP in main.cpp, and
+  // POST /admin/config/reload)
+  RuntimeConfig &config() { return config_; }
+
 private:
   // ---- Setup helpers ----
   void setup_routes();
   void handle_connection(Socket client_socket);
 
+  // ---- Reading one request ----
+  // The head (request line + headers), then the body: all of it, or — for
+  // a streaming route — a BodySource the handler reads it through.
+  // std::nullopt when there is nothing to route: the client left, or has
+  // already been sent a 400 (garbled, or over the limits below) or a 429
+  // (over its rate limit).
+  std::optional<HttpRequest> read_request(Socket &client_socket);
+
+  // A head that never ends, or a buffered body larger than this, is
+  // refused rather than read into memory. Streaming routes have no body
+  // limit; they read STREAM_READ_BYTES at a time.
+  static constexpr std::size_t MAX_HEAD_BYTES = 64 * 1024;
+  static constexpr std::size_t MAX_BODY_BYTES = 256 * 1024 * 1024;
+  static constexpr std::size_t STREAM_READ_BYTES = 256 * 1024;
+
+  // Push the live settings into the components (at startup and on reload)
+  void apply_live_settings(const Config &config);
+
   // ---- Configuration ----
+  // Declared first: admin_handler_ reads it, and it calls back into the
+  // components only on reload, once they all exist
+  RuntimeConfig config_;
   int port_;
   std::size_t thread_count_;
+  std::string snapshot_path_;
 
   // ---- Components ----
   // The store and expiry manager are owned directly (not via pointer)
   // because they have a fixed, known lifetime = the Application's lifetime.
   KeyValueStore store_;
   ExpiryManager expiry_manager_;
+  Defragmenter defragmenter_;
   Router router_;
 
+  // The named namespaces (/ns/<name>/...), each a store of its own;
+  // store_ above is the default one, behind the plain /kv/... routes
+  NamespaceRegistry namespaces_;
+
+  // Per-client request limits, checked in read_request() before routing;
+  // both set from the live rate_limit_* settings
+  RateLimiter rate_limiter_;
+  std::atomic<RateLimitKey> rate_limit_by_{RateLimitKey::IP};
+
+  // Clients parked by blocking commands (BLPOP, XREAD...). Declared BEFORE the
+  // handlers that reference it, for the same reason as store_.
+  KeyWaiters waiters_;
+
   // The KV handler needs the store reference, which is why it's
   // constructed AFTER store_ in the initializer list.
   // IMPORTANT: member variables are initialized in the ORDER THEY ARE
@@ -87,9 +157,26 @@ private:
   // So store_ must be declared BEFORE kv_handler_ for the reference to be
   // valid.
   KvHandler kv_handler_;
+  ZSetHandler zset_handler_;
+  SetHandler set_handler_;
+  HllHandler hll_handler_;
+  SketchHandler sketch_handler_;
+  BitmapHandler bitmap_handler_;
+  TimeSeriesHandler timeseries_handler_;
+  StreamHandler stream_handler_;
+  VectorHandler vector_handler_;
+  JsonHandler json_handler_;
+  ListHandler list_handler_;
+  AdminHandler admin_handler_;
+  BulkHandler bulk_handler_;
+  NamespaceHandler namespace_handler_;
 
   // Stop flag for the application
   std::atomic<bool> stop_requested_{false};
+
+  // The server run() is running, for stop(); nullptr outside run()
+  std::mutex server_mutex_;
+  TcpServer *server_ = nullptr;
 };
 
 } // namespace mini_redis
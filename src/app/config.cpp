@@ -0,0 +1,413 @@
+// =============================================================================
+// config.cpp — Server Settings: Defaults, File, Environment, Flags
+// =============================================================================
+
+#include "app/config.hpp"
+
+#include <cctype>
+#include <charconv> // std::from_chars — strict number parsing
+#include <cstdint>  // UINT64_MAX
+#include <cstdlib>  // std::getenv
+#include <fstream>
+#include <type_traits>
+
+namespace mini_redis {
+
+namespace {
+
+// =============================================================================
+// The settings table
+// =============================================================================
+// One row per setting: how to parse it into a Config and how to print it
+// back. Everything else — file, environment, flags, reload, the admin
+// listing — walks this table, so a new knob is one new row.
+// =============================================================================
+struct Setting {
+  const char *name;
+  bool live;
+  bool (*parse)(Config &config, std::string_view value); // false = bad value
+  std::string (*show)(const Config &config);
+};
+
+std::string_view trim(std::string_view text) {
+  while (!text.empty() && std::isspace(static_cast<unsigned char>(text[0]))) {
+    text.remove_prefix(1);
+  }
+  while (!text.empty() &&
+         std::isspace(static_cast<unsigned char>(text.back()))) {
+    text.remove_suffix(1);
+  }
+  return text;
+}
+
+std::string lowercase(std::string_view text) {
+  std::string result(text);
+  for (char &c : result) {
+    c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+  }
+  return result;
+}
+
+// ---- Numbers: the whole text, decimal, within [MIN, MAX] ----
+template <auto Field, std::uint64_t MIN = 0, std::uint64_t MAX = UINT64_MAX>
+bool parse_number(Config &config, std::string_view value) {
+  std::uint64_t number = 0;
+  const char *end = value.data() + value.size();
+  const auto [ptr, ec] = std::from_chars(value.data(), end, number);
+  if (value.empty() || ec != std::errc() || ptr != end || number < MIN ||
+      number > MAX) {
+    return false;
+  }
+  using T = std::decay_t<decltype(config.*Field)>;
+  config.*Field = static_cast<T>(number);
+  return true;
+}
+
+template <auto Field> std::string show_number(const Config &config) {
+  return std::to_string(config.*Field);
+}
+
+template <auto Field> bool parse_flag(Config &config, std::string_view value) {
+  const std::string text = lowercase(value);
+  if (text == "true" || text == "yes" || text == "on" || text == "1") {
+    config.*Field = true;
+  } else if (text == "false" || text == "no" || text == "off" ||
+             text == "0") {
+    config.*Field = false;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+template <auto Field> std::string show_flag(const Config &config) {
+  return config.*Field ? "true" : "false";
+}
+
+bool parse_log_level(Config &config, std::string_view value) {
+  const std::string text = lowercase(value);
+  if (text == "info") {
+    config.log_level = LogLevel::INFO;
+  } else if (text == "warning") {
+    config.log_level = LogLevel::WARNING;
+  } else if (text == "error") {
+    config.log_level = LogLevel::ERROR;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+std::string show_log_level(const Config &config) {
+  switch (config.log_level) {
+  case LogLevel::INFO:
+    return "info";
+  case LogLevel::WARNING:
+    return "warning";
+  case LogLevel::ERROR:
+    return "error";
+  }
+  return "info";
+}
+
+bool parse_rate_limit_by(Config &config, std::string_view value) {
+  const auto key = parse_rate_limit_key(lowercase(value));
+  if (!key.has_value()) {
+    return false;
+  }
+  config.rate_limit_by = *key;
+  return true;
+}
+
+std::string show_rate_limit_by(const Config &config) {
+  return rate_limit_key_name(config.rate_limit_by);
+}
+
+bool parse_snapshot_path(Config &config, std::string_view value) {
+  if (value.empty()) {
+    return false;
+  }
+  config.snapshot_path = std::string(value);
+  return true;
+}
+
+std::string show_snapshot_path(const Config &config) {
+  return config.snapshot_path;
+}
+
+bool parse_backing_dir(Config &config, std::string_view value) {
+  config.backing_dir = std::string(value);
+  return true;
+}
+
+std::string show_backing_dir(const Config &config) {
+  return config.backing_dir;
+}
+
+const Setting SETTINGS[] = {
+    {"port", false, parse_number<&Config::port, 1, 65535>,
+     show_number<&Config::port>},
+    {"threads", false, parse_number<&Config::threads, 1, 1024>,
+     show_number<&Config::threads>},
+    {"snapshot_path", false, parse_snapshot_path, show_snapshot_path},
+    {"huge_pages_mb", false, parse_number<&Config::huge_pages_mb>,
+     show_number<&Config::huge_pages_mb>},
+    {"backing_dir", false, parse_backing_dir, show_backing_dir},
+    {"write_behind_batch", false,
+     parse_number<&Config::write_behind_batch, 1, 1 << 20>,
+     show_number<&Config::write_behind_batch>},
+    {"write_behind_ms", false,
+     parse_number<&Config::write_behind_ms, 1, 3'600'000>,
+     show_number<&Config::write_behind_ms>},
+    {"log_level", true, parse_log_level, show_log_level},
+    {"read_buffer_bytes", true,
+     parse_number<&Config::read_buffer_bytes, 512, 64 << 20>,
+     show_number<&Config::read_buffer_bytes>},
+    {"expiry_interval_ms", true,
+     parse_number<&Config::expiry_interval_ms, 10, 3'600'000>,
+     show_number<&Config::expiry_interval_ms>},
+    {"memory_decay_ms", true, parse_number<&Config::memory_decay_ms>,
+     show_number<&Config::memory_decay_ms>},
+    {"dedup_min_bytes", true, parse_number<&Config::dedup_min_bytes>,
+     show_number<&Config::dedup_min_bytes>},
+    {"compress_min_bytes", true, parse_number<&Config::compress_min_bytes>,
+     show_number<&Config::compress_min_bytes>},
+    {"inline_read_bytes", true, parse_number<&Config::inline_read_bytes>,
+     show_number<&Config::inline_read_bytes>},
+    {"save_on_shutdown", true, parse_flag<&Config::save_on_shutdown>,
+     show_flag<&Config::save_on_shutdown>},
+    {"rate_limit_rps", true,
+     parse_number<&Config::rate_limit_rps, 0, UINT32_MAX>,
+     show_number<&Config::rate_limit_rps>},
+    {"rate_limit_burst", true,
+     parse_number<&Config::rate_limit_burst, 0, RateLimiter::MAX_BURST>,
+     show_number<&Config::rate_limit_burst>},
+    {"rate_limit_by", true, parse_rate_limit_by, show_rate_limit_by},
+};
+
+const Setting *find_setting(std::string_view name) {
+  for (const Setting &setting : SETTINGS) {
+    if (name == setting.name) {
+      return &setting;
+    }
+  }
+  return nullptr;
+}
+
+// "--log-level" and "--log_level" both name log_level
+std::string flag_to_name(std::string_view flag) {
+  std::string name(flag);
+  for (char &c : name) {
+    if (c == '-') {
+      c = '_';
+    }
+  }
+  return name;
+}
+
+// ---- Layer 2: "name = value" lines ----
+bool apply_file(Config &config, const std::string &path, std::string &error) {
+  std::ifstream file(path);
+  if (!file) {
+    error = path + ": cannot read the config file";
+    return false;
+  }
+  std::string line;
+  for (int number = 1; std::getline(file, line); ++number) {
+    const std::string_view text = trim(line);
+    if (text.empty() || text[0] == '#') {
+      continue;
+    }
+    const std::size_t equals = text.find('=');
+    if (equals == std::string_view::npos) {
+      error = path + ":" + std::to_string(number) + ": expected name = value";
+      return false;
+    }
+    std::string why;
+    if (!set_config_value(config, trim(text.substr(0, equals)),
+                          trim(text.substr(equals + 1)), why)) {
+      error = path + ":" + std::to_string(number) + ": " + why;
+      return false;
+    }
+  }
+  return true;
+}
+
+// ---- Layer 3: MINI_REDIS_<NAME> ----
+bool apply_environment(Config &config, std::string &error) {
+  for (const Setting &setting : SETTINGS) {
+    std::string variable = "MINI_REDIS_";
+    for (const char *c = setting.name; *c != '\0'; ++c) {
+      variable += static_cast<char>(
+          std::toupper(static_cast<unsigned char>(*c)));
+    }
+    const char *value = std::getenv(variable.c_str());
+    if (value == nullptr) {
+      continue;
+    }
+    std::string why;
+    if (!set_config_value(config, setting.name, value, why)) {
+      error = variable + ": " + why;
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// One setting by name
+// =============================================================================
+bool set_config_value(Config &config, std::string_view name,
+                      std::string_view value, std::string &error) {
+  const Setting *setting = find_setting(name);
+  if (setting == nullptr) {
+    error = "unknown setting '" + std::string(name) + "'";
+    return false;
+  }
+  Config updated = config;
+  if (!setting->parse(updated, value)) {
+    error = "bad value '" + std::string(value) + "' for " + setting->name;
+    return false;
+  }
+  config = std::move(updated);
+  return true;
+}
+
+bool is_config_setting(std::string_view name) {
+  return find_setting(name) != nullptr;
+}
+
+bool is_live_setting(std::string_view name) {
+  const Setting *setting = find_setting(name);
+  return setting != nullptr && setting->live;
+}
+
+std::string format_config(const Config &config) {
+  std::string text;
+  for (const Setting &setting : SETTINGS) {
+    if (!text.empty()) {
+      text += '\n';
+    }
+    text += setting.name;
+    text += ' ';
+    text += setting.show(config);
+  }
+  return text;
+}
+
+// =============================================================================
+// parse_command_line()
+// =============================================================================
+std::optional<ConfigSources> parse_command_line(int argc, char **argv,
+                                                std::string &error) {
+  ConfigSources sources;
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (arg.substr(0, 2) != "--" || arg.size() == 2) {
+      error = "unexpected argument '" + std::string(arg) + "'";
+      return std::nullopt;
+    }
+    std::string_view flag = arg.substr(2);
+    std::string value;
+    const std::size_t equals = flag.find('=');
+    if (equals != std::string_view::npos) {
+      value = std::string(flag.substr(equals + 1));
+      flag = flag.substr(0, equals);
+    } else if (i + 1 < argc) {
+      value = argv[++i];
+    } else {
+      error = "--" + std::string(flag) + " needs a value";
+      return std::nullopt;
+    }
+
+    const std::string name = flag_to_name(flag);
+    if (name == "config") {
+      sources.file = value;
+    } else if (is_config_setting(name)) {
+      sources.flags.emplace_back(name, std::move(value));
+    } else {
+      error = "unknown flag --" + std::string(flag);
+      return std::nullopt;
+    }
+  }
+  return sources;
+}
+
+// =============================================================================
+// load_config() — The four layers, in order
+// =============================================================================
+std::optional<Config> load_config(const ConfigSources &sources,
+                                  std::string &error) {
+  Config config;
+  if (!sources.file.empty() && !apply_file(config, sources.file, error)) {
+    return std::nullopt;
+  }
+  if (!apply_environment(config, error)) {
+    return std::nullopt;
+  }
+  for (const auto &[name, value] : sources.flags) {
+    std::string why;
+    if (!set_config_value(config, name, value, why)) {
+      error = "--" + name + ": " + why;
+      return std::nullopt;
+    }
+  }
+  return config;
+}
+
+// =============================================================================
+// RuntimeConfig
+// =============================================================================
+RuntimeConfig::RuntimeConfig(Config config, ConfigSources sources,
+                             ApplyFn apply)
+    : config_(std::move(config)), sources_(std::move(sources)),
+      apply_(std::move(apply)) {}
+
+Config RuntimeConfig::current() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return config_;
+}
+
+// Settings are compared through their printed form: one generic way to
+// spot a change and to copy it across, whatever the field's type
+RuntimeConfig::ReloadResult RuntimeConfig::reload() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ReloadResult result;
+  const auto fresh = load_config(sources_, result.error);
+  if (!fresh.has_value()) {
+    Logger::error("Config reload failed: " + result.error);
+    return result;
+  }
+
+  Config next = config_;
+  for (const Setting &setting : SETTINGS) {
+    const std::string value = setting.show(*fresh);
+    if (value == setting.show(config_)) {
+      continue;
+    }
+    if (setting.live) {
+      setting.parse(next, value);
+      result.applied.push_back(std::string(setting.name) + " " + value);
+    } else {
+      result.needs_restart.push_back(std::string(setting.name) + " " + value);
+    }
+  }
+
+  config_ = std::move(next);
+  if (apply_) {
+    apply_(config_);
+  }
+  result.ok = true;
+
+  for (const std::string &change : result.applied) {
+    Logger::info("Config reload: " + change);
+  }
+  for (const std::string &change : result.needs_restart) {
+    Logger::warning("Config reload: " + change + " needs a restart");
+  }
+  return result;
+}
+
+} // namespace mini_redis
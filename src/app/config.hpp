@@ -0,0 +1,148 @@
+// =============================================================================
+// config.hpp — Server Settings: Defaults, File, Environment, Flags (HEADER)
+// =============================================================================
+//
+// Every tuning knob in one struct, filled from four layers — each one
+// overrides the one before:
+//
+//   1. the defaults below
+//   2. a config file (--config=PATH): "name = value" lines, # comments
+//   3. the environment: MINI_REDIS_<NAME>, e.g. MINI_REDIS_LOG_LEVEL=error
+//   4. command-line flags: --name=value or --name value
+//
+// So a file can hold the deployment's settings while a flag still wins
+// for one run, and the existing MINI_REDIS_DEDUP_MIN_BYTES-style
+// variables keep working (they ARE the setting names, in capitals).
+//
+// STARTUP vs LIVE SETTINGS:
+// Some settings are only read once — the port is bound, the worker
+// threads exist, the huge-page arena is mapped. Others are plain values
+// the running server reads on every use, so changing them is safe at any
+// time. RuntimeConfig::reload() re-reads all four layers (on SIGHUP, or
+// POST /admin/config/reload) and applies only the LIVE ones; a changed
+// startup setting is reported as needing a restart and otherwise ignored.
+//
+//   name                 scope    default     meaning
+//   port                 startup  8080        TCP port to listen on
+//   threads              startup  4           worker threads
+//   snapshot_path        startup  dump.mrdb   loaded at start, saved at exit
+//   huge_pages_mb        startup  0           huge-page arena size (0 = off)
+//   backing_dir          startup  (empty)     read-through store (empty = off)
+//   write_behind_batch   startup  256         writes per backing-store batch
+//   write_behind_ms      startup  100         max delay of a queued write
+//   log_level            live     info        info | warning | error
+//   read_buffer_bytes    live     4096        socket read size
+//   expiry_interval_ms   live     1000        expired-key sweep interval
+//   memory_decay_ms      live     0           allocator purge period
+//   dedup_min_bytes      live     0           share equal values (0 = off)
+//   compress_min_bytes   live     0           LZ4 large values (0 = off)
+//   inline_read_bytes    live     0           lock-free small GETs (0 = off)
+//   save_on_shutdown     live     true        write the snapshot at exit
+//   rate_limit_rps       live     0           requests/s per client (0 = off)
+//   rate_limit_burst     live     0           bucket size (0 = rate_limit_rps)
+//   rate_limit_by        live     ip          ip | api_key | namespace
+// =============================================================================
+
+#pragma once
+
+#include "util/logger.hpp"
+#include "util/rate_limiter.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace mini_redis {
+
+struct Config {
+  // ---- Startup only ----
+  int port = 8080;
+  std::size_t threads = 4;
+  std::string snapshot_path = "dump.mrdb";
+  std::uint64_t huge_pages_mb = 0;
+  std::string backing_dir; // empty = no backing store
+  std::size_t write_behind_batch = 256;
+  std::uint64_t write_behind_ms = 100;
+
+  // ---- Live ----
+  LogLevel log_level = LogLevel::INFO;
+  std::size_t read_buffer_bytes = 4096;
+  std::uint64_t expiry_interval_ms = 1000;
+  std::uint64_t memory_decay_ms = 0;
+  std::uint64_t dedup_min_bytes = 0;
+  std::uint64_t compress_min_bytes = 0;
+  std::uint64_t inline_read_bytes = 0;
+  bool save_on_shutdown = true;
+  std::uint64_t rate_limit_rps = 0;
+  std::uint64_t rate_limit_burst = 0;
+  RateLimitKey rate_limit_by = RateLimitKey::IP;
+};
+
+// Where a Config comes from, kept so a reload can read them all again
+struct ConfigSources {
+  std::string file; // empty = no config file
+  std::vector<std::pair<std::string, std::string>> flags; // name, value
+};
+
+// ---- parse_command_line() — argv into ConfigSources ----
+// Accepts --config=PATH and --name=value (or "--name value"). Flag names
+// are checked here; values are checked by load_config().
+std::optional<ConfigSources> parse_command_line(int argc, char **argv,
+                                                std::string &error);
+
+// ---- load_config() — Defaults, then file, then environment, then flags ----
+// nullopt (and a message naming the file/line or variable) on an unknown
+// setting, a bad value or an unreadable file.
+std::optional<Config> load_config(const ConfigSources &sources,
+                                  std::string &error);
+
+// ---- One setting by name ----
+// set_config_value() returns false (and says why) for an unknown name or
+// a value that doesn't parse; 'config' is left unchanged then.
+bool set_config_value(Config &config, std::string_view name,
+                      std::string_view value, std::string &error);
+bool is_config_setting(std::string_view name);
+bool is_live_setting(std::string_view name);
+
+// Every setting as a "name value" line, in the table's order
+std::string format_config(const Config &config);
+
+// =============================================================================
+// RuntimeConfig — The running server's settings, and reloading them
+// =============================================================================
+// Holds the current Config and the sources it was read from. The apply
+// callback pushes live settings into the components (the Application
+// wires it up) and runs once per successful reload, under the same mutex,
+// so two reloads can't interleave.
+// =============================================================================
+class RuntimeConfig {
+public:
+  using ApplyFn = std::function<void(const Config &)>;
+
+  RuntimeConfig(Config config, ConfigSources sources, ApplyFn apply);
+
+  // A copy: the caller may keep it while a reload replaces the original
+  Config current() const;
+
+  struct ReloadResult {
+    bool ok = false;
+    std::string error;                      // if !ok; nothing was changed
+    std::vector<std::string> applied;       // live settings that changed
+    std::vector<std::string> needs_restart; // changed startup settings
+  };
+  ReloadResult reload();
+
+private:
+  mutable std::mutex mutex_;
+  Config config_;
+  const ConfigSources sources_;
+  const ApplyFn apply_;
+};
+
+} // namespace mini_redis
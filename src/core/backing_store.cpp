@@ -0,0 +1,301 @@
+// =============================================================================
+// backing_store.cpp — Read-Through and Write-Behind (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/backing_store.hpp"
+#include "util/hash.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm> // std::min
+#include <cstdio>    // std::rename, std::remove
+#include <filesystem>
+#include <fstream>
+#include <iterator> // std::istreambuf_iterator
+#include <system_error>
+#include <utility> // std::move
+
+namespace mini_redis {
+
+// =============================================================================
+// FileBackingStore
+// =============================================================================
+FileBackingStore::FileBackingStore(std::string directory)
+    : directory_(std::move(directory)) {
+  std::error_code error;
+  std::filesystem::create_directories(directory_, error);
+  if (error) {
+    Logger::error("Backing store: cannot create '" + directory_ +
+                  "': " + error.message());
+  }
+}
+
+std::string FileBackingStore::path_of(const std::string &key) const {
+  static constexpr char DIGITS[] = "0123456789abcdef";
+  std::string path = directory_ + "/";
+  path.reserve(path.size() + key.size() * 2);
+  for (const char c : key) {
+    const auto byte = static_cast<unsigned char>(c);
+    path += DIGITS[byte >> 4];
+    path += DIGITS[byte & 0xf];
+  }
+  return path;
+}
+
+std::optional<std::string> FileBackingStore::load(const std::string &key) {
+  if (key.size() > MAX_KEY_BYTES) {
+    return std::nullopt;
+  }
+  std::ifstream file(path_of(key), std::ios::binary);
+  if (!file) {
+    return std::nullopt; // no such key
+  }
+  return std::string((std::istreambuf_iterator<char>(file)),
+                     std::istreambuf_iterator<char>());
+}
+
+// Values: written to "<name>.tmp", then renamed over "<name>" (atomic on
+// POSIX). Deletes: a missing file is already what we want.
+bool FileBackingStore::write_batch(const std::vector<BackingWrite> &batch) {
+  for (const BackingWrite &write : batch) {
+    if (write.key.size() > MAX_KEY_BYTES) {
+      Logger::error("Backing store: key of " +
+                    std::to_string(write.key.size()) +
+                    " bytes is too long for a file name, skipped");
+      continue;
+    }
+    const std::string path = path_of(write.key);
+    if (!write.value.has_value()) {
+      std::error_code error;
+      std::filesystem::remove(path, error);
+      if (error) {
+        Logger::error("Backing store: cannot delete '" + path + "'");
+        return false;
+      }
+      continue;
+    }
+
+    const std::string tmp_path = path + ".tmp";
+    {
+      std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+      file.write(write.value->data(),
+                 static_cast<std::streamsize>(write.value->size()));
+      file.flush();
+      if (!file) {
+        Logger::error("Backing store: cannot write '" + tmp_path + "'");
+        std::remove(tmp_path.c_str());
+        return false;
+      }
+    }
+    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+      Logger::error("Backing store: cannot rename '" + tmp_path + "'");
+      std::remove(tmp_path.c_str());
+      return false;
+    }
+  }
+  return true;
+}
+
+// =============================================================================
+// CacheBacking
+// =============================================================================
+CacheBacking::CacheBacking(std::shared_ptr<BackingStore> backing,
+                           const WriteBehindOptions &options)
+    : backing_(std::move(backing)),
+      options_{std::max<std::size_t>(options.batch_size, 1),
+               options.interval} {
+  writer_ = std::thread(&CacheBacking::writer_loop, this);
+}
+
+// The writer sends what is still queued before it exits
+CacheBacking::~CacheBacking() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  wake_writer_.notify_one();
+  if (writer_.joinable()) {
+    writer_.join();
+  }
+}
+
+std::atomic<std::uint64_t> &
+CacheBacking::stripe(const std::string &key) const {
+  return generations_[hash_key(key) & (STRIPES - 1)];
+}
+
+std::uint64_t CacheBacking::generation(const std::string &key) const {
+  return stripe(key).load(std::memory_order_acquire);
+}
+
+const std::optional<std::string> *
+CacheBacking::queued_write(const std::string &key) const {
+  if (const auto it = queue_.find(key); it != queue_.end()) {
+    return &it->second;
+  }
+  if (const auto it = in_flight_.find(key); it != in_flight_.end()) {
+    return &it->second;
+  }
+  return nullptr;
+}
+
+// =============================================================================
+// load() — Queue first, then one load per key at a time
+// =============================================================================
+// The first thread to miss a key registers a future for it and does the
+// load with no lock held; threads missing the same key meanwhile wait on
+// that future instead of loading it again.
+// =============================================================================
+std::optional<std::string> CacheBacking::load(const std::string &key) {
+  std::promise<std::optional<std::string>> promise;
+  std::shared_future<std::optional<std::string>> pending;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (const auto *queued = queued_write(key)) {
+      ++stats_.queue_hits;
+      return *queued;
+    }
+    if (const auto it = loads_.find(key); it != loads_.end()) {
+      ++stats_.coalesced;
+      pending = it->second;
+    } else {
+      ++stats_.loads;
+      loads_.emplace(key, promise.get_future().share());
+    }
+  }
+  if (pending.valid()) {
+    return pending.get();
+  }
+
+  std::optional<std::string> value = backing_->load(key);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    loads_.erase(key);
+    if (value.has_value()) {
+      ++stats_.load_hits;
+    }
+  }
+  promise.set_value(value);
+  return value;
+}
+
+// =============================================================================
+// enqueue() — Newest write per key; the writer is woken for a full batch
+// =============================================================================
+void CacheBacking::enqueue(BackingWrite write) {
+  stripe(write.key).fetch_add(1, std::memory_order_acq_rel);
+  bool full = false;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.queued;
+    auto [it, inserted] =
+        queue_.try_emplace(std::move(write.key), std::move(write.value));
+    if (!inserted) {
+      ++stats_.superseded;
+      it->second = std::move(write.value);
+    }
+    full = queue_.size() >= options_.batch_size;
+  }
+  if (full) {
+    wake_writer_.notify_one();
+  }
+}
+
+bool CacheBacking::flush() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const std::uint64_t failures = stats_.failed_batches;
+  flush_requested_ = true;
+  wake_writer_.notify_one();
+  written_.wait(lock, [&] {
+    return (queue_.empty() && in_flight_.empty()) ||
+           stats_.failed_batches != failures;
+  });
+  return queue_.empty() && in_flight_.empty();
+}
+
+BackingStats CacheBacking::stats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  BackingStats stats = stats_;
+  stats.pending = queue_.size() + in_flight_.size();
+  return stats;
+}
+
+// =============================================================================
+// writer_loop() — Send the queue every interval, or when a batch is full
+// =============================================================================
+// The whole queue is swapped out at once (it becomes in_flight_, still
+// visible to load()) and sent in batch_size pieces with no lock held, so
+// SETs keep queueing while the backing store is slow. If a batch fails,
+// whatever wasn't superseded meanwhile goes back in the queue, and the
+// writer waits one interval before trying again.
+// =============================================================================
+void CacheBacking::writer_loop() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_writer_.wait_for(lock, options_.interval, [this] {
+      return stopping_ || flush_requested_ ||
+             queue_.size() >= options_.batch_size;
+    });
+    flush_requested_ = false;
+    if (queue_.empty()) {
+      written_.notify_all();
+      if (stopping_) {
+        return;
+      }
+      continue;
+    }
+
+    in_flight_.swap(queue_);
+    std::vector<BackingWrite> writes;
+    writes.reserve(in_flight_.size());
+    for (const auto &[key, value] : in_flight_) {
+      writes.push_back(BackingWrite{key, value});
+    }
+    lock.unlock();
+
+    std::uint64_t written = 0;
+    std::uint64_t batches = 0;
+    bool ok = true;
+    std::vector<BackingWrite> batch;
+    for (std::size_t begin = 0; begin < writes.size() && ok;
+         begin += options_.batch_size) {
+      const std::size_t end =
+          std::min(writes.size(), begin + options_.batch_size);
+      batch.assign(std::make_move_iterator(writes.begin() + begin),
+                   std::make_move_iterator(writes.begin() + end));
+      ok = backing_->write_batch(batch);
+      if (ok) {
+        written += batch.size();
+        ++batches;
+      }
+    }
+
+    lock.lock();
+    stats_.written += written;
+    stats_.batches += batches;
+    if (!ok) {
+      ++stats_.failed_batches;
+      // Re-sending the batches that did succeed is harmless: writes are
+      // safe to repeat
+      for (auto &[key, value] : in_flight_) {
+        queue_.try_emplace(key, std::move(value));
+      }
+    }
+    in_flight_.clear();
+    written_.notify_all();
+
+    if (!ok) {
+      if (stopping_) {
+        Logger::error("Backing store: " + std::to_string(queue_.size()) +
+                      " writes lost at shutdown");
+        return;
+      }
+      Logger::warning("Backing store: write failed, retrying in " +
+                      std::to_string(options_.interval.count()) + " ms");
+      wake_writer_.wait_for(lock, options_.interval, [this] {
+        return stopping_ || flush_requested_;
+      });
+    }
+  }
+}
+
+} // namespace mini_redis
@@ -0,0 +1,209 @@
+// =============================================================================
+// backing_store.hpp — Read-Through and Write-Behind (HEADER)
+// =============================================================================
+//
+// Used as a CACHE in front of a slower system of record (a database), the
+// store keeps the hot keys in memory and the backing store keeps them all:
+//
+//   READ-THROUGH  : a GET that misses asks the backing store, caches what
+//                   it finds and returns it. The client never has to
+//                   "check the cache, then the database, then fill the
+//                   cache" itself.
+//   WRITE-BEHIND  : SET and DEL change the cache and return at once; the
+//                   write is queued, and a background thread sends the
+//                   queue to the backing store in batches. A key written
+//                   ten times between two flushes is sent once (the last
+//                   value wins).
+//
+// COALESCING:
+// When a popular key is missing, hundreds of requests miss it at the same
+// moment. Without care each one would query the database (a "cache
+// stampede"). Here the first miss starts the load and registers it; the
+// others find it registered and wait on its std::shared_future, so one
+// load answers them all.
+//
+// READING YOUR OWN WRITES:
+// Until the writer thread has sent it, a queued write is newer than what
+// the backing store holds. A load therefore looks in the queue first: a
+// key SET then evicted reads back the value just written, and a key just
+// DELeted reads as missing — never as the stale copy.
+//
+// THE PLUGIN:
+// BackingStore is an abstract class with two virtual functions, so the
+// system of record is chosen at RUNTIME (map_policies.hpp chooses at
+// compile time instead, where every nanosecond counts; here a database
+// round trip dwarfs a virtual call). FileBackingStore is the reference
+// implementation: one file per key in a directory, good enough to stand
+// in for the database in tests and on a laptop.
+// =============================================================================
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future> // std::promise, std::shared_future
+#include <memory> // std::shared_ptr
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mini_redis {
+
+// ---- BackingWrite — One write to send: a value, or a delete ----
+struct BackingWrite {
+  std::string key;
+  std::optional<std::string> value; // std::nullopt = delete the key
+};
+
+// =============================================================================
+// BackingStore — The system of record behind the cache (interface)
+// =============================================================================
+// Both functions are called from several threads at once: load() from
+// every worker thread that misses, write_batch() from the writer thread.
+// =============================================================================
+class BackingStore {
+public:
+  virtual ~BackingStore() = default;
+
+  // The key's value, or std::nullopt if the backing store doesn't have it
+  virtual std::optional<std::string> load(const std::string &key) = 0;
+
+  // Apply every write in the batch. false = it failed and will be sent
+  // again (whole): writes must be safe to repeat.
+  virtual bool write_batch(const std::vector<BackingWrite> &batch) = 0;
+};
+
+// =============================================================================
+// FileBackingStore — Reference implementation: a file per key
+// =============================================================================
+// The file name is the key in hex ("user:1" → "757365723a31"), so any key
+// bytes are safe in it; a write goes to a temporary file first and is
+// renamed over the old one, so a crash never leaves half a value. Keys
+// longer than MAX_KEY_BYTES would overflow a file name: they are never
+// found, and writing one logs an error and skips it.
+// =============================================================================
+class FileBackingStore : public BackingStore {
+public:
+  static constexpr std::size_t MAX_KEY_BYTES = 120;
+
+  // Creates 'directory' if it doesn't exist
+  explicit FileBackingStore(std::string directory);
+
+  std::optional<std::string> load(const std::string &key) override;
+  bool write_batch(const std::vector<BackingWrite> &batch) override;
+
+  const std::string &directory() const { return directory_; }
+
+private:
+  std::string path_of(const std::string &key) const;
+
+  std::string directory_;
+};
+
+// ---- WriteBehindOptions — When the queue is sent ----
+// Whichever comes first: 'batch_size' writes queued, or 'interval' since
+// the last flush. Also the size of each write_batch() call.
+struct WriteBehindOptions {
+  std::size_t batch_size = 256;
+  std::chrono::milliseconds interval{100};
+};
+
+// ---- BackingStats — Counters since the backing store was attached ----
+struct BackingStats {
+  std::uint64_t loads = 0;          // calls to BackingStore::load()
+  std::uint64_t load_hits = 0;      // ... that found the key
+  std::uint64_t coalesced = 0;      // misses answered by another's load
+  std::uint64_t queue_hits = 0;     // misses answered by a queued write
+  std::uint64_t queued = 0;         // writes queued
+  std::uint64_t superseded = 0;     // ... replaced by a newer one unsent
+  std::uint64_t written = 0;        // writes sent successfully
+  std::uint64_t batches = 0;        // write_batch() calls that succeeded
+  std::uint64_t failed_batches = 0; // ... that failed (and were retried)
+  std::uint64_t pending = 0;        // queued or being sent, right now
+};
+
+// =============================================================================
+// CacheBacking — Coalesced loads and the write-behind queue
+// =============================================================================
+// Owned by the KeyValueStore it serves (see set_backing_store()). Owns the
+// writer thread; destroying it sends what is still queued first.
+// =============================================================================
+class CacheBacking {
+public:
+  CacheBacking(std::shared_ptr<BackingStore> backing,
+               const WriteBehindOptions &options);
+  ~CacheBacking();
+
+  // Non-copyable, non-movable (owns a running thread)
+  CacheBacking(const CacheBacking &) = delete;
+  CacheBacking &operator=(const CacheBacking &) = delete;
+  CacheBacking(CacheBacking &&) = delete;
+  CacheBacking &operator=(CacheBacking &&) = delete;
+
+  // ---- load() — The key's newest value outside the cache ----
+  // A queued write if there is one, else the backing store's value —
+  // loaded once however many threads ask for it at the same time.
+  std::optional<std::string> load(const std::string &key);
+
+  // ---- enqueue() — Queue a write for the writer thread ----
+  // The store calls it while holding the key's shard lock, so writes to
+  // one key are queued in the order they were applied.
+  void enqueue(BackingWrite write);
+
+  // ---- generation() — Has the key been written since? ----
+  // Bumped by every enqueue() of the key (or of one sharing its stripe).
+  // A loaded value is only cached if the generation read BEFORE the load
+  // is still current: otherwise a write raced with the load, and the
+  // loaded value may already be stale.
+  std::uint64_t generation(const std::string &key) const;
+
+  // ---- flush() — Send the queue now, and wait until it is empty ----
+  // false if a batch failed meanwhile (its writes stay queued). For tests
+  // and shutdown: with other threads still writing, it waits for them too.
+  bool flush();
+
+  BackingStats stats() const;
+
+private:
+  void writer_loop();
+
+  // A queued or in-flight write to 'key'; caller holds mutex_
+  const std::optional<std::string> *queued_write(const std::string &key) const;
+
+  std::atomic<std::uint64_t> &stripe(const std::string &key) const;
+
+  const std::shared_ptr<BackingStore> backing_;
+  const WriteBehindOptions options_;
+
+  // Write generations, striped by key hash (see generation())
+  static constexpr std::size_t STRIPES = 1024;
+  mutable std::array<std::atomic<std::uint64_t>, STRIPES> generations_{};
+
+  mutable std::mutex mutex_;
+  std::condition_variable wake_writer_;
+  std::condition_variable written_; // a flush finished (or failed)
+
+  // key → newest unsent write; in_flight_ is what the writer is sending
+  std::unordered_map<std::string, std::optional<std::string>> queue_;
+  std::unordered_map<std::string, std::optional<std::string>> in_flight_;
+
+  // Loads in progress, by key: a second miss waits on the first's future
+  std::unordered_map<std::string,
+                     std::shared_future<std::optional<std::string>>>
+      loads_;
+
+  bool flush_requested_ = false;
+  bool stopping_ = false;
+  BackingStats stats_;
+
+  std::thread writer_;
+};
+
+} // namespace mini_redis
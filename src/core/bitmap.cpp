@@ -0,0 +1,125 @@
+// =============================================================================
+// bitmap.cpp — Bitmap Commands on String Values (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/bitmap.hpp"
+
+#include <algorithm> // std::max, std::min
+
+namespace mini_redis {
+
+namespace {
+
+const std::uint8_t *as_bytes(std::string_view text) {
+  return reinterpret_cast<const std::uint8_t *>(text.data());
+}
+
+std::uint8_t *as_bytes(std::string &text) {
+  return reinterpret_cast<std::uint8_t *>(text.data());
+}
+
+} // anonymous namespace
+
+std::optional<ByteRange> resolve_byte_range(long long start, long long end,
+                                            std::uint64_t length) {
+  const auto size = static_cast<long long>(length);
+  if (start < 0) {
+    start += size;
+  }
+  if (end < 0) {
+    end += size;
+  }
+  start = std::max(start, 0LL);
+  end = std::min(end, size - 1);
+  if (size == 0 || end < 0 || start > end) {
+    return std::nullopt;
+  }
+  return ByteRange{static_cast<std::uint64_t>(start),
+                   static_cast<std::uint64_t>(end)};
+}
+
+// =============================================================================
+// set_bit() / get_bit()
+// =============================================================================
+bool set_bit(std::string &bytes, std::uint64_t offset, bool value) {
+  const std::uint64_t index = offset / 8;
+  const auto mask = static_cast<std::uint8_t>(0x80 >> (offset % 8));
+  if (index >= bytes.size()) {
+    bytes.resize(index + 1, '\0'); // SETBIT grows the string with zeros
+  }
+
+  auto &byte = reinterpret_cast<std::uint8_t &>(bytes[index]);
+  const bool old = (byte & mask) != 0;
+  byte = value ? static_cast<std::uint8_t>(byte | mask)
+               : static_cast<std::uint8_t>(byte & ~mask);
+  return old;
+}
+
+bool get_bit(std::string_view bytes, std::uint64_t offset) {
+  const std::uint64_t index = offset / 8;
+  if (index >= bytes.size()) {
+    return false; // past the end reads as zero
+  }
+  return (as_bytes(bytes)[index] & (0x80 >> (offset % 8))) != 0;
+}
+
+// =============================================================================
+// count_bits() / find_bit()
+// =============================================================================
+std::uint64_t count_bits(std::string_view bytes, ByteRange range) {
+  return bit_count(as_bytes(bytes) + range.first, range.last - range.first + 1);
+}
+
+std::optional<std::uint64_t> find_bit(std::string_view bytes, bool bit,
+                                      ByteRange range) {
+  // Skip whole bytes that can't contain the bit (SIMD scan)...
+  const std::uint8_t skip = bit ? 0x00 : 0xFF;
+  const std::uint64_t length = range.last - range.first + 1;
+  const std::uint64_t index =
+      range.first + find_byte_not(as_bytes(bytes) + range.first, length, skip);
+  if (index > range.last) {
+    return std::nullopt;
+  }
+
+  // ...then locate it inside the byte: bit 0 is the MOST significant,
+  // so count leading zeros (of the byte, or of its complement for bit 0)
+  const std::uint8_t byte = as_bytes(bytes)[index];
+  const unsigned target = bit ? byte : static_cast<std::uint8_t>(~byte);
+  return index * 8 + static_cast<std::uint64_t>(__builtin_clz(target) - 24);
+}
+
+// =============================================================================
+// combine_bits() / invert_bits()
+// =============================================================================
+std::string combine_bits(BitOp op,
+                         const std::vector<std::string_view> &sources) {
+  if (sources.empty()) {
+    return {};
+  }
+  std::size_t longest = 0;
+  for (const auto source : sources) {
+    longest = std::max(longest, source.size());
+  }
+
+  std::string result(sources.front());
+  result.resize(longest, '\0');
+  for (std::size_t i = 1; i < sources.size(); ++i) {
+    const auto source = sources[i];
+    bitwise(op, as_bytes(result), as_bytes(source), source.size());
+    // AND with the implicit zero padding clears everything past the end;
+    // OR / XOR with zeros change nothing
+    if (op == BitOp::AND) {
+      std::fill(result.begin() + static_cast<std::ptrdiff_t>(source.size()),
+                result.end(), '\0');
+    }
+  }
+  return result;
+}
+
+std::string invert_bits(std::string_view source) {
+  std::string result(source);
+  bitwise_not(as_bytes(result), result.size());
+  return result;
+}
+
+} // namespace mini_redis
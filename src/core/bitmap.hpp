@@ -0,0 +1,57 @@
+// =============================================================================
+// bitmap.hpp — Bitmap Commands on String Values (HEADER)
+// =============================================================================
+//
+// Redis has no separate bitmap type: SETBIT/GETBIT/BITCOUNT/BITPOS/BITOP
+// treat an ordinary STRING as an array of bits, growing it with zero bytes
+// as needed. These free functions implement those semantics on a
+// std::string (bit order: see bitmap_ops.hpp); the heavy lifting happens
+// in the SIMD kernels.
+//
+// Ranges follow Redis: [start, end] are BYTE indexes, inclusive, and
+// negative values count from the end (-1 = last byte).
+// =============================================================================
+
+#pragma once
+
+#include "core/bitmap_ops.hpp"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis {
+
+// Redis' limit: a bitmap is at most 512 MB = 2^32 bits
+constexpr std::uint64_t MAX_BIT_OFFSET = (std::uint64_t{1} << 32) - 1;
+
+// ---- An inclusive byte range, resolved against a length ----
+struct ByteRange {
+  std::uint64_t first;
+  std::uint64_t last;
+};
+
+// Apply Redis' negative-index and clamping rules. std::nullopt = empty range.
+std::optional<ByteRange> resolve_byte_range(long long start, long long end,
+                                            std::uint64_t length);
+
+// ---- SETBIT / GETBIT — set_bit() returns the OLD bit ----
+bool set_bit(std::string &bytes, std::uint64_t offset, bool value);
+bool get_bit(std::string_view bytes, std::uint64_t offset);
+
+// ---- BITCOUNT over bytes [range.first, range.last] ----
+std::uint64_t count_bits(std::string_view bytes, ByteRange range);
+
+// ---- BITPOS — offset of the first bit equal to 'bit' in the range ----
+std::optional<std::uint64_t> find_bit(std::string_view bytes, bool bit,
+                                      ByteRange range);
+
+// ---- BITOP — the result is as long as the LONGEST source ----
+// Shorter sources behave as if padded with zero bytes.
+std::string combine_bits(BitOp op,
+                         const std::vector<std::string_view> &sources);
+std::string invert_bits(std::string_view source);
+
+} // namespace mini_redis
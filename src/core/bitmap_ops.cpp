@@ -0,0 +1,265 @@
+// =============================================================================
+// bitmap_ops.cpp — Kernels for Raw Bit Arrays (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/bitmap_ops.hpp"
+
+#include <cstring> // std::memcpy
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MINI_REDIS_HAVE_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace mini_redis {
+
+namespace {
+
+// Unaligned 8-byte load without breaking aliasing rules
+std::uint64_t load_u64(const std::uint8_t *p) {
+  std::uint64_t word;
+  std::memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+void store_u64(std::uint8_t *p, std::uint64_t word) {
+  std::memcpy(p, &word, sizeof(word));
+}
+
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+
+// Checked once; the answers can't change while the process runs
+bool cpu_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+bool cpu_has_popcnt() {
+  static const bool has_popcnt = __builtin_cpu_supports("popcnt");
+  return has_popcnt;
+}
+
+// Same loop as bit_count_scalar, but compiled so that __builtin_popcountll
+// becomes ONE popcnt instruction instead of a dozen shifts and masks
+__attribute__((target("popcnt"))) std::uint64_t
+bit_count_popcnt(const std::uint8_t *data, std::size_t length) {
+  std::uint64_t total = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    total +=
+        static_cast<std::uint64_t>(__builtin_popcountll(load_u64(data + i)));
+  }
+  for (; i < length; ++i) {
+    total += static_cast<std::uint64_t>(__builtin_popcount(data[i]));
+  }
+  return total;
+}
+
+// =============================================================================
+// bit_count_avx2() — Nibble lookup (Muła's algorithm)
+// =============================================================================
+// vpshufb looks up 32 bytes in a 16-entry table at once. Split each byte
+// into its two 4-bit halves, look up "how many ones in this nibble" for
+// both, and add: 32 per-byte counts in two instructions.
+//
+// Per-byte counts (max 8) accumulate for up to 31 rounds before a byte
+// could overflow 255; then vpsadbw sums each group of 8 bytes into a
+// 64-bit lane and we start over.
+// =============================================================================
+__attribute__((target("avx2"))) std::uint64_t
+bit_count_avx2(const std::uint8_t *data, std::size_t length) {
+  const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3,
+                                         2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3,
+                                         1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i low_mask = _mm256_set1_epi8(0x0F);
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i totals = zero;
+
+  std::size_t i = 0;
+  while (i + 32 <= length) {
+    __m256i bytes_acc = zero;
+    for (int round = 0; round < 31 && i + 32 <= length; ++round, i += 32) {
+      const __m256i v =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+      const __m256i lo = _mm256_and_si256(v, low_mask);
+      const __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+      bytes_acc = _mm256_add_epi8(bytes_acc, _mm256_shuffle_epi8(table, lo));
+      bytes_acc = _mm256_add_epi8(bytes_acc, _mm256_shuffle_epi8(table, hi));
+    }
+    totals = _mm256_add_epi64(totals, _mm256_sad_epu8(bytes_acc, zero));
+  }
+
+  alignas(32) std::uint64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), totals);
+  std::uint64_t total = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+  for (; i < length; ++i) {
+    total += static_cast<std::uint64_t>(__builtin_popcount(data[i]));
+  }
+  return total;
+}
+
+// One template for AND/OR/XOR so the operator is a compile-time constant
+// inside the hot loop (no branch per block)
+template <BitOp OP>
+__attribute__((target("avx2"))) void
+bitwise_avx2(std::uint8_t *dst, const std::uint8_t *src, std::size_t length) {
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    __m256i r;
+    if constexpr (OP == BitOp::AND) {
+      r = _mm256_and_si256(a, b);
+    } else if constexpr (OP == BitOp::OR) {
+      r = _mm256_or_si256(a, b);
+    } else {
+      r = _mm256_xor_si256(a, b);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i), r);
+  }
+  bitwise_scalar(OP, dst + i, src + i, length - i);
+}
+
+__attribute__((target("avx2"))) void bitwise_not_avx2(std::uint8_t *data,
+                                                      std::size_t length) {
+  const __m256i ones = _mm256_set1_epi8(-1);
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i v = _mm256_loadu_si256(reinterpret_cast<__m256i *>(data + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(data + i),
+                        _mm256_xor_si256(v, ones));
+  }
+  for (; i < length; ++i) {
+    data[i] = static_cast<std::uint8_t>(~data[i]);
+  }
+}
+
+// Compare 32 bytes against 'skip' at once; movemask turns the result into
+// one bit per byte, so the first mismatch is a count-trailing-ones away
+__attribute__((target("avx2"))) std::size_t
+find_byte_not_avx2(const std::uint8_t *data, std::size_t length,
+                   std::uint8_t skip) {
+  const __m256i needle = _mm256_set1_epi8(static_cast<char>(skip));
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    const auto same = static_cast<std::uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+    if (same != 0xFFFFFFFFu) {
+      return i + static_cast<std::size_t>(__builtin_ctz(~same));
+    }
+  }
+  for (; i < length; ++i) {
+    if (data[i] != skip) {
+      return i;
+    }
+  }
+  return length;
+}
+
+#endif // MINI_REDIS_HAVE_AVX2_KERNELS
+
+} // anonymous namespace
+
+// =============================================================================
+// Portable kernels — 8 bytes per step
+// =============================================================================
+std::uint64_t bit_count_scalar(const std::uint8_t *data, std::size_t length) {
+  std::uint64_t total = 0;
+  std::size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    total +=
+        static_cast<std::uint64_t>(__builtin_popcountll(load_u64(data + i)));
+  }
+  for (; i < length; ++i) {
+    total += static_cast<std::uint64_t>(__builtin_popcount(data[i]));
+  }
+  return total;
+}
+
+void bitwise_scalar(BitOp op, std::uint8_t *dst, const std::uint8_t *src,
+                    std::size_t length) {
+  std::size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    const std::uint64_t a = load_u64(dst + i);
+    const std::uint64_t b = load_u64(src + i);
+    store_u64(dst + i, op == BitOp::AND ? (a & b)
+                       : op == BitOp::OR ? (a | b)
+                                         : (a ^ b));
+  }
+  for (; i < length; ++i) {
+    dst[i] = static_cast<std::uint8_t>(op == BitOp::AND ? (dst[i] & src[i])
+                                       : op == BitOp::OR ? (dst[i] | src[i])
+                                                         : (dst[i] ^ src[i]));
+  }
+}
+
+// =============================================================================
+// Dispatchers
+// =============================================================================
+std::uint64_t bit_count(const std::uint8_t *data, std::size_t length) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    return bit_count_avx2(data, length);
+  }
+  if (cpu_has_popcnt()) {
+    return bit_count_popcnt(data, length);
+  }
+#endif
+  return bit_count_scalar(data, length);
+}
+
+void bitwise(BitOp op, std::uint8_t *dst, const std::uint8_t *src,
+             std::size_t length) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    switch (op) {
+    case BitOp::AND:
+      bitwise_avx2<BitOp::AND>(dst, src, length);
+      return;
+    case BitOp::OR:
+      bitwise_avx2<BitOp::OR>(dst, src, length);
+      return;
+    case BitOp::XOR:
+      bitwise_avx2<BitOp::XOR>(dst, src, length);
+      return;
+    }
+  }
+#endif
+  bitwise_scalar(op, dst, src, length);
+}
+
+void bitwise_not(std::uint8_t *data, std::size_t length) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    bitwise_not_avx2(data, length);
+    return;
+  }
+#endif
+  std::size_t i = 0;
+  for (; i + 8 <= length; i += 8) {
+    store_u64(data + i, ~load_u64(data + i));
+  }
+  for (; i < length; ++i) {
+    data[i] = static_cast<std::uint8_t>(~data[i]);
+  }
+}
+
+std::size_t find_byte_not(const std::uint8_t *data, std::size_t length,
+                          std::uint8_t skip) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    return find_byte_not_avx2(data, length, skip);
+  }
+#endif
+  for (std::size_t i = 0; i < length; ++i) {
+    if (data[i] != skip) {
+      return i;
+    }
+  }
+  return length;
+}
+
+} // namespace mini_redis
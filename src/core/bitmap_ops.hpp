@@ -0,0 +1,53 @@
+// =============================================================================
+// bitmap_ops.hpp — Kernels for Raw Bit Arrays (HEADER)
+// =============================================================================
+//
+// A BITMAP is just a byte string read as bits: "user 1234 was active today"
+// is bit 1234 set. 100 million users fit in 12.5 MB, and questions like
+// "how many were active on Monday AND Tuesday?" become whole-array
+// operations: AND the two days together, then count the ones.
+//
+// BIT ORDER (same as Redis, so bitmaps are interchangeable with it):
+// bit 0 is the MOST significant bit of byte 0. Bit n lives in byte n / 8
+// under the mask 0x80 >> (n % 8).
+//
+// These loops run over megabytes, so they're worth SIMD:
+//   - popcount: AVX2 counts bits in 32 bytes at a time with a nibble lookup
+//     table (vpshufb); without AVX2 we use the POPCNT instruction 8 bytes
+//     at a time; without that, the compiler's portable bit trick.
+//   - AND/OR/XOR/NOT and the first-set-byte scan: 32 bytes per instruction.
+//
+// As in set_ops.hpp, each kernel is picked at RUNTIME, so one binary runs
+// everywhere and uses whatever the CPU offers.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mini_redis {
+
+enum class BitOp { AND, OR, XOR };
+
+// ---- bit_count() — Number of 1 bits in data[0 .. length) ----
+std::uint64_t bit_count(const std::uint8_t *data, std::size_t length);
+
+// ---- bitwise() — dst[i] = dst[i] OP src[i] for i in [0, length) ----
+void bitwise(BitOp op, std::uint8_t *dst, const std::uint8_t *src,
+             std::size_t length);
+
+// ---- bitwise_not() — data[i] = ~data[i] ----
+void bitwise_not(std::uint8_t *data, std::size_t length);
+
+// ---- find_byte_not() — Index of the first byte != 'skip', or 'length' ----
+// BITPOS 1 skips 0x00 bytes; BITPOS 0 skips 0xFF bytes.
+std::size_t find_byte_not(const std::uint8_t *data, std::size_t length,
+                          std::uint8_t skip);
+
+// ---- Portable versions (exposed for tests and benchmarks) ----
+std::uint64_t bit_count_scalar(const std::uint8_t *data, std::size_t length);
+void bitwise_scalar(BitOp op, std::uint8_t *dst, const std::uint8_t *src,
+                    std::size_t length);
+
+} // namespace mini_redis
@@ -0,0 +1,265 @@
+// =============================================================================
+// bloom_filter.cpp — Scalable Bloom Filter Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/bloom_filter.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm> // std::max
+#include <cmath>     // std::log, std::ceil, std::pow
+
+namespace mini_redis {
+
+namespace {
+
+constexpr std::uint64_t BLOOM_HASH_SEED = 0x9e3779b97f4a7c15ULL;
+
+// How many items ahead a batch prefetches. Far enough for the cache line to
+// arrive before we need it, near enough that it hasn't been evicted again.
+constexpr std::size_t PREFETCH_DISTANCE = 8;
+
+// Reject absurd probe counts when loading a (possibly corrupted) snapshot
+constexpr std::uint32_t MAX_HASHES = 64;
+
+// m = -n * ln(p) / (ln 2)^2, see add_layer()
+double bits_for(double capacity, double error_rate) {
+  const double ln2 = std::log(2.0);
+  return std::ceil(-capacity * std::log(error_rate) / (ln2 * ln2));
+}
+
+} // anonymous namespace
+
+BloomFilter::BloomFilter(double error_rate, std::size_t initial_capacity)
+    : error_rate_(error_rate),
+      initial_capacity_(std::max<std::size_t>(initial_capacity, 1)) {
+  add_layer();
+}
+
+BloomFilter::BloomFilter(double error_rate, std::size_t initial_capacity,
+                         NoLayers)
+    : error_rate_(error_rate),
+      initial_capacity_(std::max<std::size_t>(initial_capacity, 1)) {}
+
+double BloomFilter::first_layer_bits(double error_rate,
+                                     std::size_t initial_capacity) {
+  return bits_for(
+      static_cast<double>(std::max<std::size_t>(initial_capacity, 1)),
+      error_rate);
+}
+
+// =============================================================================
+// add_layer() — Size a new layer for its capacity and error rate
+// =============================================================================
+// Textbook optimum for n items at false-positive rate p:
+//   m = -n * ln(p) / (ln 2)^2   bits
+//   k = (m / n) * ln 2          hash probes  (= -log2(p))
+// =============================================================================
+void BloomFilter::add_layer() {
+  const auto n = layers_.size();
+  const double p = error_rate_ * std::pow(TIGHTENING, static_cast<double>(n));
+  const std::uint64_t capacity =
+      initial_capacity_ * static_cast<std::uint64_t>(
+                              std::pow(static_cast<double>(GROWTH), n));
+
+  const double ln2 = std::log(2.0);
+  const double bits = bits_for(static_cast<double>(capacity), p);
+
+  Layer layer;
+  layer.bits = std::max<std::uint64_t>(64, static_cast<std::uint64_t>(bits));
+  layer.hashes = static_cast<std::uint32_t>(
+      std::max(1.0, std::ceil(-std::log(p) / ln2)));
+  layer.capacity = capacity;
+  layer.words.assign((layer.bits + 63) / 64, 0);
+  layers_.push_back(std::move(layer));
+}
+
+// =============================================================================
+// Hashing and probing
+// =============================================================================
+BloomFilter::Probe BloomFilter::probe_for(const std::string &item) {
+  const std::uint64_t hash = hash64(item, BLOOM_HASH_SEED);
+  // h2 is derived with one extra multiply (instead of a second full hash)
+  // and forced odd so that the probe sequence never collapses onto h1
+  return Probe{hash, (hash * 0xff51afd7ed558ccdULL) | 1};
+}
+
+// Probe i lands at (h1 + i*h2) mapped onto [0, bits). The mapping uses a
+// multiply-high instead of '%': same uniformity, no slow division.
+std::uint64_t BloomFilter::bit_index(const Layer &layer, Probe probe,
+                                     std::uint32_t i) {
+  const std::uint64_t mixed = probe.h1 + i * probe.h2;
+  return fast_range(mixed, layer.bits);
+}
+
+bool BloomFilter::layer_test(const Layer &layer, Probe probe) {
+  for (std::uint32_t i = 0; i < layer.hashes; ++i) {
+    const std::uint64_t bit = bit_index(layer, probe, i);
+    if ((layer.words[bit / 64] & (std::uint64_t{1} << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void BloomFilter::layer_set(Layer &layer, Probe probe) {
+  for (std::uint32_t i = 0; i < layer.hashes; ++i) {
+    const std::uint64_t bit = bit_index(layer, probe, i);
+    layer.words[bit / 64] |= std::uint64_t{1} << (bit % 64);
+  }
+}
+
+// Ask the CPU to start loading this item's words into cache NOW, so they're
+// ready by the time the batch loop reaches the item (no stall on RAM)
+void BloomFilter::prefetch(const Layer &layer, Probe probe) {
+  for (std::uint32_t i = 0; i < layer.hashes; ++i) {
+    __builtin_prefetch(&layer.words[bit_index(layer, probe, i) / 64]);
+  }
+}
+
+// =============================================================================
+// Single-item operations
+// =============================================================================
+bool BloomFilter::contains(Probe probe) const {
+  // Newest layer first: it's the biggest, so most hits land there
+  for (auto it = layers_.rbegin(); it != layers_.rend(); ++it) {
+    if (layer_test(*it, probe)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool BloomFilter::add(Probe probe) {
+  if (contains(probe)) {
+    return false;
+  }
+  if (layers_.back().count >= layers_.back().capacity) {
+    add_layer();
+  }
+  layer_set(layers_.back(), probe);
+  ++layers_.back().count;
+  ++count_;
+  return true;
+}
+
+bool BloomFilter::add(const std::string &item) { return add(probe_for(item)); }
+
+bool BloomFilter::contains(const std::string &item) const {
+  return contains(probe_for(item));
+}
+
+// =============================================================================
+// Batched operations — hash everything, then probe with prefetching
+// =============================================================================
+// Splitting the work into two passes lets the CPU overlap independent
+// hash computations, and the prefetch pass keeps ~PREFETCH_DISTANCE items'
+// cache misses in flight at once instead of one at a time.
+// =============================================================================
+std::vector<bool> BloomFilter::add_all(const std::vector<std::string> &items) {
+  std::vector<Probe> probes;
+  probes.reserve(items.size());
+  for (const auto &item : items) {
+    probes.push_back(probe_for(item));
+  }
+
+  std::vector<bool> added(items.size());
+  for (std::size_t i = 0; i < probes.size(); ++i) {
+    if (i + PREFETCH_DISTANCE < probes.size()) {
+      prefetch(layers_.back(), probes[i + PREFETCH_DISTANCE]);
+    }
+    added[i] = add(probes[i]);
+  }
+  return added;
+}
+
+std::vector<bool>
+BloomFilter::contains_all(const std::vector<std::string> &items) const {
+  std::vector<Probe> probes;
+  probes.reserve(items.size());
+  for (const auto &item : items) {
+    probes.push_back(probe_for(item));
+  }
+
+  std::vector<bool> found(items.size());
+  for (std::size_t i = 0; i < probes.size(); ++i) {
+    if (i + PREFETCH_DISTANCE < probes.size()) {
+      prefetch(layers_.back(), probes[i + PREFETCH_DISTANCE]);
+    }
+    found[i] = contains(probes[i]);
+  }
+  return found;
+}
+
+std::size_t BloomFilter::size() const { return count_; }
+
+bool BloomFilter::empty() const { return count_ == 0; }
+
+std::size_t BloomFilter::layer_count() const { return layers_.size(); }
+
+std::size_t BloomFilter::memory_bytes() const {
+  std::size_t bytes = 0;
+  for (const auto &layer : layers_) {
+    bytes += layer.words.size() * sizeof(std::uint64_t);
+  }
+  return bytes;
+}
+
+double BloomFilter::error_rate() const { return error_rate_; }
+
+// =============================================================================
+// Snapshot encoding
+// =============================================================================
+//   f64 error_rate | u64 initial_capacity | u64 count | u32 layers
+//   per layer: u64 bits | u32 hashes | u64 capacity | u64 count | words...
+// =============================================================================
+void BloomFilter::serialize(std::string &out) const {
+  put_f64(out, error_rate_);
+  put_u64(out, initial_capacity_);
+  put_u64(out, count_);
+  put_u32(out, static_cast<std::uint32_t>(layers_.size()));
+  for (const auto &layer : layers_) {
+    put_u64(out, layer.bits);
+    put_u32(out, layer.hashes);
+    put_u64(out, layer.capacity);
+    put_u64(out, layer.count);
+    put_u64_array(out, layer.words.data(), layer.words.size());
+  }
+}
+
+std::optional<BloomFilter> BloomFilter::deserialize(ByteReader &in) {
+  double error_rate = 0;
+  std::uint64_t initial_capacity = 0;
+  std::uint64_t count = 0;
+  std::uint32_t layer_count = 0;
+  if (!in.get_f64(error_rate) || !in.get_u64(initial_capacity) ||
+      !in.get_u64(count) || !in.get_u32(layer_count) || layer_count == 0 ||
+      !(error_rate > 0.0 && error_rate < 1.0) ||
+      initial_capacity > MAX_CAPACITY) {
+    return std::nullopt;
+  }
+
+  // Not the public constructor: its first layer would be sized from
+  // initial_capacity before any of the layers below are checked
+  BloomFilter filter(error_rate, initial_capacity, NoLayers{});
+  filter.count_ = count;
+
+  for (std::uint32_t n = 0; n < layer_count; ++n) {
+    Layer layer;
+    if (!in.get_u64(layer.bits) || !in.get_u32(layer.hashes) ||
+        !in.get_u64(layer.capacity) || !in.get_u64(layer.count) ||
+        layer.bits == 0 || layer.bits > MAX_LAYER_BITS || layer.hashes == 0 ||
+        layer.hashes > MAX_HASHES) {
+      return std::nullopt;
+    }
+    const std::uint64_t words = (layer.bits + 63) / 64;
+    if (in.remaining() / sizeof(std::uint64_t) < words) {
+      return std::nullopt;
+    }
+    layer.words.resize(words);
+    in.get_u64_array(layer.words.data(), words);
+    filter.layers_.push_back(std::move(layer));
+  }
+  return filter;
+}
+
+} // namespace mini_redis
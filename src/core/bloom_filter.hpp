@@ -0,0 +1,125 @@
+// =============================================================================
+// bloom_filter.hpp — Scalable Bloom Filter Value Type (HEADER)
+// =============================================================================
+//
+// A BLOOM FILTER answers "have I seen this item before?" using a few bits
+// per item, no matter how long the items are. The catch: it may say "yes"
+// for an item it never saw (a FALSE POSITIVE, at a rate you choose), but it
+// never says "no" for an item it did see. Perfect for dedup: "probably a
+// duplicate → check the database; definitely new → skip the lookup".
+//
+// HOW IT WORKS:
+// A bit array of m bits, all zero. To add an item, hash it to k positions
+// and set those bits. To check an item, test its k bits: any zero bit means
+// "definitely never added"; all ones means "probably added".
+//
+// DOUBLE HASHING:
+// We don't need k independent hash functions. From ONE 64-bit hash we take
+// two halves h1, h2 and use positions h1 + i*h2 (i = 0..k-1) — proven to
+// be as good as k independent hashes (Kirsch & Mitzenmacher). The k
+// positions are plain arithmetic with no dependency between them, so the
+// compiler can compute them all at once (vectorize) and the memory loads
+// they feed can be issued in parallel.
+//
+// SCALABLE:
+// A fixed-size filter degrades once it holds more items than planned.
+// Like RedisBloom, when the newest LAYER reaches its capacity we add a new
+// layer twice as big with a tighter error rate, so the overall false
+// positive rate stays bounded however many items arrive.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mini_redis {
+
+class BloomFilter {
+public:
+  // RedisBloom's defaults
+  static constexpr double DEFAULT_ERROR_RATE = 0.01;
+  static constexpr std::size_t DEFAULT_CAPACITY = 100;
+
+  // Limits on what a client or a (possibly corrupted) encoding may ask
+  // for: an initial capacity, and the bits of any one layer (8 GB)
+  static constexpr std::uint64_t MAX_CAPACITY = 1'000'000'000;
+  static constexpr std::uint64_t MAX_LAYER_BITS = std::uint64_t{1} << 36;
+
+  explicit BloomFilter(double error_rate = DEFAULT_ERROR_RATE,
+                       std::size_t initial_capacity = DEFAULT_CAPACITY);
+
+  // ---- Batched operations (BF.MADD / BF.MEXISTS) ----
+  // One result per item, in order. add_all() reports true for items that
+  // were NOT already (probably) present.
+  // ---- first_layer_bits() — What the constructor would allocate ----
+  // As a double, so it can be checked before anything is built: a tiny
+  // error rate makes it larger than any integer.
+  static double first_layer_bits(double error_rate,
+                                 std::size_t initial_capacity);
+
+  std::vector<bool> add_all(const std::vector<std::string> &items);
+  std::vector<bool> contains_all(const std::vector<std::string> &items) const;
+
+  bool add(const std::string &item);
+  bool contains(const std::string &item) const;
+
+  // Number of items added (duplicates are not counted)
+  std::size_t size() const;
+  bool empty() const;
+
+  std::size_t layer_count() const;
+  std::size_t memory_bytes() const;
+  double error_rate() const;
+
+  // ---- Snapshot support ----
+  void serialize(std::string &out) const;
+  static std::optional<BloomFilter> deserialize(ByteReader &in);
+
+private:
+  // Each new layer is this much bigger, with this much smaller error rate
+  static constexpr std::size_t GROWTH = 2;
+  static constexpr double TIGHTENING = 0.5;
+
+  struct Layer {
+    std::vector<std::uint64_t> words; // the bit array, 64 bits per word
+    std::uint64_t bits = 0;           // number of usable bits (m)
+    std::uint32_t hashes = 0;         // probes per item (k)
+    std::uint64_t capacity = 0;       // items before the next layer starts
+    std::uint64_t count = 0;          // items added to this layer
+  };
+
+  // The two halves of an item's hash, computed once and reused for every
+  // probe in every layer
+  struct Probe {
+    std::uint64_t h1;
+    std::uint64_t h2;
+  };
+
+  static Probe probe_for(const std::string &item);
+  static std::uint64_t bit_index(const Layer &layer, Probe probe,
+                                 std::uint32_t i);
+  static bool layer_test(const Layer &layer, Probe probe);
+  static void layer_set(Layer &layer, Probe probe);
+  static void prefetch(const Layer &layer, Probe probe);
+
+  bool contains(Probe probe) const;
+  bool add(Probe probe);
+  void add_layer();
+
+  // For deserialize(): the settings only, the layers come from the bytes
+  struct NoLayers {};
+  BloomFilter(double error_rate, std::size_t initial_capacity, NoLayers);
+
+  double error_rate_;
+  std::size_t initial_capacity_;
+  std::size_t count_ = 0;
+  std::vector<Layer> layers_;
+};
+
+} // namespace mini_redis
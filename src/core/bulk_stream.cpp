@@ -0,0 +1,326 @@
+// =============================================================================
+// bulk_stream.cpp — Moving the Whole Store In and Out (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/bulk_stream.hpp"
+#include "core/snapshot.hpp"
+#include "util/byte_codec.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm> // std::clamp, std::min
+#include <chrono>
+#include <utility>
+
+namespace mini_redis {
+
+namespace {
+
+constexpr std::string_view MAGIC = "MRBULK01";
+constexpr std::size_t COUNT_OFFSET = MAGIC.size();
+constexpr std::size_t HEADER_BYTES = MAGIC.size() + sizeof(std::uint64_t);
+constexpr std::size_t LENGTH_BYTES = sizeof(std::uint32_t);
+constexpr std::size_t DEFAULT_MAX_WORKERS = 4;
+
+// Lengths and counts are only known once their record is written: a
+// placeholder goes out first and is overwritten here, little-endian like
+// put_u32() / put_u64()
+template <typename T>
+void patch(std::string &out, std::size_t at, T value) {
+  for (std::size_t i = 0; i < sizeof(T); ++i) {
+    out[at + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+}
+
+std::uint32_t read_u32(std::string_view bytes) {
+  ByteReader reader(bytes);
+  std::uint32_t value = 0;
+  reader.get_u32(value);
+  return value;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// encode_bulk_export()
+// =============================================================================
+// The one chunk buffer is reserved a little above 'chunk_bytes' up front:
+// it is written out at the first record that takes it past the mark, so
+// it never has to grow (and copy itself) unless one record is huge. After
+// a failed write the walk still runs to the end (for_each_entry() can't
+// stop early) but encodes nothing more.
+// =============================================================================
+std::optional<std::size_t> encode_bulk_export(const KeyValueStore &store,
+                                              std::size_t chunk_bytes,
+                                              std::FILE *out) {
+  const auto now = std::chrono::steady_clock::now();
+  const long start = std::ftell(out);
+  std::size_t records = 0;
+  bool ok = start >= 0;
+
+  std::string chunk;
+  chunk.reserve(chunk_bytes + chunk_bytes / 4);
+  chunk += MAGIC;
+  put_u64(chunk, 0); // the record count, patched in at the end
+  const auto write_chunk = [&] {
+    ok = ok && std::fwrite(chunk.data(), 1, chunk.size(), out) == chunk.size();
+    chunk.clear();
+  };
+
+  store.for_each_entry([&](const std::string &key, const StoreEntry &entry) {
+    if (!ok) {
+      return;
+    }
+    const std::size_t at = chunk.size();
+    put_u32(chunk, 0);
+    encode_snapshot_entry(chunk, key, entry, now);
+    patch(chunk, at,
+          static_cast<std::uint32_t>(chunk.size() - at - LENGTH_BYTES));
+    ++records;
+    if (chunk.size() >= chunk_bytes) {
+      write_chunk();
+    }
+  });
+
+  put_u32(chunk, 0); // end marker
+  write_chunk();
+
+  std::string count;
+  put_u64(count, static_cast<std::uint64_t>(records));
+  ok = ok && std::fseek(out, start + static_cast<long>(COUNT_OFFSET),
+                        SEEK_SET) == 0;
+  ok = ok && std::fwrite(count.data(), 1, count.size(), out) == count.size();
+  ok = ok && std::fseek(out, 0, SEEK_END) == 0 && std::fflush(out) == 0;
+  if (!ok) {
+    return std::nullopt;
+  }
+  return records;
+}
+
+// =============================================================================
+// BulkImporter — construction and teardown
+// =============================================================================
+BulkImporter::BulkImporter(KeyValueStore &store, std::size_t workers)
+    : store_(store) {
+  if (workers == 0) {
+    workers = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1,
+                                      DEFAULT_MAX_WORKERS);
+  }
+  batches_.resize(workers);
+  for (std::size_t i = 0; i < workers; ++i) {
+    auto worker = std::make_unique<Worker>();
+    Worker *raw = worker.get();
+    workers_.push_back(std::move(worker));
+    raw->thread = std::thread([this, raw] { work(*raw); });
+  }
+}
+
+BulkImporter::~BulkImporter() { finish(); }
+
+std::string BulkImporter::error() const {
+  std::lock_guard<std::mutex> lock(error_mutex_);
+  return error_;
+}
+
+// The first reason wins; every worker is woken so that a feed() waiting
+// for room notices and stops
+void BulkImporter::fail(const std::string &why) {
+  {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (error_.empty()) {
+      error_ = why;
+    }
+  }
+  failed_.store(true);
+  for (const auto &worker : workers_) {
+    { std::lock_guard<std::mutex> lock(worker->mutex); }
+    worker->changed.notify_all();
+  }
+}
+
+// =============================================================================
+// feed() / consume() — Framing records as the bytes arrive
+// =============================================================================
+// Complete records are framed straight out of the caller's bytes; only a
+// record cut off at the end of a piece is copied into pending_, to be
+// completed by the next one.
+// =============================================================================
+bool BulkImporter::feed(std::string_view bytes) {
+  if (finished_) {
+    fail("data after the stream was finished");
+  }
+  if (failed_.load() || bytes.empty()) {
+    return !failed_.load();
+  }
+
+  if (pending_.empty()) {
+    const std::size_t used = consume(bytes);
+    pending_.assign(bytes.substr(used));
+  } else {
+    pending_.append(bytes);
+    const std::size_t used = consume(pending_);
+    pending_.erase(0, used);
+  }
+  return !failed_.load();
+}
+
+std::size_t BulkImporter::consume(std::string_view data) {
+  if (end_seen_) {
+    fail("data after the end marker");
+    return data.size();
+  }
+
+  std::size_t pos = 0;
+  if (!header_done_) {
+    if (data.size() < HEADER_BYTES) {
+      return 0;
+    }
+    if (data.substr(0, MAGIC.size()) != MAGIC) {
+      fail("not a bulk stream (bad magic)");
+      return data.size();
+    }
+    ByteReader header(data.substr(COUNT_OFFSET, sizeof(std::uint64_t)));
+    std::uint64_t count = 0;
+    header.get_u64(count);
+    store_.reserve(static_cast<std::size_t>(std::min(count, MAX_RESERVE)));
+    header_done_ = true;
+    pos = HEADER_BYTES;
+  }
+
+  while (!failed_.load() && data.size() - pos >= LENGTH_BYTES) {
+    const std::uint32_t length = read_u32(data.substr(pos, LENGTH_BYTES));
+    if (length == 0) {
+      end_seen_ = true;
+      if (pos + LENGTH_BYTES != data.size()) {
+        fail("data after the end marker");
+      }
+      return data.size();
+    }
+    if (length > MAX_RECORD_BYTES) {
+      fail("record " + std::to_string(records_ + 1) + ": " +
+           std::to_string(length) + " bytes, over the limit of " +
+           std::to_string(MAX_RECORD_BYTES));
+      return data.size();
+    }
+    if (data.size() - pos - LENGTH_BYTES < length) {
+      break; // the rest of this record is still on its way
+    }
+
+    // Only the key is read here, to pick the worker; decoding the value
+    // is the workers' job
+    ByteReader record(data.substr(pos + LENGTH_BYTES, length));
+    std::uint8_t tag = 0;
+    std::uint32_t key_length = 0;
+    std::string_view key;
+    if (!record.get_u8(tag) || !record.get_u32(key_length) ||
+        !record.get_raw(key_length, key)) {
+      fail("record " + std::to_string(records_ + 1) + ": truncated key");
+      return data.size();
+    }
+
+    const std::size_t worker = hash64(key) % workers_.size();
+    batches_[worker].append(data.substr(pos, LENGTH_BYTES + length));
+    ++records_;
+    if (batches_[worker].size() >= BATCH_BYTES) {
+      send(worker);
+    }
+    pos += LENGTH_BYTES + length;
+  }
+  return pos;
+}
+
+// Hands the worker its batch, waiting while its queue is full
+void BulkImporter::send(std::size_t index) {
+  Worker &worker = *workers_[index];
+  {
+    std::unique_lock<std::mutex> lock(worker.mutex);
+    worker.changed.wait(lock, [this, &worker] {
+      return worker.queue.size() < MAX_QUEUED || failed_.load();
+    });
+    if (!failed_.load()) {
+      worker.queue.push_back(std::move(batches_[index]));
+    }
+  }
+  worker.changed.notify_all();
+  batches_[index] = std::string();
+}
+
+// =============================================================================
+// work() — One worker: decode batches, store them
+// =============================================================================
+// After a failure the worker keeps draining its queue without storing,
+// so finish() never waits on a batch nobody will take.
+// =============================================================================
+void BulkImporter::work(Worker &worker) {
+  while (true) {
+    std::string batch;
+    {
+      std::unique_lock<std::mutex> lock(worker.mutex);
+      worker.changed.wait(
+          lock, [&worker] { return !worker.queue.empty() || worker.closing; });
+      if (worker.queue.empty()) {
+        return; // closing, and nothing left
+      }
+      batch = std::move(worker.queue.front());
+      worker.queue.pop_front();
+    }
+    worker.changed.notify_all(); // room for feed()
+    if (failed_.load()) {
+      continue;
+    }
+
+    // TTLs count from the moment the batch is stored
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<std::pair<std::string, StoreEntry>> entries;
+    ByteReader in(batch);
+    std::uint32_t length = 0;
+    std::string_view bytes;
+    while (in.get_u32(length) && in.get_raw(length, bytes)) {
+      ByteReader record(bytes);
+      std::uint8_t tag = 0;
+      std::string key;
+      StoreEntry entry;
+      if (!record.get_u8(tag) ||
+          !decode_snapshot_entry(record, tag, key, entry, now) ||
+          !record.at_end()) {
+        fail("malformed record for key '" + key + "'");
+        break;
+      }
+      entries.emplace_back(std::move(key), std::move(entry));
+    }
+    store_.restore_many(std::move(entries));
+  }
+}
+
+// =============================================================================
+// finish()
+// =============================================================================
+bool BulkImporter::finish() {
+  if (finished_) {
+    return !failed_.load();
+  }
+  finished_ = true;
+
+  for (std::size_t i = 0; i < workers_.size(); ++i) {
+    if (!batches_[i].empty()) {
+      send(i);
+    }
+  }
+  for (const auto &worker : workers_) {
+    {
+      std::lock_guard<std::mutex> lock(worker->mutex);
+      worker->closing = true;
+    }
+    worker->changed.notify_all();
+  }
+  for (const auto &worker : workers_) {
+    worker->thread.join();
+  }
+
+  if (!failed_.load() && !end_seen_) {
+    fail(header_done_ ? "stream ended before its end marker"
+                      : "stream ended before its header");
+  }
+  return !failed_.load();
+}
+
+} // namespace mini_redis
@@ -0,0 +1,150 @@
+// =============================================================================
+// bulk_stream.hpp — Moving the Whole Store In and Out as One Stream (HEADER)
+// =============================================================================
+//
+// Loading a dataset key by key costs one HTTP request (connection, parse,
+// route, reply) per key — millions of round trips for a few hundred MB.
+// The bulk stream carries all of them in ONE request body:
+//
+// STREAM FORMAT (all integers little-endian, see util/byte_codec.hpp):
+//   "MRBULK01"                           8-byte magic + version
+//   u64 record count                     a sizing hint; 0 = unknown
+//   per key: u32 length | record         'length' = bytes of the record
+//     record = u8 type | bytes key | u64 ttl_ms | value payload
+//   u32 0                                end marker
+//
+// A record is exactly one snapshot entry (see snapshot.hpp), so every
+// value type travels, and a plain string is simply
+//   u8 0 | u32 key length | key | u64 ttl_ms | u32 value length | value
+// with ttl_ms = UINT64_MAX for "no expiry".
+//
+// WHY THE LENGTH PREFIX?
+// A snapshot is decoded from a complete file. A stream arrives in pieces
+// of whatever size the network delivers, and the length tells the reader
+// whether the next record is complete BEFORE decoding any of it — and
+// lets the decoding itself be handed to other threads (see BulkImporter).
+//
+// No checksum: TCP already checks the bytes in flight, and a cut-off
+// stream is caught by the missing end marker.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio> // std::FILE
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace mini_redis {
+
+// =============================================================================
+// encode_bulk_export() — The whole store as a bulk stream, into a file
+// =============================================================================
+// One point-in-time view of the store (for_each_entry(): both tables'
+// read locks at once, the view a snapshot takes) is encoded and written
+// to 'out' about 'chunk_bytes' at a time: the process never holds more
+// than one chunk, however large the store. Writers wait while the view
+// is encoded — at the speed of the disk cache, never the client's — and
+// the caller sends the file afterwards with no lock held.
+//
+// 'out' is written from its current position; the record count in the
+// header is patched in at the end, and 'out' is left positioned after
+// the end marker. Returns the number of records, or std::nullopt if
+// writing 'out' failed.
+// =============================================================================
+std::optional<std::size_t> encode_bulk_export(const KeyValueStore &store,
+                                              std::size_t chunk_bytes,
+                                              std::FILE *out);
+
+// =============================================================================
+// BulkImporter — Stores a bulk stream as it arrives
+// =============================================================================
+// feed() takes the stream in pieces of any size. It only FRAMES records:
+// each complete one is copied into the batch of the worker its key hashes
+// to. The workers decode their batches and store them with restore_many(),
+// in parallel with each other and with the next read from the network.
+//
+// Hashing keys to workers keeps every key's records in stream order, so if
+// a key appears twice the later value wins, as it would key by key. When
+// workers fall behind, feed() waits for room (MAX_QUEUED batches each):
+// memory stays bounded however fast the client sends.
+//
+// The record count in the header pre-sizes the store's shards (reserve()),
+// so a large import doesn't rehash every table over and over on the way.
+//
+// NOT ATOMIC: records are stored as they arrive, so a stream that turns
+// out to be malformed halfway leaves the records before the fault stored.
+// =============================================================================
+class BulkImporter {
+public:
+  static constexpr std::size_t BATCH_BYTES = 256 * 1024;
+  static constexpr std::size_t MAX_QUEUED = 4;
+  // A header can claim any count; pre-size for at most this many
+  static constexpr std::uint64_t MAX_RESERVE = 1u << 26;
+  // A length prefix can claim up to 4 GB, and the import route has no
+  // body limit: a record longer than this fails the stream as soon as
+  // its prefix is read, instead of being buffered. Twice the largest
+  // request body, so any value a client could SET fits.
+  static constexpr std::uint32_t MAX_RECORD_BYTES = 512u << 20;
+
+  // 0 workers = one per core, at most 4
+  explicit BulkImporter(KeyValueStore &store, std::size_t workers = 0);
+  ~BulkImporter(); // finish()es, if the caller didn't
+
+  BulkImporter(const BulkImporter &) = delete;
+  BulkImporter &operator=(const BulkImporter &) = delete;
+
+  // The next piece of the stream. False once the stream is known to be
+  // malformed (error() says why); later pieces are ignored.
+  bool feed(std::string_view bytes);
+
+  // Waits until every record fed so far is stored. False if the stream
+  // was malformed, or ended without its end marker.
+  bool finish();
+
+  std::size_t records() const { return records_; }
+  std::string error() const;
+
+private:
+  struct Worker {
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::string> queue; // batches of framed records
+    bool closing = false;
+    std::thread thread;
+  };
+
+  // Frames as many complete records from 'data' as there are; returns
+  // the bytes consumed, or fails the import
+  std::size_t consume(std::string_view data);
+  void send(std::size_t worker);
+  void work(Worker &worker);
+  void fail(const std::string &why);
+
+  KeyValueStore &store_;
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::string> batches_; // one being filled per worker
+
+  std::string pending_; // an incomplete record, carried to the next feed()
+  bool header_done_ = false;
+  bool end_seen_ = false;
+  bool finished_ = false;
+  std::size_t records_ = 0;
+
+  std::atomic<bool> failed_{false};
+  mutable std::mutex error_mutex_;
+  std::string error_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,59 @@
+// =============================================================================
+// compressed_string.cpp — String Values Stored Compressed (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/compressed_string.hpp"
+#include "util/lz4.hpp"
+
+#include <utility> // std::move
+
+namespace mini_redis {
+
+const char *content_encoding(ValueCodec codec) {
+  switch (codec) {
+  case ValueCodec::LZ4:
+    return "lz4";
+  case ValueCodec::NONE:
+    break;
+  }
+  return "";
+}
+
+std::optional<CompressedString> compress_string(std::string_view raw) {
+  CompressedString value;
+  value.bytes = lz4::compress(raw);
+  if (value.bytes.size() > raw.size() / 8 * 7) {
+    return std::nullopt;
+  }
+  value.bytes.shrink_to_fit(); // compress() reserved for the worst case
+  return value;
+}
+
+std::optional<std::string> decompress_string(ValueCodec codec,
+                                             std::string_view bytes) {
+  switch (codec) {
+  case ValueCodec::NONE:
+    return std::string(bytes);
+  case ValueCodec::LZ4:
+    return lz4::decompress(bytes);
+  }
+  return std::nullopt;
+}
+
+std::string expand(const CompressedString &value) {
+  return decompress_string(value.codec, value.bytes).value_or(std::string());
+}
+
+// A full decode: the snapshot checksum catches corruption on disk, but
+// not a file written by a buggy encoder, and a bad frame found at load
+// time is far better than one found by a GET.
+std::optional<CompressedString> load_compressed(std::uint8_t codec,
+                                                std::string bytes) {
+  const auto typed = static_cast<ValueCodec>(codec);
+  if (typed != ValueCodec::LZ4 || !decompress_string(typed, bytes)) {
+    return std::nullopt;
+  }
+  return CompressedString{typed, std::move(bytes)};
+}
+
+} // namespace mini_redis
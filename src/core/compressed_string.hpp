@@ -0,0 +1,69 @@
+// =============================================================================
+// compressed_string.hpp — String Values Stored Compressed (HEADER)
+// =============================================================================
+//
+// WHY COMPRESS IN THE STORE?
+// Large text values (JSON documents, rendered HTML, log batches) are
+// mostly redundancy. Keeping them LZ4-compressed (util/lz4.hpp) typically
+// cuts their memory 3-5x, for a few hundred microseconds per MB on SET
+// and less on GET. Small values are left alone: the frame header and a
+// hash table pass cost more than a few bytes could save.
+//
+// THE PER-ENTRY CODEC FLAG:
+// Every CompressedString records the codec its bytes are in. The store
+// never has to guess, and a future codec (zstd for cold data, say) can
+// live next to LZ4 entries without a migration.
+//
+// PASS-THROUGH:
+// The bytes are a standard LZ4 frame, so a client that sends
+// "Accept-Encoding: lz4" can be given them as-is — no decompression on
+// the server at all, and fewer bytes on the wire.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mini_redis {
+
+// ---- ValueCodec — How a string value's bytes are encoded ----
+// The numbers are written to snapshots; never renumber.
+enum class ValueCodec : std::uint8_t {
+  NONE = 0, // the bytes are the value
+  LZ4 = 1,  // one LZ4 frame
+};
+
+// ---- The HTTP Content-Encoding token for a codec ("" for NONE) ----
+const char *content_encoding(ValueCodec codec);
+
+struct CompressedString {
+  ValueCodec codec = ValueCodec::LZ4;
+  std::string bytes;
+};
+
+// ---- compress_string() — 'raw' compressed, if that is worth keeping ----
+// std::nullopt unless the result is at most 7/8 of the input: a value
+// that barely shrinks would pay the decompression on every read for
+// almost no memory.
+std::optional<CompressedString> compress_string(std::string_view raw);
+
+// ---- decompress_string() — The original bytes ----
+// std::nullopt if 'bytes' isn't valid data for 'codec'.
+std::optional<std::string> decompress_string(ValueCodec codec,
+                                             std::string_view bytes);
+
+// ---- expand() — decompress_string() for a value the store holds ----
+// Stored values were produced by compress_string() or checked when a
+// snapshot was loaded, so this can't fail in practice; an empty string
+// is returned if it somehow does.
+std::string expand(const CompressedString &value);
+
+// ---- load_compressed() — Validate bytes read from a snapshot ----
+std::optional<CompressedString> load_compressed(std::uint8_t codec,
+                                                std::string bytes);
+
+} // namespace mini_redis
@@ -0,0 +1,160 @@
+// =============================================================================
+// count_min_sketch.cpp — Count-Min Sketch Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/count_min_sketch.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm> // std::max, std::min
+#include <cmath>     // std::ceil, std::exp, std::log
+#include <limits>
+
+namespace mini_redis {
+
+namespace {
+
+constexpr std::uint64_t CMS_HASH_SEED = 0xc2b2ae3d27d4eb4fULL;
+
+} // anonymous namespace
+
+CountMinSketch::CountMinSketch(std::size_t width, std::size_t depth)
+    : width_(std::max<std::size_t>(width, 1)),
+      depth_(std::max<std::size_t>(depth, 1)),
+      counters_(width_ * depth_, 0) {}
+
+bool CountMinSketch::fits(std::uint64_t width, std::uint64_t depth,
+                          std::uint64_t max_counters) {
+  return width <= max_counters &&
+         (width == 0 || depth <= max_counters / width);
+}
+
+// Compared as doubles before the casts: a tiny epsilon makes the width
+// larger than any integer (1e-300 → 3e300), and casting that is undefined
+std::optional<CountMinSketch>
+CountMinSketch::from_error(double epsilon, double delta,
+                           std::uint64_t max_counters) {
+  const double width = std::ceil(std::exp(1.0) / epsilon);
+  const double depth = std::ceil(std::log(1.0 / delta));
+  const auto limit = static_cast<double>(max_counters);
+  if (!(width <= limit && depth <= limit) ||
+      !fits(static_cast<std::uint64_t>(width),
+            static_cast<std::uint64_t>(depth), max_counters)) {
+    return std::nullopt;
+  }
+  return CountMinSketch(static_cast<std::size_t>(width),
+                        static_cast<std::size_t>(depth));
+}
+
+// =============================================================================
+// Hashing — one hash per item, one column per row via h1 + row * h2
+// =============================================================================
+CountMinSketch::Probe CountMinSketch::probe_for(const std::string &item) {
+  const std::uint64_t hash = hash64(item, CMS_HASH_SEED);
+  return Probe{hash, (hash * 0xff51afd7ed558ccdULL) | 1};
+}
+
+std::size_t CountMinSketch::cell(Probe probe, std::size_t row) const {
+  const std::uint64_t mixed = probe.h1 + row * probe.h2;
+  const auto column = static_cast<std::size_t>(fast_range(mixed, width_));
+  return row * width_ + column;
+}
+
+// =============================================================================
+// increment() / query()
+// =============================================================================
+std::uint64_t CountMinSketch::increment(Probe probe, std::uint64_t by) {
+  std::uint64_t estimate = std::numeric_limits<std::uint64_t>::max();
+  for (std::size_t row = 0; row < depth_; ++row) {
+    std::uint64_t &counter = counters_[cell(probe, row)];
+    counter += by;
+    estimate = std::min(estimate, counter);
+  }
+  total_ += by;
+  return estimate;
+}
+
+std::uint64_t CountMinSketch::query(Probe probe) const {
+  std::uint64_t estimate = std::numeric_limits<std::uint64_t>::max();
+  for (std::size_t row = 0; row < depth_; ++row) {
+    estimate = std::min(estimate, counters_[cell(probe, row)]);
+  }
+  return estimate;
+}
+
+std::uint64_t CountMinSketch::increment(const std::string &item,
+                                        std::uint64_t by) {
+  return increment(probe_for(item), by);
+}
+
+std::uint64_t CountMinSketch::query(const std::string &item) const {
+  return query(probe_for(item));
+}
+
+// =============================================================================
+// Batched operations — hash the whole batch first, then touch counters
+// =============================================================================
+std::vector<std::uint64_t> CountMinSketch::increment_all(
+    const std::vector<std::pair<std::string, std::uint64_t>> &items) {
+  std::vector<Probe> probes;
+  probes.reserve(items.size());
+  for (const auto &item : items) {
+    probes.push_back(probe_for(item.first));
+  }
+
+  std::vector<std::uint64_t> estimates;
+  estimates.reserve(items.size());
+  for (std::size_t i = 0; i < items.size(); ++i) {
+    estimates.push_back(increment(probes[i], items[i].second));
+  }
+  return estimates;
+}
+
+std::vector<std::uint64_t>
+CountMinSketch::query_all(const std::vector<std::string> &items) const {
+  std::vector<Probe> probes;
+  probes.reserve(items.size());
+  for (const auto &item : items) {
+    probes.push_back(probe_for(item));
+  }
+
+  std::vector<std::uint64_t> estimates;
+  estimates.reserve(items.size());
+  for (const Probe probe : probes) {
+    estimates.push_back(query(probe));
+  }
+  return estimates;
+}
+
+std::size_t CountMinSketch::width() const { return width_; }
+
+std::size_t CountMinSketch::depth() const { return depth_; }
+
+std::uint64_t CountMinSketch::total() const { return total_; }
+
+// =============================================================================
+// Snapshot encoding: u64 width | u64 depth | u64 total | counters...
+// =============================================================================
+void CountMinSketch::serialize(std::string &out) const {
+  put_u64(out, width_);
+  put_u64(out, depth_);
+  put_u64(out, total_);
+  put_u64_array(out, counters_.data(), counters_.size());
+}
+
+std::optional<CountMinSketch> CountMinSketch::deserialize(ByteReader &in) {
+  std::uint64_t width = 0;
+  std::uint64_t depth = 0;
+  std::uint64_t total = 0;
+  if (!in.get_u64(width) || !in.get_u64(depth) || !in.get_u64(total) ||
+      width == 0 || depth == 0 || !fits(width, depth) ||
+      in.remaining() / sizeof(std::uint64_t) < width * depth) {
+    return std::nullopt;
+  }
+
+  CountMinSketch sketch(width, depth);
+  sketch.total_ = total;
+  in.get_u64_array(sketch.counters_.data(), sketch.counters_.size());
+  return sketch;
+}
+
+} // namespace mini_redis
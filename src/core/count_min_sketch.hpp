@@ -0,0 +1,105 @@
+// =============================================================================
+// count_min_sketch.hpp — Count-Min Sketch Value Type (HEADER)
+// =============================================================================
+//
+// A COUNT-MIN SKETCH estimates "how many times have I seen X?" for an
+// unbounded stream of items in FIXED memory — the frequency counterpart of
+// a Bloom filter. Typical uses: heavy hitters, per-IP request counts, hot
+// keys.
+//
+// HOW IT WORKS:
+// A grid of counters, DEPTH rows by WIDTH columns. Each row hashes an item
+// to one column. Incrementing bumps one counter per row; querying returns
+// the MINIMUM of the item's counters.
+//
+// Collisions can only ADD to a counter, never subtract, so every row
+// OVER-estimates — and the minimum is the least-polluted row. With
+//   width = ceil(e / epsilon)   and   depth = ceil(ln(1 / delta))
+// the estimate exceeds the true count by more than epsilon * (total of all
+// increments) with probability at most delta.
+//
+// Row columns come from the same double hashing as the Bloom filter
+// (h1 + row * h2), so one hash per item serves every row.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini_redis {
+
+class CountMinSketch {
+public:
+  // Defaults: epsilon ≈ 0.0014, delta ≈ 0.7% — 78 KB of counters
+  static constexpr std::size_t DEFAULT_WIDTH = 2000;
+  static constexpr std::size_t DEFAULT_DEPTH = 5;
+
+  explicit CountMinSketch(std::size_t width = DEFAULT_WIDTH,
+                          std::size_t depth = DEFAULT_DEPTH);
+
+  // Counters allowed when loading or sizing a sketch (1 GB of uint64)
+  static constexpr std::uint64_t MAX_COUNTERS = std::uint64_t{1} << 27;
+
+  // ---- fits() — width × depth ≤ max_counters, without overflowing ----
+  static bool fits(std::uint64_t width, std::uint64_t depth,
+                   std::uint64_t max_counters = MAX_COUNTERS);
+
+  // ---- from_error() — Size the sketch from accuracy targets ----
+  // epsilon: error bound as a fraction of the total count
+  // delta:   probability of exceeding that bound
+  // std::nullopt if that takes more than 'max_counters' counters: the
+  // size is checked before anything is allocated.
+  static std::optional<CountMinSketch>
+  from_error(double epsilon, double delta,
+             std::uint64_t max_counters = MAX_COUNTERS);
+
+  // ---- Batched operations (CMS.INCRBY / CMS.QUERY) ----
+  // increment_all() returns each item's estimate AFTER its increment.
+  std::vector<std::uint64_t> increment_all(
+      const std::vector<std::pair<std::string, std::uint64_t>> &items);
+  std::vector<std::uint64_t>
+  query_all(const std::vector<std::string> &items) const;
+
+  std::uint64_t increment(const std::string &item, std::uint64_t by = 1);
+  std::uint64_t query(const std::string &item) const;
+
+  std::size_t width() const;
+  std::size_t depth() const;
+
+  // Sum of all increments (the "N" the error bound is relative to)
+  std::uint64_t total() const;
+
+  // ---- Snapshot support ----
+  void serialize(std::string &out) const;
+  static std::optional<CountMinSketch> deserialize(ByteReader &in);
+
+private:
+  struct Probe {
+    std::uint64_t h1;
+    std::uint64_t h2;
+  };
+
+  static Probe probe_for(const std::string &item);
+
+  // Index into counters_ of the item's counter in 'row'
+  std::size_t cell(Probe probe, std::size_t row) const;
+
+  std::uint64_t increment(Probe probe, std::uint64_t by);
+  std::uint64_t query(Probe probe) const;
+
+  std::size_t width_;
+  std::size_t depth_;
+  std::uint64_t total_ = 0;
+
+  // Row-major: counters_[row * width_ + column]
+  std::vector<std::uint64_t> counters_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,161 @@
+// =============================================================================
+// defragmenter.cpp — Background Active Defragmentation (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/defragmenter.hpp"
+#include "util/allocator.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+namespace mini_redis {
+
+namespace {
+
+// Buckets per relocate() call: a few microseconds under one shard lock
+constexpr std::size_t BUCKETS_PER_STEP = 64;
+constexpr std::chrono::milliseconds SLICE{1};
+
+std::string format_ratio(double ratio) {
+  char text[32];
+  std::snprintf(text, sizeof(text), "%.2f", ratio);
+  return text;
+}
+
+} // anonymous namespace
+
+Defragmenter::Defragmenter(KeyValueStore &store, DefragOptions options)
+    : store_(store), options_(options) {}
+
+Defragmenter::~Defragmenter() { stop(); }
+
+void Defragmenter::start() {
+  stop_requested_.store(false);
+  thread_ = std::thread(&Defragmenter::defrag_loop, this);
+  Logger::info("Defragmenter started (start above " +
+               format_ratio(options_.start_ratio) + ", stop below " +
+               format_ratio(options_.stop_ratio) + ", " +
+               std::to_string(options_.cpu_percent) + "% CPU)");
+}
+
+void Defragmenter::stop() {
+  if (!thread_.joinable()) {
+    return;
+  }
+  stop_requested_.store(true);
+  sleep_cv_.notify_all();
+  thread_.join();
+  active_.store(false);
+  Logger::info("Defragmenter stopped");
+}
+
+double Defragmenter::fragmentation_ratio() {
+  const auto stats = Allocator::stats();
+  if (stats.arena_live_bytes == 0) {
+    return 1.0;
+  }
+  return static_cast<double>(stats.arena_slab_bytes) /
+         static_cast<double>(stats.arena_live_bytes);
+}
+
+DefragStats Defragmenter::stats() const {
+  DefragStats stats;
+  stats.active = active_.load();
+  stats.fragmentation_ratio = fragmentation_ratio();
+  stats.runs = runs_.load();
+  stats.passes = passes_.load();
+  stats.visited = visited_.load();
+  stats.moved = moved_.load();
+  return stats;
+}
+
+// =============================================================================
+// should_start() — Is there enough waste to be worth a run?
+// =============================================================================
+bool Defragmenter::should_start() const {
+  const auto stats = Allocator::stats();
+  if (stats.arena_live_bytes == 0) {
+    return false;
+  }
+  const std::uint64_t waste = stats.arena_slab_bytes - stats.arena_live_bytes;
+  return waste >= options_.min_waste_bytes &&
+         static_cast<double>(stats.arena_slab_bytes) >
+             options_.start_ratio * static_cast<double>(stats.arena_live_bytes);
+}
+
+std::uint64_t Defragmenter::run_pass() {
+  // Blocks parked in thread caches count as live to the arena; hand them
+  // back first, or their slabs look fuller than they are
+  Allocator::purge();
+  std::uint64_t moved = 0;
+  std::size_t cursor = 0;
+  do {
+    const auto step = store_.defrag_step(cursor, BUCKETS_PER_STEP);
+    visited_ += step.visited;
+    moved += step.moved;
+    cursor = step.cursor;
+  } while (cursor != 0);
+  moved_ += moved;
+  ++passes_;
+  return moved;
+}
+
+// =============================================================================
+// defrag_loop() — Idle checks, then budgeted slices while active
+// =============================================================================
+// CPU BUDGET: after working for SLICE, sleep SLICE * (100 - p) / p. At
+// 10% that is 1 ms on, 9 ms off — clients see at most one shard locked
+// for a few microseconds at a time, and the machine sees 10% of a core.
+// =============================================================================
+void Defragmenter::defrag_loop() {
+  const int percent = std::clamp(options_.cpu_percent, 1, 100);
+  const auto pause = SLICE * (100 - percent) / percent;
+
+  std::size_t cursor = 0;
+  std::uint64_t moved_this_pass = 0;
+
+  while (!stop_requested_.load()) {
+    auto wait = options_.check_interval;
+
+    if (!active_.load()) {
+      if (should_start()) {
+        active_.store(true);
+        ++runs_;
+        cursor = 0;
+        moved_this_pass = 0;
+        Allocator::purge();
+        Logger::info("Defragmentation started (ratio " +
+                     format_ratio(fragmentation_ratio()) + ")");
+        wait = std::chrono::milliseconds(0);
+      }
+    } else {
+      const auto slice_end = std::chrono::steady_clock::now() + SLICE;
+      do {
+        const auto step = store_.defrag_step(cursor, BUCKETS_PER_STEP);
+        visited_ += step.visited;
+        moved_ += step.moved;
+        moved_this_pass += step.moved;
+        cursor = step.cursor;
+      } while (cursor != 0 && std::chrono::steady_clock::now() < slice_end);
+
+      if (cursor == 0) {
+        ++passes_;
+        const double ratio = fragmentation_ratio();
+        if (ratio < options_.stop_ratio || moved_this_pass == 0) {
+          active_.store(false);
+          Logger::info("Defragmentation finished (ratio " +
+                       format_ratio(ratio) + ")");
+        }
+        moved_this_pass = 0;
+        Allocator::purge(); // return the emptied spans' cached blocks
+      }
+      wait = std::chrono::duration_cast<std::chrono::milliseconds>(pause);
+    }
+
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    sleep_cv_.wait_for(lock, wait, [this] { return stop_requested_.load(); });
+  }
+}
+
+} // namespace mini_redis
@@ -0,0 +1,108 @@
+// =============================================================================
+// defragmenter.hpp — Background Active Defragmentation (HEADER)
+// =============================================================================
+//
+// WHAT IS FRAGMENTATION?
+// Overwrite a key and its old node is freed, its new one allocated —
+// usually somewhere else. After hours of churn every slab of the arena
+// (util/huge_page_arena.hpp) holds a few live blocks and many holes. The
+// holes are reused for same-size blocks, but the pages can't go back to
+// the OS while even one block on them is live: RSS stays at the peak
+// while the data shrinks.
+//
+// FRAGMENTATION RATIO = bytes in slabs / bytes actually live in them.
+// 1.0 is perfectly dense; 2.0 means half the memory is holes.
+//
+// WHAT THE DEFRAGMENTER DOES:
+// It walks the store's hash table a few buckets at a time. An entry whose
+// node (or string buffer) sits in a sparse slab is COPIED into a fresh
+// allocation — which the arena carves from its densest slab — and the old
+// block freed. Sparse slabs drain, and an empty slab goes back to the free
+// span pool. Each step locks ONE shard, briefly (see
+// ThreadSafeHashMap::relocate), so clients only ever wait for a slice.
+//
+// WHEN IT RUNS:
+//   - every check_interval, it looks at the ratio; above start_ratio (and
+//     with at least min_waste_bytes of holes, so a tiny store is left
+//     alone) it starts a pass over the whole table
+//   - it works in 1 ms slices, then sleeps long enough to stay under
+//     cpu_percent of one core
+//   - after each full pass it stops once the ratio is under stop_ratio, or
+//     a pass moved nothing (the rest of the waste can't be reclaimed)
+// Two thresholds (hysteresis) keep it from flapping on and off around one.
+//
+// Without a page arena (Allocator::use_page_arena) nothing is ever sparse
+// as far as it can tell, so the thread just idles.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace mini_redis {
+
+struct DefragOptions {
+  double start_ratio = 1.4; // start a run above this fragmentation...
+  double stop_ratio = 1.1;  // ...and finish it once below this
+  std::uint64_t min_waste_bytes = 16 * 1024 * 1024;
+  int cpu_percent = 10; // share of one core while a run is active
+  std::chrono::milliseconds check_interval{1000};
+};
+
+struct DefragStats {
+  bool active = false;
+  double fragmentation_ratio = 1.0;
+  std::uint64_t runs = 0;   // times the defragmenter switched itself on
+  std::uint64_t passes = 0; // complete walks over the table
+  std::uint64_t visited = 0;
+  std::uint64_t moved = 0; // entries copied into denser slabs
+};
+
+class Defragmenter {
+public:
+  explicit Defragmenter(KeyValueStore &store, DefragOptions options = {});
+  ~Defragmenter();
+
+  Defragmenter(const Defragmenter &) = delete;
+  Defragmenter &operator=(const Defragmenter &) = delete;
+
+  void start();
+  void stop();
+
+  // ---- run_pass() — One full pass right now, on the calling thread ----
+  // Ignores the thresholds and the CPU budget; returns the entries moved.
+  // For tests and for POST /admin/memory/defrag.
+  std::uint64_t run_pass();
+
+  DefragStats stats() const;
+
+  // slab bytes / live bytes of the arena; 1.0 without one
+  static double fragmentation_ratio();
+
+private:
+  void defrag_loop();
+  bool should_start() const;
+
+  KeyValueStore &store_;
+  const DefragOptions options_;
+
+  std::thread thread_;
+  std::atomic<bool> stop_requested_{false};
+  std::mutex sleep_mutex_;
+  std::condition_variable sleep_cv_;
+
+  std::atomic<bool> active_{false};
+  std::atomic<std::uint64_t> runs_{0};
+  std::atomic<std::uint64_t> passes_{0};
+  std::atomic<std::uint64_t> visited_{0};
+  std::atomic<std::uint64_t> moved_{0};
+};
+
+} // namespace mini_redis
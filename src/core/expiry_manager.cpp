@@ -3,6 +3,7 @@
 // =============================================================================
 
 #include "core/expiry_manager.hpp"
+#include "util/allocator.hpp"
 #include "util/logger.hpp"
 
 namespace mini_redis {
@@ -12,13 +13,16 @@ namespace mini_redis {
 // =============================================================================
 // MEMBER INITIALIZER LIST — initializes members before the body runs.
 // store_(store) initializes the REFERENCE member to refer to 'store'.
-// interval_(interval_seconds) creates a std::chrono::seconds duration.
+// interval_ms_ starts as the interval converted to milliseconds.
 //
 // NOTE: References MUST be initialized in the initializer list — you can't
 // assign to a reference after construction (references can't be rebound).
 // =============================================================================
 ExpiryManager::ExpiryManager(KeyValueStore &store, int interval_seconds)
-    : store_(store), interval_(interval_seconds) {
+    : store_(store),
+      interval_ms_(std::chrono::milliseconds(
+                       std::chrono::seconds(interval_seconds))
+                       .count()) {
   // Body intentionally empty — all initialization done in the list above.
   // This is the industrial style: use initializer lists for everything.
 }
@@ -46,7 +50,7 @@ void ExpiryManager::start() {
   cleanup_thread_ = std::thread(&ExpiryManager::cleanup_loop, this);
 
   Logger::info("Expiry manager started (interval: " +
-               std::to_string(interval_.count()) + "s)");
+               std::to_string(interval().count()) + "ms)");
 }
 
 // =============================================================================
@@ -70,12 +74,20 @@ void ExpiryManager::stop() {
   Logger::info("Expiry manager stopped");
 }
 
+void ExpiryManager::set_interval(std::chrono::milliseconds interval) {
+  interval_ms_.store(interval.count());
+}
+
+std::chrono::milliseconds ExpiryManager::interval() const {
+  return std::chrono::milliseconds(interval_ms_.load());
+}
+
 // =============================================================================
 // cleanup_loop() — Runs in the background thread
 // =============================================================================
 // Loop: cleanup → sleep → cleanup → sleep → ...
 // Uses condition_variable::wait_for() for interruptible sleep:
-//   - Normally sleeps for 'interval_' seconds
+//   - Normally sleeps for interval()
 //   - But wakes up IMMEDIATELY if stop() is called (via notify_all)
 //
 // WHY NOT JUST USE std::this_thread::sleep_for()?
@@ -86,18 +98,48 @@ void ExpiryManager::stop() {
 void ExpiryManager::cleanup_loop() {
   while (!stop_requested_.load()) {
     // Run one cleanup cycle
-    store_.cleanup_expired();
+    run_cycle(store_);
+    // Housekeeping thread, so the allocator's decay timer runs here too
+    Allocator::tick();
 
     // Sleep for the interval, but wake up immediately if stop is called
     std::unique_lock<std::mutex> lock(sleep_mutex_);
 
     // wait_for() returns after either:
-    //   1. The timeout (interval_) elapses, OR
+    //   1. The timeout (interval()) elapses, OR
     //   2. The condition (stop_requested_) becomes true
     // The lambda is checked BEFORE waiting and on each wakeup.
-    sleep_cv_.wait_for(lock, interval_,
+    sleep_cv_.wait_for(lock, interval(),
                        [this] { return stop_requested_.load(); });
   }
 }
 
+void ExpiryManager::run_cycle(KeyValueStore &store,
+                              const KeyValueStore::EntryCallback &on_expired) {
+  store.cleanup_expired(on_expired);
+  enforce_retention(store);
+}
+
+// =============================================================================
+// enforce_retention() — Drop samples that fell out of their window
+// =============================================================================
+// Sample timestamps are wall-clock milliseconds (clients send Unix time),
+// so unlike TTLs this compares against system_clock, not steady_clock.
+// =============================================================================
+void ExpiryManager::enforce_retention(KeyValueStore &store) {
+  const std::int64_t now_ms =
+      std::chrono::duration_cast<std::chrono::milliseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+
+  std::size_t trimmed = 0;
+  store.modify_each_as<TimeSeries>(
+      [&](TimeSeries &series) { trimmed += series.trim_retention(now_ms); });
+
+  if (trimmed > 0) {
+    Logger::info("Retention: trimmed " + std::to_string(trimmed) +
+                 " time-series samples");
+  }
+}
+
 } // namespace mini_redis
@@ -60,15 +60,33 @@ public:
   // Stop the background cleanup thread (waits for it to finish)
   void stop();
 
+  // Change how often cleanup runs, while running (config reload).
+  // Takes effect from the next sleep; the current one runs its course.
+  void set_interval(std::chrono::milliseconds interval);
+  std::chrono::milliseconds interval() const;
+
+  // One cycle's work on any store, without a thread of its own: expired
+  // keys, then retention. Namespaces share one thread that calls this
+  // for each of them in turn (see NamespaceRegistry). 'on_expired' as in
+  // KeyValueStore::cleanup_expired().
+  static void
+  run_cycle(KeyValueStore &store,
+            const KeyValueStore::EntryCallback &on_expired = nullptr);
+
 private:
   // The function the background thread runs
   void cleanup_loop();
 
+  // Trim every time series to its retention window (see time_series.hpp).
+  // Retention is "expiry for samples": same thread, same cadence.
+  static void enforce_retention(KeyValueStore &store);
+
   // Reference to the store we're managing (NOT owned by us)
   KeyValueStore &store_;
 
-  // How often to run cleanup (in seconds)
-  std::chrono::seconds interval_;
+  // How often to run cleanup, in milliseconds (atomic: set_interval()
+  // may be called from another thread while the loop reads it)
+  std::atomic<std::chrono::milliseconds::rep> interval_ms_;
 
   // The background thread itself
   std::thread cleanup_thread_;
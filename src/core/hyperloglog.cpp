@@ -0,0 +1,473 @@
+// =============================================================================
+// hyperloglog.cpp — HyperLogLog Cardinality Estimator (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/hyperloglog.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm> // std::lower_bound, std::max
+#include <cmath>     // std::log, std::ldexp, std::llround
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MINI_REDIS_HAVE_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace mini_redis {
+
+namespace {
+
+// Redis's seed, so the same element lands in the same register as there
+constexpr std::uint64_t HLL_HASH_SEED = 0xadc83b19ULL;
+
+// =============================================================================
+// Scalar kernels — the reference versions, used on non-AVX2 CPUs
+// =============================================================================
+void max_registers_scalar(std::uint8_t *dst, const std::uint8_t *src,
+                          std::size_t n) {
+  for (std::size_t i = 0; i < n; ++i) {
+    dst[i] = std::max(dst[i], src[i]);
+  }
+}
+
+// Sum of 2^-r over all registers, plus how many registers are zero
+double harmonic_sum_scalar(const std::uint8_t *registers, std::size_t n,
+                           std::size_t &zeros) {
+  double sum = 0.0;
+  zeros = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    sum += std::ldexp(1.0, -static_cast<int>(registers[i]));
+    zeros += registers[i] == 0 ? 1 : 0;
+  }
+  return sum;
+}
+
+// Dense layout: 4 registers share 3 bytes (see dense_get below)
+void unpack_scalar(const std::uint8_t *packed, std::uint8_t *registers,
+                   std::size_t groups) {
+  for (std::size_t group = 0; group < groups; ++group) {
+    const std::uint8_t *p = packed + group * 3;
+    std::uint8_t *r = registers + group * 4;
+    r[0] = p[0] & 0x3F;
+    r[1] = static_cast<std::uint8_t>(((p[0] >> 6) | (p[1] << 2)) & 0x3F);
+    r[2] = static_cast<std::uint8_t>(((p[1] >> 4) | (p[2] << 4)) & 0x3F);
+    r[3] = p[2] >> 2;
+  }
+}
+
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+
+bool cpu_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+// 32 registers per instruction: dst = max(dst, src), byte-wise unsigned
+__attribute__((target("avx2"))) void
+max_registers_avx2(std::uint8_t *dst, const std::uint8_t *src, std::size_t n) {
+  std::size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i a = _mm256_loadu_si256(reinterpret_cast<__m256i *>(dst + i));
+    const __m256i b =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(dst + i),
+                        _mm256_max_epu8(a, b));
+  }
+  max_registers_scalar(dst + i, src + i, n - i);
+}
+
+// =============================================================================
+// unpack_avx2() — 24 packed bytes → 32 one-byte registers per step
+// =============================================================================
+// 1. Permute dwords so the low 128-bit half holds bytes 0..15 and the high
+//    half holds bytes 12..27 (shuffles can't cross the 128-bit halves).
+// 2. Shuffle each 3-byte group into its own 32-bit lane: v = 24 bits.
+// 3. Byte t of the lane must become (v >> 6t) & 63; shifting v LEFT by 2t
+//    lines those bits up with byte t, and one mask per byte keeps them.
+// =============================================================================
+__attribute__((target("avx2"))) void
+unpack_avx2(const std::uint8_t *packed, std::uint8_t *registers,
+            std::size_t groups) {
+  const __m256i dword_order = _mm256_setr_epi32(0, 1, 2, 3, 3, 4, 5, 6);
+  const __m256i group_bytes = _mm256_setr_epi8(
+      0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1, //
+      0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+  const __m256i mask0 = _mm256_set1_epi32(0x0000003F);
+  const __m256i mask1 = _mm256_set1_epi32(0x00003F00);
+  const __m256i mask2 = _mm256_set1_epi32(0x003F0000);
+  const __m256i mask3 = _mm256_set1_epi32(0x3F000000);
+
+  // Each step reads 32 bytes but consumes 24, so stop one step early
+  // and let the scalar loop finish without reading past the buffer
+  std::size_t group = 0;
+  for (; group + 8 + 3 <= groups; group += 8) {
+    const __m256i raw = _mm256_loadu_si256(
+        reinterpret_cast<const __m256i *>(packed + group * 3));
+    const __m256i v = _mm256_shuffle_epi8(
+        _mm256_permutevar8x32_epi32(raw, dword_order), group_bytes);
+
+    __m256i out = _mm256_and_si256(v, mask0);
+    out = _mm256_or_si256(
+        out, _mm256_and_si256(_mm256_slli_epi32(v, 2), mask1));
+    out = _mm256_or_si256(
+        out, _mm256_and_si256(_mm256_slli_epi32(v, 4), mask2));
+    out = _mm256_or_si256(
+        out, _mm256_and_si256(_mm256_slli_epi32(v, 6), mask3));
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(registers + group * 4),
+                        out);
+  }
+  unpack_scalar(packed + group * 3, registers + group * 4, groups - group);
+}
+
+// =============================================================================
+// harmonic_sum_avx2() — 2^-r without a single floating-point multiply
+// =============================================================================
+// A double is sign | 11-bit exponent | 52-bit fraction, and 2^e is just
+// exponent field (1023 + e) with a zero fraction. So 2^-r is the integer
+// (1023 - r) << 52, reinterpreted as a double — four at a time in AVX2.
+// Zero registers are counted 32 at a time with a byte compare + popcount.
+// =============================================================================
+__attribute__((target("avx2,popcnt"))) double
+harmonic_sum_avx2(const std::uint8_t *registers, std::size_t n,
+                  std::size_t &zeros) {
+  const __m256i exponent_bias = _mm256_set1_epi64x(1023);
+  __m256d sum_lo = _mm256_setzero_pd();
+  __m256d sum_hi = _mm256_setzero_pd();
+
+  std::size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i eight =
+        _mm_loadl_epi64(reinterpret_cast<const __m128i *>(registers + i));
+    const __m256i lo = _mm256_cvtepu8_epi64(eight);
+    const __m256i hi = _mm256_cvtepu8_epi64(_mm_srli_si128(eight, 4));
+    sum_lo = _mm256_add_pd(
+        sum_lo, _mm256_castsi256_pd(_mm256_slli_epi64(
+                    _mm256_sub_epi64(exponent_bias, lo), 52)));
+    sum_hi = _mm256_add_pd(
+        sum_hi, _mm256_castsi256_pd(_mm256_slli_epi64(
+                    _mm256_sub_epi64(exponent_bias, hi), 52)));
+  }
+
+  alignas(32) double lanes[4];
+  _mm256_store_pd(lanes, _mm256_add_pd(sum_lo, sum_hi));
+  double sum = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+
+  zeros = 0;
+  std::size_t z = 0;
+  const __m256i zero = _mm256_setzero_si256();
+  for (; z + 32 <= n; z += 32) {
+    const __m256i block =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(registers + z));
+    const auto mask = static_cast<unsigned>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(block, zero)));
+    zeros += static_cast<std::size_t>(__builtin_popcount(mask));
+  }
+
+  // Tails (never hit for 16384 registers, but keep the kernel general)
+  for (; i < n; ++i) {
+    sum += std::ldexp(1.0, -static_cast<int>(registers[i]));
+  }
+  for (; z < n; ++z) {
+    zeros += registers[z] == 0 ? 1 : 0;
+  }
+  return sum;
+}
+
+#endif // MINI_REDIS_HAVE_AVX2_KERNELS
+
+void unpack(const std::uint8_t *packed, std::uint8_t *registers,
+            std::size_t groups) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    unpack_avx2(packed, registers, groups);
+    return;
+  }
+#endif
+  unpack_scalar(packed, registers, groups);
+}
+
+void max_registers(std::uint8_t *dst, const std::uint8_t *src, std::size_t n) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    max_registers_avx2(dst, src, n);
+    return;
+  }
+#endif
+  max_registers_scalar(dst, src, n);
+}
+
+double harmonic_sum(const std::uint8_t *registers, std::size_t n,
+                    std::size_t &zeros) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    return harmonic_sum_avx2(registers, n, zeros);
+  }
+#endif
+  return harmonic_sum_scalar(registers, n, zeros);
+}
+
+std::uint32_t sparse_index(std::uint32_t entry) { return entry >> 8; }
+std::uint8_t sparse_value(std::uint32_t entry) {
+  return static_cast<std::uint8_t>(entry & 0xFF);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// add() — Hash, split into (register index, run length), update
+// =============================================================================
+bool HyperLogLog::add(const std::string &element) {
+  const std::uint64_t hash = hash64(element, HLL_HASH_SEED);
+
+  const auto index = static_cast<std::uint32_t>(hash & (REGISTERS - 1));
+
+  // The remaining 50 bits decide the run length. OR-ing in a sentinel bit
+  // caps it at 51, so it always fits in a 6-bit register.
+  const std::uint64_t rest =
+      (hash >> PRECISION) | (std::uint64_t{1} << (64 - PRECISION));
+  const auto run = static_cast<std::uint8_t>(__builtin_ctzll(rest) + 1);
+
+  return update(index, run);
+}
+
+bool HyperLogLog::update(std::uint32_t index, std::uint8_t value) {
+  if (encoding_ == Encoding::DENSE) {
+    if (dense_get(index) >= value) {
+      return false;
+    }
+    dense_set(index, value);
+    return true;
+  }
+
+  const std::uint32_t entry = (index << 8) | value;
+  const auto it = std::lower_bound(sparse_.begin(), sparse_.end(), index << 8);
+  if (it != sparse_.end() && sparse_index(*it) == index) {
+    if (sparse_value(*it) >= value) {
+      return false;
+    }
+    *it = entry;
+    return true;
+  }
+
+  sparse_.insert(it, entry);
+  if (sparse_.size() > SPARSE_MAX_ENTRIES) {
+    convert_to_dense();
+  }
+  return true;
+}
+
+// =============================================================================
+// count() / count_union()
+// =============================================================================
+std::uint64_t HyperLogLog::count() const {
+  Registers registers{};
+  merge_into(registers);
+  return estimate(registers);
+}
+
+std::uint64_t
+HyperLogLog::count_union(const std::vector<const HyperLogLog *> &hlls) {
+  Registers registers{};
+  for (const HyperLogLog *hll : hlls) {
+    if (hll != nullptr) {
+      hll->merge_into(registers);
+    }
+  }
+  return estimate(registers);
+}
+
+// =============================================================================
+// estimate() — The HyperLogLog formula
+// =============================================================================
+//   E = alpha * m^2 / Σ 2^-register
+//
+// For small cardinalities many registers are still zero and the formula
+// overestimates, so we switch to LINEAR COUNTING: m * ln(m / zeros), the
+// classic "balls into bins" estimate. With 64-bit hashes no large-range
+// correction is needed.
+// =============================================================================
+std::uint64_t HyperLogLog::estimate(const Registers &registers) {
+  const auto m = static_cast<double>(REGISTERS);
+  std::size_t zeros = 0;
+  const double sum = harmonic_sum(registers.data(), REGISTERS, zeros);
+
+  const double alpha = 0.7213 / (1.0 + 1.079 / m);
+  double estimate = alpha * m * m / sum;
+
+  if (estimate <= 2.5 * m && zeros > 0) {
+    estimate = m * std::log(m / static_cast<double>(zeros));
+  }
+  return static_cast<std::uint64_t>(std::llround(estimate));
+}
+
+// =============================================================================
+// merge() — Register-wise max, then re-encode
+// =============================================================================
+void HyperLogLog::merge(const HyperLogLog &other) {
+  Registers registers{};
+  merge_into(registers);
+  other.merge_into(registers);
+  assign(registers);
+}
+
+void HyperLogLog::merge_into(Registers &registers) const {
+  if (encoding_ == Encoding::SPARSE) {
+    for (const std::uint32_t entry : sparse_) {
+      auto &slot = registers[sparse_index(entry)];
+      slot = std::max(slot, sparse_value(entry));
+    }
+    return;
+  }
+
+  // Unpack 3 bytes → 4 registers, then one SIMD max over the whole array
+  Registers mine;
+  unpack(dense_.data(), mine.data(), REGISTERS / 4);
+  max_registers(registers.data(), mine.data(), REGISTERS);
+}
+
+void HyperLogLog::assign(const Registers &registers) {
+  std::size_t non_zero = 0;
+  for (const std::uint8_t value : registers) {
+    non_zero += value != 0 ? 1 : 0;
+  }
+
+  if (non_zero <= SPARSE_MAX_ENTRIES) {
+    encoding_ = Encoding::SPARSE;
+    dense_.clear();
+    dense_.shrink_to_fit();
+    sparse_.clear();
+    for (std::uint32_t i = 0; i < REGISTERS; ++i) {
+      if (registers[i] != 0) {
+        sparse_.push_back((i << 8) | registers[i]);
+      }
+    }
+    return;
+  }
+
+  encoding_ = Encoding::DENSE;
+  sparse_.clear();
+  sparse_.shrink_to_fit();
+  dense_.assign(DENSE_BYTES, 0);
+  for (std::size_t group = 0; group < REGISTERS / 4; ++group) {
+    const std::uint8_t *r = &registers[group * 4];
+    std::uint8_t *p = &dense_[group * 3];
+    p[0] = static_cast<std::uint8_t>(r[0] | (r[1] << 6));
+    p[1] = static_cast<std::uint8_t>((r[1] >> 2) | (r[2] << 4));
+    p[2] = static_cast<std::uint8_t>((r[2] >> 4) | (r[3] << 2));
+  }
+}
+
+// =============================================================================
+// Dense register access — 4 registers share 3 bytes
+// =============================================================================
+//   bytes:     [ p0      ][ p1      ][ p2      ]
+//   registers:  r0:6 r1:2  r1:4 r2:4  r2:2 r3:6   (low bits first)
+// =============================================================================
+void HyperLogLog::convert_to_dense() {
+  Registers registers{};
+  merge_into(registers);
+  sparse_.clear();
+  sparse_.shrink_to_fit();
+  encoding_ = Encoding::DENSE;
+  dense_.assign(DENSE_BYTES, 0);
+  for (std::size_t i = 0; i < REGISTERS; ++i) {
+    if (registers[i] != 0) {
+      dense_set(i, registers[i]);
+    }
+  }
+}
+
+std::uint8_t HyperLogLog::dense_get(std::size_t index) const {
+  const std::uint8_t *p = &dense_[(index / 4) * 3];
+  switch (index % 4) {
+  case 0:
+    return p[0] & 0x3F;
+  case 1:
+    return static_cast<std::uint8_t>(((p[0] >> 6) | (p[1] << 2)) & 0x3F);
+  case 2:
+    return static_cast<std::uint8_t>(((p[1] >> 4) | (p[2] << 4)) & 0x3F);
+  default:
+    return p[2] >> 2;
+  }
+}
+
+void HyperLogLog::dense_set(std::size_t index, std::uint8_t value) {
+  std::uint8_t *p = &dense_[(index / 4) * 3];
+  switch (index % 4) {
+  case 0:
+    p[0] = static_cast<std::uint8_t>((p[0] & 0xC0) | value);
+    break;
+  case 1:
+    p[0] = static_cast<std::uint8_t>((p[0] & 0x3F) | (value << 6));
+    p[1] = static_cast<std::uint8_t>((p[1] & 0xF0) | (value >> 2));
+    break;
+  case 2:
+    p[1] = static_cast<std::uint8_t>((p[1] & 0x0F) | (value << 4));
+    p[2] = static_cast<std::uint8_t>((p[2] & 0xFC) | (value >> 4));
+    break;
+  default:
+    p[2] = static_cast<std::uint8_t>((p[2] & 0x03) | (value << 2));
+    break;
+  }
+}
+
+HyperLogLog::Encoding HyperLogLog::encoding() const { return encoding_; }
+
+std::size_t HyperLogLog::memory_bytes() const {
+  return encoding_ == Encoding::DENSE ? dense_.size()
+                                      : sparse_.size() * sizeof(std::uint32_t);
+}
+
+// =============================================================================
+// Snapshot encoding
+// =============================================================================
+//   u8 encoding | SPARSE: u32 count, u32 per entry | DENSE: 12288 raw bytes
+// =============================================================================
+void HyperLogLog::serialize(std::string &out) const {
+  put_u8(out, static_cast<std::uint8_t>(encoding_));
+  if (encoding_ == Encoding::SPARSE) {
+    put_u32(out, static_cast<std::uint32_t>(sparse_.size()));
+    for (const std::uint32_t entry : sparse_) {
+      put_u32(out, entry);
+    }
+    return;
+  }
+  out.append(reinterpret_cast<const char *>(dense_.data()), dense_.size());
+}
+
+std::optional<HyperLogLog> HyperLogLog::deserialize(ByteReader &in) {
+  std::uint8_t encoding = 0;
+  if (!in.get_u8(encoding)) {
+    return std::nullopt;
+  }
+
+  HyperLogLog hll;
+  if (encoding == static_cast<std::uint8_t>(Encoding::DENSE)) {
+    std::string_view raw;
+    if (!in.get_raw(DENSE_BYTES, raw)) {
+      return std::nullopt;
+    }
+    hll.encoding_ = Encoding::DENSE;
+    hll.dense_.assign(raw.begin(), raw.end());
+    return hll;
+  }
+
+  std::uint32_t count = 0;
+  if (encoding != static_cast<std::uint8_t>(Encoding::SPARSE) ||
+      !in.get_u32(count) || count > SPARSE_MAX_ENTRIES) {
+    return std::nullopt;
+  }
+  for (std::uint32_t i = 0; i < count; ++i) {
+    std::uint32_t entry = 0;
+    if (!in.get_u32(entry) || sparse_index(entry) >= REGISTERS ||
+        sparse_value(entry) > 63 ||
+        (!hll.sparse_.empty() &&
+         sparse_index(hll.sparse_.back()) >= sparse_index(entry))) {
+      return std::nullopt;
+    }
+    hll.sparse_.push_back(entry);
+  }
+  return hll;
+}
+
+} // namespace mini_redis
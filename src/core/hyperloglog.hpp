@@ -0,0 +1,113 @@
+// =============================================================================
+// hyperloglog.hpp — HyperLogLog Cardinality Estimator (HEADER)
+// =============================================================================
+//
+// PROBLEM: "How many UNIQUE visitors did this page get?" Storing every
+// visitor ID in a set is exact but costs memory proportional to the number
+// of uniques — gigabytes for a billion IDs.
+//
+// HYPERLOGLOG trades exactness for memory: a fixed 12 KB per key, for ANY
+// number of uniques, with a standard error of about 0.81%.
+//
+// HOW IT WORKS (the intuition):
+// Hash each element to 64 random-looking bits. Among random numbers, one in
+// 2 ends in a 1-bit, one in 4 ends in "10", one in 2^k ends in k-1 zeros
+// then a one. So if the longest run of trailing zeros you've seen is k, you
+// have probably seen about 2^k distinct values.
+//
+// One such counter is very noisy, so the hash's low 14 bits pick one of
+// 16384 REGISTERS, and each register remembers the longest run seen for its
+// share of elements. The estimate is a (harmonic) mean over all registers.
+// Adding a duplicate hashes to the same register with the same run, so it
+// changes nothing — that's why only UNIQUES are counted.
+//
+// TWO ENCODINGS (like real Redis):
+//   1. SPARSE — most registers of a small HLL are still zero, so we store
+//      only the non-zero ones as a sorted list of (index, value) pairs.
+//   2. DENSE  — all 16384 registers, 6 bits each, packed back to back:
+//      16384 * 6 / 8 = 12288 bytes. Fixed size, no matter how many adds.
+//
+// Merging and counting unpack registers into a plain byte array and run
+// AVX2 kernels over it (max for merge, sum of 2^-r for the estimate).
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mini_redis {
+
+class HyperLogLog {
+public:
+  enum class Encoding { SPARSE, DENSE };
+
+  // ---- Geometry (same as Redis, so the numbers below are familiar) ----
+  static constexpr std::size_t PRECISION = 14; // index bits
+  static constexpr std::size_t REGISTERS = std::size_t{1} << PRECISION;
+  static constexpr std::size_t REGISTER_BITS = 6; // max value 63
+  static constexpr std::size_t DENSE_BYTES = REGISTERS * REGISTER_BITS / 8;
+
+  // ---- add() — Returns true if any register changed (PFADD's reply) ----
+  bool add(const std::string &element);
+
+  // ---- count() — Estimated number of unique elements added ----
+  std::uint64_t count() const;
+
+  // ---- merge() — This HLL becomes the union of itself and 'other' ----
+  void merge(const HyperLogLog &other);
+
+  // ---- count_union() — Estimate |A ∪ B ∪ ...| without modifying any ----
+  // nullptr entries (missing keys) count as empty.
+  static std::uint64_t
+  count_union(const std::vector<const HyperLogLog *> &hlls);
+
+  Encoding encoding() const;
+
+  // Bytes used by the register storage (sparse list or packed registers)
+  std::size_t memory_bytes() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<HyperLogLog> deserialize(ByteReader &in);
+
+private:
+  // One byte per register — the "unpacked" form the SIMD kernels work on
+  using Registers = std::array<std::uint8_t, REGISTERS>;
+
+  // Sparse entries above this many bytes convert to dense (Redis default)
+  static constexpr std::size_t SPARSE_MAX_BYTES = 3000;
+  static constexpr std::size_t SPARSE_MAX_ENTRIES =
+      SPARSE_MAX_BYTES / sizeof(std::uint32_t);
+
+  // Raise register 'index' to 'value' if it is lower. True if it changed.
+  bool update(std::uint32_t index, std::uint8_t value);
+
+  // Max-merge our registers into 'registers' (must start zeroed or valid)
+  void merge_into(Registers &registers) const;
+
+  // Replace our registers with 'registers', choosing the encoding
+  void assign(const Registers &registers);
+
+  void convert_to_dense();
+  std::uint8_t dense_get(std::size_t index) const;
+  void dense_set(std::size_t index, std::uint8_t value);
+
+  static std::uint64_t estimate(const Registers &registers);
+
+  Encoding encoding_ = Encoding::SPARSE;
+
+  // SPARSE: sorted by index, each entry = (index << 8) | value
+  std::vector<std::uint32_t> sparse_;
+
+  // DENSE: DENSE_BYTES of packed 6-bit registers (empty while sparse)
+  std::vector<std::uint8_t> dense_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,88 @@
+// =============================================================================
+// inline_values.cpp — Lock-Free Reads of Small String Values (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/inline_values.hpp"
+
+#include <algorithm> // std::min
+
+namespace mini_redis {
+
+std::optional<InlineKey> InlineKey::from(std::string_view key) {
+  if (key.size() > INLINE_KEY_BYTES) {
+    return std::nullopt;
+  }
+  InlineKey inline_key;
+  inline_key.size = static_cast<std::uint8_t>(key.size());
+  std::memcpy(inline_key.bytes, key.data(), key.size());
+  return inline_key;
+}
+
+void InlineValues::set_max_bytes(std::size_t max_bytes) {
+  max_bytes = std::min(max_bytes, INLINE_VALUE_BYTES);
+  if (max_bytes > 0) {
+    in_use_.store(true, std::memory_order_relaxed);
+  }
+  max_bytes_.store(max_bytes, std::memory_order_relaxed);
+}
+
+InlineValueStats InlineValues::stats() const {
+  InlineValueStats stats;
+  stats.max_bytes = max_bytes_.load(std::memory_order_relaxed);
+  stats.values = values_.size();
+  return stats;
+}
+
+// =============================================================================
+// read() — The whole fast path: an optimistic copy, then the checks
+// =============================================================================
+// values_.get() is the seqlock loop (ThreadSafeHashMap::get with
+// OPTIMISTIC_READS): what it returns was copied while no writer was active.
+// =============================================================================
+std::optional<std::string> InlineValues::read(std::string_view key) const {
+  if (max_bytes_.load(std::memory_order_relaxed) == 0) {
+    return std::nullopt;
+  }
+  const auto inline_key = InlineKey::from(key);
+  if (!inline_key.has_value()) {
+    return std::nullopt;
+  }
+  const auto value = values_.get(*inline_key);
+  if (!value.has_value()) {
+    return std::nullopt;
+  }
+  if (value->expires &&
+      std::chrono::steady_clock::now().time_since_epoch().count() >=
+          value->expires_at) {
+    return std::nullopt; // the store does the lazy deletion
+  }
+  return std::string(value->bytes, value->size);
+}
+
+void InlineValues::update(
+    std::string_view key, const std::string *text,
+    const std::optional<std::chrono::steady_clock::time_point> &expires_at) {
+  if (!in_use_.load(std::memory_order_relaxed)) {
+    return; // never turned on: nothing to mirror, nothing to remove
+  }
+  const auto inline_key = InlineKey::from(key);
+  if (!inline_key.has_value()) {
+    return; // long keys are never copied
+  }
+
+  const std::size_t max_bytes = max_bytes_.load(std::memory_order_relaxed);
+  if (text == nullptr || max_bytes == 0 || text->size() > max_bytes) {
+    values_.remove(*inline_key);
+    return;
+  }
+  InlineValue value;
+  value.size = static_cast<std::uint8_t>(text->size());
+  std::memcpy(value.bytes, text->data(), text->size());
+  if (expires_at.has_value()) {
+    value.expires = true;
+    value.expires_at = expires_at->time_since_epoch().count();
+  }
+  values_.set(*inline_key, value);
+}
+
+} // namespace mini_redis
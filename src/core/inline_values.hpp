@@ -0,0 +1,117 @@
+// =============================================================================
+// inline_values.hpp — Lock-Free Reads of Small String Values (HEADER)
+// =============================================================================
+//
+// THE PROBLEM: a GET of a 5-byte counter spends more time on the shard's
+// shared_mutex than on the value. Even a READ lock writes shared memory —
+// the reader count — so every GET of a hot shard moves that cache line
+// between cores, and readers on different cores slow each other down
+// without ever conflicting.
+//
+// THE FIX: a second, seqlock-guarded copy of every SMALL string value
+// (key ≤ 23 bytes, value ≤ max_bytes ≤ 22), stored INLINE in the slots of
+// a flat table — no pointers, nothing a reader could follow into freed
+// memory. A reader:
+//   1. reads the shard's sequence counter (odd = a writer is active)
+//   2. copies the slot
+//   3. reads the counter again: unchanged → the copy is good, else retry
+// Writers take the shard's spinlock and bump the counter before and after
+// (see SeqLock in map_policies.hpp). The reader writes NOTHING shared.
+//
+// THE STORE STAYS THE SOURCE OF TRUTH. Every write to a key updates this
+// copy while it still holds the key's exclusive shard lock in the store,
+// so both see the same order of writes. A key missing here is fine —
+// GET falls back to the store — but a value here is never one the store
+// no longer has (except an expired one, which readers skip).
+//
+// WHEN IT IS USED: only when max_bytes > 0 (off by default). It costs one
+// extra probe on GETs it can't answer, an update per write, and a 72-byte
+// slot per small value.
+// =============================================================================
+
+#pragma once
+
+#include "core/thread_safe_hash_map.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring> // std::memcmp
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mini_redis {
+
+constexpr std::size_t INLINE_KEY_BYTES = 23;
+constexpr std::size_t INLINE_VALUE_BYTES = 22;
+
+// ---- InlineKey — A short key, zero-padded to a fixed 24 bytes ----
+// Compared as 24 raw bytes: a fixed-size compare stays in bounds even on
+// a torn copy, which an optimistic reader may be holding.
+struct InlineKey {
+  std::uint8_t size = 0;
+  char bytes[INLINE_KEY_BYTES] = {};
+
+  static std::optional<InlineKey> from(std::string_view key);
+  std::string_view view() const { return {bytes, size}; }
+  bool operator==(const InlineKey &other) const {
+    return std::memcmp(this, &other, sizeof(InlineKey)) == 0;
+  }
+};
+
+// ---- InlineValue — A short value and its expiry, 32 bytes ----
+struct InlineValue {
+  std::chrono::steady_clock::rep expires_at = 0; // if 'expires'
+  std::uint8_t size = 0;
+  bool expires = false;
+  char bytes[INLINE_VALUE_BYTES] = {};
+};
+
+template <> struct KeyHasher<InlineKey> {
+  std::uint64_t operator()(const InlineKey &key) const {
+    return hash_key(key.view());
+  }
+};
+
+struct InlineValueStats {
+  std::uint64_t max_bytes = 0; // values up to this size are copied; 0 = off
+  std::uint64_t values = 0;    // copies held right now
+};
+
+// =============================================================================
+// InlineValues — The seqlock-guarded copies
+// =============================================================================
+class InlineValues {
+public:
+  // Clamped to INLINE_VALUE_BYTES. Turning it off stops GETs from using
+  // the copies at once; writes keep removing stale ones from then on.
+  void set_max_bytes(std::size_t max_bytes);
+  InlineValueStats stats() const;
+
+  // ---- read() — The value of 'key', without taking any lock ----
+  // nullopt if there's no copy (not small, off, never written since) or
+  // it has expired: the caller asks the store instead.
+  std::optional<std::string> read(std::string_view key) const;
+
+  // ---- update() — Mirror one write; the caller holds the store lock ----
+  // 'text' is the key's new string value, or nullptr if the key is gone
+  // or holds something else (compressed bytes, a sorted set, ...).
+  void update(
+      std::string_view key, const std::string *text,
+      const std::optional<std::chrono::steady_clock::time_point> &expires_at);
+
+private:
+  using Table =
+      ThreadSafeHashMap<InlineKey, InlineValue, FlatStorage, SeqLock, 64>;
+  static_assert(Table::OPTIMISTIC_READS, "inline copies must be POD");
+
+  std::atomic<std::size_t> max_bytes_{0};
+  // Set the first time max_bytes > 0 and never cleared: from then on
+  // every write is mirrored, even after max_bytes goes back to 0
+  std::atomic<bool> in_use_{false};
+  Table values_;
+};
+
+} // namespace mini_redis
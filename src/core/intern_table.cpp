@@ -0,0 +1,164 @@
+// =============================================================================
+// intern_table.cpp — Content-Addressed Shared Values (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/intern_table.hpp"
+#include "util/hash.hpp"
+
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <utility> // std::move
+
+namespace mini_redis {
+
+namespace detail {
+
+struct InternNode;
+
+// The table indexes nodes by a view of their own bytes, so a lookup with
+// the incoming value needs no copy and no separate hash-to-node index
+struct InternState {
+  struct ContentHash {
+    std::size_t operator()(std::string_view bytes) const {
+      return static_cast<std::size_t>(hash_key(bytes));
+    }
+  };
+
+  mutable std::mutex mutex;
+  std::unordered_map<std::string_view, InternNode *, ContentHash> nodes;
+
+  // Updated on copies too (no table lock there), hence atomic
+  std::atomic<std::uint64_t> references{0};
+  std::atomic<std::uint64_t> logical_bytes{0};
+  std::uint64_t unique_bytes = 0; // under mutex
+  std::atomic<std::uint64_t> hits{0};
+  std::atomic<std::uint64_t> misses{0};
+};
+
+struct InternNode {
+  std::string bytes;
+  std::atomic<std::uint32_t> refs{1};
+  std::shared_ptr<InternState> owner;
+};
+
+} // namespace detail
+
+// =============================================================================
+// SharedString — reference counting
+// =============================================================================
+// Taking a reference never needs the lock: whoever copies already holds
+// one, so the count can't be at zero. Dropping one does, when it may be
+// the last: intern() increments under the same lock, so "found in the
+// table" and "freed" can't interleave.
+// =============================================================================
+SharedString::SharedString(const SharedString &other) : node_(other.node_) {
+  if (node_ != nullptr) {
+    node_->refs.fetch_add(1, std::memory_order_relaxed);
+    node_->owner->references.fetch_add(1, std::memory_order_relaxed);
+    node_->owner->logical_bytes.fetch_add(node_->bytes.size(),
+                                          std::memory_order_relaxed);
+  }
+}
+
+SharedString::SharedString(SharedString &&other) noexcept
+    : node_(std::exchange(other.node_, nullptr)) {}
+
+SharedString &SharedString::operator=(const SharedString &other) {
+  if (this != &other) {
+    SharedString copy(other);
+    *this = std::move(copy);
+  }
+  return *this;
+}
+
+SharedString &SharedString::operator=(SharedString &&other) noexcept {
+  if (this != &other) {
+    release();
+    node_ = std::exchange(other.node_, nullptr);
+  }
+  return *this;
+}
+
+SharedString::~SharedString() { release(); }
+
+const std::string &SharedString::str() const { return node_->bytes; }
+
+std::uint32_t SharedString::use_count() const {
+  return node_ == nullptr ? 0 : node_->refs.load(std::memory_order_relaxed);
+}
+
+void SharedString::release() {
+  detail::InternNode *node = std::exchange(node_, nullptr);
+  if (node == nullptr) {
+    return;
+  }
+  const std::shared_ptr<detail::InternState> owner = node->owner;
+  owner->references.fetch_sub(1, std::memory_order_relaxed);
+  owner->logical_bytes.fetch_sub(node->bytes.size(),
+                                 std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(owner->mutex);
+  if (node->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+    return;
+  }
+  owner->nodes.erase(std::string_view(node->bytes));
+  owner->unique_bytes -= node->bytes.size();
+  delete node;
+}
+
+// =============================================================================
+// InternTable
+// =============================================================================
+InternTable::InternTable()
+    : state_(std::make_shared<detail::InternState>()) {}
+
+InternTable::~InternTable() = default;
+
+void InternTable::set_min_bytes(std::size_t min_bytes) {
+  min_bytes_.store(min_bytes, std::memory_order_relaxed);
+}
+
+std::size_t InternTable::min_bytes() const {
+  return min_bytes_.load(std::memory_order_relaxed);
+}
+
+SharedString InternTable::intern(std::string value) {
+  const std::size_t size = value.size();
+  state_->references.fetch_add(1, std::memory_order_relaxed);
+  state_->logical_bytes.fetch_add(size, std::memory_order_relaxed);
+
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  const auto found = state_->nodes.find(std::string_view(value));
+  if (found != state_->nodes.end()) {
+    found->second->refs.fetch_add(1, std::memory_order_relaxed);
+    state_->hits.fetch_add(1, std::memory_order_relaxed);
+    return SharedString(found->second);
+  }
+
+  auto *node = new detail::InternNode;
+  node->bytes = std::move(value);
+  node->owner = state_;
+  state_->nodes.emplace(std::string_view(node->bytes), node);
+  state_->unique_bytes += size;
+  state_->misses.fetch_add(1, std::memory_order_relaxed);
+  return SharedString(node);
+}
+
+InternStats InternTable::stats() const {
+  InternStats stats;
+  stats.min_bytes = min_bytes();
+  stats.references = state_->references.load(std::memory_order_relaxed);
+  stats.logical_bytes = state_->logical_bytes.load(std::memory_order_relaxed);
+  stats.hits = state_->hits.load(std::memory_order_relaxed);
+  stats.misses = state_->misses.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  stats.values = state_->nodes.size();
+  stats.unique_bytes = state_->unique_bytes;
+  if (stats.logical_bytes < stats.unique_bytes) {
+    stats.logical_bytes = stats.unique_bytes; // counters read a moment apart
+  }
+  return stats;
+}
+
+} // namespace mini_redis
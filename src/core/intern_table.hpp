@@ -0,0 +1,125 @@
+// =============================================================================
+// intern_table.hpp — Content-Addressed Shared Values (HEADER)
+// =============================================================================
+//
+// WHAT IS INTERNING?
+// Many keys often hold the SAME bytes: a default config blob, "{}", the
+// same feature vector for every new user. Storing each copy separately
+// wastes memory in proportion to the number of keys. Interning keeps ONE
+// copy of each distinct value in a table keyed by its content, and every
+// key that holds those bytes points at it.
+//
+//   SET a <2 KB blob>  → table: { blob → refs 1 }   a ──┐
+//   SET b <same blob>  → table: { blob → refs 2 }   b ──┴─► one 2 KB buffer
+//   DEL a              → refs 1;  DEL b → refs 0, the buffer is freed
+//
+// HOW A VALUE IS FOUND: by content. The table hashes the bytes (seeded,
+// like the store's keys, so nobody can flood one bucket) and compares the
+// full bytes on a hash match — two different values never share a buffer.
+//
+// REFERENCE COUNTING: a SharedString is a counted pointer to one table
+// node. Copying it adds a reference, destroying it drops one, and the
+// node leaves the table with its last reference. Counts are atomic so
+// copies can be made under a shard's shared lock; the final release and
+// every lookup take the table's own mutex, so a value can't be found and
+// freed at the same moment.
+//
+// WHEN IT IS USED: only for values of at least min_bytes (0 = off). Short
+// values gain little — a table node and a hash per SET cost more than a
+// few duplicated bytes — so the threshold is the dedup "mode" switch.
+// Interned values are read-only; a command that mutates one in place
+// (SETBIT) first takes a private copy.
+// =============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace mini_redis {
+
+struct InternStats {
+  std::uint64_t min_bytes = 0;     // values this size or larger are interned
+  std::uint64_t values = 0;        // distinct buffers in the table
+  std::uint64_t references = 0;    // entries (and copies) pointing at them
+  std::uint64_t unique_bytes = 0;  // bytes the buffers take
+  std::uint64_t logical_bytes = 0; // bytes without dedup: size × references
+  std::uint64_t hits = 0;          // intern() found the value already there
+  std::uint64_t misses = 0;        // intern() had to add it
+
+  std::uint64_t saved_bytes() const { return logical_bytes - unique_bytes; }
+};
+
+class InternTable;
+
+namespace detail {
+struct InternState; // the table itself   } both defined in
+struct InternNode;  // one value + count  } intern_table.cpp
+} // namespace detail
+
+// =============================================================================
+// SharedString — One reference to an interned value
+// =============================================================================
+// Behaves like a `const std::string` that is cheap to copy. A moved-from
+// SharedString holds nothing and may only be destroyed or assigned to.
+// =============================================================================
+class SharedString {
+public:
+  SharedString(const SharedString &other);
+  SharedString(SharedString &&other) noexcept;
+  SharedString &operator=(const SharedString &other);
+  SharedString &operator=(SharedString &&other) noexcept;
+  ~SharedString();
+
+  const std::string &str() const;
+
+  // References to this value, across all keys (for tests and stats)
+  std::uint32_t use_count() const;
+
+private:
+  friend class InternTable;
+
+  explicit SharedString(detail::InternNode *node) : node_(node) {}
+  void release();
+
+  detail::InternNode *node_ = nullptr;
+};
+
+class InternTable {
+public:
+  InternTable();
+  ~InternTable();
+
+  InternTable(const InternTable &) = delete;
+  InternTable &operator=(const InternTable &) = delete;
+
+  // ---- min_bytes — The dedup switch: 0 = off ----
+  // Values already interned stay shared when it changes; only new
+  // writes follow the new threshold.
+  void set_min_bytes(std::size_t min_bytes);
+  std::size_t min_bytes() const;
+
+  // Would a value of this size be interned?
+  bool should_intern(std::size_t size) const {
+    const std::size_t threshold = min_bytes_.load(std::memory_order_relaxed);
+    return threshold != 0 && size >= threshold;
+  }
+
+  // ---- intern() — A reference to the table's copy of 'value' ----
+  // Adds 'value' (moved in) if no identical value is interned yet.
+  SharedString intern(std::string value);
+
+  InternStats stats() const;
+
+private:
+  std::atomic<std::size_t> min_bytes_{0};
+
+  // Shared with every node: a SharedString copied out of the store (a
+  // snapshot, a GET in flight) can outlive the table that made it
+  std::shared_ptr<detail::InternState> state_;
+};
+
+} // namespace mini_redis
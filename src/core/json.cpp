@@ -0,0 +1,1080 @@
+// =============================================================================
+// json.cpp — JSON Document Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/json.hpp"
+#include "core/json_scan.hpp"
+
+#include <algorithm>
+#include <charconv> // std::from_chars / std::to_chars — locale-free numbers
+#include <cmath>
+#include <cstdlib> // std::strtod
+#include <cstring> // std::memcpy
+#include <limits>
+
+namespace mini_redis {
+
+namespace {
+
+// Tape tags: printable so a hex dump of a tape is readable
+constexpr char TAG_NULL = 'n';
+constexpr char TAG_FALSE = 'f';
+constexpr char TAG_TRUE = 't';
+constexpr char TAG_INTEGER = 'i';
+constexpr char TAG_NUMBER = 'd';
+constexpr char TAG_STRING = 's';
+constexpr char TAG_ARRAY = '[';
+constexpr char TAG_OBJECT = '{';
+
+// Container header: tag + u32 payload size + u32 element count
+constexpr std::size_t HEADER = 9;
+
+// Parses keep their stage-1 position list between calls (see parse()),
+// but don't hold on to one sized for a huge document forever
+constexpr std::size_t MAX_KEPT_POSITIONS = 1 << 20;
+
+// ---- Little-endian fixed-width fields at a tape offset ----
+std::uint32_t load_u32(const std::string &tape, std::size_t at) {
+  std::uint32_t value = 0;
+  for (int i = 3; i >= 0; --i) {
+    value = (value << 8) | static_cast<unsigned char>(tape[at + i]);
+  }
+  return value;
+}
+
+void store_u32(std::string &tape, std::size_t at, std::uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    tape[at + i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+std::uint64_t load_u64(const std::string &tape, std::size_t at) {
+  std::uint64_t value = 0;
+  for (int i = 7; i >= 0; --i) {
+    value = (value << 8) | static_cast<unsigned char>(tape[at + i]);
+  }
+  return value;
+}
+
+void store_u64(std::string &tape, std::size_t at, std::uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    tape[at + i] = static_cast<char>(value >> (8 * i));
+  }
+}
+
+// Reads the varint at 'at' (as written by put_varint) and moves past it
+std::size_t load_varint(const std::string &tape, std::size_t &at) {
+  std::size_t value = 0;
+  for (int shift = 0;; shift += 7) {
+    const auto byte = static_cast<unsigned char>(tape[at++]);
+    value |= static_cast<std::size_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return value;
+    }
+  }
+}
+
+std::uint64_t double_bits(double value) {
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+double bits_double(std::uint64_t bits) {
+  double value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
+void append_integer(std::string &out, long long value) {
+  char buffer[24];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
+
+// Shortest text that reads back as exactly the same double
+void append_double(std::string &out, double value) {
+  char buffer[32];
+  const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+  out.append(buffer, result.ptr);
+}
+
+void append_quoted(std::string &out, std::string_view text) {
+  static constexpr char HEX[] = "0123456789abcdef";
+  out += '"';
+  std::size_t plain_from = 0;
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    const auto c = static_cast<unsigned char>(text[i]);
+    if (c >= 0x20 && c != '"' && c != '\\') {
+      continue;
+    }
+    out.append(text.data() + plain_from, i - plain_from);
+    plain_from = i + 1;
+    switch (c) {
+    case '"':
+      out += "\\\"";
+      break;
+    case '\\':
+      out += "\\\\";
+      break;
+    case '\n':
+      out += "\\n";
+      break;
+    case '\r':
+      out += "\\r";
+      break;
+    case '\t':
+      out += "\\t";
+      break;
+    default:
+      out += "\\u00";
+      out += HEX[c >> 4];
+      out += HEX[c & 0xF];
+    }
+  }
+  out.append(text.data() + plain_from, text.size() - plain_from);
+  out += '"';
+}
+
+// =============================================================================
+// valid_utf8() — Only run when stage 1 saw a byte >= 0x80
+// =============================================================================
+// Rejects what RFC 3629 forbids: stray continuation bytes, truncated
+// sequences, overlong encodings, surrogates and code points > U+10FFFF.
+// =============================================================================
+bool valid_utf8(std::string_view text) {
+  std::size_t i = 0;
+  while (i < text.size()) {
+    if (i + 8 <= text.size()) { // skip ASCII 8 bytes at a time
+      std::uint64_t word;
+      std::memcpy(&word, text.data() + i, sizeof(word));
+      if ((word & 0x8080808080808080ULL) == 0) {
+        i += 8;
+        continue;
+      }
+    }
+    const auto lead = static_cast<unsigned char>(text[i]);
+    if (lead < 0x80) {
+      ++i;
+      continue;
+    }
+    std::size_t length;
+    std::uint32_t code_point;
+    std::uint32_t smallest;
+    if ((lead & 0xE0) == 0xC0) {
+      length = 2;
+      code_point = lead & 0x1F;
+      smallest = 0x80;
+    } else if ((lead & 0xF0) == 0xE0) {
+      length = 3;
+      code_point = lead & 0x0F;
+      smallest = 0x800;
+    } else if ((lead & 0xF8) == 0xF0) {
+      length = 4;
+      code_point = lead & 0x07;
+      smallest = 0x10000;
+    } else {
+      return false;
+    }
+    if (i + length > text.size()) {
+      return false;
+    }
+    for (std::size_t k = 1; k < length; ++k) {
+      const auto next = static_cast<unsigned char>(text[i + k]);
+      if ((next & 0xC0) != 0x80) {
+        return false;
+      }
+      code_point = (code_point << 6) | (next & 0x3F);
+    }
+    if (code_point < smallest || code_point > 0x10FFFF ||
+        (code_point >= 0xD800 && code_point <= 0xDFFF)) {
+      return false;
+    }
+    i += length;
+  }
+  return true;
+}
+
+void append_utf8(std::string &out, std::uint32_t code_point) {
+  if (code_point < 0x80) {
+    out += static_cast<char>(code_point);
+  } else if (code_point < 0x800) {
+    out += static_cast<char>(0xC0 | (code_point >> 6));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else if (code_point < 0x10000) {
+    out += static_cast<char>(0xE0 | (code_point >> 12));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  } else {
+    out += static_cast<char>(0xF0 | (code_point >> 18));
+    out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+    out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+    out += static_cast<char>(0x80 | (code_point & 0x3F));
+  }
+}
+
+// =============================================================================
+// Stage 2 — From structural positions to the tape
+// =============================================================================
+class TapeBuilder {
+public:
+  TapeBuilder(std::string_view text, const std::vector<std::uint32_t> &tokens,
+              std::string &tape)
+      : text_(text), tokens_(tokens), tape_(tape) {}
+
+  bool build();
+
+private:
+  struct Open {
+    std::size_t header; // tape offset of the container's tag
+    std::uint32_t count;
+    bool object;
+  };
+
+  enum class Expect { VALUE, KEY, AFTER_VALUE };
+
+  bool parse_value(std::size_t at, Expect &next);
+  bool parse_string(std::size_t at);
+  bool parse_hex4(std::size_t at, std::uint32_t &value) const;
+  bool parse_literal(std::size_t at, std::string_view word, char tag);
+  bool parse_number(std::size_t at);
+  bool ends_token(std::size_t at) const;
+  void close();
+
+  std::string_view text_;
+  const std::vector<std::uint32_t> &tokens_;
+  std::string &tape_;
+  std::size_t next_token_ = 0;
+  std::vector<Open> open_;
+  std::string scratch_; // decoded string contents
+};
+
+// The grammar as a three-state machine; 'open_' replaces recursion, so a
+// deeply nested document can't overflow the stack
+bool TapeBuilder::build() {
+  Expect next = Expect::VALUE;
+  while (true) {
+    if (next == Expect::AFTER_VALUE && open_.empty()) {
+      return next_token_ == tokens_.size(); // one value, then nothing
+    }
+    if (next_token_ == tokens_.size()) {
+      return false;
+    }
+    const std::size_t at = tokens_[next_token_++];
+    const char c = text_[at];
+
+    switch (next) {
+    case Expect::VALUE:
+      if (!parse_value(at, next)) {
+        return false;
+      }
+      break;
+
+    case Expect::KEY:
+      if (c != '"' || !parse_string(at) || next_token_ == tokens_.size() ||
+          text_[tokens_[next_token_++]] != ':') {
+        return false;
+      }
+      put_short_bytes(tape_, scratch_);
+      next = Expect::VALUE;
+      break;
+
+    case Expect::AFTER_VALUE:
+      ++open_.back().count;
+      if (c == ',') {
+        next = open_.back().object ? Expect::KEY : Expect::VALUE;
+      } else if (c == (open_.back().object ? '}' : ']')) {
+        close(); // the container itself is now a finished value
+      } else {
+        return false;
+      }
+      break;
+    }
+  }
+}
+
+bool TapeBuilder::parse_value(std::size_t at, Expect &next) {
+  const char c = text_[at];
+  next = Expect::AFTER_VALUE;
+  switch (c) {
+  case '{':
+  case '[': {
+    if (open_.size() == JsonDocument::MAX_DEPTH) {
+      return false;
+    }
+    open_.push_back({tape_.size(), 0, c == '{'});
+    tape_ += c == '{' ? TAG_OBJECT : TAG_ARRAY;
+    tape_.append(HEADER - 1, '\0'); // sizes are filled in by close()
+    const char closer = c == '{' ? '}' : ']';
+    if (next_token_ < tokens_.size() && text_[tokens_[next_token_]] == closer) {
+      ++next_token_;
+      close();
+    } else {
+      next = c == '{' ? Expect::KEY : Expect::VALUE;
+    }
+    return true;
+  }
+  case '"':
+    if (!parse_string(at)) {
+      return false;
+    }
+    tape_ += TAG_STRING;
+    put_short_bytes(tape_, scratch_);
+    return true;
+  case 't':
+    return parse_literal(at, "true", TAG_TRUE);
+  case 'f':
+    return parse_literal(at, "false", TAG_FALSE);
+  case 'n':
+    return parse_literal(at, "null", TAG_NULL);
+  default:
+    return parse_number(at);
+  }
+}
+
+void TapeBuilder::close() {
+  const Open done = open_.back();
+  open_.pop_back();
+  store_u32(tape_, done.header + 1,
+            static_cast<std::uint32_t>(tape_.size() - done.header - HEADER));
+  store_u32(tape_, done.header + 5, done.count);
+}
+
+// A scalar must be followed by whitespace, an operator or the end:
+// "truex" and "12abc" are one bad token, not a value plus garbage
+bool TapeBuilder::ends_token(std::size_t at) const {
+  if (at == text_.size()) {
+    return true;
+  }
+  switch (text_[at]) {
+  case ' ':
+  case '\t':
+  case '\n':
+  case '\r':
+  case ',':
+  case ':':
+  case ']':
+  case '}':
+    return true;
+  default:
+    return false;
+  }
+}
+
+bool TapeBuilder::parse_literal(std::size_t at, std::string_view word,
+                                char tag) {
+  if (text_.substr(at, word.size()) != word ||
+      !ends_token(at + word.size())) {
+    return false;
+  }
+  tape_ += tag;
+  return true;
+}
+
+// JSON's number grammar is stricter than from_chars': no leading '+', no
+// leading zeros, digits on both sides of '.', so it's checked by hand first
+bool TapeBuilder::parse_number(std::size_t at) {
+  const auto digit = [this](std::size_t i) {
+    return i < text_.size() && text_[i] >= '0' && text_[i] <= '9';
+  };
+
+  std::size_t end = at;
+  if (end < text_.size() && text_[end] == '-') {
+    ++end;
+  }
+  if (!digit(end)) {
+    return false;
+  }
+  if (text_[end] == '0') {
+    ++end;
+  } else {
+    while (digit(end)) {
+      ++end;
+    }
+  }
+  bool integral = true;
+  if (end < text_.size() && text_[end] == '.') {
+    integral = false;
+    if (!digit(++end)) {
+      return false;
+    }
+    while (digit(end)) {
+      ++end;
+    }
+  }
+  if (end < text_.size() && (text_[end] == 'e' || text_[end] == 'E')) {
+    integral = false;
+    ++end;
+    if (end < text_.size() && (text_[end] == '+' || text_[end] == '-')) {
+      ++end;
+    }
+    if (!digit(end)) {
+      return false;
+    }
+    while (digit(end)) {
+      ++end;
+    }
+  }
+  if (!ends_token(end)) {
+    return false;
+  }
+
+  const char *first = text_.data() + at;
+  const char *last = text_.data() + end;
+  if (integral) {
+    long long value = 0;
+    if (std::from_chars(first, last, value).ec == std::errc()) {
+      tape_ += TAG_INTEGER;
+      put_u64(tape_, static_cast<std::uint64_t>(value));
+      return true;
+    }
+    // beyond int64: stored as a double, like JavaScript would
+  }
+
+  double value = 0.0;
+  const auto result = std::from_chars(first, last, value);
+  if (result.ec == std::errc::result_out_of_range) {
+    // Underflow (1e-400) is a valid JSON number that rounds to zero;
+    // overflow (1e400) becomes infinity and is rejected below
+    value = std::strtod(std::string(first, last).c_str(), nullptr);
+  } else if (result.ec != std::errc()) {
+    return false;
+  }
+  if (!std::isfinite(value)) {
+    return false;
+  }
+  tape_ += TAG_NUMBER;
+  put_f64(tape_, value);
+  return true;
+}
+
+bool TapeBuilder::parse_hex4(std::size_t at, std::uint32_t &value) const {
+  if (at + 4 > text_.size()) {
+    return false;
+  }
+  value = 0;
+  for (std::size_t i = at; i < at + 4; ++i) {
+    const char c = text_[i];
+    std::uint32_t nibble;
+    if (c >= '0' && c <= '9') {
+      nibble = static_cast<std::uint32_t>(c - '0');
+    } else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f') {
+      nibble = static_cast<std::uint32_t>((c | 0x20) - 'a' + 10);
+    } else {
+      return false;
+    }
+    value = (value << 4) | nibble;
+  }
+  return true;
+}
+
+// Decodes the string whose opening quote is at 'at' into scratch_
+bool TapeBuilder::parse_string(std::size_t at) {
+  scratch_.clear();
+  std::size_t i = at + 1;
+  while (true) {
+    // Copy the run of ordinary bytes in one append
+    std::size_t run_end = i;
+    while (run_end < text_.size() && text_[run_end] != '"' &&
+           text_[run_end] != '\\' &&
+           static_cast<unsigned char>(text_[run_end]) >= 0x20) {
+      ++run_end;
+    }
+    scratch_.append(text_.data() + i, run_end - i);
+    i = run_end;
+    if (i >= text_.size() || static_cast<unsigned char>(text_[i]) < 0x20) {
+      return false; // unterminated, or a raw control character
+    }
+    if (text_[i] == '"') {
+      return true;
+    }
+
+    if (++i >= text_.size()) { // after the backslash
+      return false;
+    }
+    switch (text_[i]) {
+    case '"':
+    case '\\':
+    case '/':
+      scratch_ += text_[i];
+      break;
+    case 'b':
+      scratch_ += '\b';
+      break;
+    case 'f':
+      scratch_ += '\f';
+      break;
+    case 'n':
+      scratch_ += '\n';
+      break;
+    case 'r':
+      scratch_ += '\r';
+      break;
+    case 't':
+      scratch_ += '\t';
+      break;
+    case 'u': {
+      std::uint32_t code_point = 0;
+      if (!parse_hex4(i + 1, code_point)) {
+        return false;
+      }
+      i += 4;
+      if (code_point >= 0xDC00 && code_point <= 0xDFFF) {
+        return false; // a low surrogate with no high one before it
+      }
+      if (code_point >= 0xD800 && code_point <= 0xDBFF) {
+        // Characters beyond U+FFFF arrive as a surrogate PAIR: 😀
+        std::uint32_t low = 0;
+        if (i + 2 >= text_.size() || text_[i + 1] != '\\' ||
+            text_[i + 2] != 'u' || !parse_hex4(i + 3, low) || low < 0xDC00 ||
+            low > 0xDFFF) {
+          return false;
+        }
+        i += 6;
+        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+      }
+      append_utf8(scratch_, code_point);
+      break;
+    }
+    default:
+      return false;
+    }
+    ++i;
+  }
+}
+
+// =============================================================================
+// validate_value() — Is this a well-formed tape? (for snapshot loading)
+// =============================================================================
+bool validate_value(ByteReader &in, std::size_t depth) {
+  std::uint8_t tag = 0;
+  if (!in.get_u8(tag)) {
+    return false;
+  }
+  switch (static_cast<char>(tag)) {
+  case TAG_NULL:
+  case TAG_FALSE:
+  case TAG_TRUE:
+    return true;
+  case TAG_INTEGER: {
+    std::uint64_t value = 0;
+    return in.get_u64(value);
+  }
+  case TAG_NUMBER: {
+    double value = 0.0;
+    return in.get_f64(value) && std::isfinite(value);
+  }
+  case TAG_STRING: {
+    std::string_view text;
+    return in.get_short_bytes(text);
+  }
+  case TAG_ARRAY:
+  case TAG_OBJECT: {
+    std::uint32_t size = 0;
+    std::uint32_t count = 0;
+    std::string_view payload;
+    if (depth == JsonDocument::MAX_DEPTH || !in.get_u32(size) ||
+        !in.get_u32(count) || !in.get_raw(size, payload)) {
+      return false;
+    }
+    ByteReader elements(payload);
+    for (std::uint32_t i = 0; i < count; ++i) {
+      std::string_view key;
+      if ((tag == TAG_OBJECT && !elements.get_short_bytes(key)) ||
+          !validate_value(elements, depth + 1)) {
+        return false;
+      }
+    }
+    return elements.at_end();
+  }
+  default:
+    return false;
+  }
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// JsonPath::parse()
+// =============================================================================
+// Accepts "$" / "." / "" for the root, "$.a.b[0]['c d']", and the legacy
+// RedisJSON form without the dollar ("a.b", ".a.b").
+// =============================================================================
+std::optional<JsonPath> JsonPath::parse(std::string_view text) {
+  JsonPath path;
+  std::string_view rest = text;
+  bool implicit_dot = false;
+  if (!rest.empty() && rest.front() == '$') {
+    rest.remove_prefix(1);
+  } else if (rest == ".") {
+    return path;
+  } else if (!rest.empty() && rest.front() != '.' && rest.front() != '[') {
+    implicit_dot = true; // "a.b" means ".a.b"
+  }
+
+  while (!rest.empty() || implicit_dot) {
+    Step step;
+    if (implicit_dot || rest.front() == '.') {
+      if (!implicit_dot) {
+        rest.remove_prefix(1);
+      }
+      implicit_dot = false;
+      const std::size_t end = rest.find_first_of(".[");
+      step.key = std::string(rest.substr(0, end));
+      rest.remove_prefix(end == std::string_view::npos ? rest.size() : end);
+      if (step.key.empty() || step.key == "*") {
+        return std::nullopt; // empty name, or a wildcard (unsupported)
+      }
+    } else if (rest.front() == '[') {
+      const std::size_t close = rest.find(']');
+      if (close == std::string_view::npos || close < 2) {
+        return std::nullopt;
+      }
+      const std::string_view inside = rest.substr(1, close - 1);
+      rest.remove_prefix(close + 1);
+      const char quote = inside.front();
+      if (quote == '\'' || quote == '"') {
+        if (inside.size() < 2 || inside.back() != quote) {
+          return std::nullopt;
+        }
+        step.key = std::string(inside.substr(1, inside.size() - 2));
+      } else {
+        step.is_index = true;
+        const auto result = std::from_chars(
+            inside.data(), inside.data() + inside.size(), step.index);
+        if (result.ec != std::errc() ||
+            result.ptr != inside.data() + inside.size()) {
+          return std::nullopt;
+        }
+      }
+    } else {
+      return std::nullopt;
+    }
+    path.steps.push_back(std::move(step));
+  }
+  return path;
+}
+
+// =============================================================================
+// JsonDocument — parsing and printing
+// =============================================================================
+JsonDocument::JsonDocument() : tape_(1, TAG_NULL) {}
+
+std::optional<JsonDocument> JsonDocument::parse(std::string_view text) {
+  // Reused between parses on this thread: no allocation per request
+  thread_local std::vector<std::uint32_t> tokens;
+  tokens.clear();
+
+  bool ascii = true;
+  JsonDocument document;
+  document.tape_.clear();
+  document.tape_.reserve(text.size());
+  const bool ok = find_structurals(text, tokens, ascii) &&
+                  (ascii || valid_utf8(text)) &&
+                  TapeBuilder(text, tokens, document.tape_).build();
+
+  if (tokens.capacity() > MAX_KEPT_POSITIONS) {
+    std::vector<std::uint32_t>().swap(tokens);
+  }
+  if (!ok) {
+    return std::nullopt;
+  }
+  document.tape_.shrink_to_fit();
+  return document;
+}
+
+std::string JsonDocument::to_json() const {
+  std::string out;
+  write_json(0, out);
+  return out;
+}
+
+void JsonDocument::write_json(std::size_t offset, std::string &out) const {
+  switch (tape_[offset]) {
+  case TAG_NULL:
+    out += "null";
+    return;
+  case TAG_FALSE:
+    out += "false";
+    return;
+  case TAG_TRUE:
+    out += "true";
+    return;
+  case TAG_INTEGER:
+    append_integer(out, static_cast<long long>(load_u64(tape_, offset + 1)));
+    return;
+  case TAG_NUMBER:
+    append_double(out, bits_double(load_u64(tape_, offset + 1)));
+    return;
+  case TAG_STRING: {
+    std::size_t at = offset + 1;
+    const std::size_t length = load_varint(tape_, at);
+    append_quoted(out, std::string_view(tape_).substr(at, length));
+    return;
+  }
+  default:
+    break;
+  }
+
+  const bool object = tape_[offset] == TAG_OBJECT;
+  const std::uint32_t count = load_u32(tape_, offset + 5);
+  std::size_t at = offset + HEADER;
+  out += object ? '{' : '[';
+  for (std::uint32_t i = 0; i < count; ++i) {
+    if (i > 0) {
+      out += ',';
+    }
+    if (object) {
+      const std::size_t length = load_varint(tape_, at);
+      append_quoted(out, std::string_view(tape_).substr(at, length));
+      out += ':';
+      at += length;
+    }
+    write_json(at, out);
+    at = value_end(at);
+  }
+  out += object ? '}' : ']';
+}
+
+// =============================================================================
+// Navigation
+// =============================================================================
+std::size_t JsonDocument::value_end(std::size_t offset) const {
+  switch (tape_[offset]) {
+  case TAG_INTEGER:
+  case TAG_NUMBER:
+    return offset + 9;
+  case TAG_STRING: {
+    std::size_t at = offset + 1;
+    const std::size_t length = load_varint(tape_, at);
+    return at + length;
+  }
+  case TAG_ARRAY:
+  case TAG_OBJECT:
+    return offset + HEADER + load_u32(tape_, offset + 1); // skip it whole
+  default:
+    return offset + 1;
+  }
+}
+
+std::optional<std::size_t>
+JsonDocument::child(std::size_t container, const JsonPath::Step &step) const {
+  const char tag = tape_[container];
+  const long long count = load_u32(tape_, container + 5);
+  std::size_t at = container + HEADER;
+
+  if (step.is_index) {
+    const long long index = step.index < 0 ? count + step.index : step.index;
+    if (tag != TAG_ARRAY || index < 0 || index >= count) {
+      return std::nullopt;
+    }
+    for (long long i = 0; i < index; ++i) {
+      at = value_end(at);
+    }
+    return at;
+  }
+
+  if (tag != TAG_OBJECT) {
+    return std::nullopt;
+  }
+  for (long long i = 0; i < count; ++i) {
+    const std::size_t length = load_varint(tape_, at);
+    const bool match =
+        std::string_view(tape_).substr(at, length) == step.key;
+    at += length;
+    if (match) {
+      return at;
+    }
+    at = value_end(at);
+  }
+  return std::nullopt;
+}
+
+// Follows the first 'steps' steps of 'path'
+std::optional<JsonDocument::Location>
+JsonDocument::find(const JsonPath &path, std::size_t steps) const {
+  Location location;
+  for (std::size_t i = 0; i < steps; ++i) {
+    const auto next = child(location.offset, path.steps[i]);
+    if (!next.has_value()) {
+      return std::nullopt;
+    }
+    location.ancestors.push_back(location.offset);
+    location.offset = *next;
+  }
+  return location;
+}
+
+std::optional<std::string> JsonDocument::get(const JsonPath &path) const {
+  const auto location = find(path, path.steps.size());
+  if (!location.has_value()) {
+    return std::nullopt;
+  }
+  std::string out;
+  write_json(location->offset, out);
+  return out;
+}
+
+std::optional<JsonDocument::Type>
+JsonDocument::type_at(const JsonPath &path) const {
+  const auto location = find(path, path.steps.size());
+  if (!location.has_value()) {
+    return std::nullopt;
+  }
+  switch (tape_[location->offset]) {
+  case TAG_FALSE:
+  case TAG_TRUE:
+    return Type::BOOLEAN;
+  case TAG_INTEGER:
+    return Type::INTEGER;
+  case TAG_NUMBER:
+    return Type::NUMBER;
+  case TAG_STRING:
+    return Type::STRING;
+  case TAG_ARRAY:
+    return Type::ARRAY;
+  case TAG_OBJECT:
+    return Type::OBJECT;
+  default:
+    return Type::NUL;
+  }
+}
+
+const char *JsonDocument::type_name(Type type) {
+  switch (type) {
+  case Type::BOOLEAN:
+    return "boolean";
+  case Type::INTEGER:
+    return "integer";
+  case Type::NUMBER:
+    return "number";
+  case Type::STRING:
+    return "string";
+  case Type::ARRAY:
+    return "array";
+  case Type::OBJECT:
+    return "object";
+  case Type::NUL:
+    break;
+  }
+  return "null";
+}
+
+// =============================================================================
+// In-place edits
+// =============================================================================
+// splice() swaps 'erase' tape bytes at 'at.offset' for 'insert'. Every
+// container on the way down grows or shrinks by the same amount, and the
+// innermost one also gains or loses 'count_change' elements. Ancestors
+// all START before the edit, so their offsets stay valid.
+// =============================================================================
+void JsonDocument::splice(const Location &at, std::size_t erase,
+                          std::string_view insert, int count_change) {
+  tape_.replace(at.offset, erase, insert);
+  const auto delta = static_cast<std::uint32_t>(insert.size() - erase);
+  for (const std::size_t container : at.ancestors) {
+    store_u32(tape_, container + 1, load_u32(tape_, container + 1) + delta);
+  }
+  if (count_change != 0 && !at.ancestors.empty()) {
+    const std::size_t parent = at.ancestors.back();
+    store_u32(tape_, parent + 5,
+              load_u32(tape_, parent + 5) +
+                  static_cast<std::uint32_t>(count_change));
+  }
+}
+
+JsonDocument::Status JsonDocument::set(const JsonPath &path,
+                                       const JsonDocument &value) {
+  if (path.is_root()) {
+    tape_ = value.tape_;
+    return Status::OK;
+  }
+  if (path.steps.size() + value.depth() > MAX_DEPTH) {
+    return Status::TOO_DEEP;
+  }
+
+  const auto parent = find(path, path.steps.size() - 1);
+  if (!parent.has_value()) {
+    return Status::NO_PATH;
+  }
+  const JsonPath::Step &last = path.steps.back();
+  const auto existing = child(parent->offset, last);
+  Location at{existing.value_or(value_end(parent->offset)), parent->ancestors};
+  at.ancestors.push_back(parent->offset);
+
+  if (existing.has_value()) {
+    splice(at, value_end(*existing) - *existing, value.tape_, 0);
+    return Status::OK;
+  }
+  if (tape_[parent->offset] != TAG_OBJECT || last.is_index) {
+    // Arrays don't grow by assignment (use array_append), and scalars
+    // have no members
+    return tape_[parent->offset] == TAG_ARRAY && last.is_index
+               ? Status::NO_PATH
+               : Status::WRONG_TYPE;
+  }
+  std::string member;
+  put_short_bytes(member, last.key);
+  member += value.tape_;
+  splice(at, 0, member, 1);
+  return Status::OK;
+}
+
+JsonDocument::Status JsonDocument::remove(const JsonPath &path) {
+  if (path.is_root()) {
+    return Status::NO_PATH; // the caller deletes the key instead
+  }
+  const auto parent = find(path, path.steps.size() - 1);
+  if (!parent.has_value()) {
+    return Status::NO_PATH;
+  }
+  const JsonPath::Step &last = path.steps.back();
+  const auto value = child(parent->offset, last);
+  if (!value.has_value()) {
+    return Status::NO_PATH;
+  }
+
+  // An object member starts at its key, which sits just before the value
+  std::size_t start = *value;
+  if (!last.is_index) {
+    std::string key_prefix;
+    put_short_bytes(key_prefix, last.key);
+    start -= key_prefix.size();
+  }
+  Location at{start, parent->ancestors};
+  at.ancestors.push_back(parent->offset);
+  splice(at, value_end(*value) - start, {}, -1);
+  return Status::OK;
+}
+
+std::optional<std::string> JsonDocument::increment(const JsonPath &path,
+                                                   double delta) {
+  const auto location = find(path, path.steps.size());
+  if (!location.has_value()) {
+    return std::nullopt;
+  }
+  const std::size_t at = location->offset;
+  const char tag = tape_[at];
+  std::string text;
+
+  if (tag == TAG_INTEGER) {
+    const auto current = static_cast<long long>(load_u64(tape_, at + 1));
+    long long sum = 0;
+    // Both integer and number payloads are 8 bytes: the type can change
+    // in place without moving anything
+    if (std::trunc(delta) == delta && std::fabs(delta) < 9.2e18 &&
+        !__builtin_add_overflow(current, static_cast<long long>(delta),
+                                &sum)) {
+      store_u64(tape_, at + 1, static_cast<std::uint64_t>(sum));
+      append_integer(text, sum);
+      return text;
+    }
+    const double result = static_cast<double>(current) + delta;
+    if (!std::isfinite(result)) {
+      return std::nullopt;
+    }
+    tape_[at] = TAG_NUMBER;
+    store_u64(tape_, at + 1, double_bits(result));
+    append_double(text, result);
+    return text;
+  }
+
+  if (tag != TAG_NUMBER) {
+    return std::nullopt;
+  }
+  const double result = bits_double(load_u64(tape_, at + 1)) + delta;
+  if (!std::isfinite(result)) {
+    return std::nullopt;
+  }
+  store_u64(tape_, at + 1, double_bits(result));
+  append_double(text, result);
+  return text;
+}
+
+JsonDocument::Status
+JsonDocument::array_append(const JsonPath &path,
+                           const std::vector<JsonDocument> &values,
+                           std::size_t &length) {
+  const auto array = find(path, path.steps.size());
+  if (!array.has_value()) {
+    return Status::NO_PATH;
+  }
+  if (tape_[array->offset] != TAG_ARRAY) {
+    return Status::WRONG_TYPE;
+  }
+  std::string elements;
+  for (const auto &value : values) {
+    if (path.steps.size() + 1 + value.depth() > MAX_DEPTH) {
+      return Status::TOO_DEEP;
+    }
+    elements += value.tape_;
+  }
+
+  Location at{value_end(array->offset), array->ancestors};
+  at.ancestors.push_back(array->offset);
+  splice(at, 0, elements, static_cast<int>(values.size()));
+  length = load_u32(tape_, array->offset + 5);
+  return Status::OK;
+}
+
+// =============================================================================
+// depth() — How deeply nested the document is (a scalar is 0)
+// =============================================================================
+// The tape is depth-first, so one left-to-right pass with a stack of
+// "where does each open container end" tracks the current depth.
+// =============================================================================
+std::size_t JsonDocument::depth() const {
+  struct Open {
+    std::size_t end;
+    bool object;
+  };
+  std::vector<Open> open;
+  std::size_t deepest = 0;
+  std::size_t at = 0;
+  while (true) {
+    while (!open.empty() && at == open.back().end) {
+      open.pop_back();
+    }
+    if (at >= tape_.size()) {
+      return deepest;
+    }
+    if (!open.empty() && open.back().object) {
+      const std::size_t key_length = load_varint(tape_, at);
+      at += key_length; // skip the member's key
+    }
+    const char tag = tape_[at];
+    if (tag == TAG_ARRAY || tag == TAG_OBJECT) {
+      open.push_back({value_end(at), tag == TAG_OBJECT});
+      deepest = std::max(deepest, open.size());
+      at += HEADER;
+    } else {
+      at = value_end(at);
+    }
+  }
+}
+
+std::size_t JsonDocument::memory_bytes() const {
+  return sizeof(JsonDocument) + tape_.capacity();
+}
+
+// =============================================================================
+// Snapshot support
+// =============================================================================
+// The tape is already a compact binary form: it's written as-is, and only
+// checked on the way back in.
+// =============================================================================
+void JsonDocument::serialize(std::string &out) const { put_bytes(out, tape_); }
+
+std::optional<JsonDocument> JsonDocument::deserialize(ByteReader &in) {
+  JsonDocument document;
+  if (!in.get_bytes(document.tape_)) {
+    return std::nullopt;
+  }
+  ByteReader check(document.tape_);
+  if (!validate_value(check, 0) || !check.at_end()) {
+    return std::nullopt;
+  }
+  return document;
+}
+
+} // namespace mini_redis
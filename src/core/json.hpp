@@ -0,0 +1,147 @@
+// =============================================================================
+// json.hpp — JSON Document Value Type (HEADER)
+// =============================================================================
+//
+// Stores a JSON document PARSED, so the server can answer "what is
+// $.user.address.city?" by returning 20 bytes instead of making the client
+// download and parse a 50 KB document — and can change one field without
+// the client sending the whole document back (RedisJSON's JSON.GET /
+// JSON.SET with a path).
+//
+// STORAGE — A "TAPE":
+// The document lives in ONE byte string, values written one after another
+// in document order (depth-first), like a compact binary JSON:
+//
+//   null / false / true   1 byte  tag
+//   integer               tag + 8-byte int64
+//   number                tag + 8-byte double
+//   string                tag + varint length + bytes (escapes decoded)
+//   array                 tag + u32 payload size + u32 count + elements
+//   object                tag + u32 payload size + u32 count
+//                             + (varint key length + key + value) pairs
+//
+// Containers record their payload size, so a lookup SKIPS a whole subtree
+// in O(1) — finding $.a.b touches a's keys and b's keys, nothing else —
+// and there are no per-node heap allocations at all. An in-place update
+// splices new bytes into the tape and fixes the sizes of the enclosing
+// containers; replacing a number with a number overwrites 9 bytes.
+//
+// PARSING: two stages, simdjson-style (see json_scan.hpp): SIMD finds the
+// position of every token, then this file walks those positions.
+//
+// PATHS (a JSONPath subset — no wildcards or filters):
+//   $                 the whole document ("." or "" work too)
+//   $.user.name       object member
+//   $['odd key']      object member with any characters
+//   $.items[0]        array element; [-1] is the last one
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis {
+
+// =============================================================================
+// JsonPath — A parsed path: a list of member names and array indices
+// =============================================================================
+struct JsonPath {
+  struct Step {
+    bool is_index = false;
+    std::string key;     // member name (when !is_index)
+    long long index = 0; // element, negative = from the end
+  };
+  std::vector<Step> steps; // empty = the root
+
+  // ---- parse() — std::nullopt if the syntax is invalid ----
+  static std::optional<JsonPath> parse(std::string_view text);
+
+  bool is_root() const { return steps.empty(); }
+};
+
+class JsonDocument {
+public:
+  enum class Type : std::uint8_t {
+    NUL,
+    BOOLEAN,
+    INTEGER,
+    NUMBER,
+    STRING,
+    ARRAY,
+    OBJECT
+  };
+
+  // Deepest nesting accepted by parse(), so hostile input can't exhaust
+  // the stack when the document is printed
+  static constexpr std::size_t MAX_DEPTH = 512;
+
+  // What set() / remove() / array_append() found at the path. TOO_DEEP:
+  // the edit would nest the document deeper than MAX_DEPTH.
+  enum class Status { OK, NO_PATH, WRONG_TYPE, TOO_DEEP };
+
+  JsonDocument(); // the document "null"
+
+  // ---- parse() — std::nullopt unless 'text' is exactly one JSON value ----
+  static std::optional<JsonDocument> parse(std::string_view text);
+
+  // ---- Reading ----
+  // The value at 'path' as compact JSON text, or std::nullopt if absent
+  std::optional<std::string> get(const JsonPath &path) const;
+  std::optional<Type> type_at(const JsonPath &path) const;
+  std::string to_json() const;
+
+  // ---- set() — Replace the value at 'path', or add a missing member ----
+  // Objects gain the last step's key if it's missing; array elements must
+  // already exist. The root is always replaced.
+  Status set(const JsonPath &path, const JsonDocument &value);
+
+  // ---- remove() — Delete a member or element (not the root) ----
+  Status remove(const JsonPath &path);
+
+  // ---- increment() — Add 'delta' to a number; the new value as text ----
+  // Integers stay integers while the result fits; std::nullopt if the
+  // value is missing, not a number, or the result isn't finite.
+  std::optional<std::string> increment(const JsonPath &path, double delta);
+
+  // ---- array_append() — Push values onto an array; its new length ----
+  Status array_append(const JsonPath &path,
+                      const std::vector<JsonDocument> &values,
+                      std::size_t &length);
+
+  std::size_t memory_bytes() const;
+
+  static const char *type_name(Type type);
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<JsonDocument> deserialize(ByteReader &in);
+
+private:
+  // A value's position in the tape, plus every enclosing container's
+  // header offset (outermost first) — the sizes an edit has to fix
+  struct Location {
+    std::size_t offset = 0;
+    std::vector<std::size_t> ancestors;
+  };
+
+  std::optional<Location> find(const JsonPath &path,
+                               std::size_t steps) const;
+  std::optional<std::size_t> child(std::size_t container,
+                                   const JsonPath::Step &step) const;
+  std::size_t value_end(std::size_t offset) const;
+  std::size_t depth() const;
+  void splice(const Location &at, std::size_t erase, std::string_view insert,
+              int count_change);
+  void write_json(std::size_t offset, std::string &out) const;
+
+  std::string tape_;
+};
+
+} // namespace mini_redis
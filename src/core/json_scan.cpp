@@ -0,0 +1,281 @@
+// =============================================================================
+// json_scan.cpp — JSON Stage 1: Structural Indexing (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/json_scan.hpp"
+
+#include <cstring> // std::memcpy
+#include <limits>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MINI_REDIS_HAVE_SIMD_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace mini_redis {
+
+namespace {
+
+constexpr std::size_t BLOCK = 64;
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+  std::uint64_t quote = 0;
+  std::uint64_t backslash = 0;
+  std::uint64_t op = 0;         // { } [ ] : ,
+  std::uint64_t whitespace = 0; // space \t \n \r
+};
+
+// What one block hands to the next
+struct ScanState {
+  std::uint64_t prev_escaped = 0;   // bit 0: next block's byte 0 is escaped
+  std::uint64_t prev_in_string = 0; // all ones if we ended inside a string
+  std::uint64_t prev_separator = 1; // bit 0: a token may start at byte 0
+};
+
+// The last block is copied into a buffer padded with spaces, which are
+// never structural, so every kernel can always read a full 64 bytes
+const char *full_block(std::string_view text, std::size_t offset,
+                       char (&padded)[BLOCK]) {
+  const std::size_t left = text.size() - offset;
+  if (left >= BLOCK) {
+    return text.data() + offset;
+  }
+  std::memset(padded, ' ', BLOCK);
+  std::memcpy(padded, text.data() + offset, left);
+  return padded;
+}
+
+// =============================================================================
+// escaped_bits() — Bytes preceded by an ODD run of backslashes
+// =============================================================================
+// Bit-parallel version of "the byte after an unpaired backslash":
+//   - a backslash that is itself escaped starts nothing, so drop it;
+//   - 'follows_escape' = bytes right after a backslash — the candidates;
+//   - a run that starts on an EVEN bit escapes the byte at an odd offset
+//     (run of length 1: start 0 → escapes 1), so the even/odd bit pattern
+//     marks them; runs starting on ODD bits need the opposite pattern.
+//     Adding a run's start bit to the run carries one bit PAST its end,
+//     which is exactly where the pattern has to flip.
+// The carry out of bit 63 means the block ended in an odd run.
+// =============================================================================
+std::uint64_t escaped_bits(std::uint64_t backslash,
+                           std::uint64_t &prev_escaped) {
+  constexpr std::uint64_t EVEN_BITS = 0x5555555555555555ULL;
+
+  backslash &= ~prev_escaped;
+  const std::uint64_t follows_escape = (backslash << 1) | prev_escaped;
+  const std::uint64_t odd_starts = backslash & ~EVEN_BITS & ~follows_escape;
+
+  std::uint64_t flipped = 0;
+  prev_escaped = __builtin_add_overflow(odd_starts, backslash, &flipped);
+  return (EVEN_BITS ^ (flipped << 1)) & follows_escape;
+}
+
+// prefix_xor(x) bit i = x[0] ^ ... ^ x[i], by doubling the span each step
+std::uint64_t prefix_xor_portable(std::uint64_t bits) {
+  bits ^= bits << 1;
+  bits ^= bits << 2;
+  bits ^= bits << 4;
+  bits ^= bits << 8;
+  bits ^= bits << 16;
+  bits ^= bits << 32;
+  return bits;
+}
+
+// =============================================================================
+// structural_bits() — From character classes to token starts
+// =============================================================================
+// 'quotes' are the unescaped quotes; 'in_string' has 1s from each opening
+// quote up to (not including) its closing quote. A token starts at:
+//   - every operator outside a string;
+//   - every opening quote;
+//   - every other non-space byte outside a string that directly follows a
+//     SEPARATOR (operator, whitespace or closing quote): the first digit
+//     of a number, the 't' of true... and also stray garbage like the x in
+//     "a"x, so stage 2 sees it and rejects the document.
+// =============================================================================
+std::uint64_t structural_bits(const BlockMasks &masks, std::uint64_t quotes,
+                              std::uint64_t in_string, ScanState &state) {
+  state.prev_in_string =
+      static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+  const std::uint64_t outside = ~in_string;
+  const std::uint64_t ops = masks.op & outside;
+  const std::uint64_t separators =
+      ops | ((masks.whitespace | quotes) & outside);
+  const std::uint64_t scalars =
+      outside & ~(masks.op | masks.whitespace | quotes);
+  const std::uint64_t after_separator =
+      (separators << 1) | state.prev_separator;
+  state.prev_separator = separators >> 63;
+
+  return ops | (quotes & in_string) | (scalars & after_separator);
+}
+
+void append_positions(std::uint64_t bits, std::uint32_t base,
+                      std::vector<std::uint32_t> &positions) {
+  while (bits != 0) {
+    positions.push_back(base +
+                        static_cast<std::uint32_t>(__builtin_ctzll(bits)));
+    bits &= bits - 1; // clear the lowest set bit
+  }
+}
+
+bool too_long(std::string_view text) {
+  return text.size() >= std::numeric_limits<std::uint32_t>::max();
+}
+
+#ifdef MINI_REDIS_HAVE_SIMD_KERNELS
+
+// Checked once; the answers can't change while the process runs
+bool cpu_has_avx2_pclmul() {
+  static const bool has = __builtin_cpu_supports("avx2") &&
+                          __builtin_cpu_supports("pclmul");
+  return has;
+}
+
+// Carry-less multiplication by all-ones: each product bit is the XOR of
+// all input bits at or below it — the prefix XOR in one instruction
+__attribute__((target("pclmul"))) std::uint64_t
+prefix_xor_clmul(std::uint64_t bits) {
+  const __m128i product = _mm_clmulepi64_si128(
+      _mm_set_epi64x(0, static_cast<long long>(bits)), _mm_set1_epi8(-1), 0);
+  return static_cast<std::uint64_t>(_mm_cvtsi128_si64(product));
+}
+
+__attribute__((target("avx2"))) std::uint64_t to_mask(__m256i low,
+                                                      __m256i high) {
+  const auto lo = static_cast<std::uint32_t>(_mm256_movemask_epi8(low));
+  const auto hi = static_cast<std::uint32_t>(_mm256_movemask_epi8(high));
+  return lo | (static_cast<std::uint64_t>(hi) << 32);
+}
+
+// '{' and '[' differ only in bit 0x20, as do '}' and ']': OR-ing 0x20 in
+// folds the four brackets into two compares
+__attribute__((target("avx2"))) __m256i is_op(__m256i v) {
+  const __m256i folded = _mm256_or_si256(v, _mm256_set1_epi8(0x20));
+  return _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(folded, _mm256_set1_epi8('{')),
+                      _mm256_cmpeq_epi8(folded, _mm256_set1_epi8('}'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(':')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8(','))));
+}
+
+__attribute__((target("avx2"))) __m256i is_whitespace(__m256i v) {
+  return _mm256_or_si256(
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(' ')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\t'))),
+      _mm256_or_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('\n')),
+                      _mm256_cmpeq_epi8(v, _mm256_set1_epi8('\r'))));
+}
+
+__attribute__((target("avx2,pclmul"))) bool
+find_structurals_avx2(std::string_view text,
+                      std::vector<std::uint32_t> &positions, bool &ascii) {
+  ScanState state;
+  __m256i high_bits = _mm256_setzero_si256();
+  char padded[BLOCK];
+
+  for (std::size_t offset = 0; offset < text.size(); offset += BLOCK) {
+    const char *block = full_block(text, offset, padded);
+    const __m256i low =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block));
+    const __m256i high =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(block + 32));
+    high_bits = _mm256_or_si256(high_bits, _mm256_or_si256(low, high));
+
+    BlockMasks masks;
+    const __m256i quote = _mm256_set1_epi8('"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    masks.quote = to_mask(_mm256_cmpeq_epi8(low, quote),
+                          _mm256_cmpeq_epi8(high, quote));
+    masks.backslash = to_mask(_mm256_cmpeq_epi8(low, backslash),
+                              _mm256_cmpeq_epi8(high, backslash));
+    masks.op = to_mask(is_op(low), is_op(high));
+    masks.whitespace = to_mask(is_whitespace(low), is_whitespace(high));
+
+    const std::uint64_t quotes =
+        masks.quote & ~escaped_bits(masks.backslash, state.prev_escaped);
+    const std::uint64_t in_string =
+        prefix_xor_clmul(quotes) ^ state.prev_in_string;
+    append_positions(structural_bits(masks, quotes, in_string, state),
+                     static_cast<std::uint32_t>(offset), positions);
+  }
+
+  ascii = _mm256_movemask_epi8(high_bits) == 0;
+  return state.prev_in_string == 0;
+}
+
+#endif // MINI_REDIS_HAVE_SIMD_KERNELS
+
+} // anonymous namespace
+
+// =============================================================================
+// find_structurals_scalar() — The same masks, one byte at a time
+// =============================================================================
+// Escapes are tracked the obvious sequential way here, which makes this
+// the reference the bit-parallel escaped_bits() is tested against.
+// =============================================================================
+bool find_structurals_scalar(std::string_view text,
+                             std::vector<std::uint32_t> &positions,
+                             bool &ascii) {
+  if (too_long(text)) {
+    return false;
+  }
+  ScanState state;
+  bool escape_next = false;
+  unsigned char high_bits = 0;
+  char padded[BLOCK];
+
+  for (std::size_t offset = 0; offset < text.size(); offset += BLOCK) {
+    const char *block = full_block(text, offset, padded);
+    BlockMasks masks;
+    std::uint64_t escaped = 0;
+    for (std::size_t i = 0; i < BLOCK; ++i) {
+      const char c = block[i];
+      const std::uint64_t bit = std::uint64_t{1} << i;
+      high_bits |= static_cast<unsigned char>(c);
+      if (escape_next) {
+        escaped |= bit;
+        escape_next = false;
+      } else if (c == '\\') {
+        escape_next = true;
+      }
+      if (c == '"') {
+        masks.quote |= bit;
+      } else if (c == '\\') {
+        masks.backslash |= bit;
+      } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' ||
+                 c == ',') {
+        masks.op |= bit;
+      } else if (c == ' ' || c == '\t' || c == '\n' || c == '\r') {
+        masks.whitespace |= bit;
+      }
+    }
+
+    const std::uint64_t quotes = masks.quote & ~escaped;
+    const std::uint64_t in_string =
+        prefix_xor_portable(quotes) ^ state.prev_in_string;
+    append_positions(structural_bits(masks, quotes, in_string, state),
+                     static_cast<std::uint32_t>(offset), positions);
+  }
+
+  ascii = (high_bits & 0x80) == 0;
+  return state.prev_in_string == 0;
+}
+
+// =============================================================================
+// Dispatcher
+// =============================================================================
+bool find_structurals(std::string_view text,
+                      std::vector<std::uint32_t> &positions, bool &ascii) {
+#ifdef MINI_REDIS_HAVE_SIMD_KERNELS
+  if (cpu_has_avx2_pclmul()) {
+    return !too_long(text) && find_structurals_avx2(text, positions, ascii);
+  }
+#endif
+  return find_structurals_scalar(text, positions, ascii);
+}
+
+} // namespace mini_redis
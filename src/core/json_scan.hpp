@@ -0,0 +1,55 @@
+// =============================================================================
+// json_scan.hpp — JSON Stage 1: Structural Indexing (HEADER)
+// =============================================================================
+//
+// A byte-at-a-time JSON parser spends most of its time asking the same
+// questions of every character: am I inside a string? is this a quote, a
+// brace, a comma? The simdjson approach (Langdale & Lemire) splits parsing
+// in two:
+//
+//   STAGE 1 (this file): classify 64 bytes at a time with SIMD compares,
+//     turning each question into a 64-bit mask — bit i answers it for
+//     byte i — and combine the masks with plain integer arithmetic into
+//     the list of STRUCTURAL positions: every { } [ ] : , outside strings,
+//     every opening quote, and the first byte of every number/true/false/
+//     null. Whitespace and string contents never reach stage 2.
+//   STAGE 2 (json.cpp): walk that list and build the document — it jumps
+//     from token to token instead of scanning bytes.
+//
+// THE TRICKY PART — "inside a string?" without a loop:
+//   1. Escaped characters: a quote preceded by an ODD run of backslashes
+//      (\" or \\\") is escaped; after an even run (\\") it isn't. Runs are
+//      found with carry propagation: adding a run's start bit to the run
+//      ripples a carry to just past its end.
+//   2. With the real quotes as bits, "inside a string" is the PREFIX XOR
+//      of the quote mask: bit i = quotes[0] ^ quotes[1] ^ ... ^ quotes[i].
+//      One carry-less multiplication by all-ones (PCLMULQDQ) computes it;
+//      without it, six shift-and-xor steps do.
+// Both carry their state across 64-byte blocks.
+//
+// As in set_ops.hpp, the kernel is picked at RUNTIME (AVX2 + PCLMULQDQ or
+// portable), and both produce identical positions.
+// =============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis {
+
+// ---- find_structurals() — Stage 1 over the whole text ----
+// Appends the structural positions (ascending) to 'positions' and sets
+// 'ascii' to whether the text is pure 7-bit ASCII (if so, stage 2 can skip
+// UTF-8 validation). Returns false if a string is left unterminated or the
+// text is too long to index with 32-bit positions.
+bool find_structurals(std::string_view text,
+                      std::vector<std::uint32_t> &positions, bool &ascii);
+
+// ---- Portable version (exposed for tests and benchmarks) ----
+bool find_structurals_scalar(std::string_view text,
+                             std::vector<std::uint32_t> &positions,
+                             bool &ascii);
+
+} // namespace mini_redis
@@ -3,10 +3,43 @@
 // =============================================================================
 
 #include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
 #include "util/logger.hpp"
 
+#include <algorithm> // std::min
+#include <cstdint>   // UINT64_MAX
+#include <string>
+#include <utility> // std::as_const, std::move
+
 namespace mini_redis {
 
+// =============================================================================
+// parse_integer_key() — Canonical decimal → uint64_t
+// =============================================================================
+// Runs on EVERY key of every request, so it fails fast: "user:42" is
+// rejected at its first byte. At most 20 digits; the overflow check
+// rejects the 20-digit strings above 18446744073709551615.
+// =============================================================================
+std::optional<std::uint64_t> parse_integer_key(std::string_view key) {
+  constexpr std::size_t MAX_DIGITS = 20;
+  if (key.empty() || key.size() > MAX_DIGITS ||
+      (key[0] == '0' && key.size() > 1)) {
+    return std::nullopt;
+  }
+  std::uint64_t number = 0;
+  for (const char c : key) {
+    if (c < '0' || c > '9') {
+      return std::nullopt;
+    }
+    const auto digit = static_cast<std::uint64_t>(c - '0');
+    if (number > (UINT64_MAX - digit) / 10) {
+      return std::nullopt;
+    }
+    number = number * 10 + digit;
+  }
+  return number;
+}
+
 // =============================================================================
 // get() — Retrieve a value, checking for expiration
 // =============================================================================
@@ -19,23 +52,172 @@ namespace mini_redis {
 // with periodic cleanup (background thread) for keys nobody accesses.
 // =============================================================================
 std::optional<std::string> KeyValueStore::get(const std::string &key) {
-  // Retrieve the entry from the thread-safe map
-  const auto entry = store_.get(key);
-
-  // If key doesn't exist, return nullopt
-  if (!entry.has_value()) {
+  auto encoded = get_encoded(key);
+  if (!encoded.has_value()) {
     return std::nullopt;
   }
+  if (encoded->codec == ValueCodec::NONE) {
+    return std::move(encoded->bytes);
+  }
+  // Decompressed AFTER the shard lock is released: only the (smaller)
+  // compressed bytes were copied while holding it
+  return decompress_string(encoded->codec, encoded->bytes)
+      .value_or(std::string());
+}
+
+std::optional<EncodedValue>
+KeyValueStore::get_encoded(const std::string &key) {
+  // Inspect the entry IN PLACE rather than copying it out with store_.get():
+  // the entry might hold a huge sorted set we'd otherwise copy for nothing.
+  // Small values first: answered without taking any lock
+  if (auto text = inline_values_.read(key)) {
+    return EncodedValue{std::move(*text), ValueCodec::NONE};
+  }
+
+  // The key is hashed once, even when the expired entry has to be removed
+  std::optional<EncodedValue> result;
+  bool expired = false;
+  bool other_type = false;
+  const auto inspect = [&](const StoreEntry &entry) {
+    if (is_expired(entry)) {
+      expired = true;
+      return;
+    }
+    // Only string values can be returned by a plain GET
+    if (const auto *text = string_value(entry.value)) {
+      result = EncodedValue{*text, ValueCodec::NONE};
+    } else if (const auto *packed =
+                   std::get_if<CompressedString>(&entry.value)) {
+      result = EncodedValue{packed->bytes, packed->codec};
+    } else {
+      other_type = true;
+    }
+  };
+
+  route(key, [&](auto &table, const auto &table_key) {
+    const std::uint64_t hash = table.hash_of(table_key);
+    table.read(table_key, hash, inspect);
+    // If key exists but is expired, remove it and return nullopt — unless
+    // another thread has written it since the read lock was released
+    if (expired) {
+      table.compute(table_key, hash, [&](StoreEntry &entry, bool exists) {
+        if (!exists || is_expired(entry)) {
+          mirror_write(key, nullptr);
+          return false;
+        }
+        return true;
+      });
+    }
+  });
 
-  // If key exists but is expired, remove it and return nullopt
-  if (is_expired(entry.value())) {
-    store_.remove(key);
+  if (expired) {
     Logger::info("Key '" + key + "' expired (lazy deletion)");
+  }
+  if (!result.has_value() && !other_type && backing_ != nullptr) {
+    return read_through(key);
+  }
+  return result;
+}
+
+// =============================================================================
+// read_through() — Load a missing key, and cache it unless a write raced
+// =============================================================================
+// The load runs with no lock held; the loaded value is then inserted under
+// the shard lock, and only if nothing happened to the key meanwhile:
+//   - the key is back in the cache (a SET, or another miss's load): what
+//     it holds now is newer, and is what we return
+//   - the key was written since the load started (its generation moved):
+//     the loaded value may be stale, so it isn't cached, and the answer
+//     comes from a second load, which sees that write
+// =============================================================================
+std::optional<EncodedValue>
+KeyValueStore::read_through(const std::string &key) {
+  const std::uint64_t generation = backing_->generation(key);
+  std::optional<std::string> loaded = backing_->load(key);
+  if (!loaded.has_value()) {
     return std::nullopt;
   }
 
-  // Key exists and is not expired — return the value
-  return entry.value().value;
+  StoreEntry fresh{*loaded, std::nullopt};
+  maybe_compress(fresh.value);
+  maybe_intern(fresh.value);
+
+  std::optional<EncodedValue> current;
+  bool superseded = false;
+  bool raced = false;
+  route(key, [&](auto &table, const auto &table_key) {
+    table.compute(table_key, [&](StoreEntry &slot, bool exists) {
+      if (exists && !is_expired(slot)) {
+        superseded = true;
+        if (const auto *text = string_value(slot.value)) {
+          current = EncodedValue{*text, ValueCodec::NONE};
+        } else if (const auto *packed =
+                       std::get_if<CompressedString>(&slot.value)) {
+          current = EncodedValue{packed->bytes, packed->codec};
+        }
+        return true;
+      }
+      if (backing_->generation(key) != generation) {
+        raced = true;
+        if (exists) {
+          mirror_write(key, nullptr); // the expired entry goes
+        }
+        return false;
+      }
+      slot = std::move(fresh);
+      mirror_write(key, &slot);
+      return true;
+    });
+  });
+
+  if (superseded) {
+    return current;
+  }
+  if (raced) {
+    loaded = backing_->load(key);
+    if (!loaded.has_value()) {
+      return std::nullopt;
+    }
+  }
+  return EncodedValue{std::move(*loaded), ValueCodec::NONE};
+}
+
+bool KeyValueStore::cached(const std::string &key) const {
+  bool live = false;
+  route(key, [&](const auto &table, const auto &table_key) {
+    table.read(table_key,
+               [&](const StoreEntry &entry) { live = !is_expired(entry); });
+  });
+  return live;
+}
+
+void KeyValueStore::load_if_missing(const std::string &key) {
+  if (!cached(key)) {
+    read_through(key);
+  }
+}
+
+std::vector<std::optional<std::string>>
+KeyValueStore::get_many(const std::vector<std::string> &keys) {
+  std::vector<std::optional<std::string>> results(keys.size());
+  std::vector<std::size_t> misses;
+  std::as_const(*this).read_values(
+      keys, [&](const std::vector<const StoreValue *> &values) {
+        for (std::size_t i = 0; i < values.size(); ++i) {
+          if (values[i] == nullptr) {
+            misses.push_back(i);
+          } else if (const auto *text = string_value(*values[i])) {
+            results[i] = *text;
+          }
+        }
+      });
+  // Outside the batch's locks: a load is a round trip to the backing store
+  if (backing_ != nullptr) {
+    for (const std::size_t i : misses) {
+      results[i] = get(keys[i]);
+    }
+  }
+  return results;
 }
 
 // =============================================================================
@@ -48,9 +230,21 @@ void KeyValueStore::set(const std::string &key, const std::string &value,
   //   .value = the string value
   //   .expires_at = calculated expiration time (or nullopt if ttl_seconds == 0)
   StoreEntry entry{value, calculate_expiry(ttl_seconds)};
+  maybe_compress(entry.value);
+  maybe_intern(entry.value);
 
   // Store it in the thread-safe map
-  store_.set(key, entry);
+  route(key, [&](auto &table, const auto &table_key) {
+    table.compute(table_key, [&](StoreEntry &slot, bool /*exists*/) {
+      slot = std::move(entry);
+      mirror_write(key, &slot);
+      // A TTL'd value isn't sent (see set_backing_store())
+      if (backing_ != nullptr && ttl_seconds <= 0) {
+        backing_->enqueue(BackingWrite{key, value});
+      }
+      return true;
+    });
+  });
 
   // Log what we did
   if (ttl_seconds > 0) {
@@ -65,7 +259,22 @@ void KeyValueStore::set(const std::string &key, const std::string &value,
 // remove() — Delete a key-value pair
 // =============================================================================
 bool KeyValueStore::remove(const std::string &key) {
-  const bool removed = store_.remove(key);
+  // A key only the backing store holds is deleted all the same: ask it
+  // first (without caching the value), so the answer says whether
+  // anything was
+  bool removed = backing_ != nullptr && !cached(key) &&
+                 backing_->load(key).has_value();
+  route(key, [&](auto &table, const auto &table_key) {
+    table.compute(table_key, [&](StoreEntry & /*entry*/, bool exists) {
+      removed = removed || exists;
+      mirror_write(key, nullptr);
+      // Even when it wasn't cached: the backing store may still have it
+      if (backing_ != nullptr) {
+        backing_->enqueue(BackingWrite{key, std::nullopt});
+      }
+      return false;
+    });
+  });
 
   if (removed) {
     Logger::info("DEL '" + key + "' — removed");
@@ -91,23 +300,40 @@ std::vector<std::string> KeyValueStore::keys() const {
       result.push_back(key);
     }
   });
+  integer_store_.for_each(
+      [&result](std::uint64_t key, const StoreEntry &entry) {
+        if (!is_expired(entry)) {
+          result.push_back(std::to_string(key));
+        }
+      });
 
   return result;
 }
 
+KeyCounts KeyValueStore::key_counts() const {
+  return KeyCounts{integer_store_.size(), store_.size()};
+}
+
+void KeyValueStore::reserve(std::size_t count) { store_.reserve(count); }
+
 // =============================================================================
 // cleanup_expired() — Bulk remove all expired entries
 // =============================================================================
-std::size_t KeyValueStore::cleanup_expired() {
+std::size_t KeyValueStore::cleanup_expired(const EntryCallback &on_removed) {
   // remove_if takes a predicate (a function that returns true/false).
   // For each entry where is_expired returns true, remove it.
-  const std::size_t count = store_.remove_if(
-      [](const std::string & /*key*/, const StoreEntry &entry) {
-        //                ^^^^^^^^^
-        // The /*key*/ notation means "I'm not using this parameter."
-        // Commenting out the name prevents "unused parameter" warnings.
-        return is_expired(entry);
-      });
+  const auto expired = [&](const auto &key, const StoreEntry &entry) {
+    if (!is_expired(entry)) {
+      return false;
+    }
+    if (on_removed) {
+      on_removed(key_text(key), entry);
+    }
+    mirror_write(key_text(key), nullptr);
+    return true;
+  };
+  const std::size_t count =
+      store_.remove_if(expired) + integer_store_.remove_if(expired);
 
   if (count > 0) {
     Logger::info("Cleanup: removed " + std::to_string(count) +
@@ -117,6 +343,362 @@ std::size_t KeyValueStore::cleanup_expired() {
   return count;
 }
 
+// =============================================================================
+// defrag_step() — Relocate entries out of sparse slabs
+// =============================================================================
+// The node (key + StoreEntry) is moved by the map. A string value's heap
+// buffer (plain or compressed) is a separate block, so it gets its own
+// check: copying the string allocates a fresh buffer (in a dense slab,
+// thanks to the RelocationScope) and the swap frees the old one. Short
+// strings live inside the node (small-string optimisation) and move with
+// it. Other value types keep their internal blocks where they are.
+//
+// One pass covers the string table, then the integer table. A cursor
+// into the integer table has INTEGER_TABLE_CURSOR set; the map's own
+// cursors never reach that bit (shard << 48 | bucket).
+// =============================================================================
+namespace {
+
+constexpr std::size_t INTEGER_TABLE_CURSOR = std::size_t{1} << 63;
+
+void relocate_buffer(std::string &text) {
+  if (text.empty()) {
+    return;
+  }
+  const char *data = text.data();
+  const auto *self = reinterpret_cast<const char *>(&text);
+  const bool inline_buffer = data >= self && data < self + sizeof(text);
+  if (!inline_buffer && Allocator::should_relocate(data)) {
+    std::string fresh(text);
+    text.swap(fresh);
+  }
+}
+
+} // anonymous namespace
+
+KeyValueStore::DefragResult
+KeyValueStore::defrag_step(std::size_t cursor, std::size_t max_buckets) {
+  const Allocator::RelocationScope relocating;
+  const auto should_move = [](const void *node) {
+    return Allocator::should_relocate(node);
+  };
+  const auto relocate_value = [](StoreEntry &entry) {
+    if (auto *text = std::get_if<std::string>(&entry.value)) {
+      relocate_buffer(*text);
+    } else if (auto *packed = std::get_if<CompressedString>(&entry.value)) {
+      relocate_buffer(packed->bytes);
+    }
+  };
+
+  if ((cursor & INTEGER_TABLE_CURSOR) == 0) {
+    DefragResult step =
+        store_.relocate(cursor, max_buckets, should_move, relocate_value);
+    if (step.cursor == 0) {
+      step.cursor = INTEGER_TABLE_CURSOR; // strings done: integers next
+    }
+    return step;
+  }
+
+  const auto step = integer_store_.relocate(
+      cursor & ~INTEGER_TABLE_CURSOR, max_buckets, should_move,
+      relocate_value);
+  const std::size_t next =
+      step.cursor == 0 ? 0 : (step.cursor | INTEGER_TABLE_CURSOR);
+  return DefragResult{next, step.visited, step.moved};
+}
+
+// =============================================================================
+// for_each_entry() / restore() — Whole-entry access for snapshots
+// =============================================================================
+void KeyValueStore::for_each_entry(
+    const std::function<void(const std::string &, const StoreEntry &)>
+        &callback) const {
+  const auto integer_locks = integer_store_.lock_all_shared();
+  const auto string_locks = store_.lock_all_shared();
+  integer_store_.for_each_locked(
+      integer_locks, [&callback](std::uint64_t key, const StoreEntry &entry) {
+        if (!is_expired(entry)) {
+          callback(std::to_string(key), entry);
+        }
+      });
+  store_.for_each_locked(string_locks, [&callback](const std::string &key,
+                                                   const StoreEntry &entry) {
+    if (!is_expired(entry)) {
+      callback(key, entry);
+    }
+  });
+}
+
+void KeyValueStore::restore(const std::string &key, StoreEntry entry) {
+  maybe_compress(entry.value);
+  maybe_intern(entry.value);
+  const auto replace = [&](StoreEntry &slot, bool /*exists*/) {
+    slot = std::move(entry);
+    mirror_write(key, &slot);
+    write_behind(key, &slot);
+    return true;
+  };
+  route(key, [&replace](auto &table, const auto &table_key) {
+    table.compute(table_key, replace);
+  });
+}
+
+// Each batch is split between the tables like read_entries() does; the
+// key strings move into the batch, and mirror_write() reads them there
+void KeyValueStore::restore_many(
+    std::vector<std::pair<std::string, StoreEntry>> entries) {
+  for (auto &[key, entry] : entries) {
+    maybe_compress(entry.value);
+    maybe_intern(entry.value);
+  }
+
+  std::vector<std::uint64_t> numbers;
+  std::vector<std::string> names;
+  std::vector<StoreEntry *> number_entries;
+  std::vector<StoreEntry *> name_entries;
+  for (std::size_t begin = 0; begin < entries.size(); begin += RESTORE_BATCH) {
+    const std::size_t end = std::min(entries.size(), begin + RESTORE_BATCH);
+    numbers.clear();
+    names.clear();
+    number_entries.clear();
+    name_entries.clear();
+    for (std::size_t i = begin; i < end; ++i) {
+      auto &[key, entry] = entries[i];
+      if (const auto number = parse_integer_key(key)) {
+        numbers.push_back(*number);
+        number_entries.push_back(&entry);
+      } else {
+        names.push_back(std::move(key));
+        name_entries.push_back(&entry);
+      }
+    }
+
+    integer_store_.compute_many(
+        numbers, [&](std::size_t i, StoreEntry &slot, bool /*exists*/) {
+          slot = std::move(*number_entries[i]);
+          mirror_write(key_text(numbers[i]), &slot);
+          write_behind(key_text(numbers[i]), &slot);
+          return true;
+        });
+    store_.compute_many(
+        names, [&](std::size_t i, StoreEntry &slot, bool /*exists*/) {
+          slot = std::move(*name_entries[i]);
+          mirror_write(names[i], &slot);
+          write_behind(names[i], &slot);
+          return true;
+        });
+  }
+}
+
+void KeyValueStore::read_values(
+    const std::vector<std::string> &keys,
+    const std::function<void(const std::vector<const StoreValue *> &)> &reader)
+    const {
+  read_entries(keys, [&](const std::vector<const StoreEntry *> &entries) {
+    std::vector<const StoreValue *> values;
+    values.reserve(entries.size());
+    // Compressed strings are handed over decompressed; reserved up front
+    // so the pointers in 'values' stay valid
+    std::vector<StoreValue> expanded;
+    expanded.reserve(entries.size());
+    for (const StoreEntry *entry : entries) {
+      if (entry == nullptr || is_expired(*entry)) {
+        values.push_back(nullptr);
+      } else if (const auto *packed =
+                     std::get_if<CompressedString>(&entry->value)) {
+        expanded.emplace_back(expand(*packed));
+        values.push_back(&expanded.back());
+      } else {
+        values.push_back(&entry->value);
+      }
+    }
+    reader(values);
+  });
+}
+
+void KeyValueStore::read_values(
+    const std::vector<std::string> &keys,
+    const std::function<void(const std::vector<const StoreValue *> &)>
+        &reader) {
+  if (backing_ != nullptr) {
+    for (const std::string &key : keys) {
+      load_if_missing(key);
+    }
+  }
+  std::as_const(*this).read_values(keys, reader);
+}
+
+// =============================================================================
+// read_entries() — Split the keys between the tables, read both at once
+// =============================================================================
+// Almost every multi-key read names keys of one kind only: those go
+// straight to that table, with no second lock round and no re-ordering.
+// =============================================================================
+void KeyValueStore::read_entries(
+    const std::vector<std::string> &keys,
+    const std::function<void(const std::vector<const StoreEntry *> &)> &reader)
+    const {
+  std::vector<std::uint64_t> numbers;
+  std::vector<std::string> names;
+  // Where keys[i] went: its index in 'numbers' or 'names'
+  std::vector<std::size_t> position(keys.size());
+  std::vector<bool> is_number(keys.size());
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    if (const auto number = parse_integer_key(keys[i])) {
+      is_number[i] = true;
+      position[i] = numbers.size();
+      numbers.push_back(*number);
+    } else {
+      position[i] = names.size();
+      names.push_back(keys[i]);
+    }
+  }
+
+  if (numbers.empty()) {
+    store_.read_many(keys, reader);
+    return;
+  }
+  if (names.empty()) {
+    integer_store_.read_many(numbers, reader);
+    return;
+  }
+  integer_store_.read_many(
+      numbers, [&](const std::vector<const StoreEntry *> &by_number) {
+        store_.read_many(
+            names, [&](const std::vector<const StoreEntry *> &by_name) {
+              std::vector<const StoreEntry *> entries;
+              entries.reserve(keys.size());
+              for (std::size_t i = 0; i < keys.size(); ++i) {
+                entries.push_back(is_number[i] ? by_number[position[i]]
+                                               : by_name[position[i]]);
+              }
+              reader(entries);
+            });
+      });
+}
+
+// =============================================================================
+// Value deduplication
+// =============================================================================
+// Interning happens BEFORE the shard lock is taken: the table has its own
+// mutex, and hashing a large value is the expensive part.
+// =============================================================================
+void KeyValueStore::set_dedup_min_bytes(std::size_t min_bytes) {
+  interned_.set_min_bytes(min_bytes);
+}
+
+InternStats KeyValueStore::dedup_stats() const { return interned_.stats(); }
+
+void KeyValueStore::maybe_intern(StoreValue &value) {
+  auto *text = std::get_if<std::string>(&value);
+  if (text != nullptr && interned_.should_intern(text->size())) {
+    value = interned_.intern(std::move(*text));
+  }
+}
+
+// =============================================================================
+// Transparent compression
+// =============================================================================
+// Like interning, done before the shard lock is taken: compressing a
+// large value is by far the most expensive part of such a SET.
+// =============================================================================
+void KeyValueStore::set_compression_min_bytes(std::size_t min_bytes) {
+  compress_min_bytes_.store(min_bytes, std::memory_order_relaxed);
+}
+
+CompressionStats KeyValueStore::compression_stats() const {
+  CompressionStats stats;
+  stats.min_bytes = compress_min_bytes_.load(std::memory_order_relaxed);
+  stats.compressed = compressed_count_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_count_.load(std::memory_order_relaxed);
+  stats.raw_bytes = compress_raw_bytes_.load(std::memory_order_relaxed);
+  stats.compressed_bytes =
+      compress_stored_bytes_.load(std::memory_order_relaxed);
+  return stats;
+}
+
+void KeyValueStore::maybe_compress(StoreValue &value) {
+  const std::size_t threshold =
+      compress_min_bytes_.load(std::memory_order_relaxed);
+  auto *text = std::get_if<std::string>(&value);
+  if (threshold == 0 || text == nullptr || text->size() < threshold) {
+    return;
+  }
+  auto packed = compress_string(*text);
+  if (!packed.has_value()) {
+    rejected_count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  compressed_count_.fetch_add(1, std::memory_order_relaxed);
+  compress_raw_bytes_.fetch_add(text->size(), std::memory_order_relaxed);
+  compress_stored_bytes_.fetch_add(packed->bytes.size(),
+                                   std::memory_order_relaxed);
+  value = std::move(*packed);
+}
+
+// =============================================================================
+// Lock-free reads of small values
+// =============================================================================
+// Only plain and interned strings are copied: a compressed value is never
+// small, and any other type makes the copy go away.
+// =============================================================================
+void KeyValueStore::set_inline_read_max_bytes(std::size_t max_bytes) {
+  inline_values_.set_max_bytes(max_bytes);
+}
+
+InlineValueStats KeyValueStore::inline_value_stats() const {
+  return inline_values_.stats();
+}
+
+// =============================================================================
+// Read-through / write-behind
+// =============================================================================
+void KeyValueStore::set_backing_store(std::shared_ptr<BackingStore> backing,
+                                      const WriteBehindOptions &options) {
+  if (backing == nullptr) {
+    backing_.reset();
+    return;
+  }
+  backing_ = std::make_unique<CacheBacking>(std::move(backing), options);
+}
+
+bool KeyValueStore::flush_backing_store() {
+  return backing_ != nullptr && backing_->flush();
+}
+
+std::optional<BackingStats> KeyValueStore::backing_stats() const {
+  if (backing_ == nullptr) {
+    return std::nullopt;
+  }
+  return backing_->stats();
+}
+
+void KeyValueStore::mirror_write(const std::string &key,
+                                 const StoreEntry *entry) {
+  const std::string *text =
+      entry == nullptr ? nullptr : string_value(entry->value);
+  inline_values_.update(key, text,
+                        entry == nullptr ? std::nullopt : entry->expires_at);
+}
+
+void KeyValueStore::write_behind(const std::string &key,
+                                 const StoreEntry *entry) {
+  if (backing_ == nullptr ||
+      (entry != nullptr && entry->expires_at.has_value())) {
+    return;
+  }
+  std::optional<std::string> value;
+  if (entry != nullptr) {
+    if (const auto *text = string_value(entry->value)) {
+      value = *text;
+    } else if (const auto *packed =
+                   std::get_if<CompressedString>(&entry->value)) {
+      value = expand(*packed);
+    }
+  }
+  backing_->enqueue(BackingWrite{key, std::move(value)});
+}
+
 // =============================================================================
 // is_expired() — Check if a StoreEntry has passed its expiration time
 // =============================================================================
@@ -6,6 +6,9 @@
 // ThreadSafeHashMap and adds:
 //   1. TTL (Time-To-Live) — keys can expire after a set number of seconds
 //   2. A StoreEntry struct that holds both the value and expiration time
+//   3. Two tables behind one interface: keys that are plain integers
+//      ("10293", "1700000000123456789") go to a table keyed by the
+//      number itself, every other key to the string-keyed table
 //
 // DESIGN PRINCIPLE: Single Responsibility (the "S" in SOLID)
 // ThreadSafeHashMap handles thread-safe data access.
@@ -28,15 +31,114 @@
 
 #pragma once
 
+#include "core/backing_store.hpp"
+#include "core/bloom_filter.hpp"
+#include "core/compressed_string.hpp"
+#include "core/count_min_sketch.hpp"
+#include "core/hyperloglog.hpp"
+#include "core/inline_values.hpp"
+#include "core/intern_table.hpp"
+#include "core/json.hpp"
+#include "core/quick_list.hpp"
+#include "core/roaring_bitmap.hpp"
+#include "core/set.hpp"
+#include "core/sorted_set.hpp"
+#include "core/stream.hpp"
 #include "core/thread_safe_hash_map.hpp"
+#include "core/time_series.hpp"
+#include "core/vector_index.hpp"
 
+#include <atomic>
 #include <chrono> // For time-related types (steady_clock, duration)
+#include <cstdint>
+#include <functional>
+#include <memory> // std::unique_ptr, std::shared_ptr
 #include <optional>
 #include <string>
+#include <string_view>
+#include <type_traits> // std::is_same_v — compile-time type checks
+#include <utility>     // std::as_const, std::pair
+#include <variant>     // std::variant — a type-safe union
 #include <vector>
 
 namespace mini_redis {
 
+// =============================================================================
+// StoreValue — Every kind of value a key can hold
+// =============================================================================
+// WHAT IS std::variant?
+// A variant holds exactly ONE of a fixed list of types at a time — a
+// type-safe replacement for a C union. It always knows which type is
+// active, and std::get<T> / std::get_if<T> refuse to give you the wrong one.
+//
+//   StoreValue v = std::string("hello"); // holds a string
+//   v = SortedSet{};                     // now holds a sorted set
+//   v = QuickList{};                     // now holds a list
+//   std::holds_alternative<QuickList>(v) // → true
+//
+// Plain strings come FIRST so that a default-constructed StoreValue is an
+// empty string, and StoreEntry{"text", expiry} still compiles unchanged.
+//
+// SharedString is ALSO a string value, just one stored once for many keys
+// (see intern_table.hpp). Code that reads strings goes through
+// string_value() below, or read_as<std::string>, which accept both.
+//
+// CompressedString is a string value kept LZ4-compressed (see
+// compressed_string.hpp). string_value() can't hand out its bytes — they
+// aren't the value — so the store's readers (get, read_as, read_many_as,
+// read_values) decompress it first; handlers never see one.
+// =============================================================================
+using StoreValue =
+    std::variant<std::string, SortedSet, QuickList, Set, HyperLogLog,
+                 BloomFilter, CountMinSketch, RoaringBitmap, TimeSeries,
+                 Stream, VectorIndex, JsonDocument, SharedString,
+                 CompressedString>;
+
+// ---- string_value() — The bytes of a string value, shared or not ----
+// nullptr if 'value' holds some other type.
+inline const std::string *string_value(const StoreValue &value) {
+  if (const auto *shared = std::get_if<SharedString>(&value)) {
+    return &shared->str();
+  }
+  return std::get_if<std::string>(&value);
+}
+
+// ---- typed_value<T>() — std::get_if<T>, and SharedString counts as a string
+template <typename T> const T *typed_value(const StoreValue &value) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    return string_value(value);
+  } else {
+    return std::get_if<T>(&value);
+  }
+}
+
+// =============================================================================
+// AccessStatus — Outcome of a typed access (read_as / modify_as)
+// =============================================================================
+// OK         : the callback ran
+// NOT_FOUND  : the key doesn't exist (or has expired)
+// WRONG_TYPE : the key exists but holds a different kind of value
+//              (like Redis' "WRONGTYPE Operation against a key...")
+// =============================================================================
+enum class AccessStatus { OK, NOT_FOUND, WRONG_TYPE };
+
+// =============================================================================
+// EncodedValue — A string value as stored, possibly still compressed
+// =============================================================================
+struct EncodedValue {
+  std::string bytes;
+  ValueCodec codec = ValueCodec::NONE; // NONE: 'bytes' is the value itself
+};
+
+// ---- CompressionStats — What set() did with values above the threshold
+struct CompressionStats {
+  std::uint64_t min_bytes = 0;        // values this size or larger are tried
+  std::uint64_t compressed = 0;       // stored compressed
+  std::uint64_t rejected = 0;         // didn't shrink enough, stored as-is
+  std::uint64_t raw_bytes = 0;        // input size of the compressed ones
+  std::uint64_t compressed_bytes = 0; // ... and what they were stored as
+};
+
 // =============================================================================
 // StoreEntry — What we actually store in the map
 // =============================================================================
@@ -50,8 +152,8 @@ namespace mini_redis {
 // time — so a struct is appropriate.
 // =============================================================================
 struct StoreEntry {
-  // The actual value stored
-  std::string value;
+  // The actual value stored (a string, a sorted set, ...)
+  StoreValue value;
 
   // When this entry expires. std::nullopt means "never expires."
   //
@@ -65,6 +167,30 @@ struct StoreEntry {
   std::optional<std::chrono::steady_clock::time_point> expires_at;
 };
 
+// =============================================================================
+// parse_integer_key() — Is this key stored in the integer table?
+// =============================================================================
+// Yes for the CANONICAL decimal form of a value in [0, 2^64): digits only,
+// no sign, no leading zero. "42" does; "042", "+42", "-1" and "4.2" don't
+// and stay strings. Canonical means std::to_string() gives the key back
+// byte for byte, so "42" and "042" can never end up as one key.
+//
+// WHY BOTHER?
+// Numeric IDs are a large share of real keyspaces. As a std::string, each
+// one costs a 32-byte string object in the node (plus a heap buffer past
+// 15 digits — every 19-digit snowflake ID) and a hash over its digits. As
+// a uint64_t: 8 bytes, inline, hashed by one multiply, compared with one
+// instruction.
+// =============================================================================
+std::optional<std::uint64_t> parse_integer_key(std::string_view key);
+
+// ---- KeyCounts — How many entries each table holds ----
+// Expired keys count until they are removed.
+struct KeyCounts {
+  std::size_t integer = 0;
+  std::size_t string = 0;
+};
+
 // =============================================================================
 // KeyValueStore — The main storage interface
 // =============================================================================
@@ -73,9 +199,23 @@ public:
   // ---- get() — Retrieve a value by key ----
   // Returns std::nullopt if:
   //   - Key doesn't exist, OR
-  //   - Key exists but has expired (lazy deletion — we check on access)
+  //   - Key exists but has expired (lazy deletion — we check on access), OR
+  //   - Key holds a non-string value (e.g. a sorted set)
   std::optional<std::string> get(const std::string &key);
 
+  // ---- get_encoded() — get(), but compressed values stay compressed ----
+  // For handing the stored bytes to a client that can decode them itself.
+  std::optional<EncodedValue> get_encoded(const std::string &key);
+
+  // ---- get_many() — get() for several keys (MGET) ----
+  // One result per key, in order. Every key is looked up under one round
+  // of read locks, with the buckets prefetched ahead of the probes (see
+  // read_many() in thread_safe_hash_map.hpp). Expired keys read as
+  // missing but are left to the background cleaner. With a backing store
+  // attached, the misses then read through one by one, as in get().
+  std::vector<std::optional<std::string>>
+  get_many(const std::vector<std::string> &keys);
+
   // ---- set() — Store a key-value pair ----
   // ttl_seconds: how many seconds until this key expires
   //   - 0 means "never expire"
@@ -84,18 +224,192 @@ public:
            int ttl_seconds = 0);
 
   // ---- remove() — Delete a key ----
-  // Returns true if the key existed and was removed
+  // Returns true if the key existed and was removed: in the cache, or
+  // (with a backing store attached) only in the backing store
   bool remove(const std::string &key);
 
   // ---- keys() — List all non-expired keys ----
   std::vector<std::string> keys() const;
 
+  // ---- key_counts() — Entries in the integer and string tables ----
+  KeyCounts key_counts() const;
+
+  // ---- reserve() — Pre-size the string table for 'count' keys in all ----
+  // For bulk imports that know their size. The integer table is left to
+  // grow: which keys will be integers isn't known up front.
+  void reserve(std::size_t count);
+
   // ---- cleanup_expired() — Remove all expired entries ----
   // Called periodically by the ExpiryManager background thread.
-  // Returns the number of entries removed.
-  std::size_t cleanup_expired();
+  // Returns the number of entries removed. 'on_removed', if set, sees
+  // each entry just before it goes (a namespace credits its quota).
+  using EntryCallback =
+      std::function<void(const std::string &, const StoreEntry &)>;
+  std::size_t cleanup_expired(const EntryCallback &on_removed = nullptr);
+
+  // ---- defrag_step() — One bounded slice of active defragmentation ----
+  // Moves entries (and string values) that sit in sparsely used allocator
+  // slabs into fresh, dense ones; see core/defragmenter.hpp. Visits up to
+  // 'max_buckets' hash buckets of one shard from 'cursor'; pass the
+  // returned cursor back in, 0 = a full pass (over both tables) is done.
+  using DefragResult =
+      ThreadSafeHashMap<std::string, StoreEntry>::RelocateResult;
+  DefragResult defrag_step(std::size_t cursor, std::size_t max_buckets);
+
+  // ---- Value deduplication (see intern_table.hpp) ----
+  // String values of at least 'min_bytes' written by set() or restore()
+  // are stored once and shared between keys; 0 turns it off. Values
+  // already shared stay shared.
+  void set_dedup_min_bytes(std::size_t min_bytes);
+  InternStats dedup_stats() const;
+
+  // ---- Transparent compression (see compressed_string.hpp) ----
+  // String values of at least 'min_bytes' written by set() or restore()
+  // are stored LZ4-compressed when that saves at least 1/8; 0 turns it
+  // off. Existing values keep their encoding. Compression comes before
+  // dedup, so a value is either compressed or shared, never both.
+  void set_compression_min_bytes(std::size_t min_bytes);
+  CompressionStats compression_stats() const;
+
+  // ---- Lock-free GETs of small values (see inline_values.hpp) ----
+  // String values of at most 'max_bytes' (capped at INLINE_VALUE_BYTES)
+  // under keys of at most INLINE_KEY_BYTES are also kept in a seqlock-
+  // guarded table that get() reads without locking; 0 turns it off.
+  // Values written before it was turned on are picked up on their next
+  // write.
+  void set_inline_read_max_bytes(std::size_t max_bytes);
+  InlineValueStats inline_value_stats() const;
+
+  // ---- Read-through / write-behind (see backing_store.hpp) ----
+  // A get() that misses loads the key from 'backing' and caches it, and
+  // every change to a string value (set(), remove(), modify_as<string>,
+  // restore()) queues the key's new value. Only plain string values are
+  // sent: typed values (sorted sets, lists...) stay in memory. The
+  // backing store has no expiry, so a write with a TTL isn't sent at all:
+  // it overrides the system of record's value only in the cache, and
+  // once it has expired the next get() loads that value again. Attach
+  // before the store is shared between threads; nullptr detaches (after
+  // sending the queue).
+  void set_backing_store(std::shared_ptr<BackingStore> backing,
+                         const WriteBehindOptions &options = {});
+  // Send every queued write now and wait; false if the backing store
+  // failed (or none is attached)
+  bool flush_backing_store();
+  // std::nullopt when no backing store is attached
+  std::optional<BackingStats> backing_stats() const;
+
+  // ---- for_each_entry() — Visit every live (non-expired) entry ----
+  // Runs under the read locks of BOTH tables, taken together before the
+  // walk: it sees the store at one instant (a snapshot or an export never
+  // holds half of a write), and writers wait until the walk finishes, so
+  // keep the callback quick. Integer keys arrive first, in decimal form.
+  void for_each_entry(
+      const std::function<void(const std::string &, const StoreEntry &)>
+          &callback) const;
+
+  // ---- restore() — Insert a complete entry (value + expiry) as-is ----
+  // Overwrites any existing value, whatever its type (snapshot loading,
+  // and commands like BITOP that replace the destination wholesale).
+  // Written behind like set(): a typed value queues a delete.
+  void restore(const std::string &key, StoreEntry entry);
+
+  // ---- restore_many() — restore() for a whole batch ----
+  // Loads RESTORE_BATCH entries per round of shard locks, prefetching
+  // ahead of each insert: what snapshot loading uses.
+  static constexpr std::size_t RESTORE_BATCH = 256;
+  void restore_many(std::vector<std::pair<std::string, StoreEntry>> entries);
+
+  // ---- read_as<T>() — Inspect a typed value in place (shared lock) ----
+  // Runs 'reader' on the value at 'key' if it holds a T.
+  // Example: store.read_as<SortedSet>("board", [&](const SortedSet &z) {...});
+  // Through a non-const store, a string key the cache doesn't hold is
+  // first loaded from the backing store, as get() would (GETBIT and
+  // BITCOUNT must agree with GET); the const overload only reads.
+  template <typename T>
+  AccessStatus read_as(const std::string &key,
+                       const std::function<void(const T &)> &reader) const;
+  template <typename T>
+  AccessStatus read_as(const std::string &key,
+                       const std::function<void(const T &)> &reader);
+
+  // ---- read_many_as<T>() — Inspect several typed values at once ----
+  // All keys are read under ONE lock, so the reader sees a consistent
+  // snapshot (SINTER over three keys never mixes old and new data).
+  // Missing or expired keys arrive as nullptr; if ANY key holds another
+  // type the reader is not called and WRONG_TYPE is returned.
+  template <typename T>
+  AccessStatus read_many_as(
+      const std::vector<std::string> &keys,
+      const std::function<void(const std::vector<const T *> &)> &reader) const;
+
+  // ---- read_values() — Like read_many_as(), but for values of ANY type ----
+  // For commands that accept several representations of one logical type
+  // (BITOP over plain and roaring bitmaps); the reader inspects each
+  // StoreValue itself. Missing or expired keys arrive as nullptr. The
+  // non-const overload reads missing keys through first, like read_as().
+  void read_values(const std::vector<std::string> &keys,
+                   const std::function<void(const std::vector<const StoreValue *> &)>
+                       &reader) const;
+  void read_values(const std::vector<std::string> &keys,
+                   const std::function<void(const std::vector<const StoreValue *> &)>
+                       &reader);
+
+  // ---- modify_as<T>() — Mutate a typed value in place (exclusive lock) ----
+  // create_if_missing: insert an empty T first when the key is absent
+  //                    (ZADD creates a set; ZREM on a missing key does not).
+  // The mutator returns whether the key should be KEPT — returning false
+  // deletes it, which is how "removing the last member deletes the key"
+  // is implemented. An existing TTL is preserved. For a std::string, a
+  // key only the backing store has is loaded first, and the result is
+  // written behind.
+  template <typename T>
+  AccessStatus modify_as(const std::string &key, bool create_if_missing,
+                         const std::function<bool(T &)> &mutator);
+
+  // ---- modify_each_as<T>() — Mutate EVERY live value of type T ----
+  // One pass under the exclusive lock; background maintenance only
+  // (the expiry manager trims time series to their retention window).
+  template <typename T>
+  void modify_each_as(const std::function<void(T &)> &mutator);
 
 private:
+  using StringTable = ThreadSafeHashMap<std::string, StoreEntry>;
+  using IntegerTable = ThreadSafeHashMap<std::uint64_t, StoreEntry>;
+
+  // ---- route() — Run fn(table, key) on the table that holds 'key' ----
+  // The integer table with the parsed number, or the string table with
+  // the key as given. 'fn' is a generic lambda: it is compiled once per
+  // table, and each copy talks to its map directly.
+  template <typename Fn> decltype(auto) route(const std::string &key, Fn &&fn);
+  template <typename Fn>
+  decltype(auto) route(const std::string &key, Fn &&fn) const;
+
+  // ---- mirror_write() — Keep the inline copy of 'key' in step ----
+  // Called after EVERY change to an entry, while its shard is still
+  // locked exclusively; 'entry' is what the key holds now, or nullptr.
+  void mirror_write(const std::string &key, const StoreEntry *entry);
+
+  // ---- write_behind() — Queue what the backing store should now hold ----
+  // The entry's string value, or a delete for a typed value or a key that
+  // is gone (nullptr). Nothing for a value with a TTL, which stays in the
+  // cache (see set_backing_store()), nor without a backing store.
+  void write_behind(const std::string &key, const StoreEntry *entry);
+
+  // A table key as the client spelled it
+  static const std::string &key_text(const std::string &key) { return key; }
+  static std::string key_text(std::uint64_t key) {
+    return std::to_string(key);
+  }
+
+  // ---- read_entries() — read_many() across both tables ----
+  // When the keys span both, the integer table's shards are locked first
+  // and the string table's inside: always that order, and nothing else
+  // ever holds locks in both tables, so two readers can't deadlock.
+  void read_entries(
+      const std::vector<std::string> &keys,
+      const std::function<void(const std::vector<const StoreEntry *> &)>
+          &reader) const;
+
   // ---- Helper: check if an entry has expired ----
   // "static" here means the function doesn't need an object to call it
   // AND it doesn't access any member variables.
@@ -105,10 +419,226 @@ private:
   static std::optional<std::chrono::steady_clock::time_point>
   calculate_expiry(int ttl_seconds);
 
-  // The underlying thread-safe map
-  // Key = std::string (the key name)
+  // ---- read_through() — A get() miss, answered by the backing store ----
+  std::optional<EncodedValue> read_through(const std::string &key);
+
+  // True if the cache holds a live (unexpired) entry for 'key'
+  bool cached(const std::string &key) const;
+
+  // ---- load_if_missing() — read_through() unless 'key' is cached ----
+  // Before a string is modified in place: SETBIT on a key that was never
+  // read must start from the stored bytes, not from "".
+  void load_if_missing(const std::string &key);
+
+  // Replace a large enough string value with its compressed form
+  void maybe_compress(StoreValue &value);
+
+  // Replace a large enough string value with its interned copy
+  void maybe_intern(StoreValue &value);
+
+  std::atomic<std::size_t> compress_min_bytes_{0};
+  std::atomic<std::uint64_t> compressed_count_{0};
+  std::atomic<std::uint64_t> rejected_count_{0};
+  std::atomic<std::uint64_t> compress_raw_bytes_{0};
+  std::atomic<std::uint64_t> compress_stored_bytes_{0};
+
+  // Declared before store_: entries point into it
+  InternTable interned_;
+
+  InlineValues inline_values_;
+
+  // nullptr unless a backing store is attached
+  std::unique_ptr<CacheBacking> backing_;
+
+  // The underlying thread-safe maps
+  // Key = std::string (the key name), or its number (parse_integer_key)
   // Value = StoreEntry (value + expiration)
-  ThreadSafeHashMap<std::string, StoreEntry> store_;
+  StringTable store_;
+  IntegerTable integer_store_;
 };
 
+// =============================================================================
+// TEMPLATE IMPLEMENTATION (must live in the header — see
+// thread_safe_hash_map.hpp for why)
+// =============================================================================
+template <typename Fn>
+decltype(auto) KeyValueStore::route(const std::string &key, Fn &&fn) {
+  if (const auto number = parse_integer_key(key)) {
+    return fn(integer_store_, *number);
+  }
+  return fn(store_, key);
+}
+
+template <typename Fn>
+decltype(auto) KeyValueStore::route(const std::string &key, Fn &&fn) const {
+  if (const auto number = parse_integer_key(key)) {
+    return fn(integer_store_, *number);
+  }
+  return fn(store_, key);
+}
+
+template <typename T>
+AccessStatus
+KeyValueStore::read_as(const std::string &key,
+                       const std::function<void(const T &)> &reader) const {
+  AccessStatus status = AccessStatus::NOT_FOUND;
+
+  const auto inspect = [&](const StoreEntry &entry) {
+    if (is_expired(entry)) {
+      return; // expired = not found; the cleanup thread will reclaim it
+    }
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (const auto *packed = std::get_if<CompressedString>(&entry.value)) {
+        reader(expand(*packed));
+        status = AccessStatus::OK;
+        return;
+      }
+    }
+    // std::get_if returns a pointer to the T inside the variant, or
+    // nullptr if the variant currently holds some other type
+    const T *typed = typed_value<T>(entry.value);
+    if (typed == nullptr) {
+      status = AccessStatus::WRONG_TYPE;
+      return;
+    }
+    reader(*typed);
+    status = AccessStatus::OK;
+  };
+  route(key, [&](const auto &table, const auto &table_key) {
+    table.read(table_key, inspect);
+  });
+
+  return status;
+}
+
+template <typename T>
+AccessStatus
+KeyValueStore::read_as(const std::string &key,
+                       const std::function<void(const T &)> &reader) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    if (backing_ != nullptr) {
+      load_if_missing(key);
+    }
+  }
+  return std::as_const(*this).template read_as<T>(key, reader);
+}
+
+template <typename T>
+AccessStatus KeyValueStore::read_many_as(
+    const std::vector<std::string> &keys,
+    const std::function<void(const std::vector<const T *> &)> &reader) const {
+  AccessStatus status = AccessStatus::OK;
+
+  read_entries(keys, [&](const std::vector<const StoreEntry *> &entries) {
+    std::vector<const T *> typed;
+    typed.reserve(entries.size());
+    // Decompressed strings; reserved so the pointers in 'typed' stay valid
+    std::vector<std::string> expanded;
+    for (const StoreEntry *entry : entries) {
+      if (entry == nullptr || is_expired(*entry)) {
+        typed.push_back(nullptr);
+        continue;
+      }
+      if constexpr (std::is_same_v<T, std::string>) {
+        if (const auto *packed = std::get_if<CompressedString>(&entry->value)) {
+          expanded.reserve(entries.size());
+          expanded.push_back(expand(*packed));
+          typed.push_back(&expanded.back());
+          continue;
+        }
+      }
+      const T *value = typed_value<T>(entry->value);
+      if (value == nullptr) {
+        status = AccessStatus::WRONG_TYPE;
+        return;
+      }
+      typed.push_back(value);
+    }
+    reader(typed);
+  });
+
+  return status;
+}
+
+template <typename T>
+AccessStatus KeyValueStore::modify_as(const std::string &key,
+                                      bool create_if_missing,
+                                      const std::function<bool(T &)> &mutator) {
+  AccessStatus status = AccessStatus::NOT_FOUND;
+  if constexpr (std::is_same_v<T, std::string>) {
+    if (backing_ != nullptr) {
+      load_if_missing(key);
+    }
+  }
+
+  const auto update = [&](StoreEntry &entry, bool exists) {
+    // An expired entry is treated exactly like a missing one
+    if (exists && is_expired(entry)) {
+      exists = false;
+      entry = StoreEntry{};
+    }
+
+    if (!exists) {
+      if (!create_if_missing) {
+        return false; // nothing to modify, don't insert anything
+      }
+      entry.value = T{};
+    }
+
+    // Interned bytes are shared with other keys: mutate a private copy.
+    // Compressed bytes can't be edited in place: the value stays plain
+    // from here until the next SET (SETBIT runs of a large bitmap would
+    // otherwise recompress it on every bit).
+    if constexpr (std::is_same_v<T, std::string>) {
+      if (const auto *shared = std::get_if<SharedString>(&entry.value)) {
+        entry.value = std::string(shared->str());
+      } else if (const auto *packed =
+                     std::get_if<CompressedString>(&entry.value)) {
+        entry.value = expand(*packed);
+      }
+    }
+
+    T *typed = std::get_if<T>(&entry.value);
+    if (typed == nullptr) {
+      status = AccessStatus::WRONG_TYPE;
+      return true; // leave the existing (other-typed) value alone
+    }
+
+    status = AccessStatus::OK;
+    return mutator(*typed);
+  };
+  route(key, [&](auto &table, const auto &table_key) {
+    table.compute(table_key, [&](StoreEntry &entry, bool exists) {
+      const bool keep = update(entry, exists);
+      mirror_write(key, keep ? &entry : nullptr);
+      if constexpr (std::is_same_v<T, std::string>) {
+        if (status == AccessStatus::OK) {
+          write_behind(key, keep ? &entry : nullptr);
+        }
+      }
+      return keep;
+    });
+  });
+
+  return status;
+}
+
+template <typename T>
+void KeyValueStore::modify_each_as(const std::function<void(T &)> &mutator) {
+  const auto visit = [&](const auto &key, StoreEntry &entry) {
+    if (is_expired(entry)) {
+      return; // about to be removed anyway
+    }
+    if (T *typed = std::get_if<T>(&entry.value)) {
+      mutator(*typed);
+      if constexpr (std::is_same_v<T, std::string>) {
+        mirror_write(key_text(key), &entry);
+        write_behind(key_text(key), &entry);
+      }
+    }
+  };
+  integer_store_.update_each(visit);
+  store_.update_each(visit);
+}
+
 } // namespace mini_redis
@@ -0,0 +1,733 @@
+// =============================================================================
+// map_policies.hpp — Storage and Locking Policies for ThreadSafeHashMap
+// =============================================================================
+//
+// WHAT IS POLICY-BASED DESIGN?
+// Instead of one map class with every choice baked in, the choices become
+// TEMPLATE PARAMETERS — small classes ("policies") with an agreed-upon
+// interface, picked at compile time:
+//
+//   ThreadSafeHashMap<std::string, Entry>                         defaults
+//   ThreadSafeHashMap<std::uint64_t, std::uint64_t, FlatStorage, SeqLock>
+//   ThreadSafeHashMap<int, int, OrderedStorage, NoLock, 1>       one shard
+//
+// Because the policy is a type, not a runtime flag or a virtual call, the
+// compiler sees the exact table and lock in every call and inlines them:
+// each combination costs what a hand-written map for it would. A wrong
+// combination is a compile error rather than a slow path.
+//
+// STORAGE POLICIES — how one shard keeps its entries:
+//   NodeStorage    std::unordered_map: one heap node per entry; pointers
+//                  to entries stay valid while other keys are inserted.
+//   FlatStorage    open addressing: entries live IN the slot array, so a
+//                  lookup is one or two cache lines instead of a pointer
+//                  chase. Linear probing, backward-shift deletion.
+//   OrderedStorage std::map: a balanced tree, iterated in key order;
+//                  O(log n) lookups — the baseline the others beat.
+//
+// LOCK POLICIES — how one shard is guarded (all are "mutex types" in the
+// standard's sense, so std::lock_guard / std::shared_lock work on them):
+//   SharedMutexLock  std::shared_mutex: readers in parallel, one writer.
+//   SpinLock         one atomic flag; readers are exclusive too. Cheapest
+//                    when critical sections are a few dozen nanoseconds.
+//   SeqLock          a spinlock for writers plus a SEQUENCE counter they
+//                    bump before and after writing. With FlatStorage and
+//                    trivially copyable keys and values, get() copies the
+//                    entry WITHOUT locking and retries if the counter
+//                    moved — readers write no shared memory at all.
+//   NoLock           nothing: for shards only ever touched by one thread.
+// =============================================================================
+
+#pragma once
+
+#include "util/allocator.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm> // std::min
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator> // std::next
+#include <map>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <thread> // std::this_thread::yield
+#include <type_traits>
+#include <unordered_map>
+#include <utility> // std::pair, std::move
+#include <vector>
+
+namespace mini_redis {
+
+// =============================================================================
+// KeyHasher — The 64-bit hash that picks a key's shard and bucket
+// =============================================================================
+// String keys use the seeded fast_hash64 (via hash_key(), see hash.hpp),
+// 64-bit integer keys the seeded hash_integer_key() (the store's integer
+// table, see key_value_store.hpp).
+// Anything else goes through std::hash, whose result for integers is often
+// the integer itself: multiplying by 2^64 / golden ratio spreads every
+// input bit into the HIGH bits, which are the ones that pick the shard.
+// =============================================================================
+template <typename Key> struct KeyHasher {
+  std::uint64_t operator()(const Key &key) const {
+    return static_cast<std::uint64_t>(std::hash<Key>{}(key)) *
+           0x9e3779b97f4a7c15ULL;
+  }
+};
+
+template <> struct KeyHasher<std::string> {
+  std::uint64_t operator()(const std::string &key) const {
+    return hash_key(key);
+  }
+};
+
+template <> struct KeyHasher<std::uint64_t> {
+  std::uint64_t operator()(std::uint64_t key) const {
+    return hash_integer_key(key);
+  }
+};
+
+namespace detail {
+
+// =============================================================================
+// HintedHasher — Reuse a hash that was already computed
+// =============================================================================
+// std::unordered_map (C++17) has no "find with this precomputed hash" call:
+// find(key) always runs the hasher on 'key'. But it runs it on the very
+// object we passed in — so before each probe, the map publishes that
+// object's ADDRESS and hash in a thread-local slot, and the hasher returns
+// the stored hash when it's asked about that same object. Any other call
+// (a key it hasn't seen) just computes the hash, so the hint can only save
+// work, never produce a wrong answer.
+// =============================================================================
+struct HashHint {
+  const void *key = nullptr;
+  std::uint64_t hash = 0;
+};
+
+inline thread_local HashHint hash_hint;
+
+template <typename Key> struct HintedHasher {
+  std::size_t operator()(const Key &key) const {
+    if (hash_hint.key == &key) {
+      return static_cast<std::size_t>(hash_hint.hash);
+    }
+    return static_cast<std::size_t>(KeyHasher<Key>{}(key));
+  }
+};
+
+// Publishes a hint for ONE table call, and withdraws it afterwards so a
+// later object at the same address can't pick up a stale hash
+class ScopedHashHint {
+public:
+  ScopedHashHint(const void *key, std::uint64_t hash) {
+    hash_hint = {key, hash};
+  }
+  ~ScopedHashHint() { hash_hint = {}; }
+
+  ScopedHashHint(const ScopedHashHint &) = delete;
+  ScopedHashHint &operator=(const ScopedHashHint &) = delete;
+};
+
+// ---- What relocate() hands every table (see ThreadSafeHashMap) ----
+template <typename Value> struct RelocateHooks {
+  const std::function<bool(const void *)> &should_move;
+  const std::function<void(Value &)> &relocate_value;
+  std::size_t visited = 0;
+  std::size_t moved = 0;
+};
+
+} // namespace detail
+
+// =============================================================================
+// THE STORAGE INTERFACE
+// =============================================================================
+// A storage policy is a struct with a nested `template <K, V> class Table`
+// offering (every 'hash' is KeyHasher<K>'s, computed once by the map):
+//
+//   V *find(const K &, std::uint64_t hash)            (and a const version)
+//   void insert_or_assign(const K &, std::uint64_t hash, const V &)
+//   void insert_new(const K &, std::uint64_t hash, V &&)  key is absent
+//   bool erase(const K &, std::uint64_t hash)
+//   std::size_t size() const
+//   void for_each(F)   F(const K &, const V &)
+//   void update_each(F) F(const K &, V &)
+//   std::size_t erase_if(P)   P(const K &, const V &)
+//   std::size_t relocate(position, max_steps, RelocateHooks &)
+//       → the position to resume from, 0 once the table is done
+//   void prefetch(const K &, std::uint64_t hash) const
+//       → a HINT: start loading the memory find() will touch first
+//   void reserve(std::size_t count)
+//       → room for 'count' entries without growing on the way (bulk loads)
+//
+// Pointers returned by find() are only good until the next insert or
+// erase — the map only uses them under the shard's lock.
+// =============================================================================
+
+// =============================================================================
+// NodeStorage — std::unordered_map (the original table)
+// =============================================================================
+struct NodeStorage {
+  template <typename K, typename V> class Table {
+  public:
+    V *find(const K &key, std::uint64_t hash) {
+      const detail::ScopedHashHint hint(&key, hash);
+      const auto it = map_.find(key);
+      return it == map_.end() ? nullptr : &it->second;
+    }
+    const V *find(const K &key, std::uint64_t hash) const {
+      const detail::ScopedHashHint hint(&key, hash);
+      const auto it = map_.find(key);
+      return it == map_.end() ? nullptr : &it->second;
+    }
+
+    // The first node of the key's bucket. Reaching it already loads the
+    // bucket array slot (and the node before it, in libstdc++'s singly
+    // linked layout) — loads that don't depend on other keys', so several
+    // of them are in flight when this runs for a batch.
+    void prefetch(const K &key, std::uint64_t hash) const {
+      const detail::ScopedHashHint hint(&key, hash);
+      const std::size_t bucket = map_.bucket(key);
+      const auto first = map_.begin(bucket);
+      if (first != map_.end(bucket)) {
+        __builtin_prefetch(&*first);
+      }
+    }
+
+    void insert_or_assign(const K &key, std::uint64_t hash, const V &value) {
+      const detail::ScopedHashHint hint(&key, hash);
+      map_.insert_or_assign(key, value);
+    }
+    void insert_new(const K &key, std::uint64_t hash, V &&value) {
+      const detail::ScopedHashHint hint(&key, hash);
+      map_.try_emplace(key, std::move(value));
+    }
+
+    bool erase(const K &key, std::uint64_t hash) {
+      const detail::ScopedHashHint hint(&key, hash);
+      return map_.erase(key) > 0;
+    }
+
+    std::size_t size() const { return map_.size(); }
+    void reserve(std::size_t count) { map_.reserve(count); }
+
+    template <typename F> void for_each(F &&callback) const {
+      for (const auto &[key, value] : map_) {
+        callback(key, value);
+      }
+    }
+    template <typename F> void update_each(F &&callback) {
+      for (auto &[key, value] : map_) {
+        callback(key, value);
+      }
+    }
+
+    template <typename P> std::size_t erase_if(P &&predicate) {
+      std::size_t removed = 0;
+      // erase() returns an iterator to the NEXT element, so we only
+      // advance ourselves when nothing was erased
+      for (auto it = map_.begin(); it != map_.end();) {
+        if (predicate(it->first, it->second)) {
+          it = map_.erase(it);
+          ++removed;
+        } else {
+          ++it;
+        }
+      }
+      return removed;
+    }
+
+    // Positions are bucket indices; a moving node is extracted and
+    // re-created while the old one is still held, so the allocator can't
+    // hand the same memory back
+    std::size_t relocate(std::size_t bucket, std::size_t max_buckets,
+                         detail::RelocateHooks<V> &hooks) {
+      // Pick first, move second: re-inserting while walking a bucket
+      // could visit the new node again
+      std::vector<K> moving;
+      const std::size_t end =
+          std::min(map_.bucket_count(), bucket + max_buckets);
+      for (; bucket < end; ++bucket) {
+        for (auto it = map_.begin(bucket); it != map_.end(bucket); ++it) {
+          ++hooks.visited;
+          hooks.relocate_value(it->second);
+          if (hooks.should_move(&*it)) {
+            moving.push_back(it->first); // a fresh copy of the key, too
+          }
+        }
+      }
+      for (K &key : moving) {
+        auto old_node = map_.extract(key);
+        map_.emplace(std::move(key), std::move(old_node.mapped()));
+        ++hooks.moved;
+      } // old_node freed here, after its replacement exists
+      return bucket < map_.bucket_count() ? bucket : 0;
+    }
+
+  private:
+    // Nodes and bucket arrays come from Allocator (per-thread caches, or
+    // jemalloc/mimalloc when configured), not straight from malloc
+    std::unordered_map<K, V, detail::HintedHasher<K>, std::equal_to<K>,
+                       StlAllocator<std::pair<const K, V>>>
+        map_;
+  };
+};
+
+// =============================================================================
+// FlatStorage — Open addressing with linear probing
+// =============================================================================
+// One array of slots; a key's home slot is hash & mask, and a collision
+// takes the next free slot after it. Each slot keeps the full hash, so a
+// probe compares keys only when the hashes match, and growing the array
+// never re-hashes a key.
+//
+//   [ . | a | b | c | . | . | d | . ]     a, b, c all hash to slot 1
+//
+// DELETION WITHOUT TOMBSTONES ("backward shift"): erasing b would break
+// the probe chain a → b → c (c's lookup would stop at the hole), so every
+// entry after the hole that is NOT at its home slot is moved one step
+// back into it, until an empty slot or an entry already at home. Lookups
+// stay short forever, with no periodic cleanup.
+//
+// The array doubles once 3/4 full: linear probing's expected probe count
+// climbs steeply past that.
+//
+// OPTIMISTIC READS (with SeqLock): find_unlocked() may run WHILE a writer
+// changes the table; the SeqLock's counter tells the caller afterwards
+// whether to trust the result. It must never touch freed memory, so once
+// retain_retired_arrays() is called the table keeps old slot arrays after
+// growing instead of freeing them (they sum to less than the live array,
+// as the size doubles each time), and publishes the current array and
+// mask through atomics, array first. That sum only holds while the table
+// never replaces an array at the SAME size, so relocate() leaves the slot
+// array of such a table where it is (its values are still offered).
+// =============================================================================
+struct FlatStorage {
+  template <typename K, typename V> class Table {
+    struct Slot {
+      std::uint64_t hash = 0;
+      std::optional<std::pair<K, V>> entry; // empty slot = no value
+    };
+    using Slots = std::vector<Slot, StlAllocator<Slot>>;
+
+  public:
+    // Racy reads are only harmless if copying a torn value can't crash
+    static constexpr bool SUPPORTS_OPTIMISTIC_READS =
+        std::is_trivially_copyable_v<K> && std::is_trivially_copyable_v<V>;
+
+    Table() { resize(INITIAL_CAPACITY); }
+
+    V *find(const K &key, std::uint64_t hash) {
+      const std::size_t index = find_index(key, hash);
+      return index == NOT_FOUND ? nullptr : &slots_[index].entry->second;
+    }
+    const V *find(const K &key, std::uint64_t hash) const {
+      const std::size_t index = find_index(key, hash);
+      return index == NOT_FOUND ? nullptr : &slots_[index].entry->second;
+    }
+
+    // The home slot: the probe starts there and usually ends in the same
+    // cache line
+    void prefetch(const K & /*key*/, std::uint64_t hash) const {
+      __builtin_prefetch(&slots_[hash & mask_]);
+    }
+
+    void insert_or_assign(const K &key, std::uint64_t hash, const V &value) {
+      if (V *existing = find(key, hash)) {
+        *existing = value;
+        return;
+      }
+      insert_new(key, hash, V(value));
+    }
+
+    void insert_new(const K &key, std::uint64_t hash, V &&value) {
+      if ((size_ + 1) * 4 > slots_.size() * 3) {
+        resize(slots_.size() * 2);
+      }
+      std::size_t index = hash & mask_;
+      while (slots_[index].entry.has_value()) {
+        index = (index + 1) & mask_;
+      }
+      slots_[index].hash = hash;
+      slots_[index].entry.emplace(key, std::move(value));
+      ++size_;
+    }
+
+    bool erase(const K &key, std::uint64_t hash) {
+      const std::size_t index = find_index(key, hash);
+      if (index == NOT_FOUND) {
+        return false;
+      }
+      erase_at(index);
+      return true;
+    }
+
+    std::size_t size() const { return size_; }
+
+    // Doubles up front as often as insert_new() would on the way, in one
+    // rehash instead of one per doubling
+    void reserve(std::size_t count) {
+      std::size_t capacity = slots_.size();
+      while (count * 4 > capacity * 3) {
+        capacity *= 2;
+      }
+      if (capacity != slots_.size()) {
+        resize(capacity);
+      }
+    }
+
+    template <typename F> void for_each(F &&callback) const {
+      for (const Slot &slot : slots_) {
+        if (slot.entry.has_value()) {
+          callback(slot.entry->first, slot.entry->second);
+        }
+      }
+    }
+    template <typename F> void update_each(F &&callback) {
+      for (Slot &slot : slots_) {
+        if (slot.entry.has_value()) {
+          callback(std::as_const(slot.entry->first), slot.entry->second);
+        }
+      }
+    }
+
+    // Backward shift can move a not-yet-visited entry behind the cursor,
+    // so erase in a second pass
+    template <typename P> std::size_t erase_if(P &&predicate) {
+      std::vector<std::pair<K, std::uint64_t>> doomed;
+      for (const Slot &slot : slots_) {
+        if (slot.entry.has_value() &&
+            predicate(slot.entry->first, slot.entry->second)) {
+          doomed.emplace_back(slot.entry->first, slot.hash);
+        }
+      }
+      for (const auto &[key, hash] : doomed) {
+        erase(key, hash);
+      }
+      return doomed.size();
+    }
+
+    // Positions are slot indices. Entries have no nodes of their own:
+    // the only block to move is the slot array, checked at position 0 —
+    // unless retired arrays are kept: each pass would retire a full-size
+    // copy, and retained memory would grow by one array per pass
+    std::size_t relocate(std::size_t position, std::size_t max_slots,
+                         detail::RelocateHooks<V> &hooks) {
+      if (position == 0 && !retain_retired_ &&
+          hooks.should_move(slots_.data())) {
+        resize(slots_.size()); // a fresh array, same capacity
+        hooks.moved += size_;
+      }
+      const std::size_t end = std::min(slots_.size(), position + max_slots);
+      for (; position < end; ++position) {
+        if (slots_[position].entry.has_value()) {
+          ++hooks.visited;
+          hooks.relocate_value(slots_[position].entry->second);
+        }
+      }
+      return position < slots_.size() ? position : 0;
+    }
+
+    // ---- Optimistic reads (see the class comment) ----
+    void retain_retired_arrays() { retain_retired_ = true; }
+
+    // May run concurrently with a writer: every load below may see a
+    // half-written slot, and the caller discards the result if so. The
+    // probe is bounded by the capacity it read, so even garbage ends.
+    std::optional<V> find_unlocked(const K &key, std::uint64_t hash) const {
+      const std::size_t mask = published_mask_.load(std::memory_order_acquire);
+      const Slot *slots = published_slots_.load(std::memory_order_acquire);
+      std::size_t index = hash & mask;
+      for (std::size_t probes = 0; probes <= mask; ++probes) {
+        const Slot &slot = slots[index];
+        if (!slot.entry.has_value()) {
+          return std::nullopt;
+        }
+        if (slot.hash == hash && slot.entry->first == key) {
+          return slot.entry->second;
+        }
+        index = (index + 1) & mask;
+      }
+      return std::nullopt;
+    }
+
+  private:
+    static constexpr std::size_t INITIAL_CAPACITY = 16; // a power of two
+    static constexpr std::size_t NOT_FOUND = ~std::size_t{0};
+
+    std::size_t find_index(const K &key, std::uint64_t hash) const {
+      std::size_t index = hash & mask_;
+      while (slots_[index].entry.has_value()) {
+        if (slots_[index].hash == hash && slots_[index].entry->first == key) {
+          return index;
+        }
+        index = (index + 1) & mask_;
+      }
+      return NOT_FOUND;
+    }
+
+    void erase_at(std::size_t hole) {
+      slots_[hole].entry.reset();
+      --size_;
+      for (std::size_t next = (hole + 1) & mask_;
+           slots_[next].entry.has_value(); next = (next + 1) & mask_) {
+        // How far 'next' is from home, and from the hole: it may move
+        // back only if that doesn't put it before its home slot
+        const std::size_t home = slots_[next].hash & mask_;
+        if (((next - home) & mask_) < ((next - hole) & mask_)) {
+          continue;
+        }
+        slots_[hole].hash = slots_[next].hash;
+        slots_[hole].entry = std::move(slots_[next].entry);
+        slots_[next].entry.reset();
+        hole = next;
+      }
+    }
+
+    void resize(std::size_t capacity) {
+      Slots fresh(capacity);
+      const std::size_t mask = capacity - 1;
+      for (Slot &slot : slots_) {
+        if (slot.entry.has_value()) {
+          std::size_t index = slot.hash & mask;
+          while (fresh[index].entry.has_value()) {
+            index = (index + 1) & mask;
+          }
+          fresh[index].hash = slot.hash;
+          fresh[index].entry = std::move(slot.entry);
+        }
+      }
+      if (retain_retired_ && !slots_.empty()) {
+        retired_.push_back(std::move(slots_)); // readers may still be here
+      }
+      slots_ = std::move(fresh);
+      mask_ = mask;
+      // Array before mask: a reader that sees the new (larger) mask is
+      // guaranteed to see the new array too
+      published_slots_.store(slots_.data(), std::memory_order_release);
+      published_mask_.store(mask_, std::memory_order_release);
+    }
+
+    Slots slots_;
+    std::size_t mask_ = 0;
+    std::size_t size_ = 0;
+
+    bool retain_retired_ = false;
+    std::vector<Slots> retired_;
+    std::atomic<const Slot *> published_slots_{nullptr};
+    std::atomic<std::size_t> published_mask_{0};
+  };
+};
+
+// =============================================================================
+// OrderedStorage — std::map, a balanced binary search tree
+// =============================================================================
+// The hash is ignored: keys are found by comparison, and iteration runs
+// in key order. Positions for relocate() are ranks, so each slice walks
+// from the beginning — fine for the benchmark baseline it mostly is.
+// =============================================================================
+struct OrderedStorage {
+  template <typename K, typename V> class Table {
+  public:
+    V *find(const K &key, std::uint64_t /*hash*/) {
+      const auto it = map_.find(key);
+      return it == map_.end() ? nullptr : &it->second;
+    }
+    const V *find(const K &key, std::uint64_t /*hash*/) const {
+      const auto it = map_.find(key);
+      return it == map_.end() ? nullptr : &it->second;
+    }
+
+    // Nothing to do: each step down the tree depends on the one before
+    void prefetch(const K & /*key*/, std::uint64_t /*hash*/) const {}
+
+    void insert_or_assign(const K &key, std::uint64_t /*hash*/,
+                          const V &value) {
+      map_.insert_or_assign(key, value);
+    }
+    void insert_new(const K &key, std::uint64_t /*hash*/, V &&value) {
+      map_.try_emplace(key, std::move(value));
+    }
+
+    bool erase(const K &key, std::uint64_t /*hash*/) {
+      return map_.erase(key) > 0;
+    }
+
+    std::size_t size() const { return map_.size(); }
+    void reserve(std::size_t /*count*/) {} // a tree has nothing to pre-size
+
+    template <typename F> void for_each(F &&callback) const {
+      for (const auto &[key, value] : map_) {
+        callback(key, value);
+      }
+    }
+    template <typename F> void update_each(F &&callback) {
+      for (auto &[key, value] : map_) {
+        callback(key, value);
+      }
+    }
+
+    template <typename P> std::size_t erase_if(P &&predicate) {
+      std::size_t removed = 0;
+      for (auto it = map_.begin(); it != map_.end();) {
+        if (predicate(it->first, it->second)) {
+          it = map_.erase(it);
+          ++removed;
+        } else {
+          ++it;
+        }
+      }
+      return removed;
+    }
+
+    std::size_t relocate(std::size_t rank, std::size_t max_nodes,
+                         detail::RelocateHooks<V> &hooks) {
+      if (rank >= map_.size()) {
+        return 0;
+      }
+      std::vector<K> moving;
+      auto it = std::next(map_.begin(), static_cast<std::ptrdiff_t>(rank));
+      for (std::size_t n = 0; n < max_nodes && it != map_.end();
+           ++n, ++it, ++rank) {
+        ++hooks.visited;
+        hooks.relocate_value(it->second);
+        if (hooks.should_move(&*it)) {
+          moving.push_back(it->first);
+        }
+      }
+      for (K &key : moving) {
+        auto old_node = map_.extract(key);
+        map_.emplace(std::move(key), std::move(old_node.mapped()));
+        ++hooks.moved;
+      }
+      return rank < map_.size() ? rank : 0;
+    }
+
+  private:
+    std::map<K, V, std::less<K>, StlAllocator<std::pair<const K, V>>> map_;
+  };
+};
+
+// =============================================================================
+// Lock policies
+// =============================================================================
+using SharedMutexLock = std::shared_mutex;
+
+// ---- SpinLock — test-and-test-and-set ----
+// Waiters spin on a plain load (the line stays shared in their caches)
+// and only attempt the exchange once the lock looks free.
+class SpinLock {
+public:
+  void lock() {
+    while (locked_.exchange(true, std::memory_order_acquire)) {
+      std::uint32_t spins = 0;
+      while (locked_.load(std::memory_order_relaxed)) {
+        backoff(spins);
+      }
+    }
+  }
+  bool try_lock() { return !locked_.exchange(true, std::memory_order_acquire); }
+  void unlock() { locked_.store(false, std::memory_order_release); }
+
+  // No separate read mode: a reader holds the lock like a writer
+  void lock_shared() { lock(); }
+  bool try_lock_shared() { return try_lock(); }
+  void unlock_shared() { unlock(); }
+
+  // Tell the CPU we're spinning (frees resources for its sibling thread)
+  static void pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield");
+#endif
+  }
+
+  // One round of waiting: pause() while the holder is probably running,
+  // then give the core away — with more threads than cores, the holder
+  // may be preempted, and spinning would only delay its return
+  static void backoff(std::uint32_t &spins) {
+    constexpr std::uint32_t SPINS_BEFORE_YIELD = 64;
+    if (++spins < SPINS_BEFORE_YIELD) {
+      pause();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+private:
+  std::atomic<bool> locked_{false};
+};
+
+// ---- SeqLock — writers count, optimistic readers check ----
+// The sequence is ODD while a write is in progress:
+//
+//   reader:  s = read_begin()   (waits for an even value)
+//            copy the data
+//            read_retry(s)?     → the data may be torn, go again
+//
+// Locked readers (for_each, read(), ...) take the writer spinlock: they
+// hand out references, which an optimistic read can't do.
+class SeqLock {
+public:
+  void lock() {
+    writer_.lock();
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    // The odd value must be visible before any of the writes it guards
+    std::atomic_thread_fence(std::memory_order_release);
+  }
+  bool try_lock() {
+    if (!writer_.try_lock()) {
+      return false;
+    }
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    return true;
+  }
+  void unlock() {
+    sequence_.store(sequence_.load(std::memory_order_relaxed) + 1,
+                    std::memory_order_release);
+    writer_.unlock();
+  }
+
+  void lock_shared() { writer_.lock(); }
+  bool try_lock_shared() { return writer_.try_lock(); }
+  void unlock_shared() { writer_.unlock(); }
+
+  std::uint64_t read_begin() const {
+    for (std::uint32_t spins = 0;;) {
+      const std::uint64_t sequence = sequence_.load(std::memory_order_acquire);
+      if ((sequence & 1) == 0) {
+        return sequence;
+      }
+      SpinLock::backoff(spins);
+    }
+  }
+  // Keeps the data reads above from being moved below the re-check
+  bool read_retry(std::uint64_t sequence) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence_.load(std::memory_order_relaxed) != sequence;
+  }
+
+private:
+  SpinLock writer_;
+  std::atomic<std::uint64_t> sequence_{0};
+};
+
+// ---- NoLock — for shards owned by a single thread ----
+class NoLock {
+public:
+  void lock() {}
+  bool try_lock() { return true; }
+  void unlock() {}
+  void lock_shared() {}
+  bool try_lock_shared() { return true; }
+  void unlock_shared() {}
+};
+
+} // namespace mini_redis
@@ -0,0 +1,469 @@
+// =============================================================================
+// namespaces.cpp — Isolated Logical Databases (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/namespaces.hpp"
+#include "core/expiry_manager.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm> // std::sort, std::shuffle, std::min
+#include <random>
+#include <utility> // std::move
+
+namespace mini_redis {
+
+namespace {
+
+constexpr std::size_t MAX_NAME_BYTES = 64;
+
+// Hash node + StoreEntry + bookkeeping, per key, whatever it holds
+constexpr std::size_t ENTRY_OVERHEAD_BYTES = 96;
+
+// Typical cost of one member of a container type: its node or slot plus
+// a short string. The real size would take a walk over every member.
+constexpr std::size_t SORTED_SET_MEMBER_BYTES = 80;
+constexpr std::size_t SET_MEMBER_BYTES = 48;
+constexpr std::size_t LIST_ELEMENT_BYTES = 32;
+
+std::size_t value_bytes(const StoreValue &value) {
+  if (const auto *text = string_value(value)) {
+    return text->size();
+  }
+  if (const auto *packed = std::get_if<CompressedString>(&value)) {
+    return packed->bytes.size();
+  }
+  if (const auto *zset = std::get_if<SortedSet>(&value)) {
+    return zset->size() * SORTED_SET_MEMBER_BYTES;
+  }
+  if (const auto *set = std::get_if<Set>(&value)) {
+    return set->size() * SET_MEMBER_BYTES;
+  }
+  if (const auto *list = std::get_if<QuickList>(&value)) {
+    return list->size() * LIST_ELEMENT_BYTES;
+  }
+  if (const auto *sketch = std::get_if<CountMinSketch>(&value)) {
+    return sketch->width() * sketch->depth() * sizeof(std::uint64_t);
+  }
+  // The rest know their own footprint
+  return std::visit(
+      [](const auto &typed) -> std::size_t {
+        using T = std::decay_t<decltype(typed)>;
+        if constexpr (std::is_same_v<T, HyperLogLog> ||
+                      std::is_same_v<T, BloomFilter> ||
+                      std::is_same_v<T, RoaringBitmap> ||
+                      std::is_same_v<T, TimeSeries> ||
+                      std::is_same_v<T, Stream> ||
+                      std::is_same_v<T, VectorIndex> ||
+                      std::is_same_v<T, JsonDocument>) {
+          return typed.memory_bytes();
+        } else {
+          return 0; // handled above
+        }
+      },
+      value);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Eviction policy names
+// =============================================================================
+std::optional<EvictionPolicy> parse_eviction_policy(std::string_view name) {
+  if (name == "noeviction") {
+    return EvictionPolicy::NO_EVICTION;
+  }
+  if (name == "allkeys-random") {
+    return EvictionPolicy::ALLKEYS_RANDOM;
+  }
+  if (name == "volatile-ttl") {
+    return EvictionPolicy::VOLATILE_TTL;
+  }
+  return std::nullopt;
+}
+
+const char *eviction_policy_name(EvictionPolicy policy) {
+  switch (policy) {
+  case EvictionPolicy::ALLKEYS_RANDOM:
+    return "allkeys-random";
+  case EvictionPolicy::VOLATILE_TTL:
+    return "volatile-ttl";
+  case EvictionPolicy::NO_EVICTION:
+    break;
+  }
+  return "noeviction";
+}
+
+std::size_t estimate_entry_bytes(const std::string &key,
+                                 const StoreEntry &entry) {
+  return ENTRY_OVERHEAD_BYTES + key.size() + value_bytes(entry.value);
+}
+
+// =============================================================================
+// Namespace
+// =============================================================================
+Namespace::Namespace(std::string name, const NamespaceLimits &limits)
+    : name_(std::move(name)), max_memory_(limits.max_memory),
+      eviction_(limits.eviction),
+      expiry_interval_ms_(limits.expiry_interval.count()),
+      last_maintained_(std::chrono::steady_clock::now()) {}
+
+NamespaceLimits Namespace::limits() const {
+  return NamespaceLimits{max_memory_.load(), eviction_.load(),
+                         std::chrono::milliseconds(expiry_interval_ms_.load())};
+}
+
+void Namespace::set_limits(const NamespaceLimits &limits) {
+  max_memory_.store(limits.max_memory);
+  eviction_.store(limits.eviction);
+  expiry_interval_ms_.store(limits.expiry_interval.count());
+}
+
+std::size_t Namespace::used_bytes() const { return used_bytes_.load(); }
+
+bool Namespace::admits_writes() const {
+  const std::size_t max_memory = max_memory_.load();
+  return max_memory == 0 || eviction_.load() != EvictionPolicy::NO_EVICTION ||
+         used_bytes_.load() < max_memory;
+}
+
+std::size_t Namespace::entry_bytes(const std::string &key) const {
+  std::size_t bytes = 0;
+  store_.read_values({key}, [&](const std::vector<const StoreValue *> &values) {
+    if (values.front() != nullptr) {
+      bytes = ENTRY_OVERHEAD_BYTES + key.size() + value_bytes(*values.front());
+    }
+  });
+  return bytes;
+}
+
+// Clamped at zero: a credit for a key the count never saw (one written
+// before a measurement that had already dropped it) mustn't wrap around
+void Namespace::charge(std::size_t before, std::size_t after) {
+  if (after >= before) {
+    used_bytes_.fetch_add(after - before);
+    return;
+  }
+  const std::size_t credit = before - after;
+  std::size_t used = used_bytes_.load();
+  while (!used_bytes_.compare_exchange_weak(used,
+                                            used - std::min(used, credit))) {
+  }
+}
+
+std::uint64_t Namespace::evicted() const { return evicted_.load(); }
+
+// =============================================================================
+// enforce_quota() — Measure, and evict if over
+// =============================================================================
+// A namespace within its quota costs nothing here: the running count
+// says so without a walk. Over it, one read-only walk re-measures (the
+// count errs high, see MEMORY ACCOUNTING) and, only if that confirms it,
+// a second collects the candidates. Evictions go through remove(), like
+// any DEL, so the key's inline copy goes with it.
+// =============================================================================
+std::size_t Namespace::enforce_quota() {
+  std::lock_guard<std::mutex> lock(quota_mutex_);
+
+  const std::size_t max_memory = max_memory_.load();
+  if (max_memory == 0 || used_bytes_.load() <= max_memory) {
+    return 0;
+  }
+
+  std::size_t used = 0;
+  store_.for_each_entry(
+      [&used](const std::string &key, const StoreEntry &entry) {
+        used += estimate_entry_bytes(key, entry);
+      });
+  used_bytes_.store(used);
+
+  const EvictionPolicy policy = eviction_.load();
+  if (used <= max_memory || policy == EvictionPolicy::NO_EVICTION) {
+    return 0;
+  }
+
+  struct Candidate {
+    std::string key;
+    std::size_t bytes;
+    std::chrono::steady_clock::time_point expires_at;
+  };
+  std::vector<Candidate> candidates;
+  store_.for_each_entry([&](const std::string &key, const StoreEntry &entry) {
+    if (policy == EvictionPolicy::VOLATILE_TTL &&
+        !entry.expires_at.has_value()) {
+      return;
+    }
+    candidates.push_back(Candidate{
+        key, estimate_entry_bytes(key, entry),
+        entry.expires_at.value_or(std::chrono::steady_clock::time_point{})});
+  });
+
+  if (policy == EvictionPolicy::ALLKEYS_RANDOM) {
+    std::mt19937_64 rng(std::random_device{}());
+    std::shuffle(candidates.begin(), candidates.end(), rng);
+  } else {
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &a, const Candidate &b) {
+                return a.expires_at < b.expires_at;
+              });
+  }
+
+  std::size_t evicted = 0;
+  for (const Candidate &candidate : candidates) {
+    if (used <= max_memory) {
+      break;
+    }
+    if (store_.remove(candidate.key)) {
+      used -= std::min(used, candidate.bytes);
+      charge(candidate.bytes, 0); // keeps writes made meanwhile
+      ++evicted;
+    }
+  }
+  evicted_.fetch_add(evicted);
+
+  Logger::warning("Namespace '" + name_ + "' over its quota: evicted " +
+                  std::to_string(evicted) + " keys (" +
+                  eviction_policy_name(policy) + ")");
+  return evicted;
+}
+
+// =============================================================================
+// maintain_if_due() — One namespace's turn on the maintenance thread
+// =============================================================================
+// The interval is re-read on every visit, so a shortened one applies from
+// the next visit rather than after the old interval has run out.
+// =============================================================================
+std::chrono::steady_clock::time_point
+Namespace::maintain_if_due(std::chrono::steady_clock::time_point now) {
+  const std::chrono::milliseconds interval(expiry_interval_ms_.load());
+  if (now < last_maintained_ + interval) {
+    return last_maintained_ + interval;
+  }
+  ExpiryManager::run_cycle(
+      store_, [this](const std::string &key, const StoreEntry &entry) {
+        charge(estimate_entry_bytes(key, entry), 0);
+      });
+  enforce_quota();
+  last_maintained_ = std::chrono::steady_clock::now();
+  return last_maintained_ + interval;
+}
+
+// =============================================================================
+// NamespaceRegistry — construction and teardown
+// =============================================================================
+// Maintenance stops first, so no cycle is running while the namespaces
+// go. The reclaimer then frees whatever is still queued before it exits.
+// =============================================================================
+NamespaceRegistry::NamespaceRegistry()
+    : reclaimer_(&NamespaceRegistry::reclaim_loop, this),
+      maintainer_(&NamespaceRegistry::maintenance_loop, this) {}
+
+NamespaceRegistry::~NamespaceRegistry() {
+  {
+    std::lock_guard<std::mutex> lock(maintenance_mutex_);
+    maintenance_stopping_ = true;
+  }
+  maintenance_cv_.notify_all();
+  maintainer_.join();
+
+  {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    stopping_ = true;
+  }
+  reclaim_cv_.notify_all();
+  reclaimer_.join();
+}
+
+bool NamespaceRegistry::valid_name(std::string_view name) {
+  if (name.empty() || name.size() > MAX_NAME_BYTES) {
+    return false;
+  }
+  return std::all_of(name.begin(), name.end(), [](char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+           (c >= '0' && c <= '9') || c == '_' || c == '-';
+  });
+}
+
+// Built outside the exclusive lock by its callers, so lookups don't wait
+// while a store is constructed and configured
+std::shared_ptr<Namespace>
+NamespaceRegistry::make(const std::string &name,
+                        const NamespaceLimits &limits) const {
+  auto created = std::make_shared<Namespace>(name, limits);
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  if (settings_) {
+    settings_(created->store());
+  }
+  return created;
+}
+
+// =============================================================================
+// create() / find() / names()
+// =============================================================================
+bool NamespaceRegistry::create(const std::string &name,
+                               const NamespaceLimits &limits) {
+  if (!valid_name(name) || find(name) != nullptr) {
+    return false;
+  }
+  auto created = make(name, limits);
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    if (!namespaces_.emplace(name, created).second) {
+      created = nullptr; // lost a race with another create()
+    }
+  }
+  if (created == nullptr) {
+    return false;
+  }
+  Logger::info("Namespace '" + name + "' created");
+  return true;
+}
+
+std::shared_ptr<Namespace>
+NamespaceRegistry::find(const std::string &name) const {
+  std::shared_lock<std::shared_mutex> lock(mutex_);
+  const auto it = namespaces_.find(name);
+  return it == namespaces_.end() ? nullptr : it->second;
+}
+
+std::vector<std::string> NamespaceRegistry::names() const {
+  std::vector<std::string> result;
+  {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    result.reserve(namespaces_.size());
+    for (const auto &[name, ns] : namespaces_) {
+      result.push_back(name);
+    }
+  }
+  std::sort(result.begin(), result.end());
+  return result;
+}
+
+// =============================================================================
+// drop() / flush() — Unlink now, free later
+// =============================================================================
+bool NamespaceRegistry::drop(const std::string &name) {
+  std::shared_ptr<Namespace> retired;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = namespaces_.find(name);
+    if (it == namespaces_.end()) {
+      return false;
+    }
+    retired = std::move(it->second);
+    namespaces_.erase(it);
+  }
+  reclaim(std::move(retired));
+  Logger::info("Namespace '" + name + "' dropped");
+  return true;
+}
+
+bool NamespaceRegistry::flush(const std::string &name) {
+  const auto current = find(name);
+  if (current == nullptr) {
+    return false;
+  }
+  auto fresh = make(name, current->limits());
+
+  std::shared_ptr<Namespace> retired;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    const auto it = namespaces_.find(name);
+    if (it == namespaces_.end()) {
+      return false; // dropped meanwhile; 'fresh' goes unused
+    }
+    retired = std::move(it->second);
+    it->second = std::move(fresh);
+  }
+  reclaim(std::move(retired));
+  Logger::info("Namespace '" + name + "' flushed");
+  return true;
+}
+
+void NamespaceRegistry::configure(StoreSettings settings) {
+  std::vector<std::shared_ptr<Namespace>> current;
+  {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    settings_ = settings;
+    for (const auto &[name, ns] : namespaces_) {
+      current.push_back(ns);
+    }
+  }
+  for (const auto &ns : current) {
+    settings(ns->store());
+  }
+}
+
+// =============================================================================
+// The maintenance thread
+// =============================================================================
+// Each pass copies the namespaces' shared_ptrs under the shared lock (a
+// create or drop waits for that copy, not for the cycles), then gives each
+// namespace that is due its turn. A namespace dropped meanwhile finishes
+// its cycle and is freed here, when the copy goes.
+// =============================================================================
+void NamespaceRegistry::maintenance_loop() {
+  std::unique_lock<std::mutex> lock(maintenance_mutex_);
+  while (!maintenance_stopping_) {
+    lock.unlock();
+    std::vector<std::shared_ptr<Namespace>> current;
+    {
+      std::shared_lock<std::shared_mutex> registry_lock(mutex_);
+      current.reserve(namespaces_.size());
+      for (const auto &[name, ns] : namespaces_) {
+        current.push_back(ns);
+      }
+    }
+    auto wake_at = std::chrono::steady_clock::now() + MAINTENANCE_TICK;
+    for (const auto &ns : current) {
+      wake_at = std::min(
+          wake_at, ns->maintain_if_due(std::chrono::steady_clock::now()));
+    }
+    current.clear();
+
+    lock.lock();
+    maintenance_cv_.wait_until(lock, wake_at,
+                               [this] { return maintenance_stopping_; });
+  }
+}
+
+// =============================================================================
+// The reclaimer thread
+// =============================================================================
+std::size_t NamespaceRegistry::pending_reclaims() const {
+  std::lock_guard<std::mutex> lock(reclaim_mutex_);
+  return retired_.size() + reclaiming_;
+}
+
+void NamespaceRegistry::reclaim(std::shared_ptr<Namespace> retired) {
+  {
+    std::lock_guard<std::mutex> lock(reclaim_mutex_);
+    retired_.push_back(std::move(retired));
+  }
+  reclaim_cv_.notify_one();
+}
+
+// Requests still using a retired namespace hold their own shared_ptr:
+// whichever of them finishes last frees it instead of this thread
+void NamespaceRegistry::reclaim_loop() {
+  std::unique_lock<std::mutex> lock(reclaim_mutex_);
+  while (true) {
+    reclaim_cv_.wait(lock, [this] { return stopping_ || !retired_.empty(); });
+    if (retired_.empty()) {
+      return; // stopping, and nothing left
+    }
+    std::shared_ptr<Namespace> retired = std::move(retired_.front());
+    retired_.pop_front();
+    ++reclaiming_;
+
+    lock.unlock();
+    const std::string name = retired->name();
+    const std::size_t bytes = retired->used_bytes();
+    retired.reset(); // the expensive part: every entry is freed here
+    Logger::info("Namespace '" + name + "': reclaimed ~" +
+                 std::to_string(bytes) + " bytes");
+    lock.lock();
+    --reclaiming_;
+  }
+}
+
+} // namespace mini_redis
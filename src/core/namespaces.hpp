@@ -0,0 +1,241 @@
+// =============================================================================
+// namespaces.hpp — Isolated Logical Databases (HEADER)
+// =============================================================================
+//
+// Tenants sharing one store with key prefixes ("acme:user:1") share its
+// costs too: one tenant's keys() walks everybody's keys, and deleting a
+// tenant means finding and removing its keys one by one. A NAMESPACE is
+// instead a KeyValueStore of its own, with its own:
+//   - tables            → keys(), scans and cleanup see only its keys
+//   - expiry schedule   → its own interval, on the registry's one
+//                          maintenance thread
+//   - memory quota      → max_memory bytes (0 = unlimited)
+//   - eviction policy   → what happens once it is over its quota
+//
+// FLUSHING IN O(1):
+// flush() doesn't delete a single key. It swaps a fresh, empty Namespace
+// in under the registry lock and hands the old one to a background
+// thread, whose only job is to drop it: freeing millions of entries
+// happens there, not in the request. Requests already holding the old
+// namespace (a shared_ptr) finish against it undisturbed.
+//
+// MEMORY ACCOUNTING:
+// Usage is ESTIMATED (estimate_entry_bytes() below) rather than read from
+// the allocator, which can't tell tenants apart. It is a running count:
+// each write is charged the difference between the entry's cost after
+// and before it (an overwrite of the same size costs nothing, a delete
+// credits the entry back), and the maintenance cycle credits the keys it
+// expires. Keys removed any other way (a GET finding one expired) are
+// still counted, so the count errs high; the namespace is walked and
+// re-measured only when that count says it is over its quota.
+//
+// ONE MAINTENANCE THREAD:
+// A thread per namespace would make the thread count grow with the
+// number of tenants (and each flush would start another). Instead the
+// registry's maintenance thread visits every namespace that is due, runs
+// its cycle (ExpiryManager::run_cycle(), then the quota) and sleeps until
+// the next one is due, or MAINTENANCE_TICK at most, so a changed
+// interval is noticed promptly. A slow namespace delays the others' turn
+// rather than running beside them: cycles are one pass over one store.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory> // std::shared_ptr
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mini_redis {
+
+// =============================================================================
+// EvictionPolicy — What a namespace does once over its quota
+// =============================================================================
+// NO_EVICTION    : nothing is removed; writes are refused until deletes,
+//                  expiry or a larger quota bring it back under
+// ALLKEYS_RANDOM : random keys are evicted until it fits
+// VOLATILE_TTL   : keys with a TTL are evicted, soonest to expire first;
+//                  keys without one are never touched (so with none left,
+//                  this behaves like NO_EVICTION)
+// Names as in Redis' maxmemory-policy: "noeviction", "allkeys-random",
+// "volatile-ttl".
+// =============================================================================
+enum class EvictionPolicy { NO_EVICTION, ALLKEYS_RANDOM, VOLATILE_TTL };
+
+std::optional<EvictionPolicy> parse_eviction_policy(std::string_view name);
+const char *eviction_policy_name(EvictionPolicy policy);
+
+// ---- NamespaceLimits — A namespace's settings ----
+struct NamespaceLimits {
+  std::size_t max_memory = 0; // bytes; 0 = no quota
+  EvictionPolicy eviction = EvictionPolicy::NO_EVICTION;
+  std::chrono::milliseconds expiry_interval{1000};
+};
+
+// ---- estimate_entry_bytes() — Roughly what one entry costs ----
+// Key + value bytes + a fixed per-entry overhead (hash node, StoreEntry).
+// Types that know their footprint report it; sorted sets, sets and lists
+// count a typical per-member size, not their members' actual bytes.
+std::size_t estimate_entry_bytes(const std::string &key,
+                                 const StoreEntry &entry);
+
+// =============================================================================
+// Namespace — One tenant's store and its housekeeping
+// =============================================================================
+class Namespace {
+public:
+  // First maintenance cycle one expiry interval from now
+  Namespace(std::string name, const NamespaceLimits &limits);
+
+  // Non-copyable, non-movable (shared by pointer, holds a mutex)
+  Namespace(const Namespace &) = delete;
+  Namespace &operator=(const Namespace &) = delete;
+  Namespace(Namespace &&) = delete;
+  Namespace &operator=(Namespace &&) = delete;
+
+  const std::string &name() const { return name_; }
+  KeyValueStore &store() { return store_; }
+  const KeyValueStore &store() const { return store_; }
+
+  NamespaceLimits limits() const;
+  // Takes effect from the next maintenance cycle
+  void set_limits(const NamespaceLimits &limits);
+
+  // ---- Memory quota ----
+  // Estimated bytes in use (the running count, see above)
+  std::size_t used_bytes() const;
+
+  // False while over quota under NO_EVICTION: the caller refuses the write
+  bool admits_writes() const;
+
+  // What 'key' costs now, per estimate_entry_bytes(); 0 if it is absent
+  std::size_t entry_bytes(const std::string &key) const;
+
+  // A write or delete changed one entry's cost from 'before' to 'after'
+  // (both from entry_bytes(), taken around the write)
+  void charge(std::size_t before, std::size_t after);
+
+  // If the running count is over the quota: re-measure, then evict per
+  // the policy until back under it. Runs every maintenance cycle, and
+  // walks the namespace only when over; returns the keys evicted.
+  std::size_t enforce_quota();
+
+  // Keys evicted over the namespace's lifetime
+  std::uint64_t evicted() const;
+
+  // ---- Maintenance (the registry's maintenance thread only) ----
+  // Runs a cycle if one is due at 'now' — expired keys, retention, then
+  // enforce_quota() — and returns when the next one is due
+  std::chrono::steady_clock::time_point
+  maintain_if_due(std::chrono::steady_clock::time_point now);
+
+private:
+  std::string name_;
+
+  std::atomic<std::size_t> max_memory_;
+  std::atomic<EvictionPolicy> eviction_;
+  std::atomic<std::size_t> used_bytes_{0};
+  std::atomic<std::uint64_t> evicted_{0};
+  std::atomic<std::chrono::milliseconds::rep> expiry_interval_ms_;
+  std::chrono::steady_clock::time_point last_maintained_;
+
+  // One enforce_quota() at a time (the maintenance thread, or a caller)
+  std::mutex quota_mutex_;
+
+  KeyValueStore store_;
+};
+
+// =============================================================================
+// NamespaceRegistry — The namespaces by name, their maintenance, and their
+// reclaimer
+// =============================================================================
+// Lookups take a shared lock and copy one shared_ptr; create / drop /
+// flush take it exclusively, for the time of one map update.
+// =============================================================================
+class NamespaceRegistry {
+public:
+  NamespaceRegistry();
+  ~NamespaceRegistry();
+
+  // Upper bound on the maintenance thread's sleep
+  static constexpr std::chrono::milliseconds MAINTENANCE_TICK{1000};
+
+  // Non-copyable, non-movable (owns running threads)
+  NamespaceRegistry(const NamespaceRegistry &) = delete;
+  NamespaceRegistry &operator=(const NamespaceRegistry &) = delete;
+  NamespaceRegistry(NamespaceRegistry &&) = delete;
+  NamespaceRegistry &operator=(NamespaceRegistry &&) = delete;
+
+  // 1-64 characters out of [A-Za-z0-9_-]: safe in a URL path segment
+  static bool valid_name(std::string_view name);
+
+  // false if the name is invalid or already taken
+  bool create(const std::string &name, const NamespaceLimits &limits);
+
+  // nullptr if there's no such namespace
+  std::shared_ptr<Namespace> find(const std::string &name) const;
+
+  // Remove the namespace and all its keys; its memory is reclaimed in
+  // the background. false if there's no such namespace.
+  bool drop(const std::string &name);
+
+  // Empty the namespace, keeping its name and limits; O(1), like drop()
+  bool flush(const std::string &name);
+
+  // Every namespace name, sorted
+  std::vector<std::string> names() const;
+
+  // Namespaces dropped or flushed whose memory isn't freed yet
+  std::size_t pending_reclaims() const;
+
+  // ---- configure() — Store settings every namespace shares ----
+  // Applied to each existing store now, and to each new one (created or
+  // flushed) before its first key: dedup, compression and the like
+  // follow the server's settings (see Application::apply_live_settings).
+  using StoreSettings = std::function<void(KeyValueStore &)>;
+  void configure(StoreSettings settings);
+
+private:
+  std::shared_ptr<Namespace> make(const std::string &name,
+                                  const NamespaceLimits &limits) const;
+
+  // Hand a namespace over to the reclaimer thread
+  void reclaim(std::shared_ptr<Namespace> retired);
+  void reclaim_loop();
+
+  void maintenance_loop();
+
+  mutable std::shared_mutex mutex_;
+  std::unordered_map<std::string, std::shared_ptr<Namespace>> namespaces_;
+  StoreSettings settings_;
+
+  // ---- The reclaimer ----
+  mutable std::mutex reclaim_mutex_;
+  std::condition_variable reclaim_cv_;
+  std::deque<std::shared_ptr<Namespace>> retired_;
+  std::size_t reclaiming_ = 0; // popped but not yet freed
+  bool stopping_ = false;
+  std::thread reclaimer_;
+
+  // ---- The maintenance thread ----
+  std::mutex maintenance_mutex_;
+  std::condition_variable maintenance_cv_;
+  bool maintenance_stopping_ = false;
+  std::thread maintainer_;
+};
+
+} // namespace mini_redis
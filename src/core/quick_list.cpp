@@ -0,0 +1,321 @@
+// =============================================================================
+// quick_list.cpp — List Value Type Built From Compact Chunks (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/quick_list.hpp"
+
+#include <utility> // std::pair
+
+namespace {
+
+// =============================================================================
+// Length framing
+// =============================================================================
+// Lengths below 128 take ONE byte (top bit clear). Longer ones take FOUR
+// bytes, and the byte at the OUTER edge carries the top bit as a marker:
+//
+//   prefix (read forwards):  [1xxxxxxx][byte][byte][byte]
+//   suffix (read backwards): [byte][byte][byte][1xxxxxxx]
+//
+// The suffix is the prefix mirrored, so reading it from the END of an
+// element works exactly like reading the prefix from the start.
+// =============================================================================
+constexpr std::size_t SHORT_LENGTH_LIMIT = 0x80;
+constexpr unsigned char LONG_MARKER = 0x80;
+
+std::size_t framing_bytes(std::size_t length) {
+  return length < SHORT_LENGTH_LIMIT ? 1 : 4;
+}
+
+std::string length_prefix(std::size_t length) {
+  if (length < SHORT_LENGTH_LIMIT) {
+    return std::string(1, static_cast<char>(length));
+  }
+  std::string out(4, '\0');
+  out[0] = static_cast<char>(LONG_MARKER | ((length >> 24) & 0x7F));
+  out[1] = static_cast<char>((length >> 16) & 0xFF);
+  out[2] = static_cast<char>((length >> 8) & 0xFF);
+  out[3] = static_cast<char>(length & 0xFF);
+  return out;
+}
+
+std::string length_suffix(std::size_t length) {
+  std::string prefix = length_prefix(length);
+  return std::string(prefix.rbegin(), prefix.rend());
+}
+
+// Byte at position i as an unsigned value (char may be signed!)
+std::size_t byte_at(const std::string &bytes, std::size_t i) {
+  return static_cast<unsigned char>(bytes[i]);
+}
+
+// Decode the length prefix at 'pos' → {length, framing bytes}
+std::pair<std::size_t, std::size_t> read_prefix(const std::string &bytes,
+                                                std::size_t pos) {
+  const std::size_t first = byte_at(bytes, pos);
+  if ((first & LONG_MARKER) == 0) {
+    return {first, 1};
+  }
+  const std::size_t length = ((first & 0x7F) << 24) |
+                             (byte_at(bytes, pos + 1) << 16) |
+                             (byte_at(bytes, pos + 2) << 8) |
+                             byte_at(bytes, pos + 3);
+  return {length, 4};
+}
+
+// Decode the length suffix that ENDS at 'end' (exclusive) → {length, bytes}
+std::pair<std::size_t, std::size_t> read_suffix(const std::string &bytes,
+                                                std::size_t end) {
+  const std::size_t last = byte_at(bytes, end - 1);
+  if ((last & LONG_MARKER) == 0) {
+    return {last, 1};
+  }
+  const std::size_t length = ((last & 0x7F) << 24) |
+                             (byte_at(bytes, end - 2) << 16) |
+                             (byte_at(bytes, end - 3) << 8) |
+                             byte_at(bytes, end - 4);
+  return {length, 4};
+}
+
+std::string encode(const std::string &value) {
+  return length_prefix(value.size()) + value + length_suffix(value.size());
+}
+
+} // anonymous namespace
+
+namespace mini_redis {
+
+std::size_t QuickList::encoded_size(std::size_t length) {
+  return length + 2 * framing_bytes(length);
+}
+
+// =============================================================================
+// push_front() / push_back()
+// =============================================================================
+// Append to the end chunk if it has room, otherwise start a new chunk.
+// Prepending inside a chunk shifts at most CHUNK_MAX_BYTES bytes — a
+// bounded cost, which is what keeps pushes O(1).
+// =============================================================================
+void QuickList::push_front(const std::string &value) {
+  const std::size_t needed = encoded_size(value.size());
+  if (chunks_.empty() ||
+      chunks_.front().bytes.size() + needed > CHUNK_MAX_BYTES) {
+    chunks_.emplace_front();
+  }
+  Chunk &chunk = chunks_.front();
+  chunk.bytes.insert(0, encode(value));
+  ++chunk.count;
+  ++size_;
+}
+
+void QuickList::push_back(const std::string &value) {
+  const std::size_t needed = encoded_size(value.size());
+  if (chunks_.empty() ||
+      chunks_.back().bytes.size() + needed > CHUNK_MAX_BYTES) {
+    chunks_.emplace_back();
+  }
+  Chunk &chunk = chunks_.back();
+  chunk.bytes += encode(value);
+  ++chunk.count;
+  ++size_;
+}
+
+// =============================================================================
+// pop_front() / pop_back()
+// =============================================================================
+std::optional<std::string> QuickList::pop_front() {
+  if (chunks_.empty()) {
+    return std::nullopt;
+  }
+
+  Chunk &chunk = chunks_.front();
+  const auto [length, framing] = read_prefix(chunk.bytes, 0);
+  std::string value = chunk.bytes.substr(framing, length);
+  chunk.bytes.erase(0, length + 2 * framing);
+
+  if (--chunk.count == 0) {
+    chunks_.pop_front();
+  }
+  --size_;
+  return value;
+}
+
+std::optional<std::string> QuickList::pop_back() {
+  if (chunks_.empty()) {
+    return std::nullopt;
+  }
+
+  Chunk &chunk = chunks_.back();
+  const std::size_t end = chunk.bytes.size();
+  const auto [length, framing] = read_suffix(chunk.bytes, end);
+  std::string value = chunk.bytes.substr(end - framing - length, length);
+  chunk.bytes.resize(end - length - 2 * framing);
+
+  if (--chunk.count == 0) {
+    chunks_.pop_back();
+  }
+  --size_;
+  return value;
+}
+
+// =============================================================================
+// range() — Skip whole chunks by their counts, then decode elements
+// =============================================================================
+std::vector<std::string> QuickList::range(long long start,
+                                          long long stop) const {
+  std::vector<std::string> result;
+  if (!normalize(start, stop)) {
+    return result;
+  }
+  result.reserve(static_cast<std::size_t>(stop - start + 1));
+
+  const auto first = static_cast<std::size_t>(start);
+  const auto last = static_cast<std::size_t>(stop);
+  std::size_t index = 0; // index of the first element of the current chunk
+
+  for (const Chunk &chunk : chunks_) {
+    if (index > last) {
+      break;
+    }
+    if (index + chunk.count <= first) {
+      index += chunk.count; // the whole chunk is before the range: skip it
+      continue;
+    }
+
+    std::size_t pos = 0;
+    for (std::uint32_t i = 0; i < chunk.count; ++i, ++index) {
+      const auto [length, framing] = read_prefix(chunk.bytes, pos);
+      if (index >= first && index <= last) {
+        result.push_back(chunk.bytes.substr(pos + framing, length));
+      }
+      pos += length + 2 * framing;
+    }
+  }
+
+  return result;
+}
+
+void QuickList::trim(long long start, long long stop) {
+  if (!normalize(start, stop)) {
+    chunks_.clear();
+    size_ = 0;
+    return;
+  }
+
+  const auto keep_from = static_cast<std::size_t>(start);
+  const auto drop_at_back = size_ - 1 - static_cast<std::size_t>(stop);
+  drop_back(drop_at_back);
+  drop_front(keep_from);
+}
+
+std::size_t QuickList::size() const { return size_; }
+
+bool QuickList::empty() const { return size_ == 0; }
+
+std::size_t QuickList::chunk_count() const { return chunks_.size(); }
+
+// =============================================================================
+// Private helpers
+// =============================================================================
+bool QuickList::normalize(long long &start, long long &stop) const {
+  const auto n = static_cast<long long>(size_);
+  if (start < 0) {
+    start += n;
+  }
+  if (stop < 0) {
+    stop += n;
+  }
+  if (start < 0) {
+    start = 0;
+  }
+  if (start > stop || start >= n) {
+    return false;
+  }
+  if (stop >= n) {
+    stop = n - 1;
+  }
+  return true;
+}
+
+// Whole chunks are dropped in O(1); only the boundary chunk is re-cut
+void QuickList::drop_front(std::size_t n) {
+  while (n > 0 && !chunks_.empty()) {
+    Chunk &chunk = chunks_.front();
+    if (chunk.count <= n) {
+      n -= chunk.count;
+      size_ -= chunk.count;
+      chunks_.pop_front();
+      continue;
+    }
+
+    std::size_t pos = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto [length, framing] = read_prefix(chunk.bytes, pos);
+      pos += length + 2 * framing;
+    }
+    chunk.bytes.erase(0, pos);
+    chunk.count -= static_cast<std::uint32_t>(n);
+    size_ -= n;
+    n = 0;
+  }
+}
+
+void QuickList::drop_back(std::size_t n) {
+  while (n > 0 && !chunks_.empty()) {
+    Chunk &chunk = chunks_.back();
+    if (chunk.count <= n) {
+      n -= chunk.count;
+      size_ -= chunk.count;
+      chunks_.pop_back();
+      continue;
+    }
+
+    std::size_t end = chunk.bytes.size();
+    for (std::size_t i = 0; i < n; ++i) {
+      const auto [length, framing] = read_suffix(chunk.bytes, end);
+      end -= length + 2 * framing;
+    }
+    chunk.bytes.resize(end);
+    chunk.count -= static_cast<std::uint32_t>(n);
+    size_ -= n;
+    n = 0;
+  }
+}
+
+// =============================================================================
+// Snapshot encoding: u64 count | bytes per element, front to back
+// =============================================================================
+// Elements are written one by one rather than as raw chunks, so the file
+// doesn't depend on CHUNK_MAX_BYTES or the framing format.
+// =============================================================================
+void QuickList::serialize(std::string &out) const {
+  put_u64(out, size_);
+  for (const Chunk &chunk : chunks_) {
+    std::size_t pos = 0;
+    for (std::uint32_t i = 0; i < chunk.count; ++i) {
+      const auto [length, framing] = read_prefix(chunk.bytes, pos);
+      put_bytes(out, std::string_view(chunk.bytes).substr(pos + framing,
+                                                          length));
+      pos += length + 2 * framing;
+    }
+  }
+}
+
+std::optional<QuickList> QuickList::deserialize(ByteReader &in) {
+  std::uint64_t count = 0;
+  if (!in.get_u64(count)) {
+    return std::nullopt;
+  }
+
+  QuickList list;
+  std::string element;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    if (!in.get_bytes(element)) {
+      return std::nullopt;
+    }
+    list.push_back(element);
+  }
+  return list;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,94 @@
+// =============================================================================
+// quick_list.hpp — List Value Type Built From Compact Chunks (HEADER)
+// =============================================================================
+//
+// A LIST is an ordered sequence of strings with cheap push/pop at BOTH ends —
+// the building block for work queues and "latest N events" feeds.
+//
+// WHY NOT std::list<std::string> OR std::deque<std::string>?
+// Every std::string costs 32 bytes of bookkeeping (plus a heap allocation
+// for anything longer than ~15 chars), and std::list adds two pointers and
+// one allocation per element. For a list of short strings that's 4-10x
+// more memory than the data itself, and every element lives in a different
+// place in memory (cache-unfriendly).
+//
+// THE QUICKLIST DESIGN (from real Redis):
+//   A doubly linked list of CHUNKS. Each chunk is ONE contiguous byte buffer
+//   holding many elements back to back:
+//
+//     chunk: [len][bytes...][len] [len][bytes...][len] ...
+//
+//   Each element is framed by its length on BOTH sides, so we can walk the
+//   buffer forwards (for LRANGE) and backwards (for RPOP) without an index.
+//   Chunks are capped at a few KB, so inserting at the front of a chunk
+//   (a memmove inside the buffer) costs a bounded amount — O(1) push/pop.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mini_redis {
+
+class QuickList {
+public:
+  // ---- Push to either end ----
+  void push_front(const std::string &value);
+  void push_back(const std::string &value);
+
+  // ---- Pop from either end (std::nullopt if the list is empty) ----
+  std::optional<std::string> pop_front();
+  std::optional<std::string> pop_back();
+
+  // ---- range() — Elements with index in [start, stop] ----
+  // Negative indexes count from the end (-1 = last), like Redis LRANGE.
+  std::vector<std::string> range(long long start, long long stop) const;
+
+  // ---- trim() — Keep only the elements in [start, stop] ----
+  // Same index rules as range(); an empty range empties the list (LTRIM).
+  void trim(long long start, long long stop);
+
+  std::size_t size() const;
+  bool empty() const;
+
+  // Number of chunks (diagnostics / tests — shows the memory layout at work)
+  std::size_t chunk_count() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<QuickList> deserialize(ByteReader &in);
+
+private:
+  // One compact chunk: encoded elements plus how many there are
+  struct Chunk {
+    std::string bytes;
+    std::uint32_t count = 0;
+  };
+
+  // Soft cap on one chunk's buffer (same default as Redis: 8 KB).
+  // An element bigger than this simply gets a chunk of its own.
+  static constexpr std::size_t CHUNK_MAX_BYTES = 8 * 1024;
+
+  // Bytes needed to frame a value of this length (prefix + suffix)
+  static std::size_t encoded_size(std::size_t length);
+
+  // Normalize Redis-style [start, stop] into a valid 0-based range.
+  // Returns false if the range selects nothing.
+  bool normalize(long long &start, long long &stop) const;
+
+  // Remove 'n' elements from the front / back (n <= size())
+  void drop_front(std::size_t n);
+  void drop_back(std::size_t n);
+
+  std::list<Chunk> chunks_;
+  std::size_t size_ = 0;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,106 @@
+// =============================================================================
+// roaring_bitmap.hpp — Compressed Bitmap for Sparse Bit Sets (HEADER)
+// =============================================================================
+//
+// A plain bitmap costs offset/8 bytes no matter how few bits are set:
+// SETBIT flags 4000000000 1 allocates 500 MB to store ONE bit. That's the
+// wrong trade for sparse data (a few thousand flagged users among
+// billions of IDs).
+//
+// ROARING BITMAPS (Lemire et al., used by Lucene, Spark, ClickHouse...)
+// split the 32-bit offset space into 65536 CHUNKS of 65536 bits each. The
+// high 16 bits of an offset pick the chunk, the low 16 bits the bit inside
+// it. Only non-empty chunks exist, each as one of two CONTAINERS:
+//
+//   ARRAY  — up to 4096 set bits: a sorted std::vector<uint16_t> of the
+//            low halves. 2 bytes per set bit.
+//   BITSET — more than 4096 set bits: a plain 65536-bit array (8 KB).
+//            At 4096 entries both forms cost 8 KB, so that's the switch.
+//
+// So memory tracks the number of SET bits, and dense regions still get
+// word-at-a-time bit operations (the SIMD kernels in bitmap_ops.hpp).
+//
+// Offsets are plain integers here; to_bytes() converts to the Redis bit
+// order (bit 0 = MSB of byte 0) used by string bitmaps.
+// =============================================================================
+
+#pragma once
+
+#include "core/bitmap_ops.hpp"
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace mini_redis {
+
+class RoaringBitmap {
+public:
+  // ---- set() — Set bit 'offset' to 'value'. Returns the OLD value ----
+  bool set(std::uint32_t offset, bool value);
+
+  bool get(std::uint64_t offset) const;
+
+  // ---- Counting and searching over an INCLUSIVE bit range ----
+  std::uint64_t count() const;
+  std::uint64_t count_range(std::uint64_t first, std::uint64_t last) const;
+
+  // First bit equal to 'bit' in [first, last], or std::nullopt
+  std::optional<std::uint64_t> find(bool bit, std::uint64_t first,
+                                    std::uint64_t last) const;
+
+  // Bytes the equivalent string bitmap would need (0 if no bit is set)
+  std::uint64_t byte_length() const;
+
+  // ---- combine() — AND / OR / XOR of several bitmaps ----
+  // nullptr entries (missing keys) count as empty bitmaps.
+  static RoaringBitmap combine(BitOp op,
+                               const std::vector<const RoaringBitmap *> &all);
+
+  // Conversions to / from a Redis-order string bitmap
+  std::string to_bytes() const;
+  static RoaringBitmap from_bytes(std::string_view bytes);
+
+  bool empty() const;
+  std::size_t container_count() const;
+  std::size_t memory_bytes() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<RoaringBitmap> deserialize(ByteReader &in);
+
+private:
+  static constexpr std::size_t ARRAY_MAX = 4096;
+  static constexpr std::size_t BITSET_WORDS = 65536 / 64;
+
+  struct Container {
+    std::uint16_t key = 0;         // high 16 bits of every offset inside
+    std::uint32_t cardinality = 0; // number of set bits
+    std::vector<std::uint16_t> array; // ARRAY form: sorted low halves
+    std::vector<std::uint64_t> words; // BITSET form: 1024 words
+
+    bool is_bitset() const { return !words.empty(); }
+    bool contains(std::uint16_t low) const;
+    void to_bitset();
+    void to_array();
+    void normalize(); // pick the smaller form for the current cardinality
+  };
+
+  static Container combine(BitOp op, const Container &a, const Container &b);
+  static RoaringBitmap combine(BitOp op, const RoaringBitmap &a,
+                               const RoaringBitmap &b);
+  static std::vector<std::uint64_t> words_of(const Container &container);
+
+  std::vector<Container>::iterator find_container(std::uint16_t key);
+  std::vector<Container>::const_iterator
+  find_container(std::uint16_t key) const;
+
+  // Sorted by key
+  std::vector<Container> containers_;
+};
+
+} // namespace mini_redis
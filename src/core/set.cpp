@@ -0,0 +1,323 @@
+// =============================================================================
+// set.cpp — Set Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/set.hpp"
+#include "core/set_ops.hpp"
+
+#include <algorithm> // std::sort, std::lower_bound, std::set_union
+#include <charconv>  // std::from_chars — fast, locale-free number parsing
+#include <iterator>  // std::back_inserter
+
+namespace mini_redis {
+
+namespace {
+
+std::vector<std::string> to_strings(const std::int64_t *values,
+                                    std::size_t count) {
+  std::vector<std::string> out;
+  out.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    out.push_back(std::to_string(values[i]));
+  }
+  return out;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// as_integer() — Canonical integers only
+// =============================================================================
+std::optional<std::int64_t> Set::as_integer(const std::string &member) {
+  if (member.empty() || member.size() > 20) {
+    return std::nullopt;
+  }
+
+  std::int64_t value = 0;
+  const char *begin = member.data();
+  const char *end = begin + member.size();
+  const auto [ptr, error] = std::from_chars(begin, end, value);
+  if (error != std::errc{} || ptr != end) {
+    return std::nullopt;
+  }
+
+  // from_chars accepts "007" and "-0"; only keep strings that round-trip
+  if (std::to_string(value) != member) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+// =============================================================================
+// add() / add_all()
+// =============================================================================
+bool Set::add(const std::string &member) {
+  if (encoding_ == Encoding::INTSET) {
+    const auto value = as_integer(member);
+    if (value.has_value()) {
+      const auto it = std::lower_bound(ints_.begin(), ints_.end(), *value);
+      if (it != ints_.end() && *it == *value) {
+        return false;
+      }
+      if (ints_.size() < INTSET_MAX_ENTRIES) {
+        ints_.insert(it, *value);
+        return true;
+      }
+    }
+    // Not an integer, or the intset is full → switch representation
+    convert_to_hashtable();
+  }
+  return hashed_.insert(member).second;
+}
+
+std::size_t Set::add_all(const std::vector<std::string> &members) {
+  if (encoding_ == Encoding::INTSET) {
+    std::vector<std::int64_t> batch;
+    batch.reserve(members.size());
+    for (const auto &member : members) {
+      const auto value = as_integer(member);
+      if (!value.has_value()) {
+        batch.clear();
+        break;
+      }
+      batch.push_back(*value);
+    }
+
+    if (batch.size() == members.size() &&
+        ints_.size() + batch.size() <= INTSET_MAX_ENTRIES) {
+      std::sort(batch.begin(), batch.end());
+      batch.erase(std::unique(batch.begin(), batch.end()), batch.end());
+
+      std::vector<std::int64_t> merged;
+      merged.reserve(ints_.size() + batch.size());
+      std::set_union(ints_.begin(), ints_.end(), batch.begin(), batch.end(),
+                     std::back_inserter(merged));
+
+      const std::size_t added = merged.size() - ints_.size();
+      ints_ = std::move(merged);
+      return added;
+    }
+  }
+
+  // Mixed batch (or a hashtable already): one at a time
+  std::size_t added = 0;
+  for (const auto &member : members) {
+    if (add(member)) {
+      ++added;
+    }
+  }
+  return added;
+}
+
+// =============================================================================
+// remove() / contains()
+// =============================================================================
+bool Set::remove(const std::string &member) {
+  if (encoding_ == Encoding::HASHTABLE) {
+    return hashed_.erase(member) > 0;
+  }
+
+  const auto value = as_integer(member);
+  if (!value.has_value()) {
+    return false; // a non-integer can't be in an intset
+  }
+  const auto it = std::lower_bound(ints_.begin(), ints_.end(), *value);
+  if (it == ints_.end() || *it != *value) {
+    return false;
+  }
+  ints_.erase(it);
+  return true;
+}
+
+bool Set::contains(const std::string &member) const {
+  if (encoding_ == Encoding::HASHTABLE) {
+    return hashed_.count(member) > 0;
+  }
+  const auto value = as_integer(member);
+  return value.has_value() &&
+         std::binary_search(ints_.begin(), ints_.end(), *value);
+}
+
+std::vector<std::string> Set::members() const {
+  if (encoding_ == Encoding::INTSET) {
+    return to_strings(ints_.data(), ints_.size());
+  }
+  return std::vector<std::string>(hashed_.begin(), hashed_.end());
+}
+
+std::size_t Set::size() const {
+  return encoding_ == Encoding::INTSET ? ints_.size() : hashed_.size();
+}
+
+bool Set::empty() const { return size() == 0; }
+
+Set::Encoding Set::encoding() const { return encoding_; }
+
+// =============================================================================
+// intersect() — SINTER
+// =============================================================================
+// Smallest set first: the result can never be larger than it, and every
+// later step only has to look at what survived so far.
+// =============================================================================
+std::vector<std::string> Set::intersect(const std::vector<const Set *> &sets) {
+  if (sets.empty()) {
+    return {};
+  }
+  for (const Set *set : sets) {
+    if (set == nullptr || set->empty()) {
+      return {}; // anything ∩ ∅ = ∅
+    }
+  }
+
+  std::vector<const Set *> by_size = sets;
+  std::sort(by_size.begin(), by_size.end(),
+            [](const Set *a, const Set *b) { return a->size() < b->size(); });
+
+  const bool all_intsets =
+      std::all_of(by_size.begin(), by_size.end(), [](const Set *set) {
+        return set->encoding_ == Encoding::INTSET;
+      });
+
+  if (all_intsets) {
+    // One buffer, narrowed in place: result = result ∩ next
+    const auto &smallest = by_size.front()->ints_;
+    if (by_size.size() == 1) {
+      return to_strings(smallest.data(), smallest.size());
+    }
+    std::vector<std::int64_t> result(smallest.size());
+    const auto &second = by_size[1]->ints_;
+    std::size_t count = intersect_sorted(smallest.data(), smallest.size(),
+                                         second.data(), second.size(),
+                                         result.data());
+    for (std::size_t i = 2; i < by_size.size() && count > 0; ++i) {
+      const auto &next = by_size[i]->ints_;
+      count = intersect_sorted(result.data(), count, next.data(), next.size(),
+                               result.data());
+    }
+    return to_strings(result.data(), count);
+  }
+
+  // Mixed encodings: walk the smallest set, keep members found everywhere
+  std::vector<std::string> result;
+  for (const auto &candidate : by_size.front()->members()) {
+    const bool everywhere =
+        std::all_of(by_size.begin() + 1, by_size.end(),
+                    [&](const Set *set) { return set->contains(candidate); });
+    if (everywhere) {
+      result.push_back(candidate);
+    }
+  }
+  return result;
+}
+
+// =============================================================================
+// unite() — SUNION
+// =============================================================================
+std::vector<std::string> Set::unite(const std::vector<const Set *> &sets) {
+  const bool all_intsets =
+      std::all_of(sets.begin(), sets.end(), [](const Set *set) {
+        return set == nullptr || set->encoding_ == Encoding::INTSET;
+      });
+
+  if (all_intsets) {
+    std::vector<std::int64_t> all;
+    for (const Set *set : sets) {
+      if (set != nullptr) {
+        all.insert(all.end(), set->ints_.begin(), set->ints_.end());
+      }
+    }
+    std::sort(all.begin(), all.end());
+    all.erase(std::unique(all.begin(), all.end()), all.end());
+    return to_strings(all.data(), all.size());
+  }
+
+  std::unordered_set<std::string> all;
+  for (const Set *set : sets) {
+    if (set == nullptr) {
+      continue;
+    }
+    if (set->encoding_ == Encoding::INTSET) {
+      for (const std::int64_t value : set->ints_) {
+        all.insert(std::to_string(value));
+      }
+    } else {
+      all.insert(set->hashed_.begin(), set->hashed_.end());
+    }
+  }
+  return std::vector<std::string>(all.begin(), all.end());
+}
+
+// =============================================================================
+// convert_to_hashtable() — One-way switch, like Redis
+// =============================================================================
+void Set::convert_to_hashtable() {
+  hashed_.reserve(ints_.size() + 1);
+  for (const std::int64_t value : ints_) {
+    hashed_.insert(std::to_string(value));
+  }
+  ints_.clear();
+  ints_.shrink_to_fit();
+  encoding_ = Encoding::HASHTABLE;
+}
+
+// =============================================================================
+// Snapshot encoding
+// =============================================================================
+//   u8 encoding | u64 count | INTSET: u64 per value (ascending)
+//                           | HASHTABLE: bytes per member
+// =============================================================================
+void Set::serialize(std::string &out) const {
+  put_u8(out, static_cast<std::uint8_t>(encoding_));
+  put_u64(out, size());
+  if (encoding_ == Encoding::INTSET) {
+    for (const std::int64_t value : ints_) {
+      put_u64(out, static_cast<std::uint64_t>(value));
+    }
+  } else {
+    for (const auto &member : hashed_) {
+      put_bytes(out, member);
+    }
+  }
+}
+
+std::optional<Set> Set::deserialize(ByteReader &in) {
+  std::uint8_t encoding = 0;
+  std::uint64_t count = 0;
+  if (!in.get_u8(encoding) || !in.get_u64(count)) {
+    return std::nullopt;
+  }
+
+  Set set;
+  if (encoding == static_cast<std::uint8_t>(Encoding::INTSET)) {
+    if (count > INTSET_MAX_ENTRIES || in.remaining() < count * 8) {
+      return std::nullopt;
+    }
+    set.ints_.reserve(count);
+    for (std::uint64_t i = 0; i < count; ++i) {
+      std::uint64_t raw = 0;
+      in.get_u64(raw);
+      const auto value = static_cast<std::int64_t>(raw);
+      // The merge kernels rely on strictly ascending values
+      if (!set.ints_.empty() && set.ints_.back() >= value) {
+        return std::nullopt;
+      }
+      set.ints_.push_back(value);
+    }
+    return set;
+  }
+
+  if (encoding != static_cast<std::uint8_t>(Encoding::HASHTABLE)) {
+    return std::nullopt;
+  }
+  set.convert_to_hashtable();
+  std::string member;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    if (!in.get_bytes(member)) {
+      return std::nullopt;
+    }
+    set.hashed_.insert(member);
+  }
+  return set;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,89 @@
+// =============================================================================
+// set.hpp — Set Value Type (HEADER)
+// =============================================================================
+//
+// A SET is an unordered collection of unique strings: the tags on an
+// article, the IDs of users who liked a post. The interesting queries are
+// membership ("is 42 in here?") and set algebra across keys:
+//   SINTER tag:cpp tag:redis   → items carrying BOTH tags
+//   SUNION tag:cpp tag:redis   → items carrying EITHER tag
+//
+// TWO ENCODINGS (like real Redis):
+//   1. INTSET    — when every member is an integer (very common: IDs!), we
+//      store them as a SORTED, packed std::vector<int64_t>. 8 bytes per
+//      member instead of ~50+ for a hashed std::string, and two sorted
+//      arrays can be intersected by a linear merge — even with SIMD (see
+//      set_ops.hpp).
+//   2. HASHTABLE — the first non-integer member (or a very large set)
+//      converts the set to a std::unordered_set<std::string>: O(1)
+//      membership for anything.
+//
+// Intersections across several keys never build intermediate sets: the
+// all-integer case narrows ONE result buffer in place, and the mixed case
+// walks the smallest set and probes the others.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace mini_redis {
+
+class Set {
+public:
+  enum class Encoding { INTSET, HASHTABLE };
+
+  // ---- add() — Returns true if the member is NEW ----
+  bool add(const std::string &member);
+
+  // ---- add_all() — Bulk insert, returns how many members were new ----
+  // For an intset this sorts the batch once and merges it in O(n + m),
+  // instead of n separate O(n) shifting inserts.
+  std::size_t add_all(const std::vector<std::string> &members);
+
+  // ---- remove() — Returns true if the member existed ----
+  bool remove(const std::string &member);
+
+  bool contains(const std::string &member) const;
+
+  // All members. Intsets come out in ascending numeric order; hashtable
+  // order is unspecified (just like Redis).
+  std::vector<std::string> members() const;
+
+  std::size_t size() const;
+  bool empty() const;
+  Encoding encoding() const;
+
+  // ---- Multi-set algebra (nullptr entries = missing keys = empty sets) ----
+  static std::vector<std::string> intersect(const std::vector<const Set *> &sets);
+  static std::vector<std::string> unite(const std::vector<const Set *> &sets);
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<Set> deserialize(ByteReader &in);
+
+private:
+  // Largest intset we keep. A single add() shifts up to this many int64s
+  // (512 KB) — still fast, and it keeps big ID lists SIMD-intersectable.
+  static constexpr std::size_t INTSET_MAX_ENTRIES = 64 * 1024;
+
+  // Parse a member as an integer ONLY if it's in canonical form: "42" and
+  // "-7" yes; "+7", "007", "-0" or " 1" no — those must round-trip as the
+  // exact strings the client sent, so they force the hashtable encoding.
+  static std::optional<std::int64_t> as_integer(const std::string &member);
+
+  void convert_to_hashtable();
+
+  Encoding encoding_ = Encoding::INTSET;
+  std::vector<std::int64_t> ints_;         // INTSET: sorted, unique
+  std::unordered_set<std::string> hashed_; // HASHTABLE
+};
+
+} // namespace mini_redis
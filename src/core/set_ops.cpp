@@ -0,0 +1,211 @@
+// =============================================================================
+// set_ops.cpp — Intersection Kernels for Sorted Integer Arrays (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/set_ops.hpp"
+
+#include <algorithm> // std::lower_bound, std::min
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MINI_REDIS_HAVE_AVX2_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace mini_redis {
+
+namespace {
+
+// Switch from merge to galloping when one side is this many times larger.
+// Below ~32x the merge's sequential, branch-predictable walk wins.
+constexpr std::size_t GALLOP_RATIO = 32;
+
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+
+// Checked once; the answer can't change while the process runs
+bool cpu_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+// Write the lanes of 'block' flagged in 'mask' to out[k...], in lane
+// (= sorted) order. Returns the new k.
+__attribute__((target("avx2"))) std::size_t
+emit_lanes(__m256i block, unsigned mask, std::int64_t *out, std::size_t k) {
+  alignas(32) std::int64_t lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i *>(lanes), block);
+  while (mask != 0) {
+    out[k++] = lanes[__builtin_ctz(mask)];
+    mask &= mask - 1; // clear the lowest set bit
+  }
+  return k;
+}
+
+// =============================================================================
+// merge_avx2() — Block merge, 4x4 comparisons per step
+// =============================================================================
+// Each step compares a block of 4 from 'a' with a block of 4 from 'b' by
+// rotating b's register three times (all 16 pairs), then retires whichever
+// block has the smaller maximum (both if equal).
+//
+// Matches are remembered in a 4-bit 'pending' mask and written out only
+// when a's block RETIRES. Writing earlier could clobber a[i..i+3] when
+// 'out' aliases 'a' (see set_ops.hpp) and the block is still in play.
+//
+// __attribute__((target("avx2"))) compiles just this function with AVX2
+// enabled — the rest of the binary still runs on any x86-64 CPU.
+// =============================================================================
+__attribute__((target("avx2"))) std::size_t
+merge_avx2(const std::int64_t *a, std::size_t a_size, const std::int64_t *b,
+           std::size_t b_size, std::int64_t *out) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+  std::size_t k = 0;
+
+  if (a_size >= 4 && b_size >= 4) {
+    __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+    std::int64_t a_max = a[3];
+    std::int64_t b_max = b[3];
+    unsigned pending = 0;
+
+    while (true) {
+      __m256i eq = _mm256_cmpeq_epi64(va, vb);
+      eq = _mm256_or_si256(
+          eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x39)));
+      eq = _mm256_or_si256(
+          eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x4E)));
+      eq = _mm256_or_si256(
+          eq, _mm256_cmpeq_epi64(va, _mm256_permute4x64_epi64(vb, 0x93)));
+      pending |= static_cast<unsigned>(
+          _mm256_movemask_pd(_mm256_castsi256_pd(eq)));
+
+      const bool advance_a = a_max <= b_max;
+      const bool advance_b = b_max <= a_max;
+      if (advance_a) {
+        k = emit_lanes(va, pending, out, k);
+        pending = 0;
+        i += 4;
+      }
+      if (advance_b) {
+        j += 4;
+      }
+      if (i + 4 > a_size || j + 4 > b_size) {
+        break;
+      }
+      if (advance_a) {
+        va = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i));
+        a_max = a[i + 3];
+      }
+      if (advance_b) {
+        vb = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + j));
+        b_max = b[j + 3];
+      }
+    }
+
+    // b ran out while a's block was still open: flush its matches, then
+    // skip past the highest matched lane — everything up to it is smaller
+    // than b[j], so the scalar tail never needs those (maybe clobbered) slots
+    if (pending != 0) {
+      const unsigned highest_lane = 31u - __builtin_clz(pending);
+      k = emit_lanes(va, pending, out, k);
+      i += highest_lane + 1;
+    }
+  }
+
+  return k + intersect_merge_scalar(a + i, a_size - i, b + j, b_size - j,
+                                    out + k);
+}
+
+#endif // MINI_REDIS_HAVE_AVX2_KERNELS
+
+} // anonymous namespace
+
+// =============================================================================
+// intersect_merge_scalar() — The textbook two-pointer merge
+// =============================================================================
+std::size_t intersect_merge_scalar(const std::int64_t *a, std::size_t a_size,
+                                   const std::int64_t *b, std::size_t b_size,
+                                   std::int64_t *out) {
+  std::size_t i = 0;
+  std::size_t j = 0;
+  std::size_t k = 0;
+
+  while (i < a_size && j < b_size) {
+    if (a[i] < b[j]) {
+      ++i;
+    } else if (b[j] < a[i]) {
+      ++j;
+    } else {
+      out[k++] = a[i];
+      ++i;
+      ++j;
+    }
+  }
+  return k;
+}
+
+// =============================================================================
+// intersect_gallop() — Exponential search of the small side in the large one
+// =============================================================================
+// 'a' should be the SMALLER input. The search for a[i] starts where the
+// search for a[i-1] ended, so the large array is scanned at most once.
+// =============================================================================
+std::size_t intersect_gallop(const std::int64_t *a, std::size_t a_size,
+                             const std::int64_t *b, std::size_t b_size,
+                             std::int64_t *out) {
+  std::size_t k = 0;
+  std::size_t lo = 0; // everything in b before 'lo' is < the current a[i]
+
+  for (std::size_t i = 0; i < a_size && lo < b_size; ++i) {
+    const std::int64_t target = a[i];
+
+    // Gallop: probe lo, lo+1, lo+3, lo+7, ... until we pass the target
+    std::size_t hi = lo;
+    std::size_t step = 1;
+    while (hi < b_size && b[hi] < target) {
+      lo = hi + 1;
+      hi += step;
+      step <<= 1;
+    }
+    hi = std::min(hi, b_size);
+
+    // Then binary search the bracket [lo, hi)
+    lo = static_cast<std::size_t>(std::lower_bound(b + lo, b + hi, target) - b);
+    if (lo < b_size && b[lo] == target) {
+      out[k++] = target;
+      ++lo;
+    }
+  }
+  return k;
+}
+
+std::size_t intersect_merge_simd(const std::int64_t *a, std::size_t a_size,
+                                 const std::int64_t *b, std::size_t b_size,
+                                 std::int64_t *out) {
+#ifdef MINI_REDIS_HAVE_AVX2_KERNELS
+  if (cpu_has_avx2()) {
+    return merge_avx2(a, a_size, b, b_size, out);
+  }
+#endif
+  return intersect_merge_scalar(a, a_size, b, b_size, out);
+}
+
+// =============================================================================
+// intersect_sorted() — Pick the right kernel for the size ratio
+// =============================================================================
+std::size_t intersect_sorted(const std::int64_t *a, std::size_t a_size,
+                             const std::int64_t *b, std::size_t b_size,
+                             std::int64_t *out) {
+  if (a_size == 0 || b_size == 0) {
+    return 0;
+  }
+  if (a_size * GALLOP_RATIO < b_size) {
+    return intersect_gallop(a, a_size, b, b_size, out);
+  }
+  if (b_size * GALLOP_RATIO < a_size) {
+    return intersect_gallop(b, b_size, a, a_size, out);
+  }
+  return intersect_merge_simd(a, a_size, b, b_size, out);
+}
+
+} // namespace mini_redis
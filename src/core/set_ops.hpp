@@ -0,0 +1,60 @@
+// =============================================================================
+// set_ops.hpp — Intersection Kernels for Sorted Integer Arrays (HEADER)
+// =============================================================================
+//
+// Intersecting two SORTED arrays is the inner loop of every "users tagged
+// A AND B" query. There are two classic algorithms, and which one wins
+// depends on the size RATIO of the inputs:
+//
+//   1. MERGE — walk both arrays in lockstep, always advancing the one with
+//      the smaller head. O(n + m). Best when the sizes are similar.
+//
+//   2. GALLOPING — for each element of the SMALL array, find it in the
+//      large one with an exponential search (probe 1, 2, 4, 8, ... ahead,
+//      then binary search). O(n log(m/n)). Best when one side is tiny:
+//      10 IDs against 10 million shouldn't touch all 10 million.
+//
+// WHAT IS SIMD?
+// "Single Instruction, Multiple Data": one CPU instruction that works on
+// several values at once. An AVX2 register is 256 bits = four int64 values,
+// so the merge can compare a BLOCK of 4 against a block of 4 (all 16
+// pairs) in a handful of instructions instead of 16 branchy comparisons.
+//
+// Not every CPU has AVX2, so the SIMD kernel is compiled separately and
+// picked at RUNTIME (__builtin_cpu_supports); everything else falls back to
+// the portable scalar loop, which produces exactly the same output.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mini_redis {
+
+// ---- intersect_sorted() — Write the common elements of a and b to 'out' ----
+// Both inputs must be sorted ascending with no duplicates. 'out' must have
+// room for min(a_size, b_size) elements. Returns how many were written.
+//
+// 'out' MAY be the same buffer as 'a': results are only ever written at or
+// behind the read position in 'a', so a running result can be narrowed in
+// place ("result = result ∩ next") with no temporary array.
+std::size_t intersect_sorted(const std::int64_t *a, std::size_t a_size,
+                             const std::int64_t *b, std::size_t b_size,
+                             std::int64_t *out);
+
+// ---- Individual kernels (exposed for tests and benchmarks) ----
+std::size_t intersect_merge_scalar(const std::int64_t *a, std::size_t a_size,
+                                   const std::int64_t *b, std::size_t b_size,
+                                   std::int64_t *out);
+
+std::size_t intersect_gallop(const std::int64_t *a, std::size_t a_size,
+                             const std::int64_t *b, std::size_t b_size,
+                             std::int64_t *out);
+
+// AVX2 block merge. Falls back to the scalar merge on CPUs without AVX2.
+std::size_t intersect_merge_simd(const std::int64_t *a, std::size_t a_size,
+                                 const std::int64_t *b, std::size_t b_size,
+                                 std::int64_t *out);
+
+} // namespace mini_redis
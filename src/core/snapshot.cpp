@@ -0,0 +1,341 @@
+// =============================================================================
+// snapshot.cpp — Point-in-Time Persistence of the Whole Store (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/snapshot.hpp"
+#include "util/byte_codec.hpp"
+#include "util/hash.hpp"
+#include "util/logger.hpp"
+
+#include <algorithm> // std::max
+#include <chrono>
+#include <cstdio>  // std::rename, std::remove
+#include <fstream> // std::ifstream, std::ofstream
+#include <iterator>
+#include <limits>
+#include <type_traits> // std::is_same_v, std::decay_t
+#include <utility>
+#include <variant>
+#include <vector>
+
+namespace mini_redis {
+
+namespace {
+
+constexpr std::string_view MAGIC = "MREDIS01";
+constexpr std::uint8_t END_MARKER = 0xFF;
+constexpr std::uint64_t NO_EXPIRY = std::numeric_limits<std::uint64_t>::max();
+
+// Longest TTL an entry may carry. now + ttl must fit steady_clock's
+// nanosecond count (~292 years); a SET's TTL is at most 2^31 s (68 years).
+// Bulk imports read it off the network, so anything above is refused.
+constexpr std::uint64_t MAX_TTL_MS =
+    std::uint64_t{100} * 365 * 24 * 3600 * 1000;
+
+// The type tag written before each value. Explicit numbers (rather than
+// the variant's index) so that reordering StoreValue never breaks old files.
+enum class TypeTag : std::uint8_t {
+  STRING = 0,
+  SORTED_SET = 1,
+  LIST = 2,
+  SET = 3,
+  HYPERLOGLOG = 4,
+  BLOOM_FILTER = 5,
+  COUNT_MIN_SKETCH = 6,
+  ROARING_BITMAP = 7,
+  TIME_SERIES = 8,
+  STREAM = 9,
+  VECTOR_INDEX = 10,
+  JSON = 11,
+  COMPRESSED_STRING = 12,
+};
+
+// ---- Value → payload; returns the tag to write in front of it ----
+TypeTag encode_value(std::string &payload, const StoreValue &value) {
+  return std::visit(
+      [&payload](const auto &typed) {
+        using T = std::decay_t<decltype(typed)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+          put_bytes(payload, typed);
+          return TypeTag::STRING;
+        } else if constexpr (std::is_same_v<T, SharedString>) {
+          // Written as a plain string: sharing is a memory layout, not
+          // data, and loading re-interns it under the running threshold
+          put_bytes(payload, typed.str());
+          return TypeTag::STRING;
+        } else if constexpr (std::is_same_v<T, CompressedString>) {
+          // Kept compressed: smaller files, and no work on either side
+          put_u8(payload, static_cast<std::uint8_t>(typed.codec));
+          put_bytes(payload, typed.bytes);
+          return TypeTag::COMPRESSED_STRING;
+        } else {
+          typed.serialize(payload);
+          if constexpr (std::is_same_v<T, SortedSet>) {
+            return TypeTag::SORTED_SET;
+          } else if constexpr (std::is_same_v<T, QuickList>) {
+            return TypeTag::LIST;
+          } else if constexpr (std::is_same_v<T, Set>) {
+            return TypeTag::SET;
+          } else if constexpr (std::is_same_v<T, HyperLogLog>) {
+            return TypeTag::HYPERLOGLOG;
+          } else if constexpr (std::is_same_v<T, BloomFilter>) {
+            return TypeTag::BLOOM_FILTER;
+          } else if constexpr (std::is_same_v<T, RoaringBitmap>) {
+            return TypeTag::ROARING_BITMAP;
+          } else if constexpr (std::is_same_v<T, TimeSeries>) {
+            return TypeTag::TIME_SERIES;
+          } else if constexpr (std::is_same_v<T, Stream>) {
+            return TypeTag::STREAM;
+          } else if constexpr (std::is_same_v<T, VectorIndex>) {
+            return TypeTag::VECTOR_INDEX;
+          } else if constexpr (std::is_same_v<T, JsonDocument>) {
+            return TypeTag::JSON;
+          } else {
+            static_assert(std::is_same_v<T, CountMinSketch>,
+                          "new StoreValue type needs a snapshot tag");
+            return TypeTag::COUNT_MIN_SKETCH;
+          }
+        }
+      },
+      value);
+}
+
+// Encodes the whole store; 'keys' receives the number of entries written
+std::string encode(const KeyValueStore &store, std::size_t &keys) {
+  std::string out(MAGIC);
+  const auto now = std::chrono::steady_clock::now();
+  keys = 0;
+
+  store.for_each_entry([&](const std::string &key, const StoreEntry &entry) {
+    encode_snapshot_entry(out, key, entry, now);
+    ++keys;
+  });
+
+  put_u8(out, END_MARKER);
+  put_u64(out, hash64(out));
+  return out;
+}
+
+// ---- (tag, payload) → value ----
+template <typename T>
+bool decode_into(ByteReader &in, StoreValue &value) {
+  auto decoded = T::deserialize(in);
+  if (!decoded.has_value()) {
+    return false;
+  }
+  value = std::move(*decoded);
+  return true;
+}
+
+bool decode_value(ByteReader &in, std::uint8_t tag, StoreValue &value) {
+  switch (static_cast<TypeTag>(tag)) {
+  case TypeTag::STRING: {
+    std::string text;
+    if (!in.get_bytes(text)) {
+      return false;
+    }
+    value = std::move(text);
+    return true;
+  }
+  case TypeTag::SORTED_SET:
+    return decode_into<SortedSet>(in, value);
+  case TypeTag::LIST:
+    return decode_into<QuickList>(in, value);
+  case TypeTag::SET:
+    return decode_into<Set>(in, value);
+  case TypeTag::HYPERLOGLOG:
+    return decode_into<HyperLogLog>(in, value);
+  case TypeTag::BLOOM_FILTER:
+    return decode_into<BloomFilter>(in, value);
+  case TypeTag::COUNT_MIN_SKETCH:
+    return decode_into<CountMinSketch>(in, value);
+  case TypeTag::ROARING_BITMAP:
+    return decode_into<RoaringBitmap>(in, value);
+  case TypeTag::TIME_SERIES:
+    return decode_into<TimeSeries>(in, value);
+  case TypeTag::STREAM:
+    return decode_into<Stream>(in, value);
+  case TypeTag::VECTOR_INDEX:
+    return decode_into<VectorIndex>(in, value);
+  case TypeTag::JSON:
+    return decode_into<JsonDocument>(in, value);
+  case TypeTag::COMPRESSED_STRING: {
+    std::uint8_t codec = 0;
+    std::string bytes;
+    if (!in.get_u8(codec) || !in.get_bytes(bytes)) {
+      return false;
+    }
+    auto packed = load_compressed(codec, std::move(bytes));
+    if (!packed.has_value()) {
+      return false;
+    }
+    value = std::move(*packed);
+    return true;
+  }
+  }
+  return false; // unknown tag: a newer or corrupted file
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// encode_snapshot_entry() / decode_snapshot_entry()
+// =============================================================================
+// The value goes straight into 'out' behind a placeholder type byte,
+// filled in once encode_value() has said what it wrote (no scratch buffer
+// and no second copy per entry).
+// =============================================================================
+void encode_snapshot_entry(std::string &out, const std::string &key,
+                           const StoreEntry &entry,
+                           std::chrono::steady_clock::time_point now) {
+  using namespace std::chrono;
+
+  std::uint64_t ttl_ms = NO_EXPIRY;
+  if (entry.expires_at.has_value()) {
+    const auto left = duration_cast<milliseconds>(*entry.expires_at - now);
+    // About to expire: keep it for 1 ms rather than making it immortal
+    ttl_ms =
+        static_cast<std::uint64_t>(std::max<std::int64_t>(left.count(), 1));
+  }
+
+  const std::size_t tag_at = out.size();
+  put_u8(out, 0);
+  put_bytes(out, key);
+  put_u64(out, ttl_ms);
+  const TypeTag tag = encode_value(out, entry.value);
+  out[tag_at] = static_cast<char>(tag);
+}
+
+bool decode_snapshot_entry(ByteReader &in, std::uint8_t tag, std::string &key,
+                           StoreEntry &entry,
+                           std::chrono::steady_clock::time_point now) {
+  std::uint64_t ttl_ms = 0;
+  if (!in.get_bytes(key) || !in.get_u64(ttl_ms) ||
+      !decode_value(in, tag, entry.value)) {
+    return false;
+  }
+  if (ttl_ms != NO_EXPIRY) {
+    if (ttl_ms > MAX_TTL_MS) {
+      return false; // would overflow the time point, here and on export
+    }
+    entry.expires_at =
+        now + std::chrono::milliseconds(static_cast<std::int64_t>(ttl_ms));
+  }
+  return true;
+}
+
+// =============================================================================
+// encode_snapshot()
+// =============================================================================
+// TTLs are stored as REMAINING milliseconds, not as time points: the
+// steady_clock epoch is meaningless after a restart.
+// =============================================================================
+std::string encode_snapshot(const KeyValueStore &store) {
+  std::size_t keys = 0;
+  return encode(store, keys);
+}
+
+// =============================================================================
+// decode_snapshot()
+// =============================================================================
+std::optional<std::size_t> decode_snapshot(KeyValueStore &store,
+                                           std::string_view bytes) {
+  using namespace std::chrono;
+
+  // ---- Envelope: magic, then a checksum over everything before it ----
+  if (bytes.size() < MAGIC.size() + 1 + sizeof(std::uint64_t) ||
+      bytes.substr(0, MAGIC.size()) != MAGIC) {
+    return std::nullopt;
+  }
+  const std::string_view body =
+      bytes.substr(0, bytes.size() - sizeof(std::uint64_t));
+  ByteReader trailer(bytes.substr(body.size()));
+  std::uint64_t checksum = 0;
+  trailer.get_u64(checksum);
+  if (checksum != hash64(body)) {
+    return std::nullopt;
+  }
+
+  // ---- Entries: decode them ALL before touching the store ----
+  ByteReader in(body.substr(MAGIC.size()));
+  std::vector<std::pair<std::string, StoreEntry>> entries;
+  const auto now = steady_clock::now();
+
+  while (true) {
+    std::uint8_t tag = 0;
+    if (!in.get_u8(tag)) {
+      return std::nullopt; // ran out before the end marker
+    }
+    if (tag == END_MARKER) {
+      break;
+    }
+
+    std::string key;
+    StoreEntry entry;
+    if (!decode_snapshot_entry(in, tag, key, entry, now)) {
+      return std::nullopt;
+    }
+    entries.emplace_back(std::move(key), std::move(entry));
+  }
+  if (!in.at_end()) {
+    return std::nullopt; // trailing garbage between marker and checksum
+  }
+
+  const std::size_t count = entries.size();
+  store.restore_many(std::move(entries)); // batched: see restore_many()
+  return count;
+}
+
+// =============================================================================
+// save_snapshot() / load_snapshot()
+// =============================================================================
+std::optional<std::size_t> save_snapshot(const KeyValueStore &store,
+                                         const std::string &path) {
+  std::size_t keys = 0;
+  const std::string bytes = encode(store, keys);
+
+  const std::string tmp_path = path + ".tmp";
+  {
+    std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    file.flush();
+    if (!file) {
+      Logger::error("Snapshot: cannot write '" + tmp_path + "'");
+      std::remove(tmp_path.c_str());
+      return std::nullopt;
+    }
+  }
+
+  if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+    Logger::error("Snapshot: cannot rename '" + tmp_path + "' to '" + path +
+                  "'");
+    std::remove(tmp_path.c_str());
+    return std::nullopt;
+  }
+
+  Logger::info("Snapshot: saved " + std::to_string(bytes.size()) +
+               " bytes to '" + path + "'");
+  return keys;
+}
+
+std::optional<std::size_t> load_snapshot(KeyValueStore &store,
+                                         const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file) {
+    return 0; // no snapshot yet: a fresh, empty store
+  }
+
+  const std::string bytes((std::istreambuf_iterator<char>(file)),
+                          std::istreambuf_iterator<char>());
+  const auto loaded = decode_snapshot(store, bytes);
+  if (!loaded.has_value()) {
+    Logger::error("Snapshot: '" + path + "' is corrupt, ignoring it");
+    return std::nullopt;
+  }
+
+  Logger::info("Snapshot: loaded " + std::to_string(*loaded) +
+               " keys from '" + path + "'");
+  return loaded;
+}
+
+} // namespace mini_redis
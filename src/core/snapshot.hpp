@@ -0,0 +1,70 @@
+// =============================================================================
+// snapshot.hpp — Point-in-Time Persistence of the Whole Store (HEADER)
+// =============================================================================
+//
+// Everything in the store lives in RAM, so a restart loses it all. A
+// SNAPSHOT (Redis calls it an RDB file) writes every key, its value and its
+// remaining TTL to one binary file, and loads it back at startup.
+//
+// FILE FORMAT (all integers little-endian, see util/byte_codec.hpp):
+//   "MREDIS01"                                  8-byte magic + version
+//   per key: u8 type | bytes key | u64 ttl_ms | value payload
+//   0xFF                                        end marker
+//   u64 checksum                                hash64 of everything above
+//
+// Each value type encodes its own payload (serialize / deserialize), so
+// adding a type means adding one tag here and two methods there.
+//
+// SAFE WRITES: we write to "<path>.tmp" and then rename() it over the old
+// file. rename() is atomic on POSIX, so a crash mid-save leaves the
+// previous snapshot intact instead of a half-written one.
+//
+// SAFE READS: the checksum and every length are verified, and nothing is
+// inserted into the store unless the WHOLE file decoded cleanly.
+// =============================================================================
+
+#pragma once
+
+#include "core/key_value_store.hpp"
+#include "util/byte_codec.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mini_redis {
+
+// ---- In-memory form ----
+std::string encode_snapshot(const KeyValueStore &store);
+
+// Returns the number of keys loaded, or std::nullopt if 'bytes' is not a
+// valid snapshot (in which case the store is left untouched).
+std::optional<std::size_t> decode_snapshot(KeyValueStore &store,
+                                           std::string_view bytes);
+
+// ---- File form ----
+// save: number of keys written, or std::nullopt on an I/O error.
+// load: number of keys loaded; 0 if the file doesn't exist yet;
+//       std::nullopt if it exists but is unreadable or corrupt.
+std::optional<std::size_t> save_snapshot(const KeyValueStore &store,
+                                         const std::string &path);
+std::optional<std::size_t> load_snapshot(KeyValueStore &store,
+                                         const std::string &path);
+
+// ---- One entry: u8 type | bytes key | u64 ttl_ms | value payload ----
+// What a snapshot is made of; the bulk stream (bulk_stream.hpp) frames the
+// same entries. TTLs are written and read relative to 'now'. decode reads
+// what follows the type byte, which the caller has already taken (to tell
+// an entry from an end marker); false if the entry is malformed, or its
+// TTL is beyond 100 years.
+void encode_snapshot_entry(std::string &out, const std::string &key,
+                           const StoreEntry &entry,
+                           std::chrono::steady_clock::time_point now);
+bool decode_snapshot_entry(ByteReader &in, std::uint8_t tag, std::string &key,
+                           StoreEntry &entry,
+                           std::chrono::steady_clock::time_point now);
+
+} // namespace mini_redis
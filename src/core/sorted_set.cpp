@@ -0,0 +1,510 @@
+// =============================================================================
+// sorted_set.cpp — Sorted Set Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/sorted_set.hpp"
+
+#include <algorithm> // std::lower_bound, std::find_if
+#include <array>
+#include <cmath> // std::isnan
+#include <utility>
+
+namespace mini_redis {
+
+// =============================================================================
+// Construction / destruction
+// =============================================================================
+SortedSet::SortedSet() = default;
+
+SortedSet::~SortedSet() { free_skiplist(); }
+
+// Deep copy: re-insert every element. If the source already uses the
+// skiplist we convert up-front so the copy has the same encoding.
+SortedSet::SortedSet(const SortedSet &other) {
+  if (other.encoding_ == Encoding::SKIPLIST) {
+    convert_to_skiplist();
+  }
+  for (const auto &item : other.range_by_rank(0, -1)) {
+    add(item.member, item.score);
+  }
+}
+
+// Copy assignment via "copy-and-swap": build the copy first (which may
+// throw), and only then swap it in. If copying fails, *this is untouched.
+SortedSet &SortedSet::operator=(const SortedSet &other) {
+  if (this != &other) {
+    SortedSet copy(other);
+    swap(copy);
+  }
+  return *this;
+}
+
+SortedSet::SortedSet(SortedSet &&other) noexcept { swap(other); }
+
+SortedSet &SortedSet::operator=(SortedSet &&other) noexcept {
+  if (this != &other) {
+    SortedSet empty;
+    other.swap(empty); // 'other' becomes empty, 'empty' holds its contents
+    swap(empty);       // we take them; our old contents die with 'empty'
+  }
+  return *this;
+}
+
+void SortedSet::swap(SortedSet &other) noexcept {
+  std::swap(encoding_, other.encoding_);
+  compact_.swap(other.compact_);
+  std::swap(header_, other.header_);
+  std::swap(tail_, other.tail_);
+  std::swap(level_, other.level_);
+  std::swap(length_, other.length_);
+  index_.swap(other.index_);
+  std::swap(rng_, other.rng_);
+}
+
+// =============================================================================
+// Public operations — each one dispatches on the current encoding
+// =============================================================================
+bool SortedSet::add(const std::string &member, double score) {
+  if (encoding_ == Encoding::COMPACT) {
+    const auto it = compact_find(member);
+    if (it != compact_.end()) {
+      if (it->score != score) {
+        compact_.erase(it);
+        compact_insert(member, score);
+      }
+      return false;
+    }
+
+    // Grow out of the compact encoding when it stops being "small"
+    if (compact_.size() + 1 > COMPACT_MAX_ENTRIES ||
+        member.size() > COMPACT_MAX_MEMBER_BYTES) {
+      convert_to_skiplist();
+    } else {
+      compact_insert(member, score);
+      return true;
+    }
+  }
+
+  const auto it = index_.find(member);
+  if (it != index_.end()) {
+    const double old_score = it->second->score;
+    if (old_score != score) {
+      // Re-position the member: erase the old node, insert a new one.
+      // The index entry must go first — its key views the node's string.
+      index_.erase(it);
+      skiplist_erase(old_score, member);
+      SkipNode *node = skiplist_insert(member, score);
+      index_.emplace(node->member, node);
+    }
+    return false;
+  }
+
+  SkipNode *node = skiplist_insert(member, score);
+  index_.emplace(node->member, node);
+  return true;
+}
+
+std::optional<double> SortedSet::increment(const std::string &member,
+                                           double delta) {
+  const double new_score = score(member).value_or(0.0) + delta;
+  if (std::isnan(new_score)) {
+    return std::nullopt;
+  }
+  add(member, new_score);
+  return new_score;
+}
+
+bool SortedSet::remove(const std::string &member) {
+  if (encoding_ == Encoding::COMPACT) {
+    const auto it = compact_find(member);
+    if (it == compact_.end()) {
+      return false;
+    }
+    compact_.erase(it);
+    return true;
+  }
+
+  const auto it = index_.find(member);
+  if (it == index_.end()) {
+    return false;
+  }
+  const double old_score = it->second->score;
+  index_.erase(it);
+  skiplist_erase(old_score, member);
+  return true;
+}
+
+std::optional<double> SortedSet::score(const std::string &member) const {
+  if (encoding_ == Encoding::COMPACT) {
+    const auto it = compact_find(member);
+    if (it == compact_.end()) {
+      return std::nullopt;
+    }
+    return it->score;
+  }
+
+  const auto it = index_.find(member);
+  if (it == index_.end()) {
+    return std::nullopt;
+  }
+  return it->second->score;
+}
+
+// =============================================================================
+// rank() — Walk the skiplist summing SPANS until we land on the member
+// =============================================================================
+std::optional<std::size_t> SortedSet::rank(const std::string &member) const {
+  if (encoding_ == Encoding::COMPACT) {
+    const auto it = compact_find(member);
+    if (it == compact_.end()) {
+      return std::nullopt;
+    }
+    return static_cast<std::size_t>(it - compact_.begin());
+  }
+
+  const auto found = index_.find(member);
+  if (found == index_.end()) {
+    return std::nullopt;
+  }
+  const double target_score = found->second->score;
+
+  std::size_t traversed = 0;
+  const SkipNode *x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    // Advance while the next node is <= the target
+    while (x->levels[i].forward != nullptr &&
+           !less(target_score, member, x->levels[i].forward->score,
+                 x->levels[i].forward->member)) {
+      traversed += x->levels[i].span;
+      x = x->levels[i].forward;
+    }
+    if (x != header_ && x->member == member) {
+      return traversed - 1; // spans count 1-based positions
+    }
+  }
+  return std::nullopt; // unreachable if index_ and the list agree
+}
+
+std::vector<ScoredMember> SortedSet::range_by_rank(long long start,
+                                                   long long stop) const {
+  const auto n = static_cast<long long>(size());
+
+  // Normalize negative indexes, then clamp to the valid range
+  if (start < 0) {
+    start += n;
+  }
+  if (stop < 0) {
+    stop += n;
+  }
+  if (start < 0) {
+    start = 0;
+  }
+  if (start > stop || start >= n) {
+    return {};
+  }
+  if (stop >= n) {
+    stop = n - 1;
+  }
+
+  std::vector<ScoredMember> result;
+  result.reserve(static_cast<std::size_t>(stop - start + 1));
+
+  if (encoding_ == Encoding::COMPACT) {
+    result.assign(compact_.begin() + start, compact_.begin() + stop + 1);
+    return result;
+  }
+
+  // O(log n) jump to the first node, then a plain level-0 walk
+  const SkipNode *x = skiplist_node_at(static_cast<std::size_t>(start) + 1);
+  for (long long i = start; i <= stop && x != nullptr; ++i) {
+    result.push_back(ScoredMember{x->member, x->score});
+    x = x->levels[0].forward;
+  }
+  return result;
+}
+
+std::vector<ScoredMember> SortedSet::range_by_score(double min,
+                                                    double max) const {
+  std::vector<ScoredMember> result;
+  if (min > max) {
+    return result;
+  }
+
+  if (encoding_ == Encoding::COMPACT) {
+    auto it = std::lower_bound(
+        compact_.begin(), compact_.end(), min,
+        [](const ScoredMember &item, double value) { return item.score < value; });
+    for (; it != compact_.end() && it->score <= max; ++it) {
+      result.push_back(*it);
+    }
+    return result;
+  }
+
+  // Descend to the last node with score < min...
+  const SkipNode *x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->levels[i].forward != nullptr &&
+           x->levels[i].forward->score < min) {
+      x = x->levels[i].forward;
+    }
+  }
+  // ...then walk forward while we're still inside the range
+  for (x = x->levels[0].forward; x != nullptr && x->score <= max;
+       x = x->levels[0].forward) {
+    result.push_back(ScoredMember{x->member, x->score});
+  }
+  return result;
+}
+
+std::size_t SortedSet::size() const {
+  return encoding_ == Encoding::COMPACT ? compact_.size() : length_;
+}
+
+bool SortedSet::empty() const { return size() == 0; }
+
+SortedSet::Encoding SortedSet::encoding() const { return encoding_; }
+
+// =============================================================================
+// Private helpers
+// =============================================================================
+bool SortedSet::less(double score_a, const std::string &member_a,
+                     double score_b, const std::string &member_b) {
+  if (score_a != score_b) {
+    return score_a < score_b;
+  }
+  return member_a < member_b;
+}
+
+std::vector<ScoredMember>::iterator
+SortedSet::compact_find(const std::string &member) {
+  return std::find_if(compact_.begin(), compact_.end(),
+                      [&member](const ScoredMember &item) {
+                        return item.member == member;
+                      });
+}
+
+std::vector<ScoredMember>::const_iterator
+SortedSet::compact_find(const std::string &member) const {
+  return std::find_if(compact_.begin(), compact_.end(),
+                      [&member](const ScoredMember &item) {
+                        return item.member == member;
+                      });
+}
+
+void SortedSet::compact_insert(const std::string &member, double score) {
+  // Binary search for the insertion point keeps the vector sorted
+  const auto pos = std::lower_bound(
+      compact_.begin(), compact_.end(), ScoredMember{member, score},
+      [](const ScoredMember &a, const ScoredMember &b) {
+        return less(a.score, a.member, b.score, b.member);
+      });
+  compact_.insert(pos, ScoredMember{member, score});
+}
+
+// =============================================================================
+// convert_to_skiplist() — One-way switch from COMPACT to SKIPLIST
+// =============================================================================
+void SortedSet::convert_to_skiplist() {
+  if (encoding_ == Encoding::SKIPLIST) {
+    return;
+  }
+
+  header_ = new SkipNode{std::string(), 0.0, nullptr,
+                         std::vector<SkipLevel>(SKIPLIST_MAX_LEVEL)};
+  tail_ = nullptr;
+  level_ = 1;
+  length_ = 0;
+  encoding_ = Encoding::SKIPLIST;
+
+  std::vector<ScoredMember> items;
+  items.swap(compact_);
+  index_.reserve(items.size());
+  for (const auto &item : items) {
+    SkipNode *node = skiplist_insert(item.member, item.score);
+    index_.emplace(node->member, node);
+  }
+}
+
+// Each extra level is kept with probability 1/4 (expected height ~1.33)
+int SortedSet::random_level() {
+  int level = 1;
+  while (level < SKIPLIST_MAX_LEVEL && rng_() % 4 == 0) {
+    ++level;
+  }
+  return level;
+}
+
+// =============================================================================
+// skiplist_insert() — The classic algorithm, plus span bookkeeping
+// =============================================================================
+// update[i] = the rightmost node on level i that comes BEFORE the new node
+// rank[i]   = how many nodes precede update[i]
+// After linking the node in, every predecessor's span is split in two:
+// the part before the new node and the part after it.
+// =============================================================================
+SortedSet::SkipNode *SortedSet::skiplist_insert(const std::string &member,
+                                                double score) {
+  std::array<SkipNode *, SKIPLIST_MAX_LEVEL> update{};
+  std::array<std::size_t, SKIPLIST_MAX_LEVEL> rank{};
+
+  SkipNode *x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    rank[i] = (i == level_ - 1) ? 0 : rank[i + 1];
+    while (x->levels[i].forward != nullptr &&
+           less(x->levels[i].forward->score, x->levels[i].forward->member,
+                score, member)) {
+      rank[i] += x->levels[i].span;
+      x = x->levels[i].forward;
+    }
+    update[i] = x;
+  }
+
+  const int new_level = random_level();
+  if (new_level > level_) {
+    // Brand-new lanes start at the header and skip the whole list
+    for (int i = level_; i < new_level; ++i) {
+      rank[i] = 0;
+      update[i] = header_;
+      update[i]->levels[i].span = length_;
+    }
+    level_ = new_level;
+  }
+
+  auto *node = new SkipNode{member, score, nullptr,
+                            std::vector<SkipLevel>(new_level)};
+  for (int i = 0; i < new_level; ++i) {
+    node->levels[i].forward = update[i]->levels[i].forward;
+    update[i]->levels[i].forward = node;
+
+    node->levels[i].span = update[i]->levels[i].span - (rank[0] - rank[i]);
+    update[i]->levels[i].span = (rank[0] - rank[i]) + 1;
+  }
+
+  // Lanes above the new node's height now skip one more node
+  for (int i = new_level; i < level_; ++i) {
+    update[i]->levels[i].span++;
+  }
+
+  node->backward = (update[0] == header_) ? nullptr : update[0];
+  if (node->levels[0].forward != nullptr) {
+    node->levels[0].forward->backward = node;
+  } else {
+    tail_ = node;
+  }
+
+  ++length_;
+  return node;
+}
+
+void SortedSet::skiplist_erase(double score, const std::string &member) {
+  std::array<SkipNode *, SKIPLIST_MAX_LEVEL> update{};
+
+  SkipNode *x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->levels[i].forward != nullptr &&
+           less(x->levels[i].forward->score, x->levels[i].forward->member,
+                score, member)) {
+      x = x->levels[i].forward;
+    }
+    update[i] = x;
+  }
+
+  x = x->levels[0].forward;
+  if (x == nullptr || x->score != score || x->member != member) {
+    return;
+  }
+
+  // Unlink on every level; predecessors absorb the removed node's span
+  for (int i = 0; i < level_; ++i) {
+    if (update[i]->levels[i].forward == x) {
+      update[i]->levels[i].span += x->levels[i].span - 1;
+      update[i]->levels[i].forward = x->levels[i].forward;
+    } else {
+      update[i]->levels[i].span -= 1;
+    }
+  }
+
+  if (x->levels[0].forward != nullptr) {
+    x->levels[0].forward->backward = x->backward;
+  } else {
+    tail_ = x->backward;
+  }
+
+  // Drop lanes that became empty
+  while (level_ > 1 && header_->levels[level_ - 1].forward == nullptr) {
+    --level_;
+  }
+
+  --length_;
+  delete x;
+}
+
+// Find the node at a 1-based rank by summing spans — O(log n)
+const SortedSet::SkipNode *
+SortedSet::skiplist_node_at(std::size_t rank_one_based) const {
+  std::size_t traversed = 0;
+  const SkipNode *x = header_;
+  for (int i = level_ - 1; i >= 0; --i) {
+    while (x->levels[i].forward != nullptr &&
+           traversed + x->levels[i].span <= rank_one_based) {
+      traversed += x->levels[i].span;
+      x = x->levels[i].forward;
+    }
+    if (traversed == rank_one_based) {
+      return x;
+    }
+  }
+  return nullptr;
+}
+
+// Iterative (not recursive!) teardown — a recursive delete of a
+// million-node list would overflow the stack.
+void SortedSet::free_skiplist() {
+  if (header_ == nullptr) {
+    return;
+  }
+  SkipNode *x = header_->levels[0].forward;
+  while (x != nullptr) {
+    SkipNode *next = x->levels[0].forward;
+    delete x;
+    x = next;
+  }
+  delete header_;
+  header_ = nullptr;
+  tail_ = nullptr;
+  index_.clear();
+  length_ = 0;
+  level_ = 1;
+}
+
+// =============================================================================
+// Snapshot encoding: u64 count | (bytes member, f64 score) in rank order
+// =============================================================================
+void SortedSet::serialize(std::string &out) const {
+  const auto all = range_by_rank(0, -1);
+  put_u64(out, all.size());
+  for (const auto &item : all) {
+    put_bytes(out, item.member);
+    put_f64(out, item.score);
+  }
+}
+
+std::optional<SortedSet> SortedSet::deserialize(ByteReader &in) {
+  std::uint64_t count = 0;
+  if (!in.get_u64(count)) {
+    return std::nullopt;
+  }
+
+  SortedSet zset;
+  for (std::uint64_t i = 0; i < count; ++i) {
+    std::string member;
+    double score = 0;
+    if (!in.get_bytes(member) || !in.get_f64(score) || std::isnan(score)) {
+      return std::nullopt;
+    }
+    zset.add(member, score);
+  }
+  return zset;
+}
+
+} // namespace mini_redis
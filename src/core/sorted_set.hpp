@@ -0,0 +1,167 @@
+// =============================================================================
+// sorted_set.hpp — Sorted Set Value Type (HEADER)
+// =============================================================================
+//
+// A SORTED SET is a collection of unique members, each with a numeric score,
+// kept ordered by (score, member). It's the data structure behind
+// leaderboards: "who is #1?", "what rank is alice?", "who scored 100-200?".
+//
+// Naively you'd store a vector and sort it on every request — O(n log n)
+// per query. We want:
+//   - add / remove / update score  → O(log n)
+//   - rank of a member             → O(log n)
+//   - range by rank or by score    → O(log n + k)  (k = items returned)
+//
+// TWO ENCODINGS (like real Redis):
+//   1. COMPACT  — a small sorted std::vector. For a handful of members,
+//      a linear scan over contiguous memory beats pointer chasing, and it
+//      uses far less memory (no per-node allocations).
+//   2. SKIPLIST — once the set grows past a threshold, we convert to a
+//      skiplist (ordered by score) PLUS a hash index (member → node) so that
+//      "what's alice's score?" is O(1) instead of O(n).
+//
+// WHAT IS A SKIPLIST?
+// A sorted linked list with "express lanes". Every node is on level 0; about
+// 1/4 of them are also on level 1, 1/16 on level 2, and so on. A search
+// starts on the highest lane and drops down a level whenever it would
+// overshoot — like taking the express train, then the local train.
+// Each forward pointer also stores a SPAN (how many nodes it skips), which
+// lets us compute a member's RANK while we search.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mini_redis {
+
+// One (member, score) pair, as returned by range queries
+struct ScoredMember {
+  std::string member;
+  double score;
+};
+
+class SortedSet {
+public:
+  // Which internal representation is currently in use (exposed for tests
+  // and for diagnostics — callers never need to care)
+  enum class Encoding { COMPACT, SKIPLIST };
+
+  SortedSet();
+  ~SortedSet();
+
+  // ---- Rule of Five ----
+  // The skiplist nodes are raw heap allocations that WE own, so the
+  // compiler-generated copy would copy the POINTERS (two sets sharing nodes
+  // → double delete). We write deep copies and pointer-stealing moves.
+  SortedSet(const SortedSet &other);
+  SortedSet &operator=(const SortedSet &other);
+  SortedSet(SortedSet &&other) noexcept;
+  SortedSet &operator=(SortedSet &&other) noexcept;
+
+  // ---- add() — Insert a member or update its score ----
+  // Returns true if the member is NEW, false if it already existed.
+  bool add(const std::string &member, double score);
+
+  // ---- increment() — Add 'delta' to a member's score (creating it at 0) ----
+  // Returns the new score, or std::nullopt if the result would be NaN
+  // (e.g. +inf + -inf) — in that case the set is left unchanged.
+  std::optional<double> increment(const std::string &member, double delta);
+
+  // ---- remove() — Returns true if the member existed ----
+  bool remove(const std::string &member);
+
+  // ---- score() — The member's score, or std::nullopt if absent ----
+  std::optional<double> score(const std::string &member) const;
+
+  // ---- rank() — 0-based position in ascending score order ----
+  std::optional<std::size_t> rank(const std::string &member) const;
+
+  // ---- range_by_rank() — Members with rank in [start, stop] ----
+  // Negative indexes count from the end (-1 = last), exactly like Redis
+  // ZRANGE, so range_by_rank(0, -1) returns everything.
+  std::vector<ScoredMember> range_by_rank(long long start,
+                                          long long stop) const;
+
+  // ---- range_by_score() — Members with min <= score <= max ----
+  std::vector<ScoredMember> range_by_score(double min, double max) const;
+
+  std::size_t size() const;
+  bool empty() const;
+  Encoding encoding() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<SortedSet> deserialize(ByteReader &in);
+
+private:
+  // ---- Skiplist building blocks ----
+  struct SkipNode;
+
+  // One "lane" of a node: where it points to, and how many nodes it skips
+  struct SkipLevel {
+    SkipNode *forward = nullptr;
+    std::size_t span = 0;
+  };
+
+  struct SkipNode {
+    std::string member;
+    double score;
+    SkipNode *backward;            // previous node on level 0 (for reverse walks)
+    std::vector<SkipLevel> levels; // levels.size() = this node's height
+  };
+
+  // ---- Tuning constants (same defaults as Redis) ----
+  static constexpr std::size_t COMPACT_MAX_ENTRIES = 128;
+  static constexpr std::size_t COMPACT_MAX_MEMBER_BYTES = 64;
+  static constexpr int SKIPLIST_MAX_LEVEL = 32;
+
+  // ---- Ordering: by score, ties broken by member (lexicographic) ----
+  static bool less(double score_a, const std::string &member_a, double score_b,
+                   const std::string &member_b);
+
+  // ---- Compact-encoding helpers ----
+  std::vector<ScoredMember>::iterator compact_find(const std::string &member);
+  std::vector<ScoredMember>::const_iterator
+  compact_find(const std::string &member) const;
+  void compact_insert(const std::string &member, double score);
+
+  // ---- Skiplist helpers ----
+  void convert_to_skiplist();
+  int random_level();
+  SkipNode *skiplist_insert(const std::string &member, double score);
+  void skiplist_erase(double score, const std::string &member);
+  const SkipNode *skiplist_node_at(std::size_t rank_one_based) const;
+  void free_skiplist();
+  void swap(SortedSet &other) noexcept;
+
+  Encoding encoding_ = Encoding::COMPACT;
+
+  // COMPACT encoding: sorted by (score, member)
+  std::vector<ScoredMember> compact_;
+
+  // SKIPLIST encoding
+  SkipNode *header_ = nullptr; // sentinel with SKIPLIST_MAX_LEVEL levels
+  SkipNode *tail_ = nullptr;
+  int level_ = 1;          // number of levels currently in use
+  std::size_t length_ = 0; // number of real nodes
+
+  // member → node. The string_view points INTO the node's own member
+  // string, so each member is stored exactly once. Safe because nodes
+  // never move in memory once allocated.
+  std::unordered_map<std::string_view, SkipNode *> index_;
+
+  // Random source for node heights. A plain LCG is plenty — we need a fair
+  // coin, not cryptographic randomness.
+  std::minstd_rand rng_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,469 @@
+// =============================================================================
+// stream.cpp — Append-Only Stream Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/stream.hpp"
+
+#include <charconv> // std::from_chars — fast, locale-free number parsing
+#include <iterator> // std::prev
+
+namespace mini_redis {
+
+namespace {
+
+// Entry flag: the entry's field names equal the block's master fields, so
+// only the values are stored
+constexpr std::uint8_t SAME_FIELDS = 0x1;
+
+// Reject absurd sizes when loading a (possibly corrupted) snapshot
+constexpr std::uint64_t MAX_BLOCK_BYTES = std::uint64_t{1} << 30;
+
+constexpr std::uint64_t MAX_U64 = ~std::uint64_t{0};
+
+std::optional<std::uint64_t> parse_u64(const char *begin, const char *end) {
+  std::uint64_t value = 0;
+  const auto [ptr, error] = std::from_chars(begin, end, value);
+  if (begin == end || error != std::errc{} || ptr != end) {
+    return std::nullopt;
+  }
+  return value;
+}
+
+bool same_names(const StreamFields &fields,
+                const std::vector<std::string> &names) {
+  if (fields.size() != names.size()) {
+    return false;
+  }
+  for (std::size_t i = 0; i < names.size(); ++i) {
+    if (fields[i].first != names[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// StreamId
+// =============================================================================
+std::optional<StreamId> StreamId::successor() const {
+  if (seq < MAX_U64) {
+    return StreamId{ms, seq + 1};
+  }
+  if (ms < MAX_U64) {
+    return StreamId{ms + 1, 0};
+  }
+  return std::nullopt;
+}
+
+std::optional<StreamId> StreamId::parse(const std::string &text,
+                                        std::uint64_t missing_seq) {
+  const char *begin = text.data();
+  const char *end = begin + text.size();
+  const auto dash = text.find('-');
+  if (dash == std::string::npos) {
+    const auto ms = parse_u64(begin, end);
+    if (!ms.has_value()) {
+      return std::nullopt;
+    }
+    return StreamId{*ms, missing_seq};
+  }
+
+  const auto ms = parse_u64(begin, begin + dash);
+  const auto seq = parse_u64(begin + dash + 1, end);
+  if (!ms.has_value() || !seq.has_value()) {
+    return std::nullopt;
+  }
+  return StreamId{*ms, *seq};
+}
+
+std::string StreamId::to_string() const {
+  return std::to_string(ms) + "-" + std::to_string(seq);
+}
+
+// =============================================================================
+// ID generation
+// =============================================================================
+std::optional<StreamId> Stream::next_id(std::uint64_t now_ms) const {
+  if (now_ms > last_id_.ms) {
+    return StreamId{now_ms, 0};
+  }
+  // Same millisecond (or the clock went backwards): keep counting
+  const auto next = last_id_.successor();
+  if (next.has_value() && *next == StreamId::min()) {
+    return StreamId{0, 1};
+  }
+  return next;
+}
+
+std::optional<StreamId> Stream::next_id_in(std::uint64_t ms) const {
+  if (ms > last_id_.ms) {
+    return StreamId{ms, 0};
+  }
+  if (ms < last_id_.ms || last_id_.seq == MAX_U64) {
+    return std::nullopt;
+  }
+  return StreamId{ms, last_id_.seq + 1}; // also turns an empty 0-0 into 0-1
+}
+
+// =============================================================================
+// Entry encoding inside a block
+// =============================================================================
+//   u8 flags | varint (ms - master.ms) | varint seq
+//   SAME_FIELDS: one short_bytes value per master field
+//   otherwise:   varint n | n × (short_bytes name, short_bytes value)
+// =============================================================================
+void Stream::encode_entry(Block &block, const StreamId &master,
+                          const StreamId &id, const StreamFields &fields) {
+  const bool same = same_names(fields, block.master_fields);
+  put_u8(block.bytes, same ? SAME_FIELDS : 0);
+  put_varint(block.bytes, id.ms - master.ms);
+  put_varint(block.bytes, id.seq);
+  if (same) {
+    for (const auto &field : fields) {
+      put_short_bytes(block.bytes, field.second);
+    }
+  } else {
+    put_varint(block.bytes, fields.size());
+    for (const auto &field : fields) {
+      put_short_bytes(block.bytes, field.first);
+      put_short_bytes(block.bytes, field.second);
+    }
+  }
+  block.last = id;
+  ++block.count;
+}
+
+bool Stream::decode_block(const StreamId &master, const Block &block,
+                          std::vector<StreamEntry> &out, StreamId start,
+                          StreamId end, std::size_t limit) {
+  ByteReader reader(block.bytes);
+  std::optional<StreamId> previous;
+  std::string_view name;
+  std::string_view value;
+
+  for (std::uint32_t i = 0; i < block.count; ++i) {
+    std::uint8_t flags = 0;
+    std::uint64_t ms_delta = 0;
+    StreamId id;
+    if (!reader.get_u8(flags) || !reader.get_varint(ms_delta) ||
+        !reader.get_varint(id.seq) || ms_delta > MAX_U64 - master.ms) {
+      return false;
+    }
+    id.ms = master.ms + ms_delta;
+    if (previous.has_value() ? id <= *previous : id != master) {
+      return false; // IDs must start at the master and strictly ascend
+    }
+    previous = id;
+    if (end < id) {
+      return true; // past the range: the rest of the block isn't needed
+    }
+
+    // Entries before 'start' are stepped over as views, never copied
+    const bool wanted = !(id < start);
+    StreamEntry *entry = nullptr;
+    if (wanted) {
+      entry = &out.emplace_back();
+      entry->id = id;
+    }
+
+    if ((flags & SAME_FIELDS) != 0) {
+      if (wanted) {
+        entry->fields.reserve(block.master_fields.size());
+      }
+      for (const auto &master_name : block.master_fields) {
+        if (!reader.get_short_bytes(value)) {
+          return false;
+        }
+        if (wanted) {
+          entry->fields.emplace_back(master_name, value);
+        }
+      }
+    } else {
+      std::uint64_t field_count = 0;
+      if (!reader.get_varint(field_count) ||
+          field_count > reader.remaining() / 2) {
+        return false;
+      }
+      if (wanted) {
+        entry->fields.reserve(field_count);
+      }
+      for (std::uint64_t f = 0; f < field_count; ++f) {
+        if (!reader.get_short_bytes(name) || !reader.get_short_bytes(value)) {
+          return false;
+        }
+        if (wanted) {
+          entry->fields.emplace_back(name, value);
+        }
+      }
+    }
+    if (wanted && limit > 0 && out.size() == limit) {
+      return true;
+    }
+  }
+  return reader.at_end() && previous.has_value();
+}
+
+void Stream::insert_blocks(const std::vector<StreamEntry> &entries) {
+  Block *block = nullptr;
+  StreamId master;
+  for (const auto &entry : entries) {
+    if (block == nullptr || block->full()) {
+      master = entry.id;
+      block = &blocks_[master];
+      for (const auto &field : entry.fields) {
+        block->master_fields.push_back(field.first);
+      }
+    }
+    encode_entry(*block, master, entry.id, entry.fields);
+  }
+}
+
+// =============================================================================
+// add() — Append to the newest block, or start a new one
+// =============================================================================
+bool Stream::add(StreamId id, const StreamFields &fields) {
+  if (id <= last_id_ || id == StreamId::min()) {
+    return false;
+  }
+
+  if (blocks_.empty() || blocks_.rbegin()->second.full()) {
+    Block block;
+    block.master_fields.reserve(fields.size());
+    for (const auto &field : fields) {
+      block.master_fields.push_back(field.first);
+    }
+    blocks_.emplace_hint(blocks_.end(), id, std::move(block));
+  }
+
+  auto &[master, block] = *blocks_.rbegin();
+  encode_entry(block, master, id, fields);
+  last_id_ = id;
+  ++size_;
+  return true;
+}
+
+// =============================================================================
+// range() / read_after()
+// =============================================================================
+std::vector<StreamEntry> Stream::range(StreamId start, StreamId end,
+                                       std::size_t count) const {
+  std::vector<StreamEntry> out;
+  if (end < start) {
+    return out;
+  }
+
+  // The block holding 'start' is the last one whose master ID <= start
+  auto it = blocks_.upper_bound(start);
+  if (it != blocks_.begin()) {
+    it = std::prev(it);
+  }
+
+  for (; it != blocks_.end() && it->first <= end; ++it) {
+    if (it->second.last < start) {
+      continue;
+    }
+    decode_block(it->first, it->second, out, start, end, count);
+    if (count > 0 && out.size() == count) {
+      break;
+    }
+  }
+  return out;
+}
+
+std::vector<StreamEntry> Stream::read_after(StreamId after,
+                                            std::size_t count) const {
+  const auto start = after.successor();
+  if (!start.has_value()) {
+    return {};
+  }
+  return range(*start, StreamId::max(), count);
+}
+
+// =============================================================================
+// Trimming — whole blocks from the front, then re-pack the boundary block
+// =============================================================================
+std::size_t Stream::trim_max_len(std::size_t max_len) {
+  if (size_ <= max_len) {
+    return 0;
+  }
+  std::size_t excess = size_ - max_len;
+  const std::size_t removed = excess;
+
+  while (!blocks_.empty() && blocks_.begin()->second.count <= excess) {
+    excess -= blocks_.begin()->second.count;
+    size_ -= blocks_.begin()->second.count;
+    blocks_.erase(blocks_.begin());
+  }
+
+  if (excess > 0) {
+    std::vector<StreamEntry> entries;
+    decode_block(blocks_.begin()->first, blocks_.begin()->second, entries);
+    blocks_.erase(blocks_.begin());
+    entries.erase(entries.begin(), entries.begin() + excess);
+    insert_blocks(entries);
+    size_ -= excess;
+  }
+  return removed;
+}
+
+std::size_t Stream::trim_min_id(StreamId min_id) {
+  const std::size_t before = size_;
+
+  while (!blocks_.empty() && blocks_.begin()->second.last < min_id) {
+    size_ -= blocks_.begin()->second.count;
+    blocks_.erase(blocks_.begin());
+  }
+
+  if (!blocks_.empty() && blocks_.begin()->first < min_id) {
+    std::vector<StreamEntry> entries;
+    decode_block(blocks_.begin()->first, blocks_.begin()->second, entries);
+    size_ -= entries.size();
+    blocks_.erase(blocks_.begin());
+
+    std::size_t drop = 0;
+    while (drop < entries.size() && entries[drop].id < min_id) {
+      ++drop;
+    }
+    entries.erase(entries.begin(), entries.begin() + drop);
+    size_ += entries.size();
+    insert_blocks(entries);
+  }
+  return before - size_;
+}
+
+// =============================================================================
+// Consumer offsets
+// =============================================================================
+std::optional<StreamId> Stream::offset(const std::string &consumer) const {
+  const auto it = offsets_.find(consumer);
+  if (it == offsets_.end()) {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void Stream::set_offset(const std::string &consumer, StreamId id) {
+  offsets_[consumer] = id;
+}
+
+const std::map<std::string, StreamId> &Stream::offsets() const {
+  return offsets_;
+}
+
+std::size_t Stream::size() const { return size_; }
+
+bool Stream::empty() const { return size_ == 0; }
+
+StreamId Stream::last_id() const { return last_id_; }
+
+std::optional<StreamId> Stream::first_id() const {
+  if (blocks_.empty()) {
+    return std::nullopt;
+  }
+  return blocks_.begin()->first;
+}
+
+std::size_t Stream::block_count() const { return blocks_.size(); }
+
+std::size_t Stream::memory_bytes() const {
+  std::size_t bytes = 0;
+  for (const auto &[master, block] : blocks_) {
+    bytes += block.bytes.size();
+  }
+  return bytes;
+}
+
+// =============================================================================
+// Snapshot encoding
+// =============================================================================
+//   u64 last ms | u64 last seq | u64 block count
+//   per block: u64 master ms | u64 master seq | u32 entries
+//              u32 field names | bytes per name | bytes packed entries
+//   u32 consumers | per consumer: bytes name | u64 ms | u64 seq
+// Blocks are stored packed, as in memory; loading decodes each one to
+// validate it (and to recover its last ID).
+// =============================================================================
+void Stream::serialize(std::string &out) const {
+  put_u64(out, last_id_.ms);
+  put_u64(out, last_id_.seq);
+  put_u64(out, blocks_.size());
+  for (const auto &[master, block] : blocks_) {
+    put_u64(out, master.ms);
+    put_u64(out, master.seq);
+    put_u32(out, block.count);
+    put_u32(out, static_cast<std::uint32_t>(block.master_fields.size()));
+    for (const auto &name : block.master_fields) {
+      put_bytes(out, name);
+    }
+    put_bytes(out, block.bytes);
+  }
+  put_u32(out, static_cast<std::uint32_t>(offsets_.size()));
+  for (const auto &[consumer, id] : offsets_) {
+    put_bytes(out, consumer);
+    put_u64(out, id.ms);
+    put_u64(out, id.seq);
+  }
+}
+
+std::optional<Stream> Stream::deserialize(ByteReader &in) {
+  Stream stream;
+  std::uint64_t block_count = 0;
+  if (!in.get_u64(stream.last_id_.ms) || !in.get_u64(stream.last_id_.seq) ||
+      !in.get_u64(block_count)) {
+    return std::nullopt;
+  }
+
+  std::vector<StreamEntry> entries;
+  std::optional<StreamId> previous_last;
+  for (std::uint64_t n = 0; n < block_count; ++n) {
+    StreamId master;
+    Block block;
+    std::uint32_t field_count = 0;
+    if (!in.get_u64(master.ms) || !in.get_u64(master.seq) ||
+        !in.get_u32(block.count) || !in.get_u32(field_count) ||
+        block.count == 0 || field_count > in.remaining() / 4) {
+      return std::nullopt;
+    }
+    block.master_fields.resize(field_count);
+    for (auto &name : block.master_fields) {
+      if (!in.get_bytes(name)) {
+        return std::nullopt;
+      }
+    }
+    if (!in.get_bytes(block.bytes) || block.bytes.size() > MAX_BLOCK_BYTES) {
+      return std::nullopt;
+    }
+
+    // Decoding validates the bytes and recovers the block's last ID
+    entries.clear();
+    if (!decode_block(master, block, entries) ||
+        (previous_last.has_value() && master <= *previous_last) ||
+        stream.last_id_ < entries.back().id) {
+      return std::nullopt;
+    }
+    block.last = entries.back().id;
+    previous_last = block.last;
+    stream.size_ += block.count;
+    stream.blocks_.emplace_hint(stream.blocks_.end(), master,
+                                std::move(block));
+  }
+
+  std::uint32_t consumer_count = 0;
+  if (!in.get_u32(consumer_count)) {
+    return std::nullopt;
+  }
+  for (std::uint32_t i = 0; i < consumer_count; ++i) {
+    std::string consumer;
+    StreamId id;
+    if (!in.get_bytes(consumer) || !in.get_u64(id.ms) ||
+        !in.get_u64(id.seq)) {
+      return std::nullopt;
+    }
+    stream.offsets_[consumer] = id;
+  }
+  return stream;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,178 @@
+// =============================================================================
+// stream.hpp — Append-Only Stream Value Type (HEADER)
+// =============================================================================
+//
+// A STREAM is an append-only log of ENTRIES, each a small set of
+// field/value pairs with a unique, ever-increasing ID:
+//   1700000000000-0  { sensor: t1, temp: 21.5 }
+//   1700000000000-1  { sensor: t2, temp: 19.0 }
+//   1700000000007-0  { sensor: t1, temp: 21.6 }
+// The ID is "<milliseconds>-<sequence>": the time it was added, plus a
+// counter for entries added in the same millisecond. Readers remember the
+// last ID they saw and ask for "everything after it" — many independent
+// readers can follow the same log, each at its own pace.
+//
+// COMPACT BLOCKS (like Redis' listpacks):
+// Entries are packed into BLOCKS of up to 100 entries / 4 KB. Inside a
+// block, each entry stores its ID as a small delta from the block's first
+// ("master") ID, and since entries in a log usually have the SAME field
+// names, an entry whose fields match the master entry's stores only its
+// values. A 30-byte event costs ~35 bytes instead of hundreds.
+//
+// INDEX:
+// Redis indexes its blocks with a radix tree keyed by the 128-bit master
+// ID. We use an ordered std::map keyed by the same ID: both give "find the
+// block that holds ID x" in O(log blocks), and std::map needs no code of
+// its own. Inside a block, entries are found by a short linear decode.
+//
+// CONSUMER OFFSETS:
+// The stream also remembers, per named consumer, the last ID delivered to
+// it — so a reader can say "give me what I haven't seen yet" without
+// tracking anything itself, and resume there after reconnecting.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mini_redis {
+
+// =============================================================================
+// StreamId — "<ms>-<seq>", ordered by ms, then seq
+// =============================================================================
+struct StreamId {
+  std::uint64_t ms = 0;
+  std::uint64_t seq = 0;
+
+  static constexpr StreamId min() { return StreamId{0, 0}; }
+  static constexpr StreamId max() {
+    return StreamId{~std::uint64_t{0}, ~std::uint64_t{0}};
+  }
+
+  // The smallest ID greater than this one (std::nullopt after max())
+  std::optional<StreamId> successor() const;
+
+  // "1700-3" → {1700, 3}; a bare "1700" → {1700, missing_seq}.
+  // missing_seq lets range ends mean "the whole millisecond":
+  // start=1700 → 1700-0, end=1700 → 1700-<max>.
+  static std::optional<StreamId> parse(const std::string &text,
+                                       std::uint64_t missing_seq = 0);
+
+  std::string to_string() const;
+
+  bool operator==(const StreamId &other) const {
+    return ms == other.ms && seq == other.seq;
+  }
+  bool operator!=(const StreamId &other) const { return !(*this == other); }
+  bool operator<(const StreamId &other) const {
+    return ms < other.ms || (ms == other.ms && seq < other.seq);
+  }
+  bool operator<=(const StreamId &other) const { return !(other < *this); }
+  bool operator>(const StreamId &other) const { return other < *this; }
+};
+
+using StreamFields = std::vector<std::pair<std::string, std::string>>;
+
+struct StreamEntry {
+  StreamId id;
+  StreamFields fields;
+};
+
+class Stream {
+public:
+  // Redis' stream-node-max-entries / stream-node-max-bytes defaults
+  static constexpr std::size_t BLOCK_MAX_ENTRIES = 100;
+  static constexpr std::size_t BLOCK_MAX_BYTES = 4096;
+
+  // ---- next_id() — The ID XADD assigns for "*" ----
+  // <now>-0, or <last ms>-<last seq + 1> if the clock hasn't moved past
+  // the last entry (same millisecond, or the clock stepped backwards).
+  // std::nullopt once the ID space is exhausted.
+  std::optional<StreamId> next_id(std::uint64_t now_ms) const;
+
+  // ---- next_id_in() — The ID for "<ms>-*": next sequence in that ms ----
+  std::optional<StreamId> next_id_in(std::uint64_t ms) const;
+
+  // ---- add() — Append an entry; false if id <= last_id() or 0-0 ----
+  bool add(StreamId id, const StreamFields &fields);
+
+  // ---- range() — Entries with start <= id <= end, oldest first ----
+  // count == 0 means no limit.
+  std::vector<StreamEntry> range(StreamId start, StreamId end,
+                                 std::size_t count = 0) const;
+
+  // ---- read_after() — Entries with id > after (XREAD) ----
+  std::vector<StreamEntry> read_after(StreamId after,
+                                      std::size_t count = 0) const;
+
+  // ---- Trimming (XTRIM); both return how many entries were removed ----
+  std::size_t trim_max_len(std::size_t max_len);
+  std::size_t trim_min_id(StreamId min_id);
+
+  // ---- Consumer offsets: the last ID delivered to each consumer ----
+  std::optional<StreamId> offset(const std::string &consumer) const;
+  void set_offset(const std::string &consumer, StreamId id);
+  const std::map<std::string, StreamId> &offsets() const;
+
+  std::size_t size() const;
+  bool empty() const;
+
+  // 0-0 until the first add(). Trimming never lowers it: IDs are never
+  // reused, even after the entries holding them are gone.
+  StreamId last_id() const;
+  std::optional<StreamId> first_id() const;
+
+  std::size_t block_count() const;
+
+  // Bytes of packed entry data (excluding the index and field-name lists)
+  std::size_t memory_bytes() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<Stream> deserialize(ByteReader &in);
+
+private:
+  struct Block {
+    std::vector<std::string> master_fields; // field names of the 1st entry
+    std::string bytes;                      // packed entries
+    std::uint32_t count = 0;
+    StreamId last;
+
+    bool full() const {
+      return count >= BLOCK_MAX_ENTRIES || bytes.size() >= BLOCK_MAX_BYTES;
+    }
+  };
+
+  // Keyed by the block's first ("master") ID
+  using BlockMap = std::map<StreamId, Block>;
+
+  static void encode_entry(Block &block, const StreamId &master,
+                           const StreamId &id, const StreamFields &fields);
+
+  // Append the block's entries with start <= id <= end to 'out', stopping
+  // once 'out' holds 'limit' entries (0 = no limit). False if the bytes are
+  // malformed (checked only as far as decoding got).
+  static bool decode_block(const StreamId &master, const Block &block,
+                           std::vector<StreamEntry> &out,
+                           StreamId start = StreamId::min(),
+                           StreamId end = StreamId::max(),
+                           std::size_t limit = 0);
+
+  // Re-pack 'entries' (sorted) as fresh blocks and insert them
+  void insert_blocks(const std::vector<StreamEntry> &entries);
+
+  BlockMap blocks_;
+  std::size_t size_ = 0;
+  StreamId last_id_;
+  std::map<std::string, StreamId> offsets_;
+};
+
+} // namespace mini_redis
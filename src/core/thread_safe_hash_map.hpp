@@ -30,16 +30,49 @@
 //
 // In competitive programming, you use templates without thinking (vector<int>).
 // Here, we're CREATING a template class.
+//
+// SHARDING — MANY LOCKS INSTEAD OF ONE:
+// A single lock means every SET waits for every other SET, even on
+// unrelated keys. The map is split into SHARD_COUNT independent shards,
+// each with its own unordered_map and shared_mutex; a key always lives in
+// the shard picked by the top bits of its hash, so writers to different
+// shards never meet.
+//
+// ONE HASH PER KEY:
+// Picking the shard needs the key's hash, and so does the bucket lookup
+// inside the shard's unordered_map — hashing twice would double the cost
+// of the cheapest operation we have. So the hash is computed ONCE
+// (hash_of(), also callable by code that touches a key more than once)
+// and handed to the shard's table through a thread-local "hint" that its
+// hasher checks first (see HintedHasher in map_policies.hpp).
+//
+// POLICIES:
+// The table inside each shard, the lock guarding it, and the number of
+// shards are template parameters (see map_policies.hpp). The defaults —
+// std::unordered_map, std::shared_mutex, 16 shards — are what the store
+// uses; bench_map_matrix compares the other combinations.
+//
+// GROUP PREFETCHING (read_many, compute_many):
+// A lookup in a big table is mostly waiting for one cache miss, and
+// probing a batch key by key waits for each miss in turn. But the keys'
+// hashes are all known up front, so while key i is probed the table is
+// already asked to PREFETCH key i + PREFETCH_DISTANCE's bucket: several
+// independent misses are in flight at once, and by the time a key's turn
+// comes its memory is (ideally) already in the cache.
 // =============================================================================
 
 #pragma once
 
-#include <functional>    // std::function — for callbacks
-#include <optional>      // std::optional — a value that might not exist
-#include <shared_mutex>  // std::shared_mutex — reader-writer lock
-#include <string>        // std::string
-#include <unordered_map> // The underlying hash table
-#include <vector>        // std::vector — dynamic array
+#include "core/map_policies.hpp"
+
+#include <array>        // std::array — the fixed set of shards
+#include <cstdint>      // std::uint64_t
+#include <functional>   // std::function — for callbacks
+#include <mutex>        // std::lock_guard, std::unique_lock
+#include <optional>     // std::optional — a value that might not exist
+#include <shared_mutex> // std::shared_lock
+#include <type_traits>  // std::is_same_v
+#include <vector>       // std::vector — dynamic array
 
 namespace mini_redis {
 
@@ -62,8 +95,45 @@ namespace mini_redis {
 //   }
 // =============================================================================
 
-template <typename Key, typename Value> class ThreadSafeHashMap {
+// =============================================================================
+// ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>
+// =============================================================================
+// Storage   : NodeStorage | FlatStorage | OrderedStorage (map_policies.hpp)
+// Lock      : SharedMutexLock | SpinLock | SeqLock | NoLock
+// ShardCount: a power of two; 1 = no sharding
+// =============================================================================
+template <typename Key, typename Value, typename Storage = NodeStorage,
+          typename Lock = SharedMutexLock, std::size_t ShardCount = 16>
+class ThreadSafeHashMap {
+  static_assert(ShardCount > 0 && (ShardCount & (ShardCount - 1)) == 0,
+                "ShardCount must be a power of two");
+
 public:
+  // A power of two, so the shard is simply the hash's top bits
+  static constexpr std::size_t SHARD_COUNT = ShardCount;
+
+  // The table inside each shard
+  using Table = typename Storage::template Table<Key, Value>;
+
+  // ---- Does get() read without locking? ----
+  // Only a SeqLock over a flat table of plain-old-data can: see
+  // map_policies.hpp for why the other combinations can't.
+  static constexpr bool OPTIMISTIC_READS = [] {
+    if constexpr (std::is_same_v<Lock, SeqLock> &&
+                  std::is_same_v<Storage, FlatStorage>) {
+      return Table::SUPPORTS_OPTIMISTIC_READS;
+    } else {
+      return false;
+    }
+  }();
+
+  ThreadSafeHashMap();
+
+  // ---- hash_of() — The hash every operation on 'key' needs ----
+  // Each operation below also has an overload taking this hash, for
+  // callers that touch the same key more than once per request.
+  std::uint64_t hash_of(const Key &key) const { return KeyHasher<Key>{}(key); }
+
   // ---- get() — Thread-safe read ----
   // Returns std::optional<Value>:
   //   - If the key exists → returns the value wrapped in optional
@@ -74,14 +144,67 @@ public:
   // The compiler enforces it — you'll get an error if you try to modify
   // any member variables inside a const function.
   std::optional<Value> get(const Key &key) const;
+  std::optional<Value> get(const Key &key, std::uint64_t hash) const;
+
+  // ---- read() — Inspect a value IN PLACE under the read lock ----
+  // get() returns a COPY, which is fine for short strings but wasteful for
+  // big values (a sorted set with a million members!). read() instead runs
+  // the callback on the stored value while holding the shared lock.
+  // Returns false (and never calls the reader) if the key doesn't exist.
+  bool read(const Key &key,
+            const std::function<void(const Value &)> &reader) const;
+  bool read(const Key &key, std::uint64_t hash,
+            const std::function<void(const Value &)> &reader) const;
+
+  // ---- read_many() — Inspect SEVERAL values under ONE read lock ----
+  // The reader gets one pointer per requested key, in the same order
+  // (nullptr for a missing key). Calling read() inside read() would take
+  // the shared lock twice, which can deadlock as soon as a writer queues
+  // up between the two acquisitions — so multi-key reads go through here.
+  // The keys' shards are locked together, in ascending shard order (two
+  // readers taking overlapping shards in opposite orders could otherwise
+  // deadlock against a waiting writer).
+  void read_many(const std::vector<Key> &keys,
+                 const std::function<void(const std::vector<const Value *> &)>
+                     &reader) const;
 
   // ---- set() — Thread-safe write ----
   // Inserts or overwrites the value for the given key.
   void set(const Key &key, const Value &value);
+  void set(const Key &key, std::uint64_t hash, const Value &value);
+
+  // ---- compute() — Atomic read-modify-write of ONE entry ----
+  // Inspired by Java's Map.compute(). The callback receives:
+  //   - value:  the stored value, or a default-constructed Value if absent
+  //   - exists: whether the key was present before the call
+  // and returns whether the entry should EXIST afterwards:
+  //   - true  → keep it (inserting it if it was absent)
+  //   - false → erase it (or don't insert it if it was absent)
+  //
+  // WHY NOT get() + set()?
+  // Between the get() and the set(), another thread could modify the same
+  // key and its update would be silently lost (a "lost update" race).
+  // compute() runs the whole read-modify-write under ONE exclusive lock.
+  void compute(const Key &key,
+               const std::function<bool(Value &value, bool exists)> &fn);
+  void compute(const Key &key, std::uint64_t hash,
+               const std::function<bool(Value &value, bool exists)> &fn);
+
+  // ---- compute_many() — compute() for a batch of keys ----
+  // Runs fn(index, value, exists) for keys[0], keys[1], ... in order,
+  // with the keys' shards locked exclusively for the whole batch (in
+  // ascending order, like read_many()) and their buckets prefetched
+  // ahead of each probe. For bulk writes such as loading a snapshot;
+  // keep batches modest, as every involved shard is held throughout.
+  void compute_many(
+      const std::vector<Key> &keys,
+      const std::function<bool(std::size_t index, Value &value, bool exists)>
+          &fn);
 
   // ---- remove() — Thread-safe delete ----
   // Returns true if the key was found and removed, false if it didn't exist.
   bool remove(const Key &key);
+  bool remove(const Key &key, std::uint64_t hash);
 
   // ---- keys() — Get all keys (thread-safe) ----
   // Returns a COPY of all keys. Returning by value (not by reference)
@@ -92,10 +215,16 @@ public:
   // ---- size() — Number of entries ----
   std::size_t size() const;
 
+  // ---- reserve() — Pre-size for 'count' entries in all ----
+  // Each shard gets room for its share (the hash spreads keys evenly), one
+  // shard locked at a time. A bulk load that knows its size up front
+  // then skips the chain of rehashes growing would cost.
+  void reserve(std::size_t count);
+
   // ---- for_each() — Iterate with a callback (thread-safe) ----
   // Takes a function that receives (key, value) for each entry.
-  // The entire iteration happens under a shared lock, so the map
-  // won't change mid-iteration.
+  // The entire iteration happens under the shared locks of ALL shards, so
+  // the map won't change mid-iteration (keys() and size() do the same).
   //
   // WHY USE A CALLBACK INSTEAD OF RETURNING AN ITERATOR?
   // Iterators become invalid if another thread modifies the map.
@@ -103,6 +232,20 @@ public:
   void for_each(
       const std::function<void(const Key &, const Value &)> &callback) const;
 
+  // ---- lock_all_shared() / for_each_locked() — One instant, two maps ----
+  // for_each() releases its locks when it returns, so walking two maps one
+  // after the other can see a write land between the walks. To see both
+  // at ONE instant, take both maps' locks first, then walk each:
+  //   const auto a_locks = a.lock_all_shared();
+  //   const auto b_locks = b.lock_all_shared();
+  //   a.for_each_locked(a_locks, ...); b.for_each_locked(b_locks, ...);
+  // Passing the locks in is what proves the caller holds them.
+  using SharedLocks = std::vector<std::shared_lock<Lock>>;
+  SharedLocks lock_all_shared() const;
+  void for_each_locked(
+      const SharedLocks &locks,
+      const std::function<void(const Key &, const Value &)> &callback) const;
+
   // ---- remove_if() — Remove entries matching a condition ----
   // Takes a predicate function. For each entry where predicate returns
   // true, that entry is removed. Returns how many entries were removed.
@@ -110,22 +253,84 @@ public:
   std::size_t
   remove_if(const std::function<bool(const Key &, const Value &)> &predicate);
 
+  // ---- update_each() — Modify every entry in place ----
+  // Like for_each(), but under the EXCLUSIVE lock and with a mutable value.
+  // Used by the expiry manager to trim time series to their retention.
+  // remove_if() and update_each() lock one shard at a time: background
+  // maintenance has no reason to stall the whole map at once.
+  void update_each(const std::function<void(const Key &, Value &)> &callback);
+
+  // ---- relocate() — Re-create entries in fresh memory, a slice at once ----
+  // For active defragmentation (core/defragmenter.hpp). Walks up to
+  // 'max_buckets' buckets from 'cursor' under ONE shard's exclusive lock,
+  // so readers of other shards never wait and this shard only briefly.
+  // Every value is offered to relocate_value(); every entry whose node
+  // should_move() flags gets a new node, allocated while the old one is
+  // still held so it can't be handed the same memory back. Pass the
+  // returned cursor in next time; 0 means the pass is complete.
+  // ("Buckets" are whatever the storage walks by: hash buckets, flat
+  // slots — whose one array is the only block to move — or tree ranks.)
+  struct RelocateResult {
+    std::size_t cursor = 0;
+    std::size_t visited = 0; // entries looked at
+    std::size_t moved = 0;   // nodes re-created
+  };
+  RelocateResult relocate(std::size_t cursor, std::size_t max_buckets,
+                          const std::function<bool(const void *)> &should_move,
+                          const std::function<void(Value &)> &relocate_value);
+
 private:
-  // The actual data — a standard hash map
-  std::unordered_map<Key, Value> map_;
+  // One shard: a table and the lock guarding it. alignas(64) puts each
+  // shard on its own cache line(s), so threads locking neighbouring
+  // shards don't fight over the same line ("false sharing").
+  struct alignas(64) Shard {
+    Table table;
+
+    // "mutable" keyword explained:
+    // Problem: get() is a const function (doesn't modify the map data),
+    // but it needs to LOCK the mutex (which modifies the mutex's state).
+    //
+    // "mutable" says: "this member CAN be modified even in const
+    // functions." It's used for synchronization primitives and caches —
+    // things that are implementation details, not observable state.
+    mutable Lock mutex;
+  };
+
+  static constexpr int shard_bits() {
+    int bits = 0;
+    while ((std::size_t{1} << bits) < ShardCount) {
+      ++bits;
+    }
+    return bits;
+  }
+  static constexpr int SHARD_BITS = shard_bits();
+  static constexpr int CURSOR_SHARD_SHIFT = 48; // relocate(): shard | slot
+
+  // The top SHARD_BITS bits of the hash (a shift by 64 would be undefined,
+  // hence the single-shard case)
+  static std::size_t shard_index(std::uint64_t hash) {
+    if constexpr (SHARD_BITS == 0) {
+      return 0;
+    } else {
+      return static_cast<std::size_t>(hash >> (64 - SHARD_BITS));
+    }
+  }
 
-  // "mutable" keyword explained:
-  // Problem: get() is a const function (doesn't modify the map data),
-  // but it needs to LOCK the mutex (which modifies the mutex's state).
-  //
-  // "mutable" says: "this member CAN be modified even in const functions."
-  // It's used for synchronization primitives and caches — things that
-  // are implementation details, not observable state.
-  //
-  // Without mutable: the const get() function can't lock the mutex → won't
-  // compile With mutable:    the const get() function can lock/unlock the mutex
-  // ✓
-  mutable std::shared_mutex mutex_;
+  Shard &shard_for(std::uint64_t hash) { return shards_[shard_index(hash)]; }
+  const Shard &shard_for(std::uint64_t hash) const {
+    return shards_[shard_index(hash)];
+  }
+
+  // How many keys ahead of the probe a batch prefetches: far enough to
+  // cover a miss's latency, near enough that the lines are still cached
+  static constexpr std::size_t PREFETCH_DISTANCE = 8;
+
+  // The body of compute(), for a shard that is already locked
+  template <typename F>
+  static void compute_locked(Shard &shard, const Key &key, std::uint64_t hash,
+                             F &&fn);
+
+  std::array<Shard, SHARD_COUNT> shards_;
 };
 
 // =============================================================================
@@ -143,60 +348,259 @@ private:
 // This is the ONE exception to the "implementations go in .cpp" rule.
 // =============================================================================
 
-template <typename Key, typename Value>
-std::optional<Value> ThreadSafeHashMap<Key, Value>::get(const Key &key) const {
-  // shared_lock = READ lock — multiple threads can hold this simultaneously
-  // This is safe because reading doesn't modify the map.
-  std::shared_lock<std::shared_mutex> lock(mutex_);
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::ThreadSafeHashMap() {
+  if constexpr (OPTIMISTIC_READS) {
+    for (Shard &shard : shards_) {
+      shard.table.retain_retired_arrays();
+    }
+  }
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+std::optional<Value>
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::get(
+    const Key &key) const {
+  return get(key, hash_of(key));
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+std::optional<Value>
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::get(
+    const Key &key, std::uint64_t hash) const {
+  const Shard &shard = shard_for(hash);
+
+  // SeqLock: copy the value without taking any lock, then check that no
+  // writer was active meanwhile; if one was, the copy may be torn — retry
+  if constexpr (OPTIMISTIC_READS) {
+    for (;;) {
+      const std::uint64_t sequence = shard.mutex.read_begin();
+      std::optional<Value> value = shard.table.find_unlocked(key, hash);
+      if (!shard.mutex.read_retry(sequence)) {
+        return value;
+      }
+    }
+  } else {
+    // shared_lock = READ lock — multiple threads can hold this
+    // simultaneously (with SharedMutexLock; the other locks serialise)
+    std::shared_lock<Lock> lock(shard.mutex);
+
+    const Value *value = shard.table.find(key, hash);
+    if (value == nullptr) {
+      // Key not found → return "empty" optional
+      return std::nullopt;
+    }
+    // Key found → return a copy wrapped in optional
+    return *value;
+  }
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+bool ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::read(
+    const Key &key, const std::function<void(const Value &)> &reader) const {
+  return read(key, hash_of(key), reader);
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+bool ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::read(
+    const Key &key, std::uint64_t hash,
+    const std::function<void(const Value &)> &reader) const {
+  const Shard &shard = shard_for(hash);
+  std::shared_lock<Lock> lock(shard.mutex);
+
+  const Value *value = shard.table.find(key, hash);
+  if (value == nullptr) {
+    return false;
+  }
+
+  reader(*value);
+  return true;
+}
 
-  // .find() returns an iterator to the element, or .end() if not found
-  const auto it = map_.find(key);
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::read_many(
+    const std::vector<Key> &keys,
+    const std::function<void(const std::vector<const Value *> &)> &reader)
+    const {
+  // Hash every key once; note which shards are involved
+  std::vector<std::uint64_t> hashes;
+  hashes.reserve(keys.size());
+  std::array<bool, SHARD_COUNT> involved{};
+  for (const auto &key : keys) {
+    hashes.push_back(hash_of(key));
+    involved[shard_index(hashes.back())] = true;
+  }
+
+  std::vector<std::shared_lock<Lock>> locks;
+  for (std::size_t i = 0; i < SHARD_COUNT; ++i) {
+    if (involved[i]) {
+      locks.emplace_back(shards_[i].mutex);
+    }
+  }
 
-  if (it == map_.end()) {
-    // Key not found → return "empty" optional
-    return std::nullopt;
+  std::vector<const Value *> values;
+  values.reserve(keys.size());
+  for (std::size_t i = 0; i < keys.size() && i < PREFETCH_DISTANCE; ++i) {
+    shard_for(hashes[i]).table.prefetch(keys[i], hashes[i]);
+  }
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    const std::size_t ahead = i + PREFETCH_DISTANCE;
+    if (ahead < keys.size()) {
+      shard_for(hashes[ahead]).table.prefetch(keys[ahead], hashes[ahead]);
+    }
+    values.push_back(shard_for(hashes[i]).table.find(keys[i], hashes[i]));
   }
 
-  // Key found → return the value wrapped in optional
-  // it->second is the value (it->first would be the key)
-  return it->second;
+  reader(values);
 }
 
-template <typename Key, typename Value>
-void ThreadSafeHashMap<Key, Value>::set(const Key &key, const Value &value) {
-  // unique_lock (or lock_guard) = EXCLUSIVE/WRITE lock
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::set(
+    const Key &key, const Value &value) {
+  set(key, hash_of(key), value);
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::set(
+    const Key &key, std::uint64_t hash, const Value &value) {
+  Shard &shard = shard_for(hash);
+
+  // lock_guard = EXCLUSIVE/WRITE lock
   // Only ONE thread can hold this. All readers and writers must wait.
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+  std::lock_guard<Lock> lock(shard.mutex);
 
   // insert_or_assign: if key exists → overwrite; if not → insert
-  // This is cleaner than map_[key] = value because:
-  //   - map_[key] requires Value to be default-constructible
-  //   - insert_or_assign works with any type
-  map_.insert_or_assign(key, value);
+  shard.table.insert_or_assign(key, hash, value);
 }
 
-template <typename Key, typename Value>
-bool ThreadSafeHashMap<Key, Value>::remove(const Key &key) {
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::compute(
+    const Key &key, const std::function<bool(Value &, bool)> &fn) {
+  compute(key, hash_of(key), fn);
+}
 
-  // erase() returns the number of elements removed (0 or 1 for maps)
-  return map_.erase(key) > 0;
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::compute(
+    const Key &key, std::uint64_t hash,
+    const std::function<bool(Value &, bool)> &fn) {
+  Shard &shard = shard_for(hash);
+  std::lock_guard<Lock> lock(shard.mutex);
+  compute_locked(shard, key, hash, fn);
 }
 
-template <typename Key, typename Value>
-std::vector<Key> ThreadSafeHashMap<Key, Value>::keys() const {
-  std::shared_lock<std::shared_mutex> lock(mutex_);
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::compute_many(
+    const std::vector<Key> &keys,
+    const std::function<bool(std::size_t, Value &, bool)> &fn) {
+  std::vector<std::uint64_t> hashes;
+  hashes.reserve(keys.size());
+  std::array<bool, SHARD_COUNT> involved{};
+  for (const auto &key : keys) {
+    hashes.push_back(hash_of(key));
+    involved[shard_index(hashes.back())] = true;
+  }
+
+  std::vector<std::unique_lock<Lock>> locks;
+  for (std::size_t i = 0; i < SHARD_COUNT; ++i) {
+    if (involved[i]) {
+      locks.emplace_back(shards_[i].mutex);
+    }
+  }
+
+  for (std::size_t i = 0; i < keys.size() && i < PREFETCH_DISTANCE; ++i) {
+    shard_for(hashes[i]).table.prefetch(keys[i], hashes[i]);
+  }
+  for (std::size_t i = 0; i < keys.size(); ++i) {
+    const std::size_t ahead = i + PREFETCH_DISTANCE;
+    if (ahead < keys.size()) {
+      shard_for(hashes[ahead]).table.prefetch(keys[ahead], hashes[ahead]);
+    }
+    compute_locked(shard_for(hashes[i]), keys[i], hashes[i],
+                   [&fn, i](Value &value, bool exists) {
+                     return fn(i, value, exists);
+                   });
+  }
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+template <typename F>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::compute_locked(
+    Shard &shard, const Key &key, std::uint64_t hash, F &&fn) {
+  if (Value *existing = shard.table.find(key, hash)) {
+    // Existing entry: mutate it in place, erase it if the callback says so
+    if (!fn(*existing, true)) {
+      shard.table.erase(key, hash);
+    }
+    return;
+  }
+
+  // Missing entry: let the callback fill a fresh value, and only insert it
+  // if the callback wants it to exist. std::move avoids copying it again.
+  Value fresh{};
+  if (fn(fresh, false)) {
+    shard.table.insert_new(key, hash, std::move(fresh));
+  }
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+bool ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::remove(
+    const Key &key) {
+  return remove(key, hash_of(key));
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+bool ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::remove(
+    const Key &key, std::uint64_t hash) {
+  Shard &shard = shard_for(hash);
+  std::lock_guard<Lock> lock(shard.mutex);
+  return shard.table.erase(key, hash);
+}
+
+// Shared locks on every shard, taken in index order
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+typename ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::SharedLocks
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::lock_all_shared()
+    const {
+  SharedLocks locks;
+  locks.reserve(SHARD_COUNT);
+  for (const Shard &shard : shards_) {
+    locks.emplace_back(shard.mutex);
+  }
+  return locks;
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+std::vector<Key>
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::keys() const {
+  const auto locks = lock_all_shared();
 
   std::vector<Key> result;
-  result.reserve(map_.size()); // Pre-allocate to avoid reallocations
+  std::size_t total = 0;
+  for (const Shard &shard : shards_) {
+    total += shard.table.size();
+  }
+  result.reserve(total); // Pre-allocate to avoid reallocations
 
-  for (const auto &[key, value] : map_) {
-    // ^^^^^^^^^^^^^^^^^^^^^^^^
-    // STRUCTURED BINDINGS (C++17)
-    // This unpacks each map entry into "key" and "value" variables.
-    // Before C++17, you'd write: for (const auto& pair : map_) { pair.first; }
-    // Structured bindings are cleaner and more readable.
-    result.push_back(key);
+  for (const Shard &shard : shards_) {
+    shard.table.for_each([&result](const Key &key, const Value & /*value*/) {
+      result.push_back(key);
+    });
   }
 
   return result;
@@ -205,46 +609,98 @@ std::vector<Key> ThreadSafeHashMap<Key, Value>::keys() const {
   // caller's memory — NO copy happens. Modern C++ is smart about this.
 }
 
-template <typename Key, typename Value>
-std::size_t ThreadSafeHashMap<Key, Value>::size() const {
-  std::shared_lock<std::shared_mutex> lock(mutex_);
-  return map_.size();
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+std::size_t
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::size() const {
+  const auto locks = lock_all_shared();
+  std::size_t total = 0;
+  for (const Shard &shard : shards_) {
+    total += shard.table.size();
+  }
+  return total;
+}
+
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::reserve(
+    std::size_t count) {
+  const std::size_t share = (count + SHARD_COUNT - 1) / SHARD_COUNT;
+  for (Shard &shard : shards_) {
+    std::lock_guard<Lock> lock(shard.mutex);
+    shard.table.reserve(share);
+  }
 }
 
-template <typename Key, typename Value>
-void ThreadSafeHashMap<Key, Value>::for_each(
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::for_each(
     const std::function<void(const Key &, const Value &)> &callback) const {
+  const auto locks = lock_all_shared();
+  for_each_locked(locks, callback);
+}
 
-  std::shared_lock<std::shared_mutex> lock(mutex_);
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::for_each_locked(
+    const SharedLocks & /*locks*/,
+    const std::function<void(const Key &, const Value &)> &callback) const {
+  for (const Shard &shard : shards_) {
+    shard.table.for_each(callback);
+  }
+}
 
-  for (const auto &[key, value] : map_) {
-    callback(key, value);
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+void ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::update_each(
+    const std::function<void(const Key &, Value &)> &callback) {
+  for (Shard &shard : shards_) {
+    std::lock_guard<Lock> lock(shard.mutex);
+    shard.table.update_each(callback);
   }
 }
 
-template <typename Key, typename Value>
-std::size_t ThreadSafeHashMap<Key, Value>::remove_if(
-    const std::function<bool(const Key &, const Value &)> &predicate) {
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+typename ThreadSafeHashMap<Key, Value, Storage, Lock,
+                           ShardCount>::RelocateResult
+ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::relocate(
+    std::size_t cursor, std::size_t max_buckets,
+    const std::function<bool(const void *)> &should_move,
+    const std::function<void(Value &)> &relocate_value) {
+  RelocateResult result;
+  const std::size_t index = cursor >> CURSOR_SHARD_SHIFT;
+  const std::size_t position =
+      cursor & ((std::size_t{1} << CURSOR_SHARD_SHIFT) - 1);
+  if (index >= SHARD_COUNT) {
+    return result;
+  }
 
-  // Exclusive lock because we're modifying the map
-  std::lock_guard<std::shared_mutex> lock(mutex_);
+  Shard &shard = shards_[index];
+  std::lock_guard<Lock> lock(shard.mutex);
+  detail::RelocateHooks<Value> hooks{should_move, relocate_value};
+  const std::size_t next = shard.table.relocate(position, max_buckets, hooks);
+  result.visited = hooks.visited;
+  result.moved = hooks.moved;
+
+  if (next != 0) {
+    result.cursor = index << CURSOR_SHARD_SHIFT | next;
+  } else if (index + 1 < SHARD_COUNT) {
+    result.cursor = (index + 1) << CURSOR_SHARD_SHIFT;
+  }
+  return result;
+}
 
+template <typename Key, typename Value, typename Storage, typename Lock,
+          std::size_t ShardCount>
+std::size_t ThreadSafeHashMap<Key, Value, Storage, Lock, ShardCount>::remove_if(
+    const std::function<bool(const Key &, const Value &)> &predicate) {
   std::size_t removed_count = 0;
-
-  // We can't use range-for here because we're erasing during iteration.
-  // Erasing invalidates the iterator, so we use the "erase and advance"
-  // pattern:
-  for (auto it = map_.begin(); it != map_.end(); /* no increment here */) {
-    if (predicate(it->first, it->second)) {
-      // erase() returns an iterator to the NEXT element
-      it = map_.erase(it);
-      ++removed_count;
-    } else {
-      // Only advance if we didn't erase (erase already advances)
-      ++it;
-    }
+  for (Shard &shard : shards_) {
+    // Exclusive lock because we're modifying the map
+    std::lock_guard<Lock> lock(shard.mutex);
+    removed_count += shard.table.erase_if(predicate);
   }
-
   return removed_count;
 }
 
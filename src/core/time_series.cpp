@@ -0,0 +1,661 @@
+// =============================================================================
+// time_series.cpp — Compressed Time-Series Value Type (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/time_series.hpp"
+
+#include <algorithm> // std::upper_bound, std::partition_point, std::min, ...
+#include <cstring>   // std::memcpy
+#include <iterator>  // std::make_move_iterator
+#include <limits>    // std::numeric_limits
+
+namespace mini_redis {
+
+namespace {
+
+// Reject absurd sizes when loading a (possibly corrupted) snapshot: a chunk
+// is closed as soon as it reaches CHUNK_BYTES, so one sample past that
+// (at most ~20 bytes) is the largest a valid chunk can be
+constexpr std::size_t MAX_CHUNK_BYTES = TimeSeries::CHUNK_BYTES + 64;
+
+// Timestamp arithmetic wraps instead of overflowing (undefined for signed
+// integers): the widest delta-of-delta bucket stores all 64 bits, so the
+// wrapped value still decodes back to the exact timestamp
+std::int64_t wrapping_sub(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) -
+                                   static_cast<std::uint64_t>(b));
+}
+
+std::int64_t wrapping_add(std::int64_t a, std::int64_t b) {
+  return static_cast<std::int64_t>(static_cast<std::uint64_t>(a) +
+                                   static_cast<std::uint64_t>(b));
+}
+
+std::uint64_t to_bits(double value) {
+  std::uint64_t bits = 0;
+  std::memcpy(&bits, &value, sizeof bits);
+  return bits;
+}
+
+double from_bits(std::uint64_t bits) {
+  double value = 0;
+  std::memcpy(&value, &bits, sizeof value);
+  return value;
+}
+
+// Does 'value' fit in a 'bits'-wide two's complement field?
+bool fits_signed(std::int64_t value, unsigned bits) {
+  const std::int64_t limit = std::int64_t{1} << (bits - 1);
+  return value >= -limit && value < limit;
+}
+
+std::int64_t sign_extend(std::uint64_t raw, unsigned bits) {
+  const unsigned shift = 64 - bits;
+  return static_cast<std::int64_t>(raw << shift) >> shift;
+}
+
+// =============================================================================
+// Delta-of-delta buckets: prefix → payload width
+// =============================================================================
+//   '0'                 dod == 0
+//   '10'    +  7 bits   [-64, 63]
+//   '110'   +  9 bits   [-256, 255]
+//   '1110'  + 12 bits   [-2048, 2047]
+//   '11110' + 32 bits   anything that fits an int32
+//   '11111' + 64 bits   everything else
+// =============================================================================
+constexpr unsigned DOD_WIDTHS[] = {7, 9, 12, 32, 64};
+
+// ---- BitWriter — Appends bits MSB-first to a chunk's byte vector ----
+class BitWriter {
+public:
+  BitWriter(std::vector<std::uint8_t> &bytes, std::uint64_t &bit_length)
+      : bytes_(bytes), bit_length_(bit_length) {}
+
+  // Write the low 'count' bits of 'value' (1 <= count <= 64)
+  void write(std::uint64_t value, unsigned count) {
+    while (count > 0) {
+      const unsigned used = static_cast<unsigned>(bit_length_ % 8);
+      if (used == 0) {
+        bytes_.push_back(0);
+      }
+      const unsigned take = std::min(8 - used, count);
+      const auto part = static_cast<std::uint8_t>(
+          (value >> (count - take)) & ((1u << take) - 1));
+      bytes_.back() |= static_cast<std::uint8_t>(part << (8 - used - take));
+      count -= take;
+      bit_length_ += take;
+    }
+  }
+
+  void write_bit(bool bit) { write(bit ? 1 : 0, 1); }
+
+private:
+  std::vector<std::uint8_t> &bytes_;
+  std::uint64_t &bit_length_;
+};
+
+// ---- Bucket aggregation: one accumulator per output sample ----
+struct Accumulator {
+  std::size_t count = 0;
+  double sum = 0;
+  double min = 0;
+  double max = 0;
+  double first = 0;
+  double last = 0;
+
+  void add(double value) {
+    if (count == 0) {
+      min = max = first = value;
+    } else {
+      min = std::min(min, value);
+      max = std::max(max, value);
+    }
+    sum += value;
+    last = value;
+    ++count;
+  }
+
+  double result(TimeSeries::Aggregation aggregation) const {
+    switch (aggregation) {
+    case TimeSeries::Aggregation::AVG:
+      return sum / static_cast<double>(count);
+    case TimeSeries::Aggregation::SUM:
+      return sum;
+    case TimeSeries::Aggregation::MIN:
+      return min;
+    case TimeSeries::Aggregation::MAX:
+      return max;
+    case TimeSeries::Aggregation::COUNT:
+      return static_cast<double>(count);
+    case TimeSeries::Aggregation::FIRST:
+      return first;
+    case TimeSeries::Aggregation::LAST:
+    case TimeSeries::Aggregation::NONE:
+      break;
+    }
+    return last;
+  }
+};
+
+// Start of the bucket holding 'timestamp' (floor, also for negatives)
+std::int64_t bucket_start(std::int64_t timestamp, std::int64_t bucket_ms) {
+  std::int64_t offset = timestamp % bucket_ms;
+  if (offset < 0) {
+    offset += bucket_ms;
+  }
+  return timestamp - offset;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// ChunkReader — Decodes one chunk, sample by sample
+// =============================================================================
+// Mirrors append() exactly. Every read is bounds-checked against the
+// chunk's bit length, so a corrupted snapshot fails cleanly instead of
+// reading past the buffer. After the last sample, state() is exactly what
+// append() would have left behind — deserialize() uses that to resume.
+// =============================================================================
+class TimeSeries::ChunkReader {
+public:
+  explicit ChunkReader(const Chunk &chunk)
+      : chunk_(chunk), data_(chunk.bytes.data()), size_(chunk.bytes.size()),
+        bit_length_(chunk.bit_length) {}
+
+  // Decode the next sample. False at the end of the chunk or on bad data.
+  bool next(Sample &sample) {
+    if (decoded_ == chunk_.count) {
+      return false;
+    }
+    if (decoded_ == 0) {
+      std::uint64_t bits = 0;
+      if (!read(bits, 64)) {
+        return false;
+      }
+      state_.timestamp = chunk_.first_timestamp;
+      state_.value_bits = bits;
+    } else if (!read_timestamp() || !read_value()) {
+      return false;
+    }
+    ++decoded_;
+    sample = Sample{state_.timestamp, from_bits(state_.value_bits)};
+    return true;
+  }
+
+  const CodecState &state() const { return state_; }
+  std::uint32_t decoded() const { return decoded_; }
+
+private:
+  // ---- Bit buffer: the next bits live left-aligned in a register ----
+  // Consuming bits is a shift; memory is touched only when fewer than 57
+  // bits remain buffered (one unaligned 8-byte load every ~7 bytes).
+  // Decoding is a serial chain — every field's position depends on the
+  // previous one — so keeping that chain out of memory is what counts.
+  std::uint64_t peek() {
+    if (buffered_ < 57) {
+      const std::size_t index = position_ / 8;
+      std::uint64_t word = 0;
+      if (index + 8 <= size_) {
+        std::memcpy(&word, data_ + index, sizeof word);
+        word = __builtin_bswap64(word); // the stream is MSB-first
+      } else {
+        for (std::size_t i = index; i < size_; ++i) {
+          word |= std::uint64_t{data_[i]} << (56 - 8 * (i - index));
+        }
+      }
+      buffer_ = word << (position_ % 8);
+      buffered_ = 64 - static_cast<unsigned>(position_ % 8);
+    }
+    return buffer_;
+  }
+
+  // Consume 'count' (<= 56) bits that peek() has already buffered
+  void skip(unsigned count) {
+    buffer_ <<= count;
+    buffered_ -= count;
+    position_ += count;
+  }
+
+  bool read(std::uint64_t &out, unsigned count) {
+    if (bit_length_ - position_ < count) {
+      return false;
+    }
+    if (count > 56) { // more than one peek() is guaranteed to hold
+      out = peek() >> 32;
+      skip(32);
+      out = (out << (count - 32)) | (peek() >> (96 - count));
+      skip(count - 32);
+      return true;
+    }
+    out = peek() >> (64 - count);
+    skip(count);
+    return true;
+  }
+
+  bool read_timestamp() {
+    // The prefix is a run of up to five 1-bits, ended by a 0 if shorter
+    const unsigned ones = std::min(__builtin_clzll(~peek() | 1), 5);
+    const unsigned prefix = ones < 5 ? ones + 1 : 5;
+    if (bit_length_ - position_ < prefix) {
+      return false;
+    }
+    skip(prefix);
+
+    std::int64_t dod = 0;
+    if (ones > 0) {
+      const unsigned width = DOD_WIDTHS[ones - 1];
+      std::uint64_t raw = 0;
+      if (!read(raw, width)) {
+        return false;
+      }
+      dod = sign_extend(raw, width);
+    }
+    state_.delta = wrapping_add(state_.delta, dod);
+    state_.timestamp = wrapping_add(state_.timestamp, state_.delta);
+    return true;
+  }
+
+  bool read_value() {
+    // All control bits ('0', '10', or '11' + 5 + 6) come from one peek()
+    const std::uint64_t word = peek();
+    const std::uint64_t available = bit_length_ - position_;
+    if (available < 1) {
+      return false;
+    }
+    if ((word >> 63) == 0) {
+      skip(1);
+      return true; // same value as before
+    }
+    if (available < 2) {
+      return false;
+    }
+    if (((word >> 62) & 1) == 1) {
+      const auto leading = static_cast<unsigned>((word >> 57) & 0x1f);
+      const auto length = static_cast<unsigned>((word >> 51) & 0x3f) + 1;
+      if (available < 13 || leading + length > 64) {
+        return false;
+      }
+      skip(13);
+      state_.leading = static_cast<std::uint8_t>(leading);
+      state_.trailing = static_cast<std::uint8_t>(64 - leading - length);
+      state_.has_window = true;
+    } else if (!state_.has_window) {
+      return false; // "reuse the window" before any window exists
+    } else {
+      skip(2);
+    }
+    const unsigned meaningful = 64u - state_.leading - state_.trailing;
+    std::uint64_t xored = 0;
+    if (!read(xored, meaningful)) {
+      return false;
+    }
+    state_.value_bits ^= xored << state_.trailing;
+    return true;
+  }
+
+  // The chunk's fields, copied once: the decode loop then never has to
+  // reload them through the reference after a byte-sized store
+  const Chunk &chunk_;
+  const std::uint8_t *data_;
+  std::size_t size_;
+  std::uint64_t bit_length_;
+  std::uint64_t position_ = 0; // bits consumed
+  std::uint64_t buffer_ = 0;
+  unsigned buffered_ = 0;
+  std::uint32_t decoded_ = 0;
+  CodecState state_;
+};
+
+TimeSeries::TimeSeries(std::int64_t retention_ms)
+    : retention_ms_(std::max<std::int64_t>(retention_ms, 0)) {}
+
+// =============================================================================
+// append() — Gorilla-encode one sample at the end of a chunk
+// =============================================================================
+// The caller guarantees sample.timestamp > the chunk's last timestamp.
+// =============================================================================
+void TimeSeries::append(Chunk &chunk, Sample sample) {
+  BitWriter writer(chunk.bytes, chunk.bit_length);
+  CodecState &state = chunk.tail;
+  const std::uint64_t bits = to_bits(sample.value);
+
+  if (chunk.count == 0) {
+    // The first timestamp lives in the chunk header; the value goes raw
+    chunk.first_timestamp = sample.timestamp;
+    writer.write(bits, 64);
+    state = CodecState{};
+    state.timestamp = sample.timestamp;
+    state.value_bits = bits;
+    ++chunk.count;
+    return;
+  }
+
+  // ---- Timestamp: delta of deltas ----
+  const std::int64_t delta = wrapping_sub(sample.timestamp, state.timestamp);
+  const std::int64_t dod = wrapping_sub(delta, state.delta);
+  if (dod == 0) {
+    writer.write_bit(false);
+  } else {
+    unsigned bucket = 0;
+    while (bucket + 1 < std::size(DOD_WIDTHS) &&
+           !fits_signed(dod, DOD_WIDTHS[bucket])) {
+      ++bucket;
+    }
+    // Prefix: (bucket + 1) ones, then a zero — except the last bucket,
+    // whose five ones need no terminator
+    const unsigned ones = bucket + 1;
+    if (ones < 5) {
+      writer.write(((std::uint64_t{1} << ones) - 1) << 1, ones + 1);
+    } else {
+      writer.write(0x1f, 5);
+    }
+    const unsigned width = DOD_WIDTHS[bucket];
+    const std::uint64_t mask =
+        width == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << width) - 1;
+    writer.write(static_cast<std::uint64_t>(dod) & mask, width);
+  }
+
+  // ---- Value: XOR with the previous one ----
+  const std::uint64_t xored = bits ^ state.value_bits;
+  if (xored == 0) {
+    writer.write_bit(false);
+  } else {
+    // Leading zeros are capped at 31 so they fit the 5-bit field
+    const auto leading =
+        static_cast<std::uint8_t>(std::min(__builtin_clzll(xored), 31));
+    const auto trailing = static_cast<std::uint8_t>(__builtin_ctzll(xored));
+
+    if (state.has_window && leading >= state.leading &&
+        trailing >= state.trailing) {
+      // Fits the previous window: no need to describe it again
+      writer.write(0b10, 2);
+    } else {
+      const unsigned length = 64u - leading - trailing;
+      writer.write(0b11, 2);
+      writer.write(leading, 5);
+      writer.write(length - 1, 6); // 1..64 stored as 0..63
+      state.leading = leading;
+      state.trailing = trailing;
+      state.has_window = true;
+    }
+    const unsigned meaningful = 64u - state.leading - state.trailing;
+    writer.write(xored >> state.trailing, meaningful);
+  }
+
+  state.timestamp = sample.timestamp;
+  state.delta = delta;
+  state.value_bits = bits;
+  ++chunk.count;
+}
+
+std::vector<TimeSeries::Sample> TimeSeries::decode(const Chunk &chunk) {
+  std::vector<Sample> samples;
+  samples.reserve(chunk.count);
+  ChunkReader reader(chunk);
+  Sample sample{};
+  while (reader.next(sample)) {
+    samples.push_back(sample);
+  }
+  return samples;
+}
+
+std::vector<TimeSeries::Chunk>
+TimeSeries::encode(const std::vector<Sample> &samples) {
+  std::vector<Chunk> chunks;
+  for (const Sample &sample : samples) {
+    if (chunks.empty() || chunks.back().full()) {
+      chunks.emplace_back();
+    }
+    append(chunks.back(), sample);
+  }
+  return chunks;
+}
+
+void TimeSeries::replace_chunk(std::size_t index,
+                               const std::vector<Sample> &samples) {
+  size_ -= chunks_[index].count;
+  size_ += samples.size();
+
+  auto rebuilt = encode(samples);
+  const auto position = chunks_.erase(chunks_.begin() + index);
+  chunks_.insert(position, std::make_move_iterator(rebuilt.begin()),
+                 std::make_move_iterator(rebuilt.end()));
+}
+
+// =============================================================================
+// add()
+// =============================================================================
+bool TimeSeries::add(std::int64_t timestamp, double value) {
+  // Fast path: newer than everything → append to the newest chunk
+  if (chunks_.empty() || timestamp > chunks_.back().last_timestamp()) {
+    if (chunks_.empty() || chunks_.back().full()) {
+      chunks_.emplace_back();
+    }
+    append(chunks_.back(), Sample{timestamp, value});
+    ++size_;
+    return true;
+  }
+
+  // Slow path: patch the chunk whose range covers the timestamp (the last
+  // chunk starting at or before it; the first chunk for anything older)
+  const auto after = std::upper_bound(
+      chunks_.begin(), chunks_.end(), timestamp,
+      [](std::int64_t ts, const Chunk &chunk) {
+        return ts < chunk.first_timestamp;
+      });
+  const std::size_t index =
+      after == chunks_.begin()
+          ? 0
+          : static_cast<std::size_t>(after - chunks_.begin()) - 1;
+
+  auto samples = decode(chunks_[index]);
+  const auto it = std::lower_bound(
+      samples.begin(), samples.end(), timestamp,
+      [](const Sample &sample, std::int64_t ts) { return sample.timestamp < ts; });
+  const bool is_new = it == samples.end() || it->timestamp != timestamp;
+  if (is_new) {
+    samples.insert(it, Sample{timestamp, value});
+  } else {
+    it->value = value;
+  }
+  replace_chunk(index, samples);
+  return is_new;
+}
+
+// =============================================================================
+// range() — Skip chunks by their bounds, stream-decode the rest
+// =============================================================================
+std::vector<TimeSeries::Sample> TimeSeries::range(std::int64_t from,
+                                                  std::int64_t to,
+                                                  Aggregation aggregation,
+                                                  std::int64_t bucket_ms) const {
+  std::vector<Sample> out;
+  if (from > to) {
+    return out;
+  }
+  const bool aggregate = aggregation != Aggregation::NONE && bucket_ms > 0;
+
+  Accumulator bucket;
+  std::int64_t current_bucket = 0;
+
+  // Chunks are sorted and disjoint: binary-search the first candidate
+  auto first = std::partition_point(
+      chunks_.begin(), chunks_.end(),
+      [from](const Chunk &chunk) { return chunk.last_timestamp() < from; });
+
+  for (auto chunk_it = first; chunk_it != chunks_.end(); ++chunk_it) {
+    const Chunk &chunk = *chunk_it;
+    if (chunk.first_timestamp > to) {
+      break;
+    }
+
+    ChunkReader reader(chunk);
+    Sample sample{};
+    while (reader.next(sample)) {
+      if (sample.timestamp < from) {
+        continue;
+      }
+      if (sample.timestamp > to) {
+        break;
+      }
+      if (!aggregate) {
+        out.push_back(sample);
+        continue;
+      }
+      // Only a sample past the current bucket pays for the division.
+      // Samples ascend, so the unsigned distance is exact (no overflow).
+      const std::uint64_t into_bucket =
+          static_cast<std::uint64_t>(sample.timestamp) -
+          static_cast<std::uint64_t>(current_bucket);
+      if (bucket.count == 0 ||
+          into_bucket >= static_cast<std::uint64_t>(bucket_ms)) {
+        if (bucket.count > 0) {
+          out.push_back(Sample{current_bucket, bucket.result(aggregation)});
+          bucket = Accumulator{};
+        }
+        current_bucket = bucket_start(sample.timestamp, bucket_ms);
+      }
+      bucket.add(sample.value);
+    }
+  }
+
+  if (aggregate && bucket.count > 0) {
+    out.push_back(Sample{current_bucket, bucket.result(aggregation)});
+  }
+  return out;
+}
+
+std::optional<TimeSeries::Sample> TimeSeries::last() const {
+  if (chunks_.empty()) {
+    return std::nullopt;
+  }
+  const CodecState &tail = chunks_.back().tail;
+  return Sample{tail.timestamp, from_bits(tail.value_bits)};
+}
+
+// =============================================================================
+// trim() — Whole chunks first, then the one chunk straddling the cutoff
+// =============================================================================
+std::size_t TimeSeries::trim(std::int64_t cutoff) {
+  const std::size_t before = size_;
+  while (!chunks_.empty() && chunks_.front().last_timestamp() < cutoff) {
+    size_ -= chunks_.front().count;
+    chunks_.pop_front();
+  }
+
+  if (!chunks_.empty() && chunks_.front().first_timestamp < cutoff) {
+    auto samples = decode(chunks_.front());
+    const auto keep = std::lower_bound(
+        samples.begin(), samples.end(), cutoff,
+        [](const Sample &sample, std::int64_t ts) {
+          return sample.timestamp < ts;
+        });
+    samples.erase(samples.begin(), keep);
+    replace_chunk(0, samples);
+  }
+  return before - size_;
+}
+
+std::int64_t TimeSeries::retention_cutoff(std::int64_t now_ms) const {
+  std::int64_t cutoff = 0;
+  if (retention_ms_ <= 0 ||
+      __builtin_sub_overflow(now_ms, retention_ms_, &cutoff)) {
+    return std::numeric_limits<std::int64_t>::min();
+  }
+  return cutoff;
+}
+
+std::size_t TimeSeries::trim_retention(std::int64_t now_ms) {
+  if (retention_ms_ <= 0) {
+    return 0;
+  }
+  return trim(retention_cutoff(now_ms));
+}
+
+std::int64_t TimeSeries::retention_ms() const { return retention_ms_; }
+
+void TimeSeries::set_retention_ms(std::int64_t retention_ms) {
+  retention_ms_ = std::max<std::int64_t>(retention_ms, 0);
+}
+
+std::size_t TimeSeries::size() const { return size_; }
+
+bool TimeSeries::empty() const { return size_ == 0; }
+
+std::size_t TimeSeries::chunk_count() const { return chunks_.size(); }
+
+std::size_t TimeSeries::memory_bytes() const {
+  std::size_t bytes = 0;
+  for (const Chunk &chunk : chunks_) {
+    bytes += chunk.bytes.size();
+  }
+  return bytes;
+}
+
+// =============================================================================
+// Snapshot encoding
+// =============================================================================
+//   u64 retention_ms | u64 chunk count
+//   per chunk: u64 first timestamp | u32 samples | u64 bit length | bytes
+// The encoder state is NOT stored: decoding each chunk validates it and
+// leaves exactly the state append() needs to continue.
+// =============================================================================
+void TimeSeries::serialize(std::string &out) const {
+  put_u64(out, static_cast<std::uint64_t>(retention_ms_));
+  put_u64(out, chunks_.size());
+  for (const Chunk &chunk : chunks_) {
+    put_u64(out, static_cast<std::uint64_t>(chunk.first_timestamp));
+    put_u32(out, chunk.count);
+    put_u64(out, chunk.bit_length);
+    put_bytes(out, std::string_view(
+                       reinterpret_cast<const char *>(chunk.bytes.data()),
+                       chunk.bytes.size()));
+  }
+}
+
+std::optional<TimeSeries> TimeSeries::deserialize(ByteReader &in) {
+  std::uint64_t retention = 0;
+  std::uint64_t chunk_count = 0;
+  if (!in.get_u64(retention) || !in.get_u64(chunk_count)) {
+    return std::nullopt;
+  }
+
+  TimeSeries series(static_cast<std::int64_t>(retention));
+  std::string bytes;
+  for (std::uint64_t n = 0; n < chunk_count; ++n) {
+    Chunk chunk;
+    std::uint64_t first = 0;
+    if (!in.get_u64(first) || !in.get_u32(chunk.count) ||
+        !in.get_u64(chunk.bit_length) || !in.get_bytes(bytes) ||
+        chunk.count == 0 || bytes.size() > MAX_CHUNK_BYTES ||
+        chunk.bit_length > bytes.size() * 8) {
+      return std::nullopt;
+    }
+    chunk.first_timestamp = static_cast<std::int64_t>(first);
+    chunk.bytes.assign(bytes.begin(), bytes.end());
+
+    // Samples must be strictly ascending, within and across chunks
+    ChunkReader reader(chunk);
+    Sample sample{};
+    std::optional<std::int64_t> previous;
+    if (!series.chunks_.empty()) {
+      previous = series.chunks_.back().last_timestamp();
+    }
+    while (reader.next(sample)) {
+      if (previous.has_value() && sample.timestamp <= *previous) {
+        return std::nullopt;
+      }
+      previous = sample.timestamp;
+    }
+    if (reader.decoded() != chunk.count) {
+      return std::nullopt;
+    }
+    chunk.tail = reader.state();
+    series.size_ += chunk.count;
+    series.chunks_.push_back(std::move(chunk));
+  }
+  return series;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,148 @@
+// =============================================================================
+// time_series.hpp — Compressed Time-Series Value Type (HEADER)
+// =============================================================================
+//
+// A TIME SERIES is a list of (timestamp, value) SAMPLES in time order: CPU
+// load every second, request latency every minute. Storing each sample as
+// its own key with a TTL costs ~100 bytes (key string, hash node, entry,
+// expiry). Here one key holds the whole series, and a typical sample
+// shrinks to 1–3 BYTES.
+//
+// GORILLA COMPRESSION (Facebook's in-memory TSDB, 2015):
+// Real metrics are boringly regular, and we exploit both regularities.
+//
+//   TIMESTAMPS — samples arrive at a near-fixed interval, so the DELTA
+//   between timestamps barely changes and the DELTA OF DELTAS is usually 0:
+//     timestamps   1000  2000  3000  4001  5001
+//     deltas             1000  1000  1001  1000
+//     delta-of-delta        0     0     1    -1
+//   A zero costs ONE bit; small values cost 9–16 bits with a short prefix.
+//
+//   VALUES — consecutive readings are close, so their IEEE-754 bit patterns
+//   share the sign, the exponent and the top of the mantissa. XOR with the
+//   previous value leaves only a few "meaningful" bits in the middle:
+//     identical value  → '0'                       (1 bit)
+//     bits fit in the previous window → '10' + the meaningful bits
+//     otherwise        → '11' + 5-bit leading zeros + 6-bit length + bits
+//
+// CHUNKS:
+// Samples are packed into CHUNKS of ~4 KB (like RedisTimeSeries). Every
+// chunk remembers its first and last timestamp, so a range query skips
+// whole chunks without decoding them, and retention drops whole chunks
+// from the front. Only the chunk that straddles a boundary is decoded.
+//
+// Out-of-order samples and re-writes of an existing timestamp are allowed:
+// the one affected chunk is decoded, patched and re-encoded.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mini_redis {
+
+class TimeSeries {
+public:
+  struct Sample {
+    std::int64_t timestamp; // milliseconds (Unix epoch by convention)
+    double value;
+  };
+
+  // How range() folds the samples of one bucket into one (TS.RANGE
+  // AGGREGATION). NONE returns the raw samples.
+  enum class Aggregation { NONE, AVG, SUM, MIN, MAX, COUNT, FIRST, LAST };
+
+  // Chunks are closed once their encoded bits reach this size
+  static constexpr std::size_t CHUNK_BYTES = 4096;
+
+  // retention_ms: samples older than (now - retention) are trimmed by
+  // trim_retention(); 0 keeps everything forever
+  explicit TimeSeries(std::int64_t retention_ms = 0);
+
+  // ---- add() — Insert a sample; true if NEW, false if it replaced the ----
+  // value already stored at that exact timestamp (ON_DUPLICATE LAST).
+  // Appending in time order is the O(1) fast path.
+  bool add(std::int64_t timestamp, double value);
+
+  // ---- range() — Samples with from <= timestamp <= to (TS.RANGE) ----
+  // With an aggregation, samples are grouped into buckets of bucket_ms
+  // aligned to multiples of bucket_ms (0, bucket_ms, 2*bucket_ms, ...)
+  // and each non-empty bucket yields one sample stamped with its start.
+  std::vector<Sample> range(std::int64_t from, std::int64_t to,
+                            Aggregation aggregation = Aggregation::NONE,
+                            std::int64_t bucket_ms = 0) const;
+
+  // ---- last() — The newest sample (TS.GET) ----
+  std::optional<Sample> last() const;
+
+  // ---- trim() — Drop every sample older than 'cutoff'; returns how many ----
+  std::size_t trim(std::int64_t cutoff);
+
+  // ---- retention_cutoff() — Oldest timestamp retention keeps at now_ms ----
+  // INT64_MIN when there is no retention (nothing is ever too old).
+  std::int64_t retention_cutoff(std::int64_t now_ms) const;
+
+  // ---- trim_retention() — trim(retention_cutoff(now_ms)) ----
+  std::size_t trim_retention(std::int64_t now_ms);
+
+  std::int64_t retention_ms() const;
+  void set_retention_ms(std::int64_t retention_ms);
+
+  std::size_t size() const;
+  bool empty() const;
+  std::size_t chunk_count() const;
+
+  // Bytes of encoded sample data (excluding per-chunk bookkeeping)
+  std::size_t memory_bytes() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  void serialize(std::string &out) const;
+  static std::optional<TimeSeries> deserialize(ByteReader &in);
+
+private:
+  // What the encoder needs to append the NEXT sample: the previous
+  // timestamp, delta and value bits, and the current XOR window
+  struct CodecState {
+    std::int64_t timestamp = 0;
+    std::int64_t delta = 0;
+    std::uint64_t value_bits = 0;
+    std::uint8_t leading = 0;  // leading zeros of the window
+    std::uint8_t trailing = 0; // trailing zeros of the window
+    bool has_window = false;
+  };
+
+  struct Chunk {
+    std::vector<std::uint8_t> bytes; // the bit stream, MSB first
+    std::uint64_t bit_length = 0;
+    std::uint32_t count = 0;
+    std::int64_t first_timestamp = 0;
+    CodecState tail; // state after the last sample
+
+    std::int64_t last_timestamp() const { return tail.timestamp; }
+    bool full() const { return bytes.size() >= CHUNK_BYTES; }
+  };
+
+  class ChunkReader; // decodes one chunk sample by sample (in the .cpp)
+
+  static void append(Chunk &chunk, Sample sample);
+  static std::vector<Sample> decode(const Chunk &chunk);
+
+  // Re-encode sorted samples into as many chunks as they need
+  static std::vector<Chunk> encode(const std::vector<Sample> &samples);
+
+  // Replace chunks_[index] with the re-encoded 'samples' (may be none)
+  void replace_chunk(std::size_t index, const std::vector<Sample> &samples);
+
+  std::int64_t retention_ms_;
+  std::size_t size_ = 0;
+  std::deque<Chunk> chunks_; // ascending, non-overlapping time ranges
+};
+
+} // namespace mini_redis
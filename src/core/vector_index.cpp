@@ -0,0 +1,839 @@
+// =============================================================================
+// vector_index.cpp — Nearest-Neighbour Vector Index (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/vector_index.hpp"
+#include "core/vector_ops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring> // std::memcpy
+#include <limits>
+#include <queue>
+
+namespace mini_redis {
+
+namespace {
+
+constexpr float INF = std::numeric_limits<float>::infinity();
+
+// Default candidate list size for queries (raised to k if k is larger)
+constexpr std::size_t DEFAULT_EF_SEARCH = 100;
+
+void put_f32(std::string &out, float value) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u32(out, bits);
+}
+
+bool get_f32(ByteReader &in, float &value) {
+  std::uint32_t bits = 0;
+  if (!in.get_u32(bits)) {
+    return false;
+  }
+  std::memcpy(&value, &bits, sizeof(value));
+  return std::isfinite(value);
+}
+
+// =============================================================================
+// VisitedMarks — "have I already looked at node n during THIS search?"
+// =============================================================================
+// A fresh std::vector<bool> per search would cost a million-entry clear
+// per query. Instead each search bumps an EPOCH number, and a node counts
+// as visited iff its mark equals the current epoch — clearing is free.
+// The marks are thread_local: searches run under a SHARED lock, so several
+// threads may search the same index at once.
+// =============================================================================
+class VisitedMarks {
+public:
+  void begin(std::size_t nodes) {
+    if (marks_.size() < nodes) {
+      marks_.resize(nodes, 0);
+    }
+    if (++epoch_ == 0) { // wrapped: old marks could look current
+      std::fill(marks_.begin(), marks_.end(), 0);
+      epoch_ = 1;
+    }
+  }
+
+  // Marks 'node' visited; returns whether it already was
+  bool test_and_set(std::uint32_t node) {
+    const bool seen = marks_[node] == epoch_;
+    marks_[node] = epoch_;
+    return seen;
+  }
+
+private:
+  std::vector<std::uint16_t> marks_;
+  std::uint16_t epoch_ = 0;
+};
+
+VisitedMarks &visited_marks() {
+  thread_local VisitedMarks marks;
+  return marks;
+}
+
+} // anonymous namespace
+
+VectorIndex::VectorIndex() : VectorIndex(Options{}) {}
+
+VectorIndex::VectorIndex(const Options &options) : options_(options) {}
+
+// =============================================================================
+// Vector preparation and distances
+// =============================================================================
+bool VectorIndex::valid(const std::vector<float> &vector) const {
+  if (vector.empty() || vector.size() > MAX_DIM ||
+      (options_.dim != 0 && vector.size() != options_.dim)) {
+    return false;
+  }
+  bool any_nonzero = false;
+  for (const float value : vector) {
+    if (!std::isfinite(value)) {
+      return false;
+    }
+    any_nonzero = any_nonzero || value != 0.0f;
+  }
+  return any_nonzero || options_.metric != Metric::COSINE;
+}
+
+VectorIndex::Query
+VectorIndex::prepare(const std::vector<float> &vector) const {
+  Query query;
+  query.floats = vector;
+
+  if (options_.metric == Metric::COSINE) {
+    double norm_sq = 0.0;
+    for (const float value : query.floats) {
+      norm_sq += static_cast<double>(value) * value;
+    }
+    const double inverse = norm_sq > 0.0 ? 1.0 / std::sqrt(norm_sq) : 0.0;
+    for (float &value : query.floats) {
+      value = static_cast<float>(value * inverse);
+    }
+  }
+
+  if (options_.quantization == Quantization::FLOAT32) {
+    query.view.floats = query.floats.data();
+    return query;
+  }
+
+  // INT8: symmetric scaling so the largest |component| maps to ±127
+  float max_abs = 0.0f;
+  for (const float value : query.floats) {
+    max_abs = std::max(max_abs, std::fabs(value));
+  }
+  const float scale = max_abs / 127.0f;
+  query.codes.resize(query.floats.size());
+  std::int64_t code_norm_sq = 0;
+  for (std::size_t i = 0; i < query.floats.size(); ++i) {
+    const long code =
+        scale > 0.0f ? std::lround(query.floats[i] / scale) : 0;
+    query.codes[i] = static_cast<std::int8_t>(std::clamp(code, -127L, 127L));
+    code_norm_sq += static_cast<std::int64_t>(query.codes[i]) * query.codes[i];
+  }
+  query.floats.clear();
+  query.view.codes = query.codes.data();
+  query.view.scale = scale;
+  query.view.norm_sq = scale * scale * static_cast<float>(code_norm_sq);
+  return query;
+}
+
+VectorIndex::View VectorIndex::view_of(std::uint32_t slot) const {
+  View view;
+  const std::size_t offset = static_cast<std::size_t>(slot) * options_.dim;
+  if (options_.quantization == Quantization::FLOAT32) {
+    view.floats = floats_.data() + offset;
+  } else {
+    view.codes = codes_.data() + offset;
+    view.scale = scales_[slot];
+    view.norm_sq = norms_sq_[slot];
+  }
+  return view;
+}
+
+// Internally: COSINE → 1 - dot (vectors are unit length), L2 → SQUARED
+// distance (same order as the real one, without a sqrt per comparison)
+float VectorIndex::distance(const View &a, const View &b) const {
+  const std::size_t dim = options_.dim;
+  if (options_.quantization == Quantization::FLOAT32) {
+    return options_.metric == Metric::COSINE
+               ? 1.0f - dot_f32(a.floats, b.floats, dim)
+               : l2_sq_f32(a.floats, b.floats, dim);
+  }
+  const float dot =
+      a.scale * b.scale * static_cast<float>(dot_i8(a.codes, b.codes, dim));
+  return options_.metric == Metric::COSINE
+             ? 1.0f - dot
+             : std::max(0.0f, a.norm_sq + b.norm_sq - 2.0f * dot);
+}
+
+float VectorIndex::reported_distance(float internal) const {
+  return options_.metric == Metric::L2 ? std::sqrt(internal) : internal;
+}
+
+// =============================================================================
+// Slots
+// =============================================================================
+std::uint32_t VectorIndex::append_slot(const std::string &name,
+                                       const Query &query) {
+  const auto slot = static_cast<std::uint32_t>(names_.size());
+  names_.push_back(name);
+  if (options_.quantization == Quantization::FLOAT32) {
+    floats_.insert(floats_.end(), query.floats.begin(), query.floats.end());
+  } else {
+    codes_.insert(codes_.end(), query.codes.begin(), query.codes.end());
+    scales_.push_back(query.view.scale);
+    norms_sq_.push_back(query.view.norm_sq);
+  }
+  dead_.push_back(0);
+  slot_of_[name] = slot;
+
+  if (has_graph_) {
+    level0_.resize(level0_.size() + 1 + max_links(0), 0);
+    upper_.emplace_back();
+    levels_.push_back(0);
+  }
+  return slot;
+}
+
+// Without a graph, slot numbers mean nothing: fill the hole with the last
+// slot and shrink — O(dim), no tombstone
+void VectorIndex::remove_slot_flat(std::uint32_t slot) {
+  const std::uint32_t last = static_cast<std::uint32_t>(names_.size() - 1);
+  const std::size_t dim = options_.dim;
+  if (slot != last) {
+    names_[slot] = std::move(names_[last]);
+    slot_of_[names_[slot]] = slot;
+    if (options_.quantization == Quantization::FLOAT32) {
+      std::copy_n(floats_.begin() + last * dim, dim,
+                  floats_.begin() + slot * dim);
+    } else {
+      std::copy_n(codes_.begin() + last * dim, dim,
+                  codes_.begin() + slot * dim);
+      scales_[slot] = scales_[last];
+      norms_sq_[slot] = norms_sq_[last];
+    }
+  }
+  names_.pop_back();
+  dead_.pop_back();
+  if (options_.quantization == Quantization::FLOAT32) {
+    floats_.resize(floats_.size() - dim);
+  } else {
+    codes_.resize(codes_.size() - dim);
+    scales_.pop_back();
+    norms_sq_.pop_back();
+  }
+}
+
+// Squeeze out tombstones, then rebuild the graph over the survivors. The
+// stored data moves as-is: re-adding dequantized vectors would re-round them.
+void VectorIndex::compact() {
+  const std::size_t dim = options_.dim;
+  std::uint32_t kept = 0;
+  for (std::uint32_t slot = 0; slot < names_.size(); ++slot) {
+    if (dead_[slot] != 0) {
+      continue;
+    }
+    if (kept != slot) {
+      names_[kept] = std::move(names_[slot]);
+      slot_of_[names_[kept]] = kept;
+      if (options_.quantization == Quantization::FLOAT32) {
+        std::copy_n(floats_.begin() + slot * dim, dim,
+                    floats_.begin() + kept * dim);
+      } else {
+        std::copy_n(codes_.begin() + slot * dim, dim,
+                    codes_.begin() + kept * dim);
+        scales_[kept] = scales_[slot];
+        norms_sq_[kept] = norms_sq_[slot];
+      }
+    }
+    ++kept;
+  }
+
+  names_.resize(kept);
+  dead_.assign(kept, 0);
+  tombstones_ = 0;
+  if (options_.quantization == Quantization::FLOAT32) {
+    floats_.resize(kept * dim);
+    floats_.shrink_to_fit();
+  } else {
+    codes_.resize(kept * dim);
+    codes_.shrink_to_fit();
+    scales_.resize(kept);
+    norms_sq_.resize(kept);
+  }
+  build_graph();
+}
+
+// =============================================================================
+// add() / remove() / get()
+// =============================================================================
+bool VectorIndex::add(const std::string &name,
+                      const std::vector<float> &vector) {
+  if (options_.dim == 0) {
+    options_.dim = static_cast<std::uint32_t>(vector.size());
+  }
+  const bool is_new = !remove(name);
+
+  const std::uint32_t slot = append_slot(name, prepare(vector));
+  if (has_graph_) {
+    insert_into_graph(slot);
+  } else if (options_.algorithm == Algorithm::HNSW ||
+             (options_.algorithm == Algorithm::AUTO &&
+              size() >= HNSW_THRESHOLD)) {
+    build_graph();
+  }
+  return is_new;
+}
+
+bool VectorIndex::remove(const std::string &name) {
+  const auto it = slot_of_.find(name);
+  if (it == slot_of_.end()) {
+    return false;
+  }
+  const std::uint32_t slot = it->second;
+  slot_of_.erase(it);
+
+  if (!has_graph_) {
+    remove_slot_flat(slot);
+    return true;
+  }
+
+  dead_[slot] = 1;
+  names_[slot] = std::string();
+  ++tombstones_;
+  if (tombstones_ > size()) {
+    compact();
+  }
+  return true;
+}
+
+std::optional<std::vector<float>>
+VectorIndex::get(const std::string &name) const {
+  const auto it = slot_of_.find(name);
+  if (it == slot_of_.end()) {
+    return std::nullopt;
+  }
+  const View view = view_of(it->second);
+  std::vector<float> vector(options_.dim);
+  for (std::size_t i = 0; i < vector.size(); ++i) {
+    vector[i] = view.floats != nullptr ? view.floats[i]
+                                       : static_cast<float>(view.codes[i]) *
+                                             view.scale;
+  }
+  return vector;
+}
+
+// =============================================================================
+// HNSW — layout and levels
+// =============================================================================
+std::uint32_t VectorIndex::max_links(unsigned level) const {
+  return level == 0 ? 2 * options_.m : options_.m;
+}
+
+// [count, link, link, ...] for one node on one layer
+std::uint32_t *VectorIndex::links(std::uint32_t slot, unsigned level) {
+  if (level == 0) {
+    return level0_.data() + static_cast<std::size_t>(slot) * (1 + max_links(0));
+  }
+  return upper_[slot].data() + (level - 1) * (1 + options_.m);
+}
+
+const std::uint32_t *VectorIndex::links(std::uint32_t slot,
+                                        unsigned level) const {
+  return const_cast<VectorIndex *>(this)->links(slot, level);
+}
+
+// Layer L with probability M^-L: floor(-ln(U) / ln(M)) for U in (0, 1]
+unsigned VectorIndex::random_level() {
+  // splitmix64, then the top 53 bits as a double in [0, 1)
+  std::uint64_t z = (rng_state_ += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z ^= z >> 31;
+  const double uniform = 1.0 - static_cast<double>(z >> 11) * 0x1p-53;
+  const double level = -std::log(uniform) / std::log(double(options_.m));
+  return static_cast<unsigned>(std::min(level, double(MAX_LEVEL)));
+}
+
+void VectorIndex::build_graph() {
+  has_graph_ = true;
+  const std::size_t nodes = names_.size();
+  level0_.assign(nodes * (1 + max_links(0)), 0);
+  level0_.shrink_to_fit();
+  upper_.assign(nodes, {});
+  levels_.assign(nodes, 0);
+  entry_point_ = NO_NODE;
+  max_level_ = 0;
+  for (std::uint32_t slot = 0; slot < nodes; ++slot) {
+    insert_into_graph(slot);
+  }
+}
+
+// =============================================================================
+// HNSW — search
+// =============================================================================
+// Upper layers: plain greedy walk — hop to the closest neighbour until no
+// neighbour is closer. Only the entry point for the next layer matters.
+// =============================================================================
+std::uint32_t VectorIndex::greedy_descend(const View &query,
+                                          unsigned down_to) const {
+  std::uint32_t current = entry_point_;
+  float current_distance = distance(query, view_of(current));
+  for (unsigned level = max_level_; level > down_to; --level) {
+    bool moved = true;
+    while (moved) {
+      moved = false;
+      const std::uint32_t *list = links(current, level);
+      for (std::uint32_t i = 1; i <= list[0]; ++i) {
+        const float d = distance(query, view_of(list[i]));
+        if (d < current_distance) {
+          current = list[i];
+          current_distance = d;
+          moved = true;
+        }
+      }
+    }
+  }
+  return current;
+}
+
+// =============================================================================
+// search_layer() — Best-first search keeping the 'ef' closest nodes
+// =============================================================================
+// 'candidates' (closest first) is the frontier still to expand; 'results'
+// (farthest on top) holds the best ef found so far. We stop when the
+// closest unexpanded candidate is farther than the worst result: nothing
+// reachable through it can improve the list.
+//
+// With skip_tombstones, removed nodes are still EXPANDED (they may be the
+// only bridge to a region) but never enter the results.
+// =============================================================================
+std::vector<VectorIndex::Candidate>
+VectorIndex::search_layer(const View &query, std::uint32_t entry,
+                          std::size_t ef, unsigned level,
+                          bool skip_tombstones) const {
+  VisitedMarks &visited = visited_marks();
+  visited.begin(names_.size());
+
+  std::priority_queue<Candidate, std::vector<Candidate>,
+                      std::greater<Candidate>>
+      candidates;
+  std::priority_queue<Candidate> results;
+
+  const float entry_distance = distance(query, view_of(entry));
+  visited.test_and_set(entry);
+  candidates.push({entry_distance, entry});
+  if (!skip_tombstones || dead_[entry] == 0) {
+    results.push({entry_distance, entry});
+  }
+  float worst = results.empty() ? INF : entry_distance;
+
+  const std::size_t line_bytes =
+      options_.quantization == Quantization::FLOAT32
+          ? options_.dim * sizeof(float)
+          : options_.dim;
+  while (!candidates.empty()) {
+    const Candidate current = candidates.top();
+    if (current.distance > worst && results.size() >= ef) {
+      break;
+    }
+    candidates.pop();
+
+    const std::uint32_t *list = links(current.slot, level);
+    // Start pulling the neighbours' vectors into cache before we need
+    // them: each is a random jump through memory
+    for (std::uint32_t i = 1; i <= list[0]; ++i) {
+      const View next = view_of(list[i]);
+      const char *bytes = next.floats != nullptr
+                              ? reinterpret_cast<const char *>(next.floats)
+                              : reinterpret_cast<const char *>(next.codes);
+      for (std::size_t offset = 0; offset < line_bytes && offset < 256;
+           offset += 64) {
+        __builtin_prefetch(bytes + offset);
+      }
+    }
+
+    for (std::uint32_t i = 1; i <= list[0]; ++i) {
+      const std::uint32_t neighbor = list[i];
+      if (visited.test_and_set(neighbor)) {
+        continue;
+      }
+      const float d = distance(query, view_of(neighbor));
+      if (results.size() < ef || d < worst) {
+        candidates.push({d, neighbor});
+        if (!skip_tombstones || dead_[neighbor] == 0) {
+          results.push({d, neighbor});
+          if (results.size() > ef) {
+            results.pop();
+          }
+        }
+        worst = results.empty() ? INF : results.top().distance;
+      }
+    }
+  }
+
+  std::vector<Candidate> found(results.size());
+  for (auto it = found.rbegin(); it != found.rend(); ++it) {
+    *it = results.top();
+    results.pop();
+  }
+  return found; // closest first
+}
+
+// =============================================================================
+// HNSW — insertion
+// =============================================================================
+// NEIGHBOUR SELECTION HEURISTIC (the "H" paper's Algorithm 4): walking the
+// candidates closest first, keep one only if it is closer to the new node
+// than to every neighbour already kept. Pure "M closest" would link a node
+// to M points of the SAME tight cluster; the heuristic spreads links in
+// different directions, which keeps clusters connected to each other.
+// =============================================================================
+void VectorIndex::select_neighbors(std::vector<Candidate> &candidates,
+                                   std::size_t limit) const {
+  if (candidates.size() <= limit) {
+    return;
+  }
+  std::vector<Candidate> selected;
+  selected.reserve(limit);
+  for (const Candidate &candidate : candidates) {
+    if (selected.size() >= limit) {
+      break;
+    }
+    const View view = view_of(candidate.slot);
+    bool diverse = true;
+    for (const Candidate &kept : selected) {
+      if (distance(view, view_of(kept.slot)) < candidate.distance) {
+        diverse = false;
+        break;
+      }
+    }
+    if (diverse) {
+      selected.push_back(candidate);
+    }
+  }
+  candidates = std::move(selected);
+}
+
+// Add the edge from → to; a full list is re-pruned with the heuristic
+void VectorIndex::link(std::uint32_t from, std::uint32_t to, unsigned level) {
+  std::uint32_t *list = links(from, level);
+  const std::uint32_t limit = max_links(level);
+  if (list[0] < limit) {
+    list[++list[0]] = to;
+    return;
+  }
+
+  const View origin = view_of(from);
+  std::vector<Candidate> candidates;
+  candidates.reserve(limit + 1);
+  for (std::uint32_t i = 1; i <= list[0]; ++i) {
+    candidates.push_back({distance(origin, view_of(list[i])), list[i]});
+  }
+  candidates.push_back({distance(origin, view_of(to)), to});
+  std::sort(candidates.begin(), candidates.end());
+  select_neighbors(candidates, limit);
+
+  list[0] = static_cast<std::uint32_t>(candidates.size());
+  for (std::size_t i = 0; i < candidates.size(); ++i) {
+    list[1 + i] = candidates[i].slot;
+  }
+}
+
+void VectorIndex::insert_into_graph(std::uint32_t slot) {
+  const unsigned level = random_level();
+  levels_[slot] = static_cast<std::uint8_t>(level);
+  upper_[slot].assign(level * (1 + options_.m), 0);
+
+  if (entry_point_ == NO_NODE) {
+    entry_point_ = slot;
+    max_level_ = level;
+    return;
+  }
+
+  const View view = view_of(slot);
+  std::uint32_t entry = greedy_descend(view, level);
+  for (int layer = static_cast<int>(std::min(level, max_level_)); layer >= 0;
+       --layer) {
+    auto neighbors = search_layer(view, entry, options_.ef_construction,
+                                  static_cast<unsigned>(layer), false);
+    entry = neighbors.front().slot;
+    select_neighbors(neighbors, options_.m);
+
+    std::uint32_t *list = links(slot, static_cast<unsigned>(layer));
+    list[0] = static_cast<std::uint32_t>(neighbors.size());
+    for (std::size_t i = 0; i < neighbors.size(); ++i) {
+      list[1 + i] = neighbors[i].slot;
+      link(neighbors[i].slot, slot, static_cast<unsigned>(layer));
+    }
+  }
+
+  if (level > max_level_) {
+    max_level_ = level;
+    entry_point_ = slot;
+  }
+}
+
+// =============================================================================
+// knn() / knn_exact()
+// =============================================================================
+std::vector<VectorIndex::Match>
+VectorIndex::knn(const std::vector<float> &query, std::size_t k,
+                 std::size_t ef) const {
+  if (!has_graph_ || entry_point_ == NO_NODE) {
+    return knn_exact(query, k);
+  }
+  if (k == 0 || empty()) {
+    return {};
+  }
+
+  const Query prepared = prepare(query);
+  const std::uint32_t entry = greedy_descend(prepared.view, 0);
+  const auto found = search_layer(prepared.view, entry,
+                                  std::max(k, ef > 0 ? ef : DEFAULT_EF_SEARCH),
+                                  0, true);
+
+  std::vector<Match> matches;
+  matches.reserve(std::min(k, found.size()));
+  for (std::size_t i = 0; i < found.size() && i < k; ++i) {
+    matches.push_back(
+        {names_[found[i].slot], reported_distance(found[i].distance)});
+  }
+  return matches;
+}
+
+std::vector<VectorIndex::Match>
+VectorIndex::knn_exact(const std::vector<float> &query, std::size_t k) const {
+  if (k == 0 || empty()) {
+    return {};
+  }
+  const Query prepared = prepare(query);
+
+  // Max-heap of the k best so far: one comparison rejects most vectors
+  std::priority_queue<Candidate> best;
+  for (std::uint32_t slot = 0; slot < names_.size(); ++slot) {
+    if (dead_[slot] != 0) {
+      continue;
+    }
+    const float d = distance(prepared.view, view_of(slot));
+    if (best.size() < k) {
+      best.push({d, slot});
+    } else if (d < best.top().distance) {
+      best.pop();
+      best.push({d, slot});
+    }
+  }
+
+  std::vector<Match> matches(best.size());
+  for (auto it = matches.rbegin(); it != matches.rend(); ++it) {
+    *it = {names_[best.top().slot], reported_distance(best.top().distance)};
+    best.pop();
+  }
+  return matches;
+}
+
+std::size_t VectorIndex::size() const { return slot_of_.size(); }
+
+bool VectorIndex::empty() const { return slot_of_.empty(); }
+
+std::uint32_t VectorIndex::dim() const { return options_.dim; }
+
+const VectorIndex::Options &VectorIndex::options() const { return options_; }
+
+bool VectorIndex::has_graph() const { return has_graph_; }
+
+std::size_t VectorIndex::tombstones() const { return tombstones_; }
+
+std::size_t VectorIndex::memory_bytes() const {
+  std::size_t bytes = floats_.size() * sizeof(float) + codes_.size() +
+                      (scales_.size() + norms_sq_.size()) * sizeof(float) +
+                      level0_.size() * sizeof(std::uint32_t) + levels_.size();
+  for (const auto &layers : upper_) {
+    bytes += layers.size() * sizeof(std::uint32_t);
+  }
+  return bytes;
+}
+
+// =============================================================================
+// Snapshot encoding
+// =============================================================================
+//   u32 dim | u8 metric | u8 quantization | u8 algorithm | u32 m
+//   u32 ef_construction | u64 slots
+//   per slot: u8 dead | bytes name
+//             FLOAT32: dim × f32
+//             INT8:    bytes codes | f32 scale | f32 norm²
+//   u8 has_graph; if set: u32 entry point | u8 max level
+//             per slot: u8 level | per layer 0..level: u32 n | n × u32 link
+// Slot numbers (tombstones included) are kept so the links stay valid.
+// =============================================================================
+void VectorIndex::serialize(std::string &out) const {
+  put_u32(out, options_.dim);
+  put_u8(out, static_cast<std::uint8_t>(options_.metric));
+  put_u8(out, static_cast<std::uint8_t>(options_.quantization));
+  put_u8(out, static_cast<std::uint8_t>(options_.algorithm));
+  put_u32(out, options_.m);
+  put_u32(out, options_.ef_construction);
+  put_u64(out, names_.size());
+
+  const std::size_t dim = options_.dim;
+  for (std::uint32_t slot = 0; slot < names_.size(); ++slot) {
+    put_u8(out, dead_[slot]);
+    put_bytes(out, names_[slot]);
+    if (options_.quantization == Quantization::FLOAT32) {
+      for (std::size_t i = 0; i < dim; ++i) {
+        put_f32(out, floats_[slot * dim + i]);
+      }
+    } else {
+      put_bytes(out, std::string_view(
+                         reinterpret_cast<const char *>(codes_.data()) +
+                             slot * dim,
+                         dim));
+      put_f32(out, scales_[slot]);
+      put_f32(out, norms_sq_[slot]);
+    }
+  }
+
+  put_u8(out, has_graph_ ? 1 : 0);
+  if (!has_graph_) {
+    return;
+  }
+  put_u32(out, entry_point_);
+  put_u8(out, static_cast<std::uint8_t>(max_level_));
+  for (std::uint32_t slot = 0; slot < names_.size(); ++slot) {
+    put_u8(out, levels_[slot]);
+    for (unsigned level = 0; level <= levels_[slot]; ++level) {
+      const std::uint32_t *list = links(slot, level);
+      put_u32(out, list[0]);
+      for (std::uint32_t i = 1; i <= list[0]; ++i) {
+        put_u32(out, list[i]);
+      }
+    }
+  }
+}
+
+std::optional<VectorIndex> VectorIndex::deserialize(ByteReader &in) {
+  Options options;
+  std::uint8_t metric = 0;
+  std::uint8_t quantization = 0;
+  std::uint8_t algorithm = 0;
+  std::uint64_t slots = 0;
+  if (!in.get_u32(options.dim) || !in.get_u8(metric) ||
+      !in.get_u8(quantization) || !in.get_u8(algorithm) ||
+      !in.get_u32(options.m) || !in.get_u32(options.ef_construction) ||
+      !in.get_u64(slots) || options.dim > MAX_DIM || metric > 1 ||
+      quantization > 1 || algorithm > 2 || options.m < 2 ||
+      options.m > MAX_M || options.ef_construction == 0 ||
+      slots > in.remaining() / (5 + std::max<std::size_t>(options.dim, 1)) ||
+      (slots > 0 && options.dim == 0)) {
+    return std::nullopt;
+  }
+  options.metric = static_cast<Metric>(metric);
+  options.quantization = static_cast<Quantization>(quantization);
+  options.algorithm = static_cast<Algorithm>(algorithm);
+
+  VectorIndex index(options);
+  const std::size_t dim = options.dim;
+  const bool is_float = options.quantization == Quantization::FLOAT32;
+  index.names_.resize(slots);
+  index.dead_.resize(slots);
+  if (is_float) {
+    index.floats_.reserve(slots * dim);
+  } else {
+    index.codes_.reserve(slots * dim);
+  }
+
+  for (std::uint32_t slot = 0; slot < slots; ++slot) {
+    if (!in.get_u8(index.dead_[slot]) || index.dead_[slot] > 1 ||
+        !in.get_bytes(index.names_[slot])) {
+      return std::nullopt;
+    }
+    if (is_float) {
+      for (std::size_t i = 0; i < dim; ++i) {
+        float value = 0.0f;
+        if (!get_f32(in, value)) {
+          return std::nullopt;
+        }
+        index.floats_.push_back(value);
+      }
+    } else {
+      std::string codes;
+      float scale = 0.0f;
+      float norm_sq = 0.0f;
+      if (!in.get_bytes(codes) || codes.size() != dim ||
+          !get_f32(in, scale) || !get_f32(in, norm_sq)) {
+        return std::nullopt;
+      }
+      for (const char code : codes) {
+        index.codes_.push_back(static_cast<std::int8_t>(code));
+      }
+      index.scales_.push_back(scale);
+      index.norms_sq_.push_back(norm_sq);
+    }
+
+    if (index.dead_[slot] != 0) {
+      ++index.tombstones_;
+    } else if (!index.slot_of_.emplace(index.names_[slot], slot).second) {
+      return std::nullopt; // the same name twice
+    }
+  }
+
+  std::uint8_t has_graph = 0;
+  if (!in.get_u8(has_graph) || has_graph > 1 ||
+      (has_graph == 0 && index.tombstones_ > 0)) {
+    return std::nullopt;
+  }
+  if (has_graph == 0) {
+    return index;
+  }
+
+  std::uint8_t max_level = 0;
+  if (!in.get_u32(index.entry_point_) || !in.get_u8(max_level) ||
+      max_level > MAX_LEVEL ||
+      (slots == 0 ? index.entry_point_ != NO_NODE
+                  : index.entry_point_ >= slots)) {
+    return std::nullopt;
+  }
+  index.has_graph_ = true;
+  index.max_level_ = max_level;
+  index.level0_.assign(slots * (1 + index.max_links(0)), 0);
+  index.upper_.resize(slots);
+  index.levels_.resize(slots);
+
+  for (std::uint32_t slot = 0; slot < slots; ++slot) {
+    if (!in.get_u8(index.levels_[slot]) || index.levels_[slot] > max_level) {
+      return std::nullopt;
+    }
+    index.upper_[slot].assign(index.levels_[slot] * (1 + options.m), 0);
+    for (unsigned level = 0; level <= index.levels_[slot]; ++level) {
+      std::uint32_t *list = index.links(slot, level);
+      if (!in.get_u32(list[0]) || list[0] > index.max_links(level)) {
+        return std::nullopt;
+      }
+      for (std::uint32_t i = 1; i <= list[0]; ++i) {
+        if (!in.get_u32(list[i]) || list[i] >= slots) {
+          return std::nullopt;
+        }
+      }
+    }
+  }
+  // Links on layer L must point at nodes that exist on layer L
+  for (std::uint32_t slot = 0; slot < slots; ++slot) {
+    for (unsigned level = 1; level <= index.levels_[slot]; ++level) {
+      const std::uint32_t *list = index.links(slot, level);
+      for (std::uint32_t i = 1; i <= list[0]; ++i) {
+        if (index.levels_[list[i]] < level) {
+          return std::nullopt;
+        }
+      }
+    }
+  }
+  if (slots > 0 && index.levels_[index.entry_point_] != max_level) {
+    return std::nullopt;
+  }
+  index.rng_state_ = slots;
+  return index;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,201 @@
+// =============================================================================
+// vector_index.hpp — Nearest-Neighbour Vector Index (HEADER)
+// =============================================================================
+//
+// Stores named EMBEDDINGS (fixed-length float vectors produced by ML
+// models) and answers "which k stored vectors are closest to this one?" —
+// the core of semantic search, recommendations and RAG lookups.
+//
+// TWO WAYS TO SEARCH:
+//   1. FLAT (brute force): compare the query with EVERY vector. Exact, and
+//      with SIMD kernels (vector_ops.hpp) fast up to ~10^4-10^5 vectors.
+//   2. HNSW ("Hierarchical Navigable Small World", Malkov & Yashunin):
+//      every vector is a node linked to ~M close neighbours. A search
+//      starts at an entry point and greedily hops to whichever neighbour is
+//      closer to the query, keeping the 'ef' best candidates seen so far.
+//      Sparse upper LAYERS (each node is on layer L with probability M^-L)
+//      act like a skiplist's express lanes: long hops first, short hops on
+//      layer 0. Touches a few thousand vectors instead of millions, at the
+//      price of being APPROXIMATE — larger ef = higher recall, slower.
+// Algorithm::AUTO scans flat while the index is small and builds the graph
+// once it reaches HNSW_THRESHOLD vectors.
+//
+// STORAGE:
+//   FLOAT32 — 4 bytes per dimension, exact.
+//   INT8    — each vector is scaled so its largest |component| is 127 and
+//             rounded to bytes (plus one float scale): 4x smaller, and
+//             distances come from an exact integer dot product. Costs a
+//             little recall; the benchmark reports how much.
+//
+// METRICS:
+//   COSINE — vectors are normalized on insert; distance = 1 - cos(angle),
+//            0 (same direction) .. 2 (opposite).
+//   L2     — Euclidean distance.
+//
+// DELETION: a removed vector's node stays in the graph as a TOMBSTONE (it
+// still routes searches, it's just never returned). When tombstones
+// outnumber live vectors the index is compacted and the graph rebuilt.
+// =============================================================================
+
+#pragma once
+
+#include "util/byte_codec.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mini_redis {
+
+class VectorIndex {
+public:
+  enum class Metric : std::uint8_t { COSINE = 0, L2 = 1 };
+  enum class Quantization : std::uint8_t { FLOAT32 = 0, INT8 = 1 };
+  enum class Algorithm : std::uint8_t { AUTO = 0, FLAT = 1, HNSW = 2 };
+
+  // AUTO switches from a flat scan to the graph at this many vectors
+  static constexpr std::size_t HNSW_THRESHOLD = 10'000;
+  static constexpr std::uint32_t MAX_DIM = 32'768;
+  static constexpr std::uint32_t MAX_M = 128;
+
+  struct Options {
+    std::uint32_t dim = 0; // 0 = taken from the first vector added
+    Metric metric = Metric::COSINE;
+    Quantization quantization = Quantization::FLOAT32;
+    Algorithm algorithm = Algorithm::AUTO;
+    std::uint32_t m = 16; // graph links per node (2M on layer 0)
+    std::uint32_t ef_construction = 200; // candidates kept while linking
+  };
+
+  struct Match {
+    std::string name;
+    float distance;
+  };
+
+  VectorIndex();
+  explicit VectorIndex(const Options &options);
+
+  // ---- valid() — Can this vector be stored here? ----
+  // Right length (if dim is known), finite values, and for COSINE not all
+  // zeros (a zero vector has no direction).
+  bool valid(const std::vector<float> &vector) const;
+
+  // ---- add() — Insert or replace; true if 'name' is new ----
+  // The caller checks valid() first.
+  bool add(const std::string &name, const std::vector<float> &vector);
+
+  // ---- remove() — true if 'name' was present ----
+  bool remove(const std::string &name);
+
+  // ---- get() — The stored vector (normalized / dequantized as stored) ----
+  std::optional<std::vector<float>> get(const std::string &name) const;
+
+  // ---- knn() — The k nearest vectors, closest first ----
+  // Uses the graph when there is one; 'ef' is its candidate list size
+  // (0 = default, never less than k). The query must be valid().
+  std::vector<Match> knn(const std::vector<float> &query, std::size_t k,
+                         std::size_t ef = 0) const;
+
+  // ---- knn_exact() — The same, always by brute-force scan ----
+  std::vector<Match> knn_exact(const std::vector<float> &query,
+                               std::size_t k) const;
+
+  std::size_t size() const;
+  bool empty() const;
+  std::uint32_t dim() const;
+  const Options &options() const;
+  bool has_graph() const;
+  std::size_t tombstones() const;
+  std::size_t memory_bytes() const;
+
+  // ---- Snapshot support (see core/snapshot.hpp) ----
+  // The graph is saved too: rebuilding a million-node graph at startup
+  // would take minutes.
+  void serialize(std::string &out) const;
+  static std::optional<VectorIndex> deserialize(ByteReader &in);
+
+private:
+  // A vector prepared for distance computations: points INTO storage (a
+  // stored node) or into a caller's buffer (a query)
+  struct View {
+    const float *floats = nullptr;
+    const std::int8_t *codes = nullptr;
+    float scale = 0.0f;   // INT8: value = code * scale
+    float norm_sq = 0.0f; // INT8: |dequantized vector|²
+  };
+
+  // A query converted to the index's storage format
+  struct Query {
+    std::vector<float> floats;
+    std::vector<std::int8_t> codes;
+    View view;
+  };
+
+  static constexpr std::uint32_t NO_NODE = ~std::uint32_t{0};
+  static constexpr unsigned MAX_LEVEL = 15;
+
+  struct Candidate {
+    float distance;
+    std::uint32_t slot;
+    bool operator<(const Candidate &other) const {
+      return distance < other.distance;
+    }
+    bool operator>(const Candidate &other) const {
+      return distance > other.distance;
+    }
+  };
+
+  Query prepare(const std::vector<float> &vector) const;
+  View view_of(std::uint32_t slot) const;
+  float distance(const View &a, const View &b) const;
+  float reported_distance(float internal) const;
+
+  // ---- Slots: the dense storage every vector lives in ----
+  std::uint32_t append_slot(const std::string &name, const Query &query);
+  void remove_slot_flat(std::uint32_t slot);
+  void compact();
+
+  // ---- HNSW graph ----
+  std::uint32_t max_links(unsigned level) const;
+  std::uint32_t *links(std::uint32_t slot, unsigned level);
+  const std::uint32_t *links(std::uint32_t slot, unsigned level) const;
+  unsigned random_level();
+  void build_graph();
+  void insert_into_graph(std::uint32_t slot);
+  std::uint32_t greedy_descend(const View &query, unsigned down_to) const;
+  std::vector<Candidate> search_layer(const View &query, std::uint32_t entry,
+                                      std::size_t ef, unsigned level,
+                                      bool skip_tombstones) const;
+  void select_neighbors(std::vector<Candidate> &candidates,
+                        std::size_t limit) const;
+  void link(std::uint32_t from, std::uint32_t to, unsigned level);
+
+  Options options_;
+
+  // Per slot (a slot index is also the node ID in the graph)
+  std::vector<std::string> names_;
+  std::vector<float> floats_;       // FLOAT32: dim per slot
+  std::vector<std::int8_t> codes_;  // INT8: dim per slot
+  std::vector<float> scales_;       // INT8
+  std::vector<float> norms_sq_;     // INT8
+  std::vector<std::uint8_t> dead_;  // 1 = tombstone
+  std::unordered_map<std::string, std::uint32_t> slot_of_;
+  std::size_t tombstones_ = 0;
+
+  // Graph: layer 0 is one flat array of [count, 2M links] per slot; the
+  // few nodes on upper layers keep [count, M links] per layer separately
+  bool has_graph_ = false;
+  std::vector<std::uint32_t> level0_;
+  std::vector<std::vector<std::uint32_t>> upper_;
+  std::vector<std::uint8_t> levels_;
+  std::uint32_t entry_point_ = NO_NODE;
+  unsigned max_level_ = 0;
+  // splitmix64 state for random_level(). Not std::mt19937_64: that is
+  // 2.5 KB, and every key in the store pays for the largest StoreValue
+  std::uint64_t rng_state_ = 0x5eed;
+};
+
+} // namespace mini_redis
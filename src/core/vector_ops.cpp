@@ -0,0 +1,313 @@
+// =============================================================================
+// vector_ops.cpp — Distance Kernels for Embedding Vectors (IMPLEMENTATION)
+// =============================================================================
+
+#include "core/vector_ops.hpp"
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define MINI_REDIS_HAVE_SIMD_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace mini_redis {
+
+namespace {
+
+#ifdef MINI_REDIS_HAVE_SIMD_KERNELS
+
+// Checked once; the answers can't change while the process runs
+bool cpu_has_avx512() {
+  static const bool has_avx512 = __builtin_cpu_supports("avx512f") &&
+                                 __builtin_cpu_supports("avx512bw");
+  return has_avx512;
+}
+
+bool cpu_has_avx2() {
+  static const bool has_avx2 = __builtin_cpu_supports("avx2");
+  return has_avx2;
+}
+
+bool cpu_has_fma() {
+  static const bool has_fma = __builtin_cpu_supports("fma");
+  return has_fma;
+}
+
+// Sum of the 8 lanes of an AVX register
+__attribute__((target("avx2"))) float horizontal_sum(__m256 v) {
+  __m128 sum =
+      _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+  return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx2"))) std::int32_t horizontal_sum(__m256i v) {
+  __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(v),
+                              _mm256_extracti128_si256(v, 1));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// =============================================================================
+// AVX2 + FMA — 8 floats per instruction, two accumulators
+// =============================================================================
+// One FMA takes ~4 cycles to finish but a new one can START every cycle.
+// With a single accumulator each FMA waits for the previous one; two
+// independent chains keep twice as many in flight.
+// =============================================================================
+__attribute__((target("avx2,fma"))) float
+dot_f32_avx2(const float *a, const float *b, std::size_t length) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    sum0 =
+        _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+    sum1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8),
+                           _mm256_loadu_ps(b + i + 8), sum1);
+  }
+  for (; i + 8 <= length; i += 8) {
+    sum0 =
+        _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), sum0);
+  }
+  float total = horizontal_sum(_mm256_add_ps(sum0, sum1));
+  for (; i < length; ++i) {
+    total += a[i] * b[i];
+  }
+  return total;
+}
+
+__attribute__((target("avx2,fma"))) float
+l2_sq_f32_avx2(const float *a, const float *b, std::size_t length) {
+  __m256 sum0 = _mm256_setzero_ps();
+  __m256 sum1 = _mm256_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m256 d0 =
+        _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+    const __m256 d1 =
+        _mm256_sub_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8));
+    sum0 = _mm256_fmadd_ps(d0, d0, sum0);
+    sum1 = _mm256_fmadd_ps(d1, d1, sum1);
+  }
+  for (; i + 8 <= length; i += 8) {
+    const __m256 d =
+        _mm256_sub_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i));
+    sum0 = _mm256_fmadd_ps(d, d, sum0);
+  }
+  float total = horizontal_sum(_mm256_add_ps(sum0, sum1));
+  for (; i < length; ++i) {
+    const float d = a[i] - b[i];
+    total += d * d;
+  }
+  return total;
+}
+
+// Sign-extend 16 bytes to 16-bit lanes, multiply pairwise, add adjacent
+// products into 8 int32 lanes: vpmaddwd does the last two steps at once
+__attribute__((target("avx2"))) std::int32_t
+dot_i8_avx2(const std::int8_t *a, const std::int8_t *b, std::size_t length) {
+  __m256i sum = _mm256_setzero_si256();
+  std::size_t i = 0;
+  for (; i + 16 <= length; i += 16) {
+    const __m256i va = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(a + i)));
+    const __m256i vb = _mm256_cvtepi8_epi16(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(b + i)));
+    sum = _mm256_add_epi32(sum, _mm256_madd_epi16(va, vb));
+  }
+  std::int32_t total = horizontal_sum(sum);
+  for (; i < length; ++i) {
+    total += static_cast<std::int32_t>(a[i]) * b[i];
+  }
+  return total;
+}
+
+// Sums of the 16 lanes of an AVX-512 register: fold halves together in
+// registers. The all-ones zero-masking forms compute the same shuffles as
+// the plain ones (and the casts), which like _mm512_reduce_add_* trip GCC
+// 12's -Wuninitialized on their internal "undefined" register.
+constexpr __mmask16 ALL_LANES = 0xFFFF;
+
+__attribute__((target("avx512f"))) float horizontal_sum(__m512 v) {
+  v = _mm512_add_ps(v, _mm512_maskz_shuffle_f32x4(ALL_LANES, v, v,
+                                                  _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm512_add_ps(v, _mm512_maskz_shuffle_f32x4(ALL_LANES, v, v,
+                                                  _MM_SHUFFLE(2, 3, 0, 1)));
+  __m128 sum = _mm512_maskz_extractf32x4_ps(0xF, v, 0);
+  sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+  sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+  return _mm_cvtss_f32(sum);
+}
+
+__attribute__((target("avx512f"))) std::int32_t horizontal_sum(__m512i v) {
+  v = _mm512_add_epi32(v, _mm512_maskz_shuffle_i32x4(ALL_LANES, v, v,
+                                                     _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm512_add_epi32(v, _mm512_maskz_shuffle_i32x4(ALL_LANES, v, v,
+                                                     _MM_SHUFFLE(2, 3, 0, 1)));
+  __m128i sum = _mm512_maskz_extracti32x4_epi32(0xF, v, 0);
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+  return _mm_cvtsi128_si32(sum);
+}
+
+// =============================================================================
+// AVX-512 — 16 floats per instruction; the tail is a MASKED load
+// =============================================================================
+// Masked loads read only the lanes whose mask bit is set (the rest become
+// 0), so the last partial block needs no scalar loop — and 0 * 0 adds
+// nothing to either sum.
+// =============================================================================
+__attribute__((target("avx512f"))) float
+dot_f32_avx512(const float *a, const float *b, std::size_t length) {
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    sum0 =
+        _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), sum0);
+    sum1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16),
+                           _mm512_loadu_ps(b + i + 16), sum1);
+  }
+  for (; i < length; i += 16) {
+    const std::size_t left = length - i;
+    const __mmask16 mask = left >= 16
+                               ? ALL_LANES
+                               : static_cast<__mmask16>((1u << left) - 1);
+    sum0 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                           _mm512_maskz_loadu_ps(mask, b + i), sum0);
+  }
+  return horizontal_sum(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f"))) float
+l2_sq_f32_avx512(const float *a, const float *b, std::size_t length) {
+  __m512 sum0 = _mm512_setzero_ps();
+  __m512 sum1 = _mm512_setzero_ps();
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m512 d0 =
+        _mm512_sub_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i));
+    const __m512 d1 =
+        _mm512_sub_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16));
+    sum0 = _mm512_fmadd_ps(d0, d0, sum0);
+    sum1 = _mm512_fmadd_ps(d1, d1, sum1);
+  }
+  for (; i < length; i += 16) {
+    const std::size_t left = length - i;
+    const __mmask16 mask = left >= 16
+                               ? ALL_LANES
+                               : static_cast<__mmask16>((1u << left) - 1);
+    const __m512 d = _mm512_sub_ps(_mm512_maskz_loadu_ps(mask, a + i),
+                                   _mm512_maskz_loadu_ps(mask, b + i));
+    sum0 = _mm512_fmadd_ps(d, d, sum0);
+  }
+  return horizontal_sum(_mm512_add_ps(sum0, sum1));
+}
+
+__attribute__((target("avx512f,avx512bw"))) std::int32_t
+dot_i8_avx512(const std::int8_t *a, const std::int8_t *b, std::size_t length) {
+  __m512i sum = _mm512_setzero_si512();
+  std::size_t i = 0;
+  for (; i + 32 <= length; i += 32) {
+    const __m512i va = _mm512_cvtepi8_epi16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a + i)));
+    const __m512i vb = _mm512_cvtepi8_epi16(
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b + i)));
+    sum = _mm512_add_epi32(sum, _mm512_madd_epi16(va, vb));
+  }
+  std::int32_t total = horizontal_sum(sum);
+  for (; i < length; ++i) {
+    total += static_cast<std::int32_t>(a[i]) * b[i];
+  }
+  return total;
+}
+
+#endif // MINI_REDIS_HAVE_SIMD_KERNELS
+
+} // anonymous namespace
+
+// =============================================================================
+// Portable kernels — four independent sums, for the same reason as above
+// =============================================================================
+float dot_f32_scalar(const float *a, const float *b, std::size_t length) {
+  float sums[4] = {0, 0, 0, 0};
+  std::size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      sums[lane] += a[i + lane] * b[i + lane];
+    }
+  }
+  for (; i < length; ++i) {
+    sums[0] += a[i] * b[i];
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+float l2_sq_f32_scalar(const float *a, const float *b, std::size_t length) {
+  float sums[4] = {0, 0, 0, 0};
+  std::size_t i = 0;
+  for (; i + 4 <= length; i += 4) {
+    for (std::size_t lane = 0; lane < 4; ++lane) {
+      const float d = a[i + lane] - b[i + lane];
+      sums[lane] += d * d;
+    }
+  }
+  for (; i < length; ++i) {
+    const float d = a[i] - b[i];
+    sums[0] += d * d;
+  }
+  return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+}
+
+std::int32_t dot_i8_scalar(const std::int8_t *a, const std::int8_t *b,
+                           std::size_t length) {
+  std::int32_t total = 0;
+  for (std::size_t i = 0; i < length; ++i) {
+    total += static_cast<std::int32_t>(a[i]) * b[i];
+  }
+  return total;
+}
+
+// =============================================================================
+// Dispatchers
+// =============================================================================
+float dot_f32(const float *a, const float *b, std::size_t length) {
+#ifdef MINI_REDIS_HAVE_SIMD_KERNELS
+  if (cpu_has_avx512()) {
+    return dot_f32_avx512(a, b, length);
+  }
+  if (cpu_has_avx2() && cpu_has_fma()) {
+    return dot_f32_avx2(a, b, length);
+  }
+#endif
+  return dot_f32_scalar(a, b, length);
+}
+
+float l2_sq_f32(const float *a, const float *b, std::size_t length) {
+#ifdef MINI_REDIS_HAVE_SIMD_KERNELS
+  if (cpu_has_avx512()) {
+    return l2_sq_f32_avx512(a, b, length);
+  }
+  if (cpu_has_avx2() && cpu_has_fma()) {
+    return l2_sq_f32_avx2(a, b, length);
+  }
+#endif
+  return l2_sq_f32_scalar(a, b, length);
+}
+
+std::int32_t dot_i8(const std::int8_t *a, const std::int8_t *b,
+                    std::size_t length) {
+#ifdef MINI_REDIS_HAVE_SIMD_KERNELS
+  if (cpu_has_avx512()) {
+    return dot_i8_avx512(a, b, length);
+  }
+  if (cpu_has_avx2()) {
+    return dot_i8_avx2(a, b, length);
+  }
+#endif
+  return dot_i8_scalar(a, b, length);
+}
+
+} // namespace mini_redis
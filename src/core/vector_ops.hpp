@@ -0,0 +1,46 @@
+// =============================================================================
+// vector_ops.hpp — Distance Kernels for Embedding Vectors (HEADER)
+// =============================================================================
+//
+// Nearest-neighbour search spends nearly all its time in ONE loop: the
+// distance between the query and a stored vector, 128-1536 numbers long.
+// A brute-force scan of a million 128-d vectors is 128 million multiply-
+// adds per query, so these kernels decide how fast search is.
+//
+//   - dot_f32 / l2_sq_f32: float32 vectors. AVX-512 does 16 lanes per FMA
+//     ("fused multiply-add": a*b+c in ONE instruction, one rounding), AVX2
+//     8 lanes; several independent accumulators hide the FMA latency.
+//   - dot_i8: int8-QUANTIZED vectors (see vector_index.hpp) — 4x less
+//     memory to stream through. Bytes are widened to 16 bits and multiplied
+//     pairwise into 32-bit sums (vpmaddwd), 32 (AVX-512) or 16 (AVX2) at once.
+//
+// As in set_ops.hpp, each kernel is picked at RUNTIME, so one binary runs
+// everywhere and uses the widest instructions the CPU offers. SIMD sums in
+// a different order than the scalar loop, so float results can differ in
+// the last bits; int8 results are exact.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mini_redis {
+
+// ---- dot_f32() — Σ a[i] * b[i] ----
+float dot_f32(const float *a, const float *b, std::size_t length);
+
+// ---- l2_sq_f32() — Σ (a[i] - b[i])² (squared Euclidean distance) ----
+float l2_sq_f32(const float *a, const float *b, std::size_t length);
+
+// ---- dot_i8() — Σ a[i] * b[i] over signed bytes, exactly ----
+std::int32_t dot_i8(const std::int8_t *a, const std::int8_t *b,
+                    std::size_t length);
+
+// ---- Portable versions (exposed for tests and benchmarks) ----
+float dot_f32_scalar(const float *a, const float *b, std::size_t length);
+float l2_sq_f32_scalar(const float *a, const float *b, std::size_t length);
+std::int32_t dot_i8_scalar(const std::int8_t *a, const std::int8_t *b,
+                           std::size_t length);
+
+} // namespace mini_redis
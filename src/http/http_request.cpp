@@ -5,7 +5,9 @@
 #include "http/http_request.hpp"
 
 #include <algorithm> // std::transform — apply a function to each element
+#include <cctype>    // std::isxdigit
 #include <sstream>   // std::istringstream — parse strings like a file
+#include <utility>   // std::move
 
 // =============================================================================
 // Anonymous namespace for internal helper functions
@@ -30,6 +32,29 @@ std::string to_lower(std::string str) {
   return str;
 }
 
+// Decode URL percent-escapes: "a%20b" → "a b", and '+' → ' ' (form style).
+// Malformed escapes are kept verbatim rather than rejected.
+std::string percent_decode(const std::string &text) {
+  std::string result;
+  result.reserve(text.size());
+
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    if (text[i] == '+') {
+      result += ' ';
+    } else if (text[i] == '%' && i + 2 < text.size() &&
+               std::isxdigit(static_cast<unsigned char>(text[i + 1])) &&
+               std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+      // std::stoi with base 16 turns "20" into 32 (the space character)
+      result += static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16));
+      i += 2;
+    } else {
+      result += text[i];
+    }
+  }
+
+  return result;
+}
+
 } // anonymous namespace
 
 namespace mini_redis {
@@ -88,6 +113,28 @@ std::optional<HttpRequest> HttpRequest::parse(const std::string &raw_request) {
   }
 
   request.method_ = string_to_method(method_str);
+
+  // Split "/zset/range/board?start=0&stop=9" into the path and the query
+  const auto question_mark = path.find('?');
+  if (question_mark != std::string::npos) {
+    std::istringstream query(path.substr(question_mark + 1));
+    std::string pair;
+
+    // Each "name=value" pair is separated by '&'
+    while (std::getline(query, pair, '&')) {
+      if (pair.empty()) {
+        continue;
+      }
+      const auto equals = pair.find('=');
+      if (equals == std::string::npos) {
+        request.query_params_[percent_decode(pair)] = ""; // flag: "?verbose"
+      } else {
+        request.query_params_[percent_decode(pair.substr(0, equals))] =
+            percent_decode(pair.substr(equals + 1));
+      }
+    }
+    path.resize(question_mark);
+  }
   request.path_ = path;
 
   // ---- Step 2: Parse headers ----
@@ -174,6 +221,41 @@ HttpRequest::get_header(const std::string &name) const {
   return it->second;
 }
 
+// =============================================================================
+// get_query_param() — Query-string lookup (case-sensitive, like URLs)
+// =============================================================================
+std::optional<std::string>
+HttpRequest::get_query_param(const std::string &name) const {
+  const auto it = query_params_.find(name);
+
+  if (it == query_params_.end()) {
+    return std::nullopt;
+  }
+
+  return it->second;
+}
+
+// =============================================================================
+// content_length() / next_body_chunk() — The body beyond the first read
+// =============================================================================
+std::optional<std::size_t> HttpRequest::content_length() const {
+  const auto header = get_header("content-length");
+  if (!header.has_value() || header->empty() ||
+      header->find_first_not_of("0123456789") != std::string::npos ||
+      header->size() > 18) { // more digits could overflow size_t
+    return std::nullopt;
+  }
+  return static_cast<std::size_t>(std::stoull(*header));
+}
+
+void HttpRequest::set_body_source(BodySource source) {
+  body_source_ = std::move(source);
+}
+
+std::string HttpRequest::next_body_chunk() const {
+  return body_source_ ? body_source_() : std::string();
+}
+
 // =============================================================================
 // string_to_method() — Convert HTTP method string to enum
 // =============================================================================
@@ -182,8 +264,12 @@ HttpMethod HttpRequest::string_to_method(const std::string &method_str) {
     return HttpMethod::GET;
   if (method_str == "PUT")
     return HttpMethod::PUT;
+  if (method_str == "POST")
+    return HttpMethod::POST;
   if (method_str == "DELETE")
     return HttpMethod::DELETE;
+  if (method_str == "PATCH")
+    return HttpMethod::PATCH;
   return HttpMethod::UNKNOWN;
 }
 
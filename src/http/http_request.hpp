@@ -19,6 +19,8 @@
 
 #pragma once
 
+#include <cstddef>
+#include <functional>
 #include <optional>
 #include <string>
 #include <unordered_map>
@@ -30,13 +32,22 @@ namespace mini_redis {
 // =============================================================================
 // GET    = "give me data" (read)
 // PUT    = "store this data" (create/update)
+// POST   = "perform this action" (NOT idempotent — e.g. increment a score)
 // DELETE = "remove this data" (delete)
+// PATCH  = "change PART of this data" (e.g. one field of a JSON document)
 // These map directly to our key-value store operations.
+//
+// WHAT DOES IDEMPOTENT MEAN?
+// Doing it twice has the same effect as doing it once. PUT x=5 twice still
+// leaves x=5; "add 1 to x" twice adds 2. Clients and proxies may safely
+// RETRY idempotent requests, so non-idempotent actions belong on POST.
 // =============================================================================
 enum class HttpMethod {
   GET,
   PUT,
+  POST,
   DELETE,
+  PATCH,
   UNKNOWN // For methods we don't support
 };
 
@@ -78,6 +89,30 @@ public:
   // Returns std::nullopt if the header doesn't exist
   std::optional<std::string> get_header(const std::string &name) const;
 
+  // Get a query-string parameter (the "?name=value&..." part of the URL).
+  // Values are percent-decoded ("a%20b" → "a b"). path() never includes
+  // the query string, so routing only ever sees the bare path.
+  // Returns std::nullopt if the parameter doesn't exist
+  std::optional<std::string> get_query_param(const std::string &name) const;
+
+  // The Content-Length header as a number; std::nullopt if it is absent
+  // or not a plain decimal number
+  std::optional<std::size_t> content_length() const;
+
+  // ---- Bodies too large to buffer (streaming routes) ----
+  // For most routes the server reads the whole body before routing, and
+  // body() holds all of it. For a streaming route (bulk import) body()
+  // only holds what arrived with the headers; next_body_chunk() pulls the
+  // rest from the socket, one piece per call, and returns "" once the
+  // body is complete or the client has gone.
+  //
+  // The connection, not the request, owns the socket — so the server
+  // plugs in a BodySource. next_body_chunk() is const like the other
+  // accessors: it reads the stream, it doesn't change the request.
+  using BodySource = std::function<std::string()>;
+  void set_body_source(BodySource source);
+  std::string next_body_chunk() const;
+
 private:
   // ---- Private constructor ----
   // Only parse() can create HttpRequest objects (factory pattern).
@@ -93,6 +128,8 @@ private:
   std::string path_;
   std::string body_;
   std::unordered_map<std::string, std::string> headers_;
+  std::unordered_map<std::string, std::string> query_params_;
+  BodySource body_source_; // empty: body() is the whole body
 };
 
 } // namespace mini_redis
@@ -5,6 +5,7 @@
 #include "http/http_response.hpp"
 
 #include <sstream> // std::ostringstream for building the response string
+#include <utility> // std::move
 
 namespace mini_redis {
 
@@ -43,10 +44,39 @@ HttpResponse HttpResponse::method_not_allowed() {
   return HttpResponse(405, "Method Not Allowed");
 }
 
+// 409 = the request clashes with the resource's current state — we use it
+// when a key holds a different type (e.g. ZADD on a plain string key)
+HttpResponse HttpResponse::conflict() { return HttpResponse(409, "Conflict"); }
+
+// 429 = the client is over its rate limit (see util/rate_limiter.hpp)
+HttpResponse HttpResponse::too_many_requests() {
+  return HttpResponse(429, "Too Many Requests");
+}
+
 HttpResponse HttpResponse::internal_error() {
   return HttpResponse(500, "Internal Server Error");
 }
 
+HttpResponse HttpResponse::insufficient_storage() {
+  return HttpResponse(507, "Insufficient Storage");
+}
+
+// =============================================================================
+// parked() — Placeholder for a reply that a blocking command will send later
+// =============================================================================
+// 202 Accepted is only a label here: this response is never serialized.
+// =============================================================================
+HttpResponse HttpResponse::parked(std::shared_ptr<ParkedConnection> connection) {
+  HttpResponse response(202, "Accepted");
+  response.parked_ = std::move(connection);
+  return response;
+}
+
+const std::shared_ptr<ParkedConnection> &
+HttpResponse::parked_connection() const {
+  return parked_;
+}
+
 // =============================================================================
 // body() — Set the response body (builder method)
 // =============================================================================
@@ -66,6 +96,33 @@ HttpResponse &HttpResponse::header(const std::string &name,
   return *this;
 }
 
+// =============================================================================
+// stream_body() / write_streamed_body() — Chunked transfer encoding
+// =============================================================================
+// Each chunk is "<size in hex>\r\n<bytes>\r\n"; a chunk of size 0 ends the
+// body. That is why empty pieces are skipped: they would end it early.
+// =============================================================================
+HttpResponse &HttpResponse::stream_body(BodyWriter writer) {
+  body_writer_ = std::move(writer);
+  return *this;
+}
+
+const HttpResponse::BodyWriter &HttpResponse::body_writer() const {
+  return body_writer_;
+}
+
+bool HttpResponse::write_streamed_body(const ChunkSink &write) const {
+  const auto send_chunk = [&write](std::string_view piece) {
+    if (piece.empty()) {
+      return true;
+    }
+    std::ostringstream size;
+    size << std::hex << piece.size() << "\r\n";
+    return write(size.str()) && write(piece) && write("\r\n");
+  };
+  return body_writer_ && body_writer_(send_chunk) && write("0\r\n\r\n");
+}
+
 // =============================================================================
 // build() — Serialize the response to HTTP/1.1 text format
 // =============================================================================
@@ -86,8 +143,14 @@ std::string HttpResponse::build() const {
   // ---- Content-Length header ----
   // This tells the client how many bytes the body is.
   // Without it, the client doesn't know when the body ends!
-  // We always include this, even for empty bodies (Content-Length: 0).
-  response << "Content-Length: " << body_.size() << "\r\n";
+  // We always include this, even for empty bodies (Content-Length: 0),
+  // except for a streamed body, whose length isn't known yet: the chunks
+  // carry their own lengths instead.
+  if (body_writer_) {
+    response << "Transfer-Encoding: chunked\r\n";
+  } else {
+    response << "Content-Length: " << body_.size() << "\r\n";
+  }
 
   // ---- Connection: close header ----
   // This tells the client to close the connection after this response.
@@ -24,11 +24,19 @@
 
 #pragma once
 
+#include <functional>
+#include <memory> // std::shared_ptr
 #include <string>
+#include <string_view>
 #include <unordered_map>
 
 namespace mini_redis {
 
+// FORWARD DECLARATION: "a class with this name exists". Enough to hold a
+// pointer to it without #including its header, which keeps the HTTP layer
+// from depending on the network layer's headers.
+class ParkedConnection;
+
 class HttpResponse {
 public:
   // ---- Static factories for common status codes ----
@@ -40,7 +48,19 @@ public:
   static HttpResponse bad_request();        // 400 Bad Request
   static HttpResponse not_found();          // 404 Not Found
   static HttpResponse method_not_allowed(); // 405 Method Not Allowed
+  static HttpResponse conflict();           // 409 Conflict
+  static HttpResponse too_many_requests();  // 429 Too Many Requests
   static HttpResponse internal_error();     // 500 Internal Server Error
+  static HttpResponse insufficient_storage(); // 507 Insufficient Storage
+
+  // ---- A reply that will be sent LATER ----
+  // Returned by blocking commands (BLPOP...) that found nothing to do yet.
+  // The caller must hand the client socket to 'parked' instead of writing
+  // a response now — see network/parked_connection.hpp.
+  static HttpResponse parked(std::shared_ptr<ParkedConnection> connection);
+
+  // Non-null only for responses created by parked()
+  const std::shared_ptr<ParkedConnection> &parked_connection() const;
 
   // ---- Builder methods ----
   // Each returns a REFERENCE to *this, enabling method chaining:
@@ -53,8 +73,29 @@ public:
   HttpResponse &body(const std::string &body_content);
   HttpResponse &header(const std::string &name, const std::string &value);
 
+  // ---- Streamed body (bulk export) ----
+  // For a body too large to build as one string. Instead of body(), the
+  // writer hands the body over piece by piece to 'send', after the
+  // headers are out. Each piece goes out as one HTTP/1.1 chunk
+  // ("Transfer-Encoding: chunked" instead of Content-Length), so the
+  // client can tell a complete body from a cut-off one. 'send' returns
+  // false once the client is gone; the writer returns false to give up,
+  // and the body is then left unterminated.
+  using ChunkSink = std::function<bool(std::string_view piece)>;
+  using BodyWriter = std::function<bool(const ChunkSink &send)>;
+  HttpResponse &stream_body(BodyWriter writer);
+
+  // Empty unless stream_body() was called
+  const BodyWriter &body_writer() const;
+
+  // Runs the writer, framing its pieces as chunks and ending the body.
+  // 'write' sends raw bytes to the client. False if the body is
+  // incomplete (the writer gave up or the client went away).
+  bool write_streamed_body(const ChunkSink &write) const;
+
   // ---- Build the final HTTP response string ----
-  // This creates the complete HTTP response text ready to send over the wire.
+  // This creates the complete HTTP response text ready to send over the wire
+  // (only the headers, for a streamed body).
   // Format:
   //   HTTP/1.1 200 OK\r\n
   //   Content-Type: text/plain\r\n
@@ -71,6 +112,8 @@ private:
   std::string status_text_; // "OK", "Not Found", "Internal Server Error"
   std::string body_;        // Response body content
   std::unordered_map<std::string, std::string> headers_;
+  std::shared_ptr<ParkedConnection> parked_;
+  BodyWriter body_writer_;
 };
 
 } // namespace mini_redis
@@ -5,6 +5,8 @@
 #include "http/router.hpp"
 #include "util/logger.hpp"
 
+#include <utility> // std::move
+
 namespace mini_redis {
 
 // =============================================================================
@@ -24,8 +26,14 @@ void Router::add_route(HttpMethod method, const std::string &prefix,
   Logger::info("Route registered: " + prefix);
 }
 
+void Router::add_streaming_route(HttpMethod method, const std::string &prefix,
+                                 HandlerFunc handler) {
+  routes_.push_back(Route{method, prefix, std::move(handler), true});
+  Logger::info("Route registered: " + prefix + " (streaming body)");
+}
+
 // =============================================================================
-// route() — Find and execute the matching handler
+// find() / route() — Find and execute the matching handler
 // =============================================================================
 // Algorithm:
 //   1. For each registered route, check if the method AND path prefix match
@@ -36,7 +44,7 @@ void Router::add_route(HttpMethod method, const std::string &prefix,
 // specific routes should be registered before more general ones.
 // For example, register "/kv/" before "/" to avoid "/" matching everything.
 // =============================================================================
-HttpResponse Router::route(const HttpRequest &request) const {
+const Router::Route *Router::find(const HttpRequest &request) const {
   // Get the request path (e.g., "/kv/hello")
   const std::string &path = request.path();
 
@@ -61,18 +69,36 @@ HttpResponse Router::route(const HttpRequest &request) const {
       continue; // Path doesn't match, try next route
     }
 
-    // Match found! Extract the path suffix (the part after the prefix)
-    RouteParams params;
-    params.path_suffix = path.substr(route.prefix.size());
-    // Example: path="/kv/hello", prefix="/kv/" → suffix="hello"
+    return &route;
+  }
+  return nullptr;
+}
+
+HttpResponse Router::route(const HttpRequest &request) const {
+  const std::string &path = request.path();
+  const Route *route = find(request);
 
-    // Call the handler function and return its response
-    return route.handler(request, params);
+  if (route == nullptr) {
+    // No route matched — return 404 Not Found
+    Logger::warning("No route matched for: " + path);
+    return HttpResponse::not_found().body("Not Found: " + path);
   }
 
-  // No route matched — return 404 Not Found
-  Logger::warning("No route matched for: " + path);
-  return HttpResponse::not_found().body("Not Found: " + path);
+  // Match found! Extract the path suffix (the part after the prefix)
+  RouteParams params;
+  params.path_suffix = path.substr(route->prefix.size());
+  // Example: path="/kv/hello", prefix="/kv/" → suffix="hello"
+
+  // Call the handler function and return its response
+  return route->handler(request, params);
+}
+
+// =============================================================================
+// streams_body() — Should the server leave the body to the handler?
+// =============================================================================
+bool Router::streams_body(const HttpRequest &request) const {
+  const Route *route = find(request);
+  return route != nullptr && route->streams_body;
 }
 
 } // namespace mini_redis
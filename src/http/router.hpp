@@ -68,6 +68,17 @@ public:
   void add_route(HttpMethod method, const std::string &prefix,
                  HandlerFunc handler);
 
+  // ---- Register a route that reads its own body ----
+  // Before routing, the server normally reads the whole request body into
+  // memory. A streaming route's handler gets only what arrived with the
+  // headers and pulls the rest with request.next_body_chunk() — for
+  // uploads too large to hold at once (POST /bulk/import).
+  void add_streaming_route(HttpMethod method, const std::string &prefix,
+                           HandlerFunc handler);
+
+  // Whether the route this request would take is a streaming one
+  bool streams_body(const HttpRequest &request) const;
+
   // ---- Route a request ----
   // Finds the matching handler for the given request and calls it.
   // If no route matches, returns 404 Not Found.
@@ -81,8 +92,12 @@ private:
     HttpMethod method;
     std::string prefix;
     HandlerFunc handler;
+    bool streams_body = false;
   };
 
+  // The first route matching the request, or nullptr
+  const Route *find(const HttpRequest &request) const;
+
   // All registered routes
   std::vector<Route> routes_;
 };
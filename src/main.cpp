@@ -11,57 +11,110 @@
 // to your program. Without handling it, the program is killed immediately,
 // which can leave resources in a dirty state (open files, half-written data).
 //
-// We install a signal handler that catches SIGINT and calls app.stop()
-// for a GRACEFUL SHUTDOWN — closing connections, flushing logs, etc.
+// SIGINT (and SIGTERM, what `kill` sends) calls app.stop() for a GRACEFUL
+// SHUTDOWN — closing connections, flushing logs, saving the snapshot.
 //
-// WHY IS THE SIGNAL HANDLER APPROACH TRICKY?
+// SIGHUP, by Unix tradition, means "re-read your configuration": it
+// reloads the live settings.
+//
+// WHY NOT A SIGNAL HANDLER?
 // Signal handlers run in a special context with severe restrictions:
 //   - Can't use most standard library functions (no cout, no new, no mutex)
 //   - Can only safely write to volatile sig_atomic_t variables
 //   - Must be as short as possible
 //
-// Our approach: set a global atomic flag in the handler, check it in the main
-// loop.
+// Stopping and reloading both lock and join threads, so neither can run
+// in one. All three signals go to one thread instead (see SignalThread).
 // =============================================================================
 
 #include "app/application.hpp"
+#include "util/allocator.hpp"
 #include "util/logger.hpp"
 
-// <csignal> provides signal() and SIGINT
-// <atomic> provides std::atomic for the signal flag
+// <csignal> provides SIGINT, SIGTERM and SIGHUP
+// <atomic> provides std::atomic for the thread's stop flag
 #include <atomic>
 #include <csignal>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include <pthread.h> // pthread_sigmask, pthread_kill
+
+namespace {
 
 // =============================================================================
-// Global signal flag
+// setup_huge_pages() — Optional huge-page arena, before the store exists
 // =============================================================================
-// WHY GLOBAL?
-// Signal handlers are C-style function pointers — they can't capture context
-// (unlike lambdas). So we use a global variable that both the signal handler
-// and main() can access.
-//
-// std::atomic_bool is thread-safe for simple reads/writes without a mutex.
-// We use a global pointer to the application so the signal handler can
-// call stop() on it.
+// huge_pages_mb=N (MINI_REDIS_HUGE_PAGES_MB, --huge-pages-mb) maps and
+// prefaults N MB of 2 MB pages for the store (see huge_page_arena.hpp).
+// It has to happen before anything is stored: blocks already on the
+// regular heap stay there.
 // =============================================================================
-namespace {
-
-// Global pointer to the running application (for signal handler access)
-// We use a raw pointer here (not smart pointer) because:
-//   - The application lives on the stack in main()
-//   - We're not transferring ownership
-//   - Signal handlers can't use complex types anyway
-mini_redis::Application *g_app = nullptr;
-
-// The signal handler function — called when Ctrl+C is pressed
-// "sig" is the signal number (SIGINT = 2)
-void signal_handler(int /*sig*/) {
-  // Set the stop flag — the accept loop will check this and exit
-  if (g_app != nullptr) {
-    g_app->stop();
+void setup_huge_pages(std::uint64_t megabytes) {
+  if (megabytes == 0) {
+    return;
+  }
+  if (!mini_redis::Allocator::use_page_arena(megabytes << 20)) {
+    mini_redis::Logger::warning("Huge-page arena unavailable, using the heap");
+    return;
   }
+  const auto stats = mini_redis::Allocator::stats();
+  mini_redis::Logger::info(
+      "Huge-page arena: " + std::to_string(megabytes) + " MB, " +
+      stats.page_backing + ", " + std::to_string(stats.huge_pages) +
+      " x 2 MB pages");
 }
 
+// =============================================================================
+// SignalThread — Stops the application, or reloads its settings
+// =============================================================================
+// A handler that did either itself would break every rule above (they
+// read files, allocate, lock, join). Instead the signals are BLOCKED in
+// every thread — the mask is inherited, so it's set before any thread
+// starts — and this one thread waits for them with sigwait(), which
+// returns each as an ordinary event: after that, anything goes.
+// =============================================================================
+class SignalThread {
+public:
+  explicit SignalThread(mini_redis::Application &app)
+      : thread_([this, &app] {
+          const sigset_t signals = handled_set();
+          int signal_number = 0;
+          while (sigwait(&signals, &signal_number) == 0 && !stopping_) {
+            if (signal_number == SIGHUP) {
+              mini_redis::Logger::info("SIGHUP: reloading the config");
+              app.config().reload();
+            } else {
+              app.stop(); // run() returns in the main thread
+            }
+          }
+        }) {}
+
+  // Wakes the thread with one of the signals it waits for
+  ~SignalThread() {
+    stopping_ = true;
+    pthread_kill(thread_.native_handle(), SIGHUP);
+    thread_.join();
+  }
+
+  SignalThread(const SignalThread &) = delete;
+  SignalThread &operator=(const SignalThread &) = delete;
+
+  static sigset_t handled_set() {
+    sigset_t set;
+    sigemptyset(&set);
+    sigaddset(&set, SIGHUP);
+    sigaddset(&set, SIGINT);
+    sigaddset(&set, SIGTERM);
+    return set;
+  }
+
+private:
+  std::atomic<bool> stopping_{false};
+  std::thread thread_;
+};
+
 } // anonymous namespace
 
 // =============================================================================
@@ -73,15 +126,29 @@ void signal_handler(int /*sig*/) {
 // argc = argument count (number of command-line arguments)
 // argv = argument vector (array of C-strings)
 //
-// For now, we hardcode port 8080 and 4 threads.
-// A production app would use a config file or command-line arguments.
+// The settings come from defaults, a config file, the environment and
+// these arguments, in that order (see app/config.hpp):
+//   mini_redis --config=mini_redis.conf --port=9090 --log-level=warning
 // =============================================================================
-int main() {
-  // Install the SIGINT handler (Ctrl+C)
-  // std::signal(signal_number, handler_function) returns the previous handler
-  std::signal(SIGINT, signal_handler);
+int main(int argc, char **argv) {
+  std::string error;
+  const auto sources = mini_redis::parse_command_line(argc, argv, error);
+  const auto config = sources.has_value()
+                          ? mini_redis::load_config(*sources, error)
+                          : std::nullopt;
+  if (!config.has_value()) {
+    mini_redis::Logger::error("Configuration: " + error);
+    return 1;
+  }
+  mini_redis::Logger::set_min_level(config->log_level);
+
+  // SIGINT, SIGTERM and SIGHUP are handled by SignalThread: block them
+  // everywhere else, before the Application starts any thread
+  const sigset_t signals = SignalThread::handled_set();
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
 
   mini_redis::Logger::info("Starting Mini Redis...");
+  setup_huge_pages(config->huge_pages_mb);
 
   // Create the application on the STACK (not the heap).
   // Stack allocation is faster than heap allocation (new/delete).
@@ -95,10 +162,10 @@ int main() {
   // 4 THREADS: one per CPU core is a good default.
   //   - More threads than cores = context switching overhead
   //   - Fewer threads than cores = underutilization
-  mini_redis::Application app(8080, 4);
-
-  // Set the global pointer so the signal handler can access it
-  g_app = &app;
+  //
+  // Both are only defaults: --port / --threads (or the config file) win.
+  mini_redis::Application app(*config, *sources);
+  SignalThread signal_thread(app);
 
   // Run the application (blocks until Ctrl+C)
   app.run();
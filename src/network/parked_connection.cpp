@@ -0,0 +1,53 @@
+// =============================================================================
+// parked_connection.cpp — A Client Connection Waiting for a Late Reply
+// (IMPLEMENTATION)
+// =============================================================================
+
+#include "network/parked_connection.hpp"
+
+#include <utility>
+
+namespace mini_redis {
+
+void ParkedConnection::attach(Socket socket) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (response_.has_value()) {
+    // The reply beat us here — send it now. 'socket' closes when this
+    // function returns (RAII).
+    socket.write_all(response_.value());
+    response_.reset();
+    return;
+  }
+
+  socket_ = std::move(socket);
+}
+
+bool ParkedConnection::complete(const std::string &raw_response) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  if (completed_) {
+    return false;
+  }
+  completed_ = true;
+
+  if (socket_.has_value()) {
+    socket_->write_all(raw_response);
+    socket_.reset(); // destroying the Socket closes the connection
+  } else {
+    response_ = raw_response; // attach() will deliver it
+  }
+  return true;
+}
+
+bool ParkedConnection::is_completed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return completed_;
+}
+
+bool ParkedConnection::peer_closed() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return socket_.has_value() && socket_->peer_closed();
+}
+
+} // namespace mini_redis
@@ -0,0 +1,56 @@
+// =============================================================================
+// parked_connection.hpp — A Client Connection Waiting for a Late Reply (HEADER)
+// =============================================================================
+//
+// THE PROBLEM:
+// A blocking command like BLPOP ("pop, or wait up to 30s for something to
+// pop") would normally keep its worker thread asleep for up to 30 seconds.
+// With 4 workers, 4 waiting clients freeze the whole server.
+//
+// THE SOLUTION: PARK THE CONNECTION, NOT THE THREAD
+// The worker hands the client's Socket to a ParkedConnection and goes back
+// to the pool. Later, whoever has the answer (a thread doing LPUSH, or the
+// timeout timer) calls complete(), which writes the reply and closes the
+// socket. A parked client costs one open socket and a few bytes — no thread.
+//
+// TWO-SIDED RENDEZVOUS:
+// The reply can arrive BEFORE the worker has attached the socket (the
+// LPUSH lands a microsecond after we decided to park). So both orders work:
+//   attach() then complete() → complete() writes to the stored socket
+//   complete() then attach() → attach() writes the stored reply immediately
+// =============================================================================
+
+#pragma once
+
+#include "network/socket.hpp"
+
+#include <mutex>
+#include <optional>
+#include <string>
+
+namespace mini_redis {
+
+class ParkedConnection {
+public:
+  // Hand over the client socket (called by the worker after routing)
+  void attach(Socket socket);
+
+  // Deliver the raw reply bytes. Only the FIRST call wins (a timeout and a
+  // push may race to answer the same client); returns false for later calls.
+  bool complete(const std::string &raw_response);
+
+  // Has a reply already been delivered (or queued for delivery)?
+  bool is_completed() const;
+
+  // Has the client hung up while it waited? false until attach(): a
+  // socket we don't hold yet can't be checked.
+  bool peer_closed() const;
+
+private:
+  mutable std::mutex mutex_;
+  std::optional<Socket> socket_;          // set by attach()
+  std::optional<std::string> response_;   // set by complete() before attach()
+  bool completed_ = false;
+};
+
+} // namespace mini_redis
@@ -5,13 +5,16 @@
 #include "network/socket.hpp"
 #include "util/logger.hpp"
 
-#include <array>   // std::array — fixed-size array (safer than C arrays)
+#include <arpa/inet.h> // inet_ntop — binary address to "a.b.c.d"
+#include <cerrno>      // errno, EAGAIN
+
 #include <cstring> // std::memset — fill memory with zeros
+#include <utility> // std::exchange, std::move — used by the move operations
 
 namespace mini_redis {
 
 // =============================================================================
-// BUFFER_SIZE — How many bytes to read at once
+// BUFFER_SIZE — How many bytes to read at once (by default)
 // =============================================================================
 // "constexpr" means "constant expression" — evaluated at COMPILE TIME.
 // Unlike "const" (which means "can't change at runtime"), constexpr means
@@ -28,10 +31,22 @@ namespace mini_redis {
 // =============================================================================
 constexpr std::size_t BUFFER_SIZE = 4096;
 
+std::atomic<std::size_t> Socket::read_buffer_bytes_{BUFFER_SIZE};
+
+void Socket::set_read_buffer_bytes(std::size_t bytes) {
+  read_buffer_bytes_.store(bytes == 0 ? BUFFER_SIZE : bytes,
+                           std::memory_order_relaxed);
+}
+
+std::size_t Socket::read_buffer_bytes() {
+  return read_buffer_bytes_.load(std::memory_order_relaxed);
+}
+
 // =============================================================================
 // Private constructor — wrap an existing file descriptor
 // =============================================================================
-Socket::Socket(int fd) : fd_(fd) {
+Socket::Socket(int fd, std::string peer_address)
+    : fd_(fd), peer_address_(std::move(peer_address)) {
   // Just stores the file descriptor. The OS already created the socket.
 }
 
@@ -60,7 +75,9 @@ Socket::~Socket() { close_socket(); }
 //   2. Sets a to b (-1)
 // This is cleaner than: this->fd_ = other.fd_; other.fd_ = -1;
 // =============================================================================
-Socket::Socket(Socket &&other) noexcept : fd_(std::exchange(other.fd_, -1)) {
+Socket::Socket(Socket &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      peer_address_(std::move(other.peer_address_)) {
   // all done in the initializer list
 }
 
@@ -78,6 +95,7 @@ Socket &Socket::operator=(Socket &&other) noexcept {
 
     // Steal the other socket's file descriptor
     fd_ = std::exchange(other.fd_, -1);
+    peer_address_ = std::move(other.peer_address_);
   }
 
   // Return *this to allow chaining: a = b = std::move(c);
@@ -186,29 +204,44 @@ std::optional<Socket> Socket::accept_connection() {
   // descriptor for the client connection. The original socket continues
   // listening for more connections.
   //
-  // We pass nullptr for the client address — we don't need to know
-  // who connected (for simplicity). In production, you might log the
-  // client's IP address for security/monitoring.
-  const int client_fd = ::accept(fd_, nullptr, nullptr);
+  // accept() also fills in the client's address, which the rate limiter
+  // uses to tell clients apart (see peer_address()).
+  sockaddr_in address{};
+  socklen_t address_size = sizeof(address);
+  const int client_fd =
+      ::accept(fd_, reinterpret_cast<sockaddr *>(&address), &address_size);
 
   if (client_fd < 0) {
-    Logger::error("Failed to accept connection");
+    if (errno != EINVAL) { // EINVAL: shut_down() ended the listening
+      Logger::error("Failed to accept connection");
+    }
     return std::nullopt;
   }
 
-  return Socket(client_fd);
+  char text[INET_ADDRSTRLEN] = {};
+  if (::inet_ntop(AF_INET, &address.sin_addr, text, sizeof(text)) ==
+      nullptr) {
+    text[0] = '\0';
+  }
+  return Socket(client_fd, text);
+}
+
+void Socket::shut_down() {
+  if (fd_ >= 0) {
+    ::shutdown(fd_, SHUT_RDWR);
+  }
 }
 
 // =============================================================================
-// read_all() — Read all available data from the socket
+// read_all() / read_some() — Read the data that has arrived
 // =============================================================================
-std::string Socket::read_all() {
-  // std::array is a fixed-size array that knows its own size.
-  // Unlike C arrays (char buf[4096]):
-  //   - Doesn't decay to a pointer
-  //   - Has .size(), .data(), .begin(), .end()
-  //   - Can be passed by value (though you usually pass by reference)
-  std::array<char, BUFFER_SIZE> buffer{}; // Zero-initialized
+std::string Socket::read_all() { return read_some(read_buffer_bytes()); }
+
+std::string Socket::read_some(std::size_t max_bytes) {
+  // The size is a runtime value, so the buffer is a std::string rather
+  // than a std::array (whose size must be known at compile time). Reading
+  // straight into the string also saves copying the bytes out afterwards.
+  std::string buffer(max_bytes, '\0');
 
   // recv() reads up to buffer.size() bytes from the socket.
   // Returns the number of bytes actually read, 0 on disconnect, -1 on error.
@@ -218,28 +251,39 @@ std::string Socket::read_all() {
     return ""; // Error or client disconnected
   }
 
-  // Construct a string from the buffer, using only the bytes we actually read
-  return std::string(buffer.data(), static_cast<std::size_t>(bytes_read));
+  // Keep only the bytes we actually read
+  buffer.resize(static_cast<std::size_t>(bytes_read));
+  return buffer;
 }
 
 // =============================================================================
 // write_all() — Send all data through the socket
 // =============================================================================
-bool Socket::write_all(const std::string &data) {
+bool Socket::write_all(std::string_view data) {
   // Total number of bytes to send
   std::size_t total_sent = 0;
   const std::size_t data_size = data.size();
 
+  // MSG_NOSIGNAL: if the client already hung up (e.g. it gave up waiting
+  // on a BLPOP), send() would raise SIGPIPE, whose default action KILLS the
+  // whole server. With this flag send() just fails with EPIPE instead.
+  // macOS lacks the flag, hence the #ifdef.
+#ifdef MSG_NOSIGNAL
+  const int send_flags = MSG_NOSIGNAL;
+#else
+  const int send_flags = 0;
+#endif
+
   // We loop because send() might not send ALL bytes at once.
   // This is a common networking pitfall — the OS might only accept
   // part of your data if its internal buffer is full.
   while (total_sent < data_size) {
-    // .c_str() returns a const char* (C-style string pointer)
+    // .data() returns a const char* to the first byte (a string_view,
+    // unlike a std::string, has no c_str(): it needn't end in '\0').
     // We offset it by total_sent to continue from where we left off
     const ssize_t bytes_sent =
-        ::send(fd_, data.c_str() + total_sent, data_size - total_sent,
-               0 // flags (0 = no special behavior)
-        );
+        ::send(fd_, data.data() + total_sent, data_size - total_sent,
+               send_flags);
 
     if (bytes_sent < 0) {
       Logger::error("Failed to send data");
@@ -252,11 +296,35 @@ bool Socket::write_all(const std::string &data) {
   return true;
 }
 
+// =============================================================================
+// peer_closed() — Peek one byte without waiting
+// =============================================================================
+// recv() returning 0 means end-of-stream: the peer closed. EAGAIN means
+// "nothing to read yet" — still connected. Bytes waiting (a pipelined
+// request) also mean connected; MSG_PEEK leaves them in place.
+// =============================================================================
+bool Socket::peer_closed() const {
+  if (fd_ < 0) {
+    return true;
+  }
+  char byte = 0;
+  const ssize_t peeked = ::recv(fd_, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+  if (peeked > 0) {
+    return false;
+  }
+  if (peeked == 0) {
+    return true;
+  }
+  return errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+}
+
 // =============================================================================
 // file_descriptor() — Getter for the raw fd (for debugging)
 // =============================================================================
 int Socket::file_descriptor() const { return fd_; }
 
+const std::string &Socket::peer_address() const { return peer_address_; }
+
 // =============================================================================
 // close_socket() — Close the file descriptor
 // =============================================================================
@@ -37,8 +37,11 @@
 #include <sys/socket.h> // socket(), bind(), listen(), accept()
 #include <unistd.h>     // close() (close file descriptors)
 
+#include <atomic>
+#include <cstddef>
 #include <optional>
 #include <string>
+#include <string_view>
 
 namespace mini_redis {
 
@@ -114,21 +117,50 @@ public:
   // connections.
   std::optional<Socket> accept_connection();
 
+  // ---- Shut down both directions ----
+  // On a listening socket, wakes a thread blocked in accept_connection()
+  // (which then fails); the descriptor stays open until the destructor.
+  void shut_down();
+
   // ---- Read data from the socket ----
   // Returns the data as a string, or empty string on error/disconnect.
   std::string read_all();
 
+  // ---- Read at most 'max_bytes' ----
+  // Whatever has arrived, up to 'max_bytes' (blocking until something
+  // has); empty on error/disconnect. read_all() is read_some() with the
+  // configured buffer size; a bulk upload asks for much more per call.
+  std::string read_some(std::size_t max_bytes);
+
+  // ---- How many bytes read_all() asks the OS for at once ----
+  // Process-wide (every connection), and safe to change while the server
+  // runs: the next read uses the new size.
+  static void set_read_buffer_bytes(std::size_t bytes);
+  static std::size_t read_buffer_bytes();
+
   // ---- Write data to the socket ----
   // Returns true if all bytes were sent successfully.
-  bool write_all(const std::string &data);
+  bool write_all(std::string_view data);
+
+  // ---- Has the client hung up? ----
+  // Checks without blocking or consuming anything: true once the peer
+  // has closed (or reset) the connection. A client that only shut down
+  // its sending side looks the same — for a parked request-reply client
+  // that is a fair guess.
+  bool peer_closed() const;
 
   // ---- Get the raw file descriptor (for logging/debugging) ----
   int file_descriptor() const;
 
+  // ---- Who is on the other end ----
+  // The client's IPv4 address ("203.0.113.7") for an accepted connection;
+  // empty for a socket we created ourselves.
+  const std::string &peer_address() const;
+
 private:
   // ---- Private constructor from an existing file descriptor ----
   // Used internally by accept_connection() which gets an fd from the OS.
-  explicit Socket(int fd);
+  explicit Socket(int fd, std::string peer_address = {});
 
   // ---- Close the socket (internal helper) ----
   void close_socket();
@@ -138,6 +170,10 @@ private:
   // File descriptors are small non-negative integers that the OS uses
   // to identify open files, sockets, pipes, etc.
   int fd_ = -1;
+
+  std::string peer_address_;
+
+  static std::atomic<std::size_t> read_buffer_bytes_;
 };
 
 } // namespace mini_redis
@@ -74,6 +74,11 @@ void TcpServer::start(ConnectionHandler handler) {
 
   Logger::info("Mini Redis server listening on port " + std::to_string(port_));
 
+  {
+    std::lock_guard<std::mutex> lock(listening_mutex_);
+    listening_ = &server_socket.value();
+  }
+
   // Wrap handler in shared_ptr so lambdas can share it safely
   auto shared_handler = std::make_shared<ConnectionHandler>(std::move(handler));
 
@@ -106,19 +111,29 @@ void TcpServer::start(ConnectionHandler handler) {
     });
   }
 
+  {
+    std::lock_guard<std::mutex> lock(listening_mutex_);
+    listening_ = nullptr;
+  }
   Logger::info("Server accept loop stopped");
 }
 
 // =============================================================================
 // stop() — Signal the accept loop to exit
 // =============================================================================
+// The accept loop is most likely blocked in accept_connection(), where
+// it would only see the flag after the next client connects: shutting
+// the listening socket down makes that accept() fail at once instead.
+// =============================================================================
 void TcpServer::stop() {
-  stop_requested_.store(true);
+  if (stop_requested_.exchange(true)) {
+    return;
+  }
 
-  // NOTE: The accept loop might be blocked in accept_connection().
-  // We rely on the destructor of the server_socket (when start() returns)
-  // to close the listening socket, which will cause accept() to return
-  // with an error, breaking the loop.
+  std::lock_guard<std::mutex> lock(listening_mutex_);
+  if (listening_ != nullptr) {
+    listening_->shut_down();
+  }
   Logger::info("Server stop requested");
 }
 
@@ -25,6 +25,7 @@
 
 #include <atomic>     // std::atomic
 #include <functional> // std::function
+#include <mutex>      // std::mutex
 
 namespace mini_redis {
 
@@ -57,7 +58,8 @@ public:
   // This function BLOCKS — it runs the accept loop until stop() is called.
   void start(ConnectionHandler handler);
 
-  // Stop the server (signal the accept loop to exit)
+  // Stop the server: the accept loop exits, and start() returns.
+  // Safe from any thread, before, during or after start().
   void stop();
 
 private:
@@ -69,6 +71,11 @@ private:
 
   // Flag to signal the accept loop to stop
   std::atomic<bool> stop_requested_{false};
+
+  // The socket start() is accepting on, so stop() can wake it; nullptr
+  // outside start(). Guarded by listening_mutex_.
+  std::mutex listening_mutex_;
+  Socket *listening_ = nullptr;
 };
 
 } // namespace mini_redis
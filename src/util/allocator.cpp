@@ -0,0 +1,538 @@
+// =============================================================================
+// allocator.cpp — Pluggable Memory Allocator with Per-Thread Caches (IMPL)
+// =============================================================================
+//
+// Three backends behind one set of functions, picked by the preprocessor:
+//   MINI_REDIS_USE_JEMALLOC / MINI_REDIS_USE_MIMALLOC are defined by the
+//   top-level CMakeLists when the library was found; otherwise this is the
+//   "system" backend — glibc malloc fronted by our own thread caches.
+//
+// CAREFUL: the server binary sends every operator new/delete through
+// here, so nothing on these paths may itself use new (no std::string, no
+// std::vector, no Logger). The registry of thread caches is an intrusive
+// list under a plain std::mutex, which never allocates.
+// =============================================================================
+
+#include "util/allocator.hpp"
+#include "util/huge_page_arena.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <new>      // placement new
+#include <unistd.h> // sysconf
+
+#if defined(MINI_REDIS_USE_JEMALLOC)
+#include <jemalloc/jemalloc.h>
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+#include <mimalloc.h>
+#elif defined(__GLIBC__)
+#include <malloc.h> // malloc_usable_size, malloc_trim, mallinfo2
+#elif defined(__APPLE__)
+#include <malloc/malloc.h> // malloc_size
+#endif
+
+namespace mini_redis {
+
+namespace {
+
+// ---- Shared state: decay timer, purge count, global counters ----
+std::atomic<std::uint64_t> g_decay_ms{0};
+std::atomic<std::int64_t> g_last_purge_ms{0};
+std::atomic<std::uint64_t> g_purges{0};
+
+std::int64_t now_ms() {
+  return std::chrono::duration_cast<std::chrono::milliseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Resident set size from /proc/self/statm ("size resident shared ...",
+// counted in pages). fopen/fscanf use malloc, not operator new.
+std::uint64_t resident_bytes() {
+  std::FILE *file = std::fopen("/proc/self/statm", "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  unsigned long long size = 0;
+  unsigned long long resident = 0;
+  const int read = std::fscanf(file, "%llu %llu", &size, &resident);
+  std::fclose(file);
+  if (read != 2) {
+    return 0;
+  }
+  return resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+#if !defined(MINI_REDIS_USE_JEMALLOC) && !defined(MINI_REDIS_USE_MIMALLOC)
+
+// =============================================================================
+// ThreadCache — One thread's free lists (system backend only)
+// =============================================================================
+// Size class i holds blocks of exactly (i + 1) * 16 bytes, so a request is
+// rounded up to the next multiple of 16 and a free block is its own list
+// node (the first 8 bytes point at the next free block). Anything larger
+// than 1 KB goes straight to malloc — big blocks are rare and expensive to
+// park.
+//
+// A thread never holds more than MAX_CACHED_BYTES; past that, frees go
+// straight back to malloc. A thread that frees far more than it allocates
+// (a connection handed from the acceptor to a worker) therefore can't
+// hoard memory.
+//
+// The counters are atomics only so stats() can read them from another
+// thread; the owner updates them with relaxed ordering, which compiles to
+// plain loads and stores.
+// =============================================================================
+constexpr std::size_t CLASS_GRANULE = 16;
+constexpr std::size_t CLASS_COUNT = 64;
+constexpr std::size_t MAX_SMALL = CLASS_GRANULE * CLASS_COUNT; // 1024
+constexpr std::size_t MAX_CACHED_BYTES = 512 * 1024;
+
+struct FreeBlock {
+  FreeBlock *next;
+};
+
+std::atomic<std::uint64_t> g_purge_epoch{0};
+
+// The huge-page arena, once use_page_arena() has set it up. It is never
+// destroyed: blocks from it may still be freed during static destruction.
+std::atomic<HugePageArena *> g_arena{nullptr};
+std::mutex g_arena_mutex;
+alignas(HugePageArena) unsigned char g_arena_storage[sizeof(HugePageArena)];
+
+// Set by RelocationScope: this thread is copying blocks for the
+// defragmenter, so it talks to the arena directly
+thread_local bool t_relocating = false;
+
+// A block the thread cache is done with goes back where it came from
+void release(void *ptr, std::size_t index) {
+  HugePageArena *arena = g_arena.load(std::memory_order_acquire);
+  if (arena != nullptr && arena->contains(ptr)) {
+    arena->deallocate_small(ptr, index);
+  } else {
+    std::free(ptr);
+  }
+}
+
+// A cache miss: carve from the arena if there is one, else malloc. Always
+// the full class size, so the block can later serve any request in the
+// class.
+void *refill(std::size_t index) {
+  HugePageArena *arena = g_arena.load(std::memory_order_acquire);
+  if (arena != nullptr) {
+    if (void *block = arena->allocate_small(index)) {
+      return block;
+    }
+  }
+  return std::malloc((index + 1) * CLASS_GRANULE);
+}
+
+// Totals of threads that have exited, so stats() doesn't go backwards
+std::atomic<std::uint64_t> g_retired_allocations{0};
+std::atomic<std::uint64_t> g_retired_frees{0};
+std::atomic<std::uint64_t> g_retired_hits{0};
+
+struct ThreadCache;
+std::mutex g_registry_mutex;
+ThreadCache *g_registry = nullptr;
+
+struct ThreadCache {
+  FreeBlock *lists[CLASS_COUNT] = {};
+  std::size_t bytes = 0;
+  std::uint64_t epoch = 0;
+
+  std::atomic<std::uint64_t> allocations{0};
+  std::atomic<std::uint64_t> frees{0};
+  std::atomic<std::uint64_t> hits{0};
+  std::atomic<std::uint64_t> cached_bytes{0};
+
+  ThreadCache *prev = nullptr;
+  ThreadCache *next = nullptr;
+
+  ThreadCache();
+  ~ThreadCache();
+
+  void flush() {
+    for (std::size_t index = 0; index < CLASS_COUNT; ++index) {
+      while (lists[index] != nullptr) {
+        FreeBlock *block = lists[index];
+        lists[index] = block->next;
+        release(block, index);
+      }
+    }
+    bytes = 0;
+    cached_bytes.store(0, std::memory_order_relaxed);
+  }
+
+  void bump(std::atomic<std::uint64_t> &counter) {
+    counter.store(counter.load(std::memory_order_relaxed) + 1,
+                  std::memory_order_relaxed);
+  }
+};
+
+// Both trivially destructible, so they stay readable while (and after) the
+// thread's other thread_locals are destroyed: frees that arrive during
+// thread teardown see DEAD and go straight to free(). t_cache is the fast
+// path — a plain pointer load instead of the guard check a thread_local
+// object with a constructor costs on every access.
+enum class CacheState : unsigned char { UNSET, ALIVE, DEAD };
+thread_local CacheState t_state = CacheState::UNSET;
+thread_local ThreadCache *t_cache = nullptr;
+
+ThreadCache::ThreadCache() {
+  epoch = g_purge_epoch.load(std::memory_order_relaxed);
+  std::lock_guard<std::mutex> lock(g_registry_mutex);
+  next = g_registry;
+  if (next != nullptr) {
+    next->prev = this;
+  }
+  g_registry = this;
+}
+
+ThreadCache::~ThreadCache() {
+  t_state = CacheState::DEAD;
+  t_cache = nullptr;
+  flush();
+  g_retired_allocations.fetch_add(allocations.load());
+  g_retired_frees.fetch_add(frees.load());
+  g_retired_hits.fetch_add(hits.load());
+
+  std::lock_guard<std::mutex> lock(g_registry_mutex);
+  (prev != nullptr ? prev->next : g_registry) = next;
+  if (next != nullptr) {
+    next->prev = prev;
+  }
+}
+
+ThreadCache *this_thread_cache() {
+  ThreadCache *cache = t_cache;
+  if (cache == nullptr) {
+    if (t_state == CacheState::DEAD) {
+      return nullptr;
+    }
+    thread_local ThreadCache storage;
+    t_state = CacheState::ALIVE;
+    t_cache = cache = &storage;
+  }
+  // Someone called purge(): drop what we hold before using the cache
+  const std::uint64_t epoch = g_purge_epoch.load(std::memory_order_relaxed);
+  if (cache->epoch != epoch) {
+    cache->epoch = epoch;
+    cache->flush();
+  }
+  return cache;
+}
+
+std::size_t class_for_request(std::size_t size) {
+  return size == 0 ? 0 : (size - 1) / CLASS_GRANULE;
+}
+
+// How big a malloc'd block really is; 0 where libc can't tell us (the
+// block then skips the cache)
+std::size_t usable_size(void *ptr) {
+#if defined(__GLIBC__)
+  return malloc_usable_size(ptr);
+#elif defined(__APPLE__)
+  return malloc_size(ptr);
+#else
+  (void)ptr;
+  return 0;
+#endif
+}
+
+#endif // system backend
+
+} // anonymous namespace
+
+// =============================================================================
+// allocate() / deallocate()
+// =============================================================================
+void *Allocator::allocate(std::size_t size) {
+#if defined(MINI_REDIS_USE_JEMALLOC)
+  return std::malloc(size == 0 ? 1 : size);
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+  return mi_malloc(size == 0 ? 1 : size);
+#else
+  ThreadCache *cache = this_thread_cache();
+  if (cache != nullptr) {
+    cache->bump(cache->allocations);
+  }
+  if (t_relocating && size <= MAX_SMALL) {
+    return refill(class_for_request(size)); // a dense slab, not the cache
+  }
+  if (size > MAX_SMALL) {
+    HugePageArena *arena = g_arena.load(std::memory_order_acquire);
+    if (arena != nullptr && size >= HugePageArena::LARGE_MIN) {
+      if (void *block = arena->allocate_large(size)) {
+        return block;
+      }
+    }
+    return std::malloc(size);
+  }
+  const std::size_t index = class_for_request(size);
+  if (cache != nullptr && cache->lists[index] != nullptr) {
+    FreeBlock *block = cache->lists[index];
+    cache->lists[index] = block->next;
+    cache->bytes -= (index + 1) * CLASS_GRANULE;
+    cache->cached_bytes.store(cache->bytes, std::memory_order_relaxed);
+    cache->bump(cache->hits);
+    return block;
+  }
+  return refill(index);
+#endif
+}
+
+void Allocator::deallocate(void *ptr, std::size_t size) {
+  if (ptr == nullptr) {
+    return;
+  }
+#if defined(MINI_REDIS_USE_JEMALLOC)
+  if (size != 0) {
+    sdallocx(ptr, size, 0); // sized free skips the size lookup
+  } else {
+    std::free(ptr);
+  }
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+  if (size != 0) {
+    mi_free_size(ptr, size);
+  } else {
+    mi_free(ptr);
+  }
+#else
+  ThreadCache *cache = this_thread_cache();
+  if (cache != nullptr) {
+    cache->bump(cache->frees);
+  }
+  std::size_t index;
+  HugePageArena *arena = g_arena.load(std::memory_order_acquire);
+  if (arena != nullptr && arena->contains(ptr)) {
+    // The span knows its size class, whatever 'size' says
+    const int size_class = arena->size_class_of(ptr);
+    if (size_class < 0) {
+      arena->deallocate(ptr); // a large block: give its spans back
+      return;
+    }
+    index = static_cast<std::size_t>(size_class);
+    if (t_relocating) {
+      arena->deallocate_small(ptr, index);
+      return;
+    }
+  } else if (size != 0) {
+    if (size > MAX_SMALL) {
+      std::free(ptr);
+      return;
+    }
+    index = class_for_request(size);
+  } else {
+    // Unsized frees (plain delete, C++ code compiled without sized
+    // deallocation) ask malloc how big the block really is and file it
+    // under the largest class it can serve
+    const std::size_t usable = usable_size(ptr);
+    if (usable < CLASS_GRANULE || usable >= MAX_SMALL + CLASS_GRANULE) {
+      std::free(ptr);
+      return;
+    }
+    index = usable / CLASS_GRANULE - 1;
+  }
+
+  const std::size_t block_bytes = (index + 1) * CLASS_GRANULE;
+  if (cache == nullptr || cache->bytes + block_bytes > MAX_CACHED_BYTES) {
+    release(ptr, index);
+    return;
+  }
+  auto *block = static_cast<FreeBlock *>(ptr);
+  block->next = cache->lists[index];
+  cache->lists[index] = block;
+  cache->bytes += block_bytes;
+  cache->cached_bytes.store(cache->bytes, std::memory_order_relaxed);
+#endif
+}
+
+// =============================================================================
+// use_page_arena() — Put a preallocated page arena under the caches
+// =============================================================================
+// jemalloc and mimalloc manage their own pages and take huge pages from
+// their own options, so the arena is a system-backend feature:
+//   jemalloc  MALLOC_CONF="thp:always,metadata_thp:always"
+//   mimalloc  MIMALLOC_ALLOW_LARGE_OS_PAGES=1
+// =============================================================================
+bool Allocator::use_page_arena(std::size_t bytes, bool huge_pages) {
+#if defined(MINI_REDIS_USE_JEMALLOC) || defined(MINI_REDIS_USE_MIMALLOC)
+  (void)bytes;
+  (void)huge_pages;
+  return false;
+#else
+  std::lock_guard<std::mutex> lock(g_arena_mutex);
+  if (g_arena.load(std::memory_order_relaxed) != nullptr) {
+    return false; // one arena per process
+  }
+  auto *arena = new (g_arena_storage) HugePageArena(bytes, huge_pages);
+  if (arena->backing() == PageBacking::UNMAPPED) {
+    arena->~HugePageArena();
+    return false;
+  }
+  g_arena.store(arena, std::memory_order_release);
+  return true;
+#endif
+}
+
+// =============================================================================
+// should_relocate() / RelocationScope — Hooks for the defragmenter
+// =============================================================================
+bool Allocator::should_relocate(const void *ptr) {
+#if defined(MINI_REDIS_USE_JEMALLOC) || defined(MINI_REDIS_USE_MIMALLOC)
+  (void)ptr;
+  return false;
+#else
+  const HugePageArena *arena = g_arena.load(std::memory_order_acquire);
+  return arena != nullptr && arena->should_relocate(ptr);
+#endif
+}
+
+Allocator::RelocationScope::RelocationScope() {
+#if !defined(MINI_REDIS_USE_JEMALLOC) && !defined(MINI_REDIS_USE_MIMALLOC)
+  t_relocating = true;
+#endif
+}
+
+Allocator::RelocationScope::~RelocationScope() {
+#if !defined(MINI_REDIS_USE_JEMALLOC) && !defined(MINI_REDIS_USE_MIMALLOC)
+  t_relocating = false;
+#endif
+}
+
+// =============================================================================
+// purge() / set_decay_ms() / tick()
+// =============================================================================
+void Allocator::purge() {
+#if defined(MINI_REDIS_USE_JEMALLOC)
+  // "arena.<MALLCTL_ARENAS_ALL>.purge": every arena returns its dirty pages
+  char command[64];
+  std::snprintf(command, sizeof(command), "arena.%u.purge",
+                static_cast<unsigned>(MALLCTL_ARENAS_ALL));
+  mallctl(command, nullptr, nullptr, nullptr, 0);
+  mallctl("thread.tcache.flush", nullptr, nullptr, nullptr, 0);
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+  mi_collect(true);
+#else
+  // Other threads empty their caches on their next allocation; this one
+  // does it now, then glibc gives free pages at the top of each arena back
+  g_purge_epoch.fetch_add(1, std::memory_order_relaxed);
+  this_thread_cache();
+#if defined(__GLIBC__)
+  malloc_trim(0);
+#endif
+#endif
+  g_purges.fetch_add(1, std::memory_order_relaxed);
+  g_last_purge_ms.store(now_ms(), std::memory_order_relaxed);
+}
+
+void Allocator::set_decay_ms(std::uint64_t ms) {
+  g_decay_ms.store(ms, std::memory_order_relaxed);
+  g_last_purge_ms.store(now_ms(), std::memory_order_relaxed);
+#if defined(MINI_REDIS_USE_JEMALLOC)
+  // jemalloc decays on its own; hand it the same interval (new arenas and
+  // every existing one)
+  ssize_t decay = static_cast<ssize_t>(ms);
+  mallctl("arenas.dirty_decay_ms", nullptr, nullptr, &decay, sizeof(decay));
+  unsigned arenas = 0;
+  std::size_t length = sizeof(arenas);
+  if (mallctl("arenas.narenas", &arenas, &length, nullptr, 0) == 0) {
+    char command[64];
+    for (unsigned i = 0; i < arenas; ++i) {
+      std::snprintf(command, sizeof(command), "arena.%u.dirty_decay_ms", i);
+      mallctl(command, nullptr, nullptr, &decay, sizeof(decay));
+    }
+  }
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+  mi_option_set(mi_option_purge_delay, static_cast<long>(ms));
+#endif
+}
+
+void Allocator::tick() {
+  const std::uint64_t decay = g_decay_ms.load(std::memory_order_relaxed);
+  if (decay == 0) {
+    return;
+  }
+  const std::int64_t elapsed =
+      now_ms() - g_last_purge_ms.load(std::memory_order_relaxed);
+  if (elapsed >= static_cast<std::int64_t>(decay)) {
+    purge();
+  }
+}
+
+// =============================================================================
+// stats() / backend_name()
+// =============================================================================
+const char *Allocator::backend_name() {
+#if defined(MINI_REDIS_USE_JEMALLOC)
+  return "jemalloc";
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+  return "mimalloc";
+#else
+  return "system";
+#endif
+}
+
+AllocatorStats Allocator::stats() {
+  AllocatorStats stats;
+  stats.backend = backend_name();
+  stats.decay_ms = g_decay_ms.load(std::memory_order_relaxed);
+  stats.purges = g_purges.load(std::memory_order_relaxed);
+  stats.resident_bytes = resident_bytes();
+
+#if defined(MINI_REDIS_USE_JEMALLOC)
+  // Statistics are refreshed when the "epoch" is written
+  std::uint64_t epoch = 1;
+  std::size_t length = sizeof(epoch);
+  mallctl("epoch", &epoch, &length, &epoch, length);
+  std::size_t allocated = 0;
+  std::size_t active = 0;
+  length = sizeof(std::size_t);
+  mallctl("stats.allocated", &allocated, &length, nullptr, 0);
+  mallctl("stats.active", &active, &length, nullptr, 0);
+  stats.heap_used_bytes = allocated;
+  stats.heap_free_bytes = active > allocated ? active - allocated : 0;
+#elif defined(MINI_REDIS_USE_MIMALLOC)
+  std::size_t elapsed = 0, user = 0, system = 0, current_rss = 0,
+              peak_rss = 0, current_commit = 0, peak_commit = 0, faults = 0;
+  mi_process_info(&elapsed, &user, &system, &current_rss, &peak_rss,
+                  &current_commit, &peak_commit, &faults);
+  stats.heap_used_bytes = current_commit;
+#else
+  stats.allocations = g_retired_allocations.load(std::memory_order_relaxed);
+  stats.frees = g_retired_frees.load(std::memory_order_relaxed);
+  stats.cache_hits = g_retired_hits.load(std::memory_order_relaxed);
+  {
+    std::lock_guard<std::mutex> lock(g_registry_mutex);
+    for (const ThreadCache *cache = g_registry; cache != nullptr;
+         cache = cache->next) {
+      stats.allocations += cache->allocations.load(std::memory_order_relaxed);
+      stats.frees += cache->frees.load(std::memory_order_relaxed);
+      stats.cache_hits += cache->hits.load(std::memory_order_relaxed);
+      stats.cached_bytes += cache->cached_bytes.load(std::memory_order_relaxed);
+      ++stats.threads;
+    }
+  }
+  if (const HugePageArena *arena = g_arena.load(std::memory_order_acquire)) {
+    const HugePageArenaStats arena_stats = arena->stats();
+    stats.page_backing = to_string(arena_stats.backing);
+    stats.arena_capacity_bytes = arena_stats.capacity_bytes;
+    stats.arena_used_bytes = arena_stats.slab_bytes + arena_stats.large_bytes;
+    stats.arena_slab_bytes = arena_stats.slab_bytes;
+    stats.arena_live_bytes = arena_stats.live_bytes;
+    stats.huge_pages = arena_stats.huge_pages;
+  }
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || __GLIBC_MINOR__ >= 33)
+  const struct mallinfo2 info = mallinfo2();
+  stats.heap_used_bytes = info.uordblks + info.hblkhd;
+  stats.heap_free_bytes = info.fordblks;
+#endif
+#endif
+  return stats;
+}
+
+} // namespace mini_redis
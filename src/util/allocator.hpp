@@ -0,0 +1,157 @@
+// =============================================================================
+// allocator.hpp — Pluggable Memory Allocator with Per-Thread Caches (HEADER)
+// =============================================================================
+//
+// WHY NOT JUST malloc()?
+// Every request allocates: the request text, parsed headers, the key, the
+// value, the response. glibc malloc serves threads from a handful of
+// shared "arenas" guarded by locks, so busy workers queue on the same
+// arena, and memory freed by one thread sits in another's arena where it
+// fragments the heap. Allocators like jemalloc and mimalloc fix this with
+// PER-THREAD CACHES: a small free list per size class that a thread can
+// pop and push without talking to anyone.
+//
+// WHAT THIS FILE PROVIDES:
+// One interface — Allocator::allocate() / deallocate() — with a backend
+// chosen when the project is CONFIGURED (see the top-level CMakeLists):
+//
+//   jemalloc  linked if found; it brings its own thread caches and decay
+//   mimalloc  likewise
+//   system    glibc malloc, plus the small per-thread cache in this file:
+//             64 size classes (16..1024 bytes, in steps of 16), each a
+//             singly linked list threaded through the free blocks
+//
+// With use_page_arena(), the system backend's caches refill from a
+// preallocated arena of 2 MB pages instead of malloc.
+//
+// The store's hash table allocates through StlAllocator below, and the
+// server binary routes every operator new/delete here (new_delete.cpp),
+// which covers the I/O buffers and everything on the request path.
+//
+// PURGE AND DECAY:
+// Caches trade memory for speed. purge() hands cached blocks back and asks
+// the backend to return free pages to the OS; set_decay_ms() makes that
+// happen on a timer (driven by tick(), which the expiry thread calls).
+// Other threads notice a purge through a global "epoch" counter and empty
+// their own caches on their next allocation — nobody touches another
+// thread's free lists.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new> // std::bad_alloc
+
+namespace mini_redis {
+
+// A point-in-time view for /admin/memory. Fields a backend can't report
+// are 0.
+struct AllocatorStats {
+  const char *backend = "";
+  std::uint64_t allocations = 0; // allocate() calls
+  std::uint64_t frees = 0;       // deallocate() calls
+  std::uint64_t cache_hits = 0;  // served from a thread cache
+  std::uint64_t cached_bytes = 0; // parked in thread caches right now
+  std::uint64_t threads = 0;      // threads with a live cache
+  std::uint64_t heap_used_bytes = 0; // what the backend has handed out
+  std::uint64_t heap_free_bytes = 0; // held by the backend, but free
+  std::uint64_t resident_bytes = 0;  // process RSS
+  std::uint64_t decay_ms = 0;
+  std::uint64_t purges = 0;
+  // The huge-page arena, if use_page_arena() set one up
+  const char *page_backing = "none";
+  std::uint64_t arena_capacity_bytes = 0;
+  std::uint64_t arena_used_bytes = 0; // slabs + large blocks
+  std::uint64_t arena_slab_bytes = 0; // spans holding small blocks...
+  std::uint64_t arena_live_bytes = 0; // ...and how much of them is in use
+  std::uint64_t huge_pages = 0;       // 2 MB pages backing the arena
+};
+
+class Allocator {
+public:
+  // ---- allocate() — nullptr if the backend is out of memory ----
+  static void *allocate(std::size_t size);
+
+  // ---- deallocate() — 'size' as passed to allocate(), or 0 if unknown ----
+  static void deallocate(void *ptr, std::size_t size = 0);
+
+  // ---- purge() — Return cached and free memory to the backend / OS ----
+  static void purge();
+
+  // ---- set_decay_ms() — Purge automatically this often (0 = never) ----
+  static void set_decay_ms(std::uint64_t ms);
+
+  // ---- tick() — Called periodically; purges when the decay time is up ----
+  static void tick();
+
+  // ---- use_page_arena() — Back the store with a huge-page arena ----
+  // Maps and prefaults 'bytes' of 2 MB pages (huge_page_arena.hpp) and
+  // serves small blocks and large arrays from it from now on; call it at
+  // startup, before the store fills. huge_pages = false gives the same
+  // arena on 4 KB pages, for comparison. false if no arena could be
+  // mapped, one already exists, or the backend isn't "system".
+  static bool use_page_arena(std::size_t bytes, bool huge_pages = true);
+
+  // ---- should_relocate() — Would a fresh copy of this block be denser? ----
+  // For the defragmenter: true if 'ptr' sits in a sparsely used arena slab
+  // (see HugePageArena::should_relocate). Always false without an arena.
+  static bool should_relocate(const void *ptr);
+
+  // ---- RelocationScope — Allocate straight from the arena meanwhile ----
+  // While one is alive on a thread, that thread's small allocations and
+  // frees bypass its cache. A relocated block must land in a dense slab,
+  // not be handed back the block it was copied from.
+  class RelocationScope {
+  public:
+    RelocationScope();
+    ~RelocationScope();
+    RelocationScope(const RelocationScope &) = delete;
+    RelocationScope &operator=(const RelocationScope &) = delete;
+  };
+
+  static AllocatorStats stats();
+  static const char *backend_name();
+};
+
+// =============================================================================
+// StlAllocator — Lets standard containers allocate through Allocator
+// =============================================================================
+// The minimal C++17 allocator: value_type, allocate, deallocate, and a
+// converting constructor (an unordered_map<K, V, ..., StlAllocator<pair>>
+// rebinds it to allocate its internal nodes and bucket arrays). It has no
+// state, so any two instances are interchangeable (operator== is true).
+// =============================================================================
+template <typename T> struct StlAllocator {
+  using value_type = T;
+
+  StlAllocator() noexcept = default;
+  template <typename U> StlAllocator(const StlAllocator<U> &) noexcept {}
+
+  T *allocate(std::size_t count) {
+    if (count > static_cast<std::size_t>(-1) / sizeof(T)) {
+      throw std::bad_alloc();
+    }
+    void *memory = Allocator::allocate(count * sizeof(T));
+    if (memory == nullptr) {
+      throw std::bad_alloc(); // what the standard containers expect
+    }
+    return static_cast<T *>(memory);
+  }
+
+  void deallocate(T *ptr, std::size_t count) noexcept {
+    Allocator::deallocate(ptr, count * sizeof(T));
+  }
+};
+
+template <typename T, typename U>
+bool operator==(const StlAllocator<T> &, const StlAllocator<U> &) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const StlAllocator<T> &, const StlAllocator<U> &) {
+  return false;
+}
+
+} // namespace mini_redis
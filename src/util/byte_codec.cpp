@@ -0,0 +1,193 @@
+// =============================================================================
+// byte_codec.cpp — Little-Endian Binary Encoding Helpers (IMPLEMENTATION)
+// =============================================================================
+
+#include "util/byte_codec.hpp"
+
+#include <cstring> // std::memcpy
+
+namespace mini_redis {
+
+namespace {
+
+// On a little-endian CPU (x86, most ARM) the in-memory layout of an array
+// of integers already IS the file layout, so arrays can be copied in bulk
+constexpr bool HOST_IS_LITTLE_ENDIAN =
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__;
+
+// Write 'bytes' bytes of 'value', least significant first
+void put_le(std::string &out, std::uint64_t value, int bytes) {
+  char buffer[8];
+  for (int i = 0; i < bytes; ++i) {
+    buffer[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+  }
+  out.append(buffer, static_cast<std::size_t>(bytes));
+}
+
+} // anonymous namespace
+
+void put_u8(std::string &out, std::uint8_t value) { put_le(out, value, 1); }
+
+void put_u16(std::string &out, std::uint16_t value) { put_le(out, value, 2); }
+
+void put_u32(std::string &out, std::uint32_t value) { put_le(out, value, 4); }
+
+void put_u64(std::string &out, std::uint64_t value) { put_le(out, value, 8); }
+
+void put_f64(std::string &out, double value) {
+  // memcpy is the well-defined way to see a double's bits as an integer
+  std::uint64_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  put_u64(out, bits);
+}
+
+void put_bytes(std::string &out, std::string_view bytes) {
+  put_u32(out, static_cast<std::uint32_t>(bytes.size()));
+  out.append(bytes.data(), bytes.size());
+}
+
+void put_varint(std::string &out, std::uint64_t value) {
+  char buffer[10];
+  int length = 0;
+  while (value >= 0x80) {
+    buffer[length++] = static_cast<char>((value & 0x7F) | 0x80);
+    value >>= 7;
+  }
+  buffer[length++] = static_cast<char>(value);
+  out.append(buffer, static_cast<std::size_t>(length));
+}
+
+void put_short_bytes(std::string &out, std::string_view bytes) {
+  put_varint(out, bytes.size());
+  out.append(bytes.data(), bytes.size());
+}
+
+void put_u64_array(std::string &out, const std::uint64_t *values,
+                   std::size_t count) {
+  if constexpr (HOST_IS_LITTLE_ENDIAN) {
+    out.append(reinterpret_cast<const char *>(values),
+               count * sizeof(std::uint64_t));
+  } else {
+    for (std::size_t i = 0; i < count; ++i) {
+      put_u64(out, values[i]);
+    }
+  }
+}
+
+// =============================================================================
+// ByteReader
+// =============================================================================
+ByteReader::ByteReader(std::string_view data) : data_(data) {}
+
+bool ByteReader::get_u8(std::uint8_t &value) {
+  if (remaining() < 1) {
+    return false;
+  }
+  value = static_cast<std::uint8_t>(data_[pos_++]);
+  return true;
+}
+
+bool ByteReader::get_u16(std::uint16_t &value) {
+  if (remaining() < 2) {
+    return false;
+  }
+  const auto low = static_cast<unsigned char>(data_[pos_]);
+  const auto high = static_cast<unsigned char>(data_[pos_ + 1]);
+  value = static_cast<std::uint16_t>(low | (high << 8));
+  pos_ += 2;
+  return true;
+}
+
+bool ByteReader::get_u32(std::uint32_t &value) {
+  std::uint64_t wide = 0;
+  if (remaining() < 4) {
+    return false;
+  }
+  for (int i = 0; i < 4; ++i) {
+    const auto byte = static_cast<unsigned char>(data_[pos_++]);
+    wide |= static_cast<std::uint64_t>(byte) << (8 * i);
+  }
+  value = static_cast<std::uint32_t>(wide);
+  return true;
+}
+
+bool ByteReader::get_u64(std::uint64_t &value) {
+  if (remaining() < 8) {
+    return false;
+  }
+  value = 0;
+  for (int i = 0; i < 8; ++i) {
+    const auto byte = static_cast<unsigned char>(data_[pos_++]);
+    value |= static_cast<std::uint64_t>(byte) << (8 * i);
+  }
+  return true;
+}
+
+bool ByteReader::get_f64(double &value) {
+  std::uint64_t bits = 0;
+  if (!get_u64(bits)) {
+    return false;
+  }
+  std::memcpy(&value, &bits, sizeof(value));
+  return true;
+}
+
+bool ByteReader::get_bytes(std::string &value) {
+  std::uint32_t length = 0;
+  std::string_view raw;
+  if (!get_u32(length) || !get_raw(length, raw)) {
+    return false;
+  }
+  value.assign(raw.data(), raw.size());
+  return true;
+}
+
+bool ByteReader::get_u64_array(std::uint64_t *values, std::size_t count) {
+  if (remaining() / sizeof(std::uint64_t) < count) {
+    return false;
+  }
+  if constexpr (HOST_IS_LITTLE_ENDIAN) {
+    std::memcpy(values, data_.data() + pos_, count * sizeof(std::uint64_t));
+    pos_ += count * sizeof(std::uint64_t);
+  } else {
+    for (std::size_t i = 0; i < count; ++i) {
+      get_u64(values[i]);
+    }
+  }
+  return true;
+}
+
+bool ByteReader::get_varint(std::uint64_t &value) {
+  value = 0;
+  for (unsigned shift = 0; shift < 64; shift += 7) {
+    if (remaining() < 1) {
+      return false;
+    }
+    const auto byte = static_cast<unsigned char>(data_[pos_++]);
+    value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false; // more than 10 bytes: not a valid 64-bit varint
+}
+
+bool ByteReader::get_short_bytes(std::string_view &value) {
+  std::uint64_t length = 0;
+  return get_varint(length) && get_raw(length, value);
+}
+
+bool ByteReader::get_raw(std::size_t length, std::string_view &value) {
+  if (remaining() < length) {
+    return false;
+  }
+  value = data_.substr(pos_, length);
+  pos_ += length;
+  return true;
+}
+
+std::size_t ByteReader::remaining() const { return data_.size() - pos_; }
+
+bool ByteReader::at_end() const { return pos_ == data_.size(); }
+
+} // namespace mini_redis
@@ -0,0 +1,80 @@
+// =============================================================================
+// byte_codec.hpp — Little-Endian Binary Encoding Helpers (HEADER)
+// =============================================================================
+//
+// Snapshots store values as BYTES, not text: a sorted set's scores are
+// written as the 8 raw bytes of the double, so they come back bit-for-bit
+// identical (no "0.1 printed as 0.10000000000000001" surprises), and
+// binary data inside strings needs no escaping.
+//
+// WHY NOT JUST memcpy A STRUCT TO DISK?
+// Struct layout (padding, alignment) and byte order differ between
+// compilers and CPUs. Writing each field explicitly, least significant byte
+// first, gives a file format that means the same thing everywhere.
+//
+// Writing appends to a std::string. Reading goes through ByteReader, which
+// checks every length BEFORE reading: a truncated or corrupted file makes
+// a get_*() call return false instead of reading past the buffer.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mini_redis {
+
+// ---- Writers: append the value to 'out' ----
+void put_u8(std::string &out, std::uint8_t value);
+void put_u16(std::string &out, std::uint16_t value);
+void put_u32(std::string &out, std::uint32_t value);
+void put_u64(std::string &out, std::uint64_t value);
+void put_f64(std::string &out, double value);
+
+// Length-prefixed (u32) byte string
+void put_bytes(std::string &out, std::string_view bytes);
+
+// Variable-length unsigned integer (LEB128): 7 bits per byte, high bit =
+// "more bytes follow". Small numbers — lengths, ID deltas — take 1 byte.
+void put_varint(std::string &out, std::uint64_t value);
+
+// Varint-length-prefixed byte string, for packed in-memory encodings where
+// most strings are short (a u32 prefix would double a 4-byte field)
+void put_short_bytes(std::string &out, std::string_view bytes);
+
+// 'count' u64s, no prefix. One memcpy on little-endian CPUs — this is what
+// keeps multi-megabyte bloom filters and sketches fast to save and load.
+void put_u64_array(std::string &out, const std::uint64_t *values,
+                   std::size_t count);
+
+// ---- ByteReader: a cursor over an encoded buffer ----
+// Every getter returns false (and leaves 'value' unspecified) if the
+// buffer doesn't hold enough bytes. The buffer must outlive the reader.
+class ByteReader {
+public:
+  explicit ByteReader(std::string_view data);
+
+  bool get_u8(std::uint8_t &value);
+  bool get_u16(std::uint16_t &value);
+  bool get_u32(std::uint32_t &value);
+  bool get_u64(std::uint64_t &value);
+  bool get_f64(double &value);
+  bool get_bytes(std::string &value);
+  bool get_u64_array(std::uint64_t *values, std::size_t count);
+  bool get_varint(std::uint64_t &value);
+  bool get_short_bytes(std::string_view &value); // view into the buffer
+
+  // Raw bytes with a length known from context (no prefix)
+  bool get_raw(std::size_t length, std::string_view &value);
+
+  std::size_t remaining() const;
+  bool at_end() const;
+
+private:
+  std::string_view data_;
+  std::size_t pos_ = 0;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,172 @@
+// =============================================================================
+// hash.cpp — 64-bit Hashing for Sketches and Hash Tables (IMPLEMENTATION)
+// =============================================================================
+
+#include "util/hash.hpp"
+
+#include <chrono>
+#include <cstring> // std::memcpy
+#include <random>
+
+namespace mini_redis {
+
+// =============================================================================
+// MurmurHash64A (Austin Appleby, public domain)
+// =============================================================================
+// Mixes 8 bytes at a time with a multiply-xorshift, folds in the 0-7 byte
+// tail, then runs a final "avalanche" so every input bit affects every
+// output bit. memcpy is the portable way to read an unaligned uint64_t —
+// compilers turn it into a single load.
+// =============================================================================
+std::uint64_t hash64(const void *data, std::size_t length, std::uint64_t seed) {
+  constexpr std::uint64_t M = 0xc6a4a7935bd1e995ULL;
+  constexpr int R = 47;
+
+  const auto *bytes = static_cast<const unsigned char *>(data);
+  std::uint64_t h = seed ^ (length * M);
+
+  const std::size_t blocks = length / 8;
+  for (std::size_t i = 0; i < blocks; ++i) {
+    std::uint64_t k;
+    std::memcpy(&k, bytes + i * 8, sizeof(k));
+    k *= M;
+    k ^= k >> R;
+    k *= M;
+    h ^= k;
+    h *= M;
+  }
+
+  const unsigned char *tail = bytes + blocks * 8;
+  switch (length & 7) {
+  case 7:
+    h ^= static_cast<std::uint64_t>(tail[6]) << 48;
+    [[fallthrough]];
+  case 6:
+    h ^= static_cast<std::uint64_t>(tail[5]) << 40;
+    [[fallthrough]];
+  case 5:
+    h ^= static_cast<std::uint64_t>(tail[4]) << 32;
+    [[fallthrough]];
+  case 4:
+    h ^= static_cast<std::uint64_t>(tail[3]) << 24;
+    [[fallthrough]];
+  case 3:
+    h ^= static_cast<std::uint64_t>(tail[2]) << 16;
+    [[fallthrough]];
+  case 2:
+    h ^= static_cast<std::uint64_t>(tail[1]) << 8;
+    [[fallthrough]];
+  case 1:
+    h ^= static_cast<std::uint64_t>(tail[0]);
+    h *= M;
+  }
+
+  h ^= h >> R;
+  h *= M;
+  h ^= h >> R;
+  return h;
+}
+
+// =============================================================================
+// fast_hash64() — wyhash-style multiply-mix (after Wang Yi, public domain)
+// =============================================================================
+// The four constants are odd 64-bit numbers with balanced bits; XORing one
+// into each multiplicand keeps a zero input from zeroing the product.
+// =============================================================================
+namespace {
+
+constexpr std::uint64_t SECRET0 = 0xa0761d6478bd642fULL;
+constexpr std::uint64_t SECRET1 = 0xe7037ed1a0b428dbULL;
+constexpr std::uint64_t SECRET2 = 0x8ebc6af09c88c6e3ULL;
+constexpr std::uint64_t SECRET3 = 0x589965cc75374cc3ULL;
+
+// 128-bit product of a and b, folded to 64 bits
+inline std::uint64_t mum(std::uint64_t a, std::uint64_t b) {
+  __extension__ using uint128 = unsigned __int128;
+  const uint128 product = static_cast<uint128>(a) * b;
+  return static_cast<std::uint64_t>(product) ^
+         static_cast<std::uint64_t>(product >> 64);
+}
+
+inline std::uint64_t read64(const unsigned char *p) {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+inline std::uint64_t read32(const unsigned char *p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+} // anonymous namespace
+
+std::uint64_t fast_hash64(const void *data, std::size_t length,
+                          std::uint64_t seed) {
+  const auto *p = static_cast<const unsigned char *>(data);
+  seed ^= mum(seed ^ SECRET0, SECRET1);
+
+  std::uint64_t a = 0;
+  std::uint64_t b = 0;
+  if (length <= 16) {
+    if (length >= 4) {
+      // Two 32-bit loads from each end; they overlap for lengths 4..7,
+      // which still covers every byte
+      const std::size_t middle = (length >> 3) << 2;
+      a = (read32(p) << 32) | read32(p + middle);
+      b = (read32(p + length - 4) << 32) | read32(p + length - 4 - middle);
+    } else if (length > 0) {
+      a = (static_cast<std::uint64_t>(p[0]) << 16) |
+          (static_cast<std::uint64_t>(p[length >> 1]) << 8) | p[length - 1];
+    }
+  } else {
+    std::size_t left = length;
+    if (left > 48) {
+      std::uint64_t lane1 = seed;
+      std::uint64_t lane2 = seed;
+      do {
+        seed = mum(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+        lane1 = mum(read64(p + 16) ^ SECRET2, read64(p + 24) ^ lane1);
+        lane2 = mum(read64(p + 32) ^ SECRET3, read64(p + 40) ^ lane2);
+        p += 48;
+        left -= 48;
+      } while (left > 48);
+      seed ^= lane1 ^ lane2;
+    }
+    while (left > 16) {
+      seed = mum(read64(p) ^ SECRET1, read64(p + 8) ^ seed);
+      p += 16;
+      left -= 16;
+    }
+    // The last 16 bytes of the input (overlapping what was already mixed)
+    a = read64(p + left - 16);
+    b = read64(p + left - 8);
+  }
+
+  __extension__ using uint128 = unsigned __int128;
+  const uint128 product = static_cast<uint128>(a ^ SECRET1) * (b ^ seed);
+  return mum(static_cast<std::uint64_t>(product) ^ SECRET0 ^ length,
+             static_cast<std::uint64_t>(product >> 64) ^ SECRET1);
+}
+
+// =============================================================================
+// process_hash_seed()
+// =============================================================================
+// std::random_device is the OS entropy source on Linux; the clock is mixed
+// in as well in case a platform's random_device is deterministic.
+// A function-local static is initialized exactly once, thread-safely.
+// =============================================================================
+std::uint64_t process_hash_seed() {
+  static const std::uint64_t seed = [] {
+    std::random_device entropy;
+    const auto now = static_cast<std::uint64_t>(
+        std::chrono::steady_clock::now().time_since_epoch().count());
+    const std::uint64_t drawn =
+        (static_cast<std::uint64_t>(entropy()) << 32) | entropy();
+    return mum(drawn ^ SECRET2, now ^ SECRET3);
+  }();
+  return seed;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,87 @@
+// =============================================================================
+// hash.hpp — 64-bit Hashing for Sketches and Hash Tables (HEADER)
+// =============================================================================
+//
+// WHY NOT std::hash<std::string>?
+// std::hash is only promised to be "good enough for unordered_map", and its
+// algorithm differs between standard libraries. Sketches like HyperLogLog
+// need more: every bit of the output must look random (HLL reads the LOW
+// bits for the register index and the HIGH bits for the run of zeros), and
+// the result must be the same on every machine so serialized sketches stay
+// valid.
+//
+// We use MurmurHash64A (the hash real Redis uses for HyperLogLog): fast,
+// well-distributed, and it takes a SEED so one function can act as many
+// independent hash functions.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mini_redis {
+
+// Hash 'length' bytes at 'data' with the given seed
+std::uint64_t hash64(const void *data, std::size_t length,
+                     std::uint64_t seed = 0);
+
+inline std::uint64_t hash64(std::string_view text, std::uint64_t seed = 0) {
+  return hash64(text.data(), text.size(), seed);
+}
+
+// =============================================================================
+// fast_hash64() — The hash for hash TABLE keys
+// =============================================================================
+// Every request hashes its key, so this one is built for short inputs: a
+// wyhash-style design whose core step is one 64x64→128-bit multiply, with
+// the two halves XORed together ("mum"). Keys up to 16 bytes take two
+// (possibly overlapping) loads and no loop at all; longer keys are
+// consumed 48 bytes per iteration in three independent lanes.
+//
+// It is NOT a drop-in for hash64(): its output is not promised to stay the
+// same between versions, so anything persisted (sketch registers, snapshot
+// checksums) keeps using MurmurHash64A.
+// =============================================================================
+std::uint64_t fast_hash64(const void *data, std::size_t length,
+                          std::uint64_t seed);
+
+inline std::uint64_t fast_hash64(std::string_view text, std::uint64_t seed) {
+  return fast_hash64(text.data(), text.size(), seed);
+}
+
+// ---- process_hash_seed() — Random, fixed for the life of the process ----
+// HASH FLOODING: with a fixed, public hash function an attacker can craft
+// thousands of keys that land in one bucket and turn every lookup into a
+// linear scan. Seeding the table hash with a secret random value drawn at
+// startup means colliding keys can't be computed offline.
+std::uint64_t process_hash_seed();
+
+// ---- hash_key() — A store key's hash: computed ONCE per request ----
+// Picks the shard AND the bucket inside it (see thread_safe_hash_map.hpp).
+inline std::uint64_t hash_key(std::string_view key) {
+  return fast_hash64(key, process_hash_seed());
+}
+
+// ---- hash_integer_key() — The same, for keys stored as integers ----
+// One seeded multiply-fold instead of a pass over the decimal digits.
+// The seed matters just as much here: sequential IDs are exactly what an
+// unseeded "key * constant" hash lets an attacker pile into one bucket.
+inline std::uint64_t hash_integer_key(std::uint64_t key) {
+  __extension__ using uint128 = unsigned __int128;
+  const uint128 product = static_cast<uint128>(key ^ process_hash_seed()) *
+                          0x9e3779b97f4a7c15ULL;
+  return static_cast<std::uint64_t>(product) ^
+         static_cast<std::uint64_t>(product >> 64);
+}
+
+// Map a 64-bit hash uniformly onto [0, n) with one multiply instead of a
+// slow '%' division: the high 64 bits of hash * n. (__extension__ keeps
+// -Wpedantic quiet about the compiler's built-in 128-bit integer.)
+inline std::uint64_t fast_range(std::uint64_t hash, std::uint64_t n) {
+  __extension__ using uint128 = unsigned __int128;
+  return static_cast<std::uint64_t>((static_cast<uint128>(hash) * n) >> 64);
+}
+
+} // namespace mini_redis
@@ -0,0 +1,369 @@
+// =============================================================================
+// huge_page_arena.cpp — Preallocated Huge-Page Memory for the Store (IMPL)
+// =============================================================================
+//
+// Like allocator.cpp, this code runs underneath operator new, so the
+// allocation paths use no std::string / std::vector — only the span tables
+// made once in the constructor.
+// =============================================================================
+
+#include "util/huge_page_arena.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <sys/mman.h>
+
+namespace mini_redis {
+
+const char *to_string(PageBacking backing) {
+  switch (backing) {
+  case PageBacking::UNMAPPED:
+    return "unmapped";
+  case PageBacking::REGULAR:
+    return "regular";
+  case PageBacking::TRANSPARENT_HUGE:
+    return "transparent";
+  case PageBacking::EXPLICIT_HUGE:
+    return "explicit";
+  }
+  return "unknown";
+}
+
+namespace {
+
+std::size_t round_up(std::size_t value, std::size_t multiple) {
+  return (value + multiple - 1) / multiple * multiple;
+}
+
+// ---- map_explicit() — 2 MB pages from the hugetlbfs pool, prefaulted ----
+void *map_explicit(std::size_t bytes) {
+#if defined(MAP_HUGETLB)
+  int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | MAP_POPULATE;
+#if defined(MAP_HUGE_2MB)
+  flags |= MAP_HUGE_2MB;
+#endif
+  void *memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, flags, -1, 0);
+  return memory == MAP_FAILED ? nullptr : memory;
+#else
+  (void)bytes;
+  return nullptr;
+#endif
+}
+
+// ---- map_aligned() — Ordinary memory starting on a 2 MB boundary ----
+// mmap only promises 4 KB alignment, and a transparent huge page can only
+// back an aligned 2 MB range — so over-reserve by 2 MB and unmap the
+// slack on both sides.
+void *map_aligned(std::size_t bytes) {
+  const std::size_t reserve = bytes + HugePageArena::HUGE_PAGE;
+  void *raw = mmap(nullptr, reserve, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (raw == MAP_FAILED) {
+    return nullptr;
+  }
+  const auto start = reinterpret_cast<std::uintptr_t>(raw);
+  const std::uintptr_t aligned = round_up(start, HugePageArena::HUGE_PAGE);
+  if (aligned > start) {
+    munmap(raw, aligned - start);
+  }
+  const std::size_t tail = start + reserve - (aligned + bytes);
+  if (tail > 0) {
+    munmap(reinterpret_cast<void *>(aligned + bytes), tail);
+  }
+  return reinterpret_cast<void *>(aligned);
+}
+
+// Fault every page in now: one write per 4 KB page (with transparent huge
+// pages the first write into each 2 MB range brings in the whole page)
+void prefault(unsigned char *base, std::size_t bytes) {
+  constexpr std::size_t PAGE = 4096;
+  for (std::size_t offset = 0; offset < bytes; offset += PAGE) {
+    *static_cast<volatile unsigned char *>(base + offset) = 0;
+  }
+}
+
+// AnonHugePages of our mapping, from /proc/self/smaps. fopen/fgets use
+// malloc, never operator new.
+std::uint64_t transparent_huge_pages(const void *base) {
+  std::FILE *file = std::fopen("/proc/self/smaps", "r");
+  if (file == nullptr) {
+    return 0;
+  }
+  char line[256];
+  bool in_mapping = false;
+  std::uint64_t kilobytes = 0;
+  while (std::fgets(line, sizeof(line), file) != nullptr) {
+    unsigned long long start = 0;
+    unsigned long long end = 0;
+    // A mapping header ("start-end perms offset dev inode path"); the
+    // field lines that follow it ("Size:", "AnonHugePages:") don't parse
+    if (std::sscanf(line, "%llx-%llx ", &start, &end) == 2) {
+      in_mapping = start == reinterpret_cast<std::uintptr_t>(base);
+      continue;
+    }
+    unsigned long long value = 0;
+    if (in_mapping &&
+        std::sscanf(line, "AnonHugePages: %llu kB", &value) == 1) {
+      kilobytes = value;
+      break;
+    }
+  }
+  std::fclose(file);
+  return kilobytes * 1024 / HugePageArena::HUGE_PAGE;
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Constructor / Destructor
+// =============================================================================
+HugePageArena::HugePageArena(std::size_t bytes, bool huge_pages) {
+  const std::size_t capacity = round_up(bytes == 0 ? 1 : bytes, HUGE_PAGE);
+
+  void *memory = huge_pages ? map_explicit(capacity) : nullptr;
+  if (memory != nullptr) {
+    backing_ = PageBacking::EXPLICIT_HUGE; // MAP_POPULATE prefaulted it
+  } else {
+    memory = map_aligned(capacity);
+    if (memory == nullptr) {
+      return; // UNMAPPED
+    }
+    // Advice, not a command: if THP is off ("never") we silently get
+    // 4 KB pages, which stats() will show as huge_pages = 0. (Linux only;
+    // elsewhere the kernel decides on its own.)
+#if defined(MADV_HUGEPAGE) && defined(MADV_NOHUGEPAGE)
+    madvise(memory, capacity, huge_pages ? MADV_HUGEPAGE : MADV_NOHUGEPAGE);
+#endif
+    backing_ =
+        huge_pages ? PageBacking::TRANSPARENT_HUGE : PageBacking::REGULAR;
+    prefault(static_cast<unsigned char *>(memory), capacity);
+  }
+
+  base_ = static_cast<unsigned char *>(memory);
+  capacity_ = capacity;
+  span_count_ = capacity / SPAN;
+  span_kind_ = std::make_unique<std::uint8_t[]>(span_count_);
+  run_length_ = std::make_unique<std::uint32_t[]>(span_count_);
+  slabs_ = std::make_unique<Slab[]>(span_count_);
+}
+
+HugePageArena::~HugePageArena() {
+  if (base_ != nullptr) {
+    munmap(base_, capacity_);
+  }
+}
+
+// =============================================================================
+// take_spans() — First fit over the span table (caller holds mutex_)
+// =============================================================================
+// Linear, but only called when a size class needs a fresh slab or for a
+// large block — both rare next to the allocations they serve.
+// =============================================================================
+std::size_t HugePageArena::take_spans(std::size_t count) {
+  std::size_t run_start = first_free_span_;
+  std::size_t run = 0;
+  for (std::size_t i = first_free_span_; i < span_count_; ++i) {
+    if (span_kind_[i] != SPAN_FREE) {
+      run = 0;
+      run_start = i + 1;
+      if (i == first_free_span_) {
+        ++first_free_span_;
+      }
+      continue;
+    }
+    if (++run == count) {
+      if (run_start == first_free_span_) {
+        first_free_span_ = run_start + count;
+      }
+      return run_start;
+    }
+  }
+  return SIZE_MAX;
+}
+
+void HugePageArena::release_span(std::size_t span) {
+  span_kind_[span] = SPAN_FREE;
+  if (span < first_free_span_) {
+    first_free_span_ = span;
+  }
+}
+
+// ---- The partial-slab list of a class (caller holds mutex_) ----
+// New partial slabs join at the back, so allocation keeps filling the
+// slab at the front until it is full instead of spreading over all of them.
+void HugePageArena::link_partial(std::size_t size_class, std::uint32_t span) {
+  SizeClass &cls = classes_[size_class];
+  Slab &slab = slabs_[span];
+  slab.prev = cls.partial_tail;
+  slab.next = NO_SPAN;
+  if (cls.partial_tail != NO_SPAN) {
+    slabs_[cls.partial_tail].next = span;
+  } else {
+    cls.partial_head = span;
+  }
+  cls.partial_tail = span;
+}
+
+void HugePageArena::unlink_partial(std::size_t size_class,
+                                   std::uint32_t span) {
+  SizeClass &cls = classes_[size_class];
+  Slab &slab = slabs_[span];
+  (slab.prev != NO_SPAN ? slabs_[slab.prev].next : cls.partial_head) =
+      slab.next;
+  (slab.next != NO_SPAN ? slabs_[slab.next].prev : cls.partial_tail) =
+      slab.prev;
+  slab.prev = slab.next = NO_SPAN;
+}
+
+// =============================================================================
+// Small blocks — per-slab free lists, a new slab when all are full
+// =============================================================================
+void *HugePageArena::allocate_small(std::size_t size_class) {
+  if (base_ == nullptr || size_class >= SMALL_CLASSES) {
+    return nullptr;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  SizeClass &cls = classes_[size_class];
+  std::uint32_t span = cls.partial_head;
+  if (span == NO_SPAN) {
+    const std::size_t fresh = take_spans(1);
+    if (fresh == SIZE_MAX) {
+      return nullptr; // arena full: the caller falls back to malloc
+    }
+    span = static_cast<std::uint32_t>(fresh);
+    span_kind_[span] = static_cast<std::uint8_t>(size_class + 1);
+    ++slab_spans_;
+    ++cls.slabs;
+
+    // Thread the new slab into a free list, lowest address first
+    const std::size_t block_size = (size_class + 1) * SMALL_GRANULE;
+    unsigned char *base = base_ + span * SPAN;
+    FreeBlock *head = nullptr;
+    for (std::size_t i = blocks_per_slab(size_class); i-- > 0;) {
+      auto *block = reinterpret_cast<FreeBlock *>(base + i * block_size);
+      block->next = head;
+      head = block;
+    }
+    slabs_[span] = Slab{head, 0, NO_SPAN, NO_SPAN};
+    link_partial(size_class, span);
+  }
+
+  Slab &slab = slabs_[span];
+  FreeBlock *block = slab.free;
+  slab.free = block->next;
+  ++slab.live;
+  ++cls.live;
+  if (slab.free == nullptr) {
+    unlink_partial(size_class, span); // full now
+  }
+  return block;
+}
+
+void HugePageArena::deallocate_small(void *ptr, std::size_t size_class) {
+  auto *block = static_cast<FreeBlock *>(ptr);
+  const auto span = static_cast<std::uint32_t>(span_index(ptr));
+  std::lock_guard<std::mutex> lock(mutex_);
+  SizeClass &cls = classes_[size_class];
+  Slab &slab = slabs_[span];
+  const bool was_full = slab.free == nullptr;
+  block->next = slab.free;
+  slab.free = block;
+  --slab.live;
+  --cls.live;
+
+  if (slab.live == 0) {
+    // Empty: the span can serve any class (or a large block) again
+    if (!was_full) {
+      unlink_partial(size_class, span);
+    }
+    slab = Slab{};
+    --slab_spans_;
+    --cls.slabs;
+    release_span(span);
+  } else if (was_full) {
+    link_partial(size_class, span);
+  }
+}
+
+bool HugePageArena::should_relocate(const void *ptr) const {
+  if (!contains(ptr)) {
+    return false;
+  }
+  const int size_class = size_class_of(ptr);
+  if (size_class < 0) {
+    return false; // large blocks are whole spans: nothing to compact
+  }
+  const std::size_t span = span_index(ptr);
+  std::lock_guard<std::mutex> lock(mutex_);
+  const SizeClass &cls = classes_[size_class];
+  const Slab &slab = slabs_[span];
+  if (slab.free == nullptr || span == cls.partial_head) {
+    return false; // full, or where the copy would go anyway
+  }
+  // live / capacity < class live / class capacity (capacity cancels out)
+  return slab.live * cls.slabs < cls.live;
+}
+
+// =============================================================================
+// Large blocks — a run of whole spans
+// =============================================================================
+void *HugePageArena::allocate_large(std::size_t bytes) {
+  if (base_ == nullptr) {
+    return nullptr;
+  }
+  const std::size_t count = round_up(bytes, SPAN) / SPAN;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::size_t start = take_spans(count);
+  if (start == SIZE_MAX) {
+    return nullptr;
+  }
+  for (std::size_t i = start; i < start + count; ++i) {
+    span_kind_[i] = SPAN_LARGE;
+  }
+  run_length_[start] = static_cast<std::uint32_t>(count);
+  large_spans_ += count;
+  return base_ + start * SPAN;
+}
+
+void HugePageArena::deallocate(void *ptr) {
+  const int size_class = size_class_of(ptr);
+  if (size_class >= 0) {
+    deallocate_small(ptr, static_cast<std::size_t>(size_class));
+    return;
+  }
+  const std::size_t start = span_index(ptr);
+  std::lock_guard<std::mutex> lock(mutex_);
+  const std::size_t count = run_length_[start];
+  for (std::size_t i = start; i < start + count; ++i) {
+    release_span(i);
+  }
+  large_spans_ -= count;
+}
+
+int HugePageArena::size_class_of(const void *ptr) const {
+  const std::uint8_t kind = span_kind_[span_index(ptr)];
+  return kind == SPAN_LARGE ? -1 : static_cast<int>(kind) - 1;
+}
+
+HugePageArenaStats HugePageArena::stats() const {
+  HugePageArenaStats stats;
+  stats.backing = backing_;
+  stats.capacity_bytes = capacity_;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats.slab_bytes = slab_spans_ * SPAN;
+    for (std::size_t i = 0; i < SMALL_CLASSES; ++i) {
+      stats.live_bytes += classes_[i].live * (i + 1) * SMALL_GRANULE;
+    }
+    stats.large_bytes = large_spans_ * SPAN;
+  }
+  if (backing_ == PageBacking::EXPLICIT_HUGE) {
+    stats.huge_pages = capacity_ / HUGE_PAGE;
+  } else if (backing_ == PageBacking::TRANSPARENT_HUGE) {
+    stats.huge_pages = transparent_huge_pages(base_);
+  }
+  return stats;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,182 @@
+// =============================================================================
+// huge_page_arena.hpp — Preallocated Huge-Page Memory for the Store (HEADER)
+// =============================================================================
+//
+// WHY HUGE PAGES?
+// The CPU translates every virtual address through the page table, and
+// caches recent translations in the TLB — typically ~1500 entries. With
+// 4 KB pages that covers 6 MB; a random GET in a 10 GB store almost always
+// misses it and pays a page-table walk (several dependent memory loads)
+// BEFORE the cache miss on the key itself. With 2 MB pages the same TLB
+// covers 3 GB, and the walk is one level shorter.
+//
+// HOW WE GET THEM:
+//   1. mmap(MAP_HUGETLB | MAP_HUGE_2MB) — explicit huge pages from the
+//      kernel's reserved pool (vm.nr_hugepages). Guaranteed 2 MB pages,
+//      but the pool must have been set up by the administrator.
+//   2. Otherwise, ordinary memory aligned to 2 MB plus
+//      madvise(MADV_HUGEPAGE): transparent huge pages. The kernel backs
+//      the range with 2 MB pages when it can find them.
+// Either way the whole region is faulted in at startup ("prefault"), so
+// no GET ever stalls on a page fault later — the latency spike moves to
+// boot time, where nobody is waiting.
+//
+// WHAT LIVES IN THE ARENA:
+// The region is cut into 64 KB spans. A span either becomes a SLAB for
+// one small size class (the 16..1024-byte classes of allocator.hpp: hash
+// table nodes, keys, short values) or is part of a RUN of spans holding
+// one large block (hash table bucket arrays, anything >= 16 KB). Blocks
+// between 1 KB and 16 KB would waste most of a span, so they — and
+// everything once the arena is full — stay with malloc.
+//
+// Each slab keeps its own free list and live count. New blocks come from
+// the class's oldest partly used slab, and a slab whose last block is
+// freed goes back to the free pool. That is what makes DEFRAGMENTATION
+// possible (core/defragmenter.hpp): after heavy churn a class can be
+// spread over many nearly empty slabs. should_relocate() tells the
+// defragmenter which blocks are worth copying into a denser slab; once a
+// sparse slab is drained its span becomes free again. Runs are returned
+// when their block is freed.
+//
+// Allocator (allocator.hpp) owns the process-wide arena and puts it
+// underneath its thread caches; this class is the mechanism.
+// =============================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+namespace mini_redis {
+
+// How the arena's memory ended up being backed
+enum class PageBacking {
+  UNMAPPED,         // mmap failed: the arena serves nothing
+  REGULAR,          // 4 KB pages (asked for, to compare against)
+  TRANSPARENT_HUGE, // madvise(MADV_HUGEPAGE)
+  EXPLICIT_HUGE     // MAP_HUGETLB
+};
+
+const char *to_string(PageBacking backing);
+
+struct HugePageArenaStats {
+  PageBacking backing = PageBacking::UNMAPPED;
+  std::uint64_t capacity_bytes = 0;
+  std::uint64_t slab_bytes = 0;  // spans given to small size classes
+  std::uint64_t live_bytes = 0;  // small blocks handed out of those slabs
+  std::uint64_t large_bytes = 0; // spans holding large blocks right now
+  std::uint64_t huge_pages = 0;  // 2 MB pages actually backing the region
+};
+
+class HugePageArena {
+public:
+  static constexpr std::size_t HUGE_PAGE = 2 * 1024 * 1024;
+  static constexpr std::size_t SPAN = 64 * 1024;
+  static constexpr std::size_t SMALL_GRANULE = 16;
+  static constexpr std::size_t SMALL_CLASSES = 64; // 16..1024 bytes
+  static constexpr std::size_t LARGE_MIN = 16 * 1024;
+
+  // Reserve 'bytes' (rounded up to 2 MB) and fault it all in. With
+  // huge_pages = false the region uses ordinary 4 KB pages — the same
+  // arena, for an apples-to-apples comparison. Check backing() afterwards:
+  // UNMAPPED means every allocate call will return nullptr.
+  explicit HugePageArena(std::size_t bytes, bool huge_pages = true);
+  ~HugePageArena();
+
+  HugePageArena(const HugePageArena &) = delete;
+  HugePageArena &operator=(const HugePageArena &) = delete;
+
+  PageBacking backing() const { return backing_; }
+
+  bool contains(const void *ptr) const {
+    const auto *byte = static_cast<const unsigned char *>(ptr);
+    return byte >= base_ && byte < base_ + capacity_;
+  }
+
+  // ---- Small blocks: class i is (i + 1) * 16 bytes ----
+  void *allocate_small(std::size_t size_class);
+  void deallocate_small(void *ptr, std::size_t size_class);
+
+  // ---- Large blocks (>= LARGE_MIN), whole spans ----
+  void *allocate_large(std::size_t bytes);
+
+  // ---- Any block from this arena, size looked up from its span ----
+  void deallocate(void *ptr);
+
+  // Small size class of a block (0..63), or -1 if it is a large block
+  int size_class_of(const void *ptr) const;
+
+  // ---- should_relocate() — Is this block in a sparse slab? ----
+  // true if the block's slab is less full than its class's slabs on
+  // average and isn't the slab new blocks come from: copying the block
+  // into a fresh allocation then moves it somewhere denser.
+  bool should_relocate(const void *ptr) const;
+
+  HugePageArenaStats stats() const;
+
+private:
+  // span_kind_ values besides "small class i + 1"
+  static constexpr std::uint8_t SPAN_FREE = 0;
+  static constexpr std::uint8_t SPAN_LARGE = 0xFF;
+
+  static constexpr std::uint32_t NO_SPAN = UINT32_MAX;
+
+  struct FreeBlock {
+    FreeBlock *next;
+  };
+
+  // Bookkeeping for one slab. Partly used slabs of a class form a doubly
+  // linked list (by span index) that allocation takes from the front of.
+  struct Slab {
+    FreeBlock *free = nullptr;
+    std::uint32_t live = 0;
+    std::uint32_t prev = NO_SPAN;
+    std::uint32_t next = NO_SPAN;
+  };
+
+  struct SizeClass {
+    std::uint32_t partial_head = NO_SPAN;
+    std::uint32_t partial_tail = NO_SPAN;
+    std::size_t slabs = 0;
+    std::size_t live = 0; // blocks handed out
+  };
+
+  // First-fit search for 'count' free spans in a row; SIZE_MAX if none
+  std::size_t take_spans(std::size_t count);
+  void release_span(std::size_t span);
+  void link_partial(std::size_t size_class, std::uint32_t span);
+  void unlink_partial(std::size_t size_class, std::uint32_t span);
+  static std::size_t blocks_per_slab(std::size_t size_class) {
+    return SPAN / ((size_class + 1) * SMALL_GRANULE);
+  }
+  std::size_t span_index(const void *ptr) const {
+    return static_cast<std::size_t>(static_cast<const unsigned char *>(ptr) -
+                                    base_) /
+           SPAN;
+  }
+
+  unsigned char *base_ = nullptr;
+  std::size_t capacity_ = 0;
+  std::size_t span_count_ = 0;
+  PageBacking backing_ = PageBacking::UNMAPPED;
+
+  // One byte per span: SPAN_FREE, SPAN_LARGE, or small class + 1.
+  // run_length_[i] is the number of spans of the large block starting at
+  // span i; slabs_[i] describes span i while it is a slab. All live in
+  // ordinary memory, sized once at construction.
+  std::unique_ptr<std::uint8_t[]> span_kind_;
+  std::unique_ptr<std::uint32_t[]> run_length_;
+  std::unique_ptr<Slab[]> slabs_;
+
+  // Everything below (and the slab entries) is guarded by mutex_. Thread
+  // caches in front of the arena keep it off the fast path.
+  mutable std::mutex mutex_;
+  SizeClass classes_[SMALL_CLASSES];
+  std::size_t first_free_span_ = 0; // no free span below this index
+  std::size_t slab_spans_ = 0;
+  std::size_t large_spans_ = 0;
+};
+
+} // namespace mini_redis
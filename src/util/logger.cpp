@@ -60,6 +60,17 @@ void Logger::error(const std::string &message) {
   log(LogLevel::ERROR, message);
 }
 
+// =============================================================================
+// The level filter
+// =============================================================================
+void Logger::set_min_level(LogLevel level) {
+  min_level_.store(level, std::memory_order_relaxed);
+}
+
+LogLevel Logger::min_level() {
+  return min_level_.load(std::memory_order_relaxed);
+}
+
 // =============================================================================
 // Logger::log — The core logging function (private)
 // =============================================================================
@@ -67,6 +78,10 @@ void Logger::error(const std::string &message) {
 // code should use info() / warning() / error() instead.
 // =============================================================================
 void Logger::log(LogLevel level, const std::string &message) {
+  if (level < min_level()) {
+    return; // filtered out: no lock, no timestamp
+  }
+
   // --- Thread safety with std::lock_guard ---
   // PROBLEM: if two threads call log() at the same time, their output
   // can interleave: "[INFO] Hel[ERROR] Failed to blo world"
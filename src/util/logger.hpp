@@ -46,6 +46,10 @@
 // will WAIT until the first thread unlocks it. This prevents data races.
 #include <mutex>
 
+// <atomic> provides std::atomic — the level filter is read by every log
+// call and may be changed at runtime (config reload) without the mutex
+#include <atomic>
+
 // =============================================================================
 // WHAT IS A NAMESPACE?
 // A namespace is like a "last name" for your code. Just like there can be
@@ -111,6 +115,14 @@ public:
     // Log an error message
     static void error(const std::string& message);
 
+    // ---- The level filter ----
+    // Messages below the minimum level are dropped before any formatting
+    // (so a server logging only errors doesn't pay for its INFO lines).
+    // Levels are ordered INFO < WARNING < ERROR. Safe to change while
+    // other threads log.
+    static void set_min_level(LogLevel level);
+    static LogLevel min_level();
+
 private:
     // ---- Private implementation ----
     // "private" means ONLY code inside this class can call these.
@@ -133,6 +145,9 @@ private:
     // definition in the .cpp file. (C++17 feature)
     static inline std::mutex log_mutex_;
 
+    // The level filter (see set_min_level); INFO = log everything
+    static inline std::atomic<LogLevel> min_level_{LogLevel::INFO};
+
     // NAMING CONVENTION: trailing underscore (log_mutex_) indicates a
     // private member variable. This is the Google C++ Style Guide convention.
     // It makes it instantly clear when reading code what is a local variable
@@ -0,0 +1,421 @@
+// =============================================================================
+// lz4.cpp — In-Tree LZ4 Compression (IMPLEMENTATION)
+// =============================================================================
+// Follows the published LZ4 block and frame format specifications, so the
+// output interoperates with the reference implementation.
+// =============================================================================
+
+#include "util/lz4.hpp"
+#include "util/byte_codec.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace mini_redis::lz4 {
+
+namespace {
+
+// ---- Block format constants (from the specification) ----
+constexpr std::size_t MIN_MATCH = 4;
+constexpr std::size_t LAST_LITERALS = 5; // a block ends with >= 5 literals
+constexpr std::size_t MFLIMIT = 12;      // no match starts in the last 12
+constexpr std::size_t MAX_OFFSET = 65535;
+constexpr int HASH_LOG = 12; // 16 KB table, the reference default
+
+// ---- Frame format constants ----
+constexpr std::uint32_t FRAME_MAGIC = 0x184D2204;
+constexpr std::uint8_t FLG_VERSION = 0x40;     // version 01 in bits 7-6
+constexpr std::uint8_t FLG_BLOCK_INDEP = 0x20; // blocks don't reference
+constexpr std::uint8_t FLG_BLOCK_CHECKSUM = 0x10;
+constexpr std::uint8_t FLG_CONTENT_SIZE = 0x08;
+constexpr std::uint8_t FLG_CONTENT_CHECKSUM = 0x04;
+constexpr std::uint8_t FLG_DICT_ID = 0x01;
+constexpr std::uint8_t BD_4MB = 7 << 4;
+constexpr std::size_t BLOCK_MAX = 4 * 1024 * 1024;
+constexpr std::uint32_t RAW_BLOCK = 0x80000000u; // size's high bit
+
+std::uint32_t read32(const unsigned char *p) {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value)); // LZ4 hashes bytes, any order
+  return value;
+}
+
+std::uint32_t read32_le(const unsigned char *p) {
+  return static_cast<std::uint32_t>(p[0]) |
+         static_cast<std::uint32_t>(p[1]) << 8 |
+         static_cast<std::uint32_t>(p[2]) << 16 |
+         static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+std::uint32_t hash4(std::uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - HASH_LOG);
+}
+
+// =============================================================================
+// xxh32() — The frame format's checksum (XXH32, seed 0)
+// =============================================================================
+std::uint32_t rotl32(std::uint32_t x, int r) { return x << r | x >> (32 - r); }
+
+std::uint32_t xxh32(const unsigned char *p, std::size_t length) {
+  constexpr std::uint32_t P1 = 2654435761u, P2 = 2246822519u,
+                          P3 = 3266489917u, P4 = 668265263u, P5 = 374761393u;
+  const unsigned char *const end = p + length;
+  std::uint32_t h;
+  if (length >= 16) {
+    std::uint32_t v1 = P1 + P2, v2 = P2, v3 = 0, v4 = 0u - P1;
+    const auto round = [](std::uint32_t v, std::uint32_t input) {
+      return rotl32(v + input * P2, 13) * P1;
+    };
+    for (; p + 16 <= end; p += 16) {
+      v1 = round(v1, read32_le(p));
+      v2 = round(v2, read32_le(p + 4));
+      v3 = round(v3, read32_le(p + 8));
+      v4 = round(v4, read32_le(p + 12));
+    }
+    h = rotl32(v1, 1) + rotl32(v2, 7) + rotl32(v3, 12) + rotl32(v4, 18);
+  } else {
+    h = P5;
+  }
+  h += static_cast<std::uint32_t>(length);
+  for (; p + 4 <= end; p += 4) {
+    h = rotl32(h + read32_le(p) * P3, 17) * P4;
+  }
+  for (; p < end; ++p) {
+    h = rotl32(h + *p * P5, 11) * P1;
+  }
+  h ^= h >> 15;
+  h *= P2;
+  h ^= h >> 13;
+  h *= P3;
+  h ^= h >> 16;
+  return h;
+}
+
+// ---- A length beyond its 4-bit nibble: 255, 255, ..., remainder ----
+void put_length(std::string &out, std::size_t length) {
+  for (; length >= 255; length -= 255) {
+    out += static_cast<char>(255);
+  }
+  out += static_cast<char>(length);
+}
+
+void put_sequence(std::string &out, const unsigned char *literals,
+                  std::size_t literal_length, std::size_t offset,
+                  std::size_t match_length) {
+  const std::size_t match_code = match_length - MIN_MATCH;
+  out += static_cast<char>(std::min<std::size_t>(literal_length, 15) << 4 |
+                           std::min<std::size_t>(match_code, 15));
+  if (literal_length >= 15) {
+    put_length(out, literal_length - 15);
+  }
+  out.append(reinterpret_cast<const char *>(literals), literal_length);
+  out += static_cast<char>(offset & 0xFF);
+  out += static_cast<char>(offset >> 8);
+  if (match_code >= 15) {
+    put_length(out, match_code - 15);
+  }
+}
+
+void put_last_literals(std::string &out, const unsigned char *literals,
+                       std::size_t length) {
+  out += static_cast<char>(std::min<std::size_t>(length, 15) << 4);
+  if (length >= 15) {
+    put_length(out, length - 15);
+  }
+  out.append(reinterpret_cast<const char *>(literals), length);
+}
+
+// =============================================================================
+// compress_block() — Greedy LZ4 with one candidate per position
+// =============================================================================
+// 'table' maps a hash of 4 bytes to the last position they were seen at.
+// After a run of misses the step grows (1 extra byte per 64 misses), so
+// incompressible data is skipped through quickly instead of hashed byte
+// by byte — the "acceleration" of the reference implementation.
+// =============================================================================
+void compress_block(const unsigned char *in, std::size_t length,
+                    std::vector<std::uint32_t> &table, std::string &out) {
+  std::size_t anchor = 0;
+  if (length > MFLIMIT) {
+    std::fill(table.begin(), table.end(), 0);
+    const std::size_t match_start_limit = length - MFLIMIT;
+    const std::size_t match_end_limit = length - LAST_LITERALS;
+    std::size_t pos = 0;
+    std::size_t misses = 0;
+
+    while (pos < match_start_limit) {
+      const std::uint32_t sequence = read32(in + pos);
+      const std::uint32_t slot = hash4(sequence);
+      std::size_t candidate = table[slot];
+      table[slot] = static_cast<std::uint32_t>(pos);
+
+      if (candidate >= pos || pos - candidate > MAX_OFFSET ||
+          read32(in + candidate) != sequence) {
+        pos += 1 + (misses++ >> 6);
+        continue;
+      }
+      misses = 0;
+
+      // Grow the match backwards into pending literals, then forwards
+      while (pos > anchor && candidate > 0 &&
+             in[pos - 1] == in[candidate - 1]) {
+        --pos;
+        --candidate;
+      }
+      std::size_t match_length = MIN_MATCH;
+      while (pos + match_length < match_end_limit &&
+             in[candidate + match_length] == in[pos + match_length]) {
+        ++match_length;
+      }
+
+      put_sequence(out, in + anchor, pos - anchor, pos - candidate,
+                   match_length);
+      pos += match_length;
+      anchor = pos;
+      if (pos < match_start_limit) {
+        // Seed the table inside the match, or the next repeat is missed
+        const std::size_t seed = pos - 2;
+        table[hash4(read32(in + seed))] = static_cast<std::uint32_t>(seed);
+      }
+    }
+  }
+  put_last_literals(out, in + anchor, length - anchor);
+}
+
+// =============================================================================
+// decompress_block() — Every length checked before it is used
+// =============================================================================
+// Writes at most 'capacity' bytes to 'out'; returns the count, or -1 on
+// malformed input. Offsets may not reach before the block's own start
+// (blocks are independent).
+// =============================================================================
+long long decompress_block(const unsigned char *in, std::size_t length,
+                           char *out, std::size_t capacity) {
+  const unsigned char *const end = in + length;
+  std::size_t written = 0;
+
+  const auto read_length = [&](std::size_t &value) {
+    for (;;) {
+      if (in >= end) {
+        return false;
+      }
+      const unsigned char byte = *in++;
+      value += byte;
+      if (byte != 255) {
+        return true;
+      }
+    }
+  };
+
+  while (in < end) {
+    const unsigned char token = *in++;
+    std::size_t literals = token >> 4;
+    if (literals == 15 && !read_length(literals)) {
+      return -1;
+    }
+    if (literals > static_cast<std::size_t>(end - in) ||
+        literals > capacity - written) {
+      return -1;
+    }
+    std::memcpy(out + written, in, literals);
+    in += literals;
+    written += literals;
+    if (in == end) {
+      break; // the last sequence has no match part
+    }
+
+    if (end - in < 2) {
+      return -1;
+    }
+    const std::size_t offset = in[0] | static_cast<std::size_t>(in[1]) << 8;
+    in += 2;
+    std::size_t match_length = token & 15;
+    if (match_length == 15 && !read_length(match_length)) {
+      return -1;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > written || match_length > capacity - written) {
+      return -1;
+    }
+
+    char *dst = out + written;
+    const char *src = dst - offset;
+    if (offset >= match_length) {
+      std::memcpy(dst, src, match_length);
+    } else {
+      // Overlapping copy: offset 1 repeats one byte, offset 2 a pair...
+      for (std::size_t i = 0; i < match_length; ++i) {
+        dst[i] = src[i];
+      }
+    }
+    written += match_length;
+  }
+  return static_cast<long long>(written);
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// compress() — Frame: magic, descriptor, blocks, end mark
+// =============================================================================
+std::string compress(std::string_view input) {
+  std::string out;
+  out.reserve(input.size() / 2 + 64);
+  put_u32(out, FRAME_MAGIC);
+
+  const std::size_t descriptor = out.size();
+  put_u8(out, FLG_VERSION | FLG_BLOCK_INDEP | FLG_CONTENT_SIZE);
+  put_u8(out, BD_4MB);
+  put_u64(out, input.size());
+  const auto *header = reinterpret_cast<const unsigned char *>(out.data());
+  put_u8(out, static_cast<std::uint8_t>(
+                  xxh32(header + descriptor, out.size() - descriptor) >> 8));
+
+  const auto *in = reinterpret_cast<const unsigned char *>(input.data());
+  std::vector<std::uint32_t> table(std::size_t{1} << HASH_LOG);
+  std::string block;
+  for (std::size_t start = 0; start < input.size(); start += BLOCK_MAX) {
+    const std::size_t length = std::min(BLOCK_MAX, input.size() - start);
+    block.clear();
+    compress_block(in + start, length, table, block);
+    if (block.size() < length) {
+      put_u32(out, static_cast<std::uint32_t>(block.size()));
+      out += block;
+    } else {
+      put_u32(out, static_cast<std::uint32_t>(length) | RAW_BLOCK);
+      out.append(input.substr(start, length));
+    }
+  }
+  put_u32(out, 0); // end mark
+  return out;
+}
+
+// =============================================================================
+// Frame parsing
+// =============================================================================
+namespace {
+
+struct FrameHeader {
+  std::uint8_t flags = 0;
+  std::size_t block_max = 0;
+  std::optional<std::uint64_t> content_size;
+};
+
+// Reads the magic number and descriptor, checking its checksum byte
+std::optional<FrameHeader> read_header(ByteReader &in, std::string_view frame) {
+  std::uint32_t magic = 0;
+  FrameHeader header;
+  std::uint8_t bd = 0;
+  if (!in.get_u32(magic) || magic != FRAME_MAGIC || !in.get_u8(header.flags) ||
+      !in.get_u8(bd) || (header.flags & 0xC0) != FLG_VERSION ||
+      (header.flags & FLG_DICT_ID) != 0 ||
+      (header.flags & FLG_BLOCK_INDEP) == 0) {
+    return std::nullopt;
+  }
+  const std::size_t block_code = (bd >> 4) & 7;
+  if (block_code < 4) {
+    return std::nullopt;
+  }
+  header.block_max = std::size_t{1} << (2 * block_code + 8);
+
+  if ((header.flags & FLG_CONTENT_SIZE) != 0) {
+    std::uint64_t size = 0;
+    if (!in.get_u64(size)) {
+      return std::nullopt;
+    }
+    header.content_size = size;
+  }
+  const std::size_t descriptor_end = frame.size() - in.remaining();
+  std::uint8_t checksum = 0;
+  if (!in.get_u8(checksum)) {
+    return std::nullopt;
+  }
+  const auto *bytes = reinterpret_cast<const unsigned char *>(frame.data());
+  if (checksum !=
+      static_cast<std::uint8_t>(xxh32(bytes + 4, descriptor_end - 4) >> 8)) {
+    return std::nullopt;
+  }
+  return header;
+}
+
+} // anonymous namespace
+
+std::optional<std::uint64_t> content_size(std::string_view frame) {
+  ByteReader in(frame);
+  const auto header = read_header(in, frame);
+  return header ? header->content_size : std::nullopt;
+}
+
+std::optional<std::string> decompress(std::string_view frame) {
+  ByteReader in(frame);
+  const auto header = read_header(in, frame);
+  if (!header.has_value()) {
+    return std::nullopt;
+  }
+
+  std::string out;
+  if (header->content_size.has_value()) {
+    // Don't trust a huge claim before the blocks back it up
+    out.reserve(std::min<std::uint64_t>(*header->content_size,
+                                        frame.size() * 255));
+  }
+  for (;;) {
+    std::uint32_t size = 0;
+    if (!in.get_u32(size)) {
+      return std::nullopt;
+    }
+    if (size == 0) {
+      break; // end mark
+    }
+    const bool raw = (size & RAW_BLOCK) != 0;
+    size &= ~RAW_BLOCK;
+    std::string_view block;
+    if (size > header->block_max || !in.get_raw(size, block)) {
+      return std::nullopt;
+    }
+    if ((header->flags & FLG_BLOCK_CHECKSUM) != 0) {
+      std::uint32_t ignored = 0;
+      if (!in.get_u32(ignored)) {
+        return std::nullopt;
+      }
+    }
+
+    if (raw) {
+      out.append(block);
+      continue;
+    }
+    std::size_t capacity = header->block_max;
+    if (header->content_size.has_value()) {
+      if (*header->content_size < out.size()) {
+        return std::nullopt;
+      }
+      capacity = std::min<std::uint64_t>(capacity,
+                                         *header->content_size - out.size());
+    }
+    const std::size_t base = out.size();
+    out.resize(base + capacity);
+    const long long written = decompress_block(
+        reinterpret_cast<const unsigned char *>(block.data()), block.size(),
+        out.data() + base, capacity);
+    if (written < 0) {
+      return std::nullopt;
+    }
+    out.resize(base + static_cast<std::size_t>(written));
+  }
+
+  if ((header->flags & FLG_CONTENT_CHECKSUM) != 0) {
+    std::uint32_t checksum = 0;
+    if (!in.get_u32(checksum) ||
+        checksum != xxh32(reinterpret_cast<const unsigned char *>(out.data()),
+                          out.size())) {
+      return std::nullopt;
+    }
+  }
+  if (header->content_size.has_value() && *header->content_size != out.size()) {
+    return std::nullopt;
+  }
+  return out;
+}
+
+} // namespace mini_redis::lz4
@@ -0,0 +1,55 @@
+// =============================================================================
+// lz4.hpp — In-Tree LZ4 Compression (HEADER)
+// =============================================================================
+//
+// WHY LZ4?
+// Values of tens to hundreds of KB (JSON, HTML, logs) often shrink 3-10x,
+// but a store can't spend milliseconds per SET to get there. LZ4 trades
+// some ratio for speed: compression runs at hundreds of MB/s per core and
+// decompression at GB/s — cheaper than the network copy of the raw bytes.
+//
+// HOW LZ4 WORKS (the "block" format):
+// The output is a series of SEQUENCES, each "copy these N literal bytes,
+// then copy M bytes from OFFSET bytes back in the output":
+//
+//   token | [more literal length] | literals | offset (2 B) | [more match]
+//   4 bits literal length, 4 bits match length - 4; a nibble of 15 means
+//   "add the following bytes" (each 255 means "keep adding")
+//
+// The compressor finds matches with a hash table of the last position
+// every 4-byte string was seen at: hash the 4 bytes at the cursor, look up
+// where they were before, and if the bytes really match (and are at most
+// 64 KB back), extend the match as far as it goes. No entropy coding, no
+// search beyond that one candidate — which is why it is fast.
+//
+// THE FRAME FORMAT:
+// compress() wraps blocks in the standard LZ4 frame (magic number,
+// descriptor with the content size, blocks, end mark), so stored values
+// can be sent as-is to a client that accepts "Content-Encoding: lz4"
+// and decoded there with any LZ4 library or the lz4 command-line tool.
+// =============================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace mini_redis::lz4 {
+
+// ---- compress() — One LZ4 frame holding 'input' ----
+// Incompressible blocks are stored raw inside the frame, so the output
+// is at most a few bytes per 4 MB larger than the input.
+std::string compress(std::string_view input);
+
+// ---- decompress() — Inverse of compress() ----
+// Accepts any frame with independent blocks (what lz4 writes by default);
+// std::nullopt for malformed or truncated input, or frame features we
+// don't implement (dictionaries, linked blocks).
+std::optional<std::string> decompress(std::string_view frame);
+
+// ---- content_size() — Decompressed size recorded in the frame header ----
+std::optional<std::uint64_t> content_size(std::string_view frame);
+
+} // namespace mini_redis::lz4
@@ -0,0 +1,78 @@
+// =============================================================================
+// new_delete.cpp — Route Every operator new / delete Through Allocator
+// =============================================================================
+//
+// C++ lets a program REPLACE the global allocation functions: define them
+// once, anywhere in the program, and every `new`, std::string, std::vector
+// and node-based container uses them. That is how the request path (the
+// socket buffer, HttpRequest, the parsed headers, the response text) gets
+// the per-thread caches without touching each class.
+//
+// Linked by the mini_redis executable and by the targets that must see
+// the heap the way the server does, with key and value strings in the
+// huge-page arena:
+//
+//   test_defrag          the only TEST run under these operators (string
+//                        buffers must survive being relocated)
+//   bench_huge_pages, bench_defrag, bench_integer_keys
+//
+// Every other test and benchmark uses the default operators, so a bug
+// here can't hide behind them — and test_allocator calls Allocator
+// directly.
+//
+// Sized delete (C++14) passes the size back, which saves the system
+// backend a malloc_usable_size() call. Over-aligned types (alignas > 16)
+// keep the library's aligned operators: our classes only guarantee 16.
+// =============================================================================
+
+#include "util/allocator.hpp"
+
+#include <new>
+
+namespace {
+
+void *allocate_or_throw(std::size_t size) {
+  void *memory = mini_redis::Allocator::allocate(size);
+  if (memory == nullptr) {
+    throw std::bad_alloc(); // required by the standard for operator new
+  }
+  return memory;
+}
+
+} // anonymous namespace
+
+void *operator new(std::size_t size) { return allocate_or_throw(size); }
+
+void *operator new[](std::size_t size) { return allocate_or_throw(size); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  return mini_redis::Allocator::allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+  return mini_redis::Allocator::allocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+  mini_redis::Allocator::deallocate(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+  mini_redis::Allocator::deallocate(ptr);
+}
+
+void operator delete(void *ptr, std::size_t size) noexcept {
+  mini_redis::Allocator::deallocate(ptr, size);
+}
+
+void operator delete[](void *ptr, std::size_t size) noexcept {
+  mini_redis::Allocator::deallocate(ptr, size);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  mini_redis::Allocator::deallocate(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  mini_redis::Allocator::deallocate(ptr);
+}
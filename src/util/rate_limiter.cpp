@@ -0,0 +1,240 @@
+// =============================================================================
+// rate_limiter.cpp — Per-Client Token Buckets, Lock-Free (IMPLEMENTATION)
+// =============================================================================
+
+#include "util/rate_limiter.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm> // std::min, std::max, std::clamp
+#include <cstdint>   // UINT32_MAX
+
+namespace mini_redis {
+
+namespace {
+
+// ---- One bucket in one word ----
+// bits 63..24 : when it was last refilled, in ms on the limiter's clock
+//               (40 bits: 34 years)
+// bits 23..0  : tokens, in 1/256ths (so at most 65535 whole tokens)
+constexpr unsigned TOKEN_BITS = 24;
+constexpr std::uint64_t TOKEN_MASK = (std::uint64_t{1} << TOKEN_BITS) - 1;
+constexpr std::uint64_t TOKEN = 256; // one whole token
+
+std::uint64_t pack(std::uint64_t time_ms, std::uint64_t tokens) {
+  return (time_ms << TOKEN_BITS) | tokens;
+}
+
+std::uint64_t bucket_time(std::uint64_t state) { return state >> TOKEN_BITS; }
+
+std::uint64_t bucket_tokens(std::uint64_t state) { return state & TOKEN_MASK; }
+
+// A slot's key is never 0 (0 marks a never-used slot)
+std::uint64_t client_hash(std::string_view client) {
+  const std::uint64_t hash = hash_key(client);
+  return hash == 0 ? 1 : hash;
+}
+
+// How long an empty bucket takes to fill up again. A bucket untouched
+// for that long is full, whatever it held: the same as a new one.
+std::uint64_t full_refill_ms(std::uint64_t rate, std::uint64_t burst) {
+  return (burst * 1000 + rate - 1) / rate;
+}
+
+// A state of 0 was never written: the slot's client hasn't taken a
+// token yet (or is just claiming it), so its bucket is full
+bool is_idle(std::uint64_t state, std::uint64_t now_ms,
+             std::uint64_t full_ms) {
+  return state == 0 ||
+         now_ms - std::min(now_ms, bucket_time(state)) >= full_ms;
+}
+
+} // anonymous namespace
+
+std::optional<RateLimitKey> parse_rate_limit_key(std::string_view name) {
+  if (name == "ip") {
+    return RateLimitKey::IP;
+  }
+  if (name == "api_key") {
+    return RateLimitKey::API_KEY;
+  }
+  if (name == "namespace") {
+    return RateLimitKey::NAMESPACE;
+  }
+  return std::nullopt;
+}
+
+const char *rate_limit_key_name(RateLimitKey key) {
+  switch (key) {
+  case RateLimitKey::IP:
+    return "ip";
+  case RateLimitKey::API_KEY:
+    return "api_key";
+  case RateLimitKey::NAMESPACE:
+    return "namespace";
+  }
+  return "ip";
+}
+
+RateLimiter::RateLimiter()
+    : start_(std::chrono::steady_clock::now()),
+      slots_(std::make_unique<Slot[]>(SLOTS)) {}
+
+void RateLimiter::configure(std::uint64_t rate, std::uint64_t burst) {
+  rate = std::min<std::uint64_t>(rate, UINT32_MAX);
+  burst = std::clamp<std::uint64_t>(burst == 0 ? rate : burst, 1, MAX_BURST);
+  config_.store(rate == 0 ? 0 : (rate << 32) | burst,
+                std::memory_order_relaxed);
+}
+
+bool RateLimiter::enabled() const {
+  return config_.load(std::memory_order_relaxed) != 0;
+}
+
+// The clock starts at 1, so that a written state is never 0
+std::uint64_t RateLimiter::now_ms() const {
+  const auto elapsed = std::chrono::steady_clock::now() - start_;
+  return static_cast<std::uint64_t>(
+             std::chrono::duration_cast<std::chrono::milliseconds>(elapsed)
+                 .count()) +
+         1;
+}
+
+RateLimiter::Decision RateLimiter::acquire(std::string_view client) {
+  if (!enabled()) {
+    return Decision{};
+  }
+  return acquire(client, now_ms());
+}
+
+// =============================================================================
+// acquire() — Refill, then take a token, in one CAS
+// =============================================================================
+// The new state depends only on the old one and the clock, so a thread
+// that loses the race just recomputes from the value it lost to. A
+// refused request writes nothing: clients hammering an empty bucket only
+// read the shared cache line, they don't fight over it.
+// =============================================================================
+RateLimiter::Decision RateLimiter::acquire(std::string_view client,
+                                           std::uint64_t now_ms) {
+  const std::uint64_t config = config_.load(std::memory_order_relaxed);
+  if (config == 0) {
+    return Decision{};
+  }
+  const std::uint64_t rate = config >> 32;
+  const std::uint64_t burst = config & UINT32_MAX;
+  const std::uint64_t capacity = burst * TOKEN;
+  const std::uint64_t full_ms = full_refill_ms(rate, burst);
+
+  Slot *slot = find_slot(client_hash(client), now_ms, full_ms);
+  if (slot == nullptr) {
+    untracked_.fetch_add(1, std::memory_order_relaxed);
+    allowed_.fetch_add(1, std::memory_order_relaxed);
+    return Decision{};
+  }
+
+  std::uint64_t state = slot->state.load(std::memory_order_acquire);
+  while (true) {
+    std::uint64_t tokens = capacity;
+    if (!is_idle(state, now_ms, full_ms)) {
+      const std::uint64_t elapsed =
+          now_ms - std::min(now_ms, bucket_time(state));
+      // elapsed < full_ms, so this stays far from overflowing
+      tokens = std::min(capacity, bucket_tokens(state) +
+                                      elapsed * rate * TOKEN / 1000);
+    }
+    if (tokens < TOKEN) {
+      rejected_.fetch_add(1, std::memory_order_relaxed);
+      const std::uint64_t missing = TOKEN - tokens;
+      return Decision{false,
+                      (missing * 1000 + rate * TOKEN - 1) / (rate * TOKEN)};
+    }
+    // Time only moves forward in the word: a thread with an older 'now'
+    // mustn't rewind a bucket another thread has just refilled
+    const std::uint64_t time = std::max(now_ms, bucket_time(state));
+    if (slot->state.compare_exchange_weak(state, pack(time, tokens - TOKEN),
+                                          std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+      allowed_.fetch_add(1, std::memory_order_relaxed);
+      return Decision{};
+    }
+  }
+}
+
+// =============================================================================
+// find_slot() — The client's slot, or one to claim for it
+// =============================================================================
+// Keys are never reset to 0, only replaced, so a probe sequence has no
+// holes: the first never-used slot ends the search. On the way, the first
+// slot whose bucket is idle (full) is remembered as the one to take over.
+//
+// Two threads seeing the same new client may pick DIFFERENT free slots;
+// the client then briefly has two buckets, until one of them goes idle
+// and is taken over. A rare, short-lived double allowance, in exchange
+// for never locking.
+// =============================================================================
+RateLimiter::Slot *RateLimiter::find_slot(std::uint64_t hash,
+                                          std::uint64_t now_ms,
+                                          std::uint64_t full_ms) {
+  for (int attempt = 0; attempt < 2; ++attempt) {
+    Slot *candidate = nullptr;
+    std::uint64_t candidate_key = 0;
+    for (std::size_t i = 0; i < MAX_PROBES; ++i) {
+      Slot &slot = slots_[(hash + i) & (SLOTS - 1)];
+      const std::uint64_t key = slot.key.load(std::memory_order_acquire);
+      if (key == hash) {
+        return &slot;
+      }
+      if (key == 0) {
+        if (candidate == nullptr) {
+          candidate = &slot;
+          candidate_key = 0;
+        }
+        break;
+      }
+      if (candidate == nullptr &&
+          is_idle(slot.state.load(std::memory_order_relaxed), now_ms,
+                  full_ms)) {
+        candidate = &slot;
+        candidate_key = key;
+      }
+    }
+    if (candidate == nullptr) {
+      return nullptr; // every slot in reach is busy
+    }
+    // Taking over an idle slot leaves its state as is: idle reads as full
+    if (candidate->key.compare_exchange_strong(candidate_key, hash,
+                                               std::memory_order_acq_rel)) {
+      return candidate;
+    }
+    if (candidate_key == hash) {
+      return candidate; // another thread claimed it for the same client
+    }
+    // Someone else got it first: look again
+  }
+  return nullptr;
+}
+
+RateLimiterStats RateLimiter::stats() const {
+  const std::uint64_t config = config_.load(std::memory_order_relaxed);
+  RateLimiterStats stats;
+  stats.rate = config >> 32;
+  stats.burst = config & UINT32_MAX;
+  stats.allowed = allowed_.load(std::memory_order_relaxed);
+  stats.rejected = rejected_.load(std::memory_order_relaxed);
+  stats.untracked = untracked_.load(std::memory_order_relaxed);
+  if (stats.rate != 0) {
+    const std::uint64_t now = now_ms();
+    const std::uint64_t full_ms = full_refill_ms(stats.rate, stats.burst);
+    for (std::size_t i = 0; i < SLOTS; ++i) {
+      const Slot &slot = slots_[i];
+      if (slot.key.load(std::memory_order_relaxed) != 0 &&
+          !is_idle(slot.state.load(std::memory_order_relaxed), now,
+                   full_ms)) {
+        ++stats.active_clients;
+      }
+    }
+  }
+  return stats;
+}
+
+} // namespace mini_redis
@@ -0,0 +1,117 @@
+// =============================================================================
+// rate_limiter.hpp — Per-Client Token Buckets, Lock-Free (HEADER)
+// =============================================================================
+//
+// One client sending as fast as it can would keep every worker thread
+// busy. A TOKEN BUCKET per client caps that:
+//   - the bucket holds up to 'burst' tokens and starts full
+//   - it refills at 'rate' tokens per second
+//   - each request takes one token; with none left it is refused (429)
+// So a client gets 'rate' requests per second on average, and may spend
+// up to 'burst' of them at once after a quiet spell.
+//
+// WHY LOCK-FREE?
+// The limiter sits in front of EVERY request, from every worker thread;
+// a mutex there would serialize the whole server on one lock. Instead:
+//   - the table is a fixed array of slots, open addressing with linear
+//     probing; a slot is claimed by CAS-ing its key from 0 (or from an
+//     idle client's key) to the client's hash
+//   - a bucket is ONE 64-bit word, (last refill time << 24) | tokens, so
+//     "refill, then take a token" is a single compare-and-swap: read the
+//     word, compute the new one, CAS; on a race, recompute and retry
+// Tokens are fixed-point (1/256 of a token), so slow rates refill
+// smoothly rather than in whole tokens.
+//
+// The table never grows. A slot whose bucket has been full for a while
+// (its client went quiet) can be taken over by a new client, so the
+// table holds only the recently active ones. If even that fails — SLOTS
+// clients active at once — the request is let through and counted as
+// 'untracked': a limiter must never turn into an outage.
+// =============================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory> // std::unique_ptr
+#include <optional>
+#include <string_view>
+
+namespace mini_redis {
+
+// ---- RateLimitKey — What identifies "one client" ----
+// IP        : the peer's address
+// API_KEY   : the X-API-Key header (the address when there is none)
+// NAMESPACE : the /ns/<name>/... the request targets (the address for
+//             requests outside any namespace)
+enum class RateLimitKey { IP, API_KEY, NAMESPACE };
+
+std::optional<RateLimitKey> parse_rate_limit_key(std::string_view name);
+const char *rate_limit_key_name(RateLimitKey key);
+
+// ---- RateLimiterStats — What the limiter has decided so far ----
+struct RateLimiterStats {
+  std::uint64_t rate = 0;  // tokens per second; 0 = off
+  std::uint64_t burst = 0; // bucket size
+  std::uint64_t allowed = 0;
+  std::uint64_t rejected = 0;
+  std::uint64_t untracked = 0; // let through: no slot free
+  std::uint64_t active_clients = 0; // slots in use and not idle
+};
+
+class RateLimiter {
+public:
+  static constexpr std::size_t SLOTS = 1 << 16; // 1 MB of slots
+  static constexpr std::size_t MAX_PROBES = 16;
+  static constexpr std::uint64_t MAX_BURST = 65535;
+
+  RateLimiter();
+
+  // ---- configure() — Live: takes effect on the next request ----
+  // 'rate' tokens per second, 0 = off. 'burst' 0 means "same as rate";
+  // it is clamped to [1, MAX_BURST].
+  void configure(std::uint64_t rate, std::uint64_t burst);
+
+  bool enabled() const;
+
+  // ---- acquire() — Take one token from the client's bucket ----
+  // allowed = false: the client is over its limit, and one token will be
+  // back in about retry_after_ms.
+  struct Decision {
+    bool allowed = true;
+    std::uint64_t retry_after_ms = 0;
+  };
+  Decision acquire(std::string_view client);
+
+  // The same, at a given time (milliseconds on the limiter's own clock,
+  // starting at 1): for tests, which can't wait for real seconds to pass
+  Decision acquire(std::string_view client, std::uint64_t now_ms);
+
+  RateLimiterStats stats() const;
+
+private:
+  struct Slot {
+    std::atomic<std::uint64_t> key{0};   // client hash; 0 = never used
+    std::atomic<std::uint64_t> state{0}; // time << TOKEN_BITS | tokens
+  };
+
+  Slot *find_slot(std::uint64_t hash, std::uint64_t now_ms,
+                  std::uint64_t full_ms);
+
+  std::uint64_t now_ms() const;
+
+  // rate << 32 | burst: one load gives a consistent pair
+  std::atomic<std::uint64_t> config_{0};
+
+  std::atomic<std::uint64_t> allowed_{0};
+  std::atomic<std::uint64_t> rejected_{0};
+  std::atomic<std::uint64_t> untracked_{0};
+
+  const std::chrono::steady_clock::time_point start_;
+  // On the heap: the owner (the Application) lives on main()'s stack
+  const std::unique_ptr<Slot[]> slots_;
+};
+
+} // namespace mini_redis
@@ -0,0 +1,151 @@
+// =============================================================================
+// test_allocator.cpp — Unit Tests for the Allocator and its Thread Caches
+// =============================================================================
+//
+// The thread-cache checks only make sense for the system backend (jemalloc
+// and mimalloc keep their own caches out of our sight), so they skip
+// themselves when the project was configured with another one.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
+
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using mini_redis::Allocator;
+using mini_redis::StlAllocator;
+
+namespace {
+
+bool system_backend() {
+  return std::string(Allocator::backend_name()) == "system";
+}
+
+} // anonymous namespace
+
+TEST(AllocatorTest, AllocationsAreUsableAndAligned) {
+  std::vector<void *> blocks;
+  for (std::size_t size : {0u, 1u, 15u, 16u, 17u, 100u, 1024u, 1025u,
+                           70000u}) {
+    void *block = Allocator::allocate(size);
+    ASSERT_NE(block, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % 16, 0u);
+    std::memset(block, 0xab, size);
+    blocks.push_back(block);
+  }
+  for (std::size_t i = 0; i < blocks.size(); ++i) {
+    Allocator::deallocate(blocks[i], i % 2 ? 0 : 1); // sized and unsized
+  }
+}
+
+TEST(AllocatorTest, FreedBlocksAreReusedByTheSameThread) {
+  if (!system_backend()) {
+    GTEST_SKIP() << "thread caches belong to " << Allocator::backend_name();
+  }
+  void *first = Allocator::allocate(40);
+  Allocator::deallocate(first, 40);
+  const auto before = Allocator::stats();
+  // 33..48 bytes share a size class, so the block comes straight back
+  void *second = Allocator::allocate(48);
+  EXPECT_EQ(second, first);
+  EXPECT_EQ(Allocator::stats().cache_hits, before.cache_hits + 1);
+  Allocator::deallocate(second); // unsized: filed by malloc_usable_size
+}
+
+TEST(AllocatorTest, PurgeEmptiesEveryThreadsCache) {
+  if (!system_backend()) {
+    GTEST_SKIP() << "thread caches belong to " << Allocator::backend_name();
+  }
+  std::vector<void *> blocks;
+  for (int i = 0; i < 1000; ++i) {
+    blocks.push_back(Allocator::allocate(64));
+  }
+  for (void *block : blocks) {
+    Allocator::deallocate(block, 64);
+  }
+  EXPECT_GE(Allocator::stats().cached_bytes, 1000u * 64);
+
+  const auto purges = Allocator::stats().purges;
+  Allocator::purge();
+  EXPECT_EQ(Allocator::stats().purges, purges + 1);
+  EXPECT_EQ(Allocator::stats().cached_bytes, 0u);
+}
+
+TEST(AllocatorTest, ThreadCachesAreCappedAndRetiredOnExit) {
+  if (!system_backend()) {
+    GTEST_SKIP() << "thread caches belong to " << Allocator::backend_name();
+  }
+  const auto before = Allocator::stats();
+  std::thread worker([] {
+    // 4 MB freed by one thread: only the first 512 KB may stay cached
+    std::vector<void *> blocks;
+    for (int i = 0; i < 4096; ++i) {
+      blocks.push_back(Allocator::allocate(1024));
+    }
+    for (void *block : blocks) {
+      Allocator::deallocate(block, 1024);
+    }
+    EXPECT_LE(Allocator::stats().cached_bytes, 2u * 512 * 1024);
+  });
+  worker.join();
+
+  const auto after = Allocator::stats();
+  EXPECT_EQ(after.threads, before.threads); // its cache went with it
+  EXPECT_GE(after.allocations, before.allocations + 4096);
+  EXPECT_GE(after.frees, before.frees + 4096);
+}
+
+TEST(AllocatorTest, DecayPurgesOnTick) {
+  Allocator::set_decay_ms(0);
+  const auto purges = Allocator::stats().purges;
+  Allocator::tick(); // decay off: nothing happens
+  EXPECT_EQ(Allocator::stats().purges, purges);
+
+  Allocator::set_decay_ms(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  Allocator::tick();
+  EXPECT_EQ(Allocator::stats().purges, purges + 1);
+  EXPECT_EQ(Allocator::stats().decay_ms, 1u);
+  Allocator::set_decay_ms(0);
+}
+
+TEST(AllocatorTest, StatsReportTheHeap) {
+  const auto stats = Allocator::stats();
+  EXPECT_GT(std::strlen(stats.backend), 0u);
+  EXPECT_GT(stats.resident_bytes, 0u);
+  EXPECT_GT(stats.heap_used_bytes, 0u);
+}
+
+TEST(AllocatorTest, StandardContainersWork) {
+  std::unordered_map<int, std::string, std::hash<int>, std::equal_to<int>,
+                     StlAllocator<std::pair<const int, std::string>>>
+      map;
+  for (int i = 0; i < 10000; ++i) {
+    map.emplace(i, std::to_string(i));
+  }
+  EXPECT_EQ(map.at(1234), "1234");
+  map.clear();
+
+  std::vector<int, StlAllocator<int>> numbers(5000, 7);
+  EXPECT_EQ(numbers.back(), 7);
+}
+
+TEST(AllocatorTest, StoreRunsOnTheAllocator) {
+  const auto before = Allocator::stats();
+  mini_redis::KeyValueStore store;
+  for (int i = 0; i < 1000; ++i) {
+    store.restore("key:" + std::to_string(i), {std::string("v"), {}});
+  }
+  EXPECT_EQ(store.get("key:500"), "v");
+  if (system_backend()) {
+    // One node per key, plus bucket arrays as the shards grow
+    EXPECT_GE(Allocator::stats().allocations, before.allocations + 1000);
+  }
+}
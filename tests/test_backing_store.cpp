@@ -0,0 +1,316 @@
+// =============================================================================
+// test_backing_store.cpp — Unit Tests for Read-Through / Write-Behind
+// =============================================================================
+//
+// The file backing store stands in for the database. A thin subclass
+// counts its loads and can slow them down or fail its writes, to check
+// that concurrent misses share one load, that queued writes are batched
+// and retried, that every string write is sent, and that a miss never
+// reads a value older than the cache's own last write.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/backing_store.hpp"
+#include "core/key_value_store.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::BackingWrite;
+using mini_redis::FileBackingStore;
+using mini_redis::KeyValueStore;
+using mini_redis::WriteBehindOptions;
+
+namespace {
+
+// Nothing is sent unless the test calls flush_backing_store()
+const WriteBehindOptions MANUAL{1 << 20, std::chrono::hours(1)};
+
+class TestBackingStore : public FileBackingStore {
+public:
+  using FileBackingStore::FileBackingStore;
+
+  std::optional<std::string> load(const std::string &key) override {
+    loads.fetch_add(1);
+    std::this_thread::sleep_for(load_delay);
+    return FileBackingStore::load(key);
+  }
+
+  bool write_batch(const std::vector<BackingWrite> &batch) override {
+    if (failures_left.load() > 0) {
+      failures_left.fetch_sub(1);
+      return false;
+    }
+    return FileBackingStore::write_batch(batch);
+  }
+
+  std::atomic<int> loads{0};
+  std::atomic<int> failures_left{0};
+  std::chrono::milliseconds load_delay{0};
+};
+
+class BackingStoreTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    const auto *test = ::testing::UnitTest::GetInstance()->current_test_info();
+    directory_ = ::testing::TempDir() + "mini_redis_backing_" + test->name();
+    std::filesystem::remove_all(directory_);
+    backing_ = std::make_shared<TestBackingStore>(directory_);
+  }
+  void TearDown() override { std::filesystem::remove_all(directory_); }
+
+  void put(const std::string &key, const std::string &value) {
+    ASSERT_TRUE(backing_->FileBackingStore::write_batch({{key, value}}));
+  }
+
+  std::string directory_;
+  std::shared_ptr<TestBackingStore> backing_;
+};
+
+} // anonymous namespace
+
+TEST_F(BackingStoreTest, FileStoreRoundTrip) {
+  FileBackingStore files(directory_);
+  EXPECT_FALSE(files.load("user:1").has_value());
+  ASSERT_TRUE(files.write_batch({{"user:1", std::string("alice")},
+                                 {"bin\n/../\xff", std::string("x\0y", 3)},
+                                 {"empty", std::string()}}));
+  EXPECT_EQ(files.load("user:1"), "alice");
+  EXPECT_EQ(files.load("bin\n/../\xff"), std::string("x\0y", 3));
+  EXPECT_EQ(files.load("empty"), "");
+
+  ASSERT_TRUE(files.write_batch({{"user:1", std::nullopt},
+                                 {"never-written", std::nullopt}}));
+  EXPECT_FALSE(files.load("user:1").has_value());
+
+  // Too long for a file name: skipped, not an error
+  const std::string long_key(FileBackingStore::MAX_KEY_BYTES + 1, 'k');
+  EXPECT_TRUE(files.write_batch({{long_key, std::string("v")}}));
+  EXPECT_FALSE(files.load(long_key).has_value());
+}
+
+TEST_F(BackingStoreTest, MissesReadThroughAndAreCached) {
+  put("user:1", "alice");
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+
+  EXPECT_EQ(store.get("user:1"), "alice");
+  EXPECT_EQ(store.get("user:1"), "alice"); // from the cache now
+  EXPECT_EQ(backing_->loads.load(), 1);
+  EXPECT_FALSE(store.get("nobody").has_value());
+  EXPECT_EQ(store.keys().size(), 1u); // a miss caches nothing
+
+  // A key holding another type is not looked up
+  store.modify_as<mini_redis::Set>("tags", true, [](mini_redis::Set &set) {
+    set.add("a");
+    return true;
+  });
+  EXPECT_FALSE(store.get("tags").has_value());
+  EXPECT_EQ(backing_->loads.load(), 2);
+
+  const auto stats = store.backing_stats();
+  ASSERT_TRUE(stats.has_value());
+  EXPECT_EQ(stats->loads, 2u);
+  EXPECT_EQ(stats->load_hits, 1u);
+}
+
+TEST_F(BackingStoreTest, ConcurrentMissesShareOneLoad) {
+  put("hot", "value");
+  backing_->load_delay = std::chrono::milliseconds(200);
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+
+  std::vector<std::thread> threads;
+  std::atomic<int> found{0};
+  for (int t = 0; t < 8; ++t) {
+    threads.emplace_back([&] {
+      if (store.get("hot") == "value") {
+        found.fetch_add(1);
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(found.load(), 8);
+  EXPECT_EQ(backing_->loads.load(), 1);
+  EXPECT_EQ(store.backing_stats()->coalesced, 7u);
+}
+
+TEST_F(BackingStoreTest, WritesAreQueuedAndSentInBatches) {
+  KeyValueStore store;
+  store.set_backing_store(backing_,
+                          WriteBehindOptions{4, std::chrono::hours(1)});
+
+  for (int i = 0; i < 10; ++i) {
+    store.set("counter", std::to_string(i));
+  }
+  store.set("a", "1");
+  store.set("b", "2");
+  ASSERT_TRUE(store.flush_backing_store());
+
+  FileBackingStore files(directory_);
+  EXPECT_EQ(files.load("counter"), "9"); // the last of ten, sent once
+  EXPECT_EQ(files.load("a"), "1");
+  auto stats = store.backing_stats();
+  EXPECT_EQ(stats->queued, 12u);
+  EXPECT_EQ(stats->superseded, 9u);
+  EXPECT_EQ(stats->written, 3u);
+  EXPECT_EQ(stats->batches, 1u);
+  EXPECT_EQ(stats->pending, 0u);
+
+  // A full batch wakes the writer without a flush
+  for (int i = 0; i < 4; ++i) {
+    store.set("batch:" + std::to_string(i), "x");
+  }
+  for (int i = 0; i < 1000 && store.backing_stats()->pending > 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  EXPECT_EQ(files.load("batch:3"), "x");
+
+  store.remove("a");
+  store.remove("never-cached"); // may still exist in the backing store
+  ASSERT_TRUE(store.flush_backing_store());
+  EXPECT_FALSE(files.load("a").has_value());
+}
+
+// MGET, GETBIT / BITCOUNT and BITOP's sources miss like GET does
+TEST_F(BackingStoreTest, EveryStringReadReadsThrough) {
+  put("a", "1");
+  put("b", "2");
+  put("bits", "xyz");
+  put("source", "src");
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+
+  const auto values = store.get_many({"a", "nobody", "b"});
+  ASSERT_EQ(values.size(), 3u);
+  EXPECT_EQ(values[0], "1");
+  EXPECT_FALSE(values[1].has_value());
+  EXPECT_EQ(values[2], "2");
+
+  std::string seen;
+  EXPECT_EQ(store.read_as<std::string>(
+                "bits", [&](const std::string &text) { seen = text; }),
+            mini_redis::AccessStatus::OK);
+  EXPECT_EQ(seen, "xyz");
+
+  store.read_values({"source"},
+                    [&](const std::vector<const mini_redis::StoreValue *> &v) {
+                      ASSERT_NE(v[0], nullptr);
+                      EXPECT_EQ(*mini_redis::string_value(*v[0]), "src");
+                    });
+  EXPECT_EQ(backing_->loads.load(), 5); // "nobody" included, once
+  EXPECT_EQ(store.keys().size(), 4u);   // and the rest are cached now
+}
+
+// Until a write is sent, the backing store holds an older value: a miss
+// must see the queued write instead
+TEST_F(BackingStoreTest, MissesSeeQueuedWrites) {
+  put("deleted", "stale");
+  put("expired", "stale");
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+
+  EXPECT_TRUE(store.remove("deleted")); // held only by the backing store
+  EXPECT_FALSE(store.get("deleted").has_value());
+  EXPECT_FALSE(store.remove("deleted")); // the queued delete is seen
+  EXPECT_FALSE(store.remove("nowhere"));
+
+  store.set("expired", "fresh");
+  store.set("expired", "fresh", 1); // cache only: "fresh" stays queued
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  EXPECT_EQ(store.get("expired"), "fresh"); // the cached copy expired
+  EXPECT_EQ(backing_->loads.load(), 2); // the two remove()s of unqueued keys
+  EXPECT_EQ(store.backing_stats()->queue_hits, 3u);
+}
+
+// The backing store has no TTLs: a write with one overrides its value in
+// the cache only, and must never delete the system of record's copy
+TEST_F(BackingStoreTest, TtlWritesStayInTheCache) {
+  put("session", "stored");
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+
+  store.set("session", "temporary", 1);
+  EXPECT_EQ(store.get("session"), "temporary");
+  ASSERT_TRUE(store.flush_backing_store());
+  EXPECT_EQ(store.backing_stats()->queued, 0u);
+  EXPECT_EQ(FileBackingStore(directory_).load("session"), "stored");
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1100));
+  EXPECT_EQ(store.get("session"), "stored"); // loaded again
+  EXPECT_EQ(backing_->loads.load(), 1);
+}
+
+// SETBIT-style edits and restore() change strings without set(): they
+// must read the stored value first and send the result
+TEST_F(BackingStoreTest, EveryStringWriteIsSent) {
+  put("text", "ab");
+  put("emptied", "x");
+  put("typed", "old");
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+
+  const auto append = [](std::string &text) {
+    text += "c";
+    return true;
+  };
+  EXPECT_EQ(store.modify_as<std::string>("text", true, append),
+            mini_redis::AccessStatus::OK);
+  EXPECT_EQ(store.modify_as<std::string>("new", true, append),
+            mini_redis::AccessStatus::OK);
+  EXPECT_EQ(store.modify_as<std::string>(
+                "emptied", false, [](std::string &) { return false; }),
+            mini_redis::AccessStatus::OK);
+  store.restore("copy", mini_redis::StoreEntry{std::string("v"), std::nullopt});
+  store.restore("typed",
+                mini_redis::StoreEntry{mini_redis::Set{}, std::nullopt});
+  EXPECT_EQ(store.get("text"), "abc"); // read through, then edited
+
+  ASSERT_TRUE(store.flush_backing_store());
+  FileBackingStore files(directory_);
+  EXPECT_EQ(files.load("text"), "abc");
+  EXPECT_EQ(files.load("new"), "c");
+  EXPECT_FALSE(files.load("emptied").has_value());
+  EXPECT_EQ(files.load("copy"), "v");
+  EXPECT_FALSE(files.load("typed").has_value()); // no longer a string
+}
+
+TEST_F(BackingStoreTest, FailedBatchesAreRetried) {
+  backing_->failures_left = 1;
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+  store.set("k", "v1");
+  EXPECT_FALSE(store.flush_backing_store()); // the first attempt failed
+  store.set("k", "v2");                      // newer than the failed one
+  EXPECT_TRUE(store.flush_backing_store());
+
+  EXPECT_EQ(FileBackingStore(directory_).load("k"), "v2");
+  const auto stats = store.backing_stats();
+  EXPECT_EQ(stats->failed_batches, 1u);
+  EXPECT_EQ(stats->pending, 0u);
+}
+
+// Detaching (or destroying the store) sends what is still queued
+TEST_F(BackingStoreTest, DetachingSendsTheQueue) {
+  {
+    KeyValueStore store;
+    store.set_backing_store(backing_, MANUAL);
+    store.set("k", "v");
+  }
+  EXPECT_EQ(FileBackingStore(directory_).load("k"), "v");
+
+  KeyValueStore store;
+  store.set_backing_store(backing_, MANUAL);
+  store.set("j", "w");
+  store.set_backing_store(nullptr);
+  EXPECT_FALSE(store.backing_stats().has_value());
+  EXPECT_EQ(FileBackingStore(directory_).load("j"), "w");
+}
@@ -0,0 +1,206 @@
+// =============================================================================
+// test_bitmap.cpp — Unit Tests for String Bitmaps and Roaring Bitmaps
+// =============================================================================
+//
+// The SIMD kernels are checked against the portable versions on awkward
+// lengths (not multiples of 32), and the roaring bitmap against the plain
+// string form: both must answer every query identically.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/bitmap.hpp"
+#include "core/bitmap_ops.hpp"
+#include "core/roaring_bitmap.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::BitOp;
+using mini_redis::ByteRange;
+using mini_redis::RoaringBitmap;
+
+namespace {
+
+std::string random_bytes(std::size_t length, std::mt19937 &rng) {
+  std::string bytes(length, '\0');
+  for (auto &byte : bytes) {
+    byte = static_cast<char>(rng() & 0xFF);
+  }
+  return bytes;
+}
+
+const std::uint8_t *as_bytes(const std::string &text) {
+  return reinterpret_cast<const std::uint8_t *>(text.data());
+}
+
+} // anonymous namespace
+
+// --- Test: SIMD kernels agree with the portable ones ---
+TEST(BitmapOpsTest, KernelsMatchScalar) {
+  std::mt19937 rng(7);
+  for (const std::size_t length : {0u, 1u, 31u, 33u, 1000u, 8191u, 65537u}) {
+    const std::string a = random_bytes(length, rng);
+    const std::string b = random_bytes(length, rng);
+    EXPECT_EQ(mini_redis::bit_count(as_bytes(a), length),
+              mini_redis::bit_count_scalar(as_bytes(a), length));
+
+    for (const BitOp op : {BitOp::AND, BitOp::OR, BitOp::XOR}) {
+      std::string fast = a;
+      std::string slow = a;
+      mini_redis::bitwise(op, reinterpret_cast<std::uint8_t *>(fast.data()),
+                          as_bytes(b), length);
+      mini_redis::bitwise_scalar(
+          op, reinterpret_cast<std::uint8_t *>(slow.data()), as_bytes(b),
+          length);
+      EXPECT_EQ(fast, slow);
+    }
+  }
+}
+
+// --- Test: Redis bit order and growth ---
+TEST(StringBitmapTest, SetGetBitOrder) {
+  std::string bytes;
+  EXPECT_FALSE(mini_redis::set_bit(bytes, 7, true));
+  EXPECT_EQ(bytes, std::string(1, '\x01')); // bit 7 = LSB of byte 0
+  EXPECT_FALSE(mini_redis::set_bit(bytes, 8, true));
+  EXPECT_EQ(bytes, std::string("\x01\x80", 2));
+  EXPECT_TRUE(mini_redis::set_bit(bytes, 8, false));
+  EXPECT_TRUE(mini_redis::get_bit(bytes, 7));
+  EXPECT_FALSE(mini_redis::get_bit(bytes, 8));
+  EXPECT_FALSE(mini_redis::get_bit(bytes, 1'000'000)); // past the end
+}
+
+// --- Test: BITCOUNT / BITPOS with Redis range rules ---
+TEST(StringBitmapTest, CountAndPositionRanges) {
+  const std::string bytes("\xff\xf0\x00", 3);
+  const auto all = mini_redis::resolve_byte_range(0, -1, bytes.size());
+  ASSERT_TRUE(all.has_value());
+  EXPECT_EQ(mini_redis::count_bits(bytes, *all), 12u);
+  EXPECT_EQ(mini_redis::count_bits(
+                bytes, *mini_redis::resolve_byte_range(1, 1, bytes.size())),
+            4u);
+  EXPECT_EQ(mini_redis::count_bits(
+                bytes, *mini_redis::resolve_byte_range(-2, -1, bytes.size())),
+            4u);
+  EXPECT_FALSE(mini_redis::resolve_byte_range(2, 1, bytes.size()).has_value());
+  EXPECT_FALSE(mini_redis::resolve_byte_range(0, -1, 0).has_value());
+
+  EXPECT_EQ(mini_redis::find_bit(bytes, false, *all), 12u);
+  EXPECT_EQ(mini_redis::find_bit(bytes, true, *all), 0u);
+  EXPECT_EQ(mini_redis::find_bit(bytes, true, ByteRange{2, 2}), std::nullopt);
+
+  // The SIMD scan path (ranges longer than 32 bytes)
+  std::string long_bytes(1000, '\0');
+  mini_redis::set_bit(long_bytes, 6543, true);
+  EXPECT_EQ(mini_redis::find_bit(long_bytes, true, ByteRange{0, 999}), 6543u);
+}
+
+// --- Test: BITOP pads shorter sources with zeros ---
+TEST(StringBitmapTest, CombineDifferentLengths) {
+  const std::string a("\xff\xff\xff", 3);
+  const std::string b("\x0f", 1);
+  EXPECT_EQ(mini_redis::combine_bits(BitOp::AND, {a, b}),
+            std::string("\x0f\x00\x00", 3));
+  EXPECT_EQ(mini_redis::combine_bits(BitOp::OR, {b, a}), a);
+  EXPECT_EQ(mini_redis::combine_bits(BitOp::XOR, {a, b}),
+            std::string("\xf0\xff\xff", 3));
+  EXPECT_EQ(mini_redis::invert_bits(b), std::string("\xf0", 1));
+}
+
+// --- Test: roaring matches the string bitmap under random edits ---
+// The offsets cluster in a few chunks so containers cross the 4096-entry
+// array/bitset threshold in both directions.
+TEST(RoaringBitmapTest, MatchesStringModel) {
+  std::mt19937 rng(42);
+  RoaringBitmap roaring;
+  std::string model;
+
+  for (int i = 0; i < 40'000; ++i) {
+    const std::uint32_t chunk = rng() % 3;
+    const std::uint32_t offset = chunk * 65536 * 5 + rng() % 12'000;
+    const bool value = (i < 25'000) ? (rng() % 4 != 0) : (rng() % 4 == 0);
+    EXPECT_EQ(roaring.set(offset, value),
+              mini_redis::set_bit(model, offset, value));
+  }
+
+  const auto all = mini_redis::resolve_byte_range(0, -1, model.size());
+  EXPECT_EQ(roaring.count(), mini_redis::count_bits(model, *all));
+  EXPECT_EQ(roaring.to_bytes().size(), roaring.byte_length());
+  EXPECT_EQ(roaring.to_bytes(),
+            model.substr(0, roaring.byte_length())); // model may be longer
+  EXPECT_EQ(RoaringBitmap::from_bytes(model).to_bytes(), roaring.to_bytes());
+
+  for (int i = 0; i < 200; ++i) {
+    const std::uint64_t first = rng() % model.size();
+    const std::uint64_t last = first + rng() % (model.size() - first);
+    const ByteRange range{first, last};
+    EXPECT_EQ(roaring.count_range(first * 8, last * 8 + 7),
+              mini_redis::count_bits(model, range));
+    EXPECT_EQ(roaring.find(true, first * 8, last * 8 + 7),
+              mini_redis::find_bit(model, true, range));
+    EXPECT_EQ(roaring.find(false, first * 8, last * 8 + 7),
+              mini_redis::find_bit(model, false, range));
+  }
+}
+
+// --- Test: sparse bits cost bytes, not megabytes ---
+TEST(RoaringBitmapTest, SparseIsSmall) {
+  RoaringBitmap roaring;
+  roaring.set(4'000'000'000u, true);
+  roaring.set(7, true);
+  EXPECT_EQ(roaring.count(), 2u);
+  EXPECT_EQ(roaring.container_count(), 2u);
+  EXPECT_LT(roaring.memory_bytes(), 256u);
+  EXPECT_EQ(roaring.byte_length(), 500'000'001u);
+  EXPECT_EQ(roaring.find(true, 8, ~0ULL), 4'000'000'000u);
+  EXPECT_EQ(roaring.find(false, 7, 7), std::nullopt);
+  EXPECT_EQ(roaring.find(false, 7, 100), 8u);
+}
+
+// --- Test: AND / OR / XOR agree with the string implementation ---
+TEST(RoaringBitmapTest, CombineMatchesStrings) {
+  std::mt19937 rng(3);
+  RoaringBitmap a;
+  RoaringBitmap b;
+  for (int i = 0; i < 20'000; ++i) {
+    a.set(rng() % 300'000, true);               // some dense chunks
+    b.set((rng() % 50) * 65536 + rng() % 100, true); // sparse arrays
+  }
+  const std::string a_bytes = a.to_bytes();
+  const std::string b_bytes = b.to_bytes();
+
+  for (const BitOp op : {BitOp::AND, BitOp::OR, BitOp::XOR}) {
+    const auto combined = RoaringBitmap::combine(op, {&a, &b, nullptr});
+    std::string expected =
+        mini_redis::combine_bits(op, {a_bytes, b_bytes, std::string_view()});
+    // Strings keep trailing zero bytes; roaring ends at its last set bit
+    expected.resize(combined.byte_length());
+    EXPECT_EQ(combined.to_bytes(), expected);
+  }
+}
+
+// --- Test: snapshot encoding round-trips both container forms ---
+TEST(RoaringBitmapTest, SerializeRoundTrip) {
+  RoaringBitmap bitmap;
+  for (std::uint32_t i = 0; i < 10'000; ++i) {
+    bitmap.set(i * 3, true); // bitset container(s)
+  }
+  bitmap.set(3'000'000'000u, true); // array container
+
+  std::string bytes;
+  bitmap.serialize(bytes);
+  mini_redis::ByteReader in(bytes);
+  const auto copy = RoaringBitmap::deserialize(in);
+  ASSERT_TRUE(copy.has_value());
+  EXPECT_TRUE(in.at_end());
+  EXPECT_EQ(copy->count(), bitmap.count());
+  EXPECT_EQ(copy->container_count(), bitmap.container_count());
+  EXPECT_TRUE(copy->get(3'000'000'000u));
+  EXPECT_TRUE(copy->get(29'997));
+
+  bytes[10] ^= 0x40; // corrupt the first container's form tag
+  mini_redis::ByteReader corrupted(bytes);
+  EXPECT_FALSE(RoaringBitmap::deserialize(corrupted).has_value());
+}
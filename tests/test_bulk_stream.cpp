@@ -0,0 +1,177 @@
+// =============================================================================
+// test_bulk_stream.cpp — Unit Tests for Bulk Export and Import
+// =============================================================================
+//
+// An export fed back into an importer must reproduce the store, however
+// the stream is cut into pieces on the way; a malformed or cut-off
+// stream must be reported rather than silently half-loaded.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/bulk_stream.hpp"
+#include "core/key_value_store.hpp"
+#include "core/sorted_set.hpp"
+#include "util/byte_codec.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <vector>
+
+using mini_redis::BulkImporter;
+using mini_redis::KeyValueStore;
+using mini_redis::SortedSet;
+
+namespace {
+
+// The export as one string, as a client saving it to a file would see it
+std::string export_bytes(const KeyValueStore &store, std::size_t chunk_bytes,
+                         std::size_t *records = nullptr) {
+  std::FILE *spool = std::tmpfile();
+  const auto count = mini_redis::encode_bulk_export(store, chunk_bytes, spool);
+  EXPECT_TRUE(count.has_value());
+  if (records != nullptr) {
+    *records = count.value_or(0);
+  }
+  std::string bytes(static_cast<std::size_t>(std::ftell(spool)), '\0');
+  std::rewind(spool);
+  EXPECT_EQ(std::fread(bytes.data(), 1, bytes.size(), spool), bytes.size());
+  std::fclose(spool);
+  return bytes;
+}
+
+// Feeds 'bytes' in pieces of 'piece' bytes
+bool import_bytes(KeyValueStore &store, const std::string &bytes,
+                  std::size_t piece, std::string *error = nullptr) {
+  BulkImporter importer(store, 3);
+  bool ok = true;
+  for (std::size_t pos = 0; ok && pos < bytes.size(); pos += piece) {
+    ok = importer.feed(std::string_view(bytes).substr(pos, piece));
+  }
+  ok = importer.finish() && ok;
+  if (error != nullptr) {
+    *error = importer.error();
+  }
+  return ok;
+}
+
+// A one-record stream by hand: the format a client would write
+std::string string_record_stream(const std::string &key,
+                                 const std::string &value) {
+  std::string record;
+  mini_redis::put_u8(record, 0); // string
+  mini_redis::put_bytes(record, key);
+  mini_redis::put_u64(record, std::numeric_limits<std::uint64_t>::max());
+  mini_redis::put_bytes(record, value);
+
+  std::string stream = "MRBULK01";
+  mini_redis::put_u64(stream, 1);
+  mini_redis::put_u32(stream, static_cast<std::uint32_t>(record.size()));
+  stream += record;
+  mini_redis::put_u32(stream, 0);
+  return stream;
+}
+
+} // anonymous namespace
+
+TEST(BulkStreamTest, ExportImportRoundTrip) {
+  KeyValueStore source;
+  for (int i = 0; i < 5000; ++i) {
+    source.set("key:" + std::to_string(i), "value " + std::to_string(i));
+  }
+  source.set("42", "an integer key");
+  source.set("session", "abc", 100);
+  source.modify_as<SortedSet>("board", true, [](SortedSet &z) {
+    z.add("alice", 10);
+    return true;
+  });
+
+  std::size_t records = 0;
+  const std::string bytes = export_bytes(source, 4096, &records);
+  EXPECT_EQ(records, 5003u);
+  mini_redis::ByteReader header(std::string_view(bytes).substr(8, 8));
+  std::uint64_t count = 0;
+  ASSERT_TRUE(header.get_u64(count));
+  EXPECT_EQ(count, 5003u); // patched in after the records were written
+
+  // Whole, and in odd-sized pieces that cut records anywhere
+  for (const std::size_t piece : {bytes.size(), std::size_t{977}}) {
+    KeyValueStore target;
+    std::string error;
+    ASSERT_TRUE(import_bytes(target, bytes, piece, &error)) << error;
+    EXPECT_EQ(target.keys().size(), 5003u);
+    EXPECT_EQ(target.get("key:4999"), "value 4999");
+    EXPECT_EQ(target.get("42"), "an integer key");
+    EXPECT_EQ(target.get("session"), "abc");
+    double score = 0;
+    target.read_as<SortedSet>("board", [&score](const SortedSet &z) {
+      score = z.score("alice").value_or(0);
+    });
+    EXPECT_EQ(score, 10);
+  }
+
+  // One byte at a time: every possible cut
+  KeyValueStore small;
+  small.set("a", "1");
+  small.set("b", "2");
+  const std::string tiny = export_bytes(small, 1 << 20);
+  KeyValueStore target;
+  ASSERT_TRUE(import_bytes(target, tiny, 1));
+  EXPECT_EQ(target.get("b"), "2");
+}
+
+TEST(BulkStreamTest, HandWrittenRecordsAndOverwrites) {
+  KeyValueStore store;
+  store.set("greeting", "old");
+  ASSERT_TRUE(import_bytes(store, string_record_stream("greeting", "new"), 5));
+  EXPECT_EQ(store.get("greeting"), "new");
+
+  // The same key twice in one stream: the later record wins
+  std::string twice = "MRBULK01";
+  mini_redis::put_u64(twice, 0);
+  for (int i = 0; i < 1000; ++i) {
+    const std::string one = string_record_stream("counter", std::to_string(i));
+    twice += one.substr(16, one.size() - 16 - 4); // the record alone
+  }
+  mini_redis::put_u32(twice, 0);
+  ASSERT_TRUE(import_bytes(store, twice, 100));
+  EXPECT_EQ(store.get("counter"), "999");
+}
+
+TEST(BulkStreamTest, MalformedStreamsAreReported) {
+  KeyValueStore store;
+  std::string error;
+  EXPECT_FALSE(import_bytes(store, "MRBULK99 and then some", 64, &error));
+  EXPECT_NE(error.find("bad magic"), std::string::npos);
+
+  const std::string good = string_record_stream("key", "value");
+  EXPECT_FALSE(import_bytes(store, good.substr(0, good.size() - 4), 3,
+                            &error)); // no end marker
+  EXPECT_NE(error.find("end marker"), std::string::npos);
+
+  EXPECT_FALSE(import_bytes(store, good + "x", 64, &error));
+  EXPECT_NE(error.find("after the end marker"), std::string::npos);
+
+  std::string bad_value = good;
+  bad_value[16 + 4] = 99; // an unknown type tag
+  KeyValueStore untouched;
+  EXPECT_FALSE(import_bytes(untouched, bad_value, 64, &error));
+  EXPECT_NE(error.find("malformed record"), std::string::npos);
+  EXPECT_FALSE(untouched.get("key").has_value());
+}
+
+// A length prefix of 4 GB is refused as soon as it is read, not buffered
+// while the rest of the "record" trickles in
+TEST(BulkStreamTest, OversizedRecordFailsAtItsPrefix) {
+  KeyValueStore store;
+  BulkImporter importer(store, 1);
+  std::string stream = "MRBULK01";
+  mini_redis::put_u64(stream, 1);
+  mini_redis::put_u32(stream, 0xFFFFFFFF);
+  stream += "a few bytes of the record";
+  EXPECT_FALSE(importer.feed(stream));
+  EXPECT_NE(importer.error().find("over the limit"), std::string::npos);
+  EXPECT_FALSE(importer.feed(std::string(1 << 20, 'x'))); // ignored now
+}
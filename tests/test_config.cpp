@@ -0,0 +1,219 @@
+// =============================================================================
+// test_config.cpp — Unit Tests for the Settings Layers and Live Reload
+// =============================================================================
+//
+// Each layer (defaults, file, environment, flags) is checked to override
+// the one before, bad input to be refused with a useful reason, and a
+// reload to apply live settings while only reporting startup ones.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "app/config.hpp"
+
+#include <cstdio>  // std::remove
+#include <cstdlib> // setenv, unsetenv
+#include <fstream>
+#include <string>
+#include <vector>
+
+using mini_redis::Config;
+using mini_redis::ConfigSources;
+using mini_redis::LogLevel;
+using mini_redis::RuntimeConfig;
+
+namespace {
+
+// A config file that is removed again at the end of the test
+class ConfigFile {
+public:
+  explicit ConfigFile(const std::string &text)
+      : path_(::testing::TempDir() + "mini_redis_test.conf") {
+    write(text);
+  }
+  ~ConfigFile() { std::remove(path_.c_str()); }
+
+  void write(const std::string &text) const {
+    std::ofstream(path_, std::ios::trunc) << text;
+  }
+  const std::string &path() const { return path_; }
+
+private:
+  std::string path_;
+};
+
+// Clears the MINI_REDIS_* variables a test sets, also when it fails
+class ScopedEnv {
+public:
+  ScopedEnv(const char *name, const char *value) : name_(name) {
+    setenv(name, value, 1);
+  }
+  ~ScopedEnv() { unsetenv(name_); }
+
+private:
+  const char *name_;
+};
+
+Config load(const ConfigSources &sources) {
+  std::string error;
+  const auto config = mini_redis::load_config(sources, error);
+  EXPECT_TRUE(config.has_value()) << error;
+  return config.value_or(Config{});
+}
+
+std::string load_error(const ConfigSources &sources) {
+  std::string error;
+  EXPECT_FALSE(mini_redis::load_config(sources, error).has_value());
+  return error;
+}
+
+} // anonymous namespace
+
+TEST(ConfigTest, DefaultsMatchTheBuiltInValues) {
+  const Config config = load({});
+  EXPECT_EQ(config.port, 8080);
+  EXPECT_EQ(config.threads, 4u);
+  EXPECT_EQ(config.snapshot_path, "dump.mrdb");
+  EXPECT_EQ(config.log_level, LogLevel::INFO);
+  EXPECT_EQ(config.expiry_interval_ms, 1000u);
+  EXPECT_TRUE(config.save_on_shutdown);
+}
+
+TEST(ConfigTest, EachLayerOverridesTheOneBefore) {
+  const ConfigFile file("# deployment settings\n"
+                        "port = 9000\n"
+                        "\n"
+                        "threads=2\n"
+                        "log_level = warning\n"
+                        "snapshot_path = /var/lib/mini redis/dump.mrdb\n");
+  const ScopedEnv port("MINI_REDIS_PORT", "9100");
+  const ScopedEnv level("MINI_REDIS_LOG_LEVEL", "ERROR");
+
+  ConfigSources sources;
+  sources.file = file.path();
+  sources.flags = {{"port", "9200"}};
+  const Config config = load(sources);
+  EXPECT_EQ(config.port, 9200);                 // flag over env over file
+  EXPECT_EQ(config.log_level, LogLevel::ERROR); // env over file
+  EXPECT_EQ(config.threads, 2u);                // file over default
+  EXPECT_EQ(config.snapshot_path, "/var/lib/mini redis/dump.mrdb");
+}
+
+TEST(ConfigTest, BadInputIsRefusedWithAReason) {
+  const ConfigFile file("port = 9000\n"
+                        "threads 2\n");
+  ConfigSources sources;
+  sources.file = file.path();
+  EXPECT_NE(load_error(sources).find(":2: expected name = value"),
+            std::string::npos);
+
+  file.write("prot = 9000\n");
+  EXPECT_NE(load_error(sources).find(":1: unknown setting 'prot'"),
+            std::string::npos);
+
+  sources.file = file.path() + ".missing";
+  EXPECT_NE(load_error(sources).find("cannot read"), std::string::npos);
+
+  {
+    const ScopedEnv decay("MINI_REDIS_MEMORY_DECAY_MS", "soon");
+    EXPECT_NE(load_error({}).find("MINI_REDIS_MEMORY_DECAY_MS"),
+              std::string::npos);
+  }
+
+  for (const auto &[name, value] :
+       std::vector<std::pair<std::string, std::string>>{
+           {"port", "0"},
+           {"port", "70000"},
+           {"threads", "-1"},
+           {"threads", "4x"},
+           {"log_level", "debug"},
+           {"save_on_shutdown", "maybe"},
+           {"snapshot_path", ""}}) {
+    Config config;
+    std::string error;
+    EXPECT_FALSE(mini_redis::set_config_value(config, name, value, error))
+        << name << " = " << value;
+    EXPECT_EQ(mini_redis::format_config(config),
+              mini_redis::format_config(Config{})); // left unchanged
+  }
+}
+
+TEST(ConfigTest, CommandLineFlags) {
+  const char *argv[] = {"mini_redis",     "--config=/etc/mr.conf",
+                        "--port",         "7000",
+                        "--log-level=error", "--save_on_shutdown=off"};
+  std::string error;
+  const auto sources = mini_redis::parse_command_line(
+      6, const_cast<char **>(argv), error);
+  ASSERT_TRUE(sources.has_value()) << error;
+  EXPECT_EQ(sources->file, "/etc/mr.conf");
+  EXPECT_EQ(sources->flags,
+            (std::vector<std::pair<std::string, std::string>>{
+                {"port", "7000"},
+                {"log_level", "error"},
+                {"save_on_shutdown", "off"}}));
+
+  const char *unknown[] = {"mini_redis", "--verbose=1"};
+  EXPECT_FALSE(mini_redis::parse_command_line(2, const_cast<char **>(unknown),
+                                              error)
+                   .has_value());
+  const char *missing[] = {"mini_redis", "--port"};
+  EXPECT_FALSE(mini_redis::parse_command_line(2, const_cast<char **>(missing),
+                                              error)
+                   .has_value());
+}
+
+TEST(ConfigTest, EverySettingPrintsBackToItself) {
+  Config config;
+  config.log_level = LogLevel::WARNING;
+  config.save_on_shutdown = false;
+  config.inline_read_bytes = 16;
+  config.rate_limit_by = mini_redis::RateLimitKey::API_KEY;
+  const std::string text = mini_redis::format_config(config);
+
+  Config parsed;
+  std::size_t lines = 0;
+  std::size_t begin = 0;
+  while (begin <= text.size()) {
+    std::size_t end = text.find('\n', begin);
+    end = end == std::string::npos ? text.size() : end;
+    const std::string line = text.substr(begin, end - begin);
+    const std::size_t space = line.find(' ');
+    std::string error;
+    EXPECT_TRUE(mini_redis::set_config_value(
+        parsed, line.substr(0, space), line.substr(space + 1), error))
+        << line << ": " << error;
+    ++lines;
+    begin = end + 1;
+  }
+  EXPECT_EQ(lines, 18u);
+  EXPECT_EQ(mini_redis::format_config(parsed), text);
+}
+
+TEST(ConfigTest, ReloadAppliesLiveSettingsAndReportsTheRest) {
+  const ConfigFile file("port = 9000\nlog_level = info\n");
+  ConfigSources sources;
+  sources.file = file.path();
+  std::vector<Config> applied;
+  RuntimeConfig runtime(load(sources), sources,
+                        [&applied](const Config &c) { applied.push_back(c); });
+
+  file.write("port = 9001\nlog_level = error\nexpiry_interval_ms = 250\n");
+  auto result = runtime.reload();
+  ASSERT_TRUE(result.ok) << result.error;
+  EXPECT_EQ(result.applied, (std::vector<std::string>{
+                                "log_level error", "expiry_interval_ms 250"}));
+  EXPECT_EQ(result.needs_restart, (std::vector<std::string>{"port 9001"}));
+  ASSERT_EQ(applied.size(), 1u);
+  EXPECT_EQ(applied[0].log_level, LogLevel::ERROR);
+  EXPECT_EQ(runtime.current().port, 9000); // still the bound port
+  EXPECT_EQ(runtime.current().expiry_interval_ms, 250u);
+
+  // A broken file changes nothing
+  file.write("log_level = loud\n");
+  result = runtime.reload();
+  EXPECT_FALSE(result.ok);
+  EXPECT_NE(result.error.find("bad value 'loud'"), std::string::npos);
+  EXPECT_EQ(applied.size(), 1u);
+  EXPECT_EQ(runtime.current().log_level, LogLevel::ERROR);
+}
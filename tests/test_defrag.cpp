@@ -0,0 +1,154 @@
+// =============================================================================
+// test_defrag.cpp — Unit Tests for Active Defragmentation
+// =============================================================================
+//
+// The store is filled, mostly deleted (leaving every slab sparse), then
+// defragmented; the ratio must drop and every surviving key must still
+// read back intact. The arena is process-wide, so it is set up once.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/defragmenter.hpp"
+#include "core/key_value_store.hpp"
+#include "core/thread_safe_hash_map.hpp"
+#include "util/allocator.hpp"
+
+#include <string>
+#include <thread>
+
+using mini_redis::Allocator;
+using mini_redis::DefragOptions;
+using mini_redis::Defragmenter;
+using mini_redis::KeyValueStore;
+
+namespace {
+
+bool arena_ready() {
+  static const bool ready =
+      std::string(Allocator::backend_name()) == "system" &&
+      Allocator::use_page_arena(256 * 1024 * 1024);
+  return ready;
+}
+
+std::string value_for(int i) {
+  // Longer than the small-string buffer, so it has a block of its own
+  return "value-" + std::to_string(i) + std::string(40, 'x');
+}
+
+// 'count' keys, then delete four in five: every slab keeps ~20% live
+void fill_and_thin(KeyValueStore &store, int count) {
+  for (int i = 0; i < count; ++i) {
+    store.restore("key:" + std::to_string(i), {value_for(i), std::nullopt});
+  }
+  for (int i = 0; i < count; ++i) {
+    if (i % 5 != 0) {
+      store.remove("key:" + std::to_string(i));
+    }
+  }
+  Allocator::purge();
+}
+
+void expect_survivors(KeyValueStore &store, int count) {
+  for (int i = 0; i < count; i += 5) {
+    ASSERT_EQ(store.get("key:" + std::to_string(i)), value_for(i)) << i;
+  }
+  EXPECT_EQ(store.keys().size(), static_cast<std::size_t>(count / 5));
+}
+
+} // anonymous namespace
+
+TEST(DefragTest, RelocateVisitsEveryEntryOnce) {
+  mini_redis::ThreadSafeHashMap<std::string, int> map;
+  for (int i = 0; i < 5000; ++i) {
+    map.set("k" + std::to_string(i), i);
+  }
+
+  std::size_t cursor = 0;
+  std::size_t visited = 0;
+  std::size_t moved = 0;
+  std::size_t steps = 0;
+  do {
+    const auto step = map.relocate(
+        cursor, 16, [](const void *) { return true; },
+        [](int &value) { value += 1; });
+    visited += step.visited;
+    moved += step.moved;
+    cursor = step.cursor;
+    ++steps;
+  } while (cursor != 0);
+
+  EXPECT_EQ(visited, 5000u);
+  EXPECT_EQ(moved, 5000u); // every node re-created...
+  EXPECT_GT(steps, 1u);    // ...a slice at a time
+  for (int i = 0; i < 5000; i += 97) {
+    EXPECT_EQ(map.get("k" + std::to_string(i)), i + 1);
+  }
+  EXPECT_EQ(map.size(), 5000u);
+}
+
+TEST(DefragTest, PassCompactsSparseSlabs) {
+  if (!arena_ready()) {
+    GTEST_SKIP() << "needs the page arena";
+  }
+  KeyValueStore store;
+  fill_and_thin(store, 100000);
+  const double before = Defragmenter::fragmentation_ratio();
+  EXPECT_GT(before, 2.0);
+
+  Defragmenter defragmenter(store);
+  std::uint64_t moved = defragmenter.run_pass();
+  EXPECT_GT(moved, 0u);
+  for (int pass = 0; pass < 8 && moved > 0; ++pass) {
+    moved = defragmenter.run_pass();
+  }
+  const double after = Defragmenter::fragmentation_ratio();
+  EXPECT_LT(after, before / 2);
+  expect_survivors(store, 100000);
+}
+
+TEST(DefragTest, BackgroundThreadStartsAndStopsOnItsOwn) {
+  if (!arena_ready()) {
+    GTEST_SKIP() << "needs the page arena";
+  }
+  KeyValueStore store;
+  fill_and_thin(store, 100000);
+
+  DefragOptions options;
+  options.min_waste_bytes = 0;
+  options.cpu_percent = 50;
+  options.check_interval = std::chrono::milliseconds(10);
+  Defragmenter defragmenter(store, options);
+  defragmenter.start();
+
+  // Started by the ratio, finished by it (or by a pass moving nothing)
+  for (int i = 0; i < 1000; ++i) {
+    const auto stats = defragmenter.stats();
+    if (stats.runs > 0 && !stats.active) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  const auto stats = defragmenter.stats();
+  defragmenter.stop();
+
+  EXPECT_EQ(stats.runs, 1u);
+  EXPECT_FALSE(stats.active);
+  EXPECT_GT(stats.moved, 0u);
+  EXPECT_LE(stats.fragmentation_ratio, options.start_ratio);
+  expect_survivors(store, 100000);
+}
+
+TEST(DefragTest, IdleWhenDense) {
+  KeyValueStore store;
+  store.restore("only", {std::string("value"), std::nullopt});
+  DefragOptions options;
+  options.check_interval = std::chrono::milliseconds(5);
+  Defragmenter defragmenter(store, options);
+  defragmenter.start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  defragmenter.stop();
+  // Far below min_waste_bytes, whatever the ratio
+  EXPECT_EQ(defragmenter.stats().runs, 0u);
+  EXPECT_EQ(store.get("only"), "value");
+}
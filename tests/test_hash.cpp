@@ -0,0 +1,377 @@
+// =============================================================================
+// test_hash.cpp — Unit Tests for Key Hashing and the Sharded Hash Map
+// =============================================================================
+//
+// fast_hash64 is checked for the properties a table hash needs (every
+// length and every byte matters, the seed changes everything), and the
+// sharded ThreadSafeHashMap for behaving exactly like one big map — with
+// every storage and lock policy.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/thread_safe_hash_map.hpp"
+#include "util/hash.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::fast_hash64;
+using mini_redis::FlatStorage;
+using mini_redis::NodeStorage;
+using mini_redis::NoLock;
+using mini_redis::OrderedStorage;
+using mini_redis::SeqLock;
+using mini_redis::SpinLock;
+using mini_redis::ThreadSafeHashMap;
+
+TEST(HashTest, FastHashIsDeterministicPerSeed) {
+  EXPECT_EQ(fast_hash64("user:42", 1), fast_hash64("user:42", 1));
+  EXPECT_NE(fast_hash64("user:42", 1), fast_hash64("user:42", 2));
+  EXPECT_EQ(mini_redis::process_hash_seed(), mini_redis::process_hash_seed());
+  EXPECT_EQ(mini_redis::hash_key("k"),
+            fast_hash64("k", mini_redis::process_hash_seed()));
+}
+
+TEST(HashTest, EveryLengthAndByteMatters) {
+  // Covers each code path: 0, 1-3, 4-16, 17-48 and the 48-byte loop
+  const std::string text(200, 'x');
+  std::set<std::uint64_t> by_length;
+  for (std::size_t length = 0; length <= text.size(); ++length) {
+    by_length.insert(fast_hash64(text.data(), length, 7));
+  }
+  EXPECT_EQ(by_length.size(), text.size() + 1);
+
+  for (const std::size_t length : {1u, 3u, 4u, 7u, 8u, 16u, 17u, 48u, 49u,
+                                   100u, 200u}) {
+    const std::string base(length, 'a');
+    const std::uint64_t original = fast_hash64(base, 7);
+    for (std::size_t i = 0; i < length; ++i) {
+      std::string flipped = base;
+      flipped[i] ^= 1;
+      EXPECT_NE(fast_hash64(flipped, 7), original)
+          << "length " << length << ", byte " << i;
+    }
+  }
+}
+
+TEST(HashTest, HighBitsAreWellSpread) {
+  // The top 4 bits pick the shard: sequential keys must use all 16
+  std::vector<int> per_shard(16, 0);
+  for (int i = 0; i < 16000; ++i) {
+    ++per_shard[mini_redis::hash_key("key:" + std::to_string(i)) >> 60];
+  }
+  for (const int count : per_shard) {
+    EXPECT_GT(count, 800);
+    EXPECT_LT(count, 1200);
+  }
+}
+
+TEST(HashTest, IntegerKeyHashSpreadsSequentialIds) {
+  // Same for the integer table: sequential IDs, every shard, and the low
+  // bits (the bucket) must vary too
+  std::vector<int> per_shard(16, 0);
+  std::set<std::uint64_t> low_bits;
+  for (std::uint64_t i = 0; i < 16000; ++i) {
+    const std::uint64_t hash = mini_redis::hash_integer_key(i);
+    ++per_shard[hash >> 60];
+    low_bits.insert(hash & 0xFFF);
+  }
+  for (const int count : per_shard) {
+    EXPECT_GT(count, 800);
+    EXPECT_LT(count, 1200);
+  }
+  EXPECT_GT(low_bits.size(), 3900u); // of 4096, ~4002 expected
+}
+
+TEST(ThreadSafeHashMapTest, BehavesLikeOneMap) {
+  ThreadSafeHashMap<std::string, int> map;
+  for (int i = 0; i < 1000; ++i) {
+    map.set("k" + std::to_string(i), i);
+  }
+  EXPECT_EQ(map.size(), 1000u);
+  EXPECT_EQ(map.get("k500"), 500);
+  EXPECT_FALSE(map.get("missing").has_value());
+
+  auto keys = map.keys();
+  EXPECT_EQ(keys.size(), 1000u);
+  EXPECT_EQ(std::set<std::string>(keys.begin(), keys.end()).size(), 1000u);
+
+  int sum = 0;
+  map.for_each([&sum](const std::string &, int value) { sum += value; });
+  EXPECT_EQ(sum, 999 * 1000 / 2);
+
+  EXPECT_EQ(map.remove_if([](const std::string &, int value) {
+    return value % 2 == 0;
+  }),
+            500u);
+  EXPECT_EQ(map.size(), 500u);
+  EXPECT_TRUE(map.remove("k1"));
+  EXPECT_FALSE(map.remove("k1"));
+}
+
+TEST(ThreadSafeHashMapTest, PrecomputedHashOverloads) {
+  ThreadSafeHashMap<std::string, int> map;
+  const std::string key = "answer";
+  const std::uint64_t hash = map.hash_of(key);
+
+  map.set(key, hash, 41);
+  map.compute(key, hash, [](int &value, bool exists) {
+    EXPECT_TRUE(exists);
+    ++value;
+    return true;
+  });
+  EXPECT_EQ(map.get(key), 42); // found again through the plain overload
+  int seen = 0;
+  EXPECT_TRUE(
+      map.read(key, hash, [&seen](const int &value) { seen = value; }));
+  EXPECT_EQ(seen, 42);
+  EXPECT_TRUE(map.remove(key, hash));
+  EXPECT_FALSE(map.get(key).has_value());
+}
+
+TEST(ThreadSafeHashMapTest, ReadManyAcrossShards) {
+  ThreadSafeHashMap<std::string, int> map;
+  std::vector<std::string> keys;
+  for (int i = 0; i < 200; ++i) {
+    keys.push_back("m" + std::to_string(i));
+    if (i % 3 != 0) {
+      map.set(keys.back(), i);
+    }
+  }
+  keys.push_back("m5"); // duplicates are fine
+
+  map.read_many(keys, [&](const std::vector<const int *> &values) {
+    ASSERT_EQ(values.size(), keys.size());
+    for (int i = 0; i < 200; ++i) {
+      if (i % 3 == 0) {
+        EXPECT_EQ(values[i], nullptr);
+      } else {
+        ASSERT_NE(values[i], nullptr);
+        EXPECT_EQ(*values[i], i);
+      }
+    }
+    EXPECT_EQ(*values.back(), 5);
+  });
+}
+
+TEST(ThreadSafeHashMapTest, IntegerKeys) {
+  ThreadSafeHashMap<int, int> map;
+  for (int i = 0; i < 256; ++i) {
+    map.set(i, -i);
+  }
+  EXPECT_EQ(map.size(), 256u);
+  EXPECT_EQ(map.get(77), -77);
+}
+
+// =============================================================================
+// Policies — every storage / lock combination must behave identically
+// =============================================================================
+namespace {
+
+template <typename Map> class MapPolicyTest : public ::testing::Test {};
+
+using PolicyMaps = ::testing::Types<
+    ThreadSafeHashMap<std::uint64_t, std::uint64_t>,
+    ThreadSafeHashMap<std::uint64_t, std::uint64_t, NodeStorage, SpinLock>,
+    ThreadSafeHashMap<std::uint64_t, std::uint64_t, FlatStorage>,
+    ThreadSafeHashMap<std::uint64_t, std::uint64_t, FlatStorage, SeqLock>,
+    ThreadSafeHashMap<std::uint64_t, std::uint64_t, FlatStorage, NoLock, 1>,
+    ThreadSafeHashMap<std::uint64_t, std::uint64_t, OrderedStorage, SpinLock,
+                      4>>;
+TYPED_TEST_SUITE(MapPolicyTest, PolicyMaps);
+
+} // anonymous namespace
+
+// Random inserts, overwrites and erases, checked against std::map.
+// Erasing from a flat table shifts entries back; this is where a broken
+// probe chain would show up as a "missing" key.
+TYPED_TEST(MapPolicyTest, MatchesAReferenceMap) {
+  TypeParam map;
+  std::map<std::uint64_t, std::uint64_t> reference;
+  std::mt19937_64 rng(3);
+  for (int i = 0; i < 20000; ++i) {
+    const std::uint64_t key = rng() % 2000;
+    switch (rng() % 4) {
+    case 0:
+      EXPECT_EQ(map.remove(key), reference.erase(key) > 0);
+      break;
+    case 1:
+      map.compute(key, [&](std::uint64_t &value, bool exists) {
+        EXPECT_EQ(exists, reference.count(key) > 0);
+        value += 1;
+        reference[key] = value;
+        return true;
+      });
+      break;
+    default:
+      map.set(key, i);
+      reference[key] = i;
+    }
+  }
+
+  EXPECT_EQ(map.size(), reference.size());
+  for (std::uint64_t key = 0; key < 2000; ++key) {
+    const auto found = map.get(key);
+    const auto expected = reference.find(key);
+    if (expected == reference.end()) {
+      EXPECT_FALSE(found.has_value()) << key;
+    } else {
+      EXPECT_EQ(found, expected->second) << key;
+    }
+  }
+
+  std::map<std::uint64_t, std::uint64_t> walked;
+  map.for_each([&](const std::uint64_t &key, const std::uint64_t &value) {
+    walked[key] = value;
+  });
+  EXPECT_EQ(walked, reference);
+
+  const std::size_t odd = std::count_if(
+      reference.begin(), reference.end(),
+      [](const auto &entry) { return entry.second % 2 == 1; });
+  EXPECT_EQ(map.remove_if([](const std::uint64_t &, const std::uint64_t &v) {
+    return v % 2 == 1;
+  }),
+            odd);
+  EXPECT_EQ(map.size(), reference.size() - odd);
+}
+
+TYPED_TEST(MapPolicyTest, RelocateVisitsEveryEntryOnce) {
+  TypeParam map;
+  for (std::uint64_t i = 0; i < 3000; ++i) {
+    map.set(i, i);
+  }
+  const std::function<bool(const void *)> move_all = [](const void *) {
+    return true;
+  };
+  const std::function<void(std::uint64_t &)> count = [](std::uint64_t &v) {
+    v += 1'000'000;
+  };
+  std::size_t cursor = 0;
+  std::size_t visited = 0;
+  do {
+    const auto result = map.relocate(cursor, 100, move_all, count);
+    visited += result.visited;
+    cursor = result.cursor;
+  } while (cursor != 0);
+
+  EXPECT_EQ(visited, 3000u);
+  for (std::uint64_t i = 0; i < 3000; i += 97) {
+    EXPECT_EQ(map.get(i), i + 1'000'000);
+  }
+}
+
+// Batches longer than the prefetch distance, with duplicates and keys of
+// every shard: each key is computed in order, and read back in order
+TYPED_TEST(MapPolicyTest, BatchesMatchOneKeyAtATime) {
+  TypeParam map;
+  std::vector<std::uint64_t> keys;
+  for (std::uint64_t i = 0; i < 500; ++i) {
+    keys.push_back(i % 300); // keys 0..199 appear twice
+  }
+  std::vector<bool> existed;
+  map.compute_many(keys, [&](std::size_t index, std::uint64_t &value,
+                             bool exists) {
+    EXPECT_EQ(keys[index], index % 300);
+    existed.push_back(exists);
+    value += index;
+    return keys[index] % 7 != 0; // drop multiples of 7
+  });
+  ASSERT_EQ(existed.size(), keys.size());
+  EXPECT_FALSE(existed[0]);
+  EXPECT_FALSE(existed[1]);
+  EXPECT_TRUE(existed[301]); // key 1, kept the first time round
+
+  std::vector<std::uint64_t> wanted = keys;
+  wanted.push_back(9999); // never written
+  map.read_many(wanted, [&](const std::vector<const std::uint64_t *> &got) {
+    ASSERT_EQ(got.size(), wanted.size());
+    for (std::size_t i = 0; i < keys.size(); ++i) {
+      const std::uint64_t key = keys[i];
+      if (key % 7 == 0) {
+        EXPECT_EQ(got[i], nullptr) << key;
+      } else {
+        ASSERT_NE(got[i], nullptr) << key;
+        // Both visits added their index: key, and key + 300 if it's < 200
+        EXPECT_EQ(*got[i], key < 200 ? 2 * key + 300 : key) << key;
+      }
+    }
+    EXPECT_EQ(got.back(), nullptr);
+  });
+}
+
+// Writers keep both halves of every value equal; an optimistic reader
+// that ever returned a torn copy would see them differ
+TEST(SeqLockMapTest, OptimisticReadsNeverSeeTornValues) {
+  struct Pair {
+    std::uint64_t low = 0;
+    std::uint64_t high = 0;
+  };
+  ThreadSafeHashMap<std::uint64_t, Pair, FlatStorage, SeqLock, 4> map;
+  static_assert(decltype(map)::OPTIMISTIC_READS);
+  for (std::uint64_t key = 0; key < 64; ++key) {
+    map.set(key, Pair{});
+  }
+
+  std::atomic<bool> stop{false};
+  std::thread writer([&] {
+    // Also grows the table, so readers race with array replacement
+    for (std::uint64_t round = 1; !stop.load(); ++round) {
+      map.set(round % 64, Pair{round, round});
+      map.set(1000 + round % 5000, Pair{round, round});
+    }
+  });
+
+  std::uint64_t torn = 0;
+  std::uint64_t reads = 0;
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::milliseconds(300);
+  while (std::chrono::steady_clock::now() < deadline) {
+    for (std::uint64_t key = 0; key < 64; ++key) {
+      const auto value = map.get(key);
+      torn += value.has_value() && value->low != value->high;
+      ++reads;
+    }
+  }
+  stop = true;
+  writer.join();
+  EXPECT_EQ(torn, 0u);
+  EXPECT_GT(reads, 0u);
+}
+
+// With optimistic readers the table keeps every array it retires; a
+// defrag pass that replaced the array would add a full-size one each time
+TEST(SeqLockMapTest, DefragNeverRetiresTheSlotArray) {
+  ThreadSafeHashMap<std::uint64_t, std::uint64_t, FlatStorage, SeqLock, 4>
+      map;
+  for (std::uint64_t i = 0; i < 3000; ++i) {
+    map.set(i, i);
+  }
+  const std::function<bool(const void *)> move_all = [](const void *) {
+    return true;
+  };
+  const std::function<void(std::uint64_t &)> keep = [](std::uint64_t &) {};
+  std::size_t moved = 0;
+  std::size_t visited = 0;
+  for (int pass = 0; pass < 10; ++pass) {
+    std::size_t cursor = 0;
+    do {
+      const auto result = map.relocate(cursor, 100, move_all, keep);
+      moved += result.moved;
+      visited += result.visited;
+      cursor = result.cursor;
+    } while (cursor != 0);
+  }
+  EXPECT_EQ(moved, 0u);
+  EXPECT_EQ(visited, 10 * 3000u); // values are still offered
+  EXPECT_EQ(map.get(2999), 2999u);
+}
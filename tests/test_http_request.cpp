@@ -70,6 +70,22 @@ TEST(HttpRequestTest, ParseDeleteRequest) {
   EXPECT_EQ(request->path(), "/kv/old_key");
 }
 
+// --- Test: parse a PATCH request ---
+TEST(HttpRequestTest, ParsePatchRequest) {
+  const std::string raw = "PATCH /json/set/doc?path=$.a HTTP/1.1\r\n"
+                          "Content-Length: 1\r\n"
+                          "\r\n"
+                          "2";
+
+  const auto request = mini_redis::HttpRequest::parse(raw);
+
+  ASSERT_TRUE(request.has_value());
+  EXPECT_EQ(request->method(), mini_redis::HttpMethod::PATCH);
+  EXPECT_EQ(request->path(), "/json/set/doc");
+  EXPECT_EQ(request->get_query_param("path").value_or(""), "$.a");
+  EXPECT_EQ(request->body(), "2");
+}
+
 // --- Test: empty input returns nullopt ---
 TEST(HttpRequestTest, EmptyInputReturnsNullopt) {
   const auto request = mini_redis::HttpRequest::parse("");
@@ -100,3 +116,20 @@ TEST(HttpRequestTest, HeaderLookupCaseInsensitive) {
   EXPECT_TRUE(request->get_header("Content-Type").has_value());
   EXPECT_TRUE(request->get_header("CONTENT-TYPE").has_value());
 }
+
+// --- Test: query string is split off the path and percent-decoded ---
+TEST(HttpRequestTest, ParsesQueryParameters) {
+  const std::string raw = "GET /zset/range/board?start=0&stop=-1&who=a%20b&flag "
+                          "HTTP/1.1\r\n"
+                          "\r\n";
+
+  const auto request = mini_redis::HttpRequest::parse(raw);
+
+  ASSERT_TRUE(request.has_value());
+  EXPECT_EQ(request->path(), "/zset/range/board");
+  EXPECT_EQ(request->get_query_param("start").value(), "0");
+  EXPECT_EQ(request->get_query_param("stop").value(), "-1");
+  EXPECT_EQ(request->get_query_param("who").value(), "a b");
+  EXPECT_TRUE(request->get_query_param("flag").has_value());
+  EXPECT_FALSE(request->get_query_param("missing").has_value());
+}
@@ -0,0 +1,155 @@
+// =============================================================================
+// test_huge_pages.cpp — Unit Tests for the Huge-Page Arena
+// =============================================================================
+//
+// The explicit hugetlbfs pool is usually empty on test machines, so these
+// tests accept any backing the kernel gives us; they check the slab and
+// span bookkeeping, and that Allocator really serves from the arena.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/key_value_store.hpp"
+#include "util/allocator.hpp"
+#include "util/huge_page_arena.hpp"
+
+#include <cstring>
+#include <set>
+#include <vector>
+
+using mini_redis::Allocator;
+using mini_redis::HugePageArena;
+using mini_redis::PageBacking;
+
+TEST(HugePageArenaTest, MapsAlignedPrefaultedMemory) {
+  HugePageArena arena(3 * 1024 * 1024); // rounded up to two 2 MB pages
+  ASSERT_NE(arena.backing(), PageBacking::UNMAPPED);
+  const auto stats = arena.stats();
+  EXPECT_EQ(stats.capacity_bytes, 2 * HugePageArena::HUGE_PAGE);
+  EXPECT_EQ(stats.slab_bytes, 0u);
+
+  void *block = arena.allocate_small(0);
+  ASSERT_NE(block, nullptr);
+  EXPECT_TRUE(arena.contains(block));
+  EXPECT_FALSE(arena.contains(&stats));
+  // Starts on a 2 MB boundary, so huge pages can back it
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(block) % HugePageArena::HUGE_PAGE,
+            0u);
+}
+
+TEST(HugePageArenaTest, RegularPagesOnRequest) {
+  HugePageArena arena(HugePageArena::HUGE_PAGE, false);
+  ASSERT_EQ(arena.backing(), PageBacking::REGULAR);
+  EXPECT_EQ(arena.stats().huge_pages, 0u);
+}
+
+TEST(HugePageArenaTest, SmallBlocksComeFromSlabs) {
+  HugePageArena arena(HugePageArena::HUGE_PAGE);
+  ASSERT_NE(arena.backing(), PageBacking::UNMAPPED);
+
+  // Class 2 = 48-byte blocks: a 64 KB slab holds 1365 of them
+  std::set<void *> blocks;
+  for (int i = 0; i < 1365; ++i) {
+    void *block = arena.allocate_small(2);
+    ASSERT_NE(block, nullptr);
+    std::memset(block, 0x5a, 48);
+    EXPECT_EQ(arena.size_class_of(block), 2);
+    blocks.insert(block);
+  }
+  EXPECT_EQ(blocks.size(), 1365u); // no block handed out twice
+  EXPECT_EQ(arena.stats().slab_bytes, HugePageArena::SPAN);
+  EXPECT_EQ(arena.stats().live_bytes, 1365u * 48);
+
+  void *first = *blocks.begin();
+  arena.deallocate(first); // size found from the span
+  EXPECT_EQ(arena.allocate_small(2), first);
+  void *next_slab = arena.allocate_small(2); // the first one is full
+  EXPECT_EQ(arena.stats().slab_bytes, 2 * HugePageArena::SPAN);
+
+  // Emptied slabs go back to the pool
+  arena.deallocate(next_slab);
+  for (void *block : blocks) {
+    arena.deallocate(block);
+  }
+  EXPECT_EQ(arena.stats().slab_bytes, 0u);
+  EXPECT_EQ(arena.stats().live_bytes, 0u);
+  EXPECT_NE(arena.allocate_large(HugePageArena::HUGE_PAGE), nullptr);
+}
+
+TEST(HugePageArenaTest, SparseSlabsAreFlaggedForRelocation) {
+  HugePageArena arena(HugePageArena::HUGE_PAGE);
+  ASSERT_NE(arena.backing(), PageBacking::UNMAPPED);
+
+  // Four full slabs of 1 KB blocks (64 each), then free most of the
+  // first three: they become sparse, the fourth stays dense
+  std::vector<void *> blocks;
+  for (int i = 0; i < 4 * 64; ++i) {
+    blocks.push_back(arena.allocate_small(63));
+  }
+  for (int i = 0; i < 3 * 64; ++i) {
+    if (i % 64 >= 4) {
+      arena.deallocate(blocks[i]);
+    }
+  }
+  // The first sparse slab is where allocation goes next, so only the
+  // second and third are worth emptying
+  EXPECT_FALSE(arena.should_relocate(blocks[0]));
+  EXPECT_TRUE(arena.should_relocate(blocks[64]));
+  EXPECT_TRUE(arena.should_relocate(blocks[128]));
+  EXPECT_FALSE(arena.should_relocate(blocks[200])); // full slab
+  EXPECT_FALSE(arena.should_relocate(&blocks));     // not in the arena
+}
+
+TEST(HugePageArenaTest, LargeBlocksReuseFreedSpans) {
+  HugePageArena arena(HugePageArena::HUGE_PAGE); // 32 spans
+  ASSERT_NE(arena.backing(), PageBacking::UNMAPPED);
+
+  void *a = arena.allocate_large(100 * 1024); // 2 spans
+  void *b = arena.allocate_large(64 * 1024);  // 1 span
+  ASSERT_NE(a, nullptr);
+  ASSERT_NE(b, nullptr);
+  EXPECT_EQ(arena.size_class_of(a), -1);
+  EXPECT_EQ(arena.stats().large_bytes, 3 * HugePageArena::SPAN);
+
+  arena.deallocate(a);
+  EXPECT_EQ(arena.allocate_large(128 * 1024), a); // first fit: a's spans
+  EXPECT_EQ(arena.allocate_large(64 * 1024 * 40), nullptr); // too big
+}
+
+TEST(HugePageArenaTest, FullArenaReturnsNull) {
+  HugePageArena arena(HugePageArena::HUGE_PAGE);
+  ASSERT_NE(arena.backing(), PageBacking::UNMAPPED);
+  std::size_t served = 0;
+  while (arena.allocate_small(63) != nullptr) { // 1 KB blocks
+    ++served;
+  }
+  EXPECT_EQ(served, HugePageArena::HUGE_PAGE / 1024);
+  EXPECT_EQ(arena.allocate_small(0), nullptr); // no span left for a slab
+}
+
+TEST(HugePageArenaTest, AllocatorServesTheStoreFromTheArena) {
+  if (std::string(Allocator::backend_name()) != "system") {
+    GTEST_SKIP() << Allocator::backend_name() << " has its own huge pages";
+  }
+  ASSERT_TRUE(Allocator::use_page_arena(64 * 1024 * 1024));
+  EXPECT_FALSE(Allocator::use_page_arena(1)); // only once per process
+
+  mini_redis::KeyValueStore store;
+  for (int i = 0; i < 20000; ++i) {
+    store.restore("key:" + std::to_string(i), {std::string("v"), {}});
+  }
+  EXPECT_EQ(store.get("key:12345"), "v");
+
+  const auto stats = Allocator::stats();
+  EXPECT_EQ(stats.arena_capacity_bytes, 64u * 1024 * 1024);
+  // Nodes fill slabs; the grown bucket arrays take whole spans
+  EXPECT_GT(stats.arena_used_bytes, 20000u * 48);
+
+  // Sized, unsized and large frees all find their way back
+  void *small = Allocator::allocate(100);
+  void *large = Allocator::allocate(256 * 1024);
+  Allocator::deallocate(small);
+  Allocator::deallocate(large, 256 * 1024);
+  Allocator::purge();
+  EXPECT_EQ(Allocator::stats().cached_bytes, 0u);
+}
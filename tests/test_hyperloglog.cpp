@@ -0,0 +1,88 @@
+// =============================================================================
+// test_hyperloglog.cpp — Unit Tests for the HyperLogLog Value Type
+// =============================================================================
+//
+// HLL counts are ESTIMATES, so the tests check error bounds rather than
+// exact values: the standard error is ~0.81%, and we allow ~3 sigma.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/hyperloglog.hpp"
+
+#include <cmath>
+#include <string>
+
+using mini_redis::HyperLogLog;
+
+namespace {
+
+void add_range(HyperLogLog &hll, const std::string &prefix, int from, int to) {
+  for (int i = from; i < to; ++i) {
+    hll.add(prefix + std::to_string(i));
+  }
+}
+
+double relative_error(std::uint64_t estimate, double actual) {
+  return std::abs(static_cast<double>(estimate) - actual) / actual;
+}
+
+} // anonymous namespace
+
+// --- Test: duplicates don't change anything ---
+TEST(HyperLogLogTest, DuplicatesAreIgnored) {
+  HyperLogLog hll;
+  EXPECT_TRUE(hll.add("alice"));
+  EXPECT_FALSE(hll.add("alice"));
+  EXPECT_EQ(hll.count(), 1u);
+  EXPECT_EQ(HyperLogLog().count(), 0u);
+}
+
+// --- Test: small HLLs stay sparse and are near-exact ---
+TEST(HyperLogLogTest, SparseSmallCounts) {
+  HyperLogLog hll;
+  add_range(hll, "user:", 0, 500);
+
+  EXPECT_EQ(hll.encoding(), HyperLogLog::Encoding::SPARSE);
+  EXPECT_LT(hll.memory_bytes(), 3000u);
+  EXPECT_LT(relative_error(hll.count(), 500), 0.02);
+}
+
+// --- Test: large HLLs are dense, fixed-size and within error bounds ---
+TEST(HyperLogLogTest, DenseLargeCounts) {
+  HyperLogLog hll;
+  add_range(hll, "user:", 0, 1'000'000);
+
+  EXPECT_EQ(hll.encoding(), HyperLogLog::Encoding::DENSE);
+  EXPECT_EQ(hll.memory_bytes(), HyperLogLog::DENSE_BYTES);
+  EXPECT_EQ(HyperLogLog::DENSE_BYTES, 12288u);
+  EXPECT_LT(relative_error(hll.count(), 1'000'000), 0.025);
+
+  // Re-adding the same elements changes nothing
+  const auto before = hll.count();
+  add_range(hll, "user:", 0, 1000);
+  EXPECT_EQ(hll.count(), before);
+}
+
+// --- Test: merge and count_union estimate the union ---
+TEST(HyperLogLogTest, MergeIsUnion) {
+  HyperLogLog monday;
+  HyperLogLog tuesday;
+  add_range(monday, "v", 0, 60'000);
+  add_range(tuesday, "v", 40'000, 100'000); // 20K overlap
+
+  EXPECT_LT(relative_error(HyperLogLog::count_union({&monday, &tuesday}),
+                           100'000),
+            0.025);
+
+  HyperLogLog week;
+  week.merge(monday);
+  week.merge(tuesday);
+  EXPECT_EQ(week.count(), HyperLogLog::count_union({&monday, &tuesday}));
+
+  // Merging a sparse HLL into a dense one keeps the registers intact
+  HyperLogLog small;
+  add_range(small, "v", 0, 10);
+  week.merge(small);
+  EXPECT_EQ(week.count(), HyperLogLog::count_union({&monday, &tuesday}));
+}
@@ -0,0 +1,139 @@
+// =============================================================================
+// test_inline_values.cpp — Unit Tests for Lock-Free Small-Value Reads
+// =============================================================================
+//
+// The inline copies are invisible from the outside, so most tests go
+// through KeyValueStore and check two things: GET answers correctly, and
+// the number of copies (inline_value_stats) tracks every kind of write.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/inline_values.hpp"
+#include "core/key_value_store.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::AccessStatus;
+using mini_redis::InlineKey;
+using mini_redis::KeyValueStore;
+
+TEST(InlineValuesTest, KeysAreFixedSizeAndZeroPadded) {
+  const auto key = InlineKey::from("user:1");
+  ASSERT_TRUE(key.has_value());
+  EXPECT_EQ(key->view(), "user:1");
+  EXPECT_EQ(key, InlineKey::from("user:1"));
+  EXPECT_FALSE(key == InlineKey::from("user:10"));
+  EXPECT_TRUE(InlineKey::from(std::string(23, 'k')).has_value());
+  EXPECT_FALSE(InlineKey::from(std::string(24, 'k')).has_value());
+}
+
+TEST(InlineValuesTest, SmallValuesAreCopiedAndServed) {
+  KeyValueStore store;
+  store.set_inline_read_max_bytes(16);
+  store.set("counter", "41");
+  store.set("big", std::string(100, 'b'));
+  store.set(std::string(40, 'k'), "long key");
+  store.set("7", "integer key");
+
+  EXPECT_EQ(store.inline_value_stats().values, 2u); // "counter" and "7"
+  EXPECT_EQ(store.get("counter"), "41");
+  EXPECT_EQ(store.get("big"), std::string(100, 'b'));
+  EXPECT_EQ(store.get(std::string(40, 'k')), "long key");
+  EXPECT_EQ(store.get("7"), "integer key");
+  EXPECT_FALSE(store.get("missing").has_value());
+}
+
+TEST(InlineValuesTest, EveryWriteKeepsTheCopyInStep) {
+  KeyValueStore store;
+  store.set_inline_read_max_bytes(8);
+  store.set("k", "short");
+
+  // Grows past the limit: the copy must go, not stay stale
+  EXPECT_EQ(store.modify_as<std::string>("k", false,
+                                         [](std::string &value) {
+                                           value += " and now long";
+                                           return true;
+                                         }),
+            AccessStatus::OK);
+  EXPECT_EQ(store.inline_value_stats().values, 0u);
+  EXPECT_EQ(store.get("k"), "short and now long");
+
+  store.set("k", "again");
+  EXPECT_EQ(store.inline_value_stats().values, 1u);
+  store.restore("k", {mini_redis::SortedSet{}, std::nullopt});
+  EXPECT_EQ(store.inline_value_stats().values, 0u);
+  EXPECT_FALSE(store.get("k").has_value()); // not a string any more
+
+  store.set("k", "back");
+  EXPECT_TRUE(store.remove("k"));
+  EXPECT_EQ(store.inline_value_stats().values, 0u);
+  EXPECT_FALSE(store.get("k").has_value());
+}
+
+TEST(InlineValuesTest, ExpiredCopiesAreNotServed) {
+  KeyValueStore store;
+  store.set_inline_read_max_bytes(8);
+  store.set("temp", "v", 1);
+  EXPECT_EQ(store.get("temp"), "v");
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  EXPECT_FALSE(store.get("temp").has_value()); // also deletes it lazily
+  EXPECT_EQ(store.inline_value_stats().values, 0u);
+
+  store.set("temp2", "v", 1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  EXPECT_EQ(store.cleanup_expired(), 1u);
+  EXPECT_EQ(store.inline_value_stats().values, 0u);
+}
+
+TEST(InlineValuesTest, TurningItOffNeverLeavesStaleCopies) {
+  KeyValueStore store;
+  store.set_inline_read_max_bytes(8);
+  store.set("k", "old");
+  store.set_inline_read_max_bytes(0);
+  store.set("k", "new"); // while off: the old copy is dropped
+  store.set_inline_read_max_bytes(8);
+  EXPECT_EQ(store.get("k"), "new");
+}
+
+TEST(InlineValuesTest, ConcurrentReadersSeeOnlyWrittenValues) {
+  KeyValueStore store;
+  store.set_inline_read_max_bytes(22);
+  // Every value ever written is "<n>:<n>" — a torn read would mismatch
+  store.restore("hot", {std::string("0:0"), std::nullopt});
+
+  std::atomic<bool> stop{false};
+  std::atomic<int> bad{0};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 3; ++t) {
+    readers.emplace_back([&] {
+      while (!stop.load()) {
+        const auto value = store.get("hot");
+        if (!value.has_value()) {
+          ++bad;
+          continue;
+        }
+        const auto colon = value->find(':');
+        if (colon == std::string::npos ||
+            value->substr(0, colon) != value->substr(colon + 1)) {
+          ++bad;
+        }
+      }
+    });
+  }
+  for (int i = 1; i <= 20000; ++i) {
+    const std::string n = std::to_string(i * 7919);
+    store.restore("hot", {n + ":" + n, std::nullopt});
+    store.restore("other" + std::to_string(i % 50), {n, std::nullopt});
+  }
+  stop = true;
+  for (auto &reader : readers) {
+    reader.join();
+  }
+  EXPECT_EQ(bad.load(), 0);
+}
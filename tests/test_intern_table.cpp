@@ -0,0 +1,143 @@
+// =============================================================================
+// test_intern_table.cpp — Unit Tests for Value Deduplication
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/intern_table.hpp"
+#include "core/key_value_store.hpp"
+
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::InternTable;
+using mini_redis::KeyValueStore;
+using mini_redis::SharedString;
+using mini_redis::StoreEntry;
+
+TEST(InternTableTest, IdenticalValuesShareOneBuffer) {
+  InternTable table;
+  const std::string blob(1000, 'a');
+  SharedString first = table.intern(blob);
+  SharedString second = table.intern(blob);
+  SharedString other = table.intern(std::string(1000, 'b'));
+
+  EXPECT_EQ(&first.str(), &second.str()); // the same bytes, not a copy
+  EXPECT_NE(&first.str(), &other.str());
+  EXPECT_EQ(first.str(), blob);
+  EXPECT_EQ(first.use_count(), 2u);
+
+  const auto stats = table.stats();
+  EXPECT_EQ(stats.values, 2u);
+  EXPECT_EQ(stats.references, 3u);
+  EXPECT_EQ(stats.hits, 1u);
+  EXPECT_EQ(stats.misses, 2u);
+  EXPECT_EQ(stats.unique_bytes, 2000u);
+  EXPECT_EQ(stats.saved_bytes(), 1000u);
+}
+
+TEST(InternTableTest, LastReferenceFreesTheValue) {
+  InternTable table;
+  {
+    SharedString value = table.intern("payload");
+    SharedString copy = value; // copies count as references too
+    EXPECT_EQ(value.use_count(), 2u);
+    EXPECT_EQ(table.stats().references, 2u);
+  }
+  const auto stats = table.stats();
+  EXPECT_EQ(stats.values, 0u);
+  EXPECT_EQ(stats.references, 0u);
+  EXPECT_EQ(stats.unique_bytes, 0u);
+  EXPECT_EQ(stats.logical_bytes, 0u);
+
+  // Interning it again starts a fresh node
+  EXPECT_EQ(table.intern("payload").use_count(), 1u);
+}
+
+TEST(InternTableTest, ValuesOutliveTheTable) {
+  auto table = std::make_unique<InternTable>();
+  SharedString survivor = table->intern("still here");
+  table.reset();
+  EXPECT_EQ(survivor.str(), "still here");
+}
+
+TEST(InternTableTest, ConcurrentInternAndRelease) {
+  InternTable table;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&table, t] {
+      for (int i = 0; i < 20000; ++i) {
+        SharedString value = table.intern("v" + std::to_string(i % 8));
+        SharedString copy = value;
+        ASSERT_EQ(copy.str(), "v" + std::to_string(i % 8)) << t;
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(table.stats().values, 0u);
+  EXPECT_EQ(table.stats().references, 0u);
+}
+
+TEST(InternTableTest, StoreSharesLargeStringValues) {
+  KeyValueStore store;
+  store.set_dedup_min_bytes(64);
+  const std::string config(500, 'c');
+  for (int i = 0; i < 100; ++i) {
+    store.restore("cfg:" + std::to_string(i), StoreEntry{config, {}});
+  }
+  store.restore("short", StoreEntry{std::string("tiny"), {}});
+
+  EXPECT_EQ(store.get("cfg:42"), config);
+  EXPECT_EQ(store.get("short"), "tiny");
+  auto stats = store.dedup_stats();
+  EXPECT_EQ(stats.values, 1u); // "tiny" is under the threshold
+  EXPECT_EQ(stats.references, 100u);
+  EXPECT_EQ(stats.saved_bytes(), 99u * 500);
+
+  // Deleting and overwriting drop references
+  for (int i = 0; i < 50; ++i) {
+    store.remove("cfg:" + std::to_string(i));
+  }
+  store.restore("cfg:99", StoreEntry{std::string(500, 'd'), {}});
+  stats = store.dedup_stats();
+  EXPECT_EQ(stats.values, 2u);
+  EXPECT_EQ(stats.references, 50u);
+}
+
+TEST(InternTableTest, MutatingASharedValueCopiesIt) {
+  KeyValueStore store;
+  store.set_dedup_min_bytes(16);
+  const std::string bits(32, '\0');
+  store.restore("a", StoreEntry{bits, {}});
+  store.restore("b", StoreEntry{bits, {}});
+
+  // What SETBIT does: modify the string in place
+  const auto status = store.modify_as<std::string>(
+      "a", false, [](std::string &value) {
+        value[0] = '\x80';
+        return true;
+      });
+  EXPECT_EQ(status, mini_redis::AccessStatus::OK);
+  EXPECT_EQ(store.get("a")->front(), '\x80');
+  EXPECT_EQ(store.get("b"), bits); // untouched
+  EXPECT_EQ(store.dedup_stats().references, 1u);
+
+  // Readers see a shared value as an ordinary string
+  std::size_t length = 0;
+  EXPECT_EQ(store.read_as<std::string>(
+                "b", [&](const std::string &value) { length = value.size(); }),
+            mini_redis::AccessStatus::OK);
+  EXPECT_EQ(length, 32u);
+}
+
+TEST(InternTableTest, OffByDefault) {
+  KeyValueStore store;
+  store.restore("a", StoreEntry{std::string(4096, 'x'), {}});
+  store.restore("b", StoreEntry{std::string(4096, 'x'), {}});
+  EXPECT_EQ(store.dedup_stats().values, 0u);
+  EXPECT_EQ(store.get("b"), std::string(4096, 'x'));
+}
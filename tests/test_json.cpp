@@ -0,0 +1,290 @@
+// =============================================================================
+// test_json.cpp — Unit Tests for the JSON Document Type
+// =============================================================================
+//
+// The SIMD structural scanner is checked against the byte-at-a-time one on
+// random input dense in quotes and backslashes (where the bit tricks can go
+// wrong), then the parser against the JSON grammar's corner cases, and the
+// path edits against documents printed back out.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/json.hpp"
+#include "core/json_scan.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::JsonDocument;
+using mini_redis::JsonPath;
+
+namespace {
+
+JsonDocument doc(const std::string &text) {
+  auto parsed = JsonDocument::parse(text);
+  EXPECT_TRUE(parsed.has_value()) << text;
+  return parsed.value_or(JsonDocument{});
+}
+
+JsonPath path(const std::string &text) {
+  auto parsed = JsonPath::parse(text);
+  EXPECT_TRUE(parsed.has_value()) << text;
+  return parsed.value_or(JsonPath{});
+}
+
+} // anonymous namespace
+
+// =============================================================================
+// Stage 1
+// =============================================================================
+
+TEST(JsonScanTest, SimdMatchesScalar) {
+  // Mostly quotes, backslashes and operators, across block boundaries
+  const std::string alphabet = "\"\\\\\"{}[]:, a1\n\xc3\xa9";
+  std::mt19937 rng(7);
+  std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+  for (std::size_t length : {0u, 1u, 63u, 64u, 65u, 127u, 128u, 1000u}) {
+    for (int round = 0; round < 50; ++round) {
+      std::string text;
+      for (std::size_t i = 0; i < length; ++i) {
+        text += alphabet[pick(rng)];
+      }
+      std::vector<std::uint32_t> fast, slow;
+      bool fast_ascii = false, slow_ascii = false;
+      const bool fast_ok = mini_redis::find_structurals(text, fast,
+                                                        fast_ascii);
+      const bool slow_ok =
+          mini_redis::find_structurals_scalar(text, slow, slow_ascii);
+      ASSERT_EQ(fast_ok, slow_ok) << text;
+      ASSERT_EQ(fast, slow) << text;
+      ASSERT_EQ(fast_ascii, slow_ascii);
+    }
+  }
+}
+
+TEST(JsonScanTest, StructuralPositions) {
+  std::vector<std::uint32_t> positions;
+  bool ascii = false;
+  // {"a\"}":[1, true]}  — the brace inside the string is not structural
+  ASSERT_TRUE(mini_redis::find_structurals(R"({"a\"}":[1, true]})",
+                                           positions, ascii));
+  EXPECT_TRUE(ascii);
+  EXPECT_EQ(positions,
+            (std::vector<std::uint32_t>{0, 1, 7, 8, 9, 10, 12, 16, 17}));
+
+  positions.clear();
+  EXPECT_FALSE(mini_redis::find_structurals(R"({"open)", positions, ascii));
+}
+
+// =============================================================================
+// Parsing
+// =============================================================================
+
+TEST(JsonTest, ParsesAndPrintsCompact) {
+  EXPECT_EQ(doc(" { \"a\" : [ 1 , -2.5 , true , false , null ] ,"
+                " \"b\" : { } , \"c\" : [ ] } ")
+                .to_json(),
+            R"({"a":[1,-2.5,true,false,null],"b":{},"c":[]})");
+  EXPECT_EQ(doc("42").to_json(), "42");
+  EXPECT_EQ(doc("\"hi\"").to_json(), "\"hi\"");
+  EXPECT_EQ(doc("1e2").to_json(), "100");
+  EXPECT_EQ(doc("-0").to_json(), "0");
+  EXPECT_EQ(doc("1e-400").to_json(), "0");
+  // Beyond int64: kept as a double
+  EXPECT_EQ(JsonDocument::parse("99999999999999999999")
+                ->type_at(path("$"))
+                .value(),
+            JsonDocument::Type::NUMBER);
+}
+
+TEST(JsonTest, StringEscapes) {
+  EXPECT_EQ(doc(R"("a\"b\\c\/d\n\t\u0041\u00e9")").to_json(),
+            "\"a\\\"b\\\\c/d\\n\\tA\xc3\xa9\"");
+  // Surrogate pair → one 4-byte UTF-8 character
+  EXPECT_EQ(doc(R"("\ud83d\ude00")").to_json(), "\"\xf0\x9f\x98\x80\"");
+  // Control characters must be escaped on input, and are on output
+  EXPECT_FALSE(JsonDocument::parse("\"\x01\"").has_value());
+  EXPECT_EQ(doc(R"("\u0001")").to_json(), "\"\\u0001\"");
+}
+
+TEST(JsonTest, RejectsInvalidDocuments) {
+  for (const char *bad : {"", " ", "{", "}", "[1,]", "[1 2]", "{\"a\" 1}",
+                          "{\"a\":}", "{1:2}", "{\"a\":1,}", "01", "1.",
+                          ".5", "-", "1e", "+1", "tru", "nul", "truex",
+                          "[1]x", "1 2", "\"abc", "\"\\x\"", "\"\\u12\"",
+                          "\"\\ud800\"", "\"\\ude00\"", "1e400", "[\"a\"x]",
+                          "\"\xff\"", "\"\xc0\xaf\"", "\"\xed\xa0\x80\""}) {
+    EXPECT_FALSE(JsonDocument::parse(bad).has_value()) << bad;
+  }
+}
+
+TEST(JsonTest, DepthLimit) {
+  const std::size_t limit = JsonDocument::MAX_DEPTH;
+  EXPECT_TRUE(JsonDocument::parse(std::string(limit, '[') +
+                                  std::string(limit, ']'))
+                  .has_value());
+  EXPECT_FALSE(JsonDocument::parse(std::string(limit + 1, '[') +
+                                   std::string(limit + 1, ']'))
+                   .has_value());
+}
+
+// =============================================================================
+// Paths
+// =============================================================================
+
+TEST(JsonTest, PathSyntax) {
+  EXPECT_TRUE(path("$").is_root());
+  EXPECT_TRUE(path(".").is_root());
+  EXPECT_TRUE(path("").is_root());
+
+  const auto p = path("$.a[0]['b c'][-1]");
+  ASSERT_EQ(p.steps.size(), 4u);
+  EXPECT_EQ(p.steps[0].key, "a");
+  EXPECT_TRUE(p.steps[1].is_index);
+  EXPECT_EQ(p.steps[2].key, "b c");
+  EXPECT_EQ(p.steps[3].index, -1);
+
+  EXPECT_EQ(path("a.b").steps.size(), 2u); // legacy form
+  for (const char *bad : {"$.", "$..a", "$.*", "$[", "$[]", "$[x]", "$['a]",
+                          "$a"}) {
+    EXPECT_FALSE(JsonPath::parse(bad).has_value()) << bad;
+  }
+}
+
+TEST(JsonTest, GetFragments) {
+  const auto d =
+      doc(R"({"user":{"name":"ann","tags":["x","y"]},"n":[1,{"k":null}]})");
+  EXPECT_EQ(d.get(path("$.user.name")), "\"ann\"");
+  EXPECT_EQ(d.get(path("$.user.tags")), R"(["x","y"])");
+  EXPECT_EQ(d.get(path("$.user.tags[-1]")), "\"y\"");
+  EXPECT_EQ(d.get(path("$.n[1].k")), "null");
+  EXPECT_EQ(d.get(path("$['user']['name']")), "\"ann\"");
+  EXPECT_FALSE(d.get(path("$.user.age")).has_value());
+  EXPECT_FALSE(d.get(path("$.n[2]")).has_value());
+  EXPECT_FALSE(d.get(path("$.n[-3]")).has_value());
+  EXPECT_FALSE(d.get(path("$.user.name.first")).has_value());
+  EXPECT_FALSE(d.get(path("$.n.k")).has_value());
+
+  EXPECT_EQ(d.type_at(path("$.n")), JsonDocument::Type::ARRAY);
+  EXPECT_EQ(d.type_at(path("$.n[0]")), JsonDocument::Type::INTEGER);
+  EXPECT_EQ(d.type_at(path("$")), JsonDocument::Type::OBJECT);
+}
+
+// =============================================================================
+// Edits
+// =============================================================================
+
+TEST(JsonTest, SetReplacesAndAdds) {
+  auto d = doc(R"({"a":{"b":1,"c":[1,2]},"z":0})");
+  EXPECT_EQ(d.set(path("$.a.b"), doc(R"({"deep":[true]})")),
+            JsonDocument::Status::OK);
+  EXPECT_EQ(d.set(path("$.a.new"), doc("\"v\"")), JsonDocument::Status::OK);
+  EXPECT_EQ(d.set(path("$.a.c[0]"), doc("9")), JsonDocument::Status::OK);
+  EXPECT_EQ(d.to_json(),
+            R"({"a":{"b":{"deep":[true]},"c":[9,2],"new":"v"},"z":0})");
+  // The enclosing containers' sizes were fixed: later members still found
+  EXPECT_EQ(d.get(path("$.z")), "0");
+
+  EXPECT_EQ(d.set(path("$.a.c[5]"), doc("1")),
+            JsonDocument::Status::NO_PATH);
+  EXPECT_EQ(d.set(path("$.missing.x"), doc("1")),
+            JsonDocument::Status::NO_PATH);
+  EXPECT_EQ(d.set(path("$.z.x"), doc("1")),
+            JsonDocument::Status::WRONG_TYPE);
+
+  EXPECT_EQ(d.set(path("$"), doc("[]")), JsonDocument::Status::OK);
+  EXPECT_EQ(d.to_json(), "[]");
+}
+
+TEST(JsonTest, SetRespectsDepthLimit) {
+  const std::size_t limit = JsonDocument::MAX_DEPTH;
+  auto d = doc(R"({"a":1})");
+  const auto deep = doc(std::string(limit, '[') + std::string(limit, ']'));
+  EXPECT_EQ(d.set(path("$.a"), deep), JsonDocument::Status::TOO_DEEP);
+  EXPECT_EQ(d.set(path("$"), deep), JsonDocument::Status::OK);
+}
+
+TEST(JsonTest, Remove) {
+  auto d = doc(R"({"a":1,"b":[1,2,3],"c":{"d":true}})");
+  EXPECT_EQ(d.remove(path("$.b[1]")), JsonDocument::Status::OK);
+  EXPECT_EQ(d.remove(path("$.a")), JsonDocument::Status::OK);
+  EXPECT_EQ(d.remove(path("$.c.d")), JsonDocument::Status::OK);
+  EXPECT_EQ(d.to_json(), R"({"b":[1,3],"c":{}})");
+  EXPECT_EQ(d.remove(path("$.a")), JsonDocument::Status::NO_PATH);
+  EXPECT_EQ(d.remove(path("$")), JsonDocument::Status::NO_PATH);
+}
+
+TEST(JsonTest, Increment) {
+  auto d = doc(R"({"i":5,"f":1.5,"s":"x"})");
+  EXPECT_EQ(d.increment(path("$.i"), 3), "8");
+  EXPECT_EQ(d.increment(path("$.i"), 0.5), "8.5");
+  EXPECT_EQ(d.type_at(path("$.i")), JsonDocument::Type::NUMBER);
+  EXPECT_EQ(d.increment(path("$.f"), -1.5), "0");
+  EXPECT_FALSE(d.increment(path("$.s"), 1).has_value());
+  EXPECT_FALSE(d.increment(path("$.nope"), 1).has_value());
+  EXPECT_EQ(d.to_json(), R"({"i":8.5,"f":0,"s":"x"})");
+
+  // int64 overflow falls back to a double instead of wrapping
+  auto big = doc("9223372036854775807");
+  EXPECT_EQ(big.type_at(path("$")), JsonDocument::Type::INTEGER);
+  ASSERT_TRUE(big.increment(path("$"), 1).has_value());
+  EXPECT_EQ(big.type_at(path("$")), JsonDocument::Type::NUMBER);
+}
+
+TEST(JsonTest, ArrayAppend) {
+  auto d = doc(R"({"list":[1],"after":true})");
+  std::size_t length = 0;
+  EXPECT_EQ(d.array_append(path("$.list"), {doc("2"), doc(R"({"x":[]})")},
+                           length),
+            JsonDocument::Status::OK);
+  EXPECT_EQ(length, 3u);
+  EXPECT_EQ(d.to_json(), R"({"list":[1,2,{"x":[]}],"after":true})");
+  EXPECT_EQ(d.array_append(path("$.list[2].x"), {doc("null")}, length),
+            JsonDocument::Status::OK);
+  EXPECT_EQ(length, 1u);
+  EXPECT_EQ(d.array_append(path("$.after"), {doc("1")}, length),
+            JsonDocument::Status::WRONG_TYPE);
+  EXPECT_EQ(d.array_append(path("$.none"), {doc("1")}, length),
+            JsonDocument::Status::NO_PATH);
+}
+
+// =============================================================================
+// Round trips
+// =============================================================================
+
+TEST(JsonTest, PrintedTextParsesBack) {
+  const std::string text =
+      R"({"k\"ey":["\u0000\ud83d\ude00",-1.25e-7,123456789012,)"
+      R"({"":{"":[[],{}]}}],"u":"\u00fc"})";
+  const auto first = doc(text).to_json();
+  EXPECT_EQ(doc(first).to_json(), first);
+}
+
+TEST(JsonTest, SerializeRoundTrip) {
+  const auto original = doc(R"({"a":[1,2.5,"three",{"four":null}]})");
+  std::string bytes;
+  original.serialize(bytes);
+
+  mini_redis::ByteReader in(bytes);
+  const auto copy = JsonDocument::deserialize(in);
+  ASSERT_TRUE(copy.has_value());
+  EXPECT_EQ(copy->to_json(), original.to_json());
+
+  // A truncated or corrupted tape is rejected, never walked
+  for (std::size_t cut = 0; cut < bytes.size(); ++cut) {
+    std::string truncated = bytes;
+    truncated.resize(cut);
+    mini_redis::ByteReader partial(truncated);
+    EXPECT_FALSE(JsonDocument::deserialize(partial).has_value()) << cut;
+  }
+  std::string corrupt = bytes;
+  corrupt[corrupt.size() / 2] = 'Z';
+  mini_redis::ByteReader bad(corrupt);
+  const auto result = JsonDocument::deserialize(bad);
+  if (result.has_value()) {
+    // The byte hit string contents: still a well-formed document
+    EXPECT_TRUE(JsonDocument::parse(result->to_json()).has_value());
+  }
+}
@@ -33,6 +33,11 @@
 #include <chrono>
 #include <thread>
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
 // =============================================================================
 // TEST SUITE: KeyValueStoreTest
 // =============================================================================
@@ -163,3 +168,129 @@ TEST(KeyValueStoreTest, CleanupExpired) {
   ASSERT_TRUE(store.get("permanent").has_value());
   EXPECT_EQ(store.get("permanent").value(), "stays forever");
 }
+
+// =============================================================================
+// Integer keys — a second table, invisible from the outside
+// =============================================================================
+TEST(KeyValueStoreTest, ParseIntegerKeyAcceptsOnlyCanonicalForms) {
+  using mini_redis::parse_integer_key;
+  EXPECT_EQ(parse_integer_key("0"), 0u);
+  EXPECT_EQ(parse_integer_key("42"), 42u);
+  EXPECT_EQ(parse_integer_key("18446744073709551615"), UINT64_MAX);
+
+  // Each of these would print back differently, or isn't a number at all
+  for (const char *key : {"", "042", "00", "+42", "-1", "4.2", "42 ", "4x",
+                          "user:42", "18446744073709551616",
+                          "99999999999999999999", "123456789012345678901"}) {
+    EXPECT_FALSE(parse_integer_key(key).has_value()) << key;
+  }
+}
+
+TEST(KeyValueStoreTest, IntegerKeysBehaveLikeAnyOtherKey) {
+  mini_redis::KeyValueStore store;
+  store.set("42", "answer");
+  store.set("042", "padded"); // a different key, kept as a string
+  store.set("1700000000123456789", "snowflake");
+  store.set("user:42", "named");
+
+  const auto counts = store.key_counts();
+  EXPECT_EQ(counts.integer, 2u);
+  EXPECT_EQ(counts.string, 2u);
+
+  EXPECT_EQ(store.get("42"), "answer");
+  EXPECT_EQ(store.get("042"), "padded");
+  EXPECT_EQ(store.get("1700000000123456789"), "snowflake");
+  EXPECT_FALSE(store.get("43").has_value());
+
+  auto keys = store.keys();
+  std::sort(keys.begin(), keys.end());
+  EXPECT_EQ(keys, (std::vector<std::string>{"042", "1700000000123456789",
+                                            "42", "user:42"}));
+
+  EXPECT_EQ(store.modify_as<std::string>("42", false,
+                                         [](std::string &value) {
+                                           value += "!";
+                                           return true;
+                                         }),
+            mini_redis::AccessStatus::OK);
+  EXPECT_EQ(store.get("42"), "answer!");
+  EXPECT_TRUE(store.remove("42"));
+  EXPECT_FALSE(store.remove("42"));
+  EXPECT_EQ(store.get("042"), "padded");
+}
+
+TEST(KeyValueStoreTest, MultiKeyReadsSpanBothTables) {
+  mini_redis::KeyValueStore store;
+  store.set("1", "one");
+  store.set("a", "A");
+  store.set("2", "two");
+
+  std::vector<std::string> seen;
+  store.read_many_as<std::string>(
+      {"2", "a", "missing", "1", "3", "a"},
+      [&](const std::vector<const std::string *> &values) {
+        for (const std::string *value : values) {
+          seen.push_back(value == nullptr ? "<nil>" : *value);
+        }
+      });
+  EXPECT_EQ(seen, (std::vector<std::string>{"two", "A", "<nil>", "one",
+                                            "<nil>", "A"}));
+
+  std::size_t found = 0;
+  store.read_values({"1", "b", "a"},
+                    [&](const std::vector<const mini_redis::StoreValue *> &v) {
+                      ASSERT_EQ(v.size(), 3u);
+                      found = (v[0] != nullptr) + (v[1] != nullptr) +
+                              (v[2] != nullptr);
+                    });
+  EXPECT_EQ(found, 2u);
+}
+
+TEST(KeyValueStoreTest, WholeStoreWalksCoverBothTables) {
+  mini_redis::KeyValueStore store;
+  for (int i = 0; i < 500; ++i) {
+    store.set(std::to_string(i), "n");
+    store.set("k" + std::to_string(i), "s");
+  }
+  store.set("7", "soon gone", 1);
+  store.set("k7", "soon gone", 1);
+
+  std::size_t visited = 0;
+  std::size_t cursor = 0;
+  do {
+    const auto step = store.defrag_step(cursor, 64);
+    visited += step.visited;
+    cursor = step.cursor;
+  } while (cursor != 0);
+  EXPECT_EQ(visited, 1000u);
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+  EXPECT_EQ(store.cleanup_expired(), 2u);
+
+  std::size_t integers = 0;
+  store.for_each_entry(
+      [&](const std::string &key, const mini_redis::StoreEntry &) {
+        integers += mini_redis::parse_integer_key(key).has_value();
+      });
+  EXPECT_EQ(integers, 499u);
+}
+
+TEST(KeyValueStoreTest, BatchedRestoreAndGetMany) {
+  mini_redis::KeyValueStore store;
+  store.set("k3", "old");
+  store.set("3", "old");
+
+  // More than one batch, both kinds of key, overwriting what's there
+  std::vector<std::pair<std::string, mini_redis::StoreEntry>> entries;
+  const std::size_t count = mini_redis::KeyValueStore::RESTORE_BATCH * 2 + 10;
+  for (std::size_t i = 0; i < count; ++i) {
+    const std::string key = (i % 2 == 0 ? "" : "k") + std::to_string(i);
+    entries.emplace_back(key, mini_redis::StoreEntry{"v" + key, std::nullopt});
+  }
+  store.restore_many(std::move(entries));
+  EXPECT_EQ(store.keys().size(), count + 1); // and the "3" set above
+
+  const auto values = store.get_many({"k3", "3", "4", "k5", "nope", "k3"});
+  EXPECT_EQ(values, (std::vector<std::optional<std::string>>{
+                        "vk3", "old", "v4", "vk5", std::nullopt, "vk3"}));
+}
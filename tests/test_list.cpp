@@ -0,0 +1,302 @@
+// =============================================================================
+// test_list.cpp — Unit Tests for the List Value Type and Blocking Pops
+// =============================================================================
+//
+// QuickList tests check push/pop at both ends across chunk boundaries and
+// with long (4-byte length) elements. KeyWaiters tests check that blocking
+// pops are served immediately, on notify(), or by the timeout thread —
+// without any thread sleeping on their behalf.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "api/key_waiters.hpp"
+#include "core/quick_list.hpp"
+#include "network/parked_connection.hpp"
+#include "network/socket.hpp"
+
+#include <arpa/inet.h>  // inet_pton
+#include <netinet/in.h> // sockaddr_in
+#include <sys/socket.h> // socket(), connect()
+#include <unistd.h>     // close()
+
+#include <chrono>
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <thread>
+
+using mini_redis::QuickList;
+using mini_redis::Socket;
+
+namespace {
+
+// A real TCP connection over loopback: the server end as a Socket (what a
+// parked connection holds) and the client end as a raw fd the test can
+// close to "hang up"
+struct Connection {
+  Socket server;
+  int client_fd;
+};
+
+std::optional<Connection> connect_loopback() {
+  auto listener = Socket::create_tcp();
+  int port = 47100;
+  while (listener && !listener->bind_to(port) && port < 47300) {
+    ++port;
+  }
+  if (!listener || !listener->start_listening()) {
+    return std::nullopt;
+  }
+  const int client_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(static_cast<uint16_t>(port));
+  ::inet_pton(AF_INET, "127.0.0.1", &address.sin_addr);
+  if (::connect(client_fd, reinterpret_cast<sockaddr *>(&address),
+                sizeof(address)) != 0) {
+    ::close(client_fd);
+    return std::nullopt;
+  }
+  auto server = listener->accept_connection();
+  if (!server) {
+    ::close(client_fd);
+    return std::nullopt;
+  }
+  return Connection{std::move(*server), client_fd};
+}
+
+} // anonymous namespace
+
+// --- Test: push and pop at both ends ---
+TEST(QuickListTest, PushPopBothEnds) {
+  QuickList list;
+  list.push_back("b");
+  list.push_back("c");
+  list.push_front("a");
+
+  EXPECT_EQ(list.size(), 3u);
+  EXPECT_EQ(list.range(0, -1), (std::vector<std::string>{"a", "b", "c"}));
+  EXPECT_EQ(list.pop_front().value(), "a");
+  EXPECT_EQ(list.pop_back().value(), "c");
+  EXPECT_EQ(list.pop_back().value(), "b");
+  EXPECT_FALSE(list.pop_front().has_value());
+  EXPECT_TRUE(list.empty());
+}
+
+// --- Test: many elements spread over several compact chunks ---
+TEST(QuickListTest, SpansManyChunks) {
+  QuickList list;
+  for (int i = 0; i < 10000; ++i) {
+    list.push_back("item-" + std::to_string(i));
+  }
+
+  EXPECT_EQ(list.size(), 10000u);
+  EXPECT_GT(list.chunk_count(), 1u);
+  EXPECT_LT(list.chunk_count(), 100u); // dense: hundreds of items per chunk
+  EXPECT_EQ(list.range(5000, 5002),
+            (std::vector<std::string>{"item-5000", "item-5001", "item-5002"}));
+  EXPECT_EQ(list.range(-1, -1), (std::vector<std::string>{"item-9999"}));
+}
+
+// --- Test: long elements use the 4-byte length framing ---
+TEST(QuickListTest, LongElements) {
+  QuickList list;
+  const std::string medium(300, 'm');
+  const std::string huge(20000, 'h'); // bigger than a chunk
+  list.push_back(medium);
+  list.push_front(huge);
+  list.push_back("tail");
+
+  EXPECT_EQ(list.pop_front().value(), huge);
+  EXPECT_EQ(list.pop_back().value(), "tail");
+  EXPECT_EQ(list.pop_back().value(), medium);
+}
+
+// --- Test: trim keeps only the requested window ---
+TEST(QuickListTest, Trim) {
+  QuickList list;
+  for (int i = 0; i < 3000; ++i) {
+    list.push_back(std::to_string(i));
+  }
+
+  list.trim(1000, -1001);
+  EXPECT_EQ(list.size(), 1000u);
+  EXPECT_EQ(list.range(0, 0), (std::vector<std::string>{"1000"}));
+  EXPECT_EQ(list.range(-1, -1), (std::vector<std::string>{"1999"}));
+
+  list.trim(5, 1); // empty range empties the list
+  EXPECT_TRUE(list.empty());
+}
+
+// --- Test: randomized comparison against std::deque ---
+TEST(QuickListTest, MatchesDequeModel) {
+  QuickList list;
+  std::deque<std::string> model;
+  std::mt19937 rng(3);
+
+  for (int step = 0; step < 20000; ++step) {
+    const std::string value(rng() % 200, static_cast<char>('a' + rng() % 26));
+    switch (rng() % 4) {
+    case 0:
+      list.push_front(value);
+      model.push_front(value);
+      break;
+    case 1:
+      list.push_back(value);
+      model.push_back(value);
+      break;
+    case 2:
+      if (!model.empty()) {
+        EXPECT_EQ(list.pop_front().value(), model.front());
+        model.pop_front();
+      }
+      break;
+    default:
+      if (!model.empty()) {
+        EXPECT_EQ(list.pop_back().value(), model.back());
+        model.pop_back();
+      }
+      break;
+    }
+  }
+
+  const auto all = list.range(0, -1);
+  ASSERT_EQ(all.size(), model.size());
+  EXPECT_TRUE(std::equal(all.begin(), all.end(), model.begin()));
+}
+
+// =============================================================================
+// TEST SUITE: KeyWaitersTest
+// =============================================================================
+
+// --- Test: data already available → immediate reply, nothing parked ---
+TEST(KeyWaitersTest, ServesImmediately) {
+  mini_redis::KeyWaiters waiters;
+
+  const auto response = waiters.block(
+      "jobs", std::chrono::milliseconds(0),
+      [] { return std::optional(mini_redis::HttpResponse::ok().body("x")); },
+      mini_redis::HttpResponse::not_found());
+
+  EXPECT_EQ(response.parked_connection(), nullptr);
+  EXPECT_EQ(waiters.waiting_count(), 0u);
+}
+
+// --- Test: parked waiter is completed by notify() ---
+TEST(KeyWaitersTest, NotifyCompletesParkedClient) {
+  mini_redis::KeyWaiters waiters;
+  bool available = false;
+
+  const auto response = waiters.block(
+      "jobs", std::chrono::milliseconds(0),
+      [&available]() -> std::optional<mini_redis::HttpResponse> {
+        if (!available) {
+          return std::nullopt;
+        }
+        return mini_redis::HttpResponse::ok().body("job-1");
+      },
+      mini_redis::HttpResponse::not_found());
+
+  ASSERT_NE(response.parked_connection(), nullptr);
+  EXPECT_EQ(waiters.waiting_count(), 1u);
+
+  waiters.notify("jobs"); // still nothing → stays parked
+  EXPECT_FALSE(response.parked_connection()->is_completed());
+
+  available = true;
+  waiters.notify("jobs");
+  EXPECT_TRUE(response.parked_connection()->is_completed());
+  EXPECT_EQ(waiters.waiting_count(), 0u);
+}
+
+// --- Test: the timer thread answers expired waiters ---
+TEST(KeyWaitersTest, TimeoutCompletesParkedClient) {
+  mini_redis::KeyWaiters waiters;
+
+  const auto response = waiters.block(
+      "jobs", std::chrono::milliseconds(50),
+      []() -> std::optional<mini_redis::HttpResponse> { return std::nullopt; },
+      mini_redis::HttpResponse::not_found());
+
+  ASSERT_NE(response.parked_connection(), nullptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+  EXPECT_TRUE(response.parked_connection()->is_completed());
+  EXPECT_EQ(waiters.waiting_count(), 0u);
+}
+
+// --- Test: a timeout past the clock's range waits, it doesn't wrap ---
+// now() + milliseconds::max() would overflow into the past and time the
+// client out at once; block() cuts it to MAX_TIMEOUT instead
+TEST(KeyWaitersTest, HugeTimeoutIsClamped) {
+  mini_redis::KeyWaiters waiters;
+
+  const auto response = waiters.block(
+      "jobs", std::chrono::milliseconds::max(),
+      []() -> std::optional<mini_redis::HttpResponse> { return std::nullopt; },
+      mini_redis::HttpResponse::not_found());
+
+  ASSERT_NE(response.parked_connection(), nullptr);
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(response.parked_connection()->is_completed());
+  EXPECT_EQ(waiters.waiting_count(), 1u);
+}
+
+// --- Test: a client that hung up is dropped, not served ---
+// Serving it would pop the element and write it to a dead socket; the
+// element must go to the next waiter instead
+TEST(KeyWaitersTest, HungUpClientIsSkipped) {
+  mini_redis::KeyWaiters waiters;
+  int items = 0;
+  auto serve = [&items]() -> std::optional<mini_redis::HttpResponse> {
+    if (items == 0) {
+      return std::nullopt;
+    }
+    --items;
+    return mini_redis::HttpResponse::ok().body("job-1");
+  };
+
+  const auto gone = waiters.block("jobs", std::chrono::milliseconds(0),
+                                  serve, mini_redis::HttpResponse::not_found());
+  const auto next = waiters.block("jobs", std::chrono::milliseconds(0),
+                                  serve, mini_redis::HttpResponse::not_found());
+  ASSERT_NE(gone.parked_connection(), nullptr);
+  ASSERT_NE(next.parked_connection(), nullptr);
+
+  auto connection = connect_loopback();
+  ASSERT_TRUE(connection.has_value());
+  EXPECT_FALSE(connection->server.peer_closed());
+  gone.parked_connection()->attach(std::move(connection->server));
+  ::close(connection->client_fd);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20)); // FIN lands
+
+  items = 1;
+  waiters.notify("jobs");
+  EXPECT_EQ(items, 0);
+  EXPECT_TRUE(gone.parked_connection()->is_completed());
+  EXPECT_TRUE(next.parked_connection()->is_completed()); // got job-1
+  EXPECT_EQ(waiters.waiting_count(), 0u);
+}
+
+// --- Test: the timer sweeps out clients that hung up with no timeout ---
+TEST(KeyWaitersTest, SweepDropsHungUpClients) {
+  mini_redis::KeyWaiters waiters;
+
+  const auto response = waiters.block(
+      "jobs", std::chrono::milliseconds(0), // wait forever
+      []() -> std::optional<mini_redis::HttpResponse> { return std::nullopt; },
+      mini_redis::HttpResponse::not_found());
+  ASSERT_NE(response.parked_connection(), nullptr);
+
+  auto connection = connect_loopback();
+  ASSERT_TRUE(connection.has_value());
+  response.parked_connection()->attach(std::move(connection->server));
+  ::close(connection->client_fd);
+
+  std::this_thread::sleep_for(mini_redis::KeyWaiters::DISCONNECT_SWEEP +
+                              std::chrono::milliseconds(300));
+  EXPECT_EQ(waiters.waiting_count(), 0u);
+  EXPECT_TRUE(response.parked_connection()->is_completed());
+}
@@ -0,0 +1,214 @@
+// =============================================================================
+// test_lz4.cpp — Unit Tests for the LZ4 Codec and Value Compression
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/compressed_string.hpp"
+#include "core/key_value_store.hpp"
+#include "core/snapshot.hpp"
+#include "util/lz4.hpp"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using mini_redis::AccessStatus;
+using mini_redis::KeyValueStore;
+using mini_redis::StoreValue;
+using mini_redis::ValueCodec;
+namespace lz4 = mini_redis::lz4;
+
+namespace {
+
+// Text that compresses roughly like real JSON
+std::string json_like(std::size_t bytes) {
+  std::mt19937 rng(7);
+  std::string out;
+  while (out.size() < bytes) {
+    out += "{\"id\":" + std::to_string(rng() % 100000) +
+           ",\"name\":\"user\",\"active\":true},";
+  }
+  out.resize(bytes);
+  return out;
+}
+
+std::string random_bytes(std::size_t bytes) {
+  std::mt19937 rng(11);
+  std::string out(bytes, '\0');
+  for (char &c : out) {
+    c = static_cast<char>(rng());
+  }
+  return out;
+}
+
+} // anonymous namespace
+
+TEST(Lz4Test, RoundTripsAssortedInputs) {
+  const std::vector<std::string> inputs = {
+      "",
+      "a",
+      "abcdefghijkl", // shorter than the minimum block with a match
+      std::string(100, 'x'),
+      json_like(100'000),
+      random_bytes(70'000),
+      json_like(9 * 1024 * 1024), // three 4 MB blocks
+  };
+  for (const std::string &input : inputs) {
+    const std::string frame = lz4::compress(input);
+    const auto output = lz4::decompress(frame);
+    ASSERT_TRUE(output.has_value()) << "size " << input.size();
+    EXPECT_EQ(*output, input);
+    EXPECT_EQ(lz4::content_size(frame), input.size());
+  }
+}
+
+TEST(Lz4Test, CompressesRedundantData) {
+  const std::string input = json_like(100'000);
+  EXPECT_LT(lz4::compress(input).size(), input.size() / 3);
+
+  // Incompressible input is stored raw: only the framing is added
+  const std::string noise = random_bytes(100'000);
+  EXPECT_LE(lz4::compress(noise).size(), noise.size() + 32);
+}
+
+TEST(Lz4Test, DecodesFramesFromTheReferenceTool) {
+  // printf 'hello hello hello hello hello hello hello!\n' | lz4 -c
+  // (no content size; a content checksum, which is verified)
+  const unsigned char frame[] = {
+      0x04, 0x22, 0x4d, 0x18, 0x64, 0x40, 0xa7, 0x10, 0x00, 0x00, 0x00, 0x6f,
+      0x68, 0x65, 0x6c, 0x6c, 0x6f, 0x20, 0x06, 0x00, 0x0d, 0x50, 0x6c, 0x6c,
+      0x6f, 0x21, 0x0a, 0x00, 0x00, 0x00, 0x00, 0xff, 0x20, 0x17, 0xc9};
+  const std::string bytes(reinterpret_cast<const char *>(frame),
+                          sizeof(frame));
+  EXPECT_EQ(lz4::decompress(bytes),
+            "hello hello hello hello hello hello hello!\n");
+  EXPECT_FALSE(lz4::content_size(bytes).has_value());
+
+  std::string corrupted = bytes;
+  corrupted[corrupted.size() - 1] ^= 1; // content checksum
+  EXPECT_FALSE(lz4::decompress(corrupted).has_value());
+}
+
+TEST(Lz4Test, RejectsMalformedFrames) {
+  const std::string frame = lz4::compress(json_like(10'000));
+
+  EXPECT_FALSE(lz4::decompress("").has_value());
+  EXPECT_FALSE(lz4::decompress(frame.substr(0, frame.size() - 1)).has_value());
+  EXPECT_FALSE(lz4::decompress(frame.substr(0, 20)).has_value());
+
+  std::string bad_magic = frame;
+  bad_magic[0] ^= 1;
+  EXPECT_FALSE(lz4::decompress(bad_magic).has_value());
+
+  std::string bad_header = frame;
+  bad_header[6] ^= 1; // content size: the header checksum no longer fits
+  EXPECT_FALSE(lz4::decompress(bad_header).has_value());
+
+  // Flipping bytes inside the block must fail cleanly or decode to
+  // something else — never read or write out of bounds
+  for (std::size_t i = 20; i < frame.size() - 4; i += 7) {
+    std::string damaged = frame;
+    damaged[i] ^= 0x5A;
+    (void)lz4::decompress(damaged);
+  }
+}
+
+TEST(CompressionTest, LargeValuesAreStoredCompressed) {
+  KeyValueStore store;
+  store.set_compression_min_bytes(1024);
+  const std::string big = json_like(50'000);
+  store.set("big", big);
+  store.set("small", "tiny value");
+
+  EXPECT_EQ(store.get("big"), big);
+  EXPECT_EQ(store.get("small"), "tiny value");
+
+  const auto encoded = store.get_encoded("big");
+  ASSERT_TRUE(encoded.has_value());
+  EXPECT_EQ(encoded->codec, ValueCodec::LZ4);
+  EXPECT_LT(encoded->bytes.size(), big.size());
+  EXPECT_EQ(lz4::decompress(encoded->bytes), big); // a standard frame
+
+  EXPECT_EQ(store.get_encoded("small")->codec, ValueCodec::NONE);
+  EXPECT_FALSE(store.get_encoded("missing").has_value());
+
+  const auto stats = store.compression_stats();
+  EXPECT_EQ(stats.compressed, 1u);
+  EXPECT_EQ(stats.raw_bytes, big.size());
+  EXPECT_EQ(stats.compressed_bytes, encoded->bytes.size());
+}
+
+TEST(CompressionTest, IncompressibleValuesStayPlain) {
+  KeyValueStore store;
+  store.set_compression_min_bytes(1024);
+  const std::string noise = random_bytes(10'000);
+  store.set("noise", noise);
+
+  EXPECT_EQ(store.get_encoded("noise")->codec, ValueCodec::NONE);
+  EXPECT_EQ(store.get("noise"), noise);
+  EXPECT_EQ(store.compression_stats().rejected, 1u);
+}
+
+TEST(CompressionTest, TypedReadersSeeThePlainValue) {
+  KeyValueStore store;
+  store.set_compression_min_bytes(1024);
+  const std::string big = json_like(20'000);
+  store.set("a", big);
+  store.set("b", "short");
+
+  std::string seen;
+  EXPECT_EQ(store.read_as<std::string>(
+                "a", [&](const std::string &value) { seen = value; }),
+            AccessStatus::OK);
+  EXPECT_EQ(seen, big);
+
+  std::vector<std::string> many;
+  store.read_many_as<std::string>(
+      {"a", "b", "missing"}, [&](const std::vector<const std::string *> &v) {
+        for (const std::string *value : v) {
+          many.push_back(value == nullptr ? "<nil>" : *value);
+        }
+      });
+  EXPECT_EQ(many, (std::vector<std::string>{big, "short", "<nil>"}));
+
+  store.read_values({"a"}, [&](const std::vector<const StoreValue *> &v) {
+    ASSERT_NE(v[0], nullptr);
+    ASSERT_NE(mini_redis::string_value(*v[0]), nullptr);
+    EXPECT_EQ(*mini_redis::string_value(*v[0]), big);
+  });
+}
+
+TEST(CompressionTest, InPlaceEditsWorkOnTheDecompressedValue) {
+  KeyValueStore store;
+  store.set_compression_min_bytes(1024);
+  const std::string big = json_like(20'000);
+  store.set("doc", big);
+
+  EXPECT_EQ(store.modify_as<std::string>("doc", false,
+                                         [](std::string &value) {
+                                           value[0] = '[';
+                                           return true;
+                                         }),
+            AccessStatus::OK);
+  std::string expected = big;
+  expected[0] = '[';
+  EXPECT_EQ(store.get("doc"), expected);
+}
+
+TEST(CompressionTest, SnapshotsKeepValuesCompressed) {
+  KeyValueStore store;
+  store.set_compression_min_bytes(1024);
+  const std::string big = json_like(30'000);
+  store.set("big", big);
+  store.set("small", "plain");
+
+  const std::string snapshot = mini_redis::encode_snapshot(store);
+  EXPECT_LT(snapshot.size(), big.size());
+
+  KeyValueStore loaded; // compression off: values keep their encoding
+  ASSERT_EQ(mini_redis::decode_snapshot(loaded, snapshot), 2u);
+  EXPECT_EQ(loaded.get("big"), big);
+  EXPECT_EQ(loaded.get_encoded("big")->codec, ValueCodec::LZ4);
+  EXPECT_EQ(loaded.get("small"), "plain");
+}
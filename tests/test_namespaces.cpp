@@ -0,0 +1,265 @@
+// =============================================================================
+// test_namespaces.cpp — Unit Tests for Namespaces
+// =============================================================================
+//
+// Namespaces must not see each other's keys, a flush must leave an empty
+// namespace with its settings intact (freeing the old keys behind the
+// scenes), and a namespace over its quota must evict, or refuse writes,
+// as its policy says; a write is charged only what it changes. However
+// many namespaces there are, one thread maintains them all.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/namespaces.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+using mini_redis::EvictionPolicy;
+using mini_redis::NamespaceLimits;
+using mini_redis::NamespaceRegistry;
+
+namespace {
+
+// Long enough that the background cycle never runs during a test: each
+// test calls enforce_quota() itself
+constexpr std::chrono::milliseconds NEVER{std::chrono::hours(1)};
+
+NamespaceLimits quota(std::size_t max_memory, EvictionPolicy policy) {
+  return NamespaceLimits{max_memory, policy, NEVER};
+}
+
+// A write as the namespace handler makes one: charged what it changed
+void put(mini_redis::Namespace &ns, const std::string &key,
+         const std::string &value, int ttl_seconds = 0) {
+  const std::size_t before = ns.entry_bytes(key);
+  ns.store().set(key, value, ttl_seconds);
+  ns.charge(before, ns.entry_bytes(key));
+}
+
+void wait_for_reclaimer(const NamespaceRegistry &registry) {
+  for (int i = 0; i < 1000 && registry.pending_reclaims() > 0; ++i) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+}
+
+// Threads in this process, or 0 where /proc isn't available
+std::size_t thread_count() {
+  std::error_code error;
+  std::filesystem::directory_iterator tasks("/proc/self/task", error);
+  if (error) {
+    return 0;
+  }
+  std::size_t count = 0;
+  for (const auto &task : tasks) {
+    (void)task;
+    ++count;
+  }
+  return count;
+}
+
+} // anonymous namespace
+
+TEST(NamespacesTest, KeysAreIsolated) {
+  NamespaceRegistry registry;
+  ASSERT_TRUE(registry.create("acme", NamespaceLimits{}));
+  ASSERT_TRUE(registry.create("globex", NamespaceLimits{}));
+  EXPECT_FALSE(registry.create("acme", NamespaceLimits{})); // taken
+  EXPECT_FALSE(registry.create("no/slash", NamespaceLimits{}));
+  EXPECT_FALSE(registry.create("", NamespaceLimits{}));
+
+  auto acme = registry.find("acme");
+  auto globex = registry.find("globex");
+  acme->store().set("user:1", "alice");
+  acme->store().set("42", "integer key");
+  globex->store().set("user:1", "bob");
+
+  EXPECT_EQ(acme->store().get("user:1"), "alice");
+  EXPECT_EQ(globex->store().get("user:1"), "bob");
+  EXPECT_EQ(acme->store().keys().size(), 2u);
+  EXPECT_EQ(globex->store().keys().size(), 1u);
+  EXPECT_EQ(registry.find("initech"), nullptr);
+  EXPECT_EQ(registry.names(), (std::vector<std::string>{"acme", "globex"}));
+}
+
+TEST(NamespacesTest, FlushAndDrop) {
+  NamespaceRegistry registry;
+  const NamespaceLimits limits = quota(1 << 20, EvictionPolicy::VOLATILE_TTL);
+  ASSERT_TRUE(registry.create("acme", limits));
+  auto before = registry.find("acme");
+  for (int i = 0; i < 10000; ++i) {
+    before->store().set("key:" + std::to_string(i), "value");
+  }
+
+  ASSERT_TRUE(registry.flush("acme"));
+  auto after = registry.find("acme");
+  EXPECT_NE(after, before);
+  EXPECT_TRUE(after->store().keys().empty());
+  EXPECT_EQ(after->limits().max_memory, limits.max_memory);
+  EXPECT_EQ(after->limits().eviction, EvictionPolicy::VOLATILE_TTL);
+
+  // Whoever still holds the old namespace keeps a working store; the
+  // last one to let go frees it
+  EXPECT_EQ(before->store().get("key:9999"), "value");
+  before.reset();
+  wait_for_reclaimer(registry);
+  EXPECT_EQ(registry.pending_reclaims(), 0u);
+
+  EXPECT_TRUE(registry.drop("acme"));
+  EXPECT_EQ(registry.find("acme"), nullptr);
+  EXPECT_FALSE(registry.drop("acme"));
+  EXPECT_FALSE(registry.flush("acme"));
+}
+
+TEST(NamespacesTest, NoEvictionRefusesWritesOverQuota) {
+  NamespaceRegistry registry;
+  ASSERT_TRUE(
+      registry.create("acme", quota(4096, EvictionPolicy::NO_EVICTION)));
+  auto ns = registry.find("acme");
+  EXPECT_TRUE(ns->admits_writes());
+
+  for (int i = 0; i < 40; ++i) {
+    put(*ns, "key:" + std::to_string(i), std::string(100, 'x'));
+  }
+  EXPECT_EQ(ns->enforce_quota(), 0u); // never evicts...
+  EXPECT_GT(ns->used_bytes(), 4096u);
+  EXPECT_FALSE(ns->admits_writes()); // ...refuses instead
+  EXPECT_EQ(ns->store().keys().size(), 40u);
+
+  // A larger quota lets writes through again, until they fill it
+  ns->set_limits(quota(ns->used_bytes() + 1000, EvictionPolicy::NO_EVICTION));
+  EXPECT_TRUE(ns->admits_writes());
+  put(*ns, "big", std::string(1000, 'x'));
+  EXPECT_FALSE(ns->admits_writes());
+}
+
+TEST(NamespacesTest, WritesAreChargedWhatTheyChange) {
+  NamespaceRegistry registry;
+  ASSERT_TRUE(
+      registry.create("acme", quota(10000, EvictionPolicy::NO_EVICTION)));
+  auto ns = registry.find("acme");
+
+  // Rewriting one key costs only its first write, however often
+  for (int i = 0; i < 200; ++i) {
+    put(*ns, "counter", std::to_string(1000000 + i));
+    ASSERT_TRUE(ns->admits_writes()) << i;
+  }
+  const std::size_t one_key = ns->used_bytes();
+  EXPECT_EQ(one_key, ns->entry_bytes("counter"));
+
+  put(*ns, "counter", std::string(100, 'x')); // grows by the difference
+  EXPECT_EQ(ns->used_bytes(), ns->entry_bytes("counter"));
+  EXPECT_GT(ns->used_bytes(), one_key);
+
+  // A delete credits the entry back; deleting it again changes nothing
+  for (int repeat = 0; repeat < 2; ++repeat) {
+    const std::size_t before = ns->entry_bytes("counter");
+    ns->store().remove("counter");
+    ns->charge(before, ns->entry_bytes("counter"));
+    EXPECT_EQ(ns->used_bytes(), 0u);
+  }
+
+  // Expired keys are credited by the cycle that removes them
+  ASSERT_TRUE(registry.create(
+      "brief", NamespaceLimits{10000, EvictionPolicy::NO_EVICTION,
+                               std::chrono::milliseconds(10)}));
+  auto brief = registry.find("brief");
+  put(*brief, "short", "lived", 1);
+  EXPECT_GT(brief->used_bytes(), 0u);
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  while (brief->used_bytes() > 0 &&
+         std::chrono::steady_clock::now() < deadline) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(brief->used_bytes(), 0u);
+}
+
+TEST(NamespacesTest, EvictionBringsUsageUnderQuota) {
+  NamespaceRegistry registry;
+  ASSERT_TRUE(
+      registry.create("random", quota(8192, EvictionPolicy::ALLKEYS_RANDOM)));
+  auto random = registry.find("random");
+  for (int i = 0; i < 200; ++i) {
+    put(*random, "key:" + std::to_string(i), std::string(100, 'x'));
+  }
+  EXPECT_GT(random->enforce_quota(), 0u);
+  EXPECT_LE(random->used_bytes(), 8192u);
+  EXPECT_TRUE(random->admits_writes());
+  EXPECT_LT(random->store().keys().size(), 200u);
+
+  // volatile-ttl: the soonest to expire go first, keys without a TTL stay
+  ASSERT_TRUE(
+      registry.create("ttl", quota(2300, EvictionPolicy::VOLATILE_TTL)));
+  auto ttl = registry.find("ttl");
+  for (int i = 0; i < 10; ++i) {
+    put(*ttl, "permanent:" + std::to_string(i), std::string(100, 'p'));
+  }
+  put(*ttl, "soon", std::string(100, 's'), 10);
+  put(*ttl, "later", std::string(100, 'l'), 1000);
+  EXPECT_EQ(ttl->enforce_quota(), 1u);
+  EXPECT_FALSE(ttl->store().get("soon").has_value());
+  EXPECT_TRUE(ttl->store().get("later").has_value());
+  EXPECT_EQ(ttl->evicted(), 1u);
+
+  // Only permanent keys over the quota: nothing left to evict
+  ttl->set_limits(quota(512, EvictionPolicy::VOLATILE_TTL));
+  EXPECT_EQ(ttl->enforce_quota(), 1u); // "later"
+  EXPECT_EQ(ttl->enforce_quota(), 0u);
+  EXPECT_EQ(ttl->store().keys().size(), 10u);
+}
+
+TEST(NamespacesTest, ConfigureReachesEveryStore) {
+  NamespaceRegistry registry;
+  ASSERT_TRUE(registry.create("before", NamespaceLimits{}));
+  registry.configure([](mini_redis::KeyValueStore &store) {
+    store.set_compression_min_bytes(64);
+  });
+  ASSERT_TRUE(registry.create("after", NamespaceLimits{}));
+  ASSERT_TRUE(registry.flush("before"));
+
+  for (const char *name : {"before", "after"}) {
+    auto ns = registry.find(name);
+    EXPECT_EQ(ns->store().compression_stats().min_bytes, 64u) << name;
+  }
+}
+
+TEST(NamespacesTest, OneThreadMaintainsEveryNamespace) {
+  NamespaceRegistry registry;
+  const std::size_t threads_before = thread_count();
+  const NamespaceLimits limits{8192, EvictionPolicy::ALLKEYS_RANDOM,
+                               std::chrono::milliseconds(10)};
+  constexpr int NAMESPACES = 50;
+  for (int n = 0; n < NAMESPACES; ++n) {
+    const std::string name = "tenant" + std::to_string(n);
+    ASSERT_TRUE(registry.create(name, limits));
+    ASSERT_TRUE(registry.flush(name)); // a fresh instance, same thread
+    auto ns = registry.find(name);
+    for (int i = 0; i < 200; ++i) {
+      put(*ns, "key:" + std::to_string(i), std::string(100, 'x'));
+    }
+  }
+  wait_for_reclaimer(registry);
+  EXPECT_EQ(thread_count(), threads_before);
+
+  // Nobody calls enforce_quota() here: the maintenance thread does, for
+  // each namespace on its own interval
+  const auto deadline =
+      std::chrono::steady_clock::now() + std::chrono::seconds(5);
+  int maintained = 0;
+  while (std::chrono::steady_clock::now() < deadline) {
+    maintained = 0;
+    for (int n = 0; n < NAMESPACES; ++n) {
+      auto ns = registry.find("tenant" + std::to_string(n));
+      maintained += ns->evicted() > 0 && ns->used_bytes() <= 8192 ? 1 : 0;
+    }
+    if (maintained == NAMESPACES) {
+      break;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  EXPECT_EQ(maintained, NAMESPACES);
+}
@@ -0,0 +1,131 @@
+// =============================================================================
+// test_rate_limiter.cpp — Unit Tests for the Rate Limiter
+// =============================================================================
+//
+// Time is passed in explicitly (acquire(client, now_ms)), so the tests
+// can step through seconds of refill without waiting for them.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "util/rate_limiter.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using mini_redis::RateLimiter;
+using mini_redis::RateLimitKey;
+
+TEST(RateLimiterTest, OffUntilConfigured) {
+  RateLimiter limiter;
+  EXPECT_FALSE(limiter.enabled());
+  for (int i = 0; i < 1000; ++i) {
+    EXPECT_TRUE(limiter.acquire("ip:10.0.0.1", 1).allowed);
+  }
+  EXPECT_EQ(limiter.stats().allowed, 0u); // not even counted
+
+  limiter.configure(10, 0); // burst defaults to the rate
+  EXPECT_TRUE(limiter.enabled());
+  EXPECT_EQ(limiter.stats().burst, 10u);
+  limiter.configure(0, 50);
+  EXPECT_FALSE(limiter.enabled());
+}
+
+TEST(RateLimiterTest, BurstThenRefill) {
+  RateLimiter limiter;
+  limiter.configure(10, 5); // 10/s, one token every 100 ms
+
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(limiter.acquire("ip:10.0.0.1", 1000).allowed) << i;
+  }
+  const auto refused = limiter.acquire("ip:10.0.0.1", 1000);
+  EXPECT_FALSE(refused.allowed);
+  EXPECT_EQ(refused.retry_after_ms, 100u);
+
+  // Half a token later: still empty, and half as long to wait
+  const auto half = limiter.acquire("ip:10.0.0.1", 1050);
+  EXPECT_FALSE(half.allowed);
+  EXPECT_EQ(half.retry_after_ms, 50u);
+
+  EXPECT_TRUE(limiter.acquire("ip:10.0.0.1", 1100).allowed);
+  EXPECT_FALSE(limiter.acquire("ip:10.0.0.1", 1100).allowed);
+
+  // A long pause refills it only up to the burst
+  for (int i = 0; i < 5; ++i) {
+    EXPECT_TRUE(limiter.acquire("ip:10.0.0.1", 60'000).allowed) << i;
+  }
+  EXPECT_FALSE(limiter.acquire("ip:10.0.0.1", 60'000).allowed);
+
+  const auto stats = limiter.stats();
+  EXPECT_EQ(stats.allowed, 11u);
+  EXPECT_EQ(stats.rejected, 4u);
+}
+
+TEST(RateLimiterTest, ClientsHaveTheirOwnBuckets) {
+  RateLimiter limiter;
+  limiter.configure(1, 1);
+  EXPECT_TRUE(limiter.acquire("ip:10.0.0.1", 1).allowed);
+  EXPECT_FALSE(limiter.acquire("ip:10.0.0.1", 1).allowed);
+  EXPECT_TRUE(limiter.acquire("ip:10.0.0.2", 1).allowed);
+  EXPECT_TRUE(limiter.acquire("key:10.0.0.1", 1).allowed);
+  EXPECT_TRUE(limiter.acquire("ns:acme", 1).allowed);
+  EXPECT_FALSE(limiter.acquire("ns:acme", 1).allowed);
+}
+
+// With every slot held by an active client, a new one is let through
+// (and counted); once the others go quiet, their slots are reused
+TEST(RateLimiterTest, FullTableFailsOpenThenRecycles) {
+  RateLimiter limiter;
+  limiter.configure(1, 1); // a bucket is idle again after one second
+
+  const std::size_t clients = RateLimiter::SLOTS + RateLimiter::SLOTS / 2;
+  for (std::size_t i = 0; i < clients; ++i) {
+    limiter.acquire("ip:" + std::to_string(i), 1);
+  }
+  const std::uint64_t untracked = limiter.stats().untracked;
+  EXPECT_GT(untracked, 0u);
+  EXPECT_EQ(limiter.stats().rejected, 0u);
+
+  for (std::size_t i = 0; i < 1000; ++i) {
+    const std::string client = "new:" + std::to_string(i);
+    EXPECT_TRUE(limiter.acquire(client, 2000).allowed);
+    EXPECT_FALSE(limiter.acquire(client, 2000).allowed); // tracked again
+  }
+  EXPECT_EQ(limiter.stats().untracked, untracked);
+}
+
+// Many threads draining one bucket at the same instant: the CAS loop
+// must hand out exactly 'burst' tokens, no more, no fewer
+TEST(RateLimiterTest, ConcurrentAcquiresNeverOverspend) {
+  RateLimiter limiter;
+  limiter.configure(1, 1000);
+
+  std::atomic<int> allowed{0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&limiter, &allowed] {
+      for (int i = 0; i < 1000; ++i) {
+        if (limiter.acquire("ip:10.0.0.1", 5).allowed) {
+          allowed.fetch_add(1);
+        }
+      }
+    });
+  }
+  for (std::thread &thread : threads) {
+    thread.join();
+  }
+  EXPECT_EQ(allowed.load(), 1000);
+  EXPECT_EQ(limiter.stats().rejected, 3000u);
+}
+
+TEST(RateLimiterTest, KeyNames) {
+  for (RateLimitKey key :
+       {RateLimitKey::IP, RateLimitKey::API_KEY, RateLimitKey::NAMESPACE}) {
+    EXPECT_EQ(mini_redis::parse_rate_limit_key(
+                  mini_redis::rate_limit_key_name(key)),
+              key);
+  }
+  EXPECT_FALSE(mini_redis::parse_rate_limit_key("cookie").has_value());
+}
@@ -0,0 +1,182 @@
+// =============================================================================
+// test_set.cpp — Unit Tests for the Set Value Type and Intersection Kernels
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/key_value_store.hpp"
+#include "core/set.hpp"
+#include "core/set_ops.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using mini_redis::Set;
+
+namespace {
+
+std::vector<std::string> sorted(std::vector<std::string> items) {
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+std::vector<std::int64_t> random_ids(std::size_t count, std::int64_t universe,
+                                     std::mt19937_64 &rng) {
+  std::set<std::int64_t> ids;
+  while (ids.size() < count) {
+    ids.insert(static_cast<std::int64_t>(rng() % universe) - universe / 2);
+  }
+  return {ids.begin(), ids.end()};
+}
+
+} // anonymous namespace
+
+// --- Test: integer members keep the compact encoding ---
+TEST(SetTest, IntegersUseIntset) {
+  Set set;
+  EXPECT_TRUE(set.add("42"));
+  EXPECT_TRUE(set.add("-7"));
+  EXPECT_FALSE(set.add("42"));
+
+  EXPECT_EQ(set.encoding(), Set::Encoding::INTSET);
+  EXPECT_EQ(set.members(), (std::vector<std::string>{"-7", "42"}));
+  EXPECT_TRUE(set.contains("42"));
+  EXPECT_FALSE(set.contains("042"));
+}
+
+// --- Test: non-canonical integers and strings switch to a hashtable ---
+TEST(SetTest, ConvertsToHashtable) {
+  Set set;
+  set.add("1");
+  set.add("007"); // must come back as "007", not "7"
+
+  EXPECT_EQ(set.encoding(), Set::Encoding::HASHTABLE);
+  EXPECT_EQ(sorted(set.members()), (std::vector<std::string>{"007", "1"}));
+  EXPECT_TRUE(set.remove("1"));
+  EXPECT_FALSE(set.remove("1"));
+  EXPECT_EQ(set.size(), 1u);
+}
+
+// --- Test: bulk insert merges and counts only new members ---
+TEST(SetTest, AddAllCountsNewMembers) {
+  Set set;
+  EXPECT_EQ(set.add_all({"3", "1", "2", "3"}), 3u);
+  EXPECT_EQ(set.add_all({"2", "4"}), 1u);
+  EXPECT_EQ(set.members(), (std::vector<std::string>{"1", "2", "3", "4"}));
+
+  EXPECT_EQ(set.add_all({"5", "five"}), 2u);
+  EXPECT_EQ(set.encoding(), Set::Encoding::HASHTABLE);
+  EXPECT_EQ(set.size(), 6u);
+}
+
+// --- Test: every kernel agrees with std::set_intersection ---
+TEST(SetOpsTest, KernelsMatchReference) {
+  std::mt19937_64 rng(11);
+  const std::size_t sizes[] = {0, 1, 3, 4, 5, 17, 100, 1000, 5000};
+
+  for (const std::size_t a_size : sizes) {
+    for (const std::size_t b_size : sizes) {
+      const auto a = random_ids(a_size, 20000, rng);
+      const auto b = random_ids(b_size, 20000, rng);
+      std::vector<std::int64_t> expected;
+      std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                            std::back_inserter(expected));
+
+      std::vector<std::int64_t> out(std::min(a_size, b_size) + 1);
+      const auto check = [&](std::size_t count) {
+        EXPECT_EQ(std::vector<std::int64_t>(out.begin(), out.begin() + count),
+                  expected)
+            << "sizes " << a_size << " x " << b_size;
+      };
+      check(mini_redis::intersect_merge_scalar(a.data(), a.size(), b.data(),
+                                               b.size(), out.data()));
+      check(mini_redis::intersect_merge_simd(a.data(), a.size(), b.data(),
+                                             b.size(), out.data()));
+      check(mini_redis::intersect_gallop(a.data(), a.size(), b.data(),
+                                         b.size(), out.data()));
+      check(mini_redis::intersect_sorted(a.data(), a.size(), b.data(),
+                                         b.size(), out.data()));
+    }
+  }
+}
+
+// --- Test: the output buffer may alias the first input ---
+TEST(SetOpsTest, InPlaceIntersection) {
+  std::mt19937_64 rng(5);
+  for (int round = 0; round < 200; ++round) {
+    auto a = random_ids(1 + rng() % 300, 600, rng);
+    const auto b = random_ids(1 + rng() % 300, 600, rng);
+    std::vector<std::int64_t> expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(expected));
+
+    auto a_simd = a;
+    const auto simd_count = mini_redis::intersect_merge_simd(
+        a_simd.data(), a_simd.size(), b.data(), b.size(), a_simd.data());
+    a_simd.resize(simd_count);
+    EXPECT_EQ(a_simd, expected);
+
+    const auto count = mini_redis::intersect_sorted(a.data(), a.size(),
+                                                    b.data(), b.size(), a.data());
+    a.resize(count);
+    EXPECT_EQ(a, expected);
+  }
+}
+
+// --- Test: multi-set intersection and union, all encodings ---
+TEST(SetTest, IntersectAndUnite) {
+  Set evens;
+  Set threes;
+  Set mixed;
+  for (int i = 0; i <= 30; ++i) {
+    if (i % 2 == 0) {
+      evens.add(std::to_string(i));
+    }
+    if (i % 3 == 0) {
+      threes.add(std::to_string(i));
+    }
+  }
+  mixed.add_all({"6", "12", "13", "tag"});
+
+  EXPECT_EQ(Set::intersect({&evens, &threes}),
+            (std::vector<std::string>{"0", "6", "12", "18", "24", "30"}));
+  EXPECT_EQ(sorted(Set::intersect({&evens, &threes, &mixed})),
+            (std::vector<std::string>{"12", "6"}));
+  EXPECT_TRUE(Set::intersect({&evens, nullptr}).empty());
+
+  const auto all = Set::unite({&evens, &threes, &mixed, nullptr});
+  EXPECT_EQ(all.size(), 16u + 11u - 6u + 2u); // + "13" and "tag"
+}
+
+// --- Test: SINTER through the store reads all keys at once ---
+TEST(SetTest, StoreReadsManyKeys) {
+  mini_redis::KeyValueStore store;
+  store.modify_as<Set>("a", true, [](Set &set) {
+    set.add_all({"1", "2", "3"});
+    return true;
+  });
+  store.modify_as<Set>("b", true, [](Set &set) {
+    set.add_all({"2", "3", "4"});
+    return true;
+  });
+  store.set("plain", "text");
+
+  std::vector<std::string> result;
+  const auto status = store.read_many_as<Set>(
+      {"a", "b"}, [&](const std::vector<const Set *> &sets) {
+        result = Set::intersect(sets);
+      });
+  EXPECT_EQ(status, mini_redis::AccessStatus::OK);
+  EXPECT_EQ(result, (std::vector<std::string>{"2", "3"}));
+
+  bool called = false;
+  EXPECT_EQ(store.read_many_as<Set>(
+                {"a", "plain"},
+                [&](const std::vector<const Set *> &) { called = true; }),
+            mini_redis::AccessStatus::WRONG_TYPE);
+  EXPECT_FALSE(called);
+}
@@ -0,0 +1,319 @@
+// =============================================================================
+// test_sketches.cpp — Unit Tests for Bloom Filters, Count-Min Sketches and
+//                     Snapshots
+// =============================================================================
+//
+// Both sketches give APPROXIMATE answers with one-sided error, so the tests
+// check the guarantees rather than exact values:
+//   Bloom filter:     never a false negative; false positives near the target
+//   Count-min sketch: never an underestimate; overestimate within eps * N
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/bloom_filter.hpp"
+#include "core/count_min_sketch.hpp"
+#include "core/key_value_store.hpp"
+#include "core/snapshot.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using mini_redis::BloomFilter;
+using mini_redis::ByteReader;
+using mini_redis::CountMinSketch;
+using mini_redis::HyperLogLog;
+using mini_redis::KeyValueStore;
+using mini_redis::QuickList;
+using mini_redis::Set;
+using mini_redis::SortedSet;
+
+namespace {
+
+std::vector<std::string> make_items(const std::string &prefix, int count) {
+  std::vector<std::string> items;
+  items.reserve(count);
+  for (int i = 0; i < count; ++i) {
+    items.push_back(prefix + std::to_string(i));
+  }
+  return items;
+}
+
+} // anonymous namespace
+
+// --- Test: every added item is found, batched and single-item agree ---
+TEST(BloomFilterTest, NoFalseNegatives) {
+  BloomFilter filter(0.01, 1000);
+  const auto items = make_items("item:", 1000);
+
+  const auto added = filter.add_all(items);
+  EXPECT_EQ(filter.size(), 1000u);
+  for (const auto &item : items) {
+    EXPECT_TRUE(filter.contains(item));
+  }
+  for (const bool found : filter.contains_all(items)) {
+    EXPECT_TRUE(found);
+  }
+  // Re-adding reports "not new" for every item
+  for (const bool fresh : filter.add_all(items)) {
+    EXPECT_FALSE(fresh);
+  }
+  EXPECT_EQ(added.size(), items.size());
+}
+
+// --- Test: false-positive rate stays near the requested error rate ---
+TEST(BloomFilterTest, FalsePositiveRateNearTarget) {
+  BloomFilter filter(0.01, 10'000);
+  filter.add_all(make_items("in:", 10'000));
+
+  int false_positives = 0;
+  for (const bool found : filter.contains_all(make_items("out:", 100'000))) {
+    false_positives += found ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 2000); // 2%: twice the target, generous
+}
+
+// --- Test: outgrowing the capacity adds layers, error stays bounded ---
+TEST(BloomFilterTest, ScalesWithNewLayers) {
+  BloomFilter filter(0.01, 100);
+  const auto items = make_items("grow:", 10'000);
+  filter.add_all(items);
+
+  EXPECT_GT(filter.layer_count(), 1u);
+  for (const bool found : filter.contains_all(items)) {
+    EXPECT_TRUE(found);
+  }
+
+  int false_positives = 0;
+  for (const bool found : filter.contains_all(make_items("out:", 50'000))) {
+    false_positives += found ? 1 : 0;
+  }
+  EXPECT_LT(false_positives, 1500); // total bound is ~2x the first layer's
+}
+
+// --- Test: estimates never undercount and stay within eps * N ---
+TEST(CountMinSketchTest, EstimatesWithinBounds) {
+  auto sketch = *CountMinSketch::from_error(0.001, 0.01);
+  std::uint64_t total = 0;
+  for (int i = 0; i < 5000; ++i) {
+    const std::uint64_t count = 1 + i % 7;
+    sketch.increment("key:" + std::to_string(i), count);
+    total += count;
+  }
+  EXPECT_EQ(sketch.total(), total);
+
+  const auto estimates = sketch.query_all(make_items("key:", 5000));
+  int over_bound = 0;
+  for (int i = 0; i < 5000; ++i) {
+    const std::uint64_t actual = 1 + i % 7;
+    EXPECT_GE(estimates[i], actual);
+    over_bound += estimates[i] > actual + total / 1000 ? 1 : 0;
+  }
+  EXPECT_LE(over_bound, 50); // at most delta (1%) may exceed the bound
+  EXPECT_EQ(sketch.query("never-seen") <= total / 1000, true);
+}
+
+// --- Test: batched increments return the post-increment estimates ---
+TEST(CountMinSketchTest, BatchedIncrements) {
+  CountMinSketch sketch(1000, 5);
+  const auto estimates =
+      sketch.increment_all({{"a", 3}, {"b", 1}, {"a", 2}});
+  ASSERT_EQ(estimates.size(), 3u);
+  EXPECT_EQ(estimates[0], 3u);
+  EXPECT_EQ(estimates[2], 5u);
+  EXPECT_EQ(sketch.query("a"), 5u);
+}
+
+// --- Test: oversized dimensions are refused before any allocation ---
+TEST(CountMinSketchTest, SizeCheckedBeforeAllocating) {
+  const std::uint64_t huge = std::uint64_t{1} << 32;
+  EXPECT_FALSE(CountMinSketch::fits(huge, huge)); // the product wraps to 0
+  EXPECT_FALSE(CountMinSketch::fits(1000, 1000, 999'999));
+  EXPECT_TRUE(CountMinSketch::fits(1000, 1000, 1'000'000));
+
+  EXPECT_FALSE(CountMinSketch::from_error(1e-300, 0.01).has_value());
+  EXPECT_FALSE(CountMinSketch::from_error(0.001, 0.01, 1000).has_value());
+  const auto sketch = CountMinSketch::from_error(0.001, 0.01);
+  ASSERT_TRUE(sketch.has_value());
+  EXPECT_EQ(sketch->width(), 2719u);
+  EXPECT_EQ(sketch->depth(), 5u);
+}
+
+// --- Test: both sketches round-trip through their byte encoding ---
+TEST(SketchSerializationTest, RoundTrip) {
+  BloomFilter filter(0.001, 50);
+  filter.add_all(make_items("x", 500));
+  CountMinSketch sketch(64, 3);
+  sketch.increment("hot", 42);
+
+  std::string bytes;
+  filter.serialize(bytes);
+  sketch.serialize(bytes);
+
+  ByteReader in(bytes);
+  const auto filter_copy = BloomFilter::deserialize(in);
+  const auto sketch_copy = CountMinSketch::deserialize(in);
+  ASSERT_TRUE(filter_copy.has_value());
+  ASSERT_TRUE(sketch_copy.has_value());
+  EXPECT_TRUE(in.at_end());
+
+  EXPECT_EQ(filter_copy->size(), 500u);
+  EXPECT_EQ(filter_copy->layer_count(), filter.layer_count());
+  EXPECT_EQ(filter_copy->contains_all(make_items("y", 1000)),
+            filter.contains_all(make_items("y", 1000)));
+  EXPECT_EQ(sketch_copy->query("hot"), 42u);
+
+  // Truncated input is rejected, not misread
+  ByteReader truncated(std::string_view(bytes).substr(0, bytes.size() / 2));
+  EXPECT_FALSE(BloomFilter::deserialize(truncated).has_value());
+}
+
+// --- Test: sizes in an untrusted header are checked before allocating ---
+TEST(SketchSerializationTest, HugeBloomHeaderIsRejected) {
+  // A valid one-layer filter whose initial capacity claims 2^40 items: the
+  // old decoder sized a throwaway first layer (~1.2 TB) from it
+  std::string bytes;
+  mini_redis::put_f64(bytes, 0.01);
+  mini_redis::put_u64(bytes, std::uint64_t{1} << 40);
+  mini_redis::put_u64(bytes, 0);
+  mini_redis::put_u32(bytes, 1);
+  mini_redis::put_u64(bytes, 64); // bits
+  mini_redis::put_u32(bytes, 7);  // hashes
+  mini_redis::put_u64(bytes, 100);
+  mini_redis::put_u64(bytes, 0);
+  mini_redis::put_u64(bytes, 0); // the one word
+  ByteReader in(bytes);
+  EXPECT_FALSE(BloomFilter::deserialize(in).has_value());
+
+  // What a reservation would allocate, before building it
+  EXPECT_GT(BloomFilter::first_layer_bits(1e-300, 1'000'000'000), 1e12);
+  EXPECT_NEAR(BloomFilter::first_layer_bits(0.01, 1000), 9586, 1);
+}
+
+// --- Test: a snapshot restores every value type and its TTL ---
+TEST(SnapshotTest, RoundTripsEveryType) {
+  KeyValueStore store;
+  store.set("greeting", "hello");
+  store.set("session", "abc", 100);
+  store.modify_as<SortedSet>("board", true, [](SortedSet &z) {
+    z.add("alice", 10);
+    z.add("bob", 2.5);
+    return true;
+  });
+  store.modify_as<QuickList>("queue", true, [](QuickList &list) {
+    list.push_back("one");
+    list.push_back("two");
+    return true;
+  });
+  store.modify_as<Set>("ids", true, [](Set &set) {
+    set.add_all({"3", "1", "2"});
+    return true;
+  });
+  store.modify_as<Set>("tags", true, [](Set &set) {
+    set.add_all({"cpp", "redis"});
+    return true;
+  });
+  store.modify_as<HyperLogLog>("visitors", true, [](HyperLogLog &hll) {
+    for (int i = 0; i < 5000; ++i) {
+      hll.add("v" + std::to_string(i));
+    }
+    return true;
+  });
+  store.modify_as<BloomFilter>("seen", true, [](BloomFilter &filter) {
+    filter.add("url:1");
+    return true;
+  });
+  store.modify_as<CountMinSketch>("hits", true, [](CountMinSketch &sketch) {
+    sketch.increment("page", 7);
+    return true;
+  });
+
+  const std::string bytes = mini_redis::encode_snapshot(store);
+  KeyValueStore restored;
+  ASSERT_EQ(mini_redis::decode_snapshot(restored, bytes), 9u);
+
+  EXPECT_EQ(restored.get("greeting"), "hello");
+  EXPECT_EQ(restored.get("session"), "abc");
+  restored.read_as<SortedSet>("board", [](const SortedSet &z) {
+    EXPECT_EQ(z.score("bob"), 2.5);
+    EXPECT_EQ(z.rank("alice"), 1u);
+  });
+  restored.read_as<QuickList>("queue", [](const QuickList &list) {
+    EXPECT_EQ(list.range(0, -1), (std::vector<std::string>{"one", "two"}));
+  });
+  restored.read_as<Set>("ids", [](const Set &set) {
+    EXPECT_EQ(set.encoding(), Set::Encoding::INTSET);
+    EXPECT_EQ(set.members(), (std::vector<std::string>{"1", "2", "3"}));
+  });
+  restored.read_as<Set>("tags", [](const Set &set) {
+    EXPECT_TRUE(set.contains("redis"));
+  });
+  std::uint64_t before = 0;
+  std::uint64_t after = 0;
+  store.read_as<HyperLogLog>(
+      "visitors", [&](const HyperLogLog &hll) { before = hll.count(); });
+  restored.read_as<HyperLogLog>(
+      "visitors", [&](const HyperLogLog &hll) { after = hll.count(); });
+  EXPECT_EQ(before, after);
+  restored.read_as<BloomFilter>("seen", [](const BloomFilter &filter) {
+    EXPECT_TRUE(filter.contains("url:1"));
+  });
+  restored.read_as<CountMinSketch>("hits", [](const CountMinSketch &sketch) {
+    EXPECT_EQ(sketch.query("page"), 7u);
+  });
+}
+
+// --- Test: corrupted snapshots are rejected without touching the store ---
+TEST(SnapshotTest, RejectsCorruption) {
+  KeyValueStore store;
+  store.set("a", "1");
+  store.set("b", "2");
+  std::string bytes = mini_redis::encode_snapshot(store);
+
+  KeyValueStore target;
+  target.set("keep", "me");
+
+  std::string flipped = bytes;
+  flipped[12] ^= 0x01;
+  EXPECT_FALSE(mini_redis::decode_snapshot(target, flipped).has_value());
+  EXPECT_FALSE(
+      mini_redis::decode_snapshot(target, bytes.substr(0, 20)).has_value());
+  EXPECT_FALSE(mini_redis::decode_snapshot(target, "not a snapshot at all")
+                   .has_value());
+  EXPECT_EQ(target.keys(), std::vector<std::string>{"keep"});
+
+  EXPECT_EQ(mini_redis::decode_snapshot(target, bytes), 2u);
+  EXPECT_EQ(target.get("b"), "2");
+}
+
+// --- Test: a TTL that would overflow the clock is refused ---
+TEST(SnapshotTest, RejectsOverflowingTtl) {
+  const auto now = std::chrono::steady_clock::now();
+  std::string bytes;
+  mini_redis::encode_snapshot_entry(
+      bytes, "k",
+      mini_redis::StoreEntry{std::string("v"), now + std::chrono::hours(1)},
+      now);
+
+  // The u64 TTL follows the type byte and the key
+  std::string key_bytes;
+  mini_redis::put_bytes(key_bytes, "k");
+  const std::size_t ttl_at = 1 + key_bytes.size();
+  for (const std::uint64_t ttl_ms :
+       {std::uint64_t{3'600'000}, std::uint64_t{1} << 63}) {
+    std::string ttl;
+    mini_redis::put_u64(ttl, ttl_ms);
+    bytes.replace(ttl_at, ttl.size(), ttl);
+
+    ByteReader in(bytes);
+    std::uint8_t tag = 0;
+    ASSERT_TRUE(in.get_u8(tag));
+    std::string key;
+    mini_redis::StoreEntry entry;
+    EXPECT_EQ(mini_redis::decode_snapshot_entry(in, tag, key, entry, now),
+              ttl_ms == 3'600'000)
+        << ttl_ms;
+  }
+}
@@ -0,0 +1,155 @@
+// =============================================================================
+// test_sorted_set.cpp — Unit Tests for the Sorted Set Value Type
+// =============================================================================
+//
+// The sorted set has two encodings (compact vector and skiplist), so most
+// behaviours are checked on BOTH: small sets stay compact, and we force the
+// skiplist by adding more than 128 members.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/key_value_store.hpp"
+#include "core/sorted_set.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <random>
+#include <string>
+
+using mini_redis::SortedSet;
+
+// --- Test: members are ordered by score, ties broken by name ---
+TEST(SortedSetTest, OrdersByScoreThenMember) {
+  SortedSet zset;
+  EXPECT_TRUE(zset.add("carol", 2.0));
+  EXPECT_TRUE(zset.add("alice", 1.0));
+  EXPECT_TRUE(zset.add("bob", 2.0));
+  EXPECT_FALSE(zset.add("alice", 3.0)); // update, not a new member
+
+  const auto all = zset.range_by_rank(0, -1);
+  ASSERT_EQ(all.size(), 3u);
+  EXPECT_EQ(all[0].member, "bob");
+  EXPECT_EQ(all[1].member, "carol");
+  EXPECT_EQ(all[2].member, "alice");
+  EXPECT_EQ(zset.encoding(), SortedSet::Encoding::COMPACT);
+}
+
+// --- Test: growing past the threshold switches to the skiplist ---
+TEST(SortedSetTest, ConvertsToSkiplistWhenLarge) {
+  SortedSet zset;
+  for (int i = 0; i < 200; ++i) {
+    zset.add("m" + std::to_string(i), i);
+  }
+
+  EXPECT_EQ(zset.encoding(), SortedSet::Encoding::SKIPLIST);
+  EXPECT_EQ(zset.size(), 200u);
+  EXPECT_EQ(zset.rank("m0").value(), 0u);
+  EXPECT_EQ(zset.rank("m199").value(), 199u);
+  EXPECT_EQ(zset.score("m42").value(), 42.0);
+}
+
+// --- Test: long members also force the skiplist ---
+TEST(SortedSetTest, LongMemberForcesSkiplist) {
+  SortedSet zset;
+  zset.add(std::string(100, 'x'), 1.0);
+
+  EXPECT_EQ(zset.encoding(), SortedSet::Encoding::SKIPLIST);
+  EXPECT_EQ(zset.rank(std::string(100, 'x')).value(), 0u);
+}
+
+// --- Test: negative indexes and score ranges ---
+TEST(SortedSetTest, RangeQueries) {
+  SortedSet zset;
+  for (int i = 0; i < 300; ++i) {
+    zset.add("m" + std::to_string(i), i * 10.0);
+  }
+
+  const auto top = zset.range_by_rank(-3, -1);
+  ASSERT_EQ(top.size(), 3u);
+  EXPECT_EQ(top[0].member, "m297");
+  EXPECT_EQ(top[2].member, "m299");
+
+  const auto window = zset.range_by_score(100.0, 130.0);
+  ASSERT_EQ(window.size(), 4u);
+  EXPECT_EQ(window.front().member, "m10");
+  EXPECT_EQ(window.back().member, "m13");
+
+  EXPECT_TRUE(zset.range_by_rank(500, 600).empty());
+  EXPECT_TRUE(zset.range_by_score(5.0, 1.0).empty());
+}
+
+// --- Test: increment, remove, and NaN protection ---
+TEST(SortedSetTest, IncrementAndRemove) {
+  SortedSet zset;
+  EXPECT_EQ(zset.increment("a", 5.0).value(), 5.0);
+  EXPECT_EQ(zset.increment("a", -1.5).value(), 3.5);
+
+  zset.add("inf", std::numeric_limits<double>::infinity());
+  EXPECT_FALSE(
+      zset.increment("inf", -std::numeric_limits<double>::infinity()).has_value());
+
+  EXPECT_TRUE(zset.remove("a"));
+  EXPECT_FALSE(zset.remove("a"));
+  EXPECT_FALSE(zset.rank("a").has_value());
+  EXPECT_EQ(zset.size(), 1u);
+}
+
+// --- Test: randomized cross-check of the skiplist against std::map ---
+// A reference model: an ordered std::map<(score, member)> gives the correct
+// rank of every member, which the skiplist's span bookkeeping must match.
+TEST(SortedSetTest, SkiplistMatchesReferenceModel) {
+  SortedSet zset;
+  std::map<std::string, double> scores;
+  std::mt19937 rng(7);
+
+  for (int step = 0; step < 5000; ++step) {
+    const std::string member = "k" + std::to_string(rng() % 400);
+    if (rng() % 4 == 0) {
+      EXPECT_EQ(zset.remove(member), scores.erase(member) > 0);
+    } else {
+      const double score = static_cast<double>(rng() % 50);
+      zset.add(member, score);
+      scores[member] = score;
+    }
+  }
+
+  std::vector<std::pair<double, std::string>> expected;
+  for (const auto &[member, score] : scores) {
+    expected.emplace_back(score, member);
+  }
+  std::sort(expected.begin(), expected.end());
+
+  ASSERT_EQ(zset.size(), expected.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(zset.rank(expected[i].second).value(), i);
+  }
+
+  const SortedSet copy = zset; // deep copy keeps order and encoding
+  EXPECT_EQ(copy.encoding(), zset.encoding());
+  EXPECT_EQ(copy.range_by_rank(0, -1).size(), expected.size());
+}
+
+// --- Test: typed store access rejects the wrong type ---
+TEST(SortedSetTest, StoreReportsWrongType) {
+  mini_redis::KeyValueStore store;
+  store.set("plain", "text");
+
+  const auto status = store.modify_as<SortedSet>(
+      "plain", true, [](SortedSet &zset) { return zset.add("a", 1.0); });
+  EXPECT_EQ(status, mini_redis::AccessStatus::WRONG_TYPE);
+
+  store.modify_as<SortedSet>("board", true, [](SortedSet &zset) {
+    zset.add("a", 1.0);
+    return true;
+  });
+  EXPECT_FALSE(store.get("board").has_value()); // not a string
+
+  // Removing the last member deletes the key
+  store.modify_as<SortedSet>("board", false, [](SortedSet &zset) {
+    zset.remove("a");
+    return !zset.empty();
+  });
+  EXPECT_EQ(store.keys(), std::vector<std::string>{"plain"});
+}
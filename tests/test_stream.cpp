@@ -0,0 +1,256 @@
+// =============================================================================
+// test_stream.cpp — Unit Tests for the Append-Only Stream
+// =============================================================================
+//
+// Entries live packed inside blocks, so most tests compare the stream
+// against a plain std::vector model across block boundaries: whatever
+// range, trim or reload we do, the same entries must come back in order.
+// The last tests cover KeyWaiters' multi-key blocking used by XREAD.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "api/key_waiters.hpp"
+#include "core/key_value_store.hpp"
+#include "core/stream.hpp"
+
+#include <string>
+#include <vector>
+
+using mini_redis::ByteReader;
+using mini_redis::Stream;
+using mini_redis::StreamEntry;
+using mini_redis::StreamFields;
+using mini_redis::StreamId;
+
+namespace {
+
+// Entry i: usually the same two fields (packed as values only), every 7th
+// entry a different shape
+StreamFields fields_for(std::size_t i) {
+  if (i % 7 == 0) {
+    return {{"event", "login"}, {"user", "u" + std::to_string(i)},
+            {"ip", "10.0.0." + std::to_string(i % 256)}};
+  }
+  return {{"sensor", "s" + std::to_string(i % 5)},
+          {"temp", std::to_string(20 + i % 10)}};
+}
+
+// Fills a stream with 'count' entries 3 ms apart, returning the model
+std::vector<StreamEntry> fill(Stream &stream, std::size_t count) {
+  std::vector<StreamEntry> model;
+  for (std::size_t i = 0; i < count; ++i) {
+    StreamEntry entry{StreamId{1000 + i * 3, i % 2}, fields_for(i)};
+    EXPECT_TRUE(stream.add(entry.id, entry.fields));
+    model.push_back(entry);
+  }
+  return model;
+}
+
+void expect_entries(const std::vector<StreamEntry> &actual,
+                    const std::vector<StreamEntry> &expected) {
+  ASSERT_EQ(actual.size(), expected.size());
+  for (std::size_t i = 0; i < actual.size(); ++i) {
+    EXPECT_EQ(actual[i].id, expected[i].id) << "at " << i;
+    EXPECT_EQ(actual[i].fields, expected[i].fields) << "at " << i;
+  }
+}
+
+std::vector<StreamEntry> all(const Stream &stream) {
+  return stream.range(StreamId::min(), StreamId::max());
+}
+
+} // anonymous namespace
+
+TEST(StreamTest, IdParsingAndOrder) {
+  EXPECT_EQ(StreamId::parse("1700-3"), (StreamId{1700, 3}));
+  EXPECT_EQ(StreamId::parse("1700"), (StreamId{1700, 0}));
+  EXPECT_EQ(StreamId::parse("1700", 9), (StreamId{1700, 9}));
+  EXPECT_EQ(StreamId::parse("18446744073709551615-18446744073709551615"),
+            StreamId::max());
+  for (const char *bad : {"", "-", "1-", "-1", "a-1", "1-2-3", "+5", " 1",
+                          "18446744073709551616"}) {
+    EXPECT_FALSE(StreamId::parse(bad).has_value()) << bad;
+  }
+
+  EXPECT_LT((StreamId{1, 9}), (StreamId{2, 0}));
+  EXPECT_LT((StreamId{2, 0}), (StreamId{2, 1}));
+  EXPECT_EQ((StreamId{5, 7}).to_string(), "5-7");
+  EXPECT_EQ((StreamId{5, 7}).successor(), (StreamId{5, 8}));
+  EXPECT_EQ((StreamId{5, ~0ULL}).successor(), (StreamId{6, 0}));
+  EXPECT_FALSE(StreamId::max().successor().has_value());
+}
+
+TEST(StreamTest, AutoIdsStayMonotonic) {
+  Stream stream;
+  EXPECT_EQ(stream.next_id(0), (StreamId{0, 1})); // 0-0 is never valid
+  EXPECT_FALSE(stream.add(StreamId::min(), fields_for(1)));
+
+  EXPECT_TRUE(stream.add(*stream.next_id(100), fields_for(1)));
+  EXPECT_EQ(stream.last_id(), (StreamId{100, 0}));
+
+  // Same millisecond, then a clock that went backwards: keep counting
+  EXPECT_EQ(stream.next_id(100), (StreamId{100, 1}));
+  EXPECT_EQ(stream.next_id(50), (StreamId{100, 1}));
+  EXPECT_EQ(stream.next_id(101), (StreamId{101, 0}));
+
+  EXPECT_EQ(stream.next_id_in(100), (StreamId{100, 1}));
+  EXPECT_EQ(stream.next_id_in(200), (StreamId{200, 0}));
+  EXPECT_FALSE(stream.next_id_in(99).has_value());
+
+  EXPECT_FALSE(stream.add(StreamId{100, 0}, fields_for(2))); // not greater
+  EXPECT_FALSE(stream.add(StreamId{99, 5}, fields_for(2)));
+  EXPECT_EQ(stream.size(), 1u);
+}
+
+TEST(StreamTest, RangeAcrossBlocks) {
+  Stream stream;
+  const auto model = fill(stream, 1000);
+  EXPECT_GT(stream.block_count(), 5u);
+  expect_entries(all(stream), model);
+
+  // Inclusive bounds that fall mid-block, between IDs and on exact IDs
+  const auto middle = stream.range(model[123].id, model[456].id);
+  expect_entries(middle, {model.begin() + 123, model.begin() + 457});
+  const auto between =
+      stream.range(StreamId{model[10].id.ms, 7}, StreamId{model[20].id.ms, 0});
+  expect_entries(between, {model.begin() + 11, model.begin() + 21});
+
+  // COUNT limits, read_after is exclusive
+  expect_entries(stream.range(model[500].id, StreamId::max(), 3),
+                 {model.begin() + 500, model.begin() + 503});
+  expect_entries(stream.read_after(model[997].id),
+                 {model.begin() + 998, model.end()});
+  EXPECT_TRUE(stream.read_after(model.back().id).empty());
+  EXPECT_TRUE(stream.range(model[5].id, model[4].id).empty());
+}
+
+TEST(StreamTest, TrimByLengthAndId) {
+  Stream stream;
+  auto model = fill(stream, 1000);
+  const StreamId last = stream.last_id();
+
+  // Lengths that cut mid-block and on block boundaries
+  EXPECT_EQ(stream.trim_max_len(937), 63u);
+  model.erase(model.begin(), model.begin() + 63);
+  expect_entries(all(stream), model);
+  EXPECT_EQ(stream.trim_max_len(2000), 0u);
+
+  EXPECT_EQ(stream.trim_min_id(model[400].id), 400u);
+  model.erase(model.begin(), model.begin() + 400);
+  expect_entries(all(stream), model);
+  EXPECT_EQ(stream.first_id(), model.front().id);
+
+  // Everything goes; IDs are never reused
+  EXPECT_EQ(stream.trim_max_len(0), model.size());
+  EXPECT_TRUE(stream.empty());
+  EXPECT_EQ(stream.block_count(), 0u);
+  EXPECT_EQ(stream.last_id(), last);
+  EXPECT_FALSE(stream.add(last, fields_for(1)));
+  EXPECT_TRUE(stream.add(*stream.next_id(0), fields_for(1)));
+}
+
+TEST(StreamTest, BlocksArePacked) {
+  Stream stream;
+  for (std::uint64_t i = 0; i < 10'000; ++i) {
+    stream.add(StreamId{1'700'000'000'000 + i, 0},
+               {{"sensor", "t1"}, {"temp", "21.5"}});
+  }
+  // ID deltas + values only: well under 16 bytes for a 25-byte event
+  EXPECT_LT(stream.memory_bytes(), 16 * stream.size());
+  EXPECT_EQ(stream.block_count(), 10'000 / Stream::BLOCK_MAX_ENTRIES);
+}
+
+TEST(StreamTest, ConsumerOffsets) {
+  Stream stream;
+  EXPECT_FALSE(stream.offset("billing").has_value());
+  stream.set_offset("billing", StreamId{5, 0});
+  stream.set_offset("audit", StreamId{7, 1});
+  EXPECT_EQ(stream.offset("billing"), (StreamId{5, 0}));
+  EXPECT_EQ(stream.offsets().size(), 2u);
+}
+
+TEST(StreamTest, SerializeRoundTrip) {
+  Stream stream;
+  auto model = fill(stream, 777);
+  stream.trim_max_len(700);
+  model.erase(model.begin(), model.begin() + 77);
+  stream.set_offset("reader", model[10].id);
+
+  std::string bytes;
+  stream.serialize(bytes);
+  ByteReader reader(bytes);
+  auto restored = Stream::deserialize(reader);
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_TRUE(reader.at_end());
+  expect_entries(all(*restored), model);
+  EXPECT_EQ(restored->last_id(), stream.last_id());
+  EXPECT_EQ(restored->offset("reader"), model[10].id);
+
+  // Appending continues where the original left off
+  EXPECT_FALSE(restored->add(model.back().id, fields_for(1)));
+  EXPECT_TRUE(restored->add(*restored->next_id(0), fields_for(1)));
+
+  // A truncated stream is rejected, never read past
+  std::string truncated = bytes.substr(0, bytes.size() / 2);
+  ByteReader short_reader(truncated);
+  EXPECT_FALSE(Stream::deserialize(short_reader).has_value());
+}
+
+// --- Test: a waiter on several keys is served by whichever gets data ---
+TEST(StreamTest, WaiterOnSeveralKeys) {
+  mini_redis::KeyWaiters waiters;
+  bool ready = false;
+
+  const auto response = waiters.block(
+      std::vector<std::string>{"a", "b"}, std::chrono::milliseconds(0),
+      [&ready]() -> std::optional<mini_redis::HttpResponse> {
+        if (!ready) {
+          return std::nullopt;
+        }
+        return mini_redis::HttpResponse::ok().body("entry");
+      },
+      mini_redis::HttpResponse::not_found());
+  ASSERT_NE(response.parked_connection(), nullptr);
+  EXPECT_EQ(waiters.waiting_count(), 2u); // queued on both keys
+
+  ready = true;
+  waiters.notify("b", mini_redis::KeyWaiters::Wake::ALL);
+  EXPECT_TRUE(response.parked_connection()->is_completed());
+  EXPECT_EQ(waiters.waiting_count(), 0u); // unlinked from "a" too
+}
+
+// --- Test: Wake::ALL tries every waiter, not just up to the first miss ---
+TEST(StreamTest, WakeAllSkipsUnservableWaiters) {
+  mini_redis::KeyWaiters waiters;
+  bool first_ready = false;
+
+  const auto first = waiters.block(
+      "s", std::chrono::milliseconds(0),
+      [&first_ready]() -> std::optional<mini_redis::HttpResponse> {
+        if (!first_ready) {
+          return std::nullopt;
+        }
+        return mini_redis::HttpResponse::ok();
+      },
+      mini_redis::HttpResponse::not_found());
+  bool second_ready = false;
+  const auto second = waiters.block(
+      "s", std::chrono::milliseconds(0),
+      [&second_ready]() -> std::optional<mini_redis::HttpResponse> {
+        if (!second_ready) {
+          return std::nullopt;
+        }
+        return mini_redis::HttpResponse::ok();
+      },
+      mini_redis::HttpResponse::not_found());
+
+  second_ready = true;
+  waiters.notify("s"); // UNTIL_EMPTY stops at the first waiter
+  EXPECT_FALSE(second.parked_connection()->is_completed());
+
+  waiters.notify("s", mini_redis::KeyWaiters::Wake::ALL);
+  EXPECT_FALSE(first.parked_connection()->is_completed());
+  EXPECT_TRUE(second.parked_connection()->is_completed());
+  EXPECT_EQ(waiters.waiting_count(), 1u);
+}
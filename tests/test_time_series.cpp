@@ -0,0 +1,220 @@
+// =============================================================================
+// test_time_series.cpp — Unit Tests for the Compressed Time Series
+// =============================================================================
+//
+// Gorilla encoding is lossless, so every test compares against a plain
+// std::map model: whatever went in must come back bit-for-bit, including
+// awkward values (NaN-free extremes, negative zero, huge timestamp jumps).
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/key_value_store.hpp"
+#include "core/time_series.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <random>
+#include <vector>
+
+using mini_redis::ByteReader;
+using mini_redis::KeyValueStore;
+using mini_redis::TimeSeries;
+
+namespace {
+
+constexpr std::int64_t MIN_TS = std::numeric_limits<std::int64_t>::min();
+constexpr std::int64_t MAX_TS = std::numeric_limits<std::int64_t>::max();
+
+void expect_matches(const TimeSeries &series,
+                    const std::map<std::int64_t, double> &model) {
+  const auto samples = series.range(MIN_TS, MAX_TS);
+  ASSERT_EQ(samples.size(), model.size());
+  ASSERT_EQ(series.size(), model.size());
+  auto it = model.begin();
+  for (const auto &sample : samples) {
+    EXPECT_EQ(sample.timestamp, it->first);
+    // Compare bit patterns: -0.0 must stay -0.0
+    EXPECT_EQ(std::memcmp(&sample.value, &it->second, sizeof(double)), 0)
+        << "at " << sample.timestamp;
+    ++it;
+  }
+}
+
+} // anonymous namespace
+
+TEST(TimeSeriesTest, RoundTripsRegularAndIrregularData) {
+  TimeSeries series;
+  std::map<std::int64_t, double> model;
+  std::mt19937_64 rng(7);
+
+  std::int64_t ts = 1'700'000'000'000;
+  double value = 20.0;
+  for (int i = 0; i < 50'000; ++i) {
+    // Mostly a steady 1 s interval with jitter, occasionally a big gap
+    ts += 1000 + static_cast<std::int64_t>(rng() % 5) - 2;
+    if (i % 9973 == 0) {
+      ts += 1'000'000'000;
+    }
+    value += (static_cast<double>(rng() % 100) - 50.0) / 100.0;
+    const double stored = i % 17 == 0 ? value : std::round(value * 10) / 10;
+    series.add(ts, stored);
+    model[ts] = stored;
+  }
+  EXPECT_GT(series.chunk_count(), 1u);
+  expect_matches(series, model);
+}
+
+TEST(TimeSeriesTest, ExtremeValuesAndTimestamps) {
+  TimeSeries series;
+  std::map<std::int64_t, double> model;
+  const double values[] = {0.0,
+                           -0.0,
+                           1.0,
+                           std::numeric_limits<double>::max(),
+                           std::numeric_limits<double>::lowest(),
+                           std::numeric_limits<double>::denorm_min(),
+                           std::numeric_limits<double>::infinity(),
+                           -std::numeric_limits<double>::infinity()};
+  const std::int64_t stamps[] = {MIN_TS, -5, 0, 1, 2, 1'000'000,
+                                 MAX_TS - 1, MAX_TS};
+  for (std::size_t i = 0; i < std::size(stamps); ++i) {
+    series.add(stamps[i], values[i]);
+    model[stamps[i]] = values[i];
+  }
+  expect_matches(series, model);
+}
+
+TEST(TimeSeriesTest, OutOfOrderAndDuplicates) {
+  TimeSeries series;
+  std::map<std::int64_t, double> model;
+  std::mt19937_64 rng(11);
+
+  for (int i = 0; i < 3'000; ++i) {
+    const auto ts = static_cast<std::int64_t>(rng() % 5'000);
+    const double value = static_cast<double>(i);
+    const bool is_new = model.count(ts) == 0;
+    EXPECT_EQ(series.add(ts, value), is_new);
+    model[ts] = value;
+  }
+  expect_matches(series, model);
+}
+
+TEST(TimeSeriesTest, RangeAndAggregation) {
+  TimeSeries series;
+  for (std::int64_t ts = 0; ts < 100; ++ts) {
+    series.add(ts * 10, static_cast<double>(ts)); // 0, 10, ..., 990
+  }
+
+  const auto raw = series.range(95, 125);
+  ASSERT_EQ(raw.size(), 3u); // 100, 110, 120
+  EXPECT_EQ(raw.front().timestamp, 100);
+  EXPECT_EQ(raw.back().value, 12.0);
+
+  // Buckets of 100 ms hold 10 samples each: values 10k .. 10k+9
+  using Aggregation = TimeSeries::Aggregation;
+  const auto avg = series.range(MIN_TS, MAX_TS, Aggregation::AVG, 100);
+  ASSERT_EQ(avg.size(), 10u);
+  EXPECT_EQ(avg[3].timestamp, 300);
+  EXPECT_DOUBLE_EQ(avg[3].value, 34.5);
+
+  EXPECT_EQ(series.range(0, 999, Aggregation::MIN, 100)[2].value, 20.0);
+  EXPECT_EQ(series.range(0, 999, Aggregation::MAX, 100)[2].value, 29.0);
+  EXPECT_EQ(series.range(0, 999, Aggregation::SUM, 1000)[0].value, 4950.0);
+  EXPECT_EQ(series.range(0, 999, Aggregation::COUNT, 250)[0].value, 25.0);
+  EXPECT_EQ(series.range(55, 999, Aggregation::FIRST, 100)[0].value, 6.0);
+  EXPECT_EQ(series.range(0, 999, Aggregation::LAST, 100)[9].value, 99.0);
+
+  // Negative timestamps bucket by floor, not toward zero
+  TimeSeries negative;
+  negative.add(-150, 1.0);
+  negative.add(-50, 2.0);
+  const auto buckets = negative.range(MIN_TS, MAX_TS, Aggregation::SUM, 100);
+  ASSERT_EQ(buckets.size(), 2u);
+  EXPECT_EQ(buckets[0].timestamp, -200);
+  EXPECT_EQ(buckets[1].timestamp, -100);
+}
+
+TEST(TimeSeriesTest, TrimAndRetention) {
+  TimeSeries series(1000); // keep one second
+  std::map<std::int64_t, double> model;
+  for (std::int64_t ts = 0; ts < 100'000; ts += 3) {
+    series.add(ts, static_cast<double>(ts % 7));
+    model[ts] = static_cast<double>(ts % 7);
+  }
+  const std::size_t chunks = series.chunk_count();
+
+  // Cutoff in the middle of a chunk: exactly the older samples go
+  const std::size_t removed = series.trim(40'001);
+  model.erase(model.begin(), model.lower_bound(40'001));
+  EXPECT_EQ(removed, 100'000 / 3 + 1 - model.size());
+  EXPECT_LT(series.chunk_count(), chunks);
+  expect_matches(series, model);
+
+  // Retention is relative to the clock passed in
+  series.trim_retention(99'500);
+  model.erase(model.begin(), model.lower_bound(98'500));
+  expect_matches(series, model);
+  EXPECT_EQ(series.retention_cutoff(99'500), 98'500);
+
+  EXPECT_EQ(TimeSeries().retention_cutoff(99'500), MIN_TS);
+  EXPECT_EQ(TimeSeries(MAX_TS).retention_cutoff(-10), MIN_TS); // no overflow
+}
+
+TEST(TimeSeriesTest, CompressesRegularMetrics) {
+  TimeSeries series;
+  for (std::int64_t i = 0; i < 100'000; ++i) {
+    series.add(1'700'000'000'000 + i * 1000, 42.0 + static_cast<double>(i % 3));
+  }
+  // Steady interval + few distinct values: well under 2 bytes per sample
+  EXPECT_LT(series.memory_bytes(), 2 * series.size());
+}
+
+TEST(TimeSeriesTest, SerializeRoundTrip) {
+  TimeSeries series(60'000);
+  std::map<std::int64_t, double> model;
+  for (std::int64_t ts = 0; ts < 5'000; ++ts) {
+    series.add(ts * 7, std::sin(static_cast<double>(ts)));
+    model[ts * 7] = std::sin(static_cast<double>(ts));
+  }
+
+  std::string bytes;
+  series.serialize(bytes);
+  ByteReader reader(bytes);
+  auto restored = TimeSeries::deserialize(reader);
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_TRUE(reader.at_end());
+  EXPECT_EQ(restored->retention_ms(), 60'000);
+  expect_matches(*restored, model);
+
+  // The encoder state was recovered: appending continues seamlessly
+  restored->add(100'000, 1.5);
+  model[100'000] = 1.5;
+  expect_matches(*restored, model);
+
+  // A truncated stream is rejected, never read past
+  std::string truncated = bytes.substr(0, bytes.size() - 10);
+  ByteReader short_reader(truncated);
+  EXPECT_FALSE(TimeSeries::deserialize(short_reader).has_value());
+}
+
+TEST(TimeSeriesTest, StoreRetentionSweep) {
+  KeyValueStore store;
+  store.modify_as<TimeSeries>("cpu", true, [](TimeSeries &series) {
+    series.set_retention_ms(100);
+    for (std::int64_t ts = 0; ts < 1000; ++ts) {
+      series.add(ts, 1.0);
+    }
+    return true;
+  });
+
+  store.modify_each_as<TimeSeries>(
+      [](TimeSeries &series) { series.trim_retention(1000); });
+
+  std::size_t left = 0;
+  store.read_as<TimeSeries>(
+      "cpu", [&](const TimeSeries &series) { left = series.size(); });
+  EXPECT_EQ(left, 100u); // 900 .. 999
+}
@@ -0,0 +1,320 @@
+// =============================================================================
+// test_vector_index.cpp — Unit Tests for the Vector Index
+// =============================================================================
+//
+// The SIMD distance kernels are checked against the portable loops on odd
+// lengths, the flat scan against hand-computed answers, and the HNSW graph
+// against the flat scan: an approximate index is correct when its RECALL
+// (the fraction of the true k nearest it finds) stays high.
+// =============================================================================
+
+#include <gtest/gtest.h>
+
+#include "core/vector_index.hpp"
+#include "core/vector_ops.hpp"
+
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using mini_redis::VectorIndex;
+
+namespace {
+
+std::vector<float> random_vector(std::size_t dim, std::mt19937 &rng) {
+  std::normal_distribution<float> normal(0.0f, 1.0f);
+  std::vector<float> vector(dim);
+  for (auto &value : vector) {
+    value = normal(rng);
+  }
+  return vector;
+}
+
+// Points scattered around a few centres — like real embeddings, which
+// cluster by topic (uniform noise would make every neighbour equally far)
+std::vector<std::vector<float>> clustered(std::size_t count, std::size_t dim,
+                                          std::mt19937 &rng) {
+  std::vector<std::vector<float>> centres;
+  for (int i = 0; i < 20; ++i) {
+    centres.push_back(random_vector(dim, rng));
+  }
+  std::normal_distribution<float> noise(0.0f, 0.4f);
+  std::vector<std::vector<float>> points;
+  for (std::size_t i = 0; i < count; ++i) {
+    auto point = centres[i % centres.size()];
+    for (auto &value : point) {
+      value += noise(rng);
+    }
+    points.push_back(std::move(point));
+  }
+  return points;
+}
+
+VectorIndex::Options options_with(VectorIndex::Metric metric,
+                                  VectorIndex::Quantization quantization,
+                                  VectorIndex::Algorithm algorithm) {
+  VectorIndex::Options options;
+  options.metric = metric;
+  options.quantization = quantization;
+  options.algorithm = algorithm;
+  return options;
+}
+
+// Average fraction of the exact top-k that knn() also returns
+double recall_at(const VectorIndex &index,
+                 const std::vector<std::vector<float>> &queries,
+                 std::size_t k, std::size_t ef) {
+  double found = 0.0;
+  for (const auto &query : queries) {
+    std::set<std::string> truth;
+    for (const auto &match : index.knn_exact(query, k)) {
+      truth.insert(match.name);
+    }
+    for (const auto &match : index.knn(query, k, ef)) {
+      found += truth.count(match.name);
+    }
+  }
+  return found / static_cast<double>(queries.size() * k);
+}
+
+} // anonymous namespace
+
+// --- Test: SIMD kernels agree with the portable ones ---
+TEST(VectorOpsTest, KernelsMatchScalar) {
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> byte(-127, 127);
+  for (const std::size_t length : {1u, 7u, 15u, 17u, 33u, 128u, 1000u}) {
+    const auto a = random_vector(length, rng);
+    const auto b = random_vector(length, rng);
+    const float tolerance = 1e-4f * static_cast<float>(length);
+    EXPECT_NEAR(mini_redis::dot_f32(a.data(), b.data(), length),
+                mini_redis::dot_f32_scalar(a.data(), b.data(), length),
+                tolerance);
+    EXPECT_NEAR(mini_redis::l2_sq_f32(a.data(), b.data(), length),
+                mini_redis::l2_sq_f32_scalar(a.data(), b.data(), length),
+                tolerance);
+
+    std::vector<std::int8_t> x(length);
+    std::vector<std::int8_t> y(length);
+    for (std::size_t i = 0; i < length; ++i) {
+      x[i] = static_cast<std::int8_t>(byte(rng));
+      y[i] = static_cast<std::int8_t>(byte(rng));
+    }
+    EXPECT_EQ(mini_redis::dot_i8(x.data(), y.data(), length),
+              mini_redis::dot_i8_scalar(x.data(), y.data(), length));
+  }
+}
+
+// --- Test: Flat search returns exact distances, closest first ---
+TEST(VectorIndexTest, FlatExactResults) {
+  VectorIndex l2(options_with(VectorIndex::Metric::L2,
+                              VectorIndex::Quantization::FLOAT32,
+                              VectorIndex::Algorithm::FLAT));
+  EXPECT_TRUE(l2.add("origin", {0.0f, 0.0f}));
+  EXPECT_TRUE(l2.add("right", {3.0f, 0.0f}));
+  EXPECT_TRUE(l2.add("far", {3.0f, 4.0f}));
+  EXPECT_EQ(l2.dim(), 2u);
+
+  const auto matches = l2.knn({0.0f, 0.0f}, 2);
+  ASSERT_EQ(matches.size(), 2u);
+  EXPECT_EQ(matches[0].name, "origin");
+  EXPECT_FLOAT_EQ(matches[0].distance, 0.0f);
+  EXPECT_EQ(matches[1].name, "right");
+  EXPECT_FLOAT_EQ(matches[1].distance, 3.0f);
+  EXPECT_FLOAT_EQ(l2.knn({0.0f, 0.0f}, 5).back().distance, 5.0f);
+
+  VectorIndex cosine;
+  cosine.add("x", {2.0f, 0.0f});
+  cosine.add("y", {0.0f, 5.0f});
+  const auto nearest = cosine.knn({1.0f, 0.1f}, 1);
+  ASSERT_EQ(nearest.size(), 1u);
+  EXPECT_EQ(nearest[0].name, "x");
+  EXPECT_FLOAT_EQ(cosine.get("y")->at(1), 1.0f); // stored normalized
+}
+
+// --- Test: Only vectors of the right shape are accepted ---
+TEST(VectorIndexTest, Validation) {
+  VectorIndex index;
+  EXPECT_FALSE(index.valid({}));
+  EXPECT_FALSE(index.valid({0.0f, 0.0f})); // no direction for cosine
+  EXPECT_FALSE(index.valid({1.0f, NAN}));
+  EXPECT_TRUE(index.valid({1.0f, 2.0f, 3.0f}));
+
+  index.add("a", {1.0f, 2.0f, 3.0f});
+  EXPECT_FALSE(index.valid({1.0f, 2.0f}));
+  EXPECT_TRUE(index.valid({3.0f, 2.0f, 1.0f}));
+
+  VectorIndex l2(options_with(VectorIndex::Metric::L2,
+                              VectorIndex::Quantization::FLOAT32,
+                              VectorIndex::Algorithm::AUTO));
+  EXPECT_TRUE(l2.valid({0.0f, 0.0f}));
+}
+
+// --- Test: Re-adding a name replaces its vector ---
+TEST(VectorIndexTest, UpdateReplaces) {
+  VectorIndex index(options_with(VectorIndex::Metric::L2,
+                                 VectorIndex::Quantization::FLOAT32,
+                                 VectorIndex::Algorithm::HNSW));
+  EXPECT_TRUE(index.add("a", {1.0f, 1.0f}));
+  EXPECT_TRUE(index.add("b", {5.0f, 5.0f}));
+  EXPECT_FALSE(index.add("a", {9.0f, 9.0f}));
+  EXPECT_EQ(index.size(), 2u);
+  EXPECT_EQ(index.get("a")->at(0), 9.0f);
+  EXPECT_EQ(index.knn({10.0f, 10.0f}, 1).at(0).name, "a");
+}
+
+// --- Test: The HNSW graph finds nearly all true neighbours ---
+TEST(VectorIndexTest, HnswRecall) {
+  std::mt19937 rng(11);
+  const auto points = clustered(3000, 32, rng);
+  for (const auto metric :
+       {VectorIndex::Metric::COSINE, VectorIndex::Metric::L2}) {
+    VectorIndex index(options_with(metric, VectorIndex::Quantization::FLOAT32,
+                                   VectorIndex::Algorithm::HNSW));
+    for (std::size_t i = 0; i < points.size(); ++i) {
+      index.add("p" + std::to_string(i), points[i]);
+    }
+    ASSERT_TRUE(index.has_graph());
+
+    const auto queries = clustered(50, 32, rng);
+    EXPECT_GT(recall_at(index, queries, 10, 100), 0.95);
+    EXPECT_GT(recall_at(index, queries, 10, 200),
+              recall_at(index, queries, 10, 10) - 1e-9);
+  }
+}
+
+// --- Test: AUTO switches to the graph at the threshold ---
+TEST(VectorIndexTest, AutoBuildsGraph) {
+  std::mt19937 rng(5);
+  VectorIndex index;
+  for (std::size_t i = 0; i < VectorIndex::HNSW_THRESHOLD; ++i) {
+    EXPECT_FALSE(index.has_graph());
+    index.add(std::to_string(i), random_vector(4, rng));
+  }
+  EXPECT_TRUE(index.has_graph());
+}
+
+// --- Test: int8 storage is 4x smaller and nearly as accurate ---
+TEST(VectorIndexTest, Int8Quantization) {
+  std::mt19937 rng(9);
+  const auto points = clustered(2000, 64, rng);
+  VectorIndex exact;
+  VectorIndex quantized(options_with(VectorIndex::Metric::COSINE,
+                                     VectorIndex::Quantization::INT8,
+                                     VectorIndex::Algorithm::FLAT));
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    exact.add(std::to_string(i), points[i]);
+    quantized.add(std::to_string(i), points[i]);
+  }
+  EXPECT_LT(quantized.memory_bytes() * 2, exact.memory_bytes());
+
+  // Dequantized values are within half a quantization step
+  const auto original = exact.get("7").value();
+  const auto restored = quantized.get("7").value();
+  float largest = 0.0f;
+  for (const float value : original) {
+    largest = std::max(largest, std::fabs(value));
+  }
+  for (std::size_t i = 0; i < original.size(); ++i) {
+    EXPECT_NEAR(restored[i], original[i], largest / 127.0f);
+  }
+
+  // Top-10 lists mostly agree with float32
+  const auto queries = clustered(30, 64, rng);
+  double overlap = 0.0;
+  for (const auto &query : queries) {
+    std::set<std::string> truth;
+    for (const auto &match : exact.knn(query, 10)) {
+      truth.insert(match.name);
+    }
+    for (const auto &match : quantized.knn(query, 10)) {
+      overlap += truth.count(match.name);
+    }
+  }
+  EXPECT_GT(overlap / (queries.size() * 10.0), 0.85);
+}
+
+// --- Test: Removed vectors are never returned; compaction keeps search ---
+TEST(VectorIndexTest, RemoveAndCompact) {
+  std::mt19937 rng(13);
+  const auto points = clustered(1000, 16, rng);
+  VectorIndex index(options_with(VectorIndex::Metric::L2,
+                                 VectorIndex::Quantization::FLOAT32,
+                                 VectorIndex::Algorithm::HNSW));
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    index.add(std::to_string(i), points[i]);
+  }
+
+  EXPECT_TRUE(index.remove("0"));
+  EXPECT_FALSE(index.remove("0"));
+  EXPECT_EQ(index.tombstones(), 1u);
+  EXPECT_FALSE(index.get("0").has_value());
+  for (const auto &match : index.knn(points[0], 10)) {
+    EXPECT_NE(match.name, "0");
+  }
+
+  // Half removed: tombstones merely equal the living, no compaction yet
+  for (std::size_t i = 2; i < points.size(); i += 2) {
+    index.remove(std::to_string(i));
+  }
+  EXPECT_EQ(index.size(), 500u);
+  EXPECT_EQ(index.tombstones(), 500u);
+
+  // One more and they outnumber them → compacted, graph rebuilt
+  index.remove("999");
+  EXPECT_EQ(index.size(), 499u);
+  EXPECT_EQ(index.tombstones(), 0u);
+  EXPECT_TRUE(index.has_graph());
+  const auto matches = index.knn(points[1], 1);
+  ASSERT_EQ(matches.size(), 1u);
+  EXPECT_EQ(matches[0].name, "1");
+
+  for (std::size_t i = 1; i < points.size(); i += 2) {
+    index.remove(std::to_string(i));
+  }
+  EXPECT_TRUE(index.empty());
+  EXPECT_TRUE(index.knn(points[1], 3).empty());
+}
+
+// --- Test: Snapshot round trip keeps vectors, options and the graph ---
+TEST(VectorIndexTest, SerializeRoundTrip) {
+  std::mt19937 rng(17);
+  const auto points = clustered(500, 24, rng);
+  VectorIndex index(options_with(VectorIndex::Metric::L2,
+                                 VectorIndex::Quantization::INT8,
+                                 VectorIndex::Algorithm::HNSW));
+  for (std::size_t i = 0; i < points.size(); ++i) {
+    index.add(std::to_string(i), points[i]);
+  }
+  index.remove("3");
+
+  std::string bytes;
+  index.serialize(bytes);
+  mini_redis::ByteReader reader(bytes);
+  const auto restored = VectorIndex::deserialize(reader);
+  ASSERT_TRUE(restored.has_value());
+  EXPECT_TRUE(reader.at_end());
+  EXPECT_EQ(restored->size(), index.size());
+  EXPECT_EQ(restored->dim(), 24u);
+  EXPECT_TRUE(restored->has_graph());
+  EXPECT_EQ(restored->options().quantization,
+            VectorIndex::Quantization::INT8);
+  EXPECT_EQ(restored->get("42"), index.get("42"));
+  EXPECT_FALSE(restored->get("3").has_value());
+
+  const auto query = points[7];
+  const auto before = index.knn(query, 5);
+  const auto after = restored->knn(query, 5);
+  ASSERT_EQ(before.size(), after.size());
+  for (std::size_t i = 0; i < before.size(); ++i) {
+    EXPECT_EQ(before[i].name, after[i].name);
+  }
+
+  for (const std::size_t cut : {std::size_t{0}, bytes.size() / 2,
+                                bytes.size() - 1}) {
+    mini_redis::ByteReader truncated(std::string_view(bytes).substr(0, cut));
+    EXPECT_FALSE(VectorIndex::deserialize(truncated).has_value());
+  }
+}